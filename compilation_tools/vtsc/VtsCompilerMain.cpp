@@ -21,6 +21,7 @@
 #include <unistd.h>
 
 #include <iostream>
+#include <thread>
 
 #include <android-base/logging.h>
 #include "VtsCompilerUtils.h"
@@ -38,9 +39,22 @@ using namespace std;
 //   Usage: vtsc -mDRIVER | -mPROFILER -tSOURCE -b<base path> \
 //          <.vts input file or dir path> \
 //          <C/C++ source output file or dir path>
+// To generate only a libFuzzer dictionary of the values of the enums
+// declared in a spec,
+//   Usage: vtsc -mFUZZER -tDICTIONARY -b<base path> \
+//          <.vts input file or dir path> <dictionary output file or dir path>
 // where <base path> is a base path of where .vts input file or dir is
 // stored but should be excluded when computing the package path of generated
 // source or header output file(s).
+// To run the jobs listed in a file,
+//   Usage: vtsc -l<job list file path> [-j<number of threads>] \
+//          [-s<stamp dir>] [-b<base path>]
+// where each line of the job list file is
+//   <DRIVER | PROFILER | FUZZER> <HEADER | SOURCE | DICTIONARY> <input path> \
+//   <output path>
+// The jobs run in parallel, each input file is parsed once, and if a stamp
+// dir is given, the jobs whose input, options and vtsc are unchanged since
+// their last run are skipped.
 
 int main(int argc, char* argv[]) {
 #ifdef VTS_DEBUG
@@ -50,6 +64,9 @@ int main(int argc, char* argv[]) {
   android::vts::VtsCompileMode mode = android::vts::kDriver;
   android::vts::VtsCompileFileType type = android::vts::VtsCompileFileType::kBoth;
   string vts_base_dir;
+  string job_list_file_path;
+  int num_threads = thread::hardware_concurrency();
+  string stamp_dir;
   for (int i = 0; i < argc; i++) {
 #ifdef VTS_DEBUG
     cout << "- args[" << i << "] " << argv[i] << endl;
@@ -79,6 +96,11 @@ int main(int argc, char* argv[]) {
           type = android::vts::kSource;
 #ifdef VTS_DEBUG
           cout << "- type: SOURCE" << endl;
+#endif
+        } else if (!strcmp(&argv[i][2], "DICTIONARY")) {
+          type = android::vts::kDictionary;
+#ifdef VTS_DEBUG
+          cout << "- type: DICTIONARY" << endl;
 #endif
         }
       }
@@ -88,7 +110,31 @@ int main(int argc, char* argv[]) {
         cout << "- VTS base dir: " << vts_base_dir << endl;
 #endif
       }
+      if (argv[i][1] == 'l') {
+        job_list_file_path = &argv[i][2];
+      }
+      if (argv[i][1] == 'j') {
+        num_threads = atoi(&argv[i][2]);
+      }
+      if (argv[i][1] == 's') {
+        stamp_dir = &argv[i][2];
+      }
+    }
+  }
+  if (!job_list_file_path.empty()) {
+    vector<android::vts::TranslationJob> jobs;
+    if (!android::vts::ParseTranslationJobs(job_list_file_path.c_str(),
+                                            &jobs)) {
+      return -1;
+    }
+    if (vts_base_dir.length() > 0 && chdir(vts_base_dir.c_str())) {
+      cerr << __func__ << " can't chdir to " << vts_base_dir << endl;
+      return -1;
+    }
+    if (num_threads < 1) {
+      num_threads = 1;
     }
+    return android::vts::TranslateJobs(jobs, num_threads, stamp_dir) ? 0 : -1;
   }
   if (argc < 5) {
     cerr << "argc " << argc << " < 5" << endl;
@@ -100,7 +146,8 @@ int main(int argc, char* argv[]) {
           mode, argv[opt_count + 1], argv[opt_count + 2], argv[opt_count + 3]);
       break;
     case android::vts::kHeader:
-    case android::vts::kSource: {
+    case android::vts::kSource:
+    case android::vts::kDictionary: {
       struct stat s;
       bool is_dir = false;
       if (vts_base_dir.length() > 0) {
@@ -133,6 +180,8 @@ int main(int argc, char* argv[]) {
                       argv[opt_count + 2], ent->d_name), vts_base_dir);
               if (type == android::vts::kHeader) {
                 dst_file = android::vts::PathJoin(dst_file.c_str(), ".h");
+              } else if (type == android::vts::kDictionary) {
+                dst_file = android::vts::PathJoin(dst_file.c_str(), ".dict");
               } else {
                 dst_file = android::vts::PathJoin(dst_file.c_str(), ".cpp");
               }
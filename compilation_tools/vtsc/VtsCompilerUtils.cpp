@@ -512,6 +512,36 @@ string GetCppInstanceType(
   exit(-1);
 }
 
+string GetCppStorageType(const VariableSpecificationMessage& arg) {
+  if (arg.type() != TYPE_PREDEFINED || !endsWith(arg.predefined_type(), "*")) {
+    return "";
+  }
+  return arg.predefined_type().substr(0, arg.predefined_type().size() - 1);
+}
+
+string GetCppInstanceTypeInStorage(const VariableSpecificationMessage& arg,
+                                   const string& storage, const string& msg) {
+  if (arg.predefined_type() == "struct light_state_t*") {
+    if (msg.length() == 0) {
+      return "GenerateLightState(&" + storage + ")";
+    } else {
+      return "GenerateLightStateUsingMessage(" + msg + ", &" + storage + ")";
+    }
+  } else if (arg.predefined_type() == "GpsCallbacks*") {
+    return "GenerateGpsCallbacks(&" + storage + ")";
+  } else if (arg.predefined_type() == "camera_info_t*") {
+    if (msg.length() == 0) {
+      return "GenerateCameraInfo(&" + storage + ")";
+    } else {
+      return "GenerateCameraInfoUsingMessage(" + msg + ", &" + storage + ")";
+    }
+  } else if (arg.predefined_type() == "camera_module_callbacks_t*") {
+    return "GenerateCameraModuleCallbacks(&" + storage + ")";
+  }
+  // The other instances are left uninitialized by GetCppInstanceType.
+  return "&" + storage;
+}
+
 int vts_fs_mkdirs(char* file_path, mode_t mode) {
   char* p;
 
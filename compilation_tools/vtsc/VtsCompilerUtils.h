@@ -47,6 +47,19 @@ extern string GetCppInstanceType(
     const string& msg = string(),
     const ComponentSpecificationMessage* message = NULL);
 
+// Returns the C/C++ type of the storage that an instance of an argument is
+// generated in by GetCppInstanceTypeInStorage, i.e. the type the argument
+// points to, or an empty string if GetCppInstanceType doesn't allocate the
+// instance.
+extern string GetCppStorageType(const VariableSpecificationMessage& arg);
+
+// Gets the C/C++ instance of an argument as GetCppInstanceType does, but
+// generated in storage, a variable of the type returned by
+// GetCppStorageType, instead of in newly allocated memory.
+extern string GetCppInstanceTypeInStorage(
+    const VariableSpecificationMessage& arg, const string& storage,
+    const string& msg = string());
+
 // Returns the name of a function which can convert the given arg to a protobuf.
 extern string GetConversionToProtobufFunctionName(
     VariableSpecificationMessage arg);
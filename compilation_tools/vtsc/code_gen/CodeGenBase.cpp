@@ -16,24 +16,34 @@
 
 #include "code_gen/CodeGenBase.h"
 
+#include <inttypes.h>
 #include <limits.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
+#include <google/protobuf/text_format.h>
 #include <hidl-util/Formatter.h>
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 #include "utils/InterfaceSpecUtil.h"
+#include "utils/StringUtil.h"
 
 #include "VtsCompilerUtils.h"
+#include "code_gen/common/HalHidlCodeGenUtils.h"
 #include "code_gen/driver/HalCodeGen.h"
 #include "code_gen/driver/HalHidlCodeGen.h"
 #include "code_gen/driver/LibSharedCodeGen.h"
@@ -67,22 +77,27 @@ void Translate(VtsCompileMode mode,
                   android::vts::kSource);
 }
 
-void TranslateToFile(VtsCompileMode mode,
-                     const char* input_vts_file_path,
-                     const char* output_file_path,
-                     VtsCompileFileType file_type) {
+// Translates a parsed VTS proto file to a C/C++ source or header file.
+static void TranslateMessageToFile(VtsCompileMode mode,
+                                   const char* input_vts_file_path,
+                                   const ComponentSpecificationMessage& message,
+                                   const char* output_file_path,
+                                   VtsCompileFileType file_type) {
+  // fails before writing any output, so that the build stops here instead
+  // of generating code that can't find the types.
+  string error;
+  if (message.component_class() == HAL_HIDL &&
+      !ValidateTypeReferences(message, &error)) {
+    cerr << input_vts_file_path << ": " << error << endl;
+    exit(-1);
+  }
+
   string output_cpp_file_path_str = string(output_file_path);
 
   size_t found;
   found = output_cpp_file_path_str.find_last_of("/");
   string output_dir = output_cpp_file_path_str.substr(0, found + 1);
 
-  ComponentSpecificationMessage message;
-  if (!ParseInterfaceSpec(input_vts_file_path, &message)) {
-    cerr << __func__ << " can't parse " << input_vts_file_path << endl;
-    exit(-1);
-  }
-
   vts_fs_mkdirs(&output_dir[0], 0777);
 
   FILE* output_file = fopen(output_file_path, "w+");
@@ -111,7 +126,8 @@ void TranslateToFile(VtsCompileMode mode,
     } else if (file_type == kSource){
       code_generator->GenerateSourceFile(out, message);
     } else {
-      cerr << __func__ << " doesn't support file_type = kBoth." << endl;
+      cerr << __func__ << " doesn't support file_type = " << file_type
+           << "." << endl;
       exit(-1);
     }
   } else if (mode == kFuzzer) {
@@ -131,8 +147,11 @@ void TranslateToFile(VtsCompileMode mode,
       fuzzer_generator->GenerateHeaderFile(out);
     } else if (file_type == kSource){
       fuzzer_generator->GenerateSourceFile(out);
+    } else if (file_type == kDictionary) {
+      fuzzer_generator->GenerateDictionaryFile(out);
     } else {
-      cerr << __func__ << " doesn't support file_type = kBoth." << endl;
+      cerr << __func__ << " doesn't support file_type = " << file_type
+           << "." << endl;
       exit(-1);
     }
   } else if (mode == kProfiler) {
@@ -151,11 +170,215 @@ void TranslateToFile(VtsCompileMode mode,
     } else if (file_type == kSource){
       profiler_generator->GenerateSourceFile(out, message);
     } else {
-      cerr << __func__ << " doesn't support file_type = kBoth." << endl;
+      cerr << __func__ << " doesn't support file_type = " << file_type
+           << "." << endl;
       exit(-1);
     }
   }
 }
 
+void TranslateToFile(VtsCompileMode mode,
+                     const char* input_vts_file_path,
+                     const char* output_file_path,
+                     VtsCompileFileType file_type) {
+  ComponentSpecificationMessage message;
+  if (!ParseInterfaceSpec(input_vts_file_path, &message)) {
+    cerr << __func__ << " can't parse " << input_vts_file_path << endl;
+    exit(-1);
+  }
+  TranslateMessageToFile(mode, input_vts_file_path, message, output_file_path,
+                         file_type);
+}
+
+bool ParseTranslationJobs(const char* job_list_file_path,
+                          vector<TranslationJob>* jobs) {
+  ifstream job_list_file(job_list_file_path);
+  if (!job_list_file.is_open()) {
+    cerr << __func__ << " can't open " << job_list_file_path << endl;
+    return false;
+  }
+  string line;
+  int line_number = 0;
+  while (getline(job_list_file, line)) {
+    line_number++;
+    istringstream fields(line);
+    string mode;
+    if (!(fields >> mode) || mode[0] == '#') {
+      continue;
+    }
+    TranslationJob job;
+    string file_type;
+    string extra;
+    bool valid = (fields >> file_type >> job.input_vts_file_path >>
+                  job.output_file_path) &&
+                 !(fields >> extra);
+    if (mode == "DRIVER") {
+      job.mode = kDriver;
+    } else if (mode == "PROFILER") {
+      job.mode = kProfiler;
+    } else if (mode == "FUZZER") {
+      job.mode = kFuzzer;
+    } else {
+      valid = false;
+    }
+    if (file_type == "HEADER") {
+      job.file_type = kHeader;
+    } else if (file_type == "SOURCE") {
+      job.file_type = kSource;
+    } else if (file_type == "DICTIONARY" && job.mode == kFuzzer) {
+      job.file_type = kDictionary;
+    } else {
+      valid = false;
+    }
+    if (!valid) {
+      cerr << __func__ << " malformed job at " << job_list_file_path << ":"
+           << line_number << ": " << line << endl;
+      return false;
+    }
+    jobs->push_back(job);
+  }
+  return true;
+}
+
+// Reads the whole file at path into data.
+static bool ReadFileToString(const string& path, string* data) {
+  ifstream file(path, ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  stringstream str_stream;
+  str_stream << file.rdbuf();
+  *data = str_stream.str();
+  return true;
+}
+
+// Writes data to a file of this thread, then renames it to path, so that an
+// interrupted run leaves either the old stamp or the new one.
+static bool WriteStamp(const string& path, const string& data) {
+  stringstream temp_path;
+  temp_path << path << "." << getpid() << "." << this_thread::get_id();
+  ofstream file(temp_path.str(), ios::binary | ios::trunc);
+  if (!file.is_open() || !(file << data)) {
+    unlink(temp_path.str().c_str());
+    return false;
+  }
+  file.close();
+  if (rename(temp_path.str().c_str(), path.c_str()) != 0) {
+    unlink(temp_path.str().c_str());
+    return false;
+  }
+  return true;
+}
+
+static string HexString(uint64_t value) {
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016" PRIx64, value);
+  return hex;
+}
+
+namespace {
+
+// An input file shared by the jobs that translate it.
+struct InputSpec {
+  // true if the file has been read into data.
+  bool readable = false;
+  // contents of the file.
+  string data;
+  // parses data into message for the first job that needs it.
+  once_flag parse_once;
+  // true if data has been parsed into message.
+  bool parsed = false;
+  ComponentSpecificationMessage message;
+};
+
+}  // namespace
+
+bool TranslateJobs(const vector<TranslationJob>& jobs, int num_threads,
+                   const string& stamp_dir) {
+  map<string, unique_ptr<InputSpec>> inputs;
+  for (const auto& job : jobs) {
+    unique_ptr<InputSpec>& input = inputs[job.input_vts_file_path];
+    if (input == nullptr) {
+      input.reset(new InputSpec());
+      input->readable = ReadFileToString(job.input_vts_file_path, &input->data);
+    }
+  }
+
+  bool use_stamps = !stamp_dir.empty();
+  // a new vtsc may generate different code from the same input.
+  uint64_t vtsc_hash = 0;
+  if (use_stamps) {
+    string vtsc_binary;
+    if (ReadFileToString("/proc/self/exe", &vtsc_binary)) {
+      vtsc_hash = HashBytes(vtsc_binary);
+      string stamp_dir_path = stamp_dir;
+      vts_fs_mkdirs(&stamp_dir_path[0], 0777);
+    } else {
+      cerr << __func__ << " can't read the vtsc binary, translating all jobs."
+           << endl;
+      use_stamps = false;
+    }
+  }
+
+  atomic<size_t> next_job(0);
+  atomic<bool> success(true);
+  auto run_jobs = [&]() {
+    for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+      const TranslationJob& job = jobs[i];
+      InputSpec* input = inputs.find(job.input_vts_file_path)->second.get();
+      if (!input->readable) {
+        cerr << __func__ << " can't read " << job.input_vts_file_path << endl;
+        success = false;
+        continue;
+      }
+
+      string stamp_path;
+      string stamp;
+      if (use_stamps) {
+        stamp_path = stamp_dir + "/" +
+                     HexString(HashBytes(job.output_file_path)) + ".stamp";
+        stringstream job_key;
+        job_key << job.mode << " " << job.file_type << " "
+                << job.output_file_path;
+        stamp = HexString(
+            HashBytes(input->data, HashBytes(job_key.str(), vtsc_hash)));
+        struct stat output_stat;
+        string last_stamp;
+        if (stat(job.output_file_path.c_str(), &output_stat) == 0 &&
+            ReadFileToString(stamp_path, &last_stamp) && last_stamp == stamp) {
+          continue;
+        }
+      }
+
+      call_once(input->parse_once, [input]() {
+        input->parsed = google::protobuf::TextFormat::MergeFromString(
+            input->data, &input->message);
+      });
+      if (!input->parsed) {
+        cerr << __func__ << " can't parse " << job.input_vts_file_path << endl;
+        success = false;
+        continue;
+      }
+      TranslateMessageToFile(job.mode, job.input_vts_file_path.c_str(),
+                             input->message, job.output_file_path.c_str(),
+                             job.file_type);
+      if (use_stamps && !WriteStamp(stamp_path, stamp)) {
+        cerr << __func__ << " can't write the stamp " << stamp_path << endl;
+      }
+    }
+  };
+
+  vector<thread> threads;
+  for (int i = 1; i < num_threads && static_cast<size_t>(i) < jobs.size();
+       i++) {
+    threads.emplace_back(run_jobs);
+  }
+  run_jobs();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return success;
+}
+
 }  // namespace vts
 }  // namespace android
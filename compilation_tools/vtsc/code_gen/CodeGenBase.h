@@ -21,6 +21,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
@@ -40,6 +41,8 @@ enum VtsCompileFileType {
   kBoth = 0,
   kHeader,
   kSource,
+  // a libFuzzer dictionary, only generated by the fuzzer mode.
+  kDictionary,
 };
 
 class CodeGenBase {
@@ -75,12 +78,38 @@ void Translate(VtsCompileMode mode,
                const char* output_cpp_file_path);
 
 
-// Translates the VTS proto file to a C/C++ source or header file.
+// Translates the VTS proto file to a C/C++ source or header file, or to a
+// fuzzer dictionary.
 void TranslateToFile(VtsCompileMode mode,
                      const char* input_vts_file_path,
                      const char* output_file_path,
                      VtsCompileFileType file_type);
 
+// A translation of a VTS proto file to one source or header file.
+struct TranslationJob {
+  VtsCompileMode mode;
+  VtsCompileFileType file_type;
+  string input_vts_file_path;
+  string output_file_path;
+};
+
+// Reads the translation jobs listed in a file. Each line other than empty
+// lines and lines starting with '#' is one job:
+//   <DRIVER | PROFILER | FUZZER> <HEADER | SOURCE | DICTIONARY> <input path> \
+//   <output path>
+// Returns false if the file can't be read or a line is malformed.
+bool ParseTranslationJobs(const char* job_list_file_path,
+                          vector<TranslationJob>* jobs);
+
+// Runs the translation jobs on up to num_threads threads. Each input file is
+// read and parsed once, however many jobs use it.
+// If stamp_dir is not empty, a job is skipped when its output file exists and
+// the stamp written by the last run of the job in stamp_dir matches the hash
+// of the input file contents, the mode, the file type and the vtsc binary.
+// Returns false if any job failed.
+bool TranslateJobs(const vector<TranslationJob>& jobs, int num_threads,
+                   const string& stamp_dir);
+
 }  // namespace vts
 }  // namespace android
 
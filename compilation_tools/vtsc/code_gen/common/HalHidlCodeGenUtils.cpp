@@ -16,6 +16,12 @@
 
 #include "HalHidlCodeGenUtils.h"
 
+#include <ctype.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
 namespace android {
 namespace vts {
 
@@ -46,5 +52,213 @@ bool IsUserDefinedType(const VariableType& type) {
   }
   return false;
 }
+
+bool IsRawScalarElement(const VariableSpecificationMessage& element) {
+  static const std::set<std::string> kRawScalarTypes = {
+      "bool_t",   "int8_t",   "uint8_t",  "int16_t", "uint16_t", "int32_t",
+      "uint32_t", "int64_t",  "uint64_t", "float_t", "double_t"};
+  return element.type() == TYPE_SCALAR &&
+         kRawScalarTypes.count(element.scalar_type()) > 0;
+}
+
+bool IsPodType(const VariableSpecificationMessage& var) {
+  switch (var.type()) {
+    case TYPE_SCALAR:
+      return var.scalar_type() != "bool_t" && IsRawScalarElement(var);
+    case TYPE_ENUM:
+    case TYPE_MASK:
+      return true;
+    case TYPE_ARRAY:
+      return var.vector_value_size() > 0 && IsPodType(var.vector_value(0));
+    case TYPE_STRUCT:
+      if (var.has_predefined_type()) {
+        return false;
+      }
+      for (const auto& field : var.struct_value()) {
+        if (!IsPodType(field)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if name is a version in a type name, e.g. V1_0.
+static bool IsVersionName(const std::string& name) {
+  size_t separator = name.find('_');
+  if (name.size() < 4 || name[0] != 'V' || separator == std::string::npos ||
+      separator == 1 || separator == name.size() - 1) {
+    return false;
+  }
+  for (size_t i = 1; i < name.size(); i++) {
+    if (i != separator && !isdigit(static_cast<unsigned char>(name[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Splits a type name, e.g. ::android::hardware::nfc::V1_0::INfc::Foo, into
+// its package and version, e.g. android.hardware.nfc@1.0, and the names
+// after the version, e.g. INfc and Foo. Returns false if there is no version
+// or no name after it.
+static bool SplitTypeName(const std::string& type_name,
+                          std::string* package_version,
+                          std::vector<std::string>* names) {
+  std::vector<std::string> tokens;
+  size_t begin = type_name.compare(0, 2, "::") == 0 ? 2 : 0;
+  while (true) {
+    size_t end = type_name.find("::", begin);
+    tokens.push_back(type_name.substr(begin, end - begin));
+    if (end == std::string::npos) break;
+    begin = end + 2;
+  }
+  package_version->clear();
+  names->clear();
+  for (size_t i = 0; i < tokens.size(); i++) {
+    if (!IsVersionName(tokens[i])) continue;
+    if (i == 0 || i + 1 == tokens.size()) return false;
+    for (size_t j = 0; j < i; j++) {
+      *package_version += (j == 0 ? "" : ".") + tokens[j];
+    }
+    std::string version = tokens[i].substr(1);
+    version[version.find('_')] = '.';
+    *package_version += "@" + version;
+    names->assign(tokens.begin() + i + 1, tokens.end());
+    return true;
+  }
+  return false;
+}
+
+// Adds the names of attribute and of its sub types to declared_types.
+static void AddDeclaredTypes(const VariableSpecificationMessage& attribute,
+                             std::set<std::string>* declared_types) {
+  declared_types->insert(attribute.name());
+  for (const auto& sub_struct : attribute.sub_struct()) {
+    AddDeclaredTypes(sub_struct, declared_types);
+  }
+  for (const auto& sub_union : attribute.sub_union()) {
+    AddDeclaredTypes(sub_union, declared_types);
+  }
+  for (const auto& sub_safe_union : attribute.sub_safe_union()) {
+    AddDeclaredTypes(sub_safe_union, declared_types);
+  }
+}
+
+namespace {
+
+// Checks the references of the variables of a specification, see
+// ValidateTypeReferences.
+class TypeReferenceValidator {
+ public:
+  explicit TypeReferenceValidator(const ComponentSpecificationMessage& message)
+      : package_version_(
+            message.package() + "@" +
+            std::to_string(message.component_type_version_major()) + "." +
+            std::to_string(message.component_type_version_minor())),
+        component_name_(message.component_name()) {
+    // every interface extends android.hidl.base@1.0::IBase.
+    packages_ = {package_version_, "android.hidl.base@1.0"};
+    for (const auto& import : message.import()) {
+      packages_.insert(import.substr(0, import.find("::")));
+    }
+    const auto& attributes = component_name_ == "types"
+                                 ? message.attribute()
+                                 : message.interface().attribute();
+    for (const auto& attribute : attributes) {
+      AddDeclaredTypes(attribute, &declared_types_);
+    }
+  }
+
+  // Checks var and the variables it contains. context describes where var
+  // is, for the error message.
+  bool Validate(const VariableSpecificationMessage& var,
+                const std::string& context, std::string* error) {
+    if (!var.predefined_type().empty() &&
+        !ValidateReference(var.predefined_type(), var.type())) {
+      *error = "type " + var.predefined_type() + " referenced in " + context +
+               " is not declared in " + package_version_ +
+               "::" + component_name_ + " or its imports.";
+      return false;
+    }
+    for (const auto* fields :
+         {&var.vector_value(), &var.struct_value(), &var.sub_struct(),
+          &var.union_value(), &var.sub_union(), &var.safe_union_value(),
+          &var.sub_safe_union(), &var.fmq_value()}) {
+      for (const auto& field : *fields) {
+        if (!Validate(field, context, error)) return false;
+      }
+    }
+    return !var.has_ref_value() || Validate(var.ref_value(), context, error);
+  }
+
+ private:
+  bool ValidateReference(const std::string& type_name,
+                         VariableType type) const {
+    std::string package_version;
+    std::vector<std::string> names;
+    if (!SplitTypeName(type_name, &package_version, &names) ||
+        packages_.count(package_version) == 0) {
+      return false;
+    }
+    if (!IsUserDefinedType(type) || package_version != package_version_) {
+      return true;
+    }
+    // the types nested in the component are all in this specification.
+    bool nested_in_component;
+    if (component_name_ == "types") {
+      // e.g. ::android::hardware::nfc::V1_0::NfcEvent for NfcEvent::Foo.
+      size_t suffix_size = 0;
+      for (const auto& name : names) suffix_size += name.size() + 2;
+      std::string top_level_type = type_name.substr(
+          0, type_name.size() - suffix_size) + "::" + names[0];
+      nested_in_component =
+          names.size() == 1 || declared_types_.count(top_level_type) > 0;
+    } else {
+      nested_in_component = names[0] == component_name_;
+    }
+    return !nested_in_component || declared_types_.count(type_name) > 0;
+  }
+
+  // the package and version of the component, e.g. android.hardware.nfc@1.0.
+  std::string package_version_;
+  std::string component_name_;
+  // the packages and versions whose types may be referenced.
+  std::set<std::string> packages_;
+  // the names of the types declared in the component.
+  std::set<std::string> declared_types_;
+};
+
+}  // namespace
+
+bool ValidateTypeReferences(const ComponentSpecificationMessage& message,
+                            std::string* error) {
+  TypeReferenceValidator validator(message);
+  const auto& attributes = message.component_name() == "types"
+                               ? message.attribute()
+                               : message.interface().attribute();
+  for (const auto& attribute : attributes) {
+    if (!validator.Validate(attribute, "attribute " + attribute.name(),
+                            error)) {
+      return false;
+    }
+  }
+  for (const auto& api : message.interface().api()) {
+    for (const auto& arg : api.arg()) {
+      if (!validator.Validate(arg, "the arguments of " + api.name(), error)) {
+        return false;
+      }
+    }
+    for (const auto& return_val : api.return_type_hidl()) {
+      if (!validator.Validate(return_val, "the results of " + api.name(),
+                              error)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
 }  // namespace vts
 }  // namespace android
@@ -17,6 +17,8 @@
 #ifndef VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_COMMON_HALHIDLCODEGENUTILS_H_
 #define VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_COMMON_HALHIDLCODEGENUTILS_H_
 
+#include <string>
+
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
 namespace android {
@@ -28,6 +30,22 @@ bool IsElidableType(const VariableType& type);
 bool IsConstType(const VariableType& type);
 // Returns true iff type is a user defined type
 bool IsUserDefinedType(const VariableType& type);
+// Returns true iff a vector or an array with the given element can be handled
+// as raw bytes, i.e. its elements are scalars with a fixed size.
+bool IsRawScalarElement(const VariableSpecificationMessage& element);
+// Returns true iff the values of a type can be handled as raw bytes, i.e. it
+// is an enum, a scalar other than bool_t, or a struct or an array of those,
+// so that it is trivially copyable and every bit pattern is a valid value.
+// A struct field referencing another struct by name is not resolved, and
+// makes the struct not handled as raw bytes.
+bool IsPodType(const VariableSpecificationMessage& var);
+// Checks that the types referenced by predefined_type in a HIDL HAL
+// specification can be resolved by the generated code, i.e. that they are
+// in the package of the component or in an imported one, and that the types
+// nested in the component itself are declared in its attributes. Returns
+// false and sets error to describe the first broken reference otherwise.
+bool ValidateTypeReferences(const ComponentSpecificationMessage& message,
+                            std::string* error);
 }  // namespace vts
 }  // namespace android
 
@@ -322,8 +322,8 @@ void DriverCodeGenBase::GenerateCodeToStartMeasurement(Formatter& out) {
 }
 
 void DriverCodeGenBase::GenerateCodeToStopMeasurement(Formatter& out) {
-  out << "vector<float>* measured = vts_measurement.Stop();" << "\n";
-  out << "LOG(INFO) << \"time \" << (*measured)[0];"
+  out << "VtsMeasurementResult measured = vts_measurement.Stop();" << "\n";
+  out << "LOG(INFO) << \"time \" << measured.elapsed_time_ns << \" ns\";"
       << "\n";
 }
 
@@ -322,48 +322,42 @@ void HalCodeGen::GenerateCppBodyFuzzFunction(
                       arg.predefined_type();  // TODO - check to make sure name
                                               // is always correct
         if (name.back() == '*') name.pop_back();
-        out << name << "* arg" << arg_count << "callback = new ";
-        out << name << "(callback_socket_name);" << "\n";
-        out << "arg" << arg_count << "callback->Register(func_msg->arg("
-            << arg_count << "));" << "\n";
-
-        out << GetCppVariableType(arg) << " ";
-        out << "arg" << arg_count << " = (" << GetCppVariableType(arg)
-            << ") malloc(sizeof(" << GetCppVariableType(arg) << "));"
-            << "\n";
-        // TODO: think about how to free the malloced callback data structure.
         // find the spec.
-        bool found = false;
-        cout << name << "\n";
-        for (auto const& attribute : message.interface().attribute()) {
-          if (attribute.type() == TYPE_FUNCTION_POINTER &&
-              attribute.is_callback()) {
-            string target_name = "vts_callback_" + fuzzer_extended_class_name +
-                                 "_" + attribute.name();
-            cout << "compare" << "\n";
-            cout << target_name << "\n";
-            if (name == target_name) {
-              if (attribute.function_pointer_size() > 1) {
-                for (auto const& func_pt : attribute.function_pointer()) {
-                  out << "arg" << arg_count << "->"
-                      << func_pt.function_name() << " = arg" << arg_count
-                      << "callback->" << func_pt.function_name() << ";"
-                      << "\n";
-                }
-              } else {
-                out << "arg" << arg_count << " = arg" << arg_count
-                    << "callback->" << attribute.name() << ";" << "\n";
-              }
-              found = true;
-              break;
-            }
-          }
-        }
-        if (!found) {
+        const VariableSpecificationMessage* attribute =
+            FindCallbackAttribute(message, arg);
+        if (attribute == NULL) {
           cerr << __func__ << " ERROR callback definition missing for " << name
                << " of " << api.name() << "\n";
           exit(-1);
         }
+        // The callback functions are static, so the object only sets the
+        // socket they are sent to.
+        out << name << " arg" << arg_count << "callback("
+            << "callback_socket_name);" << "\n";
+        out << "arg" << arg_count << "callback.Register(func_msg->arg("
+            << arg_count << "));" << "\n";
+
+        out << GetCppVariableType(arg) << " ";
+        if (attribute->function_pointer_size() > 1) {
+          // The callback data structure is kept by the driver, as the HAL
+          // may hold on to it after the call.
+          string storage = GetArgStorageName(api.name(), arg_count);
+          if (!GetCppStorageType(arg).empty()) {
+            out << "arg" << arg_count << " = &" << storage << ";" << "\n";
+          } else {
+            out << "arg" << arg_count << " = (" << GetCppVariableType(arg)
+                << ") malloc(sizeof(" << GetCppVariableType(arg) << "));"
+                << "\n";
+          }
+          for (auto const& func_pt : attribute->function_pointer()) {
+            out << "arg" << arg_count << "->" << func_pt.function_name()
+                << " = " << name << "::" << func_pt.function_name() << ";"
+                << "\n";
+          }
+        } else {
+          out << "arg" << arg_count << " = " << name << "::"
+              << attribute->name() << ";" << "\n";
+        }
       } else {
         out << GetCppVariableType(arg) << " ";
         out << "arg" << arg_count << " = ";
@@ -420,8 +414,8 @@ void HalCodeGen::GenerateCppBodyFuzzFunction(
           out << "( (" << msg << ".type() == TYPE_PREDEFINED || " << msg
                  << ".type() == TYPE_STRUCT || " << msg
                  << ".type() == TYPE_SCALAR)? ";
-          out << GetCppInstanceType(arg, msg);
-          out << " : " << GetCppInstanceType(arg) << " )";
+          GenerateArgInstance(out, arg, msg,
+                              GetArgStorageName(api.name(), arg_count));
           // TODO: use the given message and call a lib function which converts
           // a message to a C/C++ struct.
         }
@@ -619,8 +613,11 @@ void HalCodeGen::GenerateCppBodyFuzzFunction(
           out << "( (" << msg << ".type() == TYPE_PREDEFINED || " << msg
                  << ".type() == TYPE_STRUCT || " << msg
                  << ".type() == TYPE_SCALAR)? ";
-          out << GetCppInstanceType(arg, msg);
-          out << " : " << GetCppInstanceType(arg) << " )";
+          GenerateArgInstance(
+              out, arg, msg,
+              GetArgStorageName(
+                  GetSubStructFunctionPath(message, parent_path, api),
+                  arg_count));
           // TODO: use the given message and call a lib function which converts
           // a message to a C/C++ struct.
         }
@@ -692,6 +689,117 @@ void HalCodeGen::GenerateCppBodyFuzzFunction(
   out << "}" << "\n";
 }
 
+void HalCodeGen::GeneratePrivateMemberDeclarations(Formatter& out,
+    const ComponentSpecificationMessage& message) {
+  // The instances of the args that are not values are kept for the lifetime
+  // of the driver, and filled in by each call instead of allocated.
+  for (auto const& api : message.interface().api()) {
+    int arg_count = 0;
+    for (auto const& arg : api.arg()) {
+      string storage_type;
+      if (arg.is_callback()) {
+        const VariableSpecificationMessage* attribute =
+            FindCallbackAttribute(message, arg);
+        if (attribute != NULL && attribute->function_pointer_size() > 1) {
+          storage_type = GetCppStorageType(arg);
+        }
+      } else if (!IsInstanceArg(arg, arg_count,
+                                message.original_data_structure_name())) {
+        storage_type = GetCppStorageType(arg);
+      }
+      if (!storage_type.empty()) {
+        out << storage_type << " " << GetArgStorageName(api.name(), arg_count)
+            << " = {};\n";
+      }
+      arg_count++;
+    }
+  }
+  for (auto const& sub_struct : message.interface().sub_struct()) {
+    GenerateSubStructArgStorageDeclarations(
+        out, sub_struct, message.original_data_structure_name(),
+        sub_struct.is_pointer() ? "->" : ".");
+  }
+}
+
+void HalCodeGen::GenerateSubStructArgStorageDeclarations(Formatter& out,
+    const StructSpecificationMessage& message,
+    const string& original_data_structure_name, const string& parent_path) {
+  for (auto const& sub_struct : message.sub_struct()) {
+    GenerateSubStructArgStorageDeclarations(
+        out, sub_struct, original_data_structure_name,
+        parent_path + message.name() + (sub_struct.is_pointer() ? "->" : "."));
+  }
+  for (auto const& api : message.api()) {
+    string function_path = GetSubStructFunctionPath(message, parent_path, api);
+    // The args of open are the module and the device of the driver.
+    if (function_path == "common_methods_open") {
+      continue;
+    }
+    int arg_count = 0;
+    for (auto const& arg : api.arg()) {
+      string storage_type = GetCppStorageType(arg);
+      if (!storage_type.empty() &&
+          !IsInstanceArg(arg, arg_count, original_data_structure_name)) {
+        out << storage_type << " "
+            << GetArgStorageName(function_path, arg_count) << " = {};\n";
+      }
+      arg_count++;
+    }
+  }
+}
+
+void HalCodeGen::GenerateArgInstance(Formatter& out,
+    const VariableSpecificationMessage& arg, const string& msg,
+    const string& storage) {
+  if (GetCppStorageType(arg).empty()) {
+    out << GetCppInstanceType(arg, msg);
+    out << " : " << GetCppInstanceType(arg) << " )";
+  } else {
+    out << GetCppInstanceTypeInStorage(arg, storage, msg);
+    out << " : " << GetCppInstanceTypeInStorage(arg, storage) << " )";
+  }
+}
+
+bool HalCodeGen::IsInstanceArg(const VariableSpecificationMessage& arg,
+    int arg_index, const string& original_data_structure_name) {
+  return arg_index == 0 && arg.type() == TYPE_PREDEFINED &&
+         !strncmp(arg.predefined_type().c_str(),
+                  original_data_structure_name.c_str(),
+                  original_data_structure_name.length());
+}
+
+const VariableSpecificationMessage* HalCodeGen::FindCallbackAttribute(
+    const ComponentSpecificationMessage& message,
+    const VariableSpecificationMessage& arg) {
+  string name = arg.predefined_type();
+  if (!name.empty() && name.back() == '*') name.pop_back();
+  for (auto const& attribute : message.interface().attribute()) {
+    if (attribute.type() == TYPE_FUNCTION_POINTER && attribute.is_callback() &&
+        attribute.name() == name) {
+      return &attribute;
+    }
+  }
+  return NULL;
+}
+
+string HalCodeGen::GetSubStructFunctionPath(
+    const StructSpecificationMessage& message, const string& parent_path,
+    const FunctionSpecificationMessage& api) {
+  string parent_path_printable(parent_path);
+  ReplaceSubString(parent_path_printable, "->", "_");
+  replace(parent_path_printable.begin(), parent_path_printable.end(), '.', '_');
+  // The path of a sub struct of the component starts with a separator.
+  if (!parent_path_printable.empty() && parent_path_printable[0] == '_') {
+    parent_path_printable.erase(0, 1);
+  }
+  return parent_path_printable + message.name() + "_" + api.name();
+}
+
+string HalCodeGen::GetArgStorageName(const string& function_path,
+                                     int arg_index) {
+  return function_path + "_arg" + to_string(arg_index) + "_";
+}
+
 void HalCodeGen::GenerateCppBodyGetAttributeFunction(
     Formatter& out, const ComponentSpecificationMessage& message,
     const string& fuzzer_extended_class_name) {
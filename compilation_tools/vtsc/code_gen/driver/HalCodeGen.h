@@ -50,6 +50,9 @@ class HalCodeGen : public DriverCodeGenBase {
       const ComponentSpecificationMessage& message,
       const string& fuzzer_extended_class_name) override;
 
+  void GeneratePrivateMemberDeclarations(Formatter& out,
+      const ComponentSpecificationMessage& message) override;
+
   void GenerateSubStructFuzzFunctionCall(Formatter& out,
       const StructSpecificationMessage& message, const string& parent_path);
 
@@ -66,6 +69,38 @@ class HalCodeGen : public DriverCodeGenBase {
       const string& fuzzer_extended_class_name,
       const string& original_data_structure_name, const string& parent_path);
 
+  // Generates the declarations of the driver members that the instances of
+  // the args of the functions of a sub struct are generated in.
+  void GenerateSubStructArgStorageDeclarations(Formatter& out,
+      const StructSpecificationMessage& message,
+      const string& original_data_structure_name, const string& parent_path);
+
+  // Generates the instance of arg from msg if it has a value, or a random
+  // one otherwise. The instances that would be allocated are generated in
+  // storage, the driver member declared for arg.
+  void GenerateArgInstance(Formatter& out,
+      const VariableSpecificationMessage& arg, const string& msg,
+      const string& storage);
+
+  // Returns whether arg is the device or module the function is called on.
+  static bool IsInstanceArg(const VariableSpecificationMessage& arg,
+      int arg_index, const string& original_data_structure_name);
+
+  // Returns the attribute that defines the callback arg, or NULL.
+  static const VariableSpecificationMessage* FindCallbackAttribute(
+      const ComponentSpecificationMessage& message,
+      const VariableSpecificationMessage& arg);
+
+  // Returns the path of a function of a sub struct, e.g.
+  // "common_methods_open".
+  static string GetSubStructFunctionPath(
+      const StructSpecificationMessage& message, const string& parent_path,
+      const FunctionSpecificationMessage& api);
+
+  // Returns the name of the driver member that the instance of the
+  // arg_index-th arg of a function is generated in, e.g. "init_arg0_".
+  static string GetArgStorageName(const string& function_path, int arg_index);
+
   // instance variable name (e.g., device_);
   static const char* const kInstanceVariableName;
 };
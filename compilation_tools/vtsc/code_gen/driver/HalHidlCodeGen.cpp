@@ -24,6 +24,7 @@
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 #include "utils/InterfaceSpecUtil.h"
 #include "utils/StringUtil.h"
+#include "utils/TypeConversionUtil.h"
 
 using namespace std;
 using namespace android;
@@ -172,9 +173,45 @@ void HalHidlCodeGen::GenerateDriverFunctionImpl(Formatter& out,
     out.indent();
     out << "const FunctionSpecificationMessage& func_msg,"
         << "\n";
-    out << "const string& callback_socket_name __attribute__((__unused__)),"
+    out << "const string& callback_socket_name,"
         << "\n";
     out << "FunctionSpecificationMessage* result_msg) {\n";
+    out << "return CallFunctionInternal(func_msg, callback_socket_name, "
+        << "result_msg, nullptr, nullptr);\n";
+    out.unindent();
+    out << "}\n\n";
+
+    // verifies the C++ values returned by the HAL, so only the name of the
+    // call is set in result_msg.
+    out << "bool " << fuzzer_extended_class_name << "::CallFunctionAndVerify("
+        << "\n";
+    out.indent();
+    out << "const FunctionSpecificationMessage& func_msg,"
+        << "\n";
+    out << "const string& callback_socket_name,"
+        << "\n";
+    out << "const FunctionSpecificationMessage& expected_result,"
+        << "\n";
+    out << "bool* verified) {\n";
+    out << "FunctionSpecificationMessage result_msg;\n";
+    out << "*verified = false;\n";
+    out << "return CallFunctionInternal(func_msg, callback_socket_name, "
+        << "&result_msg, &expected_result, verified);\n";
+    out.unindent();
+    out << "}\n\n";
+
+    out << "bool " << fuzzer_extended_class_name << "::CallFunctionInternal("
+        << "\n";
+    out.indent();
+    out << "const FunctionSpecificationMessage& func_msg,"
+        << "\n";
+    out << "const string& callback_socket_name __attribute__((__unused__)),"
+        << "\n";
+    out << "FunctionSpecificationMessage* result_msg,"
+        << "\n";
+    out << "const FunctionSpecificationMessage* expected_result,"
+        << "\n";
+    out << "bool* verified) {\n";
 
     out << "const char* func_name = func_msg.name().c_str();" << "\n";
     out << "if (hw_binder_proxy_ == nullptr) {\n";
@@ -183,11 +220,19 @@ void HalHidlCodeGen::GenerateDriverFunctionImpl(Formatter& out,
     out << "return false;\n";
     out.unindent();
     out << "}\n";
+    vector<string> names;
     for (auto const& api : message.interface().api()) {
-      GenerateDriverImplForMethod(out, api);
+      names.push_back(api.name());
     }
-
-    GenerateDriverImplForReservedMethods(out);
+    // reserved methods come last.
+    names.push_back("notifySyspropsChanged");
+    GenerateSwitchOnName(out, "func_name", names, [&](size_t index) {
+      if (index < static_cast<size_t>(message.interface().api_size())) {
+        GenerateDriverImplForMethod(out, message.interface().api(index));
+      } else {
+        GenerateDriverImplForReservedMethods(out);
+      }
+    });
 
     out << "return false;\n";
     out.unindent();
@@ -195,6 +240,41 @@ void HalHidlCodeGen::GenerateDriverFunctionImpl(Formatter& out,
   }
 }
 
+void HalHidlCodeGen::GenerateSwitchOnName(Formatter& out,
+    const string& name_expr, const vector<string>& names,
+    const function<void(size_t index)>& generate_case) {
+  // group the names by hash, keeping the order of first appearance.
+  vector<uint32_t> hashes;
+  vector<vector<size_t>> cases;
+  for (size_t i = 0; i < names.size(); i++) {
+    uint32_t hash = HashString(names[i].c_str());
+    size_t case_index = 0;
+    while (case_index < hashes.size() && hashes[case_index] != hash) {
+      case_index++;
+    }
+    if (case_index == hashes.size()) {
+      hashes.push_back(hash);
+      cases.emplace_back();
+    }
+    cases[case_index].push_back(i);
+  }
+
+  out << "switch (HashString(" << name_expr << ")) {\n";
+  out.indent();
+  for (const auto& indices : cases) {
+    out << "case HashString(\"" << names[indices[0]] << "\"): {\n";
+    out.indent();
+    for (size_t index : indices) {
+      generate_case(index);
+    }
+    out << "break;\n";
+    out.unindent();
+    out << "}\n";
+  }
+  out.unindent();
+  out << "}\n";
+}
+
 void HalHidlCodeGen::GenerateDriverImplForReservedMethods(Formatter& out) {
   // Generate call for reserved method: notifySyspropsChanged.
   out << "if (!strcmp(func_name, \"notifySyspropsChanged\")) {\n";
@@ -204,6 +284,8 @@ void HalHidlCodeGen::GenerateDriverImplForReservedMethods(Formatter& out) {
       << "\n";
   out << kInstanceVariableName << "->notifySyspropsChanged();\n";
   out << "result_msg->set_name(\"notifySyspropsChanged\");\n";
+  FunctionSpecificationMessage reserved_method;
+  GenerateResultCodeForMethod(out, reserved_method, "result");
   out << "return true;\n";
 
   out.unindent();
@@ -252,17 +334,12 @@ void HalHidlCodeGen::GenerateDriverImplForMethod(Formatter& out,
   if (CanElideCallback(func_msg)) {
     out << GetCppVariableType(func_msg.return_type_hidl(0)) << " result0 = ";
     GenerateHalFunctionCall(out, func_msg);
-    // Set the return results value to the proto message.
-    for (int index = 0; index < func_msg.return_type_hidl_size(); index++) {
-      out << "VariableSpecificationMessage* result_val_" << index << " = "
-          << "result_msg->add_return_type_hidl();\n";
-      GenerateSetResultCodeForTypedVariable(
-          out, func_msg.return_type_hidl(index),
-          "result_val_" + std::to_string(index),
-          "result" + std::to_string(index));
-    }
+    GenerateResultCodeForMethod(out, func_msg, "result");
   } else {
     GenerateHalFunctionCall(out, func_msg);
+    if (func_msg.return_type_hidl_size() == 0) {
+      GenerateResultCodeForMethod(out, func_msg, "result");
+    }
   }
 
   out << "return true;\n";
@@ -307,17 +384,40 @@ void HalHidlCodeGen::GenerateSyncCallbackFunctionImpl(Formatter& out,
   out << "LOG(INFO) << \"callback " << func_msg.name() << " called\""
       << ";\n";
 
-  // Set the return results value to the proto message.
   out << "result_msg->set_name(\"" << func_msg.name() << "\");\n";
-  for (int index = 0; index < func_msg.return_type_hidl_size(); index++) {
+  GenerateResultCodeForMethod(out, func_msg, "arg");
+  out.unindent();
+  out << "}";
+}
+
+void HalHidlCodeGen::GenerateResultCodeForMethod(Formatter& out,
+    const FunctionSpecificationMessage& func_msg, const string& value_prefix) {
+  int size = func_msg.return_type_hidl_size();
+  out << "if (expected_result != nullptr) {\n";
+  out.indent();
+  out << "*verified = expected_result->return_type_hidl_size() == " << size;
+  for (int index = 0; index < size; index++) {
+    out << " && VerifyValue(expected_result->return_type_hidl(" << index
+        << "), " << value_prefix << index << ")";
+  }
+  out << ";\n";
+  out.unindent();
+  if (size == 0) {
+    out << "}\n";
+    return;
+  }
+  out << "} else {\n";
+  out.indent();
+  // Set the return results value to the proto message.
+  for (int index = 0; index < size; index++) {
     out << "VariableSpecificationMessage* result_val_" << index << " = "
         << "result_msg->add_return_type_hidl();\n";
     GenerateSetResultCodeForTypedVariable(out, func_msg.return_type_hidl(index),
                                           "result_val_" + std::to_string(index),
-                                          "arg" + std::to_string(index));
+                                          value_prefix + std::to_string(index));
   }
   out.unindent();
-  out << "}";
+  out << "}\n";
 }
 
 void HalHidlCodeGen::GenerateCppBodyGetAttributeFunction(
@@ -505,6 +605,7 @@ void HalHidlCodeGen::GenerateClassImpl(Formatter& out,
     for (const auto& attribute : message.interface().attribute()) {
       GenerateAllFunctionImplForAttribute(out, attribute);
     }
+    GenerateTypeConversionTable(out, message, message.interface().attribute());
     GenerateGetServiceImpl(out, message, fuzzer_extended_class_name);
     DriverCodeGenBase::GenerateClassImpl(out, message,
                                          fuzzer_extended_class_name);
@@ -512,6 +613,7 @@ void HalHidlCodeGen::GenerateClassImpl(Formatter& out,
     for (const auto& attribute : message.attribute()) {
       GenerateAllFunctionImplForAttribute(out, attribute);
     }
+    GenerateTypeConversionTable(out, message, message.attribute());
   }
 }
 
@@ -524,6 +626,7 @@ void HalHidlCodeGen::GenerateHeaderIncludeFiles(Formatter& out,
       << "/" << GetComponentName(message) << ".h>"
       << "\n";
   out << "#include <hidl/HidlSupport.h>" << "\n";
+  out << "#include <utils/VerificationUtil.h>" << "\n";
 
   for (const auto& import : message.import()) {
     FQName import_name;
@@ -559,10 +662,14 @@ void HalHidlCodeGen::GenerateSourceIncludeFiles(Formatter& out,
   DriverCodeGenBase::GenerateSourceIncludeFiles(out, message,
                                                 fuzzer_extended_class_name);
   out << "#include <android/hidl/allocator/1.0/IAllocator.h>\n";
+  out << "#include <driver_base/HidlServiceCache.h>\n";
   out << "#include <fcntl.h>\n";
   out << "#include <fmq/MessageQueue.h>\n";
   out << "#include <sys/stat.h>\n";
   out << "#include <unistd.h>\n";
+  out << "#include <utils/InterfaceSpecUtil.h>\n";
+  out << "#include <utils/StringUtil.h>\n";
+  out << "#include <utils/TypeConversionUtil.h>\n";
 }
 
 void HalHidlCodeGen::GenerateAdditionalFuctionDeclarations(Formatter& out,
@@ -571,6 +678,15 @@ void HalHidlCodeGen::GenerateAdditionalFuctionDeclarations(Formatter& out,
   if (message.component_name() != "types") {
     out << "bool GetService(bool get_stub, const char* service_name);"
         << "\n\n";
+    out << "bool CallFunctionAndVerify(const FunctionSpecificationMessage& "
+        << "func_msg, const string& callback_socket_name, "
+        << "const FunctionSpecificationMessage& expected_result, "
+        << "bool* verified) override;\n";
+    out << "bool CallFunctionInternal(const FunctionSpecificationMessage& "
+        << "func_msg, const string& callback_socket_name, "
+        << "FunctionSpecificationMessage* result_msg, "
+        << "const FunctionSpecificationMessage* expected_result, "
+        << "bool* verified);\n\n";
   }
 }
 
@@ -605,58 +721,26 @@ void HalHidlCodeGen::GenerateRandomFunctionDeclForAttribute(Formatter& out,
 
 void HalHidlCodeGen::GenerateRandomFunctionImplForAttribute(Formatter& out,
     const VariableSpecificationMessage& attribute) {
-  // Random value generator
+  // Random value generator, picking one of the enumerators from a table.
   if (attribute.type() == TYPE_ENUM) {
     if (attribute.enum_value().enumerator_size() == 0) {
       // empty enum without any actual enumerator.
       return;
     }
     string attribute_name = ClearStringWithNameSpaceAccess(attribute.name());
-    out << attribute.enum_value().scalar_type() << " Random" << attribute_name
-        << "() {\n";
+    const string& scalar_type = attribute.enum_value().scalar_type();
+    out << scalar_type << " Random" << attribute_name << "() {\n";
     out.indent();
-    out << attribute.enum_value().scalar_type() << " choice = " << "("
-        << attribute.enum_value().scalar_type() << ") " << "rand() / "
-        << attribute.enum_value().enumerator().size() << ";" << "\n";
-    if (attribute.enum_value().scalar_type().find("u") != 0) {
-      out << "if (choice < 0) choice *= -1;" << "\n";
-    }
-    for (int index = 0; index < attribute.enum_value().enumerator().size();
-        index++) {
-      out << "if (choice == ";
-      out << "(" << attribute.enum_value().scalar_type() << ") ";
-      if (attribute.enum_value().scalar_type() == "int8_t") {
-        out << attribute.enum_value().scalar_value(index).int8_t();
-      } else if (attribute.enum_value().scalar_type() == "uint8_t") {
-        out << attribute.enum_value().scalar_value(index).uint8_t() << "U";
-      } else if (attribute.enum_value().scalar_type() == "int16_t") {
-        out << attribute.enum_value().scalar_value(index).int16_t();
-      } else if (attribute.enum_value().scalar_type() == "uint16_t") {
-        out << attribute.enum_value().scalar_value(index).uint16_t() << "U";
-      } else if (attribute.enum_value().scalar_type() == "int32_t") {
-        out << attribute.enum_value().scalar_value(index).int32_t() << "L";
-      } else if (attribute.enum_value().scalar_type() == "uint32_t") {
-        out << attribute.enum_value().scalar_value(index).uint32_t() << "UL";
-      } else if (attribute.enum_value().scalar_type() == "int64_t") {
-        if (attribute.enum_value().scalar_value(index).int64_t() == LLONG_MIN) {
-          out << "LLONG_MIN";
-        } else {
-          out << attribute.enum_value().scalar_value(index).int64_t() << "LL";
-        }
-      } else if (attribute.enum_value().scalar_type() == "uint64_t") {
-        out << attribute.enum_value().scalar_value(index).uint64_t() << "ULL";
-      } else {
-        cerr << __func__ << ":" << __LINE__ << " ERROR unsupported enum type "
-            << attribute.enum_value().scalar_type() << "\n";
-        exit(-1);
-      }
-      out << ") return static_cast<" << attribute.enum_value().scalar_type()
-          << ">(" << attribute.name()
-          << "::" << attribute.enum_value().enumerator(index) << ");\n";
+    out << "static const " << scalar_type << " kValues[] = {\n";
+    out.indent();
+    for (const auto& enumerator : attribute.enum_value().enumerator()) {
+      out << "static_cast<" << scalar_type << ">(" << attribute.name()
+          << "::" << enumerator << "),\n";
     }
-    out << "return static_cast<" << attribute.enum_value().scalar_type() << ">("
-        << attribute.name() << "::" << attribute.enum_value().enumerator(0)
-        << ");\n";
+    out.unindent();
+    out << "};\n";
+    out << "return kValues[RandomIndex(sizeof(kValues) / sizeof(kValues[0]))];"
+        << "\n";
     out.unindent();
     out << "}" << "\n";
   }
@@ -767,9 +851,6 @@ void HalHidlCodeGen::GenerateGetServiceImpl(Formatter& out,
   out << "bool " << fuzzer_extended_class_name
       << "::GetService(bool get_stub, const char* service_name) {" << "\n";
   out.indent();
-  out << "static bool initialized = false;" << "\n";
-  out << "if (!initialized) {" << "\n";
-  out.indent();
   out << "LOG(INFO) << \"HIDL getService\";"
       << "\n";
   out << "if (service_name) {\n"
@@ -777,8 +858,9 @@ void HalHidlCodeGen::GenerateGetServiceImpl(Formatter& out,
       << "\n"
       << "}\n";
   FQName fqname = GetFQName(message);
-  out << kInstanceVariableName << " = " << fqname.cppName() << "::getService("
-      << "service_name, get_stub);" << "\n";
+  // Drivers of the same HAL share the service through HidlServiceCache.
+  out << kInstanceVariableName << " = GetCachedHidlService<"
+      << fqname.cppName() << ">(service_name, get_stub);" << "\n";
   out << "if (" << kInstanceVariableName << " == nullptr) {\n";
   out.indent();
   out << "LOG(ERROR) << \"getService() returned a null pointer.\";\n";
@@ -788,9 +870,6 @@ void HalHidlCodeGen::GenerateGetServiceImpl(Formatter& out,
   out << "LOG(DEBUG) << \"" << kInstanceVariableName << " = \" << "
       << kInstanceVariableName << ".get();"
       << "\n";
-  out << "initialized = true;" << "\n";
-  out.unindent();
-  out << "}" << "\n";
   out << "return true;" << "\n";
   out.unindent();
   out << "}" << "\n" << "\n";
@@ -834,6 +913,46 @@ void HalHidlCodeGen::GenerateDriverImplForTypedVariable(Formatter& out,
     }
     case TYPE_VECTOR:
     {
+      bool raw_elements = IsRawScalarElement(val.vector_value(0));
+      if (raw_elements) {
+        // Wrap the elements in the shared memory instead of copying them
+        // out of the message one by one.
+        string element_type = GetCppVariableType(val.vector_value(0));
+        string region = arg_value_name + ".vector_memory_region()";
+        string count = GetVarString(arg_name) + "_count";
+        string elements = GetVarString(arg_name) + "_elements";
+        out << "if (" << arg_value_name << ".has_vector_memory_region()) {\n";
+        out.indent();
+        out << "size_t " << count << ";\n";
+        out << element_type << "* " << elements
+            << " = GetMemoryRegionElements<" << element_type << ">(" << region
+            << ", &" << count << ");\n";
+        out << "if (" << elements << " != nullptr) {\n";
+        out.indent();
+        out << arg_name << ".setToExternal(" << elements << ", " << count
+            << ");\n";
+        out.unindent();
+        out << "} else {\n";
+        out.indent();
+        out << "LOG(ERROR) << \"memory region is not an array of "
+            << element_type << ".\";\n";
+        out.unindent();
+        out << "}\n";
+        out.unindent();
+        // Copy the raw bytes in one go if the elements are packed.
+        string raw_value = arg_value_name + ".vector_raw_value()";
+        out << "} else if (" << arg_value_name
+            << ".has_vector_raw_value()) {\n";
+        out.indent();
+        out << arg_name << ".resize(" << raw_value << ".size() / sizeof("
+            << element_type << "));\n";
+        out << "memcpy(" << arg_name << ".data(), " << raw_value
+            << ".data(), " << arg_name << ".size() * sizeof(" << element_type
+            << "));\n";
+        out.unindent();
+        out << "} else {\n";
+        out.indent();
+      }
       out << arg_name << ".resize(" << arg_value_name
           << ".vector_value_size());\n";
       std::string index_name = GetVarString(arg_name) + "_index";
@@ -846,10 +965,29 @@ void HalHidlCodeGen::GenerateDriverImplForTypedVariable(Formatter& out,
           arg_value_name + ".vector_value(" + index_name + ")");
       out.unindent();
       out << "}\n";
+      if (raw_elements) {
+        out.unindent();
+        out << "}\n";
+      }
       break;
     }
     case TYPE_ARRAY:
     {
+      bool raw_elements = IsRawScalarElement(val.vector_value(0));
+      if (raw_elements) {
+        // Copy the raw bytes in one go if the elements are packed.
+        string element_type = GetCppVariableType(val.vector_value(0));
+        string raw_value = arg_value_name + ".vector_raw_value()";
+        string array_size = std::to_string(val.vector_size()) + " * sizeof(" +
+                            element_type + ")";
+        out << "if (" << raw_value << ".size() == " << array_size << ") {\n";
+        out.indent();
+        out << "memcpy(&" << arg_name << "[0], " << raw_value << ".data(), "
+            << array_size << ");\n";
+        out.unindent();
+        out << "} else {\n";
+        out.indent();
+      }
       std::string index_name = GetVarString(arg_name) + "_index";
       out << "for (int " << index_name << " = 0; " << index_name << " < "
           << arg_value_name << ".vector_value_size(); " << index_name
@@ -860,6 +998,10 @@ void HalHidlCodeGen::GenerateDriverImplForTypedVariable(Formatter& out,
           arg_value_name + ".vector_value(" + index_name + ")");
       out.unindent();
       out << "}\n";
+      if (raw_elements) {
+        out.unindent();
+        out << "}\n";
+      }
       break;
     }
     case TYPE_STRUCT:
@@ -1181,7 +1323,13 @@ void HalHidlCodeGen::GenerateVerificationFunctionImpl(Formatter& out,
         << "\n";
     out << "const FunctionSpecificationMessage& actual_result "
            "__attribute__((__unused__))) {\n";
+    vector<string> names;
     for (const FunctionSpecificationMessage& api : message.interface().api()) {
+      names.push_back(api.name());
+    }
+    GenerateSwitchOnName(out, "actual_result.name().c_str()", names,
+                         [&](size_t index) {
+      const FunctionSpecificationMessage& api = message.interface().api(index);
       out << "if (!strcmp(actual_result.name().c_str(), \"" << api.name()
           << "\")) {\n";
       out.indent();
@@ -1200,7 +1348,7 @@ void HalHidlCodeGen::GenerateVerificationFunctionImpl(Formatter& out,
       out << "return true;\n";
       out.unindent();
       out << "}\n";
-    }
+    });
     out << "return false;\n";
     out.unindent();
     out << "}\n\n";
@@ -1249,6 +1397,11 @@ void HalHidlCodeGen::GenerateVerificationCodeForTypedVariable(Formatter& out,
     }
     case TYPE_VECTOR:
     {
+      bool raw_elements = IsRawScalarElement(val.vector_value(0));
+      if (raw_elements) {
+        GenerateVerificationCodeForRawElements(out, val.vector_value(0),
+                                               expected_result, actual_result);
+      }
       out << "if (" << actual_result << ".vector_value_size() != "
           << expected_result << ".vector_value_size()) {\n";
       out.indent();
@@ -1267,10 +1420,19 @@ void HalHidlCodeGen::GenerateVerificationCodeForTypedVariable(Formatter& out,
           actual_result + ".vector_value(i)");
       out.unindent();
       out << "}\n";
+      if (raw_elements) {
+        out.unindent();
+        out << "}\n";
+      }
       break;
     }
     case TYPE_ARRAY:
     {
+      bool raw_elements = IsRawScalarElement(val.vector_value(0));
+      if (raw_elements) {
+        GenerateVerificationCodeForRawElements(out, val.vector_value(0),
+                                               expected_result, actual_result);
+      }
       out << "if (" << actual_result << ".vector_value_size() != "
           << expected_result << ".vector_value_size()) {\n";
       out.indent();
@@ -1289,6 +1451,10 @@ void HalHidlCodeGen::GenerateVerificationCodeForTypedVariable(Formatter& out,
           actual_result + ".vector_value(i)");
       out.unindent();
       out << "}\n";
+      if (raw_elements) {
+        out.unindent();
+        out << "}\n";
+      }
       break;
     }
     case TYPE_STRUCT:
@@ -1383,6 +1549,28 @@ void HalHidlCodeGen::GenerateVerificationCodeForTypedVariable(Formatter& out,
   }
 }
 
+void HalHidlCodeGen::GenerateVerificationCodeForRawElements(Formatter& out,
+    const VariableSpecificationMessage& element, const string& expected_result,
+    const string& actual_result) {
+  auto values = [&element](const string& var) {
+    return "GetScalarVectorValues<" + GetCppVariableType(element) + ">(" +
+           var + ", &ScalarDataValueMessage::" + element.scalar_type() + ")";
+  };
+  out << "if (" << actual_result << ".has_vector_raw_value() || "
+      << expected_result << ".has_vector_raw_value()) {\n";
+  out.indent();
+  out << "if (" << values(expected_result) << " != " << values(actual_result)
+      << ") {\n";
+  out.indent();
+  out << "LOG(ERROR) << \"Verification failed for raw vector value.\";\n";
+  out << "return false;\n";
+  out.unindent();
+  out << "}\n";
+  out.unindent();
+  out << "} else {\n";
+  out.indent();
+}
+
 void HalHidlCodeGen::GenerateVerificationDeclForAttribute(Formatter& out,
     const VariableSpecificationMessage& attribute) {
   if (attribute.type() == TYPE_STRUCT || attribute.type() == TYPE_UNION) {
@@ -1433,18 +1621,15 @@ void HalHidlCodeGen::GenerateSetResultCodeForTypedVariable(Formatter& out,
   switch (val.type()) {
     case TYPE_SCALAR:
     {
-      out << result_msg << "->set_type(TYPE_SCALAR);\n";
-      out << result_msg << "->set_scalar_type(\"" << val.scalar_type()
-          << "\");\n";
-      out << result_msg << "->mutable_scalar_value()->set_" << val.scalar_type()
-          << "(" << result_value << ");\n";
+      out << "SetScalarResult<" << GetCppVariableType(val.scalar_type())
+          << ">(" << result_msg << ", " << result_value << ");\n";
       break;
     }
     case TYPE_STRING:
     {
       out << result_msg << "->set_type(TYPE_STRING);\n";
       out << result_msg << "->mutable_string_value()->set_message" << "("
-          << result_value << ".c_str());\n";
+          << result_value << ".c_str(), " << result_value << ".size());\n";
       out << result_msg << "->mutable_string_value()->set_length" << "("
           << result_value << ".size());\n";
       break;
@@ -1479,6 +1664,17 @@ void HalHidlCodeGen::GenerateSetResultCodeForTypedVariable(Formatter& out,
       out << result_msg << "->set_type(TYPE_VECTOR);\n";
       out << result_msg << "->set_vector_size(" << result_value
           << ".size());\n";
+      if (IsRawScalarElement(val.vector_value(0))) {
+        // Copy the elements in one go instead of adding a message per element.
+        out << result_msg << "->set_scalar_type(\""
+            << val.vector_value(0).scalar_type() << "\");\n";
+        out << result_msg << "->set_vector_raw_value(" << result_value
+            << ".data(), " << result_value << ".size() * sizeof("
+            << GetCppVariableType(val.vector_value(0)) << "));\n";
+        break;
+      }
+      out << result_msg << "->mutable_vector_value()->Reserve("
+          << result_value << ".size());\n";
       out << "for (int i = 0; i < (int)" << result_value << ".size(); i++) {\n";
       out.indent();
       string vector_element_name = result_msg + "_vector_i";
@@ -1494,6 +1690,17 @@ void HalHidlCodeGen::GenerateSetResultCodeForTypedVariable(Formatter& out,
     case TYPE_ARRAY:
     {
       out << result_msg << "->set_type(TYPE_ARRAY);\n";
+      if (IsRawScalarElement(val.vector_value(0))) {
+        // Copy the elements in one go instead of adding a message per element.
+        out << result_msg << "->set_vector_size(" << val.vector_size()
+            << ");\n";
+        out << result_msg << "->set_scalar_type(\""
+            << val.vector_value(0).scalar_type() << "\");\n";
+        out << result_msg << "->set_vector_raw_value(&" << result_value
+            << "[0], " << val.vector_size() << " * sizeof("
+            << GetCppVariableType(val.vector_value(0)) << "));\n";
+        break;
+      }
       out << result_msg << "->set_vector_size(" << val.vector_value_size()
           << ");\n";
       out << "for (int i = 0; i < " << val.vector_value_size() << "; i++) {\n";
@@ -1687,8 +1894,9 @@ void HalHidlCodeGen::GenerateSetResultDeclForAttribute(Formatter& out,
   out << "extern \"C\" ";
   string func_name = "void SetResult"
       + ClearStringWithNameSpaceAccess(attribute.name());
-  out << func_name << "(VariableSpecificationMessage* result_msg, "
-      << attribute.name() << " result_value);\n";
+  // Take the value by reference, so that structs are not copied per call.
+  out << func_name << "(VariableSpecificationMessage* result_msg, const "
+      << attribute.name() << "& result_value);\n";
 }
 
 void HalHidlCodeGen::GenerateSetResultImplForAttribute(Formatter& out,
@@ -1710,8 +1918,8 @@ void HalHidlCodeGen::GenerateSetResultImplForAttribute(Formatter& out,
   out << "extern \"C\" ";
   string func_name = "void SetResult"
       + ClearStringWithNameSpaceAccess(attribute.name());
-  out << func_name << "(VariableSpecificationMessage* result_msg, "
-      << attribute.name() << " result_value __attribute__((__unused__))){\n";
+  out << func_name << "(VariableSpecificationMessage* result_msg, const "
+      << attribute.name() << "& result_value __attribute__((__unused__))){\n";
   out.indent();
   GenerateSetResultCodeForTypedVariable(out, attribute, "result_msg",
                                         "result_value");
@@ -1759,12 +1967,72 @@ void HalHidlCodeGen::GenerateDefaultReturnValForTypedVariable(
   }
 }
 
+void HalHidlCodeGen::GenerateValueVerifierDeclForAttribute(Formatter& out,
+    const VariableSpecificationMessage& attribute) {
+  for (const auto& sub_struct : attribute.sub_struct()) {
+    GenerateValueVerifierDeclForAttribute(out, sub_struct);
+  }
+  for (const auto& sub_union : attribute.sub_union()) {
+    GenerateValueVerifierDeclForAttribute(out, sub_union);
+  }
+  for (const auto& sub_safe_union : attribute.sub_safe_union()) {
+    GenerateValueVerifierDeclForAttribute(out, sub_safe_union);
+  }
+  if (attribute.type() != TYPE_STRUCT && attribute.type() != TYPE_UNION) {
+    return;
+  }
+  out << "template <>\n";
+  out << "struct VtsValueVerifier<" << attribute.name() << "> {\n";
+  out.indent();
+  out << "static bool Verify(const VariableSpecificationMessage& "
+      << "expected_result, const " << attribute.name() << "& actual_value);\n";
+  out.unindent();
+  out << "};\n";
+}
+
+void HalHidlCodeGen::GenerateValueVerifierImplForAttribute(Formatter& out,
+    const VariableSpecificationMessage& attribute) {
+  for (const auto& sub_struct : attribute.sub_struct()) {
+    GenerateValueVerifierImplForAttribute(out, sub_struct);
+  }
+  for (const auto& sub_union : attribute.sub_union()) {
+    GenerateValueVerifierImplForAttribute(out, sub_union);
+  }
+  for (const auto& sub_safe_union : attribute.sub_safe_union()) {
+    GenerateValueVerifierImplForAttribute(out, sub_safe_union);
+  }
+  if (attribute.type() != TYPE_STRUCT && attribute.type() != TYPE_UNION) {
+    return;
+  }
+  // the fields are in struct_value or union_value, as SetResult sets them.
+  bool is_struct = attribute.type() == TYPE_STRUCT;
+  const auto& fields =
+      is_struct ? attribute.struct_value() : attribute.union_value();
+  string fields_name = is_struct ? "struct_value" : "union_value";
+  out << "bool VtsValueVerifier<" << attribute.name()
+      << ">::Verify(const VariableSpecificationMessage& expected_result, "
+      << "const " << attribute.name()
+      << "& actual_value __attribute__((__unused__))) {\n";
+  out.indent();
+  out << "if (expected_result." << fields_name << "_size() != "
+      << fields.size() << ") { return false; }\n";
+  for (int i = 0; i < fields.size(); i++) {
+    out << "if (!VerifyValue(expected_result." << fields_name << "(" << i
+        << "), actual_value." << fields.Get(i).name()
+        << ")) { return false; }\n";
+  }
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+}
+
 void HalHidlCodeGen::GenerateAllFunctionDeclForAttribute(Formatter& out,
     const VariableSpecificationMessage& attribute) {
   GenerateDriverDeclForAttribute(out, attribute);
   GenerateRandomFunctionDeclForAttribute(out, attribute);
   GenerateVerificationDeclForAttribute(out, attribute);
   GenerateSetResultDeclForAttribute(out, attribute);
+  GenerateValueVerifierDeclForAttribute(out, attribute);
 }
 
 void HalHidlCodeGen::GenerateAllFunctionImplForAttribute(Formatter& out,
@@ -1773,6 +2041,49 @@ void HalHidlCodeGen::GenerateAllFunctionImplForAttribute(Formatter& out,
   GenerateRandomFunctionImplForAttribute(out, attribute);
   GenerateVerificationImplForAttribute(out, attribute);
   GenerateSetResultImplForAttribute(out, attribute);
+  GenerateValueVerifierImplForAttribute(out, attribute);
+}
+
+void HalHidlCodeGen::GenerateTypeConversionTable(Formatter& out,
+    const ComponentSpecificationMessage& message,
+    const google::protobuf::RepeatedPtrField<VariableSpecificationMessage>&
+        attributes) {
+  if (attributes.empty()) {
+    return;
+  }
+  out << "static const VtsTypeConversionEntry kTypeConversions[] = {\n";
+  out.indent();
+  for (const auto& attribute : attributes) {
+    GenerateTypeConversionEntries(out, attribute);
+  }
+  out.unindent();
+  out << "};\n\n";
+  out << "extern \"C\" const VtsTypeConversionEntry* "
+      << GetTypeConversionsSymbol(GetFQName(message).cppName())
+      << "(size_t* size) {\n";
+  out.indent();
+  out << "*size = sizeof(kTypeConversions) / sizeof(kTypeConversions[0]);\n";
+  out << "return kTypeConversions;\n";
+  out.unindent();
+  out << "}\n\n";
+}
+
+void HalHidlCodeGen::GenerateTypeConversionEntries(Formatter& out,
+    const VariableSpecificationMessage& attribute) {
+  for (const auto& sub_struct : attribute.sub_struct()) {
+    GenerateTypeConversionEntries(out, sub_struct);
+  }
+  for (const auto& sub_union : attribute.sub_union()) {
+    GenerateTypeConversionEntries(out, sub_union);
+  }
+  for (const auto& sub_safe_union : attribute.sub_safe_union()) {
+    GenerateTypeConversionEntries(out, sub_safe_union);
+  }
+  string func_name_suffix = ClearStringWithNameSpaceAccess(attribute.name());
+  out << "MakeTypeConversionEntry<" << attribute.name() << ">(\""
+      << attribute.name() << "\", &MessageTo" << func_name_suffix
+      << ", &SetResult" << func_name_suffix << ", "
+      << (IsPodType(attribute) ? "true" : "false") << "),\n";
 }
 
 bool HalHidlCodeGen::CanElideCallback(
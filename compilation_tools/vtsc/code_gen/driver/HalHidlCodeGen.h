@@ -17,7 +17,9 @@
 #ifndef VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_DRIVER_HALHIDLCODEGEN_H_
 #define VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_DRIVER_HALHIDLCODEGEN_H_
 
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "code_gen/driver/DriverCodeGenBase.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
@@ -108,6 +110,14 @@ class HalHidlCodeGen : public DriverCodeGenBase {
   // Generates a scalar type in C/C++.
   void GenerateScalarTypeInC(Formatter& out, const string& type);
 
+  // Generates a switch on the hash of name_expr, with one case for each
+  // distinct hash of names in the given order. Calls generate_case with the
+  // index of every name in the case; the generated code must compare the
+  // name itself, since different names may have the same hash.
+  void GenerateSwitchOnName(Formatter& out, const string& name_expr,
+      const vector<string>& names,
+      const function<void(size_t index)>& generate_case);
+
   // Generates the driver function implementation for hidl reserved methods.
   void GenerateDriverImplForReservedMethods(Formatter& out);
 
@@ -123,6 +133,14 @@ class HalHidlCodeGen : public DriverCodeGenBase {
   void GenerateSyncCallbackFunctionImpl(Formatter& out,
       const FunctionSpecificationMessage& func_msg);
 
+  // Generates the code that either verifies the values returned by a Hal
+  // function call against expected_result, or sets them to result_msg if
+  // there is no expected result. The values are named value_prefix followed
+  // by their index.
+  void GenerateResultCodeForMethod(Formatter& out,
+      const FunctionSpecificationMessage& func_msg,
+      const string& value_prefix);
+
   // Generates the driver function declaration for attributes defined within
   // an interface or in a types.hal.
   void GenerateDriverDeclForAttribute(Formatter& out,
@@ -153,6 +171,24 @@ class HalHidlCodeGen : public DriverCodeGenBase {
       const VariableSpecificationMessage& val, const string& result_value,
       const string& expected_result);
 
+  // Generates the start of an if-else that compares vectors or arrays of
+  // scalars as values when either side holds them as raw bytes. The caller
+  // generates the per-element comparison in the else branch and closes it.
+  void GenerateVerificationCodeForRawElements(Formatter& out,
+      const VariableSpecificationMessage& element,
+      const string& expected_result, const string& actual_result);
+
+  // Generates the VtsValueVerifier specialization declarations for the
+  // structs and unions of an attribute and its sub types.
+  void GenerateValueVerifierDeclForAttribute(Formatter& out,
+      const VariableSpecificationMessage& attribute);
+
+  // Generates the VtsValueVerifier specialization implementations for the
+  // structs and unions of an attribute and its sub types, which compare the
+  // fields as C++ values.
+  void GenerateValueVerifierImplForAttribute(Formatter& out,
+      const VariableSpecificationMessage& attribute);
+
   // Generates the SetResult function declarations for attributes defined
   // within an interface or in a types.hal.
   void GenerateSetResultDeclForAttribute(Formatter& out,
@@ -195,6 +231,19 @@ class HalHidlCodeGen : public DriverCodeGenBase {
   void GenerateAllFunctionImplForAttribute(Formatter& out,
       const VariableSpecificationMessage& attribute);
 
+  // Generates the extern "C" table of the conversion functions of all the
+  // attributes of a component, which the resource manager looks up with a
+  // single dlsym per component instead of one per type.
+  void GenerateTypeConversionTable(Formatter& out,
+      const ComponentSpecificationMessage& message,
+      const google::protobuf::RepeatedPtrField<VariableSpecificationMessage>&
+          attributes);
+
+  // Generates the table entries of an attribute and its sub types, in the
+  // order of their MessageTo functions.
+  void GenerateTypeConversionEntries(Formatter& out,
+      const VariableSpecificationMessage& attribute);
+
   // Returns true if we could omit the callback function and return result
   // directly.
   bool CanElideCallback(const FunctionSpecificationMessage& func_msg);
@@ -48,60 +48,7 @@ void LibSharedCodeGen::GenerateCppBodyFuzzFunction(
     // args - definition;
     int arg_count = 0;
     for (auto const& arg : api.arg()) {
-      if (arg_count == 0 && arg.type() == TYPE_PREDEFINED &&
-          !strncmp(arg.predefined_type().c_str(),
-                   message.original_data_structure_name().c_str(),
-                   message.original_data_structure_name().length()) &&
-          message.original_data_structure_name().length() > 0) {
-        out << "    " << GetCppVariableType(arg) << " "
-            << "arg" << arg_count << " = ";
-        out << "reinterpret_cast<" << GetCppVariableType(arg) << ">("
-               << kInstanceVariableName << ")";
-      } else if (arg.type() == TYPE_SCALAR) {
-        if (arg.scalar_type() == "char_pointer" ||
-            arg.scalar_type() == "uchar_pointer") {
-          if (arg.scalar_type() == "char_pointer") {
-            out << "    char ";
-          } else {
-            out << "    unsigned char ";
-          }
-          out << "arg" << arg_count
-                 << "[func_msg->arg(" << arg_count
-                 << ").string_value().length() + 1];" << "\n";
-          out << "    if (func_msg->arg(" << arg_count
-                 << ").type() == TYPE_SCALAR && "
-                 << "func_msg->arg(" << arg_count
-                 << ").string_value().has_message()) {" << "\n";
-          out << "      strcpy(arg" << arg_count << ", "
-                 << "func_msg->arg(" << arg_count << ").string_value()"
-                 << ".message().c_str());" << "\n";
-          out << "    } else {" << "\n";
-          out << "   strcpy(arg" << arg_count << ", "
-                 << GetCppInstanceType(arg) << ");" << "\n";
-          out << "    }" << "\n";
-        } else {
-          out << "    " << GetCppVariableType(arg) << " "
-                 << "arg" << arg_count << " = ";
-          out << "(func_msg->arg(" << arg_count
-                 << ").type() == TYPE_SCALAR && "
-                 << "func_msg->arg(" << arg_count
-                 << ").scalar_value().has_" << arg.scalar_type() << "()) ? ";
-          if (arg.scalar_type() == "void_pointer") {
-            out << "reinterpret_cast<" << GetCppVariableType(arg) << ">(";
-          }
-          out << "func_msg->arg(" << arg_count << ").scalar_value()."
-                 << arg.scalar_type() << "()";
-          if (arg.scalar_type() == "void_pointer") {
-            out << ")";
-          }
-          out << " : " << GetCppInstanceType(arg);
-        }
-      } else {
-        out << "    " << GetCppVariableType(arg) << " "
-               << "arg" << arg_count << " = ";
-        out << GetCppInstanceType(arg);
-      }
-      out << ";" << "\n";
+      GenerateArgDefinition(out, message, arg, arg_count);
       out << "LOG(INFO) << \"arg" << arg_count << " = \" << arg" << arg_count
           << ";\n";
       arg_count++;
@@ -143,6 +90,133 @@ void LibSharedCodeGen::GenerateCppBodyFuzzFunction(
   out << "return false;" << "\n";
   out.unindent();
   out << "}" << "\n";
+
+  GenerateCppBodyFuzzRepeatedFunction(out, message,
+                                      fuzzer_extended_class_name);
+}
+
+void LibSharedCodeGen::GenerateCppBodyFuzzRepeatedFunction(
+    Formatter& out, const ComponentSpecificationMessage& message,
+    const string& fuzzer_extended_class_name) {
+  out << "int " << fuzzer_extended_class_name << "::FuzzRepeated(" << "\n";
+  out << "    FunctionSpecificationMessage* func_msg, int count," << "\n";
+  out << "    const string& callback_socket_name, vector<void*>* results) {"
+      << "\n";
+  out.indent();
+  out << "const char* func_name = func_msg->name().c_str();" << "\n";
+
+  for (auto const& api : message.interface().api()) {
+    out << "if (!strcmp(func_name, \"" << api.name() << "\")) {" << "\n";
+    out.indent();
+    // The function is looked up once for all the calls.
+    out << "typedef void* (*func_type_" << api.name() << ")(...);" << "\n";
+    out << "func_type_" << api.name() << " func = (func_type_" << api.name()
+        << ") target_loader_.GetLoaderFunction(\"" << api.name() << "\");\n";
+    out << "if (func == NULL) return 0;" << "\n";
+
+    // The args that are not scalars point to buffers, which are allocated
+    // once and shared by the calls. The scalars are generated for each call.
+    int arg_count = 0;
+    for (auto const& arg : api.arg()) {
+      if (arg.type() != TYPE_SCALAR) {
+        GenerateArgDefinition(out, message, arg, arg_count);
+      }
+      arg_count++;
+    }
+    out << "for (int i = 0; i < count; i++) {" << "\n";
+    out.indent();
+    arg_count = 0;
+    for (auto const& arg : api.arg()) {
+      if (arg.type() == TYPE_SCALAR) {
+        GenerateArgDefinition(out, message, arg, arg_count);
+      }
+      arg_count++;
+    }
+    if (!api.has_return_type() || api.return_type().type() == TYPE_VOID) {
+      out << "func(";
+    } else {
+      out << "results->push_back(const_cast<void*>("
+          << "reinterpret_cast<const void*>(func(";
+    }
+    for (int index = 0; index < arg_count; index++) {
+      if (index > 0) out << ", ";
+      out << "arg" << index;
+    }
+    if (!api.has_return_type() || api.return_type().type() == TYPE_VOID) {
+      out << ");" << "\n";
+      out << "results->push_back(NULL);" << "\n";
+    } else {
+      out << "))));" << "\n";
+    }
+    out.unindent();
+    out << "}" << "\n";
+    out << "return count;" << "\n";
+    out.unindent();
+    out << "}" << "\n";
+  }
+  out << "return DriverBase::FuzzRepeated(" << "\n";
+  out << "    func_msg, count, callback_socket_name, results);" << "\n";
+  out.unindent();
+  out << "}" << "\n";
+}
+
+void LibSharedCodeGen::GenerateArgDefinition(Formatter& out,
+    const ComponentSpecificationMessage& message,
+    const VariableSpecificationMessage& arg, int arg_index) {
+  if (arg_index == 0 && arg.type() == TYPE_PREDEFINED &&
+      !strncmp(arg.predefined_type().c_str(),
+               message.original_data_structure_name().c_str(),
+               message.original_data_structure_name().length()) &&
+      message.original_data_structure_name().length() > 0) {
+    out << "    " << GetCppVariableType(arg) << " "
+        << "arg" << arg_index << " = ";
+    out << "reinterpret_cast<" << GetCppVariableType(arg) << ">("
+           << kInstanceVariableName << ")";
+  } else if (arg.type() == TYPE_SCALAR) {
+    if (arg.scalar_type() == "char_pointer" ||
+        arg.scalar_type() == "uchar_pointer") {
+      if (arg.scalar_type() == "char_pointer") {
+        out << "    char ";
+      } else {
+        out << "    unsigned char ";
+      }
+      out << "arg" << arg_index
+             << "[func_msg->arg(" << arg_index
+             << ").string_value().length() + 1];" << "\n";
+      out << "    if (func_msg->arg(" << arg_index
+             << ").type() == TYPE_SCALAR && "
+             << "func_msg->arg(" << arg_index
+             << ").string_value().has_message()) {" << "\n";
+      out << "      strcpy(arg" << arg_index << ", "
+             << "func_msg->arg(" << arg_index << ").string_value()"
+             << ".message().c_str());" << "\n";
+      out << "    } else {" << "\n";
+      out << "   strcpy(arg" << arg_index << ", "
+             << GetCppInstanceType(arg) << ");" << "\n";
+      out << "    }" << "\n";
+    } else {
+      out << "    " << GetCppVariableType(arg) << " "
+             << "arg" << arg_index << " = ";
+      out << "(func_msg->arg(" << arg_index
+             << ").type() == TYPE_SCALAR && "
+             << "func_msg->arg(" << arg_index
+             << ").scalar_value().has_" << arg.scalar_type() << "()) ? ";
+      if (arg.scalar_type() == "void_pointer") {
+        out << "reinterpret_cast<" << GetCppVariableType(arg) << ">(";
+      }
+      out << "func_msg->arg(" << arg_index << ").scalar_value()."
+             << arg.scalar_type() << "()";
+      if (arg.scalar_type() == "void_pointer") {
+        out << ")";
+      }
+      out << " : " << GetCppInstanceType(arg);
+    }
+  } else {
+    out << "    " << GetCppVariableType(arg) << " "
+           << "arg" << arg_index << " = ";
+    out << GetCppInstanceType(arg);
+  }
+  out << ";" << "\n";
 }
 
 void LibSharedCodeGen::GenerateCppBodyGetAttributeFunction(
@@ -162,6 +236,13 @@ void LibSharedCodeGen::GenerateCppBodyGetAttributeFunction(
   out << "}" << "\n";
 }
 
+void LibSharedCodeGen::GenerateAdditionalFuctionDeclarations(Formatter& out,
+    const ComponentSpecificationMessage& /*message*/,
+    const string& /*fuzzer_extended_class_name*/) {
+  out << "int FuzzRepeated(FunctionSpecificationMessage* func_msg, int count, "
+      << "const string& callback_socket_name, vector<void*>* results);\n";
+}
+
 void LibSharedCodeGen::GenerateClassConstructionFunction(Formatter& out,
     const ComponentSpecificationMessage& /*message*/,
     const string& fuzzer_extended_class_name) {
@@ -41,10 +41,30 @@ class LibSharedCodeGen : public HalCodeGen {
       const ComponentSpecificationMessage& message,
       const string& fuzzer_extended_class_name) override;
 
+  void GenerateAdditionalFuctionDeclarations(Formatter& out,
+      const ComponentSpecificationMessage& message,
+      const string& fuzzer_extended_class_name) override;
+
   void GenerateClassConstructionFunction(Formatter& out,
       const ComponentSpecificationMessage& message,
       const string& fuzzer_extended_class_name) override;
 
+  // The args of shared library functions are generated by each call.
+  void GeneratePrivateMemberDeclarations(Formatter& /*out*/,
+      const ComponentSpecificationMessage& /*message*/) override {}
+
+  // Generates code for FuzzRepeated(...) function body, which calls an API
+  // count times without going back to the caller in between.
+  void GenerateCppBodyFuzzRepeatedFunction(Formatter& out,
+      const ComponentSpecificationMessage& message,
+      const string& fuzzer_extended_class_name);
+
+  // Generates the definition of the arg_index-th arg of an API, from the
+  // value in func_msg or a random one.
+  void GenerateArgDefinition(Formatter& out,
+      const ComponentSpecificationMessage& message,
+      const VariableSpecificationMessage& arg, int arg_index);
+
   // instance variable name (e.g., submodule_);
   static const char* const kInstanceVariableName;
 };
@@ -46,9 +46,15 @@ void FuzzerCodeGenBase::GenerateSourceFile(Formatter &out) {
   GenerateGlobalVars(out);
   GenerateLLVMFuzzerInitialize(out);
   GenerateLLVMFuzzerTestOneInput(out);
+  GenerateLLVMFuzzerCustomMutator(out);
   GenerateCloseNameSpaces(out);
 }
 
+void FuzzerCodeGenBase::GenerateDictionaryFile(Formatter &out) {
+  out << "# This file was auto-generated by VTS compiler.\n\n";
+  GenerateDictionaryEntries(out);
+}
+
 void FuzzerCodeGenBase::GenerateOpenNameSpaces(Formatter &out) {
   out << "namespace android {\n";
   out << "namespace vts {\n\n";
@@ -43,6 +43,9 @@ class FuzzerCodeGenBase {
   void GenerateHeaderFile(Formatter &out);
   // Generates fuzzer source file.
   void GenerateSourceFile(Formatter &out);
+  // Generates a libFuzzer dictionary of the values known from the spec, to
+  // be given to the fuzzer as -dict=<file>.
+  void GenerateDictionaryFile(Formatter &out);
 
  protected:
   // Generates "#include" declarations.
@@ -55,6 +58,10 @@ class FuzzerCodeGenBase {
   virtual void GenerateLLVMFuzzerInitialize(Formatter &out) = 0;
   // Generates definition of LLVMFuzzerTestOneInput function.
   virtual void GenerateLLVMFuzzerTestOneInput(Formatter &out) = 0;
+  // Generates definition of LLVMFuzzerCustomMutator function.
+  virtual void GenerateLLVMFuzzerCustomMutator(Formatter &out) = 0;
+  // Generates the entries of the dictionary file.
+  virtual void GenerateDictionaryEntries(Formatter &out) = 0;
   virtual void GenerateOpenNameSpaces(Formatter &out);
   virtual void GenerateCloseNameSpaces(Formatter &out);
 
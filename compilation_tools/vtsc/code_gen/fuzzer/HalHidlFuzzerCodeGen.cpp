@@ -15,6 +15,9 @@
  */
 
 #include "HalHidlFuzzerCodeGen.h"
+
+#include <stdio.h>
+
 #include "VtsCompilerUtils.h"
 #include "code_gen/common/HalHidlCodeGenUtils.h"
 #include "utils/InterfaceSpecUtil.h"
@@ -23,6 +26,7 @@
 using std::cerr;
 using std::cout;
 using std::endl;
+using std::set;
 using std::vector;
 
 namespace android {
@@ -31,6 +35,9 @@ namespace vts {
 void HalHidlFuzzerCodeGen::GenerateSourceIncludeFiles(Formatter &out) {
   out << "#include <iostream>\n\n";
   out << "#include \"FuncFuzzerUtils.h\"\n";
+  out << "#include \"utils/FuzzDecodeUtil.h\"\n";
+  out << "#include \"utils/FuzzForkServer.h\"\n";
+  out << "#include \"utils/FuzzRemoteCoverage.h\"\n";
   out << "#include <" << GetPackagePath(comp_spec_) << "/"
       << GetVersion(comp_spec_) << "/" << GetComponentName(comp_spec_)
       << ".h>\n";
@@ -52,16 +59,62 @@ void HalHidlFuzzerCodeGen::GenerateUsingDeclaration(Formatter &out) {
 }
 
 void HalHidlFuzzerCodeGen::GenerateGlobalVars(Formatter &out) {
-  out << "static string target_func;\n\n";
+  for (const auto &attribute : comp_spec_.attribute()) {
+    GenerateFuzzDecoderDeclForAttribute(out, attribute);
+  }
+  for (const auto &attribute : comp_spec_.interface().attribute()) {
+    GenerateFuzzDecoderDeclForAttribute(out, attribute);
+  }
+  for (const auto &attribute : comp_spec_.attribute()) {
+    GenerateFuzzDecoderImplForAttribute(out, attribute);
+  }
+  for (const auto &attribute : comp_spec_.interface().attribute()) {
+    GenerateFuzzDecoderImplForAttribute(out, attribute);
+  }
+  out << "static string target_func;\n";
+  out << "static FuzzForkServer fork_server;\n";
+  out << "static FuzzRemoteCoverage remote_coverage;\n\n";
+  out << "// Fuzzes one function of the HAL with the input at data, and consumes "
+         "it.\n";
+  out << "// Returns false if the input is too short.\n";
+  out << "typedef bool (*FuzzFunc)(" << GetHalPointerType()
+      << " &hal, FuzzDataCursor &cursor);\n\n";
+  for (const auto &func_spec : comp_spec_.interface().api()) {
+    GenerateFuzzFunction(out, func_spec);
+  }
+  // an empty table would be ill-formed, and there is no function to select.
+  if (comp_spec_.interface().api_size() > 0) {
+    GenerateFuzzFuncTable(out);
+    out << "// the function to fuzz, nullptr to fuzz sequences of all the "
+           "functions.\n";
+    out << "static FuzzFunc target_fuzz_func = nullptr;\n\n";
+  }
+  GenerateFuzzInputFunction(out);
 }
 
 void HalHidlFuzzerCodeGen::GenerateLLVMFuzzerInitialize(Formatter &out) {
   out << "extern \"C\" int LLVMFuzzerInitialize(int *argc, char ***argv) "
          "{\n";
   out.indent();
+  out << "fork_server.ExtractBatchSize(argc, argv);\n";
+  out << "remote_coverage.ExtractAndMap(argc, argv);\n";
   out << "FuncFuzzerParams params{ExtractFuncFuzzerParams(*argc, *argv)};\n";
   out << "target_func = params.target_func_;\n";
-  out << "return 0;\n";
+  out << "if (target_func.empty()) { return 0; }\n";
+  if (comp_spec_.interface().api_size() > 0) {
+    out << "for (const auto &fuzz_func : kFuzzFuncs) {\n";
+    out.indent();
+    out << "if (target_func == fuzz_func.name) {\n";
+    out.indent();
+    out << "target_fuzz_func = fuzz_func.func;\n";
+    out << "return 0;\n";
+    out.unindent();
+    out << "}\n";
+    out.unindent();
+    out << "}\n";
+  }
+  out << "cerr << \"No such function: \" << target_func << endl;\n";
+  out << "exit(1);\n";
   out.unindent();
   out << "}\n\n";
 }
@@ -70,9 +123,8 @@ void HalHidlFuzzerCodeGen::GenerateLLVMFuzzerTestOneInput(Formatter &out) {
   out << "extern \"C\" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t "
          "size) {\n";
   out.indent();
-  out << "static ::android::sp<" << comp_spec_.component_name() << "> "
-      << GetHalPointerName() << " = " << comp_spec_.component_name()
-      << "::getService(true);\n";
+  out << "static " << GetHalPointerType() << " " << GetHalPointerName()
+      << " = " << comp_spec_.component_name() << "::getService(true);\n";
   out << "if (" << GetHalPointerName() << " == nullptr) {\n";
   out.indent();
   out << "cerr << \"" << comp_spec_.component_name()
@@ -80,20 +132,170 @@ void HalHidlFuzzerCodeGen::GenerateLLVMFuzzerTestOneInput(Formatter &out) {
   out << "exit(1);\n";
   out.unindent();
   out << "}\n\n";
-  for (const auto &func_spec : comp_spec_.interface().api()) {
-    GenerateHalFunctionCall(out, func_spec);
-  }
-  out << "{\n";
-  out.indent();
-  out << "cerr << \"No such function: \" << target_func << endl;\n";
-  out << "exit(1);\n";
+  out << "// forks here, once the service is got.\n";
+  out << "fork_server.BeginInput();\n";
+  out << "remote_coverage.BeginInput();\n";
+  out << "FuzzDataCursor cursor(data, size);\n";
+  out << "FuzzInput(" << GetHalPointerName() << ", cursor);\n";
+  out << "remote_coverage.EndInput();\n";
+  out << "return 0;\n";
+
   out.unindent();
-  out << "}\n";
+  out << "}\n\n";
+}
 
+void HalHidlFuzzerCodeGen::GenerateLLVMFuzzerCustomMutator(Formatter &out) {
+  out << "// Sets the enums and the masks of the input to valid values, or lets "
+         "libFuzzer\n";
+  out << "// mutate the input.\n";
+  out << "extern \"C\" size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t "
+         "size, size_t max_size, unsigned int seed) {\n";
+  out.indent();
+  out << "return MutateFuzzInput(data, size, max_size, seed, [](FuzzDataCursor "
+         "&cursor) {\n";
+  out.indent();
+  out << "static " << GetHalPointerType() << " no_hal;\n";
+  out << "FuzzInput(no_hal, cursor);\n";
+  out.unindent();
+  out << "});\n";
   out.unindent();
   out << "}\n\n";
 }
 
+void HalHidlFuzzerCodeGen::GenerateDictionaryEntries(Formatter &out) {
+  set<string> mask_types;
+  for (const auto &func_spec : comp_spec_.interface().api()) {
+    for (const auto &arg : func_spec.arg()) {
+      AddMaskTypes(arg, &mask_types);
+    }
+    for (const auto &return_val : func_spec.return_type_hidl()) {
+      AddMaskTypes(return_val, &mask_types);
+    }
+  }
+  for (const auto &attribute : comp_spec_.attribute()) {
+    AddMaskTypes(attribute, &mask_types);
+  }
+  for (const auto &attribute : comp_spec_.interface().attribute()) {
+    AddMaskTypes(attribute, &mask_types);
+  }
+  for (const auto &attribute : comp_spec_.attribute()) {
+    GenerateDictionaryEntriesForAttribute(out, attribute, mask_types);
+  }
+  for (const auto &attribute : comp_spec_.interface().attribute()) {
+    GenerateDictionaryEntriesForAttribute(out, attribute, mask_types);
+  }
+}
+
+void HalHidlFuzzerCodeGen::AddMaskTypes(const VariableSpecificationMessage &var,
+                                        set<string> *mask_types) {
+  if (var.type() == TYPE_MASK && var.has_predefined_type()) {
+    mask_types->insert(var.predefined_type());
+  }
+  for (const auto *fields :
+       {&var.vector_value(), &var.struct_value(), &var.sub_struct(),
+        &var.union_value(), &var.sub_union(), &var.safe_union_value(),
+        &var.sub_safe_union()}) {
+    for (const auto &field : *fields) {
+      AddMaskTypes(field, mask_types);
+    }
+  }
+}
+
+// Gets the value of the enumerator at index of enum_value, converted to
+// uint64_t as the fuzzer does, and the size of the enum in bytes.
+// Returns false if the scalar type of the enum is not supported.
+static bool GetEnumeratorValue(const EnumDataValueMessage &enum_value,
+                               int index, uint64_t *value, size_t *size) {
+  const string &scalar_type = enum_value.scalar_type();
+  const ScalarDataValueMessage &scalar = enum_value.scalar_value(index);
+  if (scalar_type == "int8_t") {
+    *value = static_cast<uint64_t>(static_cast<int64_t>(scalar.int8_t()));
+    *size = 1;
+  } else if (scalar_type == "uint8_t") {
+    *value = scalar.uint8_t();
+    *size = 1;
+  } else if (scalar_type == "int16_t") {
+    *value = static_cast<uint64_t>(static_cast<int64_t>(scalar.int16_t()));
+    *size = 2;
+  } else if (scalar_type == "uint16_t") {
+    *value = scalar.uint16_t();
+    *size = 2;
+  } else if (scalar_type == "int32_t") {
+    *value = static_cast<uint64_t>(static_cast<int64_t>(scalar.int32_t()));
+    *size = 4;
+  } else if (scalar_type == "uint32_t") {
+    *value = scalar.uint32_t();
+    *size = 4;
+  } else if (scalar_type == "int64_t") {
+    *value = static_cast<uint64_t>(scalar.int64_t());
+    *size = 8;
+  } else if (scalar_type == "uint64_t") {
+    *value = scalar.uint64_t();
+    *size = 8;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Returns a dictionary entry of the size low bytes of value, little-endian.
+static string GetDictionaryEntry(const string &name, uint64_t value,
+                                 size_t size) {
+  string entry = name + "=\"";
+  for (size_t i = 0; i < size; i++) {
+    char byte[5];
+    snprintf(byte, sizeof(byte), "\\x%02x",
+             static_cast<unsigned>((value >> (8 * i)) & 0xff));
+    entry += byte;
+  }
+  return entry + "\"";
+}
+
+void HalHidlFuzzerCodeGen::GenerateDictionaryEntriesForAttribute(
+    Formatter &out, const VariableSpecificationMessage &attribute,
+    const set<string> &mask_types) {
+  for (const auto *sub_types :
+       {&attribute.sub_struct(), &attribute.sub_union(),
+        &attribute.sub_safe_union()}) {
+    for (const auto &sub_type : *sub_types) {
+      GenerateDictionaryEntriesForAttribute(out, sub_type, mask_types);
+    }
+  }
+  if (attribute.type() != TYPE_ENUM ||
+      attribute.enum_value().enumerator_size() == 0) {
+    return;
+  }
+  const EnumDataValueMessage &enum_value = attribute.enum_value();
+  string name = attribute.name();
+  if (name.compare(0, 2, "::") == 0) {
+    name = name.substr(2);
+  }
+  name = ClearStringWithNameSpaceAccess(name);
+  out << "# " << attribute.name() << "\n";
+  set<uint64_t> values;
+  uint64_t all_bits = 0;
+  size_t size = 0;
+  for (int i = 0; i < enum_value.enumerator_size(); i++) {
+    uint64_t value;
+    if (!GetEnumeratorValue(enum_value, i, &value, &size)) {
+      cerr << __func__ << ":" << __LINE__ << " ERROR unsupported enum type "
+           << enum_value.scalar_type() << endl;
+      exit(-1);
+    }
+    all_bits |= value;
+    // aliases of a value would only be duplicate entries.
+    if (values.insert(value).second) {
+      out << GetDictionaryEntry(name + "__" + enum_value.enumerator(i), value,
+                                size)
+          << "\n";
+    }
+  }
+  if (mask_types.count(attribute.name()) > 0 && values.count(all_bits) == 0) {
+    out << GetDictionaryEntry(name + "__all_bits", all_bits, size) << "\n";
+  }
+  out << "\n";
+}
+
 string HalHidlFuzzerCodeGen::GetHalPointerName() {
   string prefix = "android.hardware.";
   string hal_pointer_name = comp_spec_.package().substr(prefix.size());
@@ -101,6 +303,10 @@ string HalHidlFuzzerCodeGen::GetHalPointerName() {
   return hal_pointer_name;
 }
 
+string HalHidlFuzzerCodeGen::GetHalPointerType() {
+  return "::android::sp<" + comp_spec_.component_name() + ">";
+}
+
 void HalHidlFuzzerCodeGen::GenerateReturnCallback(
     Formatter &out, const FunctionSpecificationMessage &func_spec) {
   if (CanElideCallback(func_spec)) {
@@ -117,22 +323,24 @@ void HalHidlFuzzerCodeGen::GenerateReturnCallback(
   out << "){};\n\n";
 }
 
-void HalHidlFuzzerCodeGen::GenerateHalFunctionCall(
+void HalHidlFuzzerCodeGen::GenerateFuzzFunction(
     Formatter &out, const FunctionSpecificationMessage &func_spec) {
-  string func_name = func_spec.name();
-  out << "if (target_func == \"" << func_name << "\") {\n";
+  vector<string> types{GetFuncArgTypes(func_spec)};
+  out << "static bool " << GetFuzzFunctionName(func_spec) << "("
+      << GetHalPointerType() << " &" << GetHalPointerName()
+      << ", FuzzDataCursor &cursor"
+      << (types.empty() ? " __attribute__((__unused__))" : "") << ") {\n";
   out.indent();
 
   GenerateReturnCallback(out, func_spec);
-  vector<string> types{GetFuncArgTypes(func_spec)};
+  // static, so that the arguments are reused between inputs.
   for (size_t i = 0; i < types.size(); ++i) {
-    out << "size_t type_size" << i << " = sizeof(" << types[i] << ");\n";
-    out << "if (size < type_size" << i << ") { return 0; }\n";
-    out << "size -= type_size" << i << ";\n";
-    out << types[i] << " arg" << i << ";\n";
-    out << "memcpy(&arg" << i << ", data, type_size" << i << ");\n";
-    out << "data += type_size" << i << ";\n\n";
+    out << "static " << types[i] << " arg" << i << ";\n";
+    GenerateDecodeStatement(out, func_spec.arg(i), "arg" + std::to_string(i));
   }
+  out << "// only decodes the input for the custom mutator.\n";
+  out << "if (" << GetHalPointerName() << " == nullptr) { return true; }\n";
+  out << "\n";
 
   out << GetHalPointerName() << "->" << func_spec.name() << "(";
   for (size_t i = 0; i < types.size(); ++i) {
@@ -145,10 +353,122 @@ void HalHidlFuzzerCodeGen::GenerateHalFunctionCall(
     out << return_cb_name;
   }
   out << ");\n";
-  out << "return 0;\n";
+  out << "return true;\n";
+
+  out.unindent();
+  out << "}\n\n";
+}
+
+void HalHidlFuzzerCodeGen::GenerateDecodeStatement(
+    Formatter &out, const VariableSpecificationMessage &var,
+    const string &target) {
+  // a mask is its scalar type in C++, so the enum of its bits is only known
+  // from the spec.
+  if (var.type() == TYPE_MASK && var.has_predefined_type()) {
+    out << "if (!DecodeFuzzMask<" << var.predefined_type() << ">(cursor, &"
+        << target << ")) { return false; }\n";
+  } else {
+    out << "if (!DecodeFuzzValue(cursor, &" << target
+        << ")) { return false; }\n";
+  }
+}
 
+void HalHidlFuzzerCodeGen::GenerateFuzzInputFunction(Formatter &out) {
+  out << "// Fuzzes the HAL with the whole input. Only decodes the input if hal "
+         "is null.\n";
+  if (comp_spec_.interface().api_size() == 0) {
+    out << "static void FuzzInput(" << GetHalPointerType()
+        << " &hal __attribute__((__unused__)), FuzzDataCursor &cursor "
+           "__attribute__((__unused__))) {\n";
+    out.indent();
+    out << "// the interface has no function to call.\n";
+    out.unindent();
+    out << "}\n\n";
+    return;
+  }
+  out << "static void FuzzInput(" << GetHalPointerType()
+      << " &hal, FuzzDataCursor &cursor) {\n";
+  out.indent();
+  out << "if (target_fuzz_func != nullptr) {\n";
+  out.indent();
+  out << "target_fuzz_func(hal, cursor);\n";
+  out << "return;\n";
+  out.unindent();
+  out << "}\n";
+  out << "// Each call is a byte selecting the function, followed by its "
+         "arguments.\n";
+  out << "uint8_t index;\n";
+  out << "while (cursor.ConsumeBytes(&index, sizeof(index))) {\n";
+  out.indent();
+  out << "FuzzFunc fuzz_func = kFuzzFuncs[index % kNumFuzzFuncs].func;\n";
+  out << "if (!fuzz_func(hal, cursor)) { break; }\n";
   out.unindent();
-  out << "} else ";
+  out << "}\n";
+  out.unindent();
+  out << "}\n\n";
+}
+
+void HalHidlFuzzerCodeGen::GenerateFuzzFuncTable(Formatter &out) {
+  out << "// the functions to fuzz, indexed by the first byte of each call in "
+         "the input\n";
+  out << "// when fuzzing sequences of all the functions.\n";
+  out << "static const struct {\n";
+  out.indent();
+  out << "const char *name;\n";
+  out << "FuzzFunc func;\n";
+  out.unindent();
+  out << "} kFuzzFuncs[] = {\n";
+  out.indent();
+  for (const auto &func_spec : comp_spec_.interface().api()) {
+    out << "{\"" << func_spec.name() << "\", "
+        << GetFuzzFunctionName(func_spec) << "},\n";
+  }
+  out.unindent();
+  out << "};\n";
+  out << "static const size_t kNumFuzzFuncs = "
+         "sizeof(kFuzzFuncs) / sizeof(kFuzzFuncs[0]);\n\n";
+}
+
+void HalHidlFuzzerCodeGen::GenerateFuzzDecoderDeclForAttribute(
+    Formatter &out, const VariableSpecificationMessage &attribute) {
+  for (const auto &sub_struct : attribute.sub_struct()) {
+    GenerateFuzzDecoderDeclForAttribute(out, sub_struct);
+  }
+  if (attribute.type() != TYPE_STRUCT) {
+    return;
+  }
+  out << "template <>\n";
+  out << "struct VtsFuzzDecoder<" << attribute.name() << "> {\n";
+  out.indent();
+  out << "static bool Decode(FuzzDataCursor &cursor, " << attribute.name()
+      << " *value);\n";
+  out.unindent();
+  out << "};\n\n";
+}
+
+void HalHidlFuzzerCodeGen::GenerateFuzzDecoderImplForAttribute(
+    Formatter &out, const VariableSpecificationMessage &attribute) {
+  for (const auto &sub_struct : attribute.sub_struct()) {
+    GenerateFuzzDecoderImplForAttribute(out, sub_struct);
+  }
+  if (attribute.type() != TYPE_STRUCT) {
+    return;
+  }
+  out << "bool VtsFuzzDecoder<" << attribute.name()
+      << ">::Decode(FuzzDataCursor &cursor __attribute__((__unused__)), "
+      << attribute.name() << " *value __attribute__((__unused__))) {\n";
+  out.indent();
+  for (const auto &field : attribute.struct_value()) {
+    GenerateDecodeStatement(out, field, "value->" + field.name());
+  }
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+}
+
+string HalHidlFuzzerCodeGen::GetFuzzFunctionName(
+    const FunctionSpecificationMessage &func_spec) {
+  return "Fuzz_" + func_spec.name();
 }
 
 bool HalHidlFuzzerCodeGen::CanElideCallback(
@@ -17,6 +17,8 @@
 #ifndef VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_FUZZER_HALHIDLFUZZERCODEGEN_H_
 #define VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_FUZZER_HALHIDLFUZZERCODEGEN_H_
 
+#include <set>
+
 #include "code_gen/fuzzer/FuzzerCodeGenBase.h"
 
 namespace android {
@@ -33,24 +35,54 @@ class HalHidlFuzzerCodeGen : public FuzzerCodeGenBase {
   void GenerateGlobalVars(Formatter &out) override;
   void GenerateLLVMFuzzerInitialize(Formatter &out) override;
   void GenerateLLVMFuzzerTestOneInput(Formatter &out) override;
+  void GenerateLLVMFuzzerCustomMutator(Formatter &out) override;
+  void GenerateDictionaryEntries(Formatter &out) override;
 
  private:
   // Generates return callback function for HAL function being fuzzed.
   void GenerateReturnCallback(Formatter &out,
                               const FunctionSpecificationMessage &func_spec);
-  // Generates function call.
-  void GenerateHalFunctionCall(Formatter &out,
-                               const FunctionSpecificationMessage &func_spec);
+  // Generates the function that fuzzes a HAL function with the input.
+  void GenerateFuzzFunction(Formatter &out,
+                            const FunctionSpecificationMessage &func_spec);
+  // Generates the VtsFuzzDecoder specializations of a struct and the structs
+  // nested in it.
+  void GenerateFuzzDecoderDeclForAttribute(
+      Formatter &out, const VariableSpecificationMessage &attribute);
+  void GenerateFuzzDecoderImplForAttribute(
+      Formatter &out, const VariableSpecificationMessage &attribute);
+  // Generates the table of the fuzz functions, by HAL function name.
+  void GenerateFuzzFuncTable(Formatter &out);
+  // Generates the function that fuzzes the HAL with a whole input.
+  void GenerateFuzzInputFunction(Formatter &out);
+  // Generates the statement decoding var from the input into target.
+  void GenerateDecodeStatement(Formatter &out,
+                               const VariableSpecificationMessage &var,
+                               const std::string &target);
+  // Generates the dictionary entries of the values of an enum, and of the
+  // enums nested in attribute. mask_types are the enums used as masks.
+  void GenerateDictionaryEntriesForAttribute(
+      Formatter &out, const VariableSpecificationMessage &attribute,
+      const std::set<std::string> &mask_types);
+  // Adds the enums that var and the variables in it use as masks to
+  // mask_types.
+  void AddMaskTypes(const VariableSpecificationMessage &var,
+                    std::set<std::string> *mask_types);
+  // Returns name of the fuzz function of a HAL function.
+  std::string GetFuzzFunctionName(
+      const FunctionSpecificationMessage &func_spec);
   // Returns name of pointer to hal instance.
   std::string GetHalPointerName();
+  // Returns type of pointer to hal instance.
+  std::string GetHalPointerType();
   // Returns true if we could omit the callback function and return result
   // directly.
   bool CanElideCallback(const FunctionSpecificationMessage &func_spec);
   // Returns a vector of strings containing type names of function arguments.
   std::vector<std::string> GetFuncArgTypes(
       const FunctionSpecificationMessage &func_spec);
-  // Name of return callback. Since we only fuzz one function, we'll need at
-  // most one return callback.
+  // Name of return callback. Each fuzz function needs at most one return
+  // callback.
   const std::string return_cb_name = "hidl_cb";
 };
 
@@ -15,7 +15,9 @@
  */
 
 #include "HalHidlProfilerCodeGen.h"
+
 #include "VtsCompilerUtils.h"
+#include "code_gen/common/HalHidlCodeGenUtils.h"
 #include "utils/InterfaceSpecUtil.h"
 #include "utils/StringUtil.h"
 
@@ -64,6 +66,15 @@ void HalHidlProfilerCodeGen::GenerateProfilerForVectorVariable(
     const std::string& arg_name, const std::string& arg_value) {
   out << arg_name << "->set_type(TYPE_VECTOR);\n";
   out << arg_name << "->set_vector_size(" << arg_value << ".size());\n";
+  if (IsRawScalarElement(val.vector_value(0))) {
+    // Copy the elements in one go instead of adding a message per element.
+    out << arg_name << "->set_scalar_type(\""
+        << val.vector_value(0).scalar_type() << "\");\n";
+    out << arg_name << "->set_vector_raw_value(" << arg_value << ".data(), "
+        << GetRawValueSizeExpression(arg_value, arg_value + ".size()")
+        << ");\n";
+    return;
+  }
   std::string index_name = GetVarString(arg_name) + "_index";
   out << "for (int " << index_name << " = 0; " << index_name << " < (int)"
       << arg_value << ".size(); " << index_name << "++) {\n";
@@ -85,6 +96,16 @@ void HalHidlProfilerCodeGen::GenerateProfilerForArrayVariable(
     const std::string& arg_name, const std::string& arg_value) {
   out << arg_name << "->set_type(TYPE_ARRAY);\n";
   out << arg_name << "->set_vector_size(" << val.vector_size() << ");\n";
+  if (IsRawScalarElement(val.vector_value(0))) {
+    // Copy the elements in one go instead of adding a message per element.
+    out << arg_name << "->set_scalar_type(\""
+        << val.vector_value(0).scalar_type() << "\");\n";
+    out << arg_name << "->set_vector_raw_value(&" << arg_value << "[0], "
+        << GetRawValueSizeExpression(arg_value,
+                                     std::to_string(val.vector_size()))
+        << ");\n";
+    return;
+  }
   std::string index_name = GetVarString(arg_name) + "_index";
   out << "for (int " << index_name << " = 0; " << index_name << " < "
       << val.vector_size() << "; " << index_name << "++) {\n";
@@ -190,55 +211,13 @@ void HalHidlProfilerCodeGen::GenerateProfilerForHandleVariable(
   out.indent();
   out << "auto* fd_val_i = " << arg_name
       << "->mutable_handle_value()->add_fd_val();\n";
-  out << "char filePath[PATH_MAX];\n";
-  out << "string procPath = \"/proc/self/fd/\" + to_string(" << handle_name
-      << "->data[i]);\n";
-  out << "ssize_t r = readlink(procPath.c_str(), filePath, "
-         "sizeof(filePath));\n";
-  out << "if (r == -1) {\n";
+  out << "if (!VtsProfilingInterface::ProfileFileDescriptor(" << handle_name
+      << "->data[i], fd_val_i)) {\n";
   out.indent();
   out << "LOG(ERROR) << \"Unable to get file path\";\n";
   out << "continue;\n";
   out.unindent();
   out << "}\n";
-  out << "filePath[r] = '\\0';\n";
-  out << "fd_val_i->set_file_name(filePath);\n";
-  out << "struct stat statbuf;\n";
-  out << "fstat(" << handle_name << "->data[i], &statbuf);\n";
-  out << "fd_val_i->set_mode(statbuf.st_mode);\n";
-  out << "if (S_ISREG(statbuf.st_mode) || S_ISDIR(statbuf.st_mode)) {\n";
-  out.indent();
-  out << "fd_val_i->set_type(S_ISREG(statbuf.st_mode)? FILE_TYPE: DIR_TYPE);\n";
-  out << "int flags = fcntl(" << handle_name << "->data[i], F_GETFL);\n";
-  out << "fd_val_i->set_flags(flags);\n";
-  out.unindent();
-  out << "}\n";
-  out << "else if (S_ISCHR(statbuf.st_mode) || S_ISBLK(statbuf.st_mode)) {\n";
-  out.indent();
-  out << "fd_val_i->set_type(DEV_TYPE);\n";
-  out << "if (strcmp(filePath, \"/dev/ashmem\") == 0) {\n";
-  out.indent();
-  out << "int size = ashmem_get_size_region(" << handle_name << "->data[i]);\n";
-  out << "fd_val_i->mutable_memory()->set_size(size);\n";
-  out.unindent();
-  out << "}\n";
-  out.unindent();
-  out << "}\n";
-  out << "else if (S_ISFIFO(statbuf.st_mode)){\n";
-  out.indent();
-  out << "fd_val_i->set_type(PIPE_TYPE);\n";
-  out.unindent();
-  out << "}\n";
-  out << "else if (S_ISSOCK(statbuf.st_mode)) {\n";
-  out.indent();
-  out << "fd_val_i->set_type(SOCKET_TYPE);\n";
-  out.unindent();
-  out << "}\n";
-  out << "else {\n";
-  out.indent();
-  out << "fd_val_i->set_type(LINK_TYPE);\n";
-  out.unindent();
-  out << "}\n";
   out.unindent();
   out << "} else {\n";
   out.indent();
@@ -304,25 +283,37 @@ void HalHidlProfilerCodeGen::GenerateProfilerForFMQSyncVariable(
   string element_type = GetCppVariableType(val.fmq_value(0));
   std::string queue_name = arg_name + "_q";
   std::string temp_result_name = arg_name + "_result";
-  out << "MessageQueue<" << element_type << ", kSynchronizedReadWrite> "
-      << queue_name << "(" << arg_value << ", false);\n";
+  std::string queue_type =
+      "MessageQueue<" + element_type + ", kSynchronizedReadWrite>";
+  std::string count_name = arg_name + "_count";
+  std::string transaction_name = arg_name + "_tx";
+  out << queue_type << " " << queue_name << "(" << arg_value
+      << ", false);\n";
   out << "if (" << queue_name << ".isValid()) {\n";
   out.indent();
-  out << "for (int i = 0; i < (int)" << queue_name
-      << ".availableToRead(); i++) {\n";
+  // Profile the items in place. The read is never committed, so the queue is
+  // left untouched for the HAL and its clients.
+  out << "size_t " << count_name << " = " << queue_name
+      << ".availableToRead();\n";
+  out << queue_type << "::MemTransaction " << transaction_name << ";\n";
+  out << "if (" << count_name << " > 0 && " << queue_name << ".beginRead("
+      << count_name << ", &" << transaction_name << ")) {\n";
+  out.indent();
+  out << "for (size_t i = 0; i < " << count_name << "; i++) {\n";
   out.indent();
   std::string fmq_item_name = arg_name + "_item_i";
   out << "auto *" << fmq_item_name << " = " << arg_name
       << "->add_fmq_value();\n";
-  out << element_type << " " << temp_result_name << ";\n";
-  out << queue_name << ".read(&" << temp_result_name << ");\n";
-  out << queue_name << ".write(&" << temp_result_name << ");\n";
+  out << "const " << element_type << "& " << temp_result_name << " = *"
+      << transaction_name << ".getSlot(i);\n";
   GenerateProfilerForTypedVariable(out, val.fmq_value(0), fmq_item_name,
                                    temp_result_name);
   out.unindent();
   out << "}\n";
   out.unindent();
   out << "}\n";
+  out.unindent();
+  out << "}\n";
 }
 
 void HalHidlProfilerCodeGen::GenerateProfilerForFMQUnsyncVariable(
@@ -359,12 +350,76 @@ void HalHidlProfilerCodeGen::GenerateProfilerForSafeUnionVariable(
   out << "LOG(ERROR) << \"TYPE_SAFE_UNION is not supported yet. \";\n";
 }
 
+std::string HalHidlProfilerCodeGen::GetRawValueSizeExpression(
+    const std::string& arg_value, const std::string& count) {
+  std::string element_size = "sizeof(" + arg_value + "[0])";
+  std::string raw_size = "VtsProfilingInterface::GetRawValueSize(" + count +
+                         ", " + element_size + ")";
+  if (!in_method_) {
+    return raw_size;
+  }
+  return "GetProfilingRawValueSize<args_policy>(" + raw_size + ", " +
+         element_size + ")";
+}
+
+void HalHidlProfilerCodeGen::GenerateProfilerForMethodVariable(
+    Formatter& out, const VariableSpecificationMessage& val,
+    const std::string& arg_name, const std::string& arg_value) {
+  std::string type_name;
+  switch (val.type()) {
+    case TYPE_VECTOR:
+      type_name = "TYPE_VECTOR";
+      break;
+    case TYPE_ARRAY:
+      type_name = "TYPE_ARRAY";
+      break;
+    case TYPE_STRUCT:
+      type_name = "TYPE_STRUCT";
+      break;
+    case TYPE_UNION:
+      type_name = "TYPE_UNION";
+      break;
+    case TYPE_SAFE_UNION:
+      type_name = "TYPE_SAFE_UNION";
+      break;
+    default:
+      // Captured the same way by all the policies.
+      GenerateProfilerForTypedVariable(out, val, arg_name, arg_value);
+      return;
+  }
+  out << "if (args_policy == kProfileShallowArgs) {\n";
+  out.indent();
+  out << arg_name << "->set_type(" << type_name << ");\n";
+  if (val.type() == TYPE_VECTOR) {
+    out << arg_name << "->set_vector_size(" << arg_value << ".size());\n";
+  } else if (val.type() == TYPE_ARRAY) {
+    out << arg_name << "->set_vector_size(" << val.vector_size() << ");\n";
+  } else if (val.has_predefined_type()) {
+    out << arg_name << "->set_predefined_type(\"" << val.predefined_type()
+        << "\");\n";
+  }
+  out.unindent();
+  out << "} else {\n";
+  out.indent();
+  GenerateProfilerForTypedVariable(out, val, arg_name, arg_value);
+  out.unindent();
+  out << "}\n";
+}
+
 void HalHidlProfilerCodeGen::GenerateProfilerForMethod(
-    Formatter& out, const FunctionSpecificationMessage& method) {
-  out << "FunctionSpecificationMessage msg;\n";
+    Formatter& out, const ComponentSpecificationMessage& message,
+    const FunctionSpecificationMessage& method) {
+  out << "FunctionSpecificationMessage& msg = "
+         "VtsProfilingInterface::NewTraceMessage();\n";
   out << "msg.set_name(\"" << method.name() << "\");\n";
-  out << "if (profiling_for_args) {\n";
-  out.indent();
+  // The policy is a constant, so that the compiler drops the capture code
+  // the policy excludes, e.g. all of it under kProfileTimingOnly.
+  out << "constexpr VtsProfilingArgsPolicy args_policy = "
+         "GetProfilingArgsPolicy(\""
+      << GetComponentName(message) << "\", \"" << method.name() << "\");\n";
+  out << "if (args_policy != kProfileTimingOnly && profiling_for_args) {\n";
+  out.indent();
+  in_method_ = true;
   out << "if (!args) {\n";
   out.indent();
   out << "LOG(WARNING) << \"no argument passed\";\n";
@@ -378,7 +433,6 @@ void HalHidlProfilerCodeGen::GenerateProfilerForMethod(
   out << "case details::HidlInstrumentor::PASSTHROUGH_ENTRY:\n";
   out << "{\n";
   out.indent();
-  ComponentSpecificationMessage message;
   out << "if ((*args).size() != " << method.arg().size() << ") {\n";
   out.indent();
   out << "LOG(ERROR) << \"Number of arguments does not match. expect: "
@@ -399,8 +453,8 @@ void HalHidlProfilerCodeGen::GenerateProfilerForMethod(
         << GetCppVariableType(arg) << "*> ((*args)[" << i << "]);\n";
     out << "if (" << arg_value << " != nullptr) {\n";
     out.indent();
-    GenerateProfilerForTypedVariable(out, arg, arg_name,
-                                     "(*" + arg_value + ")");
+    GenerateProfilerForMethodVariable(out, arg, arg_name,
+                                      "(*" + arg_value + ")");
     out.unindent();
     out << "} else {\n";
     out.indent();
@@ -438,8 +492,8 @@ void HalHidlProfilerCodeGen::GenerateProfilerForMethod(
         << GetCppVariableType(arg) << "*> ((*args)[" << i << "]);\n";
     out << "if (" << result_value << " != nullptr) {\n";
     out.indent();
-    GenerateProfilerForTypedVariable(out, arg, result_name,
-                                     "(*" + result_value + ")");
+    GenerateProfilerForMethodVariable(out, arg, result_name,
+                                      "(*" + result_value + ")");
     out.unindent();
     out << "} else {\n";
     out.indent();
@@ -463,7 +517,8 @@ void HalHidlProfilerCodeGen::GenerateProfilerForMethod(
   out << "}\n";
   out.unindent();
   out << "}\n";
-  out << "profiler.AddTraceEvent(event, package, version, interface, msg);\n";
+  in_method_ = false;
+  out << "profiler.AddTraceEvent(event, hal, msg);\n";
 }
 
 void HalHidlProfilerCodeGen::GenerateHeaderIncludeFiles(
@@ -521,11 +576,6 @@ void HalHidlProfilerCodeGen::GenerateSourceIncludeFiles(
   out << "#include \"" << GetPackagePath(message) << "/" << GetVersion(message)
       << "/" << GetComponentBaseName(message) << ".vts.h\"\n";
   out << "#include <cutils/properties.h>\n";
-  if (IncludeHidlNativeType(message, TYPE_HANDLE)) {
-    out << "#include <cutils/ashmem.h>\n";
-    out << "#include <fcntl.h>\n";
-    out << "#include <sys/stat.h>\n";
-  }
   if (IncludeHidlNativeType(message, TYPE_FMQ_SYNC) ||
       IncludeHidlNativeType(message, TYPE_FMQ_UNSYNC)) {
     out << "#include <fmq/MessageQueue.h>\n";
@@ -561,13 +611,21 @@ void HalHidlProfilerCodeGen::GenerateProfilerCheck(
       << GetPackageName(message) << " actual: \" << package;\n";
   out.unindent();
   out << "}\n";
-  out << "std::string version_str = std::string(version);\n";
-  out << "int major_version = stoi(version_str.substr(0, "
-         "version_str.find('.')));\n";
-  out << "int minor_version = stoi(version_str.substr(version_str.find('.') + "
-         "1));\n";
-  out << "if (major_version != " << GetMajorVersion(message)
-      << " || minor_version > " << GetMinorVersion(message) << ") {\n";
+  // create and initialize the VTS profiler interface, and get the descriptor
+  // of the HAL so that the version is only parsed once.
+  out << "VtsProfilingInterface& profiler = "
+      << "VtsProfilingInterface::getInstance(TRACEFILEPREFIX);\n";
+  out << "const VtsProfilingInterface::HalDescriptor* hal = "
+         "profiler.GetHalDescriptor(package, version, interface);\n";
+  out << "if (hal == nullptr) {\n";
+  out.indent();
+  out << "LOG(ERROR) << \"failed to register HAL: \" << package << \"@\" << "
+         "version << \"::\" << interface;\n";
+  out << "return;\n";
+  out.unindent();
+  out << "}\n";
+  out << "if (hal->version_major != " << GetMajorVersion(message)
+      << " || hal->version_minor > " << GetMinorVersion(message) << ") {\n";
   out.indent();
   out << "LOG(WARNING) << \"incorrect version. Expect: " << GetVersion(message)
       << " or lower (if version != x.0), actual: \" << version;\n";
@@ -581,16 +639,20 @@ void HalHidlProfilerCodeGen::GenerateProfilerCheck(
       << GetComponentName(message) << " actual: \" << interface;\n";
   out.unindent();
   out << "}\n";
+  // decide whether to trace the event before building the message, so that
+  // the events dropped by sampling or rate-limiting cost almost nothing.
+  out << "if (!profiler.ShouldTraceEvent(event, hal, method)) {\n";
+  out.indent();
+  out << "return;\n";
+  out.unindent();
+  out << "}\n";
   out << "\n";
 }
 
 void HalHidlProfilerCodeGen::GenerateLocalVariableDefinition(
     Formatter& out, const ComponentSpecificationMessage&) {
-  // create and initialize the VTS profiler interface.
-  out << "VtsProfilingInterface& profiler = "
-      << "VtsProfilingInterface::getInstance(TRACEFILEPREFIX);\n\n";
-  out << "bool profiling_for_args = "
-         "property_get_bool(\"hal.instrumentation.profile.args\", true);\n";
+  // The profiler caches the property so that it is not looked up per event.
+  out << "bool profiling_for_args = profiler.IsProfilingArgsEnabled();\n";
 }
 
 }  // namespace vts
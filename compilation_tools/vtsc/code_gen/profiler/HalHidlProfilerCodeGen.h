@@ -93,8 +93,9 @@ class HalHidlProfilerCodeGen : public ProfilerCodeGenBase {
       const VariableSpecificationMessage& val, const std::string& arg_name,
       const std::string& arg_value) override;
 
-  virtual void GenerateProfilerForMethod(Formatter& out,
-    const FunctionSpecificationMessage& method) override;
+  virtual void GenerateProfilerForMethod(
+      Formatter& out, const ComponentSpecificationMessage& message,
+      const FunctionSpecificationMessage& method) override;
 
   virtual void GenerateHeaderIncludeFiles(Formatter& out,
     const ComponentSpecificationMessage& message) override;
@@ -110,6 +111,22 @@ class HalHidlProfilerCodeGen : public ProfilerCodeGenBase {
     const ComponentSpecificationMessage& message) override;
 
  private:
+  // Generates the profiler code for an argument or return value of a method,
+  // which captures less of the value under kProfileShallowArgs, see
+  // VtsProfilingArgsPolicy.h.
+  void GenerateProfilerForMethodVariable(
+      Formatter& out, const VariableSpecificationMessage& val,
+      const std::string& arg_name, const std::string& arg_value);
+
+  // Returns the expression of the number of bytes to record of count
+  // elements of arg_value, a vector or an array of scalars.
+  std::string GetRawValueSizeExpression(const std::string& arg_value,
+                                        const std::string& count);
+
+  // Whether the code of a method is being generated, where the args_policy
+  // constant of the method is defined.
+  bool in_method_ = false;
+
   DISALLOW_COPY_AND_ASSIGN (HalHidlProfilerCodeGen);
 };
 
@@ -117,14 +117,33 @@ void ProfilerCodeGenBase::GenerateSourceFile(
       // Generate code to define local variables.
       GenerateLocalVariableDefinition(out, message);
 
-      // Generate the profiler code for each method.
+      // Generate the profiler code for each method. Dispatch on the hash of
+      // the method name (computed at compile time for the case labels) and
+      // compare the name only once.
+      out << "switch (VtsProfilingInterface::HashMethodName(method)) {\n";
+      out.indent();
       for (const FunctionSpecificationMessage& api : interface.api()) {
+        out << "case VtsProfilingInterface::HashMethodName(\"" << api.name()
+            << "\"):\n";
+        out << "{\n";
+        out.indent();
         out << "if (strcmp(method, \"" << api.name() << "\") == 0) {\n";
         out.indent();
-        GenerateProfilerForMethod(out, api);
+        GenerateProfilerForMethod(out, message, api);
+        out.unindent();
+        out << "}\n";
+        out << "break;\n";
         out.unindent();
         out << "}\n";
       }
+      out << "default:\n";
+      out << "{\n";
+      out.indent();
+      out << "break;\n";
+      out.unindent();
+      out << "}\n";
+      out.unindent();
+      out << "}\n";
     }
 
     out.unindent();
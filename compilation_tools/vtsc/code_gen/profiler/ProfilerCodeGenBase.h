@@ -134,9 +134,10 @@ class ProfilerCodeGenBase {
       const VariableSpecificationMessage& val, const std::string& arg_name,
       const std::string& arg_value) = 0;
 
-  // Generates the profiler code for method.
-  virtual void GenerateProfilerForMethod(Formatter& out,
-    const FunctionSpecificationMessage& method) = 0;
+  // Generates the profiler code for a method of the given component.
+  virtual void GenerateProfilerForMethod(
+      Formatter& out, const ComponentSpecificationMessage& message,
+      const FunctionSpecificationMessage& method) = 0;
 
   // Generates the necessary "#include" code for header file of profiler.
   virtual void GenerateHeaderIncludeFiles(Formatter& out,
@@ -2,10 +2,14 @@
 #include "vts_measurement.h"
 #include <android-base/logging.h>
 #include <android/hidl/allocator/1.0/IAllocator.h>
+#include <driver_base/HidlServiceCache.h>
 #include <fcntl.h>
 #include <fmq/MessageQueue.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <utils/InterfaceSpecUtil.h>
+#include <utils/StringUtil.h>
+#include <utils/TypeConversionUtil.h>
 
 
 using namespace android::hardware::tests::bar::V1_0;
@@ -19,7 +23,7 @@ bool Verify__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(const V
     return true;
 }
 
-extern "C" void SetResult__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(VariableSpecificationMessage* result_msg, ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated result_value __attribute__((__unused__))){
+extern "C" void SetResult__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(VariableSpecificationMessage* result_msg, const ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated& result_value __attribute__((__unused__))){
     result_msg->set_type(TYPE_STRUCT);
     auto *result_msg_myRelated = result_msg->add_struct_value();
     result_msg_myRelated->set_type(TYPE_STRUCT);
@@ -27,21 +31,32 @@ extern "C" void SetResult__android__hardware__tests__bar__V1_0__IBar__SomethingR
     result_msg_myRelated->set_name("myRelated");
 }
 
+bool VtsValueVerifier<::android::hardware::tests::bar::V1_0::IBar::SomethingRelated>::Verify(const VariableSpecificationMessage& expected_result, const ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated& actual_value __attribute__((__unused__))) {
+    if (expected_result.struct_value_size() != 1) { return false; }
+    if (!VerifyValue(expected_result.struct_value(0), actual_value.myRelated)) { return false; }
+    return true;
+}
+
+static const VtsTypeConversionEntry kTypeConversions[] = {
+    MakeTypeConversionEntry<::android::hardware::tests::bar::V1_0::IBar::SomethingRelated>("::android::hardware::tests::bar::V1_0::IBar::SomethingRelated", &MessageTo__android__hardware__tests__bar__V1_0__IBar__SomethingRelated, &SetResult__android__hardware__tests__bar__V1_0__IBar__SomethingRelated, false),
+};
+
+extern "C" const VtsTypeConversionEntry* VtsTypeConversions__android__hardware__tests__bar__V1_0__IBar(size_t* size) {
+    *size = sizeof(kTypeConversions) / sizeof(kTypeConversions[0]);
+    return kTypeConversions;
+}
+
 bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_stub, const char* service_name) {
-    static bool initialized = false;
-    if (!initialized) {
-        LOG(INFO) << "HIDL getService";
-        if (service_name) {
-          LOG(INFO) << "  - service name: " << service_name;
-        }
-        hw_binder_proxy_ = ::android::hardware::tests::bar::V1_0::IBar::getService(service_name, get_stub);
-        if (hw_binder_proxy_ == nullptr) {
-            LOG(ERROR) << "getService() returned a null pointer.";
-            return false;
-        }
-        LOG(DEBUG) << "hw_binder_proxy_ = " << hw_binder_proxy_.get();
-        initialized = true;
+    LOG(INFO) << "HIDL getService";
+    if (service_name) {
+      LOG(INFO) << "  - service name: " << service_name;
     }
+    hw_binder_proxy_ = GetCachedHidlService<::android::hardware::tests::bar::V1_0::IBar>(service_name, get_stub);
+    if (hw_binder_proxy_ == nullptr) {
+        LOG(ERROR) << "getService() returned a null pointer.";
+        return false;
+    }
+    LOG(DEBUG) << "hw_binder_proxy_ = " << hw_binder_proxy_.get();
     return true;
 }
 
@@ -59,6 +74,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg1 = callback_message.add_arg();
     var_msg1->set_type(TYPE_VECTOR);
     var_msg1->set_vector_size(arg1.size());
+    var_msg1->mutable_vector_value()->Reserve(arg1.size());
     for (int i = 0; i < (int)arg1.size(); i++) {
         auto *var_msg1_vector_i = var_msg1->add_vector_value();
         var_msg1_vector_i->set_type(TYPE_UNION);
@@ -76,9 +92,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     callback_message.set_id(GetCallbackID("doThis"));
     callback_message.set_name("Vts_android_hardware_tests_bar_V1_0_IBar::doThis");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("float_t");
-    var_msg0->mutable_scalar_value()->set_float_t(arg0);
+    SetScalarResult<float>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return ::android::hardware::Void();
 }
@@ -90,9 +104,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     callback_message.set_id(GetCallbackID("doThatAndReturnSomething"));
     callback_message.set_name("Vts_android_hardware_tests_bar_V1_0_IBar::doThatAndReturnSomething");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int64_t");
-    var_msg0->mutable_scalar_value()->set_int64_t(arg0);
+    SetScalarResult<int64_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<int32_t>(0);
 }
@@ -107,21 +119,13 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     callback_message.set_id(GetCallbackID("doQuiteABit"));
     callback_message.set_name("Vts_android_hardware_tests_bar_V1_0_IBar::doQuiteABit");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     VariableSpecificationMessage* var_msg1 = callback_message.add_arg();
-    var_msg1->set_type(TYPE_SCALAR);
-    var_msg1->set_scalar_type("int64_t");
-    var_msg1->mutable_scalar_value()->set_int64_t(arg1);
+    SetScalarResult<int64_t>(var_msg1, arg1);
     VariableSpecificationMessage* var_msg2 = callback_message.add_arg();
-    var_msg2->set_type(TYPE_SCALAR);
-    var_msg2->set_scalar_type("float_t");
-    var_msg2->mutable_scalar_value()->set_float_t(arg2);
+    SetScalarResult<float>(var_msg2, arg2);
     VariableSpecificationMessage* var_msg3 = callback_message.add_arg();
-    var_msg3->set_type(TYPE_SCALAR);
-    var_msg3->set_scalar_type("double_t");
-    var_msg3->mutable_scalar_value()->set_double_t(arg3);
+    SetScalarResult<double>(var_msg3, arg3);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<double>(0);
 }
@@ -134,13 +138,9 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     callback_message.set_name("Vts_android_hardware_tests_bar_V1_0_IBar::doSomethingElse");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_ARRAY);
-    var_msg0->set_vector_size(1);
-    for (int i = 0; i < 1; i++) {
-        auto *var_msg0_array_i = var_msg0->add_vector_value();
-        var_msg0_array_i->set_type(TYPE_SCALAR);
-        var_msg0_array_i->set_scalar_type("int32_t");
-        var_msg0_array_i->mutable_scalar_value()->set_int32_t(arg0[i]);
-    }
+    var_msg0->set_vector_size(15);
+    var_msg0->set_scalar_type("int32_t");
+    var_msg0->set_vector_raw_value(&arg0[0], 15 * sizeof(int32_t));
     RpcCallToAgent(callback_message, callback_socket_name_);
     cb(::android::hardware::hidl_array<int32_t, 32>());
     return ::android::hardware::Void();
@@ -166,12 +166,8 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
-    for (int i = 0; i < (int)arg0.size(); i++) {
-        auto *var_msg0_vector_i = var_msg0->add_vector_value();
-        var_msg0_vector_i->set_type(TYPE_SCALAR);
-        var_msg0_vector_i->set_scalar_type("int32_t");
-        var_msg0_vector_i->mutable_scalar_value()->set_int32_t(arg0[i]);
-    }
+    var_msg0->set_scalar_type("int32_t");
+    var_msg0->set_vector_raw_value(arg0.data(), arg0.size() * sizeof(int32_t));
     RpcCallToAgent(callback_message, callback_socket_name_);
     cb(::android::hardware::hidl_vec<int32_t>());
     return ::android::hardware::Void();
@@ -212,6 +208,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
+    var_msg0->mutable_vector_value()->Reserve(arg0.size());
     for (int i = 0; i < (int)arg0.size(); i++) {
         auto *var_msg0_vector_i = var_msg0->add_vector_value();
         var_msg0_vector_i->set_type(TYPE_STRUCT);
@@ -247,29 +244,23 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
         auto *var_msg0_array_i = var_msg0->add_vector_value();
         var_msg0_array_i->set_type(TYPE_STRUCT);
         auto *var_msg0_array_i_q = var_msg0_array_i->add_struct_value();
-        var_msg0_array_i_q->set_type(TYPE_SCALAR);
-        var_msg0_array_i_q->set_scalar_type("int32_t");
-        var_msg0_array_i_q->mutable_scalar_value()->set_int32_t(arg0[i].q);
+        SetScalarResult<int32_t>(var_msg0_array_i_q, arg0[i].q);
         var_msg0_array_i_q->set_name("q");
         auto *var_msg0_array_i_name = var_msg0_array_i->add_struct_value();
         var_msg0_array_i_name->set_type(TYPE_STRING);
-        var_msg0_array_i_name->mutable_string_value()->set_message(arg0[i].name.c_str());
+        var_msg0_array_i_name->mutable_string_value()->set_message(arg0[i].name.c_str(), arg0[i].name.size());
         var_msg0_array_i_name->mutable_string_value()->set_length(arg0[i].name.size());
         var_msg0_array_i_name->set_name("name");
         auto *var_msg0_array_i_address = var_msg0_array_i->add_struct_value();
         var_msg0_array_i_address->set_type(TYPE_STRING);
-        var_msg0_array_i_address->mutable_string_value()->set_message(arg0[i].address.c_str());
+        var_msg0_array_i_address->mutable_string_value()->set_message(arg0[i].address.c_str(), arg0[i].address.size());
         var_msg0_array_i_address->mutable_string_value()->set_length(arg0[i].address.size());
         var_msg0_array_i_address->set_name("address");
         auto *var_msg0_array_i_numbers = var_msg0_array_i->add_struct_value();
         var_msg0_array_i_numbers->set_type(TYPE_ARRAY);
-        var_msg0_array_i_numbers->set_vector_size(1);
-        for (int i = 0; i < 1; i++) {
-            auto *var_msg0_array_i_numbers_array_i = var_msg0_array_i_numbers->add_vector_value();
-            var_msg0_array_i_numbers_array_i->set_type(TYPE_SCALAR);
-            var_msg0_array_i_numbers_array_i->set_scalar_type("double_t");
-            var_msg0_array_i_numbers_array_i->mutable_scalar_value()->set_double_t(arg0[i].numbers[i]);
-        }
+        var_msg0_array_i_numbers->set_vector_size(10);
+        var_msg0_array_i_numbers->set_scalar_type("double_t");
+        var_msg0_array_i_numbers->set_vector_raw_value(&arg0[i].numbers[0], 10 * sizeof(double));
         var_msg0_array_i_numbers->set_name("numbers");
         auto *var_msg0_array_i_fumble = var_msg0_array_i->add_struct_value();
         var_msg0_array_i_fumble->set_type(TYPE_STRUCT);
@@ -309,7 +300,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     for (int i = 0; i < 1; i++) {
         auto *var_msg0_array_i = var_msg0->add_vector_value();
         var_msg0_array_i->set_type(TYPE_STRING);
-        var_msg0_array_i->mutable_string_value()->set_message(arg0[i].c_str());
+        var_msg0_array_i->mutable_string_value()->set_message(arg0[i].c_str(), arg0[i].size());
         var_msg0_array_i->mutable_string_value()->set_length(arg0[i].size());
     }
     RpcCallToAgent(callback_message, callback_socket_name_);
@@ -326,10 +317,11 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
+    var_msg0->mutable_vector_value()->Reserve(arg0.size());
     for (int i = 0; i < (int)arg0.size(); i++) {
         auto *var_msg0_vector_i = var_msg0->add_vector_value();
         var_msg0_vector_i->set_type(TYPE_STRING);
-        var_msg0_vector_i->mutable_string_value()->set_message(arg0[i].c_str());
+        var_msg0_vector_i->mutable_string_value()->set_message(arg0[i].c_str(), arg0[i].size());
         var_msg0_vector_i->mutable_string_value()->set_length(arg0[i].size());
     }
     RpcCallToAgent(callback_message, callback_socket_name_);
@@ -349,13 +341,9 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     for (int i = 0; i < 1; i++) {
         auto *var_msg0_array_i = var_msg0->add_vector_value();
         var_msg0_array_i->set_type(TYPE_ARRAY);
-        var_msg0_array_i->set_vector_size(1);
-        for (int i = 0; i < 1; i++) {
-            auto *var_msg0_array_i_array_i = var_msg0_array_i->add_vector_value();
-            var_msg0_array_i_array_i->set_type(TYPE_SCALAR);
-            var_msg0_array_i_array_i->set_scalar_type("float_t");
-            var_msg0_array_i_array_i->mutable_scalar_value()->set_float_t(arg0[i][i]);
-        }
+        var_msg0_array_i->set_vector_size(5);
+        var_msg0_array_i->set_scalar_type("float_t");
+        var_msg0_array_i->set_vector_raw_value(&arg0[i][0], 5 * sizeof(float));
     }
     RpcCallToAgent(callback_message, callback_socket_name_);
     cb(::android::hardware::hidl_array<float, 5, 3>());
@@ -406,7 +394,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
         for (int i = 0; i < 1; i++) {
             auto *var_msg0_array_i_array_i = var_msg0_array_i->add_vector_value();
             var_msg0_array_i_array_i->set_type(TYPE_STRING);
-            var_msg0_array_i_array_i->mutable_string_value()->set_message(arg0[i][i].c_str());
+            var_msg0_array_i_array_i->mutable_string_value()->set_message(arg0[i][i].c_str(), arg0[i][i].size());
             var_msg0_array_i_array_i->mutable_string_value()->set_length(arg0[i][i].size());
         }
     }
@@ -424,12 +412,8 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
-    for (int i = 0; i < (int)arg0.size(); i++) {
-        auto *var_msg0_vector_i = var_msg0->add_vector_value();
-        var_msg0_vector_i->set_type(TYPE_SCALAR);
-        var_msg0_vector_i->set_scalar_type("uint8_t");
-        var_msg0_vector_i->mutable_scalar_value()->set_uint8_t(arg0[i]);
-    }
+    var_msg0->set_scalar_type("uint8_t");
+    var_msg0->set_vector_raw_value(arg0.data(), arg0.size() * sizeof(uint8_t));
     RpcCallToAgent(callback_message, callback_socket_name_);
     cb(::android::hardware::hidl_vec<uint8_t>());
     return ::android::hardware::Void();
@@ -455,6 +439,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
+    var_msg0->mutable_vector_value()->Reserve(arg0.size());
     for (int i = 0; i < (int)arg0.size(); i++) {
         auto *var_msg0_vector_i = var_msg0->add_vector_value();
         var_msg0_vector_i->set_type(TYPE_HIDL_INTERFACE);
@@ -480,6 +465,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
+    var_msg0->mutable_vector_value()->Reserve(arg0.size());
     for (int i = 0; i < (int)arg0.size(); i++) {
         auto *var_msg0_vector_i = var_msg0->add_vector_value();
         var_msg0_vector_i->set_type(TYPE_HIDL_INTERFACE);
@@ -528,9 +514,7 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetService(bool get_st
     callback_message.set_id(GetCallbackID("createHandles"));
     callback_message.set_name("Vts_android_hardware_tests_bar_V1_0_IBar::createHandles");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("uint32_t");
-    var_msg0->mutable_scalar_value()->set_uint32_t(arg0);
+    SetScalarResult<uint32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     cb(::android::hardware::hidl_vec<::android::hardware::hidl_handle>());
     return ::android::hardware::Void();
@@ -654,893 +638,1277 @@ bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::GetAttribute(
 }
 bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::CallFunction(
     const FunctionSpecificationMessage& func_msg,
-    const string& callback_socket_name __attribute__((__unused__)),
+    const string& callback_socket_name,
     FunctionSpecificationMessage* result_msg) {
+    return CallFunctionInternal(func_msg, callback_socket_name, result_msg, nullptr, nullptr);
+}
+
+bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::CallFunctionAndVerify(
+    const FunctionSpecificationMessage& func_msg,
+    const string& callback_socket_name,
+    const FunctionSpecificationMessage& expected_result,
+    bool* verified) {
+    FunctionSpecificationMessage result_msg;
+    *verified = false;
+    return CallFunctionInternal(func_msg, callback_socket_name, &result_msg, &expected_result, verified);
+}
+
+bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::CallFunctionInternal(
+    const FunctionSpecificationMessage& func_msg,
+    const string& callback_socket_name __attribute__((__unused__)),
+    FunctionSpecificationMessage* result_msg,
+    const FunctionSpecificationMessage* expected_result,
+    bool* verified) {
     const char* func_name = func_msg.name().c_str();
     if (hw_binder_proxy_ == nullptr) {
         LOG(ERROR) << "hw_binder_proxy_ is null. ";
         return false;
     }
-    if (!strcmp(func_name, "convertToBoolIfSmall")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::Discriminator arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__Discriminator(func_msg.arg(0), &(arg0), callback_socket_name);
-        ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Union> arg1;
-        arg1.resize(func_msg.arg(1).vector_value_size());
-        for (int arg1_index = 0; arg1_index < func_msg.arg(1).vector_value_size(); arg1_index++) {
-            MessageTo__android__hardware__tests__foo__V1_0__IFoo__Union(func_msg.arg(1).vector_value(arg1_index), &(arg1[arg1_index]), callback_socket_name);
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->convertToBoolIfSmall(arg0, arg1, [&](const ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::ContainsUnion>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback convertToBoolIfSmall called";
-            result_msg->set_name("convertToBoolIfSmall");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_STRUCT);
-                SetResult__android__hardware__tests__foo__V1_0__IFoo__ContainsUnion(result_val_0_vector_i, arg0[i]);
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "doThis")) {
-        float arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().float_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->doThis(arg0);
-        result_msg->set_name("doThis");
-        return true;
-    }
-    if (!strcmp(func_name, "doThatAndReturnSomething")) {
-        int64_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int64_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        int32_t result0 = hw_binder_proxy_->doThatAndReturnSomething(arg0);
-        result_msg->set_name("doThatAndReturnSomething");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("int32_t");
-        result_val_0->mutable_scalar_value()->set_int32_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "doQuiteABit")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        int64_t arg1 = 0;
-        arg1 = func_msg.arg(1).scalar_value().int64_t();
-        float arg2 = 0;
-        arg2 = func_msg.arg(2).scalar_value().float_t();
-        double arg3 = 0;
-        arg3 = func_msg.arg(3).scalar_value().double_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        double result0 = hw_binder_proxy_->doQuiteABit(arg0, arg1, arg2, arg3);
-        result_msg->set_name("doQuiteABit");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("double_t");
-        result_val_0->mutable_scalar_value()->set_double_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "doSomethingElse")) {
-        ::android::hardware::hidl_array<int32_t, 15> arg0;
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().int32_t();
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->doSomethingElse(arg0, [&](const ::android::hardware::hidl_array<int32_t, 32>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback doSomethingElse called";
-            result_msg->set_name("doSomethingElse");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_ARRAY);
-            result_val_0->set_vector_size(1);
-            for (int i = 0; i < 1; i++) {
-                auto *result_val_0_array_i = result_val_0->add_vector_value();
-                result_val_0_array_i->set_type(TYPE_SCALAR);
-                result_val_0_array_i->set_scalar_type("int32_t");
-                result_val_0_array_i->mutable_scalar_value()->set_int32_t(arg0[i]);
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "doStuffAndReturnAString")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->doStuffAndReturnAString([&](const ::android::hardware::hidl_string& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback doStuffAndReturnAString called";
-            result_msg->set_name("doStuffAndReturnAString");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_STRING);
-            result_val_0->mutable_string_value()->set_message(arg0.c_str());
-            result_val_0->mutable_string_value()->set_length(arg0.size());
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "mapThisVector")) {
-        ::android::hardware::hidl_vec<int32_t> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().int32_t();
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->mapThisVector(arg0, [&](const ::android::hardware::hidl_vec<int32_t>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback mapThisVector called";
-            result_msg->set_name("mapThisVector");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_SCALAR);
-                result_val_0_vector_i->set_scalar_type("int32_t");
-                result_val_0_vector_i->mutable_scalar_value()->set_int32_t(arg0[i]);
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "callMe")) {
-        sp<::android::hardware::tests::foo::V1_0::IFooCallback> arg0;
-        arg0 = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_IFooCallback(callback_socket_name);
-        static_cast<Vts_android_hardware_tests_foo_V1_0_IFooCallback*>(arg0.get())->Register(func_msg.arg(0));
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->callMe(arg0);
-        result_msg->set_name("callMe");
-        return true;
-    }
-    if (!strcmp(func_name, "useAnEnum")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__SomeEnum(func_msg.arg(0), &(arg0), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum result0 = hw_binder_proxy_->useAnEnum(arg0);
-        result_msg->set_name("useAnEnum");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__tests__foo__V1_0__IFoo__SomeEnum(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "haveAGooberVec")) {
-        ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Goober> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            MessageTo__android__hardware__tests__foo__V1_0__IFoo__Goober(func_msg.arg(0).vector_value(arg0_index), &(arg0[arg0_index]), callback_socket_name);
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveAGooberVec(arg0);
-        result_msg->set_name("haveAGooberVec");
-        return true;
-    }
-    if (!strcmp(func_name, "haveAGoober")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::Goober arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__Goober(func_msg.arg(0), &(arg0), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveAGoober(arg0);
-        result_msg->set_name("haveAGoober");
-        return true;
-    }
-    if (!strcmp(func_name, "haveAGooberArray")) {
-        ::android::hardware::hidl_array<::android::hardware::tests::foo::V1_0::IFoo::Goober, 20> arg0;
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index].q = func_msg.arg(0).vector_value(arg0_index).struct_value(0).scalar_value().int32_t();
-            arg0[arg0_index].name = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).struct_value(1).string_value().message());
-            arg0[arg0_index].address = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).struct_value(2).string_value().message());
-            for (int arg0_arg0_index__numbers_index = 0; arg0_arg0_index__numbers_index < func_msg.arg(0).vector_value(arg0_index).struct_value(3).vector_value_size(); arg0_arg0_index__numbers_index++) {
-                arg0[arg0_index].numbers[arg0_arg0_index__numbers_index] = func_msg.arg(0).vector_value(arg0_index).struct_value(3).vector_value(arg0_arg0_index__numbers_index).scalar_value().double_t();
-            }
-            MessageTo__android__hardware__tests__foo__V1_0__IFoo__Fumble(func_msg.arg(0).vector_value(arg0_index).struct_value(4), &(arg0[arg0_index].fumble), callback_socket_name);
-            MessageTo__android__hardware__tests__foo__V1_0__IFoo__Fumble(func_msg.arg(0).vector_value(arg0_index).struct_value(5), &(arg0[arg0_index].gumble), callback_socket_name);
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveAGooberArray(arg0);
-        result_msg->set_name("haveAGooberArray");
-        return true;
-    }
-    if (!strcmp(func_name, "haveATypeFromAnotherFile")) {
-        ::android::hardware::tests::foo::V1_0::Abc arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__Abc(func_msg.arg(0), &(arg0), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveATypeFromAnotherFile(arg0);
-        result_msg->set_name("haveATypeFromAnotherFile");
-        return true;
-    }
-    if (!strcmp(func_name, "haveSomeStrings")) {
-        ::android::hardware::hidl_array<::android::hardware::hidl_string, 3> arg0;
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).string_value().message());
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveSomeStrings(arg0, [&](const ::android::hardware::hidl_array<::android::hardware::hidl_string, 2>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback haveSomeStrings called";
-            result_msg->set_name("haveSomeStrings");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_ARRAY);
-            result_val_0->set_vector_size(1);
-            for (int i = 0; i < 1; i++) {
-                auto *result_val_0_array_i = result_val_0->add_vector_value();
-                result_val_0_array_i->set_type(TYPE_STRING);
-                result_val_0_array_i->mutable_string_value()->set_message(arg0[i].c_str());
-                result_val_0_array_i->mutable_string_value()->set_length(arg0[i].size());
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "haveAStringVec")) {
-        ::android::hardware::hidl_vec<::android::hardware::hidl_string> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).string_value().message());
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveAStringVec(arg0, [&](const ::android::hardware::hidl_vec<::android::hardware::hidl_string>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback haveAStringVec called";
-            result_msg->set_name("haveAStringVec");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_STRING);
-                result_val_0_vector_i->mutable_string_value()->set_message(arg0[i].c_str());
-                result_val_0_vector_i->mutable_string_value()->set_length(arg0[i].size());
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "transposeMe")) {
-        ::android::hardware::hidl_array<float, 3, 5> arg0;
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            for (int arg0_arg0_index__index = 0; arg0_arg0_index__index < func_msg.arg(0).vector_value(arg0_index).vector_value_size(); arg0_arg0_index__index++) {
-                arg0[arg0_index][arg0_arg0_index__index] = func_msg.arg(0).vector_value(arg0_index).vector_value(arg0_arg0_index__index).scalar_value().float_t();
-            }
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->transposeMe(arg0, [&](const ::android::hardware::hidl_array<float, 5, 3>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback transposeMe called";
-            result_msg->set_name("transposeMe");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_ARRAY);
-            result_val_0->set_vector_size(1);
-            for (int i = 0; i < 1; i++) {
-                auto *result_val_0_array_i = result_val_0->add_vector_value();
-                result_val_0_array_i->set_type(TYPE_ARRAY);
-                result_val_0_array_i->set_vector_size(1);
-                for (int i = 0; i < 1; i++) {
-                    auto *result_val_0_array_i_array_i = result_val_0_array_i->add_vector_value();
-                    result_val_0_array_i_array_i->set_type(TYPE_SCALAR);
-                    result_val_0_array_i_array_i->set_scalar_type("float_t");
-                    result_val_0_array_i_array_i->mutable_scalar_value()->set_float_t(arg0[i][i]);
+    switch (HashString(func_name)) {
+        case HashString("convertToBoolIfSmall"): {
+            if (!strcmp(func_name, "convertToBoolIfSmall")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::Discriminator arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__Discriminator(func_msg.arg(0), &(arg0), callback_socket_name);
+                ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Union> arg1;
+                arg1.resize(func_msg.arg(1).vector_value_size());
+                for (int arg1_index = 0; arg1_index < func_msg.arg(1).vector_value_size(); arg1_index++) {
+                    MessageTo__android__hardware__tests__foo__V1_0__IFoo__Union(func_msg.arg(1).vector_value(arg1_index), &(arg1[arg1_index]), callback_socket_name);
                 }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->convertToBoolIfSmall(arg0, arg1, [&](const ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::ContainsUnion>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback convertToBoolIfSmall called";
+                    result_msg->set_name("convertToBoolIfSmall");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->mutable_vector_value()->Reserve(arg0.size());
+                        for (int i = 0; i < (int)arg0.size(); i++) {
+                            auto *result_val_0_vector_i = result_val_0->add_vector_value();
+                            result_val_0_vector_i->set_type(TYPE_STRUCT);
+                            SetResult__android__hardware__tests__foo__V1_0__IFoo__ContainsUnion(result_val_0_vector_i, arg0[i]);
+                        }
+                    }
+                });
+                return true;
             }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "callingDrWho")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(func_msg.arg(0), &(arg0), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->callingDrWho(arg0, [&](const ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback callingDrWho called";
-            result_msg->set_name("callingDrWho");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_STRUCT);
-            SetResult__android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(result_val_0, arg0);
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "transpose")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3 arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__StringMatrix5x3(func_msg.arg(0), &(arg0), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->transpose(arg0, [&](const ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback transpose called";
-            result_msg->set_name("transpose");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_STRUCT);
-            SetResult__android__hardware__tests__foo__V1_0__IFoo__StringMatrix3x5(result_val_0, arg0);
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "transpose2")) {
-        ::android::hardware::hidl_array<::android::hardware::hidl_string, 5, 3> arg0;
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            for (int arg0_arg0_index__index = 0; arg0_arg0_index__index < func_msg.arg(0).vector_value(arg0_index).vector_value_size(); arg0_arg0_index__index++) {
-                arg0[arg0_index][arg0_arg0_index__index] = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).vector_value(arg0_arg0_index__index).string_value().message());
-            }
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->transpose2(arg0, [&](const ::android::hardware::hidl_array<::android::hardware::hidl_string, 3, 5>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback transpose2 called";
-            result_msg->set_name("transpose2");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_ARRAY);
-            result_val_0->set_vector_size(1);
-            for (int i = 0; i < 1; i++) {
-                auto *result_val_0_array_i = result_val_0->add_vector_value();
-                result_val_0_array_i->set_type(TYPE_ARRAY);
-                result_val_0_array_i->set_vector_size(1);
-                for (int i = 0; i < 1; i++) {
-                    auto *result_val_0_array_i_array_i = result_val_0_array_i->add_vector_value();
-                    result_val_0_array_i_array_i->set_type(TYPE_STRING);
-                    result_val_0_array_i_array_i->mutable_string_value()->set_message(arg0[i][i].c_str());
-                    result_val_0_array_i_array_i->mutable_string_value()->set_length(arg0[i][i].size());
+            break;
+        }
+        case HashString("doThis"): {
+            if (!strcmp(func_name, "doThis")) {
+                float arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().float_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->doThis(arg0);
+                result_msg->set_name("doThis");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
                 }
+                return true;
             }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "sendVec")) {
-        ::android::hardware::hidl_vec<uint8_t> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().uint8_t();
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->sendVec(arg0, [&](const ::android::hardware::hidl_vec<uint8_t>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback sendVec called";
-            result_msg->set_name("sendVec");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_SCALAR);
-                result_val_0_vector_i->set_scalar_type("uint8_t");
-                result_val_0_vector_i->mutable_scalar_value()->set_uint8_t(arg0[i]);
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "sendVecVec")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->sendVecVec([&](const ::android::hardware::hidl_vec<::android::hardware::hidl_vec<uint8_t>>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback sendVecVec called";
-            result_msg->set_name("sendVecVec");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_VECTOR);
-                result_val_0_vector_i->set_vector_size(arg0[i].size());
-                for (int i = 0; i < (int)arg0[i].size(); i++) {
-                    auto *result_val_0_vector_i_vector_i = result_val_0_vector_i->add_vector_value();
-                    result_val_0_vector_i_vector_i->set_type(TYPE_SCALAR);
-                    result_val_0_vector_i_vector_i->set_scalar_type("uint8_t");
-                    result_val_0_vector_i_vector_i->mutable_scalar_value()->set_uint8_t(arg0[i][i]);
+            break;
+        }
+        case HashString("doThatAndReturnSomething"): {
+            if (!strcmp(func_name, "doThatAndReturnSomething")) {
+                int64_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int64_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                int32_t result0 = hw_binder_proxy_->doThatAndReturnSomething(arg0);
+                result_msg->set_name("doThatAndReturnSomething");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<int32_t>(result_val_0, result0);
                 }
+                return true;
             }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "haveAVectorOfInterfaces")) {
-        ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            if (func_msg.arg(0).vector_value(arg0_index).has_hidl_interface_pointer()) {
-                arg0[arg0_index] = reinterpret_cast<::android::hardware::tests::foo::V1_0::ISimple*>(func_msg.arg(0).vector_value(arg0_index).hidl_interface_pointer());
-            } else {
-                arg0[arg0_index] = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_ISimple(callback_socket_name);
-            }
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveAVectorOfInterfaces(arg0, [&](const ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback haveAVectorOfInterfaces called";
-            result_msg->set_name("haveAVectorOfInterfaces");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_HIDL_INTERFACE);
-                result_val_0_vector_i->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
-                if (arg0[i] != nullptr) {
-                    arg0[i]->incStrong(arg0[i].get());
-                    result_val_0_vector_i->set_hidl_interface_pointer(reinterpret_cast<uintptr_t>(arg0[i].get()));
+            break;
+        }
+        case HashString("doQuiteABit"): {
+            if (!strcmp(func_name, "doQuiteABit")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                int64_t arg1 = 0;
+                arg1 = func_msg.arg(1).scalar_value().int64_t();
+                float arg2 = 0;
+                arg2 = func_msg.arg(2).scalar_value().float_t();
+                double arg3 = 0;
+                arg3 = func_msg.arg(3).scalar_value().double_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                double result0 = hw_binder_proxy_->doQuiteABit(arg0, arg1, arg2, arg3);
+                result_msg->set_name("doQuiteABit");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
                 } else {
-                    result_val_0_vector_i->set_hidl_interface_pointer(0);
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<double>(result_val_0, result0);
                 }
+                return true;
             }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "haveAVectorOfGenericInterfaces")) {
-        ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            if (func_msg.arg(0).vector_value(arg0_index).has_hidl_interface_pointer()) {
-                arg0[arg0_index] = reinterpret_cast<::android::hidl::base::V1_0::IBase*>(func_msg.arg(0).vector_value(arg0_index).hidl_interface_pointer());
-            } else {
-                LOG(ERROR) << "general interface is not supported yet. ";
-            }
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->haveAVectorOfGenericInterfaces(arg0, [&](const ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback haveAVectorOfGenericInterfaces called";
-            result_msg->set_name("haveAVectorOfGenericInterfaces");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_HIDL_INTERFACE);
-                result_val_0_vector_i->set_predefined_type("::android::hidl::base::V1_0::IBase");
-                if (arg0[i] != nullptr) {
-                    arg0[i]->incStrong(arg0[i].get());
-                    result_val_0_vector_i->set_hidl_interface_pointer(reinterpret_cast<uintptr_t>(arg0[i].get()));
+            break;
+        }
+        case HashString("doSomethingElse"): {
+            if (!strcmp(func_name, "doSomethingElse")) {
+                ::android::hardware::hidl_array<int32_t, 15> arg0;
+                if (func_msg.arg(0).vector_raw_value().size() == 15 * sizeof(int32_t)) {
+                    memcpy(&arg0[0], func_msg.arg(0).vector_raw_value().data(), 15 * sizeof(int32_t));
                 } else {
-                    result_val_0_vector_i->set_hidl_interface_pointer(0);
+                    for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                        arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().int32_t();
+                    }
                 }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->doSomethingElse(arg0, [&](const ::android::hardware::hidl_array<int32_t, 32>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback doSomethingElse called";
+                    result_msg->set_name("doSomethingElse");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_ARRAY);
+                        result_val_0->set_vector_size(32);
+                        result_val_0->set_scalar_type("int32_t");
+                        result_val_0->set_vector_raw_value(&arg0[0], 32 * sizeof(int32_t));
+                    }
+                });
+                return true;
             }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "echoNullInterface")) {
-        sp<::android::hardware::tests::foo::V1_0::IFooCallback> arg0;
-        arg0 = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_IFooCallback(callback_socket_name);
-        static_cast<Vts_android_hardware_tests_foo_V1_0_IFooCallback*>(arg0.get())->Register(func_msg.arg(0));
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->echoNullInterface(arg0, [&](bool arg0 __attribute__((__unused__)),const sp<::android::hardware::tests::foo::V1_0::IFooCallback>& arg1 __attribute__((__unused__))){
-            LOG(INFO) << "callback echoNullInterface called";
-            result_msg->set_name("echoNullInterface");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_SCALAR);
-            result_val_0->set_scalar_type("bool_t");
-            result_val_0->mutable_scalar_value()->set_bool_t(arg0);
-            VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
-            result_val_1->set_type(TYPE_HIDL_CALLBACK);
-            LOG(ERROR) << "TYPE HIDL_CALLBACK is not supported yet. ";
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "createMyHandle")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->createMyHandle([&](const ::android::hardware::tests::foo::V1_0::IFoo::MyHandle& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback createMyHandle called";
-            result_msg->set_name("createMyHandle");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_STRUCT);
-            SetResult__android__hardware__tests__foo__V1_0__IFoo__MyHandle(result_val_0, arg0);
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "createHandles")) {
-        uint32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().uint32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->createHandles(arg0, [&](const ::android::hardware::hidl_vec<::android::hardware::hidl_handle>& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback createHandles called";
-            result_msg->set_name("createHandles");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_VECTOR);
-            result_val_0->set_vector_size(arg0.size());
-            for (int i = 0; i < (int)arg0.size(); i++) {
-                auto *result_val_0_vector_i = result_val_0->add_vector_value();
-                result_val_0_vector_i->set_type(TYPE_HANDLE);
-                result_val_0_vector_i->mutable_handle_value()->set_hidl_handle_address(reinterpret_cast<size_t>(new android::hardware::hidl_handle(arg0[i])));
-            }
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "closeHandles")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->closeHandles();
-        result_msg->set_name("closeHandles");
-        return true;
-    }
-    if (!strcmp(func_name, "repeatWithFmq")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::WithFmq arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__WithFmq(func_msg.arg(0), &(arg0), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->repeatWithFmq(arg0, [&](const ::android::hardware::tests::foo::V1_0::IFoo::WithFmq& arg0 __attribute__((__unused__))){
-            LOG(INFO) << "callback repeatWithFmq called";
-            result_msg->set_name("repeatWithFmq");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_STRUCT);
-            SetResult__android__hardware__tests__foo__V1_0__IFoo__WithFmq(result_val_0, arg0);
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "thisIsNew")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->thisIsNew();
-        result_msg->set_name("thisIsNew");
-        return true;
-    }
-    if (!strcmp(func_name, "expectNullHandle")) {
-        ::android::hardware::hidl_handle arg0;
-        if (func_msg.arg(0).has_handle_value()) {
-            if (func_msg.arg(0).handle_value().has_hidl_handle_address()) {
-                arg0 = *(reinterpret_cast<android::hardware::hidl_handle*>(func_msg.arg(0).handle_value().hidl_handle_address()));
-            } else {
-                native_handle_t* handle = native_handle_create(func_msg.arg(0).handle_value().num_fds(), func_msg.arg(0).handle_value().num_ints());
-                if (!handle) {
-                    LOG(ERROR) << "Failed to create handle. ";
-                    exit(-1);
+            break;
+        }
+        case HashString("doStuffAndReturnAString"): {
+            if (!strcmp(func_name, "doStuffAndReturnAString")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->doStuffAndReturnAString([&](const ::android::hardware::hidl_string& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback doStuffAndReturnAString called";
+                    result_msg->set_name("doStuffAndReturnAString");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_STRING);
+                        result_val_0->mutable_string_value()->set_message(arg0.c_str(), arg0.size());
+                        result_val_0->mutable_string_value()->set_length(arg0.size());
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("mapThisVector"): {
+            if (!strcmp(func_name, "mapThisVector")) {
+                ::android::hardware::hidl_vec<int32_t> arg0;
+                if (func_msg.arg(0).has_vector_memory_region()) {
+                    size_t arg0_count;
+                    int32_t* arg0_elements = GetMemoryRegionElements<int32_t>(func_msg.arg(0).vector_memory_region(), &arg0_count);
+                    if (arg0_elements != nullptr) {
+                        arg0.setToExternal(arg0_elements, arg0_count);
+                    } else {
+                        LOG(ERROR) << "memory region is not an array of int32_t.";
+                    }
+                } else if (func_msg.arg(0).has_vector_raw_value()) {
+                    arg0.resize(func_msg.arg(0).vector_raw_value().size() / sizeof(int32_t));
+                    memcpy(arg0.data(), func_msg.arg(0).vector_raw_value().data(), arg0.size() * sizeof(int32_t));
+                } else {
+                    arg0.resize(func_msg.arg(0).vector_value_size());
+                    for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                        arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().int32_t();
+                    }
                 }
-                for (int fd_index = 0; fd_index < func_msg.arg(0).handle_value().num_fds() + func_msg.arg(0).handle_value().num_ints(); fd_index++) {
-                    if (fd_index < func_msg.arg(0).handle_value().num_fds()) {
-                        FdMessage fd_val = func_msg.arg(0).handle_value().fd_val(fd_index);
-                        string file_name = fd_val.file_name();
-                        switch (fd_val.type()) {
-                            case FdType::FILE_TYPE:
-                            {
-                                size_t pre = 0; size_t pos = 0;
-                                string dir;
-                                struct stat st;
-                                while((pos=file_name.find_first_of('/', pre)) != string::npos){
-                                    dir = file_name.substr(0, pos++);
-                                    pre = pos;
-                                    if(dir.size() == 0) continue; // ignore leading /
-                                    if (stat(dir.c_str(), &st) == -1) {
-                                    LOG(INFO) << " Creating dir: " << dir;
-                                        mkdir(dir.c_str(), 0700);
-                                    }
-                                }
-                                int fd = open(file_name.c_str(), fd_val.flags() | O_CREAT, fd_val.mode());
-                                if (fd == -1) {
-                                    LOG(ERROR) << "Failed to open file: " << file_name << " error: " << errno;
-                                    exit (-1);
-                                }
-                                handle->data[fd_index] = fd;
-                                break;
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->mapThisVector(arg0, [&](const ::android::hardware::hidl_vec<int32_t>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback mapThisVector called";
+                    result_msg->set_name("mapThisVector");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->set_scalar_type("int32_t");
+                        result_val_0->set_vector_raw_value(arg0.data(), arg0.size() * sizeof(int32_t));
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("callMe"): {
+            if (!strcmp(func_name, "callMe")) {
+                sp<::android::hardware::tests::foo::V1_0::IFooCallback> arg0;
+                arg0 = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_IFooCallback(callback_socket_name);
+                static_cast<Vts_android_hardware_tests_foo_V1_0_IFooCallback*>(arg0.get())->Register(func_msg.arg(0));
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->callMe(arg0);
+                result_msg->set_name("callMe");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("useAnEnum"): {
+            if (!strcmp(func_name, "useAnEnum")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__SomeEnum(func_msg.arg(0), &(arg0), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum result0 = hw_binder_proxy_->useAnEnum(arg0);
+                result_msg->set_name("useAnEnum");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__tests__foo__V1_0__IFoo__SomeEnum(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAGooberVec"): {
+            if (!strcmp(func_name, "haveAGooberVec")) {
+                ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Goober> arg0;
+                arg0.resize(func_msg.arg(0).vector_value_size());
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    MessageTo__android__hardware__tests__foo__V1_0__IFoo__Goober(func_msg.arg(0).vector_value(arg0_index), &(arg0[arg0_index]), callback_socket_name);
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveAGooberVec(arg0);
+                result_msg->set_name("haveAGooberVec");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAGoober"): {
+            if (!strcmp(func_name, "haveAGoober")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::Goober arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__Goober(func_msg.arg(0), &(arg0), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveAGoober(arg0);
+                result_msg->set_name("haveAGoober");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAGooberArray"): {
+            if (!strcmp(func_name, "haveAGooberArray")) {
+                ::android::hardware::hidl_array<::android::hardware::tests::foo::V1_0::IFoo::Goober, 20> arg0;
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    arg0[arg0_index].q = func_msg.arg(0).vector_value(arg0_index).struct_value(0).scalar_value().int32_t();
+                    arg0[arg0_index].name = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).struct_value(1).string_value().message());
+                    arg0[arg0_index].address = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).struct_value(2).string_value().message());
+                    if (func_msg.arg(0).vector_value(arg0_index).struct_value(3).vector_raw_value().size() == 10 * sizeof(double)) {
+                        memcpy(&arg0[arg0_index].numbers[0], func_msg.arg(0).vector_value(arg0_index).struct_value(3).vector_raw_value().data(), 10 * sizeof(double));
+                    } else {
+                        for (int arg0_arg0_index__numbers_index = 0; arg0_arg0_index__numbers_index < func_msg.arg(0).vector_value(arg0_index).struct_value(3).vector_value_size(); arg0_arg0_index__numbers_index++) {
+                            arg0[arg0_index].numbers[arg0_arg0_index__numbers_index] = func_msg.arg(0).vector_value(arg0_index).struct_value(3).vector_value(arg0_arg0_index__numbers_index).scalar_value().double_t();
+                        }
+                    }
+                    MessageTo__android__hardware__tests__foo__V1_0__IFoo__Fumble(func_msg.arg(0).vector_value(arg0_index).struct_value(4), &(arg0[arg0_index].fumble), callback_socket_name);
+                    MessageTo__android__hardware__tests__foo__V1_0__IFoo__Fumble(func_msg.arg(0).vector_value(arg0_index).struct_value(5), &(arg0[arg0_index].gumble), callback_socket_name);
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveAGooberArray(arg0);
+                result_msg->set_name("haveAGooberArray");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("haveATypeFromAnotherFile"): {
+            if (!strcmp(func_name, "haveATypeFromAnotherFile")) {
+                ::android::hardware::tests::foo::V1_0::Abc arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__Abc(func_msg.arg(0), &(arg0), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveATypeFromAnotherFile(arg0);
+                result_msg->set_name("haveATypeFromAnotherFile");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("haveSomeStrings"): {
+            if (!strcmp(func_name, "haveSomeStrings")) {
+                ::android::hardware::hidl_array<::android::hardware::hidl_string, 3> arg0;
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    arg0[arg0_index] = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).string_value().message());
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveSomeStrings(arg0, [&](const ::android::hardware::hidl_array<::android::hardware::hidl_string, 2>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback haveSomeStrings called";
+                    result_msg->set_name("haveSomeStrings");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_ARRAY);
+                        result_val_0->set_vector_size(1);
+                        for (int i = 0; i < 1; i++) {
+                            auto *result_val_0_array_i = result_val_0->add_vector_value();
+                            result_val_0_array_i->set_type(TYPE_STRING);
+                            result_val_0_array_i->mutable_string_value()->set_message(arg0[i].c_str(), arg0[i].size());
+                            result_val_0_array_i->mutable_string_value()->set_length(arg0[i].size());
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAStringVec"): {
+            if (!strcmp(func_name, "haveAStringVec")) {
+                ::android::hardware::hidl_vec<::android::hardware::hidl_string> arg0;
+                arg0.resize(func_msg.arg(0).vector_value_size());
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    arg0[arg0_index] = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).string_value().message());
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveAStringVec(arg0, [&](const ::android::hardware::hidl_vec<::android::hardware::hidl_string>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback haveAStringVec called";
+                    result_msg->set_name("haveAStringVec");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->mutable_vector_value()->Reserve(arg0.size());
+                        for (int i = 0; i < (int)arg0.size(); i++) {
+                            auto *result_val_0_vector_i = result_val_0->add_vector_value();
+                            result_val_0_vector_i->set_type(TYPE_STRING);
+                            result_val_0_vector_i->mutable_string_value()->set_message(arg0[i].c_str(), arg0[i].size());
+                            result_val_0_vector_i->mutable_string_value()->set_length(arg0[i].size());
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("transposeMe"): {
+            if (!strcmp(func_name, "transposeMe")) {
+                ::android::hardware::hidl_array<float, 3, 5> arg0;
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    if (func_msg.arg(0).vector_value(arg0_index).vector_raw_value().size() == 5 * sizeof(float)) {
+                        memcpy(&arg0[arg0_index][0], func_msg.arg(0).vector_value(arg0_index).vector_raw_value().data(), 5 * sizeof(float));
+                    } else {
+                        for (int arg0_arg0_index__index = 0; arg0_arg0_index__index < func_msg.arg(0).vector_value(arg0_index).vector_value_size(); arg0_arg0_index__index++) {
+                            arg0[arg0_index][arg0_arg0_index__index] = func_msg.arg(0).vector_value(arg0_index).vector_value(arg0_arg0_index__index).scalar_value().float_t();
+                        }
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->transposeMe(arg0, [&](const ::android::hardware::hidl_array<float, 5, 3>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback transposeMe called";
+                    result_msg->set_name("transposeMe");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_ARRAY);
+                        result_val_0->set_vector_size(1);
+                        for (int i = 0; i < 1; i++) {
+                            auto *result_val_0_array_i = result_val_0->add_vector_value();
+                            result_val_0_array_i->set_type(TYPE_ARRAY);
+                            result_val_0_array_i->set_vector_size(3);
+                            result_val_0_array_i->set_scalar_type("float_t");
+                            result_val_0_array_i->set_vector_raw_value(&arg0[i][0], 3 * sizeof(float));
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("callingDrWho"): {
+            if (!strcmp(func_name, "callingDrWho")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(func_msg.arg(0), &(arg0), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->callingDrWho(arg0, [&](const ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback callingDrWho called";
+                    result_msg->set_name("callingDrWho");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_STRUCT);
+                        SetResult__android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(result_val_0, arg0);
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("transpose"): {
+            if (!strcmp(func_name, "transpose")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3 arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__StringMatrix5x3(func_msg.arg(0), &(arg0), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->transpose(arg0, [&](const ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback transpose called";
+                    result_msg->set_name("transpose");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_STRUCT);
+                        SetResult__android__hardware__tests__foo__V1_0__IFoo__StringMatrix3x5(result_val_0, arg0);
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("transpose2"): {
+            if (!strcmp(func_name, "transpose2")) {
+                ::android::hardware::hidl_array<::android::hardware::hidl_string, 5, 3> arg0;
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    for (int arg0_arg0_index__index = 0; arg0_arg0_index__index < func_msg.arg(0).vector_value(arg0_index).vector_value_size(); arg0_arg0_index__index++) {
+                        arg0[arg0_index][arg0_arg0_index__index] = ::android::hardware::hidl_string(func_msg.arg(0).vector_value(arg0_index).vector_value(arg0_arg0_index__index).string_value().message());
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->transpose2(arg0, [&](const ::android::hardware::hidl_array<::android::hardware::hidl_string, 3, 5>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback transpose2 called";
+                    result_msg->set_name("transpose2");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_ARRAY);
+                        result_val_0->set_vector_size(1);
+                        for (int i = 0; i < 1; i++) {
+                            auto *result_val_0_array_i = result_val_0->add_vector_value();
+                            result_val_0_array_i->set_type(TYPE_ARRAY);
+                            result_val_0_array_i->set_vector_size(1);
+                            for (int i = 0; i < 1; i++) {
+                                auto *result_val_0_array_i_array_i = result_val_0_array_i->add_vector_value();
+                                result_val_0_array_i_array_i->set_type(TYPE_STRING);
+                                result_val_0_array_i_array_i->mutable_string_value()->set_message(arg0[i][i].c_str(), arg0[i][i].size());
+                                result_val_0_array_i_array_i->mutable_string_value()->set_length(arg0[i][i].size());
                             }
-                            case FdType::DIR_TYPE:
-                            {
-                                struct stat st;
-                                if (!stat(file_name.c_str(), &st)) {
-                                    mkdir(file_name.c_str(), fd_val.mode());
-                                }
-                                handle->data[fd_index] = open(file_name.c_str(), O_DIRECTORY, fd_val.mode());
-                                break;
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("sendVec"): {
+            if (!strcmp(func_name, "sendVec")) {
+                ::android::hardware::hidl_vec<uint8_t> arg0;
+                if (func_msg.arg(0).has_vector_memory_region()) {
+                    size_t arg0_count;
+                    uint8_t* arg0_elements = GetMemoryRegionElements<uint8_t>(func_msg.arg(0).vector_memory_region(), &arg0_count);
+                    if (arg0_elements != nullptr) {
+                        arg0.setToExternal(arg0_elements, arg0_count);
+                    } else {
+                        LOG(ERROR) << "memory region is not an array of uint8_t.";
+                    }
+                } else if (func_msg.arg(0).has_vector_raw_value()) {
+                    arg0.resize(func_msg.arg(0).vector_raw_value().size() / sizeof(uint8_t));
+                    memcpy(arg0.data(), func_msg.arg(0).vector_raw_value().data(), arg0.size() * sizeof(uint8_t));
+                } else {
+                    arg0.resize(func_msg.arg(0).vector_value_size());
+                    for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                        arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().uint8_t();
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->sendVec(arg0, [&](const ::android::hardware::hidl_vec<uint8_t>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback sendVec called";
+                    result_msg->set_name("sendVec");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->set_scalar_type("uint8_t");
+                        result_val_0->set_vector_raw_value(arg0.data(), arg0.size() * sizeof(uint8_t));
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("sendVecVec"): {
+            if (!strcmp(func_name, "sendVecVec")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->sendVecVec([&](const ::android::hardware::hidl_vec<::android::hardware::hidl_vec<uint8_t>>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback sendVecVec called";
+                    result_msg->set_name("sendVecVec");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->mutable_vector_value()->Reserve(arg0.size());
+                        for (int i = 0; i < (int)arg0.size(); i++) {
+                            auto *result_val_0_vector_i = result_val_0->add_vector_value();
+                            result_val_0_vector_i->set_type(TYPE_VECTOR);
+                            result_val_0_vector_i->set_vector_size(arg0[i].size());
+                            result_val_0_vector_i->set_scalar_type("uint8_t");
+                            result_val_0_vector_i->set_vector_raw_value(arg0[i].data(), arg0[i].size() * sizeof(uint8_t));
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAVectorOfInterfaces"): {
+            if (!strcmp(func_name, "haveAVectorOfInterfaces")) {
+                ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>> arg0;
+                arg0.resize(func_msg.arg(0).vector_value_size());
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    if (func_msg.arg(0).vector_value(arg0_index).has_hidl_interface_pointer()) {
+                        arg0[arg0_index] = reinterpret_cast<::android::hardware::tests::foo::V1_0::ISimple*>(func_msg.arg(0).vector_value(arg0_index).hidl_interface_pointer());
+                    } else {
+                        arg0[arg0_index] = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_ISimple(callback_socket_name);
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveAVectorOfInterfaces(arg0, [&](const ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback haveAVectorOfInterfaces called";
+                    result_msg->set_name("haveAVectorOfInterfaces");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->mutable_vector_value()->Reserve(arg0.size());
+                        for (int i = 0; i < (int)arg0.size(); i++) {
+                            auto *result_val_0_vector_i = result_val_0->add_vector_value();
+                            result_val_0_vector_i->set_type(TYPE_HIDL_INTERFACE);
+                            result_val_0_vector_i->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
+                            if (arg0[i] != nullptr) {
+                                arg0[i]->incStrong(arg0[i].get());
+                                result_val_0_vector_i->set_hidl_interface_pointer(reinterpret_cast<uintptr_t>(arg0[i].get()));
+                            } else {
+                                result_val_0_vector_i->set_hidl_interface_pointer(0);
                             }
-                            case FdType::DEV_TYPE:
-                            {
-                                if(file_name == "/dev/ashmem") {
-                                    handle->data[fd_index] = ashmem_create_region("SharedMemory", fd_val.memory().size());
-                                }
-                                break;
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAVectorOfGenericInterfaces"): {
+            if (!strcmp(func_name, "haveAVectorOfGenericInterfaces")) {
+                ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>> arg0;
+                arg0.resize(func_msg.arg(0).vector_value_size());
+                for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                    if (func_msg.arg(0).vector_value(arg0_index).has_hidl_interface_pointer()) {
+                        arg0[arg0_index] = reinterpret_cast<::android::hidl::base::V1_0::IBase*>(func_msg.arg(0).vector_value(arg0_index).hidl_interface_pointer());
+                    } else {
+                        LOG(ERROR) << "general interface is not supported yet. ";
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->haveAVectorOfGenericInterfaces(arg0, [&](const ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback haveAVectorOfGenericInterfaces called";
+                    result_msg->set_name("haveAVectorOfGenericInterfaces");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->mutable_vector_value()->Reserve(arg0.size());
+                        for (int i = 0; i < (int)arg0.size(); i++) {
+                            auto *result_val_0_vector_i = result_val_0->add_vector_value();
+                            result_val_0_vector_i->set_type(TYPE_HIDL_INTERFACE);
+                            result_val_0_vector_i->set_predefined_type("::android::hidl::base::V1_0::IBase");
+                            if (arg0[i] != nullptr) {
+                                arg0[i]->incStrong(arg0[i].get());
+                                result_val_0_vector_i->set_hidl_interface_pointer(reinterpret_cast<uintptr_t>(arg0[i].get()));
+                            } else {
+                                result_val_0_vector_i->set_hidl_interface_pointer(0);
                             }
-                            case FdType::PIPE_TYPE:
-                            case FdType::SOCKET_TYPE:
-                            case FdType::LINK_TYPE:
-                            {
-                                LOG(ERROR) << "Not supported yet. ";
-                                break;
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("echoNullInterface"): {
+            if (!strcmp(func_name, "echoNullInterface")) {
+                sp<::android::hardware::tests::foo::V1_0::IFooCallback> arg0;
+                arg0 = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_IFooCallback(callback_socket_name);
+                static_cast<Vts_android_hardware_tests_foo_V1_0_IFooCallback*>(arg0.get())->Register(func_msg.arg(0));
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->echoNullInterface(arg0, [&](bool arg0 __attribute__((__unused__)),const sp<::android::hardware::tests::foo::V1_0::IFooCallback>& arg1 __attribute__((__unused__))){
+                    LOG(INFO) << "callback echoNullInterface called";
+                    result_msg->set_name("echoNullInterface");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 2 && VerifyValue(expected_result->return_type_hidl(0), arg0) && VerifyValue(expected_result->return_type_hidl(1), arg1);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        SetScalarResult<bool>(result_val_0, arg0);
+                        VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
+                        result_val_1->set_type(TYPE_HIDL_CALLBACK);
+                        LOG(ERROR) << "TYPE HIDL_CALLBACK is not supported yet. ";
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("createMyHandle"): {
+            if (!strcmp(func_name, "createMyHandle")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->createMyHandle([&](const ::android::hardware::tests::foo::V1_0::IFoo::MyHandle& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback createMyHandle called";
+                    result_msg->set_name("createMyHandle");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_STRUCT);
+                        SetResult__android__hardware__tests__foo__V1_0__IFoo__MyHandle(result_val_0, arg0);
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("createHandles"): {
+            if (!strcmp(func_name, "createHandles")) {
+                uint32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().uint32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->createHandles(arg0, [&](const ::android::hardware::hidl_vec<::android::hardware::hidl_handle>& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback createHandles called";
+                    result_msg->set_name("createHandles");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_VECTOR);
+                        result_val_0->set_vector_size(arg0.size());
+                        result_val_0->mutable_vector_value()->Reserve(arg0.size());
+                        for (int i = 0; i < (int)arg0.size(); i++) {
+                            auto *result_val_0_vector_i = result_val_0->add_vector_value();
+                            result_val_0_vector_i->set_type(TYPE_HANDLE);
+                            result_val_0_vector_i->mutable_handle_value()->set_hidl_handle_address(reinterpret_cast<size_t>(new android::hardware::hidl_handle(arg0[i])));
+                        }
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("closeHandles"): {
+            if (!strcmp(func_name, "closeHandles")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->closeHandles();
+                result_msg->set_name("closeHandles");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("repeatWithFmq"): {
+            if (!strcmp(func_name, "repeatWithFmq")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::WithFmq arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__WithFmq(func_msg.arg(0), &(arg0), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->repeatWithFmq(arg0, [&](const ::android::hardware::tests::foo::V1_0::IFoo::WithFmq& arg0 __attribute__((__unused__))){
+                    LOG(INFO) << "callback repeatWithFmq called";
+                    result_msg->set_name("repeatWithFmq");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), arg0);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_STRUCT);
+                        SetResult__android__hardware__tests__foo__V1_0__IFoo__WithFmq(result_val_0, arg0);
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("thisIsNew"): {
+            if (!strcmp(func_name, "thisIsNew")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->thisIsNew();
+                result_msg->set_name("thisIsNew");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("expectNullHandle"): {
+            if (!strcmp(func_name, "expectNullHandle")) {
+                ::android::hardware::hidl_handle arg0;
+                if (func_msg.arg(0).has_handle_value()) {
+                    if (func_msg.arg(0).handle_value().has_hidl_handle_address()) {
+                        arg0 = *(reinterpret_cast<android::hardware::hidl_handle*>(func_msg.arg(0).handle_value().hidl_handle_address()));
+                    } else {
+                        native_handle_t* handle = native_handle_create(func_msg.arg(0).handle_value().num_fds(), func_msg.arg(0).handle_value().num_ints());
+                        if (!handle) {
+                            LOG(ERROR) << "Failed to create handle. ";
+                            exit(-1);
+                        }
+                        for (int fd_index = 0; fd_index < func_msg.arg(0).handle_value().num_fds() + func_msg.arg(0).handle_value().num_ints(); fd_index++) {
+                            if (fd_index < func_msg.arg(0).handle_value().num_fds()) {
+                                FdMessage fd_val = func_msg.arg(0).handle_value().fd_val(fd_index);
+                                string file_name = fd_val.file_name();
+                                switch (fd_val.type()) {
+                                    case FdType::FILE_TYPE:
+                                    {
+                                        size_t pre = 0; size_t pos = 0;
+                                        string dir;
+                                        struct stat st;
+                                        while((pos=file_name.find_first_of('/', pre)) != string::npos){
+                                            dir = file_name.substr(0, pos++);
+                                            pre = pos;
+                                            if(dir.size() == 0) continue; // ignore leading /
+                                            if (stat(dir.c_str(), &st) == -1) {
+                                            LOG(INFO) << " Creating dir: " << dir;
+                                                mkdir(dir.c_str(), 0700);
+                                            }
+                                        }
+                                        int fd = open(file_name.c_str(), fd_val.flags() | O_CREAT, fd_val.mode());
+                                        if (fd == -1) {
+                                            LOG(ERROR) << "Failed to open file: " << file_name << " error: " << errno;
+                                            exit (-1);
+                                        }
+                                        handle->data[fd_index] = fd;
+                                        break;
+                                    }
+                                    case FdType::DIR_TYPE:
+                                    {
+                                        struct stat st;
+                                        if (!stat(file_name.c_str(), &st)) {
+                                            mkdir(file_name.c_str(), fd_val.mode());
+                                        }
+                                        handle->data[fd_index] = open(file_name.c_str(), O_DIRECTORY, fd_val.mode());
+                                        break;
+                                    }
+                                    case FdType::DEV_TYPE:
+                                    {
+                                        if(file_name == "/dev/ashmem") {
+                                            handle->data[fd_index] = ashmem_create_region("SharedMemory", fd_val.memory().size());
+                                        }
+                                        break;
+                                    }
+                                    case FdType::PIPE_TYPE:
+                                    case FdType::SOCKET_TYPE:
+                                    case FdType::LINK_TYPE:
+                                    {
+                                        LOG(ERROR) << "Not supported yet. ";
+                                        break;
+                                    }
+                                }
+                            } else {
+                                handle->data[fd_index] = func_msg.arg(0).handle_value().int_val(fd_index -func_msg.arg(0).handle_value().num_fds());
                             }
                         }
+                        arg0 = handle;
+                    }
+                } else {
+                    arg0 = nullptr;
+                }
+                ::android::hardware::tests::foo::V1_0::Abc arg1;
+                MessageTo__android__hardware__tests__foo__V1_0__Abc(func_msg.arg(1), &(arg1), callback_socket_name);
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->expectNullHandle(arg0, arg1, [&](bool arg0 __attribute__((__unused__)),bool arg1 __attribute__((__unused__))){
+                    LOG(INFO) << "callback expectNullHandle called";
+                    result_msg->set_name("expectNullHandle");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 2 && VerifyValue(expected_result->return_type_hidl(0), arg0) && VerifyValue(expected_result->return_type_hidl(1), arg1);
                     } else {
-                        handle->data[fd_index] = func_msg.arg(0).handle_value().int_val(fd_index -func_msg.arg(0).handle_value().num_fds());
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        SetScalarResult<bool>(result_val_0, arg0);
+                        VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
+                        SetScalarResult<bool>(result_val_1, arg1);
                     }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("takeAMask"): {
+            if (!strcmp(func_name, "takeAMask")) {
+                ::android::hardware::tests::foo::V1_0::IFoo::BitField arg0;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__BitField(func_msg.arg(0), &(arg0), callback_socket_name);
+                uint8_t arg1;
+                arg1 = func_msg.arg(1).scalar_value().uint8_t();
+                ::android::hardware::tests::foo::V1_0::IFoo::MyMask arg2;
+                MessageTo__android__hardware__tests__foo__V1_0__IFoo__MyMask(func_msg.arg(2), &(arg2), callback_socket_name);
+                uint8_t arg3;
+                arg3 = func_msg.arg(3).scalar_value().uint8_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->takeAMask(arg0, arg1, arg2, arg3, [&](::android::hardware::tests::foo::V1_0::IFoo::BitField arg0 __attribute__((__unused__)),uint8_t arg1 __attribute__((__unused__)),uint8_t arg2 __attribute__((__unused__)),uint8_t arg3 __attribute__((__unused__))){
+                    LOG(INFO) << "callback takeAMask called";
+                    result_msg->set_name("takeAMask");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 4 && VerifyValue(expected_result->return_type_hidl(0), arg0) && VerifyValue(expected_result->return_type_hidl(1), arg1) && VerifyValue(expected_result->return_type_hidl(2), arg2) && VerifyValue(expected_result->return_type_hidl(3), arg3);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        result_val_0->set_type(TYPE_ENUM);
+                        SetResult__android__hardware__tests__foo__V1_0__IFoo__BitField(result_val_0, arg0);
+                        VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
+                        SetScalarResult<uint8_t>(result_val_1, arg1);
+                        VariableSpecificationMessage* result_val_2 = result_msg->add_return_type_hidl();
+                        SetScalarResult<uint8_t>(result_val_2, arg2);
+                        VariableSpecificationMessage* result_val_3 = result_msg->add_return_type_hidl();
+                        SetScalarResult<uint8_t>(result_val_3, arg3);
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAInterface"): {
+            if (!strcmp(func_name, "haveAInterface")) {
+                sp<::android::hardware::tests::foo::V1_0::ISimple> arg0;
+                if (func_msg.arg(0).has_hidl_interface_pointer()) {
+                    arg0 = reinterpret_cast<::android::hardware::tests::foo::V1_0::ISimple*>(func_msg.arg(0).hidl_interface_pointer());
+                } else {
+                    arg0 = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_ISimple(callback_socket_name);
                 }
-                arg0 = handle;
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                sp<::android::hardware::tests::foo::V1_0::ISimple> result0 = hw_binder_proxy_->haveAInterface(arg0);
+                result_msg->set_name("haveAInterface");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_HIDL_INTERFACE);
+                    result_val_0->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
+                    if (result0 != nullptr) {
+                        result0->incStrong(result0.get());
+                        result_val_0->set_hidl_interface_pointer(reinterpret_cast<uintptr_t>(result0.get()));
+                    } else {
+                        result_val_0->set_hidl_interface_pointer(0);
+                    }
+                }
+                return true;
             }
-        } else {
-            arg0 = nullptr;
-        }
-        ::android::hardware::tests::foo::V1_0::Abc arg1;
-        MessageTo__android__hardware__tests__foo__V1_0__Abc(func_msg.arg(1), &(arg1), callback_socket_name);
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->expectNullHandle(arg0, arg1, [&](bool arg0 __attribute__((__unused__)),bool arg1 __attribute__((__unused__))){
-            LOG(INFO) << "callback expectNullHandle called";
-            result_msg->set_name("expectNullHandle");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_SCALAR);
-            result_val_0->set_scalar_type("bool_t");
-            result_val_0->mutable_scalar_value()->set_bool_t(arg0);
-            VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
-            result_val_1->set_type(TYPE_SCALAR);
-            result_val_1->set_scalar_type("bool_t");
-            result_val_1->mutable_scalar_value()->set_bool_t(arg1);
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "takeAMask")) {
-        ::android::hardware::tests::foo::V1_0::IFoo::BitField arg0;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__BitField(func_msg.arg(0), &(arg0), callback_socket_name);
-        uint8_t arg1;
-        arg1 = func_msg.arg(1).scalar_value().uint8_t();
-        ::android::hardware::tests::foo::V1_0::IFoo::MyMask arg2;
-        MessageTo__android__hardware__tests__foo__V1_0__IFoo__MyMask(func_msg.arg(2), &(arg2), callback_socket_name);
-        uint8_t arg3;
-        arg3 = func_msg.arg(3).scalar_value().uint8_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->takeAMask(arg0, arg1, arg2, arg3, [&](::android::hardware::tests::foo::V1_0::IFoo::BitField arg0 __attribute__((__unused__)),uint8_t arg1 __attribute__((__unused__)),uint8_t arg2 __attribute__((__unused__)),uint8_t arg3 __attribute__((__unused__))){
-            LOG(INFO) << "callback takeAMask called";
-            result_msg->set_name("takeAMask");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_ENUM);
-            SetResult__android__hardware__tests__foo__V1_0__IFoo__BitField(result_val_0, arg0);
-            VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
-            result_val_1->set_type(TYPE_SCALAR);
-            result_val_1->set_scalar_type("uint8_t");
-            result_val_1->mutable_scalar_value()->set_uint8_t(arg1);
-            VariableSpecificationMessage* result_val_2 = result_msg->add_return_type_hidl();
-            result_val_2->set_type(TYPE_SCALAR);
-            result_val_2->set_scalar_type("uint8_t");
-            result_val_2->mutable_scalar_value()->set_uint8_t(arg2);
-            VariableSpecificationMessage* result_val_3 = result_msg->add_return_type_hidl();
-            result_val_3->set_type(TYPE_SCALAR);
-            result_val_3->set_scalar_type("uint8_t");
-            result_val_3->mutable_scalar_value()->set_uint8_t(arg3);
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "haveAInterface")) {
-        sp<::android::hardware::tests::foo::V1_0::ISimple> arg0;
-        if (func_msg.arg(0).has_hidl_interface_pointer()) {
-            arg0 = reinterpret_cast<::android::hardware::tests::foo::V1_0::ISimple*>(func_msg.arg(0).hidl_interface_pointer());
-        } else {
-            arg0 = VtsFuzzerCreateVts_android_hardware_tests_foo_V1_0_ISimple(callback_socket_name);
-        }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        sp<::android::hardware::tests::foo::V1_0::ISimple> result0 = hw_binder_proxy_->haveAInterface(arg0);
-        result_msg->set_name("haveAInterface");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_HIDL_INTERFACE);
-        result_val_0->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
-        if (result0 != nullptr) {
-            result0->incStrong(result0.get());
-            result_val_0->set_hidl_interface_pointer(reinterpret_cast<uintptr_t>(result0.get()));
-        } else {
-            result_val_0->set_hidl_interface_pointer(0);
+            break;
+        }
+        case HashString("notifySyspropsChanged"): {
+            if (!strcmp(func_name, "notifySyspropsChanged")) {
+                LOG(INFO) << "Call notifySyspropsChanged";
+                hw_binder_proxy_->notifySyspropsChanged();
+                result_msg->set_name("notifySyspropsChanged");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(func_name, "notifySyspropsChanged")) {
-        LOG(INFO) << "Call notifySyspropsChanged";
-        hw_binder_proxy_->notifySyspropsChanged();
-        result_msg->set_name("notifySyspropsChanged");
-        return true;
     }
     return false;
 }
 
 bool FuzzerExtended_android_hardware_tests_bar_V1_0_IBar::VerifyResults(const FunctionSpecificationMessage& expected_result __attribute__((__unused__)),
     const FunctionSpecificationMessage& actual_result __attribute__((__unused__))) {
-    if (!strcmp(actual_result.name().c_str(), "convertToBoolIfSmall")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+    switch (HashString(actual_result.name().c_str())) {
+        case HashString("convertToBoolIfSmall"): {
+            if (!strcmp(actual_result.name().c_str(), "convertToBoolIfSmall")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    if (!Verify__android__hardware__tests__foo__V1_0__IFoo__ContainsUnion(expected_result.return_type_hidl(0).vector_value(i), actual_result.return_type_hidl(0).vector_value(i))) { return false; }
+                }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (!Verify__android__hardware__tests__foo__V1_0__IFoo__ContainsUnion(expected_result.return_type_hidl(0).vector_value(i), actual_result.return_type_hidl(0).vector_value(i))) { return false; }
+        case HashString("doThis"): {
+            if (!strcmp(actual_result.name().c_str(), "doThis")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "doThis")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "doThatAndReturnSomething")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().int32_t() != expected_result.return_type_hidl(0).scalar_value().int32_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "doQuiteABit")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().double_t() != expected_result.return_type_hidl(0).scalar_value().double_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "doSomethingElse")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("doThatAndReturnSomething"): {
+            if (!strcmp(actual_result.name().c_str(), "doThatAndReturnSomething")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().int32_t() != expected_result.return_type_hidl(0).scalar_value().int32_t()) { return false; }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (actual_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t() != expected_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t()) { return false; }
+        case HashString("doQuiteABit"): {
+            if (!strcmp(actual_result.name().c_str(), "doQuiteABit")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().double_t() != expected_result.return_type_hidl(0).scalar_value().double_t()) { return false; }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "doStuffAndReturnAString")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (strcmp(actual_result.return_type_hidl(0).string_value().message().c_str(), expected_result.return_type_hidl(0).string_value().message().c_str())!= 0){ return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "mapThisVector")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("doSomethingElse"): {
+            if (!strcmp(actual_result.name().c_str(), "doSomethingElse")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).has_vector_raw_value() || expected_result.return_type_hidl(0).has_vector_raw_value()) {
+                    if (GetScalarVectorValues<int32_t>(expected_result.return_type_hidl(0), &ScalarDataValueMessage::int32_t) != GetScalarVectorValues<int32_t>(actual_result.return_type_hidl(0), &ScalarDataValueMessage::int32_t)) {
+                        LOG(ERROR) << "Verification failed for raw vector value.";
+                        return false;
+                    }
+                } else {
+                    if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                        LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                        return false;
+                    }
+                    for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                        if (actual_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t() != expected_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t()) { return false; }
+                    }
+                }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (actual_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t() != expected_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t()) { return false; }
+        case HashString("doStuffAndReturnAString"): {
+            if (!strcmp(actual_result.name().c_str(), "doStuffAndReturnAString")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (strcmp(actual_result.return_type_hidl(0).string_value().message().c_str(), expected_result.return_type_hidl(0).string_value().message().c_str())!= 0){ return false; }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "callMe")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "useAnEnum")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__tests__foo__V1_0__IFoo__SomeEnum(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAGooberVec")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAGoober")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAGooberArray")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveATypeFromAnotherFile")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveSomeStrings")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("mapThisVector"): {
+            if (!strcmp(actual_result.name().c_str(), "mapThisVector")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).has_vector_raw_value() || expected_result.return_type_hidl(0).has_vector_raw_value()) {
+                    if (GetScalarVectorValues<int32_t>(expected_result.return_type_hidl(0), &ScalarDataValueMessage::int32_t) != GetScalarVectorValues<int32_t>(actual_result.return_type_hidl(0), &ScalarDataValueMessage::int32_t)) {
+                        LOG(ERROR) << "Verification failed for raw vector value.";
+                        return false;
+                    }
+                } else {
+                    if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                        LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                        return false;
+                    }
+                    for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                        if (actual_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t() != expected_result.return_type_hidl(0).vector_value(i).scalar_value().int32_t()) { return false; }
+                    }
+                }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (strcmp(actual_result.return_type_hidl(0).vector_value(i).string_value().message().c_str(), expected_result.return_type_hidl(0).vector_value(i).string_value().message().c_str())!= 0){ return false; }
+        case HashString("callMe"): {
+            if (!strcmp(actual_result.name().c_str(), "callMe")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAStringVec")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("useAnEnum"): {
+            if (!strcmp(actual_result.name().c_str(), "useAnEnum")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__tests__foo__V1_0__IFoo__SomeEnum(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (strcmp(actual_result.return_type_hidl(0).vector_value(i).string_value().message().c_str(), expected_result.return_type_hidl(0).vector_value(i).string_value().message().c_str())!= 0){ return false; }
+        case HashString("haveAGooberVec"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAGooberVec")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "transposeMe")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("haveAGoober"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAGoober")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (actual_result.return_type_hidl(0).vector_value(i).vector_value_size() != expected_result.return_type_hidl(0).vector_value(i).vector_value_size()) {
-                LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value(i).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value(i).vector_value_size();
-                return false;
+        case HashString("haveAGooberArray"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAGooberArray")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
             }
-            for (int i = 0; i < expected_result.return_type_hidl(0).vector_value(i).vector_value_size(); i++) {
-                if (actual_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().float_t() != expected_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().float_t()) { return false; }
+            break;
+        }
+        case HashString("haveATypeFromAnotherFile"): {
+            if (!strcmp(actual_result.name().c_str(), "haveATypeFromAnotherFile")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
             }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "callingDrWho")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (!Verify__android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "transpose")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (!Verify__android__hardware__tests__foo__V1_0__IFoo__StringMatrix3x5(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "transpose2")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("haveSomeStrings"): {
+            if (!strcmp(actual_result.name().c_str(), "haveSomeStrings")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    if (strcmp(actual_result.return_type_hidl(0).vector_value(i).string_value().message().c_str(), expected_result.return_type_hidl(0).vector_value(i).string_value().message().c_str())!= 0){ return false; }
+                }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (actual_result.return_type_hidl(0).vector_value(i).vector_value_size() != expected_result.return_type_hidl(0).vector_value(i).vector_value_size()) {
-                LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value(i).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value(i).vector_value_size();
-                return false;
+        case HashString("haveAStringVec"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAStringVec")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    if (strcmp(actual_result.return_type_hidl(0).vector_value(i).string_value().message().c_str(), expected_result.return_type_hidl(0).vector_value(i).string_value().message().c_str())!= 0){ return false; }
+                }
+                return true;
             }
-            for (int i = 0; i < expected_result.return_type_hidl(0).vector_value(i).vector_value_size(); i++) {
-                if (strcmp(actual_result.return_type_hidl(0).vector_value(i).vector_value(i).string_value().message().c_str(), expected_result.return_type_hidl(0).vector_value(i).vector_value(i).string_value().message().c_str())!= 0){ return false; }
+            break;
+        }
+        case HashString("transposeMe"): {
+            if (!strcmp(actual_result.name().c_str(), "transposeMe")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    if (actual_result.return_type_hidl(0).vector_value(i).has_vector_raw_value() || expected_result.return_type_hidl(0).vector_value(i).has_vector_raw_value()) {
+                        if (GetScalarVectorValues<float>(expected_result.return_type_hidl(0).vector_value(i), &ScalarDataValueMessage::float_t) != GetScalarVectorValues<float>(actual_result.return_type_hidl(0).vector_value(i), &ScalarDataValueMessage::float_t)) {
+                            LOG(ERROR) << "Verification failed for raw vector value.";
+                            return false;
+                        }
+                    } else {
+                        if (actual_result.return_type_hidl(0).vector_value(i).vector_value_size() != expected_result.return_type_hidl(0).vector_value(i).vector_value_size()) {
+                            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value(i).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value(i).vector_value_size();
+                            return false;
+                        }
+                        for (int i = 0; i < expected_result.return_type_hidl(0).vector_value(i).vector_value_size(); i++) {
+                            if (actual_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().float_t() != expected_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().float_t()) { return false; }
+                        }
+                    }
+                }
+                return true;
             }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "sendVec")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("callingDrWho"): {
+            if (!strcmp(actual_result.name().c_str(), "callingDrWho")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (!Verify__android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (actual_result.return_type_hidl(0).vector_value(i).scalar_value().uint8_t() != expected_result.return_type_hidl(0).vector_value(i).scalar_value().uint8_t()) { return false; }
+        case HashString("transpose"): {
+            if (!strcmp(actual_result.name().c_str(), "transpose")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (!Verify__android__hardware__tests__foo__V1_0__IFoo__StringMatrix3x5(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "sendVecVec")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("transpose2"): {
+            if (!strcmp(actual_result.name().c_str(), "transpose2")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i < expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    if (actual_result.return_type_hidl(0).vector_value(i).vector_value_size() != expected_result.return_type_hidl(0).vector_value(i).vector_value_size()) {
+                        LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value(i).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value(i).vector_value_size();
+                        return false;
+                    }
+                    for (int i = 0; i < expected_result.return_type_hidl(0).vector_value(i).vector_value_size(); i++) {
+                        if (strcmp(actual_result.return_type_hidl(0).vector_value(i).vector_value(i).string_value().message().c_str(), expected_result.return_type_hidl(0).vector_value(i).vector_value(i).string_value().message().c_str())!= 0){ return false; }
+                    }
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("sendVec"): {
+            if (!strcmp(actual_result.name().c_str(), "sendVec")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).has_vector_raw_value() || expected_result.return_type_hidl(0).has_vector_raw_value()) {
+                    if (GetScalarVectorValues<uint8_t>(expected_result.return_type_hidl(0), &ScalarDataValueMessage::uint8_t) != GetScalarVectorValues<uint8_t>(actual_result.return_type_hidl(0), &ScalarDataValueMessage::uint8_t)) {
+                        LOG(ERROR) << "Verification failed for raw vector value.";
+                        return false;
+                    }
+                } else {
+                    if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                        LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                        return false;
+                    }
+                    for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                        if (actual_result.return_type_hidl(0).vector_value(i).scalar_value().uint8_t() != expected_result.return_type_hidl(0).vector_value(i).scalar_value().uint8_t()) { return false; }
+                    }
+                }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            if (actual_result.return_type_hidl(0).vector_value(i).vector_value_size() != expected_result.return_type_hidl(0).vector_value(i).vector_value_size()) {
-                LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value(i).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value(i).vector_value_size();
-                return false;
+        case HashString("sendVecVec"): {
+            if (!strcmp(actual_result.name().c_str(), "sendVecVec")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    if (actual_result.return_type_hidl(0).vector_value(i).has_vector_raw_value() || expected_result.return_type_hidl(0).vector_value(i).has_vector_raw_value()) {
+                        if (GetScalarVectorValues<uint8_t>(expected_result.return_type_hidl(0).vector_value(i), &ScalarDataValueMessage::uint8_t) != GetScalarVectorValues<uint8_t>(actual_result.return_type_hidl(0).vector_value(i), &ScalarDataValueMessage::uint8_t)) {
+                            LOG(ERROR) << "Verification failed for raw vector value.";
+                            return false;
+                        }
+                    } else {
+                        if (actual_result.return_type_hidl(0).vector_value(i).vector_value_size() != expected_result.return_type_hidl(0).vector_value(i).vector_value_size()) {
+                            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value(i).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value(i).vector_value_size();
+                            return false;
+                        }
+                        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value(i).vector_value_size(); i++) {
+                            if (actual_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().uint8_t() != expected_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().uint8_t()) { return false; }
+                        }
+                    }
+                }
+                return true;
             }
-            for (int i = 0; i <expected_result.return_type_hidl(0).vector_value(i).vector_value_size(); i++) {
-                if (actual_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().uint8_t() != expected_result.return_type_hidl(0).vector_value(i).vector_value(i).scalar_value().uint8_t()) { return false; }
+            break;
+        }
+        case HashString("haveAVectorOfInterfaces"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAVectorOfInterfaces")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    LOG(ERROR) << "TYPE_HIDL_INTERFACE is not supported yet. ";
+                }
+                return true;
             }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAVectorOfInterfaces")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("haveAVectorOfGenericInterfaces"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAVectorOfGenericInterfaces")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    LOG(ERROR) << "TYPE_HIDL_INTERFACE is not supported yet. ";
+                }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            LOG(ERROR) << "TYPE_HIDL_INTERFACE is not supported yet. ";
+        case HashString("echoNullInterface"): {
+            if (!strcmp(actual_result.name().c_str(), "echoNullInterface")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                LOG(ERROR) << "TYPE_HILD_CALLBACK is not supported yet. ";
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAVectorOfGenericInterfaces")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("createMyHandle"): {
+            if (!strcmp(actual_result.name().c_str(), "createMyHandle")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (!Verify__android__hardware__tests__foo__V1_0__IFoo__MyHandle(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            LOG(ERROR) << "TYPE_HIDL_INTERFACE is not supported yet. ";
+        case HashString("createHandles"): {
+            if (!strcmp(actual_result.name().c_str(), "createHandles")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
+                    LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
+                    return false;
+                }
+                for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
+                    LOG(ERROR) << "TYPE_HANDLE is not supported yet. ";
+                }
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "echoNullInterface")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        LOG(ERROR) << "TYPE_HILD_CALLBACK is not supported yet. ";
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "createMyHandle")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (!Verify__android__hardware__tests__foo__V1_0__IFoo__MyHandle(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "createHandles")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).vector_value_size() != expected_result.return_type_hidl(0).vector_value_size()) {
-            LOG(ERROR) << "Verification failed for vector size. expected: " << expected_result.return_type_hidl(0).vector_value_size() << " actual: " << actual_result.return_type_hidl(0).vector_value_size();
-            return false;
+        case HashString("closeHandles"): {
+            if (!strcmp(actual_result.name().c_str(), "closeHandles")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
         }
-        for (int i = 0; i <expected_result.return_type_hidl(0).vector_value_size(); i++) {
-            LOG(ERROR) << "TYPE_HANDLE is not supported yet. ";
+        case HashString("repeatWithFmq"): {
+            if (!strcmp(actual_result.name().c_str(), "repeatWithFmq")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (!Verify__android__hardware__tests__foo__V1_0__IFoo__WithFmq(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("thisIsNew"): {
+            if (!strcmp(actual_result.name().c_str(), "thisIsNew")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("expectNullHandle"): {
+            if (!strcmp(actual_result.name().c_str(), "expectNullHandle")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                if (actual_result.return_type_hidl(1).scalar_value().bool_t() != expected_result.return_type_hidl(1).scalar_value().bool_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("takeAMask"): {
+            if (!strcmp(actual_result.name().c_str(), "takeAMask")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__tests__foo__V1_0__IFoo__BitField(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                if (actual_result.return_type_hidl(1).scalar_value().uint8_t() != expected_result.return_type_hidl(1).scalar_value().uint8_t()) { return false; }
+                if (actual_result.return_type_hidl(2).scalar_value().uint8_t() != expected_result.return_type_hidl(2).scalar_value().uint8_t()) { return false; }
+                if (actual_result.return_type_hidl(3).scalar_value().uint8_t() != expected_result.return_type_hidl(3).scalar_value().uint8_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("haveAInterface"): {
+            if (!strcmp(actual_result.name().c_str(), "haveAInterface")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                LOG(ERROR) << "TYPE_HIDL_INTERFACE is not supported yet. ";
+                return true;
+            }
+            break;
         }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "closeHandles")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "repeatWithFmq")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (!Verify__android__hardware__tests__foo__V1_0__IFoo__WithFmq(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "thisIsNew")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "expectNullHandle")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        if (actual_result.return_type_hidl(1).scalar_value().bool_t() != expected_result.return_type_hidl(1).scalar_value().bool_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "takeAMask")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__tests__foo__V1_0__IFoo__BitField(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        if (actual_result.return_type_hidl(1).scalar_value().uint8_t() != expected_result.return_type_hidl(1).scalar_value().uint8_t()) { return false; }
-        if (actual_result.return_type_hidl(2).scalar_value().uint8_t() != expected_result.return_type_hidl(2).scalar_value().uint8_t()) { return false; }
-        if (actual_result.return_type_hidl(3).scalar_value().uint8_t() != expected_result.return_type_hidl(3).scalar_value().uint8_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "haveAInterface")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        LOG(ERROR) << "TYPE_HIDL_INTERFACE is not supported yet. ";
-        return true;
     }
     return false;
 }
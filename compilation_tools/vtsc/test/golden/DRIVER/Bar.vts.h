@@ -17,6 +17,7 @@
 
 #include <android/hardware/tests/bar/1.0/IBar.h>
 #include <hidl/HidlSupport.h>
+#include <utils/VerificationUtil.h>
 #include <android/hardware/tests/foo/1.0/IFoo.h>
 #include <android/hardware/tests/foo/1.0/Foo.vts.h>
 #include <android/hardware/tests/foo/1.0/IFooCallback.h>
@@ -37,7 +38,11 @@ namespace android {
 namespace vts {
 extern "C" void MessageTo__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(const VariableSpecificationMessage& var_msg, ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated* arg, const string& callback_socket_name);
 bool Verify__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(const VariableSpecificationMessage& expected_result, const VariableSpecificationMessage& actual_result);
-extern "C" void SetResult__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(VariableSpecificationMessage* result_msg, ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated result_value);
+extern "C" void SetResult__android__hardware__tests__bar__V1_0__IBar__SomethingRelated(VariableSpecificationMessage* result_msg, const ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated& result_value);
+template <>
+struct VtsValueVerifier<::android::hardware::tests::bar::V1_0::IBar::SomethingRelated> {
+    static bool Verify(const VariableSpecificationMessage& expected_result, const ::android::hardware::tests::bar::V1_0::IBar::SomethingRelated& actual_value);
+};
 
 class Vts_android_hardware_tests_bar_V1_0_IBar : public ::android::hardware::tests::bar::V1_0::IBar, public DriverCallbackBase {
  public:
@@ -172,6 +177,9 @@ class FuzzerExtended_android_hardware_tests_bar_V1_0_IBar : public DriverBase {
     bool GetAttribute(FunctionSpecificationMessage* func_msg, void** result);
     bool GetService(bool get_stub, const char* service_name);
 
+    bool CallFunctionAndVerify(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, const FunctionSpecificationMessage& expected_result, bool* verified) override;
+    bool CallFunctionInternal(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, FunctionSpecificationMessage* result_msg, const FunctionSpecificationMessage* expected_result, bool* verified);
+
  private:
     sp<::android::hardware::tests::bar::V1_0::IBar> hw_binder_proxy_;
 };
@@ -17,6 +17,7 @@
 
 #include <android/hardware/tests/memory/1.0/IMemoryTest.h>
 #include <hidl/HidlSupport.h>
+#include <utils/VerificationUtil.h>
 #include <android/hidl/base/1.0/types.h>
 #include <android/hidl/memory/block/1.0/types.h>
 #include <android/hidl/memory/block/1.0/types.vts.h>
@@ -73,6 +74,9 @@ class FuzzerExtended_android_hardware_tests_memory_V1_0_IMemoryTest : public Dri
     bool GetAttribute(FunctionSpecificationMessage* func_msg, void** result);
     bool GetService(bool get_stub, const char* service_name);
 
+    bool CallFunctionAndVerify(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, const FunctionSpecificationMessage& expected_result, bool* verified) override;
+    bool CallFunctionInternal(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, FunctionSpecificationMessage* result_msg, const FunctionSpecificationMessage* expected_result, bool* verified);
+
  private:
     sp<::android::hardware::tests::memory::V1_0::IMemoryTest> hw_binder_proxy_;
 };
@@ -2,30 +2,30 @@
 #include "vts_measurement.h"
 #include <android-base/logging.h>
 #include <android/hidl/allocator/1.0/IAllocator.h>
+#include <driver_base/HidlServiceCache.h>
 #include <fcntl.h>
 #include <fmq/MessageQueue.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <utils/InterfaceSpecUtil.h>
+#include <utils/StringUtil.h>
+#include <utils/TypeConversionUtil.h>
 
 
 using namespace android::hardware::nfc::V1_0;
 namespace android {
 namespace vts {
 bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::GetService(bool get_stub, const char* service_name) {
-    static bool initialized = false;
-    if (!initialized) {
-        LOG(INFO) << "HIDL getService";
-        if (service_name) {
-          LOG(INFO) << "  - service name: " << service_name;
-        }
-        hw_binder_proxy_ = ::android::hardware::nfc::V1_0::INfc::getService(service_name, get_stub);
-        if (hw_binder_proxy_ == nullptr) {
-            LOG(ERROR) << "getService() returned a null pointer.";
-            return false;
-        }
-        LOG(DEBUG) << "hw_binder_proxy_ = " << hw_binder_proxy_.get();
-        initialized = true;
+    LOG(INFO) << "HIDL getService";
+    if (service_name) {
+      LOG(INFO) << "  - service name: " << service_name;
+    }
+    hw_binder_proxy_ = GetCachedHidlService<::android::hardware::nfc::V1_0::INfc>(service_name, get_stub);
+    if (hw_binder_proxy_ == nullptr) {
+        LOG(ERROR) << "getService() returned a null pointer.";
+        return false;
     }
+    LOG(DEBUG) << "hw_binder_proxy_ = " << hw_binder_proxy_.get();
     return true;
 }
 
@@ -52,12 +52,8 @@ bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::GetService(bool get_stub, co
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
-    for (int i = 0; i < (int)arg0.size(); i++) {
-        auto *var_msg0_vector_i = var_msg0->add_vector_value();
-        var_msg0_vector_i->set_type(TYPE_SCALAR);
-        var_msg0_vector_i->set_scalar_type("uint8_t");
-        var_msg0_vector_i->mutable_scalar_value()->set_uint8_t(arg0[i]);
-    }
+    var_msg0->set_scalar_type("uint8_t");
+    var_msg0->set_vector_raw_value(arg0.data(), arg0.size() * sizeof(uint8_t));
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<uint32_t>(0);
 }
@@ -71,12 +67,8 @@ bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::GetService(bool get_stub, co
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
     var_msg0->set_type(TYPE_VECTOR);
     var_msg0->set_vector_size(arg0.size());
-    for (int i = 0; i < (int)arg0.size(); i++) {
-        auto *var_msg0_vector_i = var_msg0->add_vector_value();
-        var_msg0_vector_i->set_type(TYPE_SCALAR);
-        var_msg0_vector_i->set_scalar_type("uint8_t");
-        var_msg0_vector_i->mutable_scalar_value()->set_uint8_t(arg0[i]);
-    }
+    var_msg0->set_scalar_type("uint8_t");
+    var_msg0->set_vector_raw_value(arg0.data(), arg0.size() * sizeof(uint8_t));
     RpcCallToAgent(callback_message, callback_socket_name_);
     return ::android::hardware::nfc::V1_0::NfcStatus();
 }
@@ -140,135 +132,258 @@ bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::GetAttribute(
 }
 bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::CallFunction(
     const FunctionSpecificationMessage& func_msg,
-    const string& callback_socket_name __attribute__((__unused__)),
+    const string& callback_socket_name,
     FunctionSpecificationMessage* result_msg) {
+    return CallFunctionInternal(func_msg, callback_socket_name, result_msg, nullptr, nullptr);
+}
+
+bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::CallFunctionAndVerify(
+    const FunctionSpecificationMessage& func_msg,
+    const string& callback_socket_name,
+    const FunctionSpecificationMessage& expected_result,
+    bool* verified) {
+    FunctionSpecificationMessage result_msg;
+    *verified = false;
+    return CallFunctionInternal(func_msg, callback_socket_name, &result_msg, &expected_result, verified);
+}
+
+bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::CallFunctionInternal(
+    const FunctionSpecificationMessage& func_msg,
+    const string& callback_socket_name __attribute__((__unused__)),
+    FunctionSpecificationMessage* result_msg,
+    const FunctionSpecificationMessage* expected_result,
+    bool* verified) {
     const char* func_name = func_msg.name().c_str();
     if (hw_binder_proxy_ == nullptr) {
         LOG(ERROR) << "hw_binder_proxy_ is null. ";
         return false;
     }
-    if (!strcmp(func_name, "open")) {
-        sp<::android::hardware::nfc::V1_0::INfcClientCallback> arg0;
-        arg0 = VtsFuzzerCreateVts_android_hardware_nfc_V1_0_INfcClientCallback(callback_socket_name);
-        static_cast<Vts_android_hardware_nfc_V1_0_INfcClientCallback*>(arg0.get())->Register(func_msg.arg(0));
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->open(arg0);
-        result_msg->set_name("open");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "write")) {
-        ::android::hardware::hidl_vec<uint8_t> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().uint8_t();
+    switch (HashString(func_name)) {
+        case HashString("open"): {
+            if (!strcmp(func_name, "open")) {
+                sp<::android::hardware::nfc::V1_0::INfcClientCallback> arg0;
+                arg0 = VtsFuzzerCreateVts_android_hardware_nfc_V1_0_INfcClientCallback(callback_socket_name);
+                static_cast<Vts_android_hardware_nfc_V1_0_INfcClientCallback*>(arg0.get())->Register(func_msg.arg(0));
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->open(arg0);
+                result_msg->set_name("open");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
         }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        uint32_t result0 = hw_binder_proxy_->write(arg0);
-        result_msg->set_name("write");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("uint32_t");
-        result_val_0->mutable_scalar_value()->set_uint32_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "coreInitialized")) {
-        ::android::hardware::hidl_vec<uint8_t> arg0;
-        arg0.resize(func_msg.arg(0).vector_value_size());
-        for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
-            arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().uint8_t();
+        case HashString("write"): {
+            if (!strcmp(func_name, "write")) {
+                ::android::hardware::hidl_vec<uint8_t> arg0;
+                if (func_msg.arg(0).has_vector_memory_region()) {
+                    size_t arg0_count;
+                    uint8_t* arg0_elements = GetMemoryRegionElements<uint8_t>(func_msg.arg(0).vector_memory_region(), &arg0_count);
+                    if (arg0_elements != nullptr) {
+                        arg0.setToExternal(arg0_elements, arg0_count);
+                    } else {
+                        LOG(ERROR) << "memory region is not an array of uint8_t.";
+                    }
+                } else if (func_msg.arg(0).has_vector_raw_value()) {
+                    arg0.resize(func_msg.arg(0).vector_raw_value().size() / sizeof(uint8_t));
+                    memcpy(arg0.data(), func_msg.arg(0).vector_raw_value().data(), arg0.size() * sizeof(uint8_t));
+                } else {
+                    arg0.resize(func_msg.arg(0).vector_value_size());
+                    for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                        arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().uint8_t();
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                uint32_t result0 = hw_binder_proxy_->write(arg0);
+                result_msg->set_name("write");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<uint32_t>(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("coreInitialized"): {
+            if (!strcmp(func_name, "coreInitialized")) {
+                ::android::hardware::hidl_vec<uint8_t> arg0;
+                if (func_msg.arg(0).has_vector_memory_region()) {
+                    size_t arg0_count;
+                    uint8_t* arg0_elements = GetMemoryRegionElements<uint8_t>(func_msg.arg(0).vector_memory_region(), &arg0_count);
+                    if (arg0_elements != nullptr) {
+                        arg0.setToExternal(arg0_elements, arg0_count);
+                    } else {
+                        LOG(ERROR) << "memory region is not an array of uint8_t.";
+                    }
+                } else if (func_msg.arg(0).has_vector_raw_value()) {
+                    arg0.resize(func_msg.arg(0).vector_raw_value().size() / sizeof(uint8_t));
+                    memcpy(arg0.data(), func_msg.arg(0).vector_raw_value().data(), arg0.size() * sizeof(uint8_t));
+                } else {
+                    arg0.resize(func_msg.arg(0).vector_value_size());
+                    for (int arg0_index = 0; arg0_index < func_msg.arg(0).vector_value_size(); arg0_index++) {
+                        arg0[arg0_index] = func_msg.arg(0).vector_value(arg0_index).scalar_value().uint8_t();
+                    }
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->coreInitialized(arg0);
+                result_msg->set_name("coreInitialized");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("prediscover"): {
+            if (!strcmp(func_name, "prediscover")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->prediscover();
+                result_msg->set_name("prediscover");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("close"): {
+            if (!strcmp(func_name, "close")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->close();
+                result_msg->set_name("close");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("controlGranted"): {
+            if (!strcmp(func_name, "controlGranted")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->controlGranted();
+                result_msg->set_name("controlGranted");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("powerCycle"): {
+            if (!strcmp(func_name, "powerCycle")) {
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->powerCycle();
+                result_msg->set_name("powerCycle");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    result_val_0->set_type(TYPE_ENUM);
+                    SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("notifySyspropsChanged"): {
+            if (!strcmp(func_name, "notifySyspropsChanged")) {
+                LOG(INFO) << "Call notifySyspropsChanged";
+                hw_binder_proxy_->notifySyspropsChanged();
+                result_msg->set_name("notifySyspropsChanged");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
         }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->coreInitialized(arg0);
-        result_msg->set_name("coreInitialized");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "prediscover")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->prediscover();
-        result_msg->set_name("prediscover");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "close")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->close();
-        result_msg->set_name("close");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "controlGranted")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->controlGranted();
-        result_msg->set_name("controlGranted");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "powerCycle")) {
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        ::android::hardware::nfc::V1_0::NfcStatus result0 = hw_binder_proxy_->powerCycle();
-        result_msg->set_name("powerCycle");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_ENUM);
-        SetResult__android__hardware__nfc__V1_0__NfcStatus(result_val_0, result0);
-        return true;
-    }
-    if (!strcmp(func_name, "notifySyspropsChanged")) {
-        LOG(INFO) << "Call notifySyspropsChanged";
-        hw_binder_proxy_->notifySyspropsChanged();
-        result_msg->set_name("notifySyspropsChanged");
-        return true;
     }
     return false;
 }
 
 bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::VerifyResults(const FunctionSpecificationMessage& expected_result __attribute__((__unused__)),
     const FunctionSpecificationMessage& actual_result __attribute__((__unused__))) {
-    if (!strcmp(actual_result.name().c_str(), "open")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "write")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().uint32_t() != expected_result.return_type_hidl(0).scalar_value().uint32_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "coreInitialized")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "prediscover")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "close")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "controlGranted")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "powerCycle")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
-        return true;
+    switch (HashString(actual_result.name().c_str())) {
+        case HashString("open"): {
+            if (!strcmp(actual_result.name().c_str(), "open")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("write"): {
+            if (!strcmp(actual_result.name().c_str(), "write")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().uint32_t() != expected_result.return_type_hidl(0).scalar_value().uint32_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("coreInitialized"): {
+            if (!strcmp(actual_result.name().c_str(), "coreInitialized")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("prediscover"): {
+            if (!strcmp(actual_result.name().c_str(), "prediscover")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("close"): {
+            if (!strcmp(actual_result.name().c_str(), "close")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("controlGranted"): {
+            if (!strcmp(actual_result.name().c_str(), "controlGranted")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("powerCycle"): {
+            if (!strcmp(actual_result.name().c_str(), "powerCycle")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if(!Verify__android__hardware__nfc__V1_0__NfcStatus(expected_result.return_type_hidl(0), actual_result.return_type_hidl(0))) { return false; }
+                return true;
+            }
+            break;
+        }
     }
     return false;
 }
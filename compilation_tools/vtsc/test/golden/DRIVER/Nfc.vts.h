@@ -17,6 +17,7 @@
 
 #include <android/hardware/nfc/1.0/INfc.h>
 #include <hidl/HidlSupport.h>
+#include <utils/VerificationUtil.h>
 #include <android/hardware/nfc/1.0/INfcClientCallback.h>
 #include <android/hardware/nfc/1.0/NfcClientCallback.vts.h>
 #include <android/hardware/nfc/1.0/types.h>
@@ -78,6 +79,9 @@ class FuzzerExtended_android_hardware_nfc_V1_0_INfc : public DriverBase {
     bool GetAttribute(FunctionSpecificationMessage* func_msg, void** result);
     bool GetService(bool get_stub, const char* service_name);
 
+    bool CallFunctionAndVerify(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, const FunctionSpecificationMessage& expected_result, bool* verified) override;
+    bool CallFunctionInternal(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, FunctionSpecificationMessage* result_msg, const FunctionSpecificationMessage* expected_result, bool* verified);
+
  private:
     sp<::android::hardware::nfc::V1_0::INfc> hw_binder_proxy_;
 };
@@ -17,6 +17,7 @@
 
 #include <android/hardware/nfc/1.0/INfcClientCallback.h>
 #include <hidl/HidlSupport.h>
+#include <utils/VerificationUtil.h>
 #include <android/hardware/nfc/1.0/types.h>
 #include <android/hardware/nfc/1.0/types.vts.h>
 #include <android/hidl/base/1.0/types.h>
@@ -62,6 +63,9 @@ class FuzzerExtended_android_hardware_nfc_V1_0_INfcClientCallback : public Drive
     bool GetAttribute(FunctionSpecificationMessage* func_msg, void** result);
     bool GetService(bool get_stub, const char* service_name);
 
+    bool CallFunctionAndVerify(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, const FunctionSpecificationMessage& expected_result, bool* verified) override;
+    bool CallFunctionInternal(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, FunctionSpecificationMessage* result_msg, const FunctionSpecificationMessage* expected_result, bool* verified);
+
  private:
     sp<::android::hardware::nfc::V1_0::INfcClientCallback> hw_binder_proxy_;
 };
@@ -2,10 +2,14 @@
 #include "vts_measurement.h"
 #include <android-base/logging.h>
 #include <android/hidl/allocator/1.0/IAllocator.h>
+#include <driver_base/HidlServiceCache.h>
 #include <fcntl.h>
 #include <fmq/MessageQueue.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <utils/InterfaceSpecUtil.h>
+#include <utils/StringUtil.h>
+#include <utils/TypeConversionUtil.h>
 
 
 using namespace android::hardware::tests::msgq::V1_0;
@@ -15,37 +19,43 @@ extern "C" void MessageTo__android__hardware__tests__msgq__V1_0__ITestMsgQ__Even
     *arg = (::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits)var_msg.scalar_value().uint32_t();
 }
 uint32_t Random__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits() {
-    uint32_t choice = (uint32_t) rand() / 2;
-    if (choice == (uint32_t) 1UL) return static_cast<uint32_t>(::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits::FMQ_NOT_EMPTY);
-    if (choice == (uint32_t) 2UL) return static_cast<uint32_t>(::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits::FMQ_NOT_FULL);
-    return static_cast<uint32_t>(::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits::FMQ_NOT_EMPTY);
+    static const uint32_t kValues[] = {
+        static_cast<uint32_t>(::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits::FMQ_NOT_EMPTY),
+        static_cast<uint32_t>(::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits::FMQ_NOT_FULL),
+    };
+    return kValues[RandomIndex(sizeof(kValues) / sizeof(kValues[0]))];
 }
 bool Verify__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(const VariableSpecificationMessage& expected_result __attribute__((__unused__)), const VariableSpecificationMessage& actual_result __attribute__((__unused__))){
     if (actual_result.scalar_value().uint32_t() != expected_result.scalar_value().uint32_t()) { return false; }
     return true;
 }
 
-extern "C" void SetResult__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(VariableSpecificationMessage* result_msg, ::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits result_value __attribute__((__unused__))){
+extern "C" void SetResult__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(VariableSpecificationMessage* result_msg, const ::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits& result_value __attribute__((__unused__))){
     result_msg->set_type(TYPE_ENUM);
     result_msg->set_scalar_type("uint32_t");
     result_msg->mutable_scalar_value()->set_uint32_t(static_cast<uint32_t>(result_value));
 }
 
+static const VtsTypeConversionEntry kTypeConversions[] = {
+    MakeTypeConversionEntry<::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits>("::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits", &MessageTo__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits, &SetResult__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits, true),
+};
+
+extern "C" const VtsTypeConversionEntry* VtsTypeConversions__android__hardware__tests__msgq__V1_0__ITestMsgQ(size_t* size) {
+    *size = sizeof(kTypeConversions) / sizeof(kTypeConversions[0]);
+    return kTypeConversions;
+}
+
 bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool get_stub, const char* service_name) {
-    static bool initialized = false;
-    if (!initialized) {
-        LOG(INFO) << "HIDL getService";
-        if (service_name) {
-          LOG(INFO) << "  - service name: " << service_name;
-        }
-        hw_binder_proxy_ = ::android::hardware::tests::msgq::V1_0::ITestMsgQ::getService(service_name, get_stub);
-        if (hw_binder_proxy_ == nullptr) {
-            LOG(ERROR) << "getService() returned a null pointer.";
-            return false;
-        }
-        LOG(DEBUG) << "hw_binder_proxy_ = " << hw_binder_proxy_.get();
-        initialized = true;
+    LOG(INFO) << "HIDL getService";
+    if (service_name) {
+      LOG(INFO) << "  - service name: " << service_name;
     }
+    hw_binder_proxy_ = GetCachedHidlService<::android::hardware::tests::msgq::V1_0::ITestMsgQ>(service_name, get_stub);
+    if (hw_binder_proxy_ == nullptr) {
+        LOG(ERROR) << "getService() returned a null pointer.";
+        return false;
+    }
+    LOG(DEBUG) << "hw_binder_proxy_ = " << hw_binder_proxy_.get();
     return true;
 }
 
@@ -74,13 +84,9 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("getFmqUnsyncWrite"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::getFmqUnsyncWrite");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("bool_t");
-    var_msg0->mutable_scalar_value()->set_bool_t(arg0);
+    SetScalarResult<bool>(var_msg0, arg0);
     VariableSpecificationMessage* var_msg1 = callback_message.add_arg();
-    var_msg1->set_type(TYPE_SCALAR);
-    var_msg1->set_scalar_type("bool_t");
-    var_msg1->mutable_scalar_value()->set_bool_t(arg1);
+    SetScalarResult<bool>(var_msg1, arg1);
     RpcCallToAgent(callback_message, callback_socket_name_);
     cb(static_cast<bool>(0), ::android::hardware::MQDescriptorUnsync<int32_t>());
     return ::android::hardware::Void();
@@ -93,9 +99,7 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestWriteFmqSync"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestWriteFmqSync");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<bool>(0);
 }
@@ -107,9 +111,7 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestReadFmqSync"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestReadFmqSync");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<bool>(0);
 }
@@ -121,9 +123,7 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestWriteFmqUnsync"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestWriteFmqUnsync");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<bool>(0);
 }
@@ -135,9 +135,7 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestReadFmqUnsync"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestReadFmqUnsync");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return static_cast<bool>(0);
 }
@@ -149,9 +147,7 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestBlockingRead"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestBlockingRead");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return ::android::hardware::Void();
 }
@@ -163,9 +159,7 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestBlockingReadDefaultEventFlagBits"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestBlockingReadDefaultEventFlagBits");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return ::android::hardware::Void();
 }
@@ -178,13 +172,9 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetService(bool
     callback_message.set_id(GetCallbackID("requestBlockingReadRepeat"));
     callback_message.set_name("Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ::requestBlockingReadRepeat");
     VariableSpecificationMessage* var_msg0 = callback_message.add_arg();
-    var_msg0->set_type(TYPE_SCALAR);
-    var_msg0->set_scalar_type("int32_t");
-    var_msg0->mutable_scalar_value()->set_int32_t(arg0);
+    SetScalarResult<int32_t>(var_msg0, arg0);
     VariableSpecificationMessage* var_msg1 = callback_message.add_arg();
-    var_msg1->set_type(TYPE_SCALAR);
-    var_msg1->set_scalar_type("int32_t");
-    var_msg1->mutable_scalar_value()->set_int32_t(arg1);
+    SetScalarResult<int32_t>(var_msg1, arg1);
     RpcCallToAgent(callback_message, callback_socket_name_);
     return ::android::hardware::Void();
 }
@@ -208,184 +198,288 @@ bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::GetAttribute(
 }
 bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::CallFunction(
     const FunctionSpecificationMessage& func_msg,
-    const string& callback_socket_name __attribute__((__unused__)),
+    const string& callback_socket_name,
     FunctionSpecificationMessage* result_msg) {
+    return CallFunctionInternal(func_msg, callback_socket_name, result_msg, nullptr, nullptr);
+}
+
+bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::CallFunctionAndVerify(
+    const FunctionSpecificationMessage& func_msg,
+    const string& callback_socket_name,
+    const FunctionSpecificationMessage& expected_result,
+    bool* verified) {
+    FunctionSpecificationMessage result_msg;
+    *verified = false;
+    return CallFunctionInternal(func_msg, callback_socket_name, &result_msg, &expected_result, verified);
+}
+
+bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::CallFunctionInternal(
+    const FunctionSpecificationMessage& func_msg,
+    const string& callback_socket_name __attribute__((__unused__)),
+    FunctionSpecificationMessage* result_msg,
+    const FunctionSpecificationMessage* expected_result,
+    bool* verified) {
     const char* func_name = func_msg.name().c_str();
     if (hw_binder_proxy_ == nullptr) {
         LOG(ERROR) << "hw_binder_proxy_ is null. ";
         return false;
     }
-    if (!strcmp(func_name, "configureFmqSyncReadWrite")) {
-        const ::android::hardware::MQDescriptorSync<int32_t>* arg0;
-        if (func_msg.arg(0).fmq_value_size() > 0 && func_msg.arg(0).fmq_value(0).has_fmq_desc_address()) {
-            arg0 = reinterpret_cast<::android::hardware::MQDescriptorSync<int32_t>*>(func_msg.arg(0).fmq_value(0).fmq_desc_address());
-        } else {
-            ::android::hardware::MessageQueue<int32_t, ::android::hardware::kSynchronizedReadWrite> arg0_sync_q(1024);
-            for (int i = 0; i < (int)func_msg.arg(0).fmq_value_size(); i++) {
-                int32_t arg0_sync_q_item;
-                arg0_sync_q_item = func_msg.arg(0).fmq_value(i).scalar_value().int32_t();
-                arg0_sync_q.write(&arg0_sync_q_item);
+    switch (HashString(func_name)) {
+        case HashString("configureFmqSyncReadWrite"): {
+            if (!strcmp(func_name, "configureFmqSyncReadWrite")) {
+                const ::android::hardware::MQDescriptorSync<int32_t>* arg0;
+                if (func_msg.arg(0).fmq_value_size() > 0 && func_msg.arg(0).fmq_value(0).has_fmq_desc_address()) {
+                    arg0 = reinterpret_cast<::android::hardware::MQDescriptorSync<int32_t>*>(func_msg.arg(0).fmq_value(0).fmq_desc_address());
+                } else {
+                    ::android::hardware::MessageQueue<int32_t, ::android::hardware::kSynchronizedReadWrite> arg0_sync_q(1024);
+                    for (int i = 0; i < (int)func_msg.arg(0).fmq_value_size(); i++) {
+                        int32_t arg0_sync_q_item;
+                        arg0_sync_q_item = func_msg.arg(0).fmq_value(i).scalar_value().int32_t();
+                        arg0_sync_q.write(&arg0_sync_q_item);
+                    }
+                    arg0 = arg0_sync_q.getDesc();
+                }
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                bool result0 = hw_binder_proxy_->configureFmqSyncReadWrite(*arg0);
+                result_msg->set_name("configureFmqSyncReadWrite");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<bool>(result_val_0, result0);
+                }
+                return true;
             }
-            arg0 = arg0_sync_q.getDesc();
+            break;
+        }
+        case HashString("getFmqUnsyncWrite"): {
+            if (!strcmp(func_name, "getFmqUnsyncWrite")) {
+                bool arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().bool_t();
+                bool arg1 = 0;
+                arg1 = func_msg.arg(1).scalar_value().bool_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->getFmqUnsyncWrite(arg0, arg1, [&](bool arg0 __attribute__((__unused__)),const ::android::hardware::MQDescriptorUnsync<int32_t>& arg1 __attribute__((__unused__))){
+                    LOG(INFO) << "callback getFmqUnsyncWrite called";
+                    result_msg->set_name("getFmqUnsyncWrite");
+                    if (expected_result != nullptr) {
+                        *verified = expected_result->return_type_hidl_size() == 2 && VerifyValue(expected_result->return_type_hidl(0), arg0) && VerifyValue(expected_result->return_type_hidl(1), arg1);
+                    } else {
+                        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                        SetScalarResult<bool>(result_val_0, arg0);
+                        VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
+                        result_val_1->set_type(TYPE_FMQ_UNSYNC);
+                        VariableSpecificationMessage* result_val_1_item = result_val_1->add_fmq_value();
+                        result_val_1_item->set_type(TYPE_SCALAR);
+                        result_val_1_item->set_scalar_type("int32_t");
+                        result_val_1_item->set_fmq_desc_address(reinterpret_cast<size_t>(new (std::nothrow) ::android::hardware::MQDescriptorUnsync<int32_t>(arg1)));
+                    }
+                });
+                return true;
+            }
+            break;
+        }
+        case HashString("requestWriteFmqSync"): {
+            if (!strcmp(func_name, "requestWriteFmqSync")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                bool result0 = hw_binder_proxy_->requestWriteFmqSync(arg0);
+                result_msg->set_name("requestWriteFmqSync");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<bool>(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestReadFmqSync"): {
+            if (!strcmp(func_name, "requestReadFmqSync")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                bool result0 = hw_binder_proxy_->requestReadFmqSync(arg0);
+                result_msg->set_name("requestReadFmqSync");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<bool>(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestWriteFmqUnsync"): {
+            if (!strcmp(func_name, "requestWriteFmqUnsync")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                bool result0 = hw_binder_proxy_->requestWriteFmqUnsync(arg0);
+                result_msg->set_name("requestWriteFmqUnsync");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<bool>(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestReadFmqUnsync"): {
+            if (!strcmp(func_name, "requestReadFmqUnsync")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                bool result0 = hw_binder_proxy_->requestReadFmqUnsync(arg0);
+                result_msg->set_name("requestReadFmqUnsync");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 1 && VerifyValue(expected_result->return_type_hidl(0), result0);
+                } else {
+                    VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
+                    SetScalarResult<bool>(result_val_0, result0);
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestBlockingRead"): {
+            if (!strcmp(func_name, "requestBlockingRead")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->requestBlockingRead(arg0);
+                result_msg->set_name("requestBlockingRead");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestBlockingReadDefaultEventFlagBits"): {
+            if (!strcmp(func_name, "requestBlockingReadDefaultEventFlagBits")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->requestBlockingReadDefaultEventFlagBits(arg0);
+                result_msg->set_name("requestBlockingReadDefaultEventFlagBits");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestBlockingReadRepeat"): {
+            if (!strcmp(func_name, "requestBlockingReadRepeat")) {
+                int32_t arg0 = 0;
+                arg0 = func_msg.arg(0).scalar_value().int32_t();
+                int32_t arg1 = 0;
+                arg1 = func_msg.arg(1).scalar_value().int32_t();
+                LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
+                hw_binder_proxy_->requestBlockingReadRepeat(arg0, arg1);
+                result_msg->set_name("requestBlockingReadRepeat");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
+        }
+        case HashString("notifySyspropsChanged"): {
+            if (!strcmp(func_name, "notifySyspropsChanged")) {
+                LOG(INFO) << "Call notifySyspropsChanged";
+                hw_binder_proxy_->notifySyspropsChanged();
+                result_msg->set_name("notifySyspropsChanged");
+                if (expected_result != nullptr) {
+                    *verified = expected_result->return_type_hidl_size() == 0;
+                }
+                return true;
+            }
+            break;
         }
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        bool result0 = hw_binder_proxy_->configureFmqSyncReadWrite(*arg0);
-        result_msg->set_name("configureFmqSyncReadWrite");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("bool_t");
-        result_val_0->mutable_scalar_value()->set_bool_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "getFmqUnsyncWrite")) {
-        bool arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().bool_t();
-        bool arg1 = 0;
-        arg1 = func_msg.arg(1).scalar_value().bool_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->getFmqUnsyncWrite(arg0, arg1, [&](bool arg0 __attribute__((__unused__)),const ::android::hardware::MQDescriptorUnsync<int32_t>& arg1 __attribute__((__unused__))){
-            LOG(INFO) << "callback getFmqUnsyncWrite called";
-            result_msg->set_name("getFmqUnsyncWrite");
-            VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-            result_val_0->set_type(TYPE_SCALAR);
-            result_val_0->set_scalar_type("bool_t");
-            result_val_0->mutable_scalar_value()->set_bool_t(arg0);
-            VariableSpecificationMessage* result_val_1 = result_msg->add_return_type_hidl();
-            result_val_1->set_type(TYPE_FMQ_UNSYNC);
-            VariableSpecificationMessage* result_val_1_item = result_val_1->add_fmq_value();
-            result_val_1_item->set_type(TYPE_SCALAR);
-            result_val_1_item->set_scalar_type("int32_t");
-            result_val_1_item->set_fmq_desc_address(reinterpret_cast<size_t>(new (std::nothrow) ::android::hardware::MQDescriptorUnsync<int32_t>(arg1)));
-        });
-        return true;
-    }
-    if (!strcmp(func_name, "requestWriteFmqSync")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        bool result0 = hw_binder_proxy_->requestWriteFmqSync(arg0);
-        result_msg->set_name("requestWriteFmqSync");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("bool_t");
-        result_val_0->mutable_scalar_value()->set_bool_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "requestReadFmqSync")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        bool result0 = hw_binder_proxy_->requestReadFmqSync(arg0);
-        result_msg->set_name("requestReadFmqSync");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("bool_t");
-        result_val_0->mutable_scalar_value()->set_bool_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "requestWriteFmqUnsync")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        bool result0 = hw_binder_proxy_->requestWriteFmqUnsync(arg0);
-        result_msg->set_name("requestWriteFmqUnsync");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("bool_t");
-        result_val_0->mutable_scalar_value()->set_bool_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "requestReadFmqUnsync")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        bool result0 = hw_binder_proxy_->requestReadFmqUnsync(arg0);
-        result_msg->set_name("requestReadFmqUnsync");
-        VariableSpecificationMessage* result_val_0 = result_msg->add_return_type_hidl();
-        result_val_0->set_type(TYPE_SCALAR);
-        result_val_0->set_scalar_type("bool_t");
-        result_val_0->mutable_scalar_value()->set_bool_t(result0);
-        return true;
-    }
-    if (!strcmp(func_name, "requestBlockingRead")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->requestBlockingRead(arg0);
-        result_msg->set_name("requestBlockingRead");
-        return true;
-    }
-    if (!strcmp(func_name, "requestBlockingReadDefaultEventFlagBits")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->requestBlockingReadDefaultEventFlagBits(arg0);
-        result_msg->set_name("requestBlockingReadDefaultEventFlagBits");
-        return true;
-    }
-    if (!strcmp(func_name, "requestBlockingReadRepeat")) {
-        int32_t arg0 = 0;
-        arg0 = func_msg.arg(0).scalar_value().int32_t();
-        int32_t arg1 = 0;
-        arg1 = func_msg.arg(1).scalar_value().int32_t();
-        LOG(DEBUG) << "local_device = " << hw_binder_proxy_.get();
-        hw_binder_proxy_->requestBlockingReadRepeat(arg0, arg1);
-        result_msg->set_name("requestBlockingReadRepeat");
-        return true;
-    }
-    if (!strcmp(func_name, "notifySyspropsChanged")) {
-        LOG(INFO) << "Call notifySyspropsChanged";
-        hw_binder_proxy_->notifySyspropsChanged();
-        result_msg->set_name("notifySyspropsChanged");
-        return true;
     }
     return false;
 }
 
 bool FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ::VerifyResults(const FunctionSpecificationMessage& expected_result __attribute__((__unused__)),
     const FunctionSpecificationMessage& actual_result __attribute__((__unused__))) {
-    if (!strcmp(actual_result.name().c_str(), "configureFmqSyncReadWrite")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "getFmqUnsyncWrite")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        LOG(ERROR) << "TYPE_FMQ_UNSYNC is not supported yet. ";
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestWriteFmqSync")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestReadFmqSync")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestWriteFmqUnsync")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestReadFmqUnsync")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestBlockingRead")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestBlockingReadDefaultEventFlagBits")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
-    }
-    if (!strcmp(actual_result.name().c_str(), "requestBlockingReadRepeat")) {
-        if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
-        return true;
+    switch (HashString(actual_result.name().c_str())) {
+        case HashString("configureFmqSyncReadWrite"): {
+            if (!strcmp(actual_result.name().c_str(), "configureFmqSyncReadWrite")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("getFmqUnsyncWrite"): {
+            if (!strcmp(actual_result.name().c_str(), "getFmqUnsyncWrite")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                LOG(ERROR) << "TYPE_FMQ_UNSYNC is not supported yet. ";
+                return true;
+            }
+            break;
+        }
+        case HashString("requestWriteFmqSync"): {
+            if (!strcmp(actual_result.name().c_str(), "requestWriteFmqSync")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestReadFmqSync"): {
+            if (!strcmp(actual_result.name().c_str(), "requestReadFmqSync")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestWriteFmqUnsync"): {
+            if (!strcmp(actual_result.name().c_str(), "requestWriteFmqUnsync")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestReadFmqUnsync"): {
+            if (!strcmp(actual_result.name().c_str(), "requestReadFmqUnsync")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                if (actual_result.return_type_hidl(0).scalar_value().bool_t() != expected_result.return_type_hidl(0).scalar_value().bool_t()) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestBlockingRead"): {
+            if (!strcmp(actual_result.name().c_str(), "requestBlockingRead")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestBlockingReadDefaultEventFlagBits"): {
+            if (!strcmp(actual_result.name().c_str(), "requestBlockingReadDefaultEventFlagBits")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
+        }
+        case HashString("requestBlockingReadRepeat"): {
+            if (!strcmp(actual_result.name().c_str(), "requestBlockingReadRepeat")) {
+                if (actual_result.return_type_hidl_size() != expected_result.return_type_hidl_size() ) { return false; }
+                return true;
+            }
+            break;
+        }
     }
     return false;
 }
@@ -17,6 +17,7 @@
 
 #include <android/hardware/tests/msgq/1.0/ITestMsgQ.h>
 #include <hidl/HidlSupport.h>
+#include <utils/VerificationUtil.h>
 #include <android/hidl/base/1.0/types.h>
 
 
@@ -26,7 +27,7 @@ namespace vts {
 extern "C" void MessageTo__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(const VariableSpecificationMessage& var_msg, ::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits* arg, const string& callback_socket_name);
 uint32_t Random__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits();
 bool Verify__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(const VariableSpecificationMessage& expected_result, const VariableSpecificationMessage& actual_result);
-extern "C" void SetResult__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(VariableSpecificationMessage* result_msg, ::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits result_value);
+extern "C" void SetResult__android__hardware__tests__msgq__V1_0__ITestMsgQ__EventFlagBits(VariableSpecificationMessage* result_msg, const ::android::hardware::tests::msgq::V1_0::ITestMsgQ::EventFlagBits& result_value);
 
 class Vts_android_hardware_tests_msgq_V1_0_ITestMsgQ : public ::android::hardware::tests::msgq::V1_0::ITestMsgQ, public DriverCallbackBase {
  public:
@@ -86,6 +87,9 @@ class FuzzerExtended_android_hardware_tests_msgq_V1_0_ITestMsgQ : public DriverB
     bool GetAttribute(FunctionSpecificationMessage* func_msg, void** result);
     bool GetService(bool get_stub, const char* service_name);
 
+    bool CallFunctionAndVerify(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, const FunctionSpecificationMessage& expected_result, bool* verified) override;
+    bool CallFunctionInternal(const FunctionSpecificationMessage& func_msg, const string& callback_socket_name, FunctionSpecificationMessage* result_msg, const FunctionSpecificationMessage* expected_result, bool* verified);
+
  private:
     sp<::android::hardware::tests::msgq::V1_0::ITestMsgQ> hw_binder_proxy_;
 };
@@ -191,6 +191,167 @@ bool FuzzerExtended_libc::Fuzz(
       }
     return false;
 }
+int FuzzerExtended_libc::FuzzRepeated(
+    FunctionSpecificationMessage* func_msg, int count,
+    const string& callback_socket_name, vector<void*>* results) {
+    const char* func_name = func_msg->name().c_str();
+    if (!strcmp(func_name, "socket")) {
+        typedef void* (*func_type_socket)(...);
+        func_type_socket func = (func_type_socket) target_loader_.GetLoaderFunction("socket");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                int32_t arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_int32_t()) ? func_msg->arg(1).scalar_value().int32_t() : RandomInt32();
+                int32_t arg2 = (func_msg->arg(2).type() == TYPE_SCALAR && func_msg->arg(2).scalar_value().has_int32_t()) ? func_msg->arg(2).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "accept")) {
+        typedef void* (*func_type_accept)(...);
+        func_type_accept func = (func_type_accept) target_loader_.GetLoaderFunction("accept");
+        if (func == NULL) return 0;
+            struct sockaddr* arg1 = (struct sockaddr*) malloc(sizeof(struct sockaddr));
+            socklen_t* arg2 = (socklen_t*) malloc(sizeof(socklen_t));
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "bind")) {
+        typedef void* (*func_type_bind)(...);
+        func_type_bind func = (func_type_bind) target_loader_.GetLoaderFunction("bind");
+        if (func == NULL) return 0;
+            struct sockaddr* arg1 = (struct sockaddr*) malloc(sizeof(struct sockaddr));
+            socklen_t* arg2 = (socklen_t*) malloc(sizeof(socklen_t));
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "connect")) {
+        typedef void* (*func_type_connect)(...);
+        func_type_connect func = (func_type_connect) target_loader_.GetLoaderFunction("connect");
+        if (func == NULL) return 0;
+            struct sockaddr* arg1 = (struct sockaddr*) malloc(sizeof(struct sockaddr));
+            socklen_t* arg2 = (socklen_t*) malloc(sizeof(socklen_t));
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "listen")) {
+        typedef void* (*func_type_listen)(...);
+        func_type_listen func = (func_type_listen) target_loader_.GetLoaderFunction("listen");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                int32_t arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_int32_t()) ? func_msg->arg(1).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "recv")) {
+        typedef void* (*func_type_recv)(...);
+        func_type_recv func = (func_type_recv) target_loader_.GetLoaderFunction("recv");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                void* arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_void_pointer()) ? reinterpret_cast<void*>(func_msg->arg(1).scalar_value().void_pointer()) : RandomVoidPointer();
+                uint32_t arg2 = (func_msg->arg(2).type() == TYPE_SCALAR && func_msg->arg(2).scalar_value().has_uint32_t()) ? func_msg->arg(2).scalar_value().uint32_t() : RandomUint32();
+                int32_t arg3 = (func_msg->arg(3).type() == TYPE_SCALAR && func_msg->arg(3).scalar_value().has_int32_t()) ? func_msg->arg(3).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2, arg3))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "send")) {
+        typedef void* (*func_type_send)(...);
+        func_type_send func = (func_type_send) target_loader_.GetLoaderFunction("send");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                void* arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_void_pointer()) ? reinterpret_cast<void*>(func_msg->arg(1).scalar_value().void_pointer()) : RandomVoidPointer();
+                uint32_t arg2 = (func_msg->arg(2).type() == TYPE_SCALAR && func_msg->arg(2).scalar_value().has_uint32_t()) ? func_msg->arg(2).scalar_value().uint32_t() : RandomUint32();
+                int32_t arg3 = (func_msg->arg(3).type() == TYPE_SCALAR && func_msg->arg(3).scalar_value().has_int32_t()) ? func_msg->arg(3).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2, arg3))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "fopen")) {
+        typedef void* (*func_type_fopen)(...);
+        func_type_fopen func = (func_type_fopen) target_loader_.GetLoaderFunction("fopen");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                char arg0[func_msg->arg(0).string_value().length() + 1];
+                if (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).string_value().has_message()) {
+                  strcpy(arg0, func_msg->arg(0).string_value().message().c_str());
+                } else {
+               strcpy(arg0, RandomCharPointer());
+                }
+            ;
+                char arg1[func_msg->arg(1).string_value().length() + 1];
+                if (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).string_value().has_message()) {
+                  strcpy(arg1, func_msg->arg(1).string_value().message().c_str());
+                } else {
+               strcpy(arg1, RandomCharPointer());
+                }
+            ;
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "read")) {
+        typedef void* (*func_type_read)(...);
+        func_type_read func = (func_type_read) target_loader_.GetLoaderFunction("read");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                void* arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_void_pointer()) ? reinterpret_cast<void*>(func_msg->arg(1).scalar_value().void_pointer()) : RandomVoidPointer();
+                uint32_t arg2 = (func_msg->arg(2).type() == TYPE_SCALAR && func_msg->arg(2).scalar_value().has_uint32_t()) ? func_msg->arg(2).scalar_value().uint32_t() : RandomUint32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "write")) {
+        typedef void* (*func_type_write)(...);
+        func_type_write func = (func_type_write) target_loader_.GetLoaderFunction("write");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                void* arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_void_pointer()) ? reinterpret_cast<void*>(func_msg->arg(1).scalar_value().void_pointer()) : RandomVoidPointer();
+                int32_t arg2 = (func_msg->arg(2).type() == TYPE_SCALAR && func_msg->arg(2).scalar_value().has_int32_t()) ? func_msg->arg(2).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "lseek")) {
+        typedef void* (*func_type_lseek)(...);
+        func_type_lseek func = (func_type_lseek) target_loader_.GetLoaderFunction("lseek");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+                int32_t arg1 = (func_msg->arg(1).type() == TYPE_SCALAR && func_msg->arg(1).scalar_value().has_int32_t()) ? func_msg->arg(1).scalar_value().int32_t() : RandomInt32();
+                int32_t arg2 = (func_msg->arg(2).type() == TYPE_SCALAR && func_msg->arg(2).scalar_value().has_int32_t()) ? func_msg->arg(2).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0, arg1, arg2))));
+        }
+        return count;
+    }
+    if (!strcmp(func_name, "close")) {
+        typedef void* (*func_type_close)(...);
+        func_type_close func = (func_type_close) target_loader_.GetLoaderFunction("close");
+        if (func == NULL) return 0;
+        for (int i = 0; i < count; i++) {
+                int32_t arg0 = (func_msg->arg(0).type() == TYPE_SCALAR && func_msg->arg(0).scalar_value().has_int32_t()) ? func_msg->arg(0).scalar_value().int32_t() : RandomInt32();
+            results->push_back(const_cast<void*>(reinterpret_cast<const void*>(func(arg0))));
+        }
+        return count;
+    }
+    return DriverBase::FuzzRepeated(
+        func_msg, count, callback_socket_name, results);
+}
 bool FuzzerExtended_libc::GetAttribute(
     FunctionSpecificationMessage* func_msg,
     void** result) {
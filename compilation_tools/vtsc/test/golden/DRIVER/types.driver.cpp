@@ -2,10 +2,14 @@
 #include "vts_measurement.h"
 #include <android-base/logging.h>
 #include <android/hidl/allocator/1.0/IAllocator.h>
+#include <driver_base/HidlServiceCache.h>
 #include <fcntl.h>
 #include <fmq/MessageQueue.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <utils/InterfaceSpecUtil.h>
+#include <utils/StringUtil.h>
+#include <utils/TypeConversionUtil.h>
 
 
 using namespace android::hardware::nfc::V1_0;
@@ -15,22 +19,23 @@ extern "C" void MessageTo__android__hardware__nfc__V1_0__NfcEvent(const Variable
     *arg = (::android::hardware::nfc::V1_0::NfcEvent)var_msg.scalar_value().uint32_t();
 }
 uint32_t Random__android__hardware__nfc__V1_0__NfcEvent() {
-    uint32_t choice = (uint32_t) rand() / 7;
-    if (choice == (uint32_t) 0UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::OPEN_CPLT);
-    if (choice == (uint32_t) 1UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::CLOSE_CPLT);
-    if (choice == (uint32_t) 2UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::POST_INIT_CPLT);
-    if (choice == (uint32_t) 3UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::PRE_DISCOVER_CPLT);
-    if (choice == (uint32_t) 4UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::REQUEST_CONTROL);
-    if (choice == (uint32_t) 5UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::RELEASE_CONTROL);
-    if (choice == (uint32_t) 6UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::ERROR);
-    return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::OPEN_CPLT);
+    static const uint32_t kValues[] = {
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::OPEN_CPLT),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::CLOSE_CPLT),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::POST_INIT_CPLT),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::PRE_DISCOVER_CPLT),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::REQUEST_CONTROL),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::RELEASE_CONTROL),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcEvent::ERROR),
+    };
+    return kValues[RandomIndex(sizeof(kValues) / sizeof(kValues[0]))];
 }
 bool Verify__android__hardware__nfc__V1_0__NfcEvent(const VariableSpecificationMessage& expected_result __attribute__((__unused__)), const VariableSpecificationMessage& actual_result __attribute__((__unused__))){
     if (actual_result.scalar_value().uint32_t() != expected_result.scalar_value().uint32_t()) { return false; }
     return true;
 }
 
-extern "C" void SetResult__android__hardware__nfc__V1_0__NfcEvent(VariableSpecificationMessage* result_msg, ::android::hardware::nfc::V1_0::NfcEvent result_value __attribute__((__unused__))){
+extern "C" void SetResult__android__hardware__nfc__V1_0__NfcEvent(VariableSpecificationMessage* result_msg, const ::android::hardware::nfc::V1_0::NfcEvent& result_value __attribute__((__unused__))){
     result_msg->set_type(TYPE_ENUM);
     result_msg->set_scalar_type("uint32_t");
     result_msg->mutable_scalar_value()->set_uint32_t(static_cast<uint32_t>(result_value));
@@ -40,24 +45,35 @@ extern "C" void MessageTo__android__hardware__nfc__V1_0__NfcStatus(const Variabl
     *arg = (::android::hardware::nfc::V1_0::NfcStatus)var_msg.scalar_value().uint32_t();
 }
 uint32_t Random__android__hardware__nfc__V1_0__NfcStatus() {
-    uint32_t choice = (uint32_t) rand() / 5;
-    if (choice == (uint32_t) 0UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::OK);
-    if (choice == (uint32_t) 1UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::FAILED);
-    if (choice == (uint32_t) 2UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::ERR_TRANSPORT);
-    if (choice == (uint32_t) 3UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::ERR_CMD_TIMEOUT);
-    if (choice == (uint32_t) 4UL) return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::REFUSED);
-    return static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::OK);
+    static const uint32_t kValues[] = {
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::OK),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::FAILED),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::ERR_TRANSPORT),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::ERR_CMD_TIMEOUT),
+        static_cast<uint32_t>(::android::hardware::nfc::V1_0::NfcStatus::REFUSED),
+    };
+    return kValues[RandomIndex(sizeof(kValues) / sizeof(kValues[0]))];
 }
 bool Verify__android__hardware__nfc__V1_0__NfcStatus(const VariableSpecificationMessage& expected_result __attribute__((__unused__)), const VariableSpecificationMessage& actual_result __attribute__((__unused__))){
     if (actual_result.scalar_value().uint32_t() != expected_result.scalar_value().uint32_t()) { return false; }
     return true;
 }
 
-extern "C" void SetResult__android__hardware__nfc__V1_0__NfcStatus(VariableSpecificationMessage* result_msg, ::android::hardware::nfc::V1_0::NfcStatus result_value __attribute__((__unused__))){
+extern "C" void SetResult__android__hardware__nfc__V1_0__NfcStatus(VariableSpecificationMessage* result_msg, const ::android::hardware::nfc::V1_0::NfcStatus& result_value __attribute__((__unused__))){
     result_msg->set_type(TYPE_ENUM);
     result_msg->set_scalar_type("uint32_t");
     result_msg->mutable_scalar_value()->set_uint32_t(static_cast<uint32_t>(result_value));
 }
 
+static const VtsTypeConversionEntry kTypeConversions[] = {
+    MakeTypeConversionEntry<::android::hardware::nfc::V1_0::NfcEvent>("::android::hardware::nfc::V1_0::NfcEvent", &MessageTo__android__hardware__nfc__V1_0__NfcEvent, &SetResult__android__hardware__nfc__V1_0__NfcEvent, true),
+    MakeTypeConversionEntry<::android::hardware::nfc::V1_0::NfcStatus>("::android::hardware::nfc::V1_0::NfcStatus", &MessageTo__android__hardware__nfc__V1_0__NfcStatus, &SetResult__android__hardware__nfc__V1_0__NfcStatus, true),
+};
+
+extern "C" const VtsTypeConversionEntry* VtsTypeConversions__android__hardware__nfc__V1_0__types(size_t* size) {
+    *size = sizeof(kTypeConversions) / sizeof(kTypeConversions[0]);
+    return kTypeConversions;
+}
+
 }  // namespace vts
 }  // namespace android
@@ -3,6 +3,9 @@
 #include <iostream>
 
 #include "FuncFuzzerUtils.h"
+#include "utils/FuzzDecodeUtil.h"
+#include "utils/FuzzForkServer.h"
+#include "utils/FuzzRemoteCoverage.h"
 #include <android/hardware/renderscript/1.0/IContext.h>
 
 using std::cerr;
@@ -16,11 +19,1280 @@ namespace android {
 namespace vts {
 
 static string target_func;
+static FuzzForkServer fork_server;
+static FuzzRemoteCoverage remote_coverage;
+
+// Fuzzes one function of the HAL with the input at data, and consumes it.
+// Returns false if the input is too short.
+typedef bool (*FuzzFunc)(::android::sp<IContext> &hal, FuzzDataCursor &cursor);
+
+static bool Fuzz_allocationAdapterCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationAdapterCreate(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationAdapterOffset(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_vec<uint32_t> arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationAdapterOffset(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationGetType(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationGetType(arg0);
+    return true;
+}
+
+static bool Fuzz_allocationCreateTyped(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static int32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static void* arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationCreateTyped(arg0, arg1, arg2, arg3);
+    return true;
+}
+
+static bool Fuzz_allocationCreateFromBitmap(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static int32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationCreateFromBitmap(arg0, arg1, arg2, arg3);
+    return true;
+}
+
+static bool Fuzz_allocationCubeCreateFromBitmap(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static int32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationCubeCreateFromBitmap(arg0, arg1, arg2, arg3);
+    return true;
+}
+
+static bool Fuzz_allocationGetNativeWindow(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationGetNativeWindow(arg0);
+    return true;
+}
+
+static bool Fuzz_allocationSetNativeWindow(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationSetNativeWindow(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationSetupBufferQueue(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationSetupBufferQueue(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationShareBufferQueue(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationShareBufferQueue(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationCopyToBitmap(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static void* arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationCopyToBitmap(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_allocation1DWrite(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocation1DWrite(arg0, arg1, arg2, arg3, arg4);
+    return true;
+}
+
+static bool Fuzz_allocationElementWrite(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static uint32_t arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint64_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationElementWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+    return true;
+}
+
+static bool Fuzz_allocation2DWrite(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint32_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint32_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    static uint64_t arg8;
+    if (!DecodeFuzzValue(cursor, &arg8)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocation2DWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8);
+    return true;
+}
+
+static bool Fuzz_allocation3DWrite(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static uint32_t arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint32_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint32_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static uint32_t arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg8;
+    if (!DecodeFuzzValue(cursor, &arg8)) { return false; }
+    static uint64_t arg9;
+    if (!DecodeFuzzValue(cursor, &arg9)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocation3DWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9);
+    return true;
+}
+
+static bool Fuzz_allocationGenerateMipmaps(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationGenerateMipmaps(arg0);
+    return true;
+}
+
+static bool Fuzz_allocationRead(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static void* arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationRead(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_allocation1DRead(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static void* arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint64_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocation1DRead(arg0, arg1, arg2, arg3, arg4, arg5);
+    return true;
+}
+
+static bool Fuzz_allocationElementRead(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static uint32_t arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static void* arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint64_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static uint64_t arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationElementRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7);
+    return true;
+}
+
+static bool Fuzz_allocation2DRead(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint32_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint32_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static void* arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    static uint64_t arg8;
+    if (!DecodeFuzzValue(cursor, &arg8)) { return false; }
+    static uint64_t arg9;
+    if (!DecodeFuzzValue(cursor, &arg9)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocation2DRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9);
+    return true;
+}
+
+static bool Fuzz_allocation3DRead(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static uint32_t arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint32_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint32_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static uint32_t arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    static void* arg8;
+    if (!DecodeFuzzValue(cursor, &arg8)) { return false; }
+    static uint64_t arg9;
+    if (!DecodeFuzzValue(cursor, &arg9)) { return false; }
+    static uint64_t arg10;
+    if (!DecodeFuzzValue(cursor, &arg10)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocation3DRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10);
+    return true;
+}
+
+static bool Fuzz_allocationSyncAll(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationUsageType arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationSyncAll(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationResize1D(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationResize1D(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_allocationCopy2DRange(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint32_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint32_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static uint64_t arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    static uint32_t arg8;
+    if (!DecodeFuzzValue(cursor, &arg8)) { return false; }
+    static uint32_t arg9;
+    if (!DecodeFuzzValue(cursor, &arg9)) { return false; }
+    static uint32_t arg10;
+    if (!DecodeFuzzValue(cursor, &arg10)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg11;
+    if (!DecodeFuzzValue(cursor, &arg11)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationCopy2DRange(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11);
+    return true;
+}
+
+static bool Fuzz_allocationCopy3DRange(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static uint32_t arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static uint32_t arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static uint32_t arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    static uint32_t arg7;
+    if (!DecodeFuzzValue(cursor, &arg7)) { return false; }
+    static uint64_t arg8;
+    if (!DecodeFuzzValue(cursor, &arg8)) { return false; }
+    static uint32_t arg9;
+    if (!DecodeFuzzValue(cursor, &arg9)) { return false; }
+    static uint32_t arg10;
+    if (!DecodeFuzzValue(cursor, &arg10)) { return false; }
+    static uint32_t arg11;
+    if (!DecodeFuzzValue(cursor, &arg11)) { return false; }
+    static uint32_t arg12;
+    if (!DecodeFuzzValue(cursor, &arg12)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationCopy3DRange(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12);
+    return true;
+}
+
+static bool Fuzz_allocationIoSend(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationIoSend(arg0);
+    return true;
+}
+
+static bool Fuzz_allocationIoReceive(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationIoReceive(arg0);
+    return true;
+}
+
+static bool Fuzz_allocationGetPointer(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](void* arg0, uint64_t arg1){};
+
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->allocationGetPointer(arg0, arg1, arg2, arg3, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_elementGetNativeMetadata(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](const ::android::hardware::hidl_vec<uint32_t>& arg0){};
+
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->elementGetNativeMetadata(arg0, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_elementGetSubElements(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](const ::android::hardware::hidl_vec<uint64_t>& arg0, const ::android::hardware::hidl_vec<::android::hardware::hidl_string>& arg1, const ::android::hardware::hidl_vec<uint64_t>& arg2){};
+
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->elementGetSubElements(arg0, arg1, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_elementCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::renderscript::V1_0::DataType arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::DataKind arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static bool arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->elementCreate(arg0, arg1, arg2, arg3);
+    return true;
+}
+
+static bool Fuzz_elementComplexCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::hidl_vec<uint64_t> arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_vec<::android::hardware::hidl_string> arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->elementComplexCreate(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_typeGetNativeMetadata(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](const ::android::hardware::hidl_vec<uint64_t>& arg0){};
+
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->typeGetNativeMetadata(arg0, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_typeCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static bool arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static bool arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static ::android::hardware::renderscript::V1_0::YuvFormat arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->typeCreate(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+    return true;
+}
+
+static bool Fuzz_contextDestroy(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextDestroy();
+    return true;
+}
+
+static bool Fuzz_contextGetMessage(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](::android::hardware::renderscript::V1_0::MessageToClientType arg0, uint64_t arg1){};
+
+    static void* arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextGetMessage(arg0, arg1, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_contextPeekMessage(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](::android::hardware::renderscript::V1_0::MessageToClientType arg0, uint64_t arg1, uint32_t arg2){};
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextPeekMessage(hidl_cb);
+    return true;
+}
+
+static bool Fuzz_contextSendMessage(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint32_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextSendMessage(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_contextInitToClient(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextInitToClient();
+    return true;
+}
+
+static bool Fuzz_contextDeinitToClient(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextDeinitToClient();
+    return true;
+}
+
+static bool Fuzz_contextFinish(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextFinish();
+    return true;
+}
+
+static bool Fuzz_contextLog(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextLog();
+    return true;
+}
+
+static bool Fuzz_contextSetCacheDir(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::hidl_string arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextSetCacheDir(arg0);
+    return true;
+}
+
+static bool Fuzz_contextSetPriority(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::renderscript::V1_0::ThreadPriorities arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextSetPriority(arg0);
+    return true;
+}
+
+static bool Fuzz_assignName(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_string arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->assignName(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_getName(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](const ::android::hardware::hidl_string& arg0){};
+
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->getName(arg0, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_closureCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static ::android::hardware::hidl_vec<int64_t> arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::hidl_vec<int32_t> arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg6;
+    if (!DecodeFuzzValue(cursor, &arg6)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->closureCreate(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+    return true;
+}
+
+static bool Fuzz_invokeClosureCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static ::android::hardware::hidl_vec<int64_t> arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::hidl_vec<int32_t> arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->invokeClosureCreate(arg0, arg1, arg2, arg3, arg4);
+    return true;
+}
+
+static bool Fuzz_closureSetArg(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static void* arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static int32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->closureSetArg(arg0, arg1, arg2, arg3);
+    return true;
+}
+
+static bool Fuzz_closureSetGlobal(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static int64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static int32_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->closureSetGlobal(arg0, arg1, arg2, arg3);
+    return true;
+}
+
+static bool Fuzz_scriptKernelIDCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static int32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static int32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptKernelIDCreate(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptInvokeIDCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static int32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptInvokeIDCreate(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_scriptFieldIDCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static int32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptFieldIDCreate(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_scriptGroupCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::hidl_vec<uint64_t> arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptGroupCreate(arg0, arg1, arg2, arg3, arg4);
+    return true;
+}
+
+static bool Fuzz_scriptGroup2Create(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::hidl_string arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_string arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptGroup2Create(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptGroupSetOutput(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptGroupSetOutput(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptGroupSetInput(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptGroupSetInput(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptGroupExecute(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptGroupExecute(arg0);
+    return true;
+}
+
+static bool Fuzz_objDestroy(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->objDestroy(arg0);
+    return true;
+}
+
+static bool Fuzz_samplerCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::renderscript::V1_0::SamplerValue arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::SamplerValue arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::renderscript::V1_0::SamplerValue arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static ::android::hardware::renderscript::V1_0::SamplerValue arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::renderscript::V1_0::SamplerValue arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static float arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->samplerCreate(arg0, arg1, arg2, arg3, arg4, arg5);
+    return true;
+}
+
+static bool Fuzz_scriptBindAllocation(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptBindAllocation(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptSetTimeZone(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_string arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetTimeZone(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_scriptInvoke(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptInvoke(arg0, arg1);
+    return true;
+}
+
+static bool Fuzz_scriptInvokeV(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptInvokeV(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptForEach(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint64_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    static void* arg5;
+    if (!DecodeFuzzValue(cursor, &arg5)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptForEach(arg0, arg1, arg2, arg3, arg4, arg5);
+    return true;
+}
+
+static bool Fuzz_scriptReduce(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint64_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint64_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static void* arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptReduce(arg0, arg1, arg2, arg3, arg4);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarI(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static int32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarI(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarObj(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarObj(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarJ(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static int64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarJ(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarF(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static float arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarF(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarD(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static double arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarD(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarV(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarV(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptGetVarV(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    // No-op. Only need this to make HAL function call.
+    auto hidl_cb = [](const ::android::hardware::hidl_vec<uint8_t>& arg0){};
+
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static uint64_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptGetVarV(arg0, arg1, arg2, hidl_cb);
+    return true;
+}
+
+static bool Fuzz_scriptSetVarVE(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static uint64_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint32_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    static uint64_t arg3;
+    if (!DecodeFuzzValue(cursor, &arg3)) { return false; }
+    static ::android::hardware::hidl_vec<uint32_t> arg4;
+    if (!DecodeFuzzValue(cursor, &arg4)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptSetVarVE(arg0, arg1, arg2, arg3, arg4);
+    return true;
+}
+
+static bool Fuzz_scriptCCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::hidl_string arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::hidl_string arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static ::android::hardware::hidl_vec<uint8_t> arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptCCreate(arg0, arg1, arg2);
+    return true;
+}
+
+static bool Fuzz_scriptIntrinsicCreate(::android::sp<IContext> &renderscript, FuzzDataCursor &cursor) {
+    static ::android::hardware::renderscript::V1_0::ScriptIntrinsicID arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static uint64_t arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->scriptIntrinsicCreate(arg0, arg1);
+    return true;
+}
+
+// the functions to fuzz, indexed by the first byte of each call in the input
+// when fuzzing sequences of all the functions.
+static const struct {
+    const char *name;
+    FuzzFunc func;
+} kFuzzFuncs[] = {
+    {"allocationAdapterCreate", Fuzz_allocationAdapterCreate},
+    {"allocationAdapterOffset", Fuzz_allocationAdapterOffset},
+    {"allocationGetType", Fuzz_allocationGetType},
+    {"allocationCreateTyped", Fuzz_allocationCreateTyped},
+    {"allocationCreateFromBitmap", Fuzz_allocationCreateFromBitmap},
+    {"allocationCubeCreateFromBitmap", Fuzz_allocationCubeCreateFromBitmap},
+    {"allocationGetNativeWindow", Fuzz_allocationGetNativeWindow},
+    {"allocationSetNativeWindow", Fuzz_allocationSetNativeWindow},
+    {"allocationSetupBufferQueue", Fuzz_allocationSetupBufferQueue},
+    {"allocationShareBufferQueue", Fuzz_allocationShareBufferQueue},
+    {"allocationCopyToBitmap", Fuzz_allocationCopyToBitmap},
+    {"allocation1DWrite", Fuzz_allocation1DWrite},
+    {"allocationElementWrite", Fuzz_allocationElementWrite},
+    {"allocation2DWrite", Fuzz_allocation2DWrite},
+    {"allocation3DWrite", Fuzz_allocation3DWrite},
+    {"allocationGenerateMipmaps", Fuzz_allocationGenerateMipmaps},
+    {"allocationRead", Fuzz_allocationRead},
+    {"allocation1DRead", Fuzz_allocation1DRead},
+    {"allocationElementRead", Fuzz_allocationElementRead},
+    {"allocation2DRead", Fuzz_allocation2DRead},
+    {"allocation3DRead", Fuzz_allocation3DRead},
+    {"allocationSyncAll", Fuzz_allocationSyncAll},
+    {"allocationResize1D", Fuzz_allocationResize1D},
+    {"allocationCopy2DRange", Fuzz_allocationCopy2DRange},
+    {"allocationCopy3DRange", Fuzz_allocationCopy3DRange},
+    {"allocationIoSend", Fuzz_allocationIoSend},
+    {"allocationIoReceive", Fuzz_allocationIoReceive},
+    {"allocationGetPointer", Fuzz_allocationGetPointer},
+    {"elementGetNativeMetadata", Fuzz_elementGetNativeMetadata},
+    {"elementGetSubElements", Fuzz_elementGetSubElements},
+    {"elementCreate", Fuzz_elementCreate},
+    {"elementComplexCreate", Fuzz_elementComplexCreate},
+    {"typeGetNativeMetadata", Fuzz_typeGetNativeMetadata},
+    {"typeCreate", Fuzz_typeCreate},
+    {"contextDestroy", Fuzz_contextDestroy},
+    {"contextGetMessage", Fuzz_contextGetMessage},
+    {"contextPeekMessage", Fuzz_contextPeekMessage},
+    {"contextSendMessage", Fuzz_contextSendMessage},
+    {"contextInitToClient", Fuzz_contextInitToClient},
+    {"contextDeinitToClient", Fuzz_contextDeinitToClient},
+    {"contextFinish", Fuzz_contextFinish},
+    {"contextLog", Fuzz_contextLog},
+    {"contextSetCacheDir", Fuzz_contextSetCacheDir},
+    {"contextSetPriority", Fuzz_contextSetPriority},
+    {"assignName", Fuzz_assignName},
+    {"getName", Fuzz_getName},
+    {"closureCreate", Fuzz_closureCreate},
+    {"invokeClosureCreate", Fuzz_invokeClosureCreate},
+    {"closureSetArg", Fuzz_closureSetArg},
+    {"closureSetGlobal", Fuzz_closureSetGlobal},
+    {"scriptKernelIDCreate", Fuzz_scriptKernelIDCreate},
+    {"scriptInvokeIDCreate", Fuzz_scriptInvokeIDCreate},
+    {"scriptFieldIDCreate", Fuzz_scriptFieldIDCreate},
+    {"scriptGroupCreate", Fuzz_scriptGroupCreate},
+    {"scriptGroup2Create", Fuzz_scriptGroup2Create},
+    {"scriptGroupSetOutput", Fuzz_scriptGroupSetOutput},
+    {"scriptGroupSetInput", Fuzz_scriptGroupSetInput},
+    {"scriptGroupExecute", Fuzz_scriptGroupExecute},
+    {"objDestroy", Fuzz_objDestroy},
+    {"samplerCreate", Fuzz_samplerCreate},
+    {"scriptBindAllocation", Fuzz_scriptBindAllocation},
+    {"scriptSetTimeZone", Fuzz_scriptSetTimeZone},
+    {"scriptInvoke", Fuzz_scriptInvoke},
+    {"scriptInvokeV", Fuzz_scriptInvokeV},
+    {"scriptForEach", Fuzz_scriptForEach},
+    {"scriptReduce", Fuzz_scriptReduce},
+    {"scriptSetVarI", Fuzz_scriptSetVarI},
+    {"scriptSetVarObj", Fuzz_scriptSetVarObj},
+    {"scriptSetVarJ", Fuzz_scriptSetVarJ},
+    {"scriptSetVarF", Fuzz_scriptSetVarF},
+    {"scriptSetVarD", Fuzz_scriptSetVarD},
+    {"scriptSetVarV", Fuzz_scriptSetVarV},
+    {"scriptGetVarV", Fuzz_scriptGetVarV},
+    {"scriptSetVarVE", Fuzz_scriptSetVarVE},
+    {"scriptCCreate", Fuzz_scriptCCreate},
+    {"scriptIntrinsicCreate", Fuzz_scriptIntrinsicCreate},
+};
+static const size_t kNumFuzzFuncs = sizeof(kFuzzFuncs) / sizeof(kFuzzFuncs[0]);
+
+// the function to fuzz, nullptr to fuzz sequences of all the functions.
+static FuzzFunc target_fuzz_func = nullptr;
+
+// Fuzzes the HAL with the whole input. Only decodes the input if hal is null.
+static void FuzzInput(::android::sp<IContext> &hal, FuzzDataCursor &cursor) {
+    if (target_fuzz_func != nullptr) {
+        target_fuzz_func(hal, cursor);
+        return;
+    }
+    // Each call is a byte selecting the function, followed by its arguments.
+    uint8_t index;
+    while (cursor.ConsumeBytes(&index, sizeof(index))) {
+        FuzzFunc fuzz_func = kFuzzFuncs[index % kNumFuzzFuncs].func;
+        if (!fuzz_func(hal, cursor)) { break; }
+    }
+}
 
 extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    fork_server.ExtractBatchSize(argc, argv);
+    remote_coverage.ExtractAndMap(argc, argv);
     FuncFuzzerParams params{ExtractFuncFuzzerParams(*argc, *argv)};
     target_func = params.target_func_;
-    return 0;
+    if (target_func.empty()) { return 0; }
+    for (const auto &fuzz_func : kFuzzFuncs) {
+        if (target_func == fuzz_func.name) {
+            target_fuzz_func = fuzz_func.func;
+            return 0;
+        }
+    }
+    cerr << "No such function: " << target_func << endl;
+    exit(1);
 }
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
@@ -30,2082 +1302,22 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
         exit(1);
     }
 
-    if (target_func == "allocationAdapterCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationAdapterCreate(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationAdapterOffset") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_vec<uint32_t>);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_vec<uint32_t> arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationAdapterOffset(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationGetType") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->allocationGetType(arg0);
-        return 0;
-    } else if (target_func == "allocationCreateTyped") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::AllocationMipmapControl);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(int32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        int32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(void*);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        void* arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->allocationCreateTyped(arg0, arg1, arg2, arg3);
-        return 0;
-    } else if (target_func == "allocationCreateFromBitmap") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::AllocationMipmapControl);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint8_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(int32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        int32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->allocationCreateFromBitmap(arg0, arg1, arg2, arg3);
-        return 0;
-    } else if (target_func == "allocationCubeCreateFromBitmap") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::AllocationMipmapControl);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint8_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(int32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        int32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->allocationCubeCreateFromBitmap(arg0, arg1, arg2, arg3);
-        return 0;
-    } else if (target_func == "allocationGetNativeWindow") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->allocationGetNativeWindow(arg0);
-        return 0;
-    } else if (target_func == "allocationSetNativeWindow") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationSetNativeWindow(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationSetupBufferQueue") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationSetupBufferQueue(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationShareBufferQueue") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationShareBufferQueue(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationCopyToBitmap") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(void*);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        void* arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->allocationCopyToBitmap(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "allocation1DWrite") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::hidl_vec<uint8_t> arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        renderscript->allocation1DWrite(arg0, arg1, arg2, arg3, arg4);
-        return 0;
-    } else if (target_func == "allocationElementWrite") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(uint32_t);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        uint32_t arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        ::android::hardware::hidl_vec<uint8_t> arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint64_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint64_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        renderscript->allocationElementWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
-        return 0;
-    } else if (target_func == "allocation2DWrite") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::renderscript::V1_0::AllocationCubemapFace);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint32_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint32_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint32_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint32_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        ::android::hardware::hidl_vec<uint8_t> arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        size_t type_size8 = sizeof(uint64_t);
-        if (size < type_size8) { return 0; }
-        size -= type_size8;
-        uint64_t arg8;
-        memcpy(&arg8, data, type_size8);
-        data += type_size8;
-
-        renderscript->allocation2DWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8);
-        return 0;
-    } else if (target_func == "allocation3DWrite") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(uint32_t);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        uint32_t arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint32_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint32_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint32_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint32_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(uint32_t);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        uint32_t arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        size_t type_size8 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size8) { return 0; }
-        size -= type_size8;
-        ::android::hardware::hidl_vec<uint8_t> arg8;
-        memcpy(&arg8, data, type_size8);
-        data += type_size8;
-
-        size_t type_size9 = sizeof(uint64_t);
-        if (size < type_size9) { return 0; }
-        size -= type_size9;
-        uint64_t arg9;
-        memcpy(&arg9, data, type_size9);
-        data += type_size9;
-
-        renderscript->allocation3DWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9);
-        return 0;
-    } else if (target_func == "allocationGenerateMipmaps") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->allocationGenerateMipmaps(arg0);
-        return 0;
-    } else if (target_func == "allocationRead") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(void*);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        void* arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->allocationRead(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "allocation1DRead") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(void*);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        void* arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint64_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint64_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        renderscript->allocation1DRead(arg0, arg1, arg2, arg3, arg4, arg5);
-        return 0;
-    } else if (target_func == "allocationElementRead") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(uint32_t);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        uint32_t arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(void*);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        void* arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint64_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint64_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(uint64_t);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        uint64_t arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        renderscript->allocationElementRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7);
-        return 0;
-    } else if (target_func == "allocation2DRead") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::renderscript::V1_0::AllocationCubemapFace);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint32_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint32_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint32_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint32_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(void*);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        void* arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        size_t type_size8 = sizeof(uint64_t);
-        if (size < type_size8) { return 0; }
-        size -= type_size8;
-        uint64_t arg8;
-        memcpy(&arg8, data, type_size8);
-        data += type_size8;
-
-        size_t type_size9 = sizeof(uint64_t);
-        if (size < type_size9) { return 0; }
-        size -= type_size9;
-        uint64_t arg9;
-        memcpy(&arg9, data, type_size9);
-        data += type_size9;
-
-        renderscript->allocation2DRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9);
-        return 0;
-    } else if (target_func == "allocation3DRead") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(uint32_t);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        uint32_t arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint32_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint32_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint32_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint32_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(uint32_t);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        uint32_t arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        size_t type_size8 = sizeof(void*);
-        if (size < type_size8) { return 0; }
-        size -= type_size8;
-        void* arg8;
-        memcpy(&arg8, data, type_size8);
-        data += type_size8;
-
-        size_t type_size9 = sizeof(uint64_t);
-        if (size < type_size9) { return 0; }
-        size -= type_size9;
-        uint64_t arg9;
-        memcpy(&arg9, data, type_size9);
-        data += type_size9;
-
-        size_t type_size10 = sizeof(uint64_t);
-        if (size < type_size10) { return 0; }
-        size -= type_size10;
-        uint64_t arg10;
-        memcpy(&arg10, data, type_size10);
-        data += type_size10;
-
-        renderscript->allocation3DRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10);
-        return 0;
-    } else if (target_func == "allocationSyncAll") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::AllocationUsageType);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::AllocationUsageType arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationSyncAll(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationResize1D") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->allocationResize1D(arg0, arg1);
-        return 0;
-    } else if (target_func == "allocationCopy2DRange") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::renderscript::V1_0::AllocationCubemapFace);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint32_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint32_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint32_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint32_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(uint64_t);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        uint64_t arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        size_t type_size8 = sizeof(uint32_t);
-        if (size < type_size8) { return 0; }
-        size -= type_size8;
-        uint32_t arg8;
-        memcpy(&arg8, data, type_size8);
-        data += type_size8;
-
-        size_t type_size9 = sizeof(uint32_t);
-        if (size < type_size9) { return 0; }
-        size -= type_size9;
-        uint32_t arg9;
-        memcpy(&arg9, data, type_size9);
-        data += type_size9;
-
-        size_t type_size10 = sizeof(uint32_t);
-        if (size < type_size10) { return 0; }
-        size -= type_size10;
-        uint32_t arg10;
-        memcpy(&arg10, data, type_size10);
-        data += type_size10;
-
-        size_t type_size11 = sizeof(::android::hardware::renderscript::V1_0::AllocationCubemapFace);
-        if (size < type_size11) { return 0; }
-        size -= type_size11;
-        ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg11;
-        memcpy(&arg11, data, type_size11);
-        data += type_size11;
-
-        renderscript->allocationCopy2DRange(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11);
-        return 0;
-    } else if (target_func == "allocationCopy3DRange") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(uint32_t);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        uint32_t arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(uint32_t);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        uint32_t arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(uint32_t);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        uint32_t arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        size_t type_size7 = sizeof(uint32_t);
-        if (size < type_size7) { return 0; }
-        size -= type_size7;
-        uint32_t arg7;
-        memcpy(&arg7, data, type_size7);
-        data += type_size7;
-
-        size_t type_size8 = sizeof(uint64_t);
-        if (size < type_size8) { return 0; }
-        size -= type_size8;
-        uint64_t arg8;
-        memcpy(&arg8, data, type_size8);
-        data += type_size8;
-
-        size_t type_size9 = sizeof(uint32_t);
-        if (size < type_size9) { return 0; }
-        size -= type_size9;
-        uint32_t arg9;
-        memcpy(&arg9, data, type_size9);
-        data += type_size9;
-
-        size_t type_size10 = sizeof(uint32_t);
-        if (size < type_size10) { return 0; }
-        size -= type_size10;
-        uint32_t arg10;
-        memcpy(&arg10, data, type_size10);
-        data += type_size10;
-
-        size_t type_size11 = sizeof(uint32_t);
-        if (size < type_size11) { return 0; }
-        size -= type_size11;
-        uint32_t arg11;
-        memcpy(&arg11, data, type_size11);
-        data += type_size11;
-
-        size_t type_size12 = sizeof(uint32_t);
-        if (size < type_size12) { return 0; }
-        size -= type_size12;
-        uint32_t arg12;
-        memcpy(&arg12, data, type_size12);
-        data += type_size12;
-
-        renderscript->allocationCopy3DRange(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12);
-        return 0;
-    } else if (target_func == "allocationIoSend") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->allocationIoSend(arg0);
-        return 0;
-    } else if (target_func == "allocationIoReceive") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->allocationIoReceive(arg0);
-        return 0;
-    } else if (target_func == "allocationGetPointer") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](void* arg0, uint64_t arg1){};
-
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::renderscript::V1_0::AllocationCubemapFace);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->allocationGetPointer(arg0, arg1, arg2, arg3, hidl_cb);
-        return 0;
-    } else if (target_func == "elementGetNativeMetadata") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](const ::android::hardware::hidl_vec<uint32_t>& arg0){};
-
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->elementGetNativeMetadata(arg0, hidl_cb);
-        return 0;
-    } else if (target_func == "elementGetSubElements") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](const ::android::hardware::hidl_vec<uint64_t>& arg0, const ::android::hardware::hidl_vec<::android::hardware::hidl_string>& arg1, const ::android::hardware::hidl_vec<uint64_t>& arg2){};
-
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->elementGetSubElements(arg0, arg1, hidl_cb);
-        return 0;
-    } else if (target_func == "elementCreate") {
-        size_t type_size0 = sizeof(::android::hardware::renderscript::V1_0::DataType);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::renderscript::V1_0::DataType arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::DataKind);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::DataKind arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(bool);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        bool arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->elementCreate(arg0, arg1, arg2, arg3);
-        return 0;
-    } else if (target_func == "elementComplexCreate") {
-        size_t type_size0 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::hidl_vec<uint64_t> arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_vec<::android::hardware::hidl_string>);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_vec<::android::hardware::hidl_string> arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->elementComplexCreate(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "typeGetNativeMetadata") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](const ::android::hardware::hidl_vec<uint64_t>& arg0){};
-
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->typeGetNativeMetadata(arg0, hidl_cb);
-        return 0;
-    } else if (target_func == "typeCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(bool);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        bool arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(bool);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        bool arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(::android::hardware::renderscript::V1_0::YuvFormat);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        ::android::hardware::renderscript::V1_0::YuvFormat arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        renderscript->typeCreate(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
-        return 0;
-    } else if (target_func == "contextDestroy") {
-        renderscript->contextDestroy();
-        return 0;
-    } else if (target_func == "contextGetMessage") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](::android::hardware::renderscript::V1_0::MessageToClientType arg0, uint64_t arg1){};
-
-        size_t type_size0 = sizeof(void*);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        void* arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->contextGetMessage(arg0, arg1, hidl_cb);
-        return 0;
-    } else if (target_func == "contextPeekMessage") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](::android::hardware::renderscript::V1_0::MessageToClientType arg0, uint64_t arg1, uint32_t arg2){};
-
-        renderscript->contextPeekMessage(hidl_cb);
-        return 0;
-    } else if (target_func == "contextSendMessage") {
-        size_t type_size0 = sizeof(uint32_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint32_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_vec<uint8_t> arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->contextSendMessage(arg0, arg1);
-        return 0;
-    } else if (target_func == "contextInitToClient") {
-        renderscript->contextInitToClient();
-        return 0;
-    } else if (target_func == "contextDeinitToClient") {
-        renderscript->contextDeinitToClient();
-        return 0;
-    } else if (target_func == "contextFinish") {
-        renderscript->contextFinish();
-        return 0;
-    } else if (target_func == "contextLog") {
-        renderscript->contextLog();
-        return 0;
-    } else if (target_func == "contextSetCacheDir") {
-        size_t type_size0 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::hidl_string arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->contextSetCacheDir(arg0);
-        return 0;
-    } else if (target_func == "contextSetPriority") {
-        size_t type_size0 = sizeof(::android::hardware::renderscript::V1_0::ThreadPriorities);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::renderscript::V1_0::ThreadPriorities arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->contextSetPriority(arg0);
-        return 0;
-    } else if (target_func == "assignName") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_string arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->assignName(arg0, arg1);
-        return 0;
-    } else if (target_func == "getName") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](const ::android::hardware::hidl_string& arg0){};
-
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->getName(arg0, hidl_cb);
-        return 0;
-    } else if (target_func == "closureCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(::android::hardware::hidl_vec<int64_t>);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        ::android::hardware::hidl_vec<int64_t> arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::hidl_vec<int32_t>);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::hidl_vec<int32_t> arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        ::android::hardware::hidl_vec<uint64_t> arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        size_t type_size6 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size6) { return 0; }
-        size -= type_size6;
-        ::android::hardware::hidl_vec<uint64_t> arg6;
-        memcpy(&arg6, data, type_size6);
-        data += type_size6;
-
-        renderscript->closureCreate(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
-        return 0;
-    } else if (target_func == "invokeClosureCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_vec<uint8_t> arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(::android::hardware::hidl_vec<int64_t>);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        ::android::hardware::hidl_vec<int64_t> arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::hidl_vec<int32_t>);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::hidl_vec<int32_t> arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        renderscript->invokeClosureCreate(arg0, arg1, arg2, arg3, arg4);
-        return 0;
-    } else if (target_func == "closureSetArg") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(void*);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        void* arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(int32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        int32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->closureSetArg(arg0, arg1, arg2, arg3);
-        return 0;
-    } else if (target_func == "closureSetGlobal") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(int64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        int64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(int32_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        int32_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        renderscript->closureSetGlobal(arg0, arg1, arg2, arg3);
-        return 0;
-    } else if (target_func == "scriptKernelIDCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(int32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        int32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(int32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        int32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptKernelIDCreate(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptInvokeIDCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(int32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        int32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->scriptInvokeIDCreate(arg0, arg1);
-        return 0;
-    } else if (target_func == "scriptFieldIDCreate") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(int32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        int32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->scriptFieldIDCreate(arg0, arg1);
-        return 0;
-    } else if (target_func == "scriptGroupCreate") {
-        size_t type_size0 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::hidl_vec<uint64_t> arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_vec<uint64_t> arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        ::android::hardware::hidl_vec<uint64_t> arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::hidl_vec<uint64_t> arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        renderscript->scriptGroupCreate(arg0, arg1, arg2, arg3, arg4);
-        return 0;
-    } else if (target_func == "scriptGroup2Create") {
-        size_t type_size0 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::hidl_string arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_string arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptGroup2Create(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptGroupSetOutput") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptGroupSetOutput(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptGroupSetInput") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptGroupSetInput(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptGroupExecute") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->scriptGroupExecute(arg0);
-        return 0;
-    } else if (target_func == "objDestroy") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        renderscript->objDestroy(arg0);
-        return 0;
-    } else if (target_func == "samplerCreate") {
-        size_t type_size0 = sizeof(::android::hardware::renderscript::V1_0::SamplerValue);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::renderscript::V1_0::SamplerValue arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::SamplerValue);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::SamplerValue arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::renderscript::V1_0::SamplerValue);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::renderscript::V1_0::SamplerValue arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(::android::hardware::renderscript::V1_0::SamplerValue);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        ::android::hardware::renderscript::V1_0::SamplerValue arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::renderscript::V1_0::SamplerValue);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::renderscript::V1_0::SamplerValue arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(float);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        float arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        renderscript->samplerCreate(arg0, arg1, arg2, arg3, arg4, arg5);
-        return 0;
-    } else if (target_func == "scriptBindAllocation") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptBindAllocation(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptSetTimeZone") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_string arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->scriptSetTimeZone(arg0, arg1);
-        return 0;
-    } else if (target_func == "scriptInvoke") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->scriptInvoke(arg0, arg1);
-        return 0;
-    } else if (target_func == "scriptInvokeV") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint8_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptInvokeV(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptForEach") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint64_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint64_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::hidl_vec<uint8_t> arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        size_t type_size5 = sizeof(void*);
-        if (size < type_size5) { return 0; }
-        size -= type_size5;
-        void* arg5;
-        memcpy(&arg5, data, type_size5);
-        data += type_size5;
-
-        renderscript->scriptForEach(arg0, arg1, arg2, arg3, arg4, arg5);
-        return 0;
-    } else if (target_func == "scriptReduce") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint64_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint64_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint64_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint64_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(void*);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        void* arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        renderscript->scriptReduce(arg0, arg1, arg2, arg3, arg4);
-        return 0;
-    } else if (target_func == "scriptSetVarI") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(int32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        int32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptSetVarI(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptSetVarObj") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptSetVarObj(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptSetVarJ") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(int64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        int64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptSetVarJ(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptSetVarF") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(float);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        float arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptSetVarF(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptSetVarD") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(double);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        double arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptSetVarD(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptSetVarV") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint8_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptSetVarV(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptGetVarV") {
-        // No-op. Only need this to make HAL function call.
-        auto hidl_cb = [](const ::android::hardware::hidl_vec<uint8_t>& arg0){};
-
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(uint64_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        uint64_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptGetVarV(arg0, arg1, arg2, hidl_cb);
-        return 0;
-    } else if (target_func == "scriptSetVarVE") {
-        size_t type_size0 = sizeof(uint64_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint64_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint32_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint32_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint8_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        size_t type_size3 = sizeof(uint64_t);
-        if (size < type_size3) { return 0; }
-        size -= type_size3;
-        uint64_t arg3;
-        memcpy(&arg3, data, type_size3);
-        data += type_size3;
-
-        size_t type_size4 = sizeof(::android::hardware::hidl_vec<uint32_t>);
-        if (size < type_size4) { return 0; }
-        size -= type_size4;
-        ::android::hardware::hidl_vec<uint32_t> arg4;
-        memcpy(&arg4, data, type_size4);
-        data += type_size4;
-
-        renderscript->scriptSetVarVE(arg0, arg1, arg2, arg3, arg4);
-        return 0;
-    } else if (target_func == "scriptCCreate") {
-        size_t type_size0 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::hidl_string arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::hidl_string);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::hidl_string arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(::android::hardware::hidl_vec<uint8_t>);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        ::android::hardware::hidl_vec<uint8_t> arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->scriptCCreate(arg0, arg1, arg2);
-        return 0;
-    } else if (target_func == "scriptIntrinsicCreate") {
-        size_t type_size0 = sizeof(::android::hardware::renderscript::V1_0::ScriptIntrinsicID);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(uint64_t);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        uint64_t arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        renderscript->scriptIntrinsicCreate(arg0, arg1);
-        return 0;
-    } else {
-        cerr << "No such function: " << target_func << endl;
-        exit(1);
-    }
+    // forks here, once the service is got.
+    fork_server.BeginInput();
+    remote_coverage.BeginInput();
+    FuzzDataCursor cursor(data, size);
+    FuzzInput(renderscript, cursor);
+    remote_coverage.EndInput();
+    return 0;
+}
+
+// Sets the enums and the masks of the input to valid values, or lets libFuzzer
+// mutate the input.
+extern "C" size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t size, size_t max_size, unsigned int seed) {
+    return MutateFuzzInput(data, size, max_size, seed, [](FuzzDataCursor &cursor) {
+        static ::android::sp<IContext> no_hal;
+        FuzzInput(no_hal, cursor);
+    });
 }
 
 }  // namespace vts
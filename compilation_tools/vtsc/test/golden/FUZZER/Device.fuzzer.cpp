@@ -3,6 +3,9 @@
 #include <iostream>
 
 #include "FuncFuzzerUtils.h"
+#include "utils/FuzzDecodeUtil.h"
+#include "utils/FuzzForkServer.h"
+#include "utils/FuzzRemoteCoverage.h"
 #include <android/hardware/renderscript/1.0/IDevice.h>
 
 using std::cerr;
@@ -16,11 +19,68 @@ namespace android {
 namespace vts {
 
 static string target_func;
+static FuzzForkServer fork_server;
+static FuzzRemoteCoverage remote_coverage;
+
+// Fuzzes one function of the HAL with the input at data, and consumes it.
+// Returns false if the input is too short.
+typedef bool (*FuzzFunc)(::android::sp<IDevice> &hal, FuzzDataCursor &cursor);
+
+static bool Fuzz_contextCreate(::android::sp<IDevice> &renderscript, FuzzDataCursor &cursor) {
+    static uint32_t arg0;
+    if (!DecodeFuzzValue(cursor, &arg0)) { return false; }
+    static ::android::hardware::renderscript::V1_0::ContextType arg1;
+    if (!DecodeFuzzValue(cursor, &arg1)) { return false; }
+    static int32_t arg2;
+    if (!DecodeFuzzValue(cursor, &arg2)) { return false; }
+    // only decodes the input for the custom mutator.
+    if (renderscript == nullptr) { return true; }
+
+    renderscript->contextCreate(arg0, arg1, arg2);
+    return true;
+}
+
+// the functions to fuzz, indexed by the first byte of each call in the input
+// when fuzzing sequences of all the functions.
+static const struct {
+    const char *name;
+    FuzzFunc func;
+} kFuzzFuncs[] = {
+    {"contextCreate", Fuzz_contextCreate},
+};
+static const size_t kNumFuzzFuncs = sizeof(kFuzzFuncs) / sizeof(kFuzzFuncs[0]);
+
+// the function to fuzz, nullptr to fuzz sequences of all the functions.
+static FuzzFunc target_fuzz_func = nullptr;
+
+// Fuzzes the HAL with the whole input. Only decodes the input if hal is null.
+static void FuzzInput(::android::sp<IDevice> &hal, FuzzDataCursor &cursor) {
+    if (target_fuzz_func != nullptr) {
+        target_fuzz_func(hal, cursor);
+        return;
+    }
+    // Each call is a byte selecting the function, followed by its arguments.
+    uint8_t index;
+    while (cursor.ConsumeBytes(&index, sizeof(index))) {
+        FuzzFunc fuzz_func = kFuzzFuncs[index % kNumFuzzFuncs].func;
+        if (!fuzz_func(hal, cursor)) { break; }
+    }
+}
 
 extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    fork_server.ExtractBatchSize(argc, argv);
+    remote_coverage.ExtractAndMap(argc, argv);
     FuncFuzzerParams params{ExtractFuncFuzzerParams(*argc, *argv)};
     target_func = params.target_func_;
-    return 0;
+    if (target_func.empty()) { return 0; }
+    for (const auto &fuzz_func : kFuzzFuncs) {
+        if (target_func == fuzz_func.name) {
+            target_fuzz_func = fuzz_func.func;
+            return 0;
+        }
+    }
+    cerr << "No such function: " << target_func << endl;
+    exit(1);
 }
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
@@ -30,34 +90,22 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
         exit(1);
     }
 
-    if (target_func == "contextCreate") {
-        size_t type_size0 = sizeof(uint32_t);
-        if (size < type_size0) { return 0; }
-        size -= type_size0;
-        uint32_t arg0;
-        memcpy(&arg0, data, type_size0);
-        data += type_size0;
-
-        size_t type_size1 = sizeof(::android::hardware::renderscript::V1_0::ContextType);
-        if (size < type_size1) { return 0; }
-        size -= type_size1;
-        ::android::hardware::renderscript::V1_0::ContextType arg1;
-        memcpy(&arg1, data, type_size1);
-        data += type_size1;
-
-        size_t type_size2 = sizeof(int32_t);
-        if (size < type_size2) { return 0; }
-        size -= type_size2;
-        int32_t arg2;
-        memcpy(&arg2, data, type_size2);
-        data += type_size2;
-
-        renderscript->contextCreate(arg0, arg1, arg2);
-        return 0;
-    } else {
-        cerr << "No such function: " << target_func << endl;
-        exit(1);
-    }
+    // forks here, once the service is got.
+    fork_server.BeginInput();
+    remote_coverage.BeginInput();
+    FuzzDataCursor cursor(data, size);
+    FuzzInput(renderscript, cursor);
+    remote_coverage.EndInput();
+    return 0;
+}
+
+// Sets the enums and the masks of the input to valid values, or lets libFuzzer
+// mutate the input.
+extern "C" size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t size, size_t max_size, unsigned int seed) {
+    return MutateFuzzInput(data, size, max_size, seed, [](FuzzDataCursor &cursor) {
+        static ::android::sp<IDevice> no_hal;
+        FuzzInput(no_hal, cursor);
+    });
 }
 
 }  // namespace vts
@@ -0,0 +1,70 @@
+// This file was auto-generated by VTS compiler.
+
+#include <iostream>
+
+#include "FuncFuzzerUtils.h"
+#include "utils/FuzzDecodeUtil.h"
+#include "utils/FuzzForkServer.h"
+#include "utils/FuzzRemoteCoverage.h"
+#include <android/hardware/renderscript/1.0/IDevice.h>
+
+using std::cerr;
+using std::endl;
+using std::string;
+
+using namespace ::android::hardware::renderscript::V1_0;
+using namespace ::android::hardware;
+
+namespace android {
+namespace vts {
+
+static string target_func;
+static FuzzForkServer fork_server;
+static FuzzRemoteCoverage remote_coverage;
+
+// Fuzzes one function of the HAL with the input at data, and consumes it.
+// Returns false if the input is too short.
+typedef bool (*FuzzFunc)(::android::sp<IDevice> &hal, FuzzDataCursor &cursor);
+
+// Fuzzes the HAL with the whole input. Only decodes the input if hal is null.
+static void FuzzInput(::android::sp<IDevice> &hal __attribute__((__unused__)), FuzzDataCursor &cursor __attribute__((__unused__))) {
+    // the interface has no function to call.
+}
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    fork_server.ExtractBatchSize(argc, argv);
+    remote_coverage.ExtractAndMap(argc, argv);
+    FuncFuzzerParams params{ExtractFuncFuzzerParams(*argc, *argv)};
+    target_func = params.target_func_;
+    if (target_func.empty()) { return 0; }
+    cerr << "No such function: " << target_func << endl;
+    exit(1);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static ::android::sp<IDevice> renderscript = IDevice::getService(true);
+    if (renderscript == nullptr) {
+        cerr << "IDevice::getService() failed" << endl;
+        exit(1);
+    }
+
+    // forks here, once the service is got.
+    fork_server.BeginInput();
+    remote_coverage.BeginInput();
+    FuzzDataCursor cursor(data, size);
+    FuzzInput(renderscript, cursor);
+    remote_coverage.EndInput();
+    return 0;
+}
+
+// Sets the enums and the masks of the input to valid values, or lets libFuzzer
+// mutate the input.
+extern "C" size_t LLVMFuzzerCustomMutator(uint8_t *data, size_t size, size_t max_size, unsigned int seed) {
+    return MutateFuzzInput(data, size, max_size, seed, [](FuzzDataCursor &cursor) {
+        static ::android::sp<IDevice> no_hal;
+        FuzzInput(no_hal, cursor);
+    });
+}
+
+}  // namespace vts
+}  // namespace android
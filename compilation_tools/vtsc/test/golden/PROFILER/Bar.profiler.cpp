@@ -1,8 +1,5 @@
 #include "android/hardware/tests/bar/1.0/Bar.vts.h"
 #include <cutils/properties.h>
-#include <cutils/ashmem.h>
-#include <fcntl.h>
-#include <sys/stat.h>
 
 using namespace android::hardware::tests::bar::V1_0;
 using namespace android::hardware;
@@ -30,2020 +27,2277 @@ void HIDL_INSTRUMENTATION_FUNCTION_android_hardware_tests_bar_V1_0_IBar(
     if (strcmp(package, "android.hardware.tests.bar") != 0) {
         LOG(WARNING) << "incorrect package. Expect: android.hardware.tests.bar actual: " << package;
     }
-    std::string version_str = std::string(version);
-    int major_version = stoi(version_str.substr(0, version_str.find('.')));
-    int minor_version = stoi(version_str.substr(version_str.find('.') + 1));
-    if (major_version != 1 || minor_version > 0) {
+    VtsProfilingInterface& profiler = VtsProfilingInterface::getInstance(TRACEFILEPREFIX);
+    const VtsProfilingInterface::HalDescriptor* hal = profiler.GetHalDescriptor(package, version, interface);
+    if (hal == nullptr) {
+        LOG(ERROR) << "failed to register HAL: " << package << "@" << version << "::" << interface;
+        return;
+    }
+    if (hal->version_major != 1 || hal->version_minor > 0) {
         LOG(WARNING) << "incorrect version. Expect: 1.0 or lower (if version != x.0), actual: " << version;
     }
     if (strcmp(interface, "IBar") != 0) {
         LOG(WARNING) << "incorrect interface. Expect: IBar actual: " << interface;
     }
+    if (!profiler.ShouldTraceEvent(event, hal, method)) {
+        return;
+    }
 
-    VtsProfilingInterface& profiler = VtsProfilingInterface::getInstance(TRACEFILEPREFIX);
-
-    bool profiling_for_args = property_get_bool("hal.instrumentation.profile.args", true);
-    if (strcmp(method, "convertToBoolIfSmall") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("convertToBoolIfSmall");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 2) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 2, actual: " << (*args).size() << ", method name: convertToBoolIfSmall, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::Discriminator *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::Discriminator*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ENUM);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__Discriminator(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Union> *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Union>*> ((*args)[1]);
-                        if (arg_val_1 != nullptr) {
-                            arg_1->set_type(TYPE_VECTOR);
-                            arg_1->set_vector_size((*arg_val_1).size());
-                            for (int arg_1_index = 0; arg_1_index < (int)(*arg_val_1).size(); arg_1_index++) {
-                                auto *arg_1_vector_arg_1_index __attribute__((__unused__)) = arg_1->add_vector_value();
-                                arg_1_vector_arg_1_index->set_type(TYPE_UNION);
-                                profile____android__hardware__tests__foo__V1_0__IFoo__Union(arg_1_vector_arg_1_index, (*arg_val_1)[arg_1_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 1 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: convertToBoolIfSmall, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::ContainsUnion> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::ContainsUnion>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_STRUCT);
-                                profile____android__hardware__tests__foo__V1_0__IFoo__ContainsUnion(result_0_vector_result_0_index, (*result_val_0)[result_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+    bool profiling_for_args = profiler.IsProfilingArgsEnabled();
+    switch (VtsProfilingInterface::HashMethodName(method)) {
+        case VtsProfilingInterface::HashMethodName("convertToBoolIfSmall"):
+        {
+            if (strcmp(method, "convertToBoolIfSmall") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("convertToBoolIfSmall");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "convertToBoolIfSmall");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 2) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 2, actual: " << (*args).size() << ", method name: convertToBoolIfSmall, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::Discriminator *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::Discriminator*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_ENUM);
+                                    profile____android__hardware__tests__foo__V1_0__IFoo__Discriminator(arg_0, (*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Union> *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Union>*> ((*args)[1]);
+                                if (arg_val_1 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_1->set_type(TYPE_VECTOR);
+                                        arg_1->set_vector_size((*arg_val_1).size());
+                                    } else {
+                                        arg_1->set_type(TYPE_VECTOR);
+                                        arg_1->set_vector_size((*arg_val_1).size());
+                                        for (int arg_1_index = 0; arg_1_index < (int)(*arg_val_1).size(); arg_1_index++) {
+                                            auto *arg_1_vector_arg_1_index __attribute__((__unused__)) = arg_1->add_vector_value();
+                                            arg_1_vector_arg_1_index->set_type(TYPE_UNION);
+                                            profile____android__hardware__tests__foo__V1_0__IFoo__Union(arg_1_vector_arg_1_index, (*arg_val_1)[arg_1_index]);
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 1 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: convertToBoolIfSmall, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::ContainsUnion> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::ContainsUnion>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
+                                            auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_vector_result_0_index->set_type(TYPE_STRUCT);
+                                            profile____android__hardware__tests__foo__V1_0__IFoo__ContainsUnion(result_0_vector_result_0_index, (*result_val_0)[result_0_index]);
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "doThis") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("doThis");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: doThis, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        float *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<float*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_SCALAR);
-                            arg_0->mutable_scalar_value()->set_float_t((*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: doThis, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("doThis"):
+        {
+            if (strcmp(method, "doThis") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("doThis");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "doThis");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: doThis, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                float *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<float*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_SCALAR);
+                                    arg_0->mutable_scalar_value()->set_float_t((*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: doThis, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "doThatAndReturnSomething") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("doThatAndReturnSomething");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: doThatAndReturnSomething, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        int64_t *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<int64_t*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_SCALAR);
-                            arg_0->mutable_scalar_value()->set_int64_t((*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doThatAndReturnSomething, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        int32_t *result_val_0 __attribute__((__unused__)) = reinterpret_cast<int32_t*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_SCALAR);
-                            result_0->mutable_scalar_value()->set_int32_t((*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("doThatAndReturnSomething"):
+        {
+            if (strcmp(method, "doThatAndReturnSomething") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("doThatAndReturnSomething");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "doThatAndReturnSomething");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: doThatAndReturnSomething, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                int64_t *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<int64_t*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_SCALAR);
+                                    arg_0->mutable_scalar_value()->set_int64_t((*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doThatAndReturnSomething, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                int32_t *result_val_0 __attribute__((__unused__)) = reinterpret_cast<int32_t*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_SCALAR);
+                                    result_0->mutable_scalar_value()->set_int32_t((*result_val_0));
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "doQuiteABit") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("doQuiteABit");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 4) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 4, actual: " << (*args).size() << ", method name: doQuiteABit, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        int32_t *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<int32_t*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_SCALAR);
-                            arg_0->mutable_scalar_value()->set_int32_t((*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
-                        int64_t *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<int64_t*> ((*args)[1]);
-                        if (arg_val_1 != nullptr) {
-                            arg_1->set_type(TYPE_SCALAR);
-                            arg_1->mutable_scalar_value()->set_int64_t((*arg_val_1));
-                        } else {
-                            LOG(WARNING) << "argument 1 is null.";
-                        }
-                        auto *arg_2 __attribute__((__unused__)) = msg.add_arg();
-                        float *arg_val_2 __attribute__((__unused__)) = reinterpret_cast<float*> ((*args)[2]);
-                        if (arg_val_2 != nullptr) {
-                            arg_2->set_type(TYPE_SCALAR);
-                            arg_2->mutable_scalar_value()->set_float_t((*arg_val_2));
-                        } else {
-                            LOG(WARNING) << "argument 2 is null.";
-                        }
-                        auto *arg_3 __attribute__((__unused__)) = msg.add_arg();
-                        double *arg_val_3 __attribute__((__unused__)) = reinterpret_cast<double*> ((*args)[3]);
-                        if (arg_val_3 != nullptr) {
-                            arg_3->set_type(TYPE_SCALAR);
-                            arg_3->mutable_scalar_value()->set_double_t((*arg_val_3));
-                        } else {
-                            LOG(WARNING) << "argument 3 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doQuiteABit, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        double *result_val_0 __attribute__((__unused__)) = reinterpret_cast<double*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_SCALAR);
-                            result_0->mutable_scalar_value()->set_double_t((*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("doQuiteABit"):
+        {
+            if (strcmp(method, "doQuiteABit") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("doQuiteABit");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "doQuiteABit");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 4) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 4, actual: " << (*args).size() << ", method name: doQuiteABit, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                int32_t *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<int32_t*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_SCALAR);
+                                    arg_0->mutable_scalar_value()->set_int32_t((*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
+                                int64_t *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<int64_t*> ((*args)[1]);
+                                if (arg_val_1 != nullptr) {
+                                    arg_1->set_type(TYPE_SCALAR);
+                                    arg_1->mutable_scalar_value()->set_int64_t((*arg_val_1));
+                                } else {
+                                    LOG(WARNING) << "argument 1 is null.";
+                                }
+                                auto *arg_2 __attribute__((__unused__)) = msg.add_arg();
+                                float *arg_val_2 __attribute__((__unused__)) = reinterpret_cast<float*> ((*args)[2]);
+                                if (arg_val_2 != nullptr) {
+                                    arg_2->set_type(TYPE_SCALAR);
+                                    arg_2->mutable_scalar_value()->set_float_t((*arg_val_2));
+                                } else {
+                                    LOG(WARNING) << "argument 2 is null.";
+                                }
+                                auto *arg_3 __attribute__((__unused__)) = msg.add_arg();
+                                double *arg_val_3 __attribute__((__unused__)) = reinterpret_cast<double*> ((*args)[3]);
+                                if (arg_val_3 != nullptr) {
+                                    arg_3->set_type(TYPE_SCALAR);
+                                    arg_3->mutable_scalar_value()->set_double_t((*arg_val_3));
+                                } else {
+                                    LOG(WARNING) << "argument 3 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doQuiteABit, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                double *result_val_0 __attribute__((__unused__)) = reinterpret_cast<double*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_SCALAR);
+                                    result_0->mutable_scalar_value()->set_double_t((*result_val_0));
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "doSomethingElse") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("doSomethingElse");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: doSomethingElse, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_array<int32_t, 15> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<int32_t, 15>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ARRAY);
-                            arg_0->set_vector_size(15);
-                            for (int arg_0_index = 0; arg_0_index < 15; arg_0_index++) {
-                                auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_array_arg_0_index->set_type(TYPE_SCALAR);
-                                arg_0_array_arg_0_index->mutable_scalar_value()->set_int32_t((*arg_val_0)[arg_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doSomethingElse, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_array<int32_t, 32> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<int32_t, 32>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_ARRAY);
-                            result_0->set_vector_size(32);
-                            for (int result_0_index = 0; result_0_index < 32; result_0_index++) {
-                                auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_array_result_0_index->set_type(TYPE_SCALAR);
-                                result_0_array_result_0_index->mutable_scalar_value()->set_int32_t((*result_val_0)[result_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("doSomethingElse"):
+        {
+            if (strcmp(method, "doSomethingElse") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("doSomethingElse");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "doSomethingElse");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: doSomethingElse, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_array<int32_t, 15> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<int32_t, 15>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(15);
+                                    } else {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(15);
+                                        arg_0->set_scalar_type("int32_t");
+                                        arg_0->set_vector_raw_value(&(*arg_val_0)[0], GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize(15, sizeof((*arg_val_0)[0])), sizeof((*arg_val_0)[0])));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doSomethingElse, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_array<int32_t, 32> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<int32_t, 32>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(32);
+                                    } else {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(32);
+                                        result_0->set_scalar_type("int32_t");
+                                        result_0->set_vector_raw_value(&(*result_val_0)[0], GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize(32, sizeof((*result_val_0)[0])), sizeof((*result_val_0)[0])));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "doStuffAndReturnAString") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("doStuffAndReturnAString");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: doStuffAndReturnAString, event type: " << event;
-                            break;
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doStuffAndReturnAString, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_string *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_string*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_STRING);
-                            result_0->mutable_string_value()->set_message((*result_val_0).c_str());
-                            result_0->mutable_string_value()->set_length((*result_val_0).size());
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("doStuffAndReturnAString"):
+        {
+            if (strcmp(method, "doStuffAndReturnAString") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("doStuffAndReturnAString");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "doStuffAndReturnAString");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: doStuffAndReturnAString, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: doStuffAndReturnAString, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_string *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_string*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_STRING);
+                                    result_0->mutable_string_value()->set_message((*result_val_0).c_str());
+                                    result_0->mutable_string_value()->set_length((*result_val_0).size());
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "mapThisVector") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("mapThisVector");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: mapThisVector, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<int32_t> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<int32_t>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_VECTOR);
-                            arg_0->set_vector_size((*arg_val_0).size());
-                            for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
-                                auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_vector_arg_0_index->set_type(TYPE_SCALAR);
-                                arg_0_vector_arg_0_index->mutable_scalar_value()->set_int32_t((*arg_val_0)[arg_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: mapThisVector, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<int32_t> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<int32_t>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_SCALAR);
-                                result_0_vector_result_0_index->mutable_scalar_value()->set_int32_t((*result_val_0)[result_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("mapThisVector"):
+        {
+            if (strcmp(method, "mapThisVector") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("mapThisVector");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "mapThisVector");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: mapThisVector, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<int32_t> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<int32_t>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                    } else {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                        arg_0->set_scalar_type("int32_t");
+                                        arg_0->set_vector_raw_value((*arg_val_0).data(), GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize((*arg_val_0).size(), sizeof((*arg_val_0)[0])), sizeof((*arg_val_0)[0])));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: mapThisVector, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<int32_t> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<int32_t>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        result_0->set_scalar_type("int32_t");
+                                        result_0->set_vector_raw_value((*result_val_0).data(), GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize((*result_val_0).size(), sizeof((*result_val_0)[0])), sizeof((*result_val_0)[0])));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "callMe") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("callMe");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: callMe, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        sp<::android::hardware::tests::foo::V1_0::IFooCallback> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::IFooCallback>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_HIDL_CALLBACK);
-                            arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFooCallback");
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: callMe, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("callMe"):
+        {
+            if (strcmp(method, "callMe") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("callMe");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "callMe");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: callMe, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                sp<::android::hardware::tests::foo::V1_0::IFooCallback> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::IFooCallback>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_HIDL_CALLBACK);
+                                    arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFooCallback");
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: callMe, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "useAnEnum") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("useAnEnum");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: useAnEnum, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::SomeEnum*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ENUM);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__SomeEnum(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: useAnEnum, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::SomeEnum*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_ENUM);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__SomeEnum(result_0, (*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("useAnEnum"):
+        {
+            if (strcmp(method, "useAnEnum") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("useAnEnum");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "useAnEnum");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: useAnEnum, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::SomeEnum*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_ENUM);
+                                    profile____android__hardware__tests__foo__V1_0__IFoo__SomeEnum(arg_0, (*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: useAnEnum, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::tests::foo::V1_0::IFoo::SomeEnum *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::SomeEnum*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_ENUM);
+                                    profile____android__hardware__tests__foo__V1_0__IFoo__SomeEnum(result_0, (*result_val_0));
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAGooberVec") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAGooberVec");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAGooberVec, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Goober> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Goober>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_VECTOR);
-                            arg_0->set_vector_size((*arg_val_0).size());
-                            for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
-                                auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_vector_arg_0_index->set_type(TYPE_STRUCT);
-                                profile____android__hardware__tests__foo__V1_0__IFoo__Goober(arg_0_vector_arg_0_index, (*arg_val_0)[arg_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveAGooberVec, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("haveAGooberVec"):
+        {
+            if (strcmp(method, "haveAGooberVec") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAGooberVec");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAGooberVec");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAGooberVec, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Goober> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::tests::foo::V1_0::IFoo::Goober>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                    } else {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                        for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
+                                            auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_vector_arg_0_index->set_type(TYPE_STRUCT);
+                                            profile____android__hardware__tests__foo__V1_0__IFoo__Goober(arg_0_vector_arg_0_index, (*arg_val_0)[arg_0_index]);
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveAGooberVec, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAGoober") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAGoober");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAGoober, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::Goober *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::Goober*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__Goober(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveAGoober, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("haveAGoober"):
+        {
+            if (strcmp(method, "haveAGoober") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAGoober");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAGoober");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAGoober, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::Goober *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::Goober*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::Goober");
+                                    } else {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__Goober(arg_0, (*arg_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveAGoober, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAGooberArray") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAGooberArray");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAGooberArray, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_array<::android::hardware::tests::foo::V1_0::IFoo::Goober, 20> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::tests::foo::V1_0::IFoo::Goober, 20>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ARRAY);
-                            arg_0->set_vector_size(20);
-                            for (int arg_0_index = 0; arg_0_index < 20; arg_0_index++) {
-                                auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_array_arg_0_index->set_type(TYPE_STRUCT);
-                                auto *arg_0_array_arg_0_index_q __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
-                                arg_0_array_arg_0_index_q->set_type(TYPE_SCALAR);
-                                arg_0_array_arg_0_index_q->mutable_scalar_value()->set_int32_t((*arg_val_0)[arg_0_index].q);
-                                auto *arg_0_array_arg_0_index_name __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
-                                arg_0_array_arg_0_index_name->set_type(TYPE_STRING);
-                                arg_0_array_arg_0_index_name->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].name.c_str());
-                                arg_0_array_arg_0_index_name->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].name.size());
-                                auto *arg_0_array_arg_0_index_address __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
-                                arg_0_array_arg_0_index_address->set_type(TYPE_STRING);
-                                arg_0_array_arg_0_index_address->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].address.c_str());
-                                arg_0_array_arg_0_index_address->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].address.size());
-                                auto *arg_0_array_arg_0_index_numbers __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
-                                arg_0_array_arg_0_index_numbers->set_type(TYPE_ARRAY);
-                                arg_0_array_arg_0_index_numbers->set_vector_size(10);
-                                for (int arg_0_array_arg_0_index_numbers_index = 0; arg_0_array_arg_0_index_numbers_index < 10; arg_0_array_arg_0_index_numbers_index++) {
-                                    auto *arg_0_array_arg_0_index_numbers_array_arg_0_array_arg_0_index_numbers_index __attribute__((__unused__)) = arg_0_array_arg_0_index_numbers->add_vector_value();
-                                    arg_0_array_arg_0_index_numbers_array_arg_0_array_arg_0_index_numbers_index->set_type(TYPE_SCALAR);
-                                    arg_0_array_arg_0_index_numbers_array_arg_0_array_arg_0_index_numbers_index->mutable_scalar_value()->set_double_t((*arg_val_0)[arg_0_index].numbers[arg_0_array_arg_0_index_numbers_index]);
-                                }
-                                auto *arg_0_array_arg_0_index_fumble __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
-                                arg_0_array_arg_0_index_fumble->set_type(TYPE_STRUCT);
-                                profile____android__hardware__tests__foo__V1_0__IFoo__Fumble(arg_0_array_arg_0_index_fumble, (*arg_val_0)[arg_0_index].fumble);
-                                auto *arg_0_array_arg_0_index_gumble __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
-                                arg_0_array_arg_0_index_gumble->set_type(TYPE_STRUCT);
-                                profile____android__hardware__tests__foo__V1_0__IFoo__Fumble(arg_0_array_arg_0_index_gumble, (*arg_val_0)[arg_0_index].gumble);
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveAGooberArray, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("haveAGooberArray"):
+        {
+            if (strcmp(method, "haveAGooberArray") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAGooberArray");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAGooberArray");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAGooberArray, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_array<::android::hardware::tests::foo::V1_0::IFoo::Goober, 20> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::tests::foo::V1_0::IFoo::Goober, 20>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(20);
+                                    } else {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(20);
+                                        for (int arg_0_index = 0; arg_0_index < 20; arg_0_index++) {
+                                            auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_array_arg_0_index->set_type(TYPE_STRUCT);
+                                            auto *arg_0_array_arg_0_index_q __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
+                                            arg_0_array_arg_0_index_q->set_type(TYPE_SCALAR);
+                                            arg_0_array_arg_0_index_q->mutable_scalar_value()->set_int32_t((*arg_val_0)[arg_0_index].q);
+                                            auto *arg_0_array_arg_0_index_name __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
+                                            arg_0_array_arg_0_index_name->set_type(TYPE_STRING);
+                                            arg_0_array_arg_0_index_name->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].name.c_str());
+                                            arg_0_array_arg_0_index_name->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].name.size());
+                                            auto *arg_0_array_arg_0_index_address __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
+                                            arg_0_array_arg_0_index_address->set_type(TYPE_STRING);
+                                            arg_0_array_arg_0_index_address->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].address.c_str());
+                                            arg_0_array_arg_0_index_address->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].address.size());
+                                            auto *arg_0_array_arg_0_index_numbers __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
+                                            arg_0_array_arg_0_index_numbers->set_type(TYPE_ARRAY);
+                                            arg_0_array_arg_0_index_numbers->set_vector_size(10);
+                                            arg_0_array_arg_0_index_numbers->set_scalar_type("double_t");
+                                            arg_0_array_arg_0_index_numbers->set_vector_raw_value(&(*arg_val_0)[arg_0_index].numbers[0], GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize(10, sizeof((*arg_val_0)[arg_0_index].numbers[0])), sizeof((*arg_val_0)[arg_0_index].numbers[0])));
+                                            auto *arg_0_array_arg_0_index_fumble __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
+                                            arg_0_array_arg_0_index_fumble->set_type(TYPE_STRUCT);
+                                            profile____android__hardware__tests__foo__V1_0__IFoo__Fumble(arg_0_array_arg_0_index_fumble, (*arg_val_0)[arg_0_index].fumble);
+                                            auto *arg_0_array_arg_0_index_gumble __attribute__((__unused__)) = arg_0_array_arg_0_index->add_struct_value();
+                                            arg_0_array_arg_0_index_gumble->set_type(TYPE_STRUCT);
+                                            profile____android__hardware__tests__foo__V1_0__IFoo__Fumble(arg_0_array_arg_0_index_gumble, (*arg_val_0)[arg_0_index].gumble);
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveAGooberArray, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveATypeFromAnotherFile") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveATypeFromAnotherFile");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveATypeFromAnotherFile, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::Abc *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::Abc*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__Abc(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveATypeFromAnotherFile, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("haveATypeFromAnotherFile"):
+        {
+            if (strcmp(method, "haveATypeFromAnotherFile") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveATypeFromAnotherFile");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveATypeFromAnotherFile");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveATypeFromAnotherFile, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::Abc *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::Abc*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::Abc");
+                                    } else {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__Abc(arg_0, (*arg_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: haveATypeFromAnotherFile, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveSomeStrings") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveSomeStrings");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveSomeStrings, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_array<::android::hardware::hidl_string, 3> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 3>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ARRAY);
-                            arg_0->set_vector_size(3);
-                            for (int arg_0_index = 0; arg_0_index < 3; arg_0_index++) {
-                                auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_array_arg_0_index->set_type(TYPE_STRING);
-                                arg_0_array_arg_0_index->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].c_str());
-                                arg_0_array_arg_0_index->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].size());
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveSomeStrings, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_array<::android::hardware::hidl_string, 2> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 2>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_ARRAY);
-                            result_0->set_vector_size(2);
-                            for (int result_0_index = 0; result_0_index < 2; result_0_index++) {
-                                auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_array_result_0_index->set_type(TYPE_STRING);
-                                result_0_array_result_0_index->mutable_string_value()->set_message((*result_val_0)[result_0_index].c_str());
-                                result_0_array_result_0_index->mutable_string_value()->set_length((*result_val_0)[result_0_index].size());
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("haveSomeStrings"):
+        {
+            if (strcmp(method, "haveSomeStrings") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveSomeStrings");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveSomeStrings");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveSomeStrings, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_array<::android::hardware::hidl_string, 3> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 3>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(3);
+                                    } else {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(3);
+                                        for (int arg_0_index = 0; arg_0_index < 3; arg_0_index++) {
+                                            auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_array_arg_0_index->set_type(TYPE_STRING);
+                                            arg_0_array_arg_0_index->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].c_str());
+                                            arg_0_array_arg_0_index->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].size());
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveSomeStrings, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_array<::android::hardware::hidl_string, 2> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 2>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(2);
+                                    } else {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(2);
+                                        for (int result_0_index = 0; result_0_index < 2; result_0_index++) {
+                                            auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_array_result_0_index->set_type(TYPE_STRING);
+                                            result_0_array_result_0_index->mutable_string_value()->set_message((*result_val_0)[result_0_index].c_str());
+                                            result_0_array_result_0_index->mutable_string_value()->set_length((*result_val_0)[result_0_index].size());
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAStringVec") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAStringVec");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAStringVec, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<::android::hardware::hidl_string> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_string>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_VECTOR);
-                            arg_0->set_vector_size((*arg_val_0).size());
-                            for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
-                                auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_vector_arg_0_index->set_type(TYPE_STRING);
-                                arg_0_vector_arg_0_index->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].c_str());
-                                arg_0_vector_arg_0_index->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].size());
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAStringVec, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<::android::hardware::hidl_string> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_string>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_STRING);
-                                result_0_vector_result_0_index->mutable_string_value()->set_message((*result_val_0)[result_0_index].c_str());
-                                result_0_vector_result_0_index->mutable_string_value()->set_length((*result_val_0)[result_0_index].size());
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("haveAStringVec"):
+        {
+            if (strcmp(method, "haveAStringVec") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAStringVec");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAStringVec");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAStringVec, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<::android::hardware::hidl_string> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_string>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                    } else {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                        for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
+                                            auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_vector_arg_0_index->set_type(TYPE_STRING);
+                                            arg_0_vector_arg_0_index->mutable_string_value()->set_message((*arg_val_0)[arg_0_index].c_str());
+                                            arg_0_vector_arg_0_index->mutable_string_value()->set_length((*arg_val_0)[arg_0_index].size());
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAStringVec, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<::android::hardware::hidl_string> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_string>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
+                                            auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_vector_result_0_index->set_type(TYPE_STRING);
+                                            result_0_vector_result_0_index->mutable_string_value()->set_message((*result_val_0)[result_0_index].c_str());
+                                            result_0_vector_result_0_index->mutable_string_value()->set_length((*result_val_0)[result_0_index].size());
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "transposeMe") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("transposeMe");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: transposeMe, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_array<float, 3, 5> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<float, 3, 5>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ARRAY);
-                            arg_0->set_vector_size(3);
-                            for (int arg_0_index = 0; arg_0_index < 3; arg_0_index++) {
-                                auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_array_arg_0_index->set_type(TYPE_ARRAY);
-                                arg_0_array_arg_0_index->set_vector_size(5);
-                                for (int arg_0_array_arg_0_index_index = 0; arg_0_array_arg_0_index_index < 5; arg_0_array_arg_0_index_index++) {
-                                    auto *arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index __attribute__((__unused__)) = arg_0_array_arg_0_index->add_vector_value();
-                                    arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->set_type(TYPE_SCALAR);
-                                    arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->mutable_scalar_value()->set_float_t((*arg_val_0)[arg_0_index][arg_0_array_arg_0_index_index]);
-                                }
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: transposeMe, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_array<float, 5, 3> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<float, 5, 3>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_ARRAY);
-                            result_0->set_vector_size(5);
-                            for (int result_0_index = 0; result_0_index < 5; result_0_index++) {
-                                auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_array_result_0_index->set_type(TYPE_ARRAY);
-                                result_0_array_result_0_index->set_vector_size(3);
-                                for (int result_0_array_result_0_index_index = 0; result_0_array_result_0_index_index < 3; result_0_array_result_0_index_index++) {
-                                    auto *result_0_array_result_0_index_array_result_0_array_result_0_index_index __attribute__((__unused__)) = result_0_array_result_0_index->add_vector_value();
-                                    result_0_array_result_0_index_array_result_0_array_result_0_index_index->set_type(TYPE_SCALAR);
-                                    result_0_array_result_0_index_array_result_0_array_result_0_index_index->mutable_scalar_value()->set_float_t((*result_val_0)[result_0_index][result_0_array_result_0_index_index]);
-                                }
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("transposeMe"):
+        {
+            if (strcmp(method, "transposeMe") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("transposeMe");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "transposeMe");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: transposeMe, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_array<float, 3, 5> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<float, 3, 5>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(3);
+                                    } else {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(3);
+                                        for (int arg_0_index = 0; arg_0_index < 3; arg_0_index++) {
+                                            auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_array_arg_0_index->set_type(TYPE_ARRAY);
+                                            arg_0_array_arg_0_index->set_vector_size(5);
+                                            arg_0_array_arg_0_index->set_scalar_type("float_t");
+                                            arg_0_array_arg_0_index->set_vector_raw_value(&(*arg_val_0)[arg_0_index][0], GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize(5, sizeof((*arg_val_0)[arg_0_index][0])), sizeof((*arg_val_0)[arg_0_index][0])));
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: transposeMe, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_array<float, 5, 3> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<float, 5, 3>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(5);
+                                    } else {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(5);
+                                        for (int result_0_index = 0; result_0_index < 5; result_0_index++) {
+                                            auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_array_result_0_index->set_type(TYPE_ARRAY);
+                                            result_0_array_result_0_index->set_vector_size(3);
+                                            result_0_array_result_0_index->set_scalar_type("float_t");
+                                            result_0_array_result_0_index->set_vector_raw_value(&(*result_val_0)[result_0_index][0], GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize(3, sizeof((*result_val_0)[result_0_index][0])), sizeof((*result_val_0)[result_0_index][0])));
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "callingDrWho") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("callingDrWho");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: callingDrWho, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: callingDrWho, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(result_0, (*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("callingDrWho"):
+        {
+            if (strcmp(method, "callingDrWho") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("callingDrWho");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "callingDrWho");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: callingDrWho, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional");
+                                    } else {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(arg_0, (*arg_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: callingDrWho, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        result_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::MultiDimensional");
+                                    } else {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__MultiDimensional(result_0, (*result_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "transpose") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("transpose");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3 *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__StringMatrix5x3(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5 *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__StringMatrix3x5(result_0, (*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("transpose"):
+        {
+            if (strcmp(method, "transpose") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("transpose");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "transpose");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3 *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::StringMatrix5x3");
+                                    } else {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__StringMatrix5x3(arg_0, (*arg_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5 *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        result_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::StringMatrix3x5");
+                                    } else {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__StringMatrix3x5(result_0, (*result_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "transpose2") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("transpose2");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose2, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_array<::android::hardware::hidl_string, 5, 3> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 5, 3>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ARRAY);
-                            arg_0->set_vector_size(5);
-                            for (int arg_0_index = 0; arg_0_index < 5; arg_0_index++) {
-                                auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_array_arg_0_index->set_type(TYPE_ARRAY);
-                                arg_0_array_arg_0_index->set_vector_size(3);
-                                for (int arg_0_array_arg_0_index_index = 0; arg_0_array_arg_0_index_index < 3; arg_0_array_arg_0_index_index++) {
-                                    auto *arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index __attribute__((__unused__)) = arg_0_array_arg_0_index->add_vector_value();
-                                    arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->set_type(TYPE_STRING);
-                                    arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->mutable_string_value()->set_message((*arg_val_0)[arg_0_index][arg_0_array_arg_0_index_index].c_str());
-                                    arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->mutable_string_value()->set_length((*arg_val_0)[arg_0_index][arg_0_array_arg_0_index_index].size());
-                                }
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose2, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_array<::android::hardware::hidl_string, 3, 5> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 3, 5>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_ARRAY);
-                            result_0->set_vector_size(3);
-                            for (int result_0_index = 0; result_0_index < 3; result_0_index++) {
-                                auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_array_result_0_index->set_type(TYPE_ARRAY);
-                                result_0_array_result_0_index->set_vector_size(5);
-                                for (int result_0_array_result_0_index_index = 0; result_0_array_result_0_index_index < 5; result_0_array_result_0_index_index++) {
-                                    auto *result_0_array_result_0_index_array_result_0_array_result_0_index_index __attribute__((__unused__)) = result_0_array_result_0_index->add_vector_value();
-                                    result_0_array_result_0_index_array_result_0_array_result_0_index_index->set_type(TYPE_STRING);
-                                    result_0_array_result_0_index_array_result_0_array_result_0_index_index->mutable_string_value()->set_message((*result_val_0)[result_0_index][result_0_array_result_0_index_index].c_str());
-                                    result_0_array_result_0_index_array_result_0_array_result_0_index_index->mutable_string_value()->set_length((*result_val_0)[result_0_index][result_0_array_result_0_index_index].size());
-                                }
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("transpose2"):
+        {
+            if (strcmp(method, "transpose2") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("transpose2");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "transpose2");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose2, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_array<::android::hardware::hidl_string, 5, 3> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 5, 3>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(5);
+                                    } else {
+                                        arg_0->set_type(TYPE_ARRAY);
+                                        arg_0->set_vector_size(5);
+                                        for (int arg_0_index = 0; arg_0_index < 5; arg_0_index++) {
+                                            auto *arg_0_array_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_array_arg_0_index->set_type(TYPE_ARRAY);
+                                            arg_0_array_arg_0_index->set_vector_size(3);
+                                            for (int arg_0_array_arg_0_index_index = 0; arg_0_array_arg_0_index_index < 3; arg_0_array_arg_0_index_index++) {
+                                                auto *arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index __attribute__((__unused__)) = arg_0_array_arg_0_index->add_vector_value();
+                                                arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->set_type(TYPE_STRING);
+                                                arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->mutable_string_value()->set_message((*arg_val_0)[arg_0_index][arg_0_array_arg_0_index_index].c_str());
+                                                arg_0_array_arg_0_index_array_arg_0_array_arg_0_index_index->mutable_string_value()->set_length((*arg_val_0)[arg_0_index][arg_0_array_arg_0_index_index].size());
+                                            }
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: transpose2, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_array<::android::hardware::hidl_string, 3, 5> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_array<::android::hardware::hidl_string, 3, 5>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(3);
+                                    } else {
+                                        result_0->set_type(TYPE_ARRAY);
+                                        result_0->set_vector_size(3);
+                                        for (int result_0_index = 0; result_0_index < 3; result_0_index++) {
+                                            auto *result_0_array_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_array_result_0_index->set_type(TYPE_ARRAY);
+                                            result_0_array_result_0_index->set_vector_size(5);
+                                            for (int result_0_array_result_0_index_index = 0; result_0_array_result_0_index_index < 5; result_0_array_result_0_index_index++) {
+                                                auto *result_0_array_result_0_index_array_result_0_array_result_0_index_index __attribute__((__unused__)) = result_0_array_result_0_index->add_vector_value();
+                                                result_0_array_result_0_index_array_result_0_array_result_0_index_index->set_type(TYPE_STRING);
+                                                result_0_array_result_0_index_array_result_0_array_result_0_index_index->mutable_string_value()->set_message((*result_val_0)[result_0_index][result_0_array_result_0_index_index].c_str());
+                                                result_0_array_result_0_index_array_result_0_array_result_0_index_index->mutable_string_value()->set_length((*result_val_0)[result_0_index][result_0_array_result_0_index_index].size());
+                                            }
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "sendVec") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("sendVec");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: sendVec, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<uint8_t> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<uint8_t>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_VECTOR);
-                            arg_0->set_vector_size((*arg_val_0).size());
-                            for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
-                                auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_vector_arg_0_index->set_type(TYPE_SCALAR);
-                                arg_0_vector_arg_0_index->mutable_scalar_value()->set_uint8_t((*arg_val_0)[arg_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: sendVec, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<uint8_t> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<uint8_t>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_SCALAR);
-                                result_0_vector_result_0_index->mutable_scalar_value()->set_uint8_t((*result_val_0)[result_0_index]);
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("sendVec"):
+        {
+            if (strcmp(method, "sendVec") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("sendVec");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "sendVec");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: sendVec, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<uint8_t> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<uint8_t>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                    } else {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                        arg_0->set_scalar_type("uint8_t");
+                                        arg_0->set_vector_raw_value((*arg_val_0).data(), GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize((*arg_val_0).size(), sizeof((*arg_val_0)[0])), sizeof((*arg_val_0)[0])));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: sendVec, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<uint8_t> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<uint8_t>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        result_0->set_scalar_type("uint8_t");
+                                        result_0->set_vector_raw_value((*result_val_0).data(), GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize((*result_val_0).size(), sizeof((*result_val_0)[0])), sizeof((*result_val_0)[0])));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "sendVecVec") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("sendVecVec");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: sendVecVec, event type: " << event;
-                            break;
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: sendVecVec, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<::android::hardware::hidl_vec<uint8_t>> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_vec<uint8_t>>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_VECTOR);
-                                result_0_vector_result_0_index->set_vector_size((*result_val_0)[result_0_index].size());
-                                for (int result_0_vector_result_0_index_index = 0; result_0_vector_result_0_index_index < (int)(*result_val_0)[result_0_index].size(); result_0_vector_result_0_index_index++) {
-                                    auto *result_0_vector_result_0_index_vector_result_0_vector_result_0_index_index __attribute__((__unused__)) = result_0_vector_result_0_index->add_vector_value();
-                                    result_0_vector_result_0_index_vector_result_0_vector_result_0_index_index->set_type(TYPE_SCALAR);
-                                    result_0_vector_result_0_index_vector_result_0_vector_result_0_index_index->mutable_scalar_value()->set_uint8_t((*result_val_0)[result_0_index][result_0_vector_result_0_index_index]);
-                                }
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("sendVecVec"):
+        {
+            if (strcmp(method, "sendVecVec") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("sendVecVec");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "sendVecVec");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: sendVecVec, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: sendVecVec, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<::android::hardware::hidl_vec<uint8_t>> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_vec<uint8_t>>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
+                                            auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_vector_result_0_index->set_type(TYPE_VECTOR);
+                                            result_0_vector_result_0_index->set_vector_size((*result_val_0)[result_0_index].size());
+                                            result_0_vector_result_0_index->set_scalar_type("uint8_t");
+                                            result_0_vector_result_0_index->set_vector_raw_value((*result_val_0)[result_0_index].data(), GetProfilingRawValueSize<args_policy>(VtsProfilingInterface::GetRawValueSize((*result_val_0)[result_0_index].size(), sizeof((*result_val_0)[result_0_index][0])), sizeof((*result_val_0)[result_0_index][0])));
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAVectorOfInterfaces") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAVectorOfInterfaces");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfInterfaces, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_VECTOR);
-                            arg_0->set_vector_size((*arg_val_0).size());
-                            for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
-                                auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_vector_arg_0_index->set_type(TYPE_HIDL_INTERFACE);
-                                arg_0_vector_arg_0_index->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfInterfaces, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_HIDL_INTERFACE);
-                                result_0_vector_result_0_index->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("haveAVectorOfInterfaces"):
+        {
+            if (strcmp(method, "haveAVectorOfInterfaces") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAVectorOfInterfaces");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAVectorOfInterfaces");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfInterfaces, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                    } else {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                        for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
+                                            auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_vector_arg_0_index->set_type(TYPE_HIDL_INTERFACE);
+                                            arg_0_vector_arg_0_index->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfInterfaces, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hardware::tests::foo::V1_0::ISimple>>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
+                                            auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_vector_result_0_index->set_type(TYPE_HIDL_INTERFACE);
+                                            result_0_vector_result_0_index->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAVectorOfGenericInterfaces") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAVectorOfGenericInterfaces");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfGenericInterfaces, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_VECTOR);
-                            arg_0->set_vector_size((*arg_val_0).size());
-                            for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
-                                auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
-                                arg_0_vector_arg_0_index->set_type(TYPE_HIDL_INTERFACE);
-                                arg_0_vector_arg_0_index->set_predefined_type("::android::hidl::base::V1_0::IBase");
-                            }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfGenericInterfaces, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_HIDL_INTERFACE);
-                                result_0_vector_result_0_index->set_predefined_type("::android::hidl::base::V1_0::IBase");
-                            }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("haveAVectorOfGenericInterfaces"):
+        {
+            if (strcmp(method, "haveAVectorOfGenericInterfaces") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAVectorOfGenericInterfaces");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAVectorOfGenericInterfaces");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfGenericInterfaces, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                    } else {
+                                        arg_0->set_type(TYPE_VECTOR);
+                                        arg_0->set_vector_size((*arg_val_0).size());
+                                        for (int arg_0_index = 0; arg_0_index < (int)(*arg_val_0).size(); arg_0_index++) {
+                                            auto *arg_0_vector_arg_0_index __attribute__((__unused__)) = arg_0->add_vector_value();
+                                            arg_0_vector_arg_0_index->set_type(TYPE_HIDL_INTERFACE);
+                                            arg_0_vector_arg_0_index->set_predefined_type("::android::hidl::base::V1_0::IBase");
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAVectorOfGenericInterfaces, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<sp<::android::hidl::base::V1_0::IBase>>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
+                                            auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_vector_result_0_index->set_type(TYPE_HIDL_INTERFACE);
+                                            result_0_vector_result_0_index->set_predefined_type("::android::hidl::base::V1_0::IBase");
+                                        }
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "echoNullInterface") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("echoNullInterface");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: echoNullInterface, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        sp<::android::hardware::tests::foo::V1_0::IFooCallback> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::IFooCallback>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_HIDL_CALLBACK);
-                            arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFooCallback");
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 2) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 2, actual: " << (*args).size() << ", method name: echoNullInterface, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        bool *result_val_0 __attribute__((__unused__)) = reinterpret_cast<bool*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_SCALAR);
-                            result_0->mutable_scalar_value()->set_bool_t((*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
-                        }
-                        auto *result_1 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        sp<::android::hardware::tests::foo::V1_0::IFooCallback> *result_val_1 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::IFooCallback>*> ((*args)[1]);
-                        if (result_val_1 != nullptr) {
-                            result_1->set_type(TYPE_HIDL_CALLBACK);
-                            result_1->set_predefined_type("::android::hardware::tests::foo::V1_0::IFooCallback");
-                        } else {
-                            LOG(WARNING) << "return value 1 is null.";
+        case VtsProfilingInterface::HashMethodName("echoNullInterface"):
+        {
+            if (strcmp(method, "echoNullInterface") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("echoNullInterface");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "echoNullInterface");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: echoNullInterface, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                sp<::android::hardware::tests::foo::V1_0::IFooCallback> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::IFooCallback>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_HIDL_CALLBACK);
+                                    arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFooCallback");
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 2) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 2, actual: " << (*args).size() << ", method name: echoNullInterface, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                bool *result_val_0 __attribute__((__unused__)) = reinterpret_cast<bool*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_SCALAR);
+                                    result_0->mutable_scalar_value()->set_bool_t((*result_val_0));
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                auto *result_1 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                sp<::android::hardware::tests::foo::V1_0::IFooCallback> *result_val_1 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::IFooCallback>*> ((*args)[1]);
+                                if (result_val_1 != nullptr) {
+                                    result_1->set_type(TYPE_HIDL_CALLBACK);
+                                    result_1->set_predefined_type("::android::hardware::tests::foo::V1_0::IFooCallback");
+                                } else {
+                                    LOG(WARNING) << "return value 1 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "createMyHandle") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("createMyHandle");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: createMyHandle, event type: " << event;
-                            break;
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: createMyHandle, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::tests::foo::V1_0::IFoo::MyHandle *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MyHandle*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__MyHandle(result_0, (*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("createMyHandle"):
+        {
+            if (strcmp(method, "createMyHandle") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("createMyHandle");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "createMyHandle");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: createMyHandle, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: createMyHandle, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::tests::foo::V1_0::IFoo::MyHandle *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MyHandle*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        result_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::MyHandle");
+                                    } else {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__MyHandle(result_0, (*result_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "createHandles") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("createHandles");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: createHandles, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        uint32_t *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<uint32_t*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_SCALAR);
-                            arg_0->mutable_scalar_value()->set_uint32_t((*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: createHandles, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::hidl_vec<::android::hardware::hidl_handle> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_handle>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_VECTOR);
-                            result_0->set_vector_size((*result_val_0).size());
-                            for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
-                                auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
-                                result_0_vector_result_0_index->set_type(TYPE_HANDLE);
-                                auto result_0_vector_result_0_index_h = (*result_val_0)[result_0_index].getNativeHandle();
-                                if (result_0_vector_result_0_index_h) {
-                                    result_0_vector_result_0_index->mutable_handle_value()->set_version(result_0_vector_result_0_index_h->version);
-                                    result_0_vector_result_0_index->mutable_handle_value()->set_num_ints(result_0_vector_result_0_index_h->numInts);
-                                    result_0_vector_result_0_index->mutable_handle_value()->set_num_fds(result_0_vector_result_0_index_h->numFds);
-                                    for (int i = 0; i < result_0_vector_result_0_index_h->numInts + result_0_vector_result_0_index_h->numFds; i++) {
-                                        if(i < result_0_vector_result_0_index_h->numFds) {
-                                            auto* fd_val_i = result_0_vector_result_0_index->mutable_handle_value()->add_fd_val();
-                                            char filePath[PATH_MAX];
-                                            string procPath = "/proc/self/fd/" + to_string(result_0_vector_result_0_index_h->data[i]);
-                                            ssize_t r = readlink(procPath.c_str(), filePath, sizeof(filePath));
-                                            if (r == -1) {
-                                                LOG(ERROR) << "Unable to get file path";
-                                                continue;
-                                            }
-                                            filePath[r] = '\0';
-                                            fd_val_i->set_file_name(filePath);
-                                            struct stat statbuf;
-                                            fstat(result_0_vector_result_0_index_h->data[i], &statbuf);
-                                            fd_val_i->set_mode(statbuf.st_mode);
-                                            if (S_ISREG(statbuf.st_mode) || S_ISDIR(statbuf.st_mode)) {
-                                                fd_val_i->set_type(S_ISREG(statbuf.st_mode)? FILE_TYPE: DIR_TYPE);
-                                                int flags = fcntl(result_0_vector_result_0_index_h->data[i], F_GETFL);
-                                                fd_val_i->set_flags(flags);
-                                            }
-                                            else if (S_ISCHR(statbuf.st_mode) || S_ISBLK(statbuf.st_mode)) {
-                                                fd_val_i->set_type(DEV_TYPE);
-                                                if (strcmp(filePath, "/dev/ashmem") == 0) {
-                                                    int size = ashmem_get_size_region(result_0_vector_result_0_index_h->data[i]);
-                                                    fd_val_i->mutable_memory()->set_size(size);
+        case VtsProfilingInterface::HashMethodName("createHandles"):
+        {
+            if (strcmp(method, "createHandles") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("createHandles");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "createHandles");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: createHandles, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                uint32_t *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<uint32_t*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_SCALAR);
+                                    arg_0->mutable_scalar_value()->set_uint32_t((*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: createHandles, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::hidl_vec<::android::hardware::hidl_handle> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_vec<::android::hardware::hidl_handle>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                    } else {
+                                        result_0->set_type(TYPE_VECTOR);
+                                        result_0->set_vector_size((*result_val_0).size());
+                                        for (int result_0_index = 0; result_0_index < (int)(*result_val_0).size(); result_0_index++) {
+                                            auto *result_0_vector_result_0_index __attribute__((__unused__)) = result_0->add_vector_value();
+                                            result_0_vector_result_0_index->set_type(TYPE_HANDLE);
+                                            auto result_0_vector_result_0_index_h = (*result_val_0)[result_0_index].getNativeHandle();
+                                            if (result_0_vector_result_0_index_h) {
+                                                result_0_vector_result_0_index->mutable_handle_value()->set_version(result_0_vector_result_0_index_h->version);
+                                                result_0_vector_result_0_index->mutable_handle_value()->set_num_ints(result_0_vector_result_0_index_h->numInts);
+                                                result_0_vector_result_0_index->mutable_handle_value()->set_num_fds(result_0_vector_result_0_index_h->numFds);
+                                                for (int i = 0; i < result_0_vector_result_0_index_h->numInts + result_0_vector_result_0_index_h->numFds; i++) {
+                                                    if(i < result_0_vector_result_0_index_h->numFds) {
+                                                        auto* fd_val_i = result_0_vector_result_0_index->mutable_handle_value()->add_fd_val();
+                                                        if (!VtsProfilingInterface::ProfileFileDescriptor(result_0_vector_result_0_index_h->data[i], fd_val_i)) {
+                                                            LOG(ERROR) << "Unable to get file path";
+                                                            continue;
+                                                        }
+                                                    } else {
+                                                        result_0_vector_result_0_index->mutable_handle_value()->add_int_val(result_0_vector_result_0_index_h->data[i]);
+                                                    }
                                                 }
+                                            } else {
+                                                LOG(WARNING) << "null handle";
+                                                result_0_vector_result_0_index->mutable_handle_value()->set_hidl_handle_address(0);
                                             }
-                                            else if (S_ISFIFO(statbuf.st_mode)){
-                                                fd_val_i->set_type(PIPE_TYPE);
-                                            }
-                                            else if (S_ISSOCK(statbuf.st_mode)) {
-                                                fd_val_i->set_type(SOCKET_TYPE);
-                                            }
-                                            else {
-                                                fd_val_i->set_type(LINK_TYPE);
-                                            }
-                                        } else {
-                                            result_0_vector_result_0_index->mutable_handle_value()->add_int_val(result_0_vector_result_0_index_h->data[i]);
                                         }
                                     }
                                 } else {
-                                    LOG(WARNING) << "null handle";
-                                    result_0_vector_result_0_index->mutable_handle_value()->set_hidl_handle_address(0);
+                                    LOG(WARNING) << "return value 0 is null.";
                                 }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
                             }
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "closeHandles") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("closeHandles");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: closeHandles, event type: " << event;
-                            break;
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: closeHandles, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("closeHandles"):
+        {
+            if (strcmp(method, "closeHandles") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("closeHandles");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "closeHandles");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: closeHandles, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: closeHandles, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "repeatWithFmq") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("repeatWithFmq");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: repeatWithFmq, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::WithFmq *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::WithFmq*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__WithFmq(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: repeatWithFmq, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::tests::foo::V1_0::IFoo::WithFmq *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::WithFmq*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__WithFmq(result_0, (*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("repeatWithFmq"):
+        {
+            if (strcmp(method, "repeatWithFmq") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("repeatWithFmq");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "repeatWithFmq");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: repeatWithFmq, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::WithFmq *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::WithFmq*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::WithFmq");
+                                    } else {
+                                        arg_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__WithFmq(arg_0, (*arg_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: repeatWithFmq, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::tests::foo::V1_0::IFoo::WithFmq *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::WithFmq*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        result_0->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::WithFmq");
+                                    } else {
+                                        result_0->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__WithFmq(result_0, (*result_val_0));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "thisIsNew") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("thisIsNew");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: thisIsNew, event type: " << event;
-                            break;
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 0) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: thisIsNew, event type: " << event;
-                            break;
+        case VtsProfilingInterface::HashMethodName("thisIsNew"):
+        {
+            if (strcmp(method, "thisIsNew") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("thisIsNew");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "thisIsNew");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 0, actual: " << (*args).size() << ", method name: thisIsNew, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 0) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 0, actual: " << (*args).size() << ", method name: thisIsNew, event type: " << event;
+                                    break;
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "expectNullHandle") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("expectNullHandle");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 2) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 2, actual: " << (*args).size() << ", method name: expectNullHandle, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::hidl_handle *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_handle*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_HANDLE);
-                            auto arg_0_h = (*arg_val_0).getNativeHandle();
-                            if (arg_0_h) {
-                                arg_0->mutable_handle_value()->set_version(arg_0_h->version);
-                                arg_0->mutable_handle_value()->set_num_ints(arg_0_h->numInts);
-                                arg_0->mutable_handle_value()->set_num_fds(arg_0_h->numFds);
-                                for (int i = 0; i < arg_0_h->numInts + arg_0_h->numFds; i++) {
-                                    if(i < arg_0_h->numFds) {
-                                        auto* fd_val_i = arg_0->mutable_handle_value()->add_fd_val();
-                                        char filePath[PATH_MAX];
-                                        string procPath = "/proc/self/fd/" + to_string(arg_0_h->data[i]);
-                                        ssize_t r = readlink(procPath.c_str(), filePath, sizeof(filePath));
-                                        if (r == -1) {
-                                            LOG(ERROR) << "Unable to get file path";
-                                            continue;
-                                        }
-                                        filePath[r] = '\0';
-                                        fd_val_i->set_file_name(filePath);
-                                        struct stat statbuf;
-                                        fstat(arg_0_h->data[i], &statbuf);
-                                        fd_val_i->set_mode(statbuf.st_mode);
-                                        if (S_ISREG(statbuf.st_mode) || S_ISDIR(statbuf.st_mode)) {
-                                            fd_val_i->set_type(S_ISREG(statbuf.st_mode)? FILE_TYPE: DIR_TYPE);
-                                            int flags = fcntl(arg_0_h->data[i], F_GETFL);
-                                            fd_val_i->set_flags(flags);
-                                        }
-                                        else if (S_ISCHR(statbuf.st_mode) || S_ISBLK(statbuf.st_mode)) {
-                                            fd_val_i->set_type(DEV_TYPE);
-                                            if (strcmp(filePath, "/dev/ashmem") == 0) {
-                                                int size = ashmem_get_size_region(arg_0_h->data[i]);
-                                                fd_val_i->mutable_memory()->set_size(size);
+        case VtsProfilingInterface::HashMethodName("expectNullHandle"):
+        {
+            if (strcmp(method, "expectNullHandle") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("expectNullHandle");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "expectNullHandle");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 2) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 2, actual: " << (*args).size() << ", method name: expectNullHandle, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::hidl_handle *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::hidl_handle*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_HANDLE);
+                                    auto arg_0_h = (*arg_val_0).getNativeHandle();
+                                    if (arg_0_h) {
+                                        arg_0->mutable_handle_value()->set_version(arg_0_h->version);
+                                        arg_0->mutable_handle_value()->set_num_ints(arg_0_h->numInts);
+                                        arg_0->mutable_handle_value()->set_num_fds(arg_0_h->numFds);
+                                        for (int i = 0; i < arg_0_h->numInts + arg_0_h->numFds; i++) {
+                                            if(i < arg_0_h->numFds) {
+                                                auto* fd_val_i = arg_0->mutable_handle_value()->add_fd_val();
+                                                if (!VtsProfilingInterface::ProfileFileDescriptor(arg_0_h->data[i], fd_val_i)) {
+                                                    LOG(ERROR) << "Unable to get file path";
+                                                    continue;
+                                                }
+                                            } else {
+                                                arg_0->mutable_handle_value()->add_int_val(arg_0_h->data[i]);
                                             }
                                         }
-                                        else if (S_ISFIFO(statbuf.st_mode)){
-                                            fd_val_i->set_type(PIPE_TYPE);
-                                        }
-                                        else if (S_ISSOCK(statbuf.st_mode)) {
-                                            fd_val_i->set_type(SOCKET_TYPE);
-                                        }
-                                        else {
-                                            fd_val_i->set_type(LINK_TYPE);
-                                        }
                                     } else {
-                                        arg_0->mutable_handle_value()->add_int_val(arg_0_h->data[i]);
+                                        LOG(WARNING) << "null handle";
+                                        arg_0->mutable_handle_value()->set_hidl_handle_address(0);
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::Abc *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::Abc*> ((*args)[1]);
+                                if (arg_val_1 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_1->set_type(TYPE_STRUCT);
+                                        arg_1->set_predefined_type("::android::hardware::tests::foo::V1_0::Abc");
+                                    } else {
+                                        arg_1->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__Abc(arg_1, (*arg_val_1));
                                     }
+                                } else {
+                                    LOG(WARNING) << "argument 1 is null.";
                                 }
-                            } else {
-                                LOG(WARNING) << "null handle";
-                                arg_0->mutable_handle_value()->set_hidl_handle_address(0);
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 2) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 2, actual: " << (*args).size() << ", method name: expectNullHandle, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                bool *result_val_0 __attribute__((__unused__)) = reinterpret_cast<bool*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_SCALAR);
+                                    result_0->mutable_scalar_value()->set_bool_t((*result_val_0));
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                auto *result_1 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                bool *result_val_1 __attribute__((__unused__)) = reinterpret_cast<bool*> ((*args)[1]);
+                                if (result_val_1 != nullptr) {
+                                    result_1->set_type(TYPE_SCALAR);
+                                    result_1->mutable_scalar_value()->set_bool_t((*result_val_1));
+                                } else {
+                                    LOG(WARNING) << "return value 1 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
                             }
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::Abc *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::Abc*> ((*args)[1]);
-                        if (arg_val_1 != nullptr) {
-                            arg_1->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__Abc(arg_1, (*arg_val_1));
-                        } else {
-                            LOG(WARNING) << "argument 1 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 2) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 2, actual: " << (*args).size() << ", method name: expectNullHandle, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        bool *result_val_0 __attribute__((__unused__)) = reinterpret_cast<bool*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_SCALAR);
-                            result_0->mutable_scalar_value()->set_bool_t((*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
-                        }
-                        auto *result_1 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        bool *result_val_1 __attribute__((__unused__)) = reinterpret_cast<bool*> ((*args)[1]);
-                        if (result_val_1 != nullptr) {
-                            result_1->set_type(TYPE_SCALAR);
-                            result_1->mutable_scalar_value()->set_bool_t((*result_val_1));
-                        } else {
-                            LOG(WARNING) << "return value 1 is null.";
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "takeAMask") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("takeAMask");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 4) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 4, actual: " << (*args).size() << ", method name: takeAMask, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::BitField *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::BitField*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_ENUM);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__BitField(arg_0, (*arg_val_0));
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
-                        uint8_t *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[1]);
-                        if (arg_val_1 != nullptr) {
-                            arg_1->set_type(TYPE_MASK);
-                            arg_1->set_scalar_type("uint8_t");
-                            arg_1->mutable_scalar_value()->set_uint8_t((*arg_val_1));
-                        } else {
-                            LOG(WARNING) << "argument 1 is null.";
-                        }
-                        auto *arg_2 __attribute__((__unused__)) = msg.add_arg();
-                        ::android::hardware::tests::foo::V1_0::IFoo::MyMask *arg_val_2 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MyMask*> ((*args)[2]);
-                        if (arg_val_2 != nullptr) {
-                            arg_2->set_type(TYPE_STRUCT);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__MyMask(arg_2, (*arg_val_2));
-                        } else {
-                            LOG(WARNING) << "argument 2 is null.";
-                        }
-                        auto *arg_3 __attribute__((__unused__)) = msg.add_arg();
-                        uint8_t *arg_val_3 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[3]);
-                        if (arg_val_3 != nullptr) {
-                            arg_3->set_type(TYPE_MASK);
-                            arg_3->set_scalar_type("uint8_t");
-                            arg_3->mutable_scalar_value()->set_uint8_t((*arg_val_3));
-                        } else {
-                            LOG(WARNING) << "argument 3 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 4) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 4, actual: " << (*args).size() << ", method name: takeAMask, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        ::android::hardware::tests::foo::V1_0::IFoo::BitField *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::BitField*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_ENUM);
-                            profile____android__hardware__tests__foo__V1_0__IFoo__BitField(result_0, (*result_val_0));
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
-                        }
-                        auto *result_1 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        uint8_t *result_val_1 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[1]);
-                        if (result_val_1 != nullptr) {
-                            result_1->set_type(TYPE_SCALAR);
-                            result_1->mutable_scalar_value()->set_uint8_t((*result_val_1));
-                        } else {
-                            LOG(WARNING) << "return value 1 is null.";
-                        }
-                        auto *result_2 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        uint8_t *result_val_2 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[2]);
-                        if (result_val_2 != nullptr) {
-                            result_2->set_type(TYPE_SCALAR);
-                            result_2->mutable_scalar_value()->set_uint8_t((*result_val_2));
-                        } else {
-                            LOG(WARNING) << "return value 2 is null.";
-                        }
-                        auto *result_3 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        uint8_t *result_val_3 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[3]);
-                        if (result_val_3 != nullptr) {
-                            result_3->set_type(TYPE_SCALAR);
-                            result_3->mutable_scalar_value()->set_uint8_t((*result_val_3));
-                        } else {
-                            LOG(WARNING) << "return value 3 is null.";
+        case VtsProfilingInterface::HashMethodName("takeAMask"):
+        {
+            if (strcmp(method, "takeAMask") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("takeAMask");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "takeAMask");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 4) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 4, actual: " << (*args).size() << ", method name: takeAMask, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::BitField *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::BitField*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_ENUM);
+                                    profile____android__hardware__tests__foo__V1_0__IFoo__BitField(arg_0, (*arg_val_0));
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                auto *arg_1 __attribute__((__unused__)) = msg.add_arg();
+                                uint8_t *arg_val_1 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[1]);
+                                if (arg_val_1 != nullptr) {
+                                    arg_1->set_type(TYPE_MASK);
+                                    arg_1->set_scalar_type("uint8_t");
+                                    arg_1->mutable_scalar_value()->set_uint8_t((*arg_val_1));
+                                } else {
+                                    LOG(WARNING) << "argument 1 is null.";
+                                }
+                                auto *arg_2 __attribute__((__unused__)) = msg.add_arg();
+                                ::android::hardware::tests::foo::V1_0::IFoo::MyMask *arg_val_2 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::MyMask*> ((*args)[2]);
+                                if (arg_val_2 != nullptr) {
+                                    if (args_policy == kProfileShallowArgs) {
+                                        arg_2->set_type(TYPE_STRUCT);
+                                        arg_2->set_predefined_type("::android::hardware::tests::foo::V1_0::IFoo::MyMask");
+                                    } else {
+                                        arg_2->set_type(TYPE_STRUCT);
+                                        profile____android__hardware__tests__foo__V1_0__IFoo__MyMask(arg_2, (*arg_val_2));
+                                    }
+                                } else {
+                                    LOG(WARNING) << "argument 2 is null.";
+                                }
+                                auto *arg_3 __attribute__((__unused__)) = msg.add_arg();
+                                uint8_t *arg_val_3 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[3]);
+                                if (arg_val_3 != nullptr) {
+                                    arg_3->set_type(TYPE_MASK);
+                                    arg_3->set_scalar_type("uint8_t");
+                                    arg_3->mutable_scalar_value()->set_uint8_t((*arg_val_3));
+                                } else {
+                                    LOG(WARNING) << "argument 3 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 4) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 4, actual: " << (*args).size() << ", method name: takeAMask, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                ::android::hardware::tests::foo::V1_0::IFoo::BitField *result_val_0 __attribute__((__unused__)) = reinterpret_cast<::android::hardware::tests::foo::V1_0::IFoo::BitField*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_ENUM);
+                                    profile____android__hardware__tests__foo__V1_0__IFoo__BitField(result_0, (*result_val_0));
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                auto *result_1 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                uint8_t *result_val_1 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[1]);
+                                if (result_val_1 != nullptr) {
+                                    result_1->set_type(TYPE_SCALAR);
+                                    result_1->mutable_scalar_value()->set_uint8_t((*result_val_1));
+                                } else {
+                                    LOG(WARNING) << "return value 1 is null.";
+                                }
+                                auto *result_2 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                uint8_t *result_val_2 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[2]);
+                                if (result_val_2 != nullptr) {
+                                    result_2->set_type(TYPE_SCALAR);
+                                    result_2->mutable_scalar_value()->set_uint8_t((*result_val_2));
+                                } else {
+                                    LOG(WARNING) << "return value 2 is null.";
+                                }
+                                auto *result_3 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                uint8_t *result_val_3 __attribute__((__unused__)) = reinterpret_cast<uint8_t*> ((*args)[3]);
+                                if (result_val_3 != nullptr) {
+                                    result_3->set_type(TYPE_SCALAR);
+                                    result_3->mutable_scalar_value()->set_uint8_t((*result_val_3));
+                                } else {
+                                    LOG(WARNING) << "return value 3 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
-    }
-    if (strcmp(method, "haveAInterface") == 0) {
-        FunctionSpecificationMessage msg;
-        msg.set_name("haveAInterface");
-        if (profiling_for_args) {
-            if (!args) {
-                LOG(WARNING) << "no argument passed";
-            } else {
-                switch (event) {
-                    case details::HidlInstrumentor::CLIENT_API_ENTRY:
-                    case details::HidlInstrumentor::SERVER_API_ENTRY:
-                    case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAInterface, event type: " << event;
-                            break;
-                        }
-                        auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
-                        sp<::android::hardware::tests::foo::V1_0::ISimple> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::ISimple>*> ((*args)[0]);
-                        if (arg_val_0 != nullptr) {
-                            arg_0->set_type(TYPE_HIDL_INTERFACE);
-                            arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
-                        } else {
-                            LOG(WARNING) << "argument 0 is null.";
-                        }
-                        break;
-                    }
-                    case details::HidlInstrumentor::CLIENT_API_EXIT:
-                    case details::HidlInstrumentor::SERVER_API_EXIT:
-                    case details::HidlInstrumentor::PASSTHROUGH_EXIT:
-                    {
-                        if ((*args).size() != 1) {
-                            LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAInterface, event type: " << event;
-                            break;
-                        }
-                        auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
-                        sp<::android::hardware::tests::foo::V1_0::ISimple> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::ISimple>*> ((*args)[0]);
-                        if (result_val_0 != nullptr) {
-                            result_0->set_type(TYPE_HIDL_INTERFACE);
-                            result_0->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
-                        } else {
-                            LOG(WARNING) << "return value 0 is null.";
+        case VtsProfilingInterface::HashMethodName("haveAInterface"):
+        {
+            if (strcmp(method, "haveAInterface") == 0) {
+                FunctionSpecificationMessage& msg = VtsProfilingInterface::NewTraceMessage();
+                msg.set_name("haveAInterface");
+                constexpr VtsProfilingArgsPolicy args_policy = GetProfilingArgsPolicy("IBar", "haveAInterface");
+                if (args_policy != kProfileTimingOnly && profiling_for_args) {
+                    if (!args) {
+                        LOG(WARNING) << "no argument passed";
+                    } else {
+                        switch (event) {
+                            case details::HidlInstrumentor::CLIENT_API_ENTRY:
+                            case details::HidlInstrumentor::SERVER_API_ENTRY:
+                            case details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of arguments does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAInterface, event type: " << event;
+                                    break;
+                                }
+                                auto *arg_0 __attribute__((__unused__)) = msg.add_arg();
+                                sp<::android::hardware::tests::foo::V1_0::ISimple> *arg_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::ISimple>*> ((*args)[0]);
+                                if (arg_val_0 != nullptr) {
+                                    arg_0->set_type(TYPE_HIDL_INTERFACE);
+                                    arg_0->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
+                                } else {
+                                    LOG(WARNING) << "argument 0 is null.";
+                                }
+                                break;
+                            }
+                            case details::HidlInstrumentor::CLIENT_API_EXIT:
+                            case details::HidlInstrumentor::SERVER_API_EXIT:
+                            case details::HidlInstrumentor::PASSTHROUGH_EXIT:
+                            {
+                                if ((*args).size() != 1) {
+                                    LOG(ERROR) << "Number of return values does not match. expect: 1, actual: " << (*args).size() << ", method name: haveAInterface, event type: " << event;
+                                    break;
+                                }
+                                auto *result_0 __attribute__((__unused__)) = msg.add_return_type_hidl();
+                                sp<::android::hardware::tests::foo::V1_0::ISimple> *result_val_0 __attribute__((__unused__)) = reinterpret_cast<sp<::android::hardware::tests::foo::V1_0::ISimple>*> ((*args)[0]);
+                                if (result_val_0 != nullptr) {
+                                    result_0->set_type(TYPE_HIDL_INTERFACE);
+                                    result_0->set_predefined_type("::android::hardware::tests::foo::V1_0::ISimple");
+                                } else {
+                                    LOG(WARNING) << "return value 0 is null.";
+                                }
+                                break;
+                            }
+                            default:
+                            {
+                                LOG(WARNING) << "not supported. ";
+                                break;
+                            }
                         }
-                        break;
-                    }
-                    default:
-                    {
-                        LOG(WARNING) << "not supported. ";
-                        break;
                     }
                 }
+                profiler.AddTraceEvent(event, hal, msg);
             }
+            break;
+        }
+        default:
+        {
+            break;
         }
-        profiler.AddTraceEvent(event, package, version, interface, msg);
     }
 }
 
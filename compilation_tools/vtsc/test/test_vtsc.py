@@ -19,6 +19,7 @@ import filecmp
 import getopt
 import logging
 import os
+import re
 import shutil
 import subprocess
 import sys
@@ -75,6 +76,8 @@ class VtscTester(unittest.TestCase):
         self.TestDriver()
         self.TestProfiler()
         self.TestFuzzer()
+        self.TestJobList()
+        self.TestTypeValidation()
         self.assertEqual(self._errors, 0)
 
     def TestDriver(self):
@@ -142,6 +145,86 @@ class VtscTester(unittest.TestCase):
                 os.path.join(self._temp_dir, component_name + ".vts"),
                 "%s.fuzzer.cpp" % component_name,
                 file_type="SOURCE")
+        # an interface without functions gets no table of functions to fuzz.
+        with open(os.path.join(self._temp_dir, "Device.vts")) as vts_file:
+            spec = vts_file.read()
+        empty_spec = re.sub(r"^(\s*)api: \{\n.*?^\1\}\n", "", spec,
+                            flags=re.MULTILINE | re.DOTALL)
+        vts_file_path = os.path.join(self._temp_dir, "EmptyDevice.vts")
+        with open(vts_file_path, "w") as vts_file:
+            vts_file.write(empty_spec)
+        self.RunTest(
+            "FUZZER", vts_file_path, "EmptyDevice.fuzzer.cpp",
+            file_type="SOURCE")
+        # the dictionary of a spec with an enum used as a mask, which is
+        # checked in so that the golden doesn't change with the HAL.
+        self.RunTest(
+            "FUZZER",
+            "test/vts/compilation_tools/vtsc/test/spec/Foo.vts",
+            "Foo.dict",
+            file_type="DICTIONARY")
+
+    def TestJobList(self):
+        """Run tests for the job list mode. """
+        logging.info("Running TestJobList test case.")
+        self.GenerateVtsFile("android.hardware.nfc@1.0")
+        vts_file_path = os.path.join(self._temp_dir, "Nfc.vts")
+        output_dir = os.path.join(self._output_dir, "jobs")
+        jobs = [("DRIVER", "HEADER", "Nfc.vts.h"),
+                ("DRIVER", "SOURCE", "Nfc.driver.cpp"),
+                ("PROFILER", "HEADER", "Nfc.vts.h"),
+                ("PROFILER", "SOURCE", "Nfc.profiler.cpp")]
+        job_list_file_path = os.path.join(self._temp_dir, "jobs.txt")
+        with open(job_list_file_path, "w") as job_list_file:
+            job_list_file.write("# mode type input output\n")
+            for mode, file_type, output_file_name in jobs:
+                job_list_file.write("%s %s %s %s\n" % (
+                    mode, file_type, vts_file_path,
+                    os.path.join(output_dir, mode, output_file_name)))
+        vtsc_cmd = [
+            self._vtsc_path, "-l" + job_list_file_path, "-j2",
+            "-s" + os.path.join(self._temp_dir, "stamps")
+        ]
+        for run in range(2):
+            return_code = cmd_utils.RunCommand(vtsc_cmd)
+            if (return_code != 0):
+                self.Error("Fail to execute command: %s" % vtsc_cmd)
+            mtimes = []
+            for mode, file_type, output_file_name in jobs:
+                output_file = os.path.join(output_dir, mode, output_file_name)
+                self.CompareOutputFile(
+                    output_file,
+                    os.path.join(self._canonical_dir, mode, output_file_name))
+                mtimes.append(os.stat(output_file).st_mtime)
+            if run == 0:
+                first_mtimes = mtimes
+            elif mtimes != first_mtimes:
+                self.Error("Unchanged jobs are translated again: %s" %
+                           vtsc_cmd)
+
+    def TestTypeValidation(self):
+        """Run tests for the validation of the type references. """
+        logging.info("Running TestTypeValidation test case.")
+        self.GenerateVtsFile("android.hardware.nfc@1.0")
+        with open(os.path.join(self._temp_dir, "Nfc.vts")) as vts_file:
+            spec = vts_file.read()
+        # refers to a type of a package that is not imported.
+        broken_spec = spec.replace("::android::hardware::nfc::V1_0::NfcStatus",
+                                   "::android::hardware::nfcx::V1_0::NfcStatus")
+        vts_file_path = os.path.join(self._temp_dir, "BrokenNfc.vts")
+        with open(vts_file_path, "w") as vts_file:
+            vts_file.write(broken_spec)
+        output_file = os.path.join(self._output_dir, "DRIVER",
+                                   "BrokenNfc.driver.cpp")
+        vtsc_cmd = [
+            self._vtsc_path, "-mDRIVER", "-tSOURCE", vts_file_path, output_file
+        ]
+        return_code = cmd_utils.RunCommand(vtsc_cmd)
+        if return_code == 0:
+            self.Error("Broken type reference is accepted: %s" % vtsc_cmd)
+        if os.path.exists(output_file):
+            self.Error("Output is generated for a broken type reference: %s" %
+                       output_file)
 
     def RunFuzzerTest(self, mode, vts_file_path, source_file_name):
         vtsc_cmd = [
@@ -193,7 +276,8 @@ class VtscTester(unittest.TestCase):
             mode: the vtsc mode for generated code. e.g. DRIVER / PROFILER.
             vts_file_path: path of the input vts file.
             source_file_name: name of the generated source file.
-            file_type: type of file e.g. HEADER / SOURCE / BOTH.
+            file_type: type of file e.g. HEADER / SOURCE / BOTH, or
+                       DICTIONARY in FUZZER mode.
         """
         if (file_type == "BOTH"):
             vtsc_cmd = [
@@ -218,7 +302,7 @@ class VtscTester(unittest.TestCase):
             output_header_file = os.path.join(self._output_dir, mode,
                                               header_file_name)
             self.CompareOutputFile(output_header_file, canonical_header_file)
-        elif (file_type == "SOURCE" or file_type == "BOTH"):
+        elif file_type in ("SOURCE", "DICTIONARY", "BOTH"):
             canonical_source_file = os.path.join(self._canonical_dir, mode,
                                                  output_file_name)
             output_source_file = os.path.join(self._output_dir, mode,
@@ -28,9 +28,9 @@
 #include <binder/IPCThreadState.h>
 #include <binder/IServiceManager.h>
 #include <binder/ProcessState.h>
-#include <binder/TextOutput.h>
 
 #include "binder/VtsFuzzerBinderService.h"
+#include "utils/DriverTrace.h"
 #include "utils/InterfaceSpecUtil.h"
 
 using namespace std;
@@ -39,6 +39,69 @@ namespace android {
 namespace vts {
 
 IMPLEMENT_META_INTERFACE(VtsFuzzer, VTS_FUZZER_BINDER_SERVICE_NAME);
+IMPLEMENT_META_INTERFACE(VtsFuzzerCallback, "VtsFuzzerCallback");
+
+void WriteVtsFuzzerCallList(const vector<string>& entries, Parcel* parcel) {
+  parcel->writeInt32(entries.size());
+  for (const auto& entry : entries) {
+    parcel->writeInt32(entry.size());
+    parcel->write(entry.data(), entry.size());
+  }
+}
+
+bool ReadVtsFuzzerCallList(const Parcel& parcel, vector<string>* entries) {
+  int32_t count;
+  // each entry takes at least its size, so a larger count is corrupt and
+  // must not be reserved.
+  if (parcel.readInt32(&count) != NO_ERROR || count < 0 ||
+      static_cast<size_t>(count) > parcel.dataAvail() / sizeof(int32_t)) {
+    return false;
+  }
+  entries->reserve(entries->size() + count);
+  for (int32_t i = 0; i < count; i++) {
+    int32_t size;
+    if (parcel.readInt32(&size) != NO_ERROR || size < 0) {
+      return false;
+    }
+    const void* data = parcel.readInplace(size);
+    if (data == NULL && size > 0) {
+      return false;
+    }
+    entries->emplace_back(static_cast<const char*>(data), size);
+  }
+  return true;
+}
+
+void BpVtsFuzzerCallback::OnCallsComplete(int64_t cookie,
+                                          const vector<string>& results) {
+  Parcel data;
+  Parcel reply;
+  data.writeInterfaceToken(IVtsFuzzerCallback::getInterfaceDescriptor());
+  data.writeInt64(cookie);
+  WriteVtsFuzzerCallList(results, &data);
+  remote()->transact(CALLS_COMPLETE, data, &reply, IBinder::FLAG_ONEWAY);
+}
+
+status_t BnVtsFuzzerCallback::onTransact(uint32_t code, const Parcel& data,
+                                         Parcel* reply, uint32_t flags) {
+  switch (code) {
+    case CALLS_COMPLETE: {
+      CHECK_INTERFACE(IVtsFuzzerCallback, data, reply);
+      int64_t cookie;
+      vector<string> results;
+      if (data.readInt64(&cookie) != NO_ERROR ||
+          !ReadVtsFuzzerCallList(data, &results)) {
+        return BAD_VALUE;
+      }
+      ScopedDriverTrace trace("BnVtsFuzzerCallback::OnCallsComplete",
+                              results.size());
+      OnCallsComplete(cookie, results);
+      return NO_ERROR;
+    }
+    default:
+      return BBinder::onTransact(code, data, reply, flags);
+  }
+}
 
 void BpVtsFuzzer::Exit() {
   Parcel data;
@@ -52,13 +115,10 @@ int32_t BpVtsFuzzer::LoadHal(const string& path, int target_class,
                              int target_type, int target_version_major,
                              int target_version_minor,
                              const string& module_name) {
+  ScopedDriverTrace trace("BpVtsFuzzer::LoadHal", path);
   Parcel data;
   Parcel reply;
 
-  printf("agent->driver: LoadHal(%s, %d, %d, %s, %s)\n", path.c_str(),
-         target_class, target_type,
-         GetVersionString(target_version_major, target_version_minor).c_str(),
-         module_name.c_str());
   data.writeInterfaceToken(IVtsFuzzer::getInterfaceDescriptor());
   data.writeCString(path.c_str());
   data.writeInt32(target_class);
@@ -67,97 +127,90 @@ int32_t BpVtsFuzzer::LoadHal(const string& path, int target_class,
   data.writeInt32(target_version_minor);
   data.writeCString(module_name.c_str());
 
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << "BpVtsFuzzer::Status request parcel:\n"
-       << data
-       << endl;
-#endif
-
   remote()->transact(LOAD_HAL, data, &reply);
 
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << "BpVtsFuzzer::Status response parcel:\n"
-       << reply
-       << endl;
-#endif
-
   int32_t res;
   status_t status = reply.readInt32(&res);
-
-  printf("driver->agent: LoadHal returns %d\n", status);
+  if (status != NO_ERROR) {
+    ALOGE("LoadHal(%s, %d, %d, %s, %s) failed: %d", path.c_str(),
+          target_class, target_type,
+          GetVersionString(target_version_major, target_version_minor).c_str(),
+          module_name.c_str(), status);
+  }
   return res;
 }
 
 int32_t BpVtsFuzzer::Status(int32_t type) {
+  ScopedDriverTrace trace("BpVtsFuzzer::Status");
   Parcel data;
   Parcel reply;
 
   data.writeInterfaceToken(IVtsFuzzer::getInterfaceDescriptor());
   data.writeInt32(type);
 
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << "BpVtsFuzzer::Status request parcel:\n"
-       << data
-       << endl;
-#endif
-
   remote()->transact(STATUS, data, &reply);
 
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << "BpVtsFuzzer::Status response parcel:\n"
-       << reply
-       << endl;
-#endif
-
   int32_t res;
   /* status_t */ reply.readInt32(&res);
   return res;
 }
 
 string BpVtsFuzzer::Call(const string& call_payload) {
+  ScopedDriverTrace trace("BpVtsFuzzer::Call", call_payload.size());
   Parcel data, reply;
   data.writeInterfaceToken(IVtsFuzzer::getInterfaceDescriptor());
   data.writeCString(call_payload.c_str());
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << data << endl;
-#endif
 
   remote()->transact(CALL, data, &reply);
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << reply << endl;
-#endif
 
   const char* res = reply.readCString();
   if (res == NULL) {
-    printf("reply == NULL\n");
-    return res;
+    ALOGE("Call got no reply");
+    return "";
   }
-
-  printf("len(reply) = %zu\n", strlen(res));
   return {res};
 }
 
 const char* BpVtsFuzzer::GetFunctions() {
+  ScopedDriverTrace trace("BpVtsFuzzer::GetFunctions");
   Parcel data, reply;
   data.writeInterfaceToken(IVtsFuzzer::getInterfaceDescriptor());
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << data << endl;
-#endif
 
   remote()->transact(GET_FUNCTIONS, data, &reply);
-#ifdef VTS_FUZZER_BINDER_DEBUG
-  alog << reply << endl;
-#endif
 
   const char* res = reply.readCString();
   if (res == NULL) {
-    printf("reply == NULL\n");
-    return res;
+    ALOGE("GetFunctions got no reply");
   }
-
-  printf("len(reply) = %zu\n", strlen(res));
   return res;
 }
 
+vector<string> BpVtsFuzzer::CallMany(const vector<string>& call_payloads) {
+  ScopedDriverTrace trace("BpVtsFuzzer::CallMany", call_payloads.size());
+  Parcel data, reply;
+  data.writeInterfaceToken(IVtsFuzzer::getInterfaceDescriptor());
+  WriteVtsFuzzerCallList(call_payloads, &data);
+
+  vector<string> results;
+  if (remote()->transact(CALL_MANY, data, &reply) != NO_ERROR ||
+      !ReadVtsFuzzerCallList(reply, &results)) {
+    ALOGE("CallMany of %zu calls failed", call_payloads.size());
+    results.clear();
+  }
+  return results;
+}
+
+status_t BpVtsFuzzer::CallAsync(const vector<string>& call_payloads,
+                                const sp<IVtsFuzzerCallback>& callback,
+                                int64_t cookie) {
+  ScopedDriverTrace trace("BpVtsFuzzer::CallAsync", call_payloads.size());
+  Parcel data, reply;
+  data.writeInterfaceToken(IVtsFuzzer::getInterfaceDescriptor());
+  data.writeStrongBinder(IInterface::asBinder(callback));
+  data.writeInt64(cookie);
+  WriteVtsFuzzerCallList(call_payloads, &data);
+  return remote()->transact(CALL_ASYNC, data, &reply, IBinder::FLAG_ONEWAY);
+}
+
 }  // namespace vts
 }  // namespace android
@@ -37,6 +37,11 @@ void* DllLoader::Load(const char* file_path) {
     return NULL;
   }
 
+  auto res = handles_.find(file_path);
+  if (res != handles_.end()) {
+    handle_ = res->second;
+    return handle_;
+  }
   // consider using the load mechanism in hardware/libhardware/hardware.c
   handle_ = dlopen(file_path, RTLD_LAZY);
   if (!handle_) {
@@ -45,6 +50,7 @@ void* DllLoader::Load(const char* file_path) {
     return NULL;
   }
   LOG(DEBUG) << "DLL loaded " << file_path;
+  handles_[file_path] = handle_;
   return handle_;
 }
 
@@ -85,6 +91,41 @@ bool DllLoader::GcovFlush() {
   return true;
 }
 
+bool DllLoader::GcovReset() {
+  void (*func)() = (void (*)())LoadSymbol("__gcov_reset");
+  if (func == NULL) {
+    return false;
+  }
+  func();
+  return true;
+}
+
+bool DllLoader::ProfileWriteBuffer(std::string* buffer) {
+  uint64_t (*get_size)() =
+      (uint64_t(*)())LoadSymbol("__llvm_profile_get_size_for_buffer");
+  int (*write_buffer)(char*) =
+      (int (*)(char*))LoadSymbol("__llvm_profile_write_buffer");
+  if (get_size == NULL || write_buffer == NULL) {
+    return false;
+  }
+  buffer->resize(get_size());
+  if (write_buffer(&(*buffer)[0]) != 0) {
+    LOG(ERROR) << "Can't write the profile to a buffer";
+    buffer->clear();
+    return false;
+  }
+  return true;
+}
+
+bool DllLoader::ProfileResetCounters() {
+  void (*func)() = (void (*)())LoadSymbol("__llvm_profile_reset_counters");
+  if (func == NULL) {
+    return false;
+  }
+  func();
+  return true;
+}
+
 void* DllLoader::LoadSymbol(const char* symbol_name) const {
   const char* error = dlerror();
   if (error != NULL) {
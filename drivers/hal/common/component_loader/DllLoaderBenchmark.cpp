@@ -0,0 +1,216 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "component_loader/DllLoader.h"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <link.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "driver_base/DriverBase.h"
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "utils/InterfaceSpecUtil.h"
+
+using namespace std;
+
+// Reports the size and the load time of the driver and profiler libraries
+// that vtsc generates for the HALs of its golden tests, to catch
+// regressions in the code generators.
+//
+// Usage: vts_driver_lib_benchmark [<driver lib dir>]
+// where <driver lib dir> is where VTS pushes the libraries, by default
+// /data/local/tmp/<bitness>/.
+
+namespace android {
+namespace vts {
+
+// A HAL whose generated code is in compilation_tools/vtsc/test/golden.
+struct GoldenHal {
+  const char* package;
+  int version_major;
+  int version_minor;
+  const char* component_name;
+};
+
+static const GoldenHal kGoldenHals[] = {
+    {"android.hardware.tests.bar", 1, 0, "IBar"},
+    {"android.hardware.nfc", 1, 0, "INfc"},
+    {"android.hardware.tests.msgq", 1, 0, "ITestMsgQ"},
+    {"android.hardware.tests.memory", 1, 0, "IMemoryTest"},
+};
+
+// The sizes read from the ELF headers of a library.
+struct ElfStats {
+  size_t file_bytes = 0;
+  size_t text_bytes = 0;
+  size_t dynamic_symbols = 0;
+  size_t relocations = 0;
+};
+
+// Reads the section headers of the ELF file at path.
+//
+// @param path  path of the shared library.
+// @param stats to be filled with the sizes.
+//
+// @return true if successful, false if path is not a readable ELF file of
+//         the bitness of this process.
+static bool ReadElfStats(const string& path, ElfStats* stats) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(ElfW(Ehdr))) {
+    close(fd);
+    return false;
+  }
+  size_t size = file_stat.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return false;
+
+  const char* data = static_cast<const char*>(addr);
+  const ElfW(Ehdr)* header = reinterpret_cast<const ElfW(Ehdr)*>(data);
+  bool success = memcmp(header->e_ident, ELFMAG, SELFMAG) == 0 &&
+                 header->e_shentsize == sizeof(ElfW(Shdr)) &&
+                 header->e_shoff + header->e_shnum * sizeof(ElfW(Shdr)) <=
+                     size &&
+                 header->e_shstrndx < header->e_shnum;
+  if (success) {
+    const ElfW(Shdr)* sections =
+        reinterpret_cast<const ElfW(Shdr)*>(data + header->e_shoff);
+    const ElfW(Shdr)& names = sections[header->e_shstrndx];
+    stats->file_bytes = size;
+    for (int i = 0; i < header->e_shnum; i++) {
+      const ElfW(Shdr)& section = sections[i];
+      if (section.sh_name < names.sh_size && names.sh_offset < size &&
+          strncmp(data + names.sh_offset + section.sh_name, ".text",
+                  names.sh_size - section.sh_name) == 0) {
+        stats->text_bytes += section.sh_size;
+      }
+      if (section.sh_entsize == 0) continue;
+      if (section.sh_type == SHT_DYNSYM) {
+        stats->dynamic_symbols += section.sh_size / section.sh_entsize;
+      } else if (section.sh_type == SHT_RELA || section.sh_type == SHT_REL) {
+        stats->relocations += section.sh_size / section.sh_entsize;
+      }
+    }
+  }
+  munmap(addr, size);
+  return success;
+}
+
+// Returns the path of the driver or profiler library of hal.
+static string GetLibPath(const string& lib_dir, const GoldenHal& hal,
+                         const char* lib_type) {
+  return lib_dir + hal.package + "@" + to_string(hal.version_major) + "." +
+         to_string(hal.version_minor) + "-vts." + lib_type + ".so";
+}
+
+// Reports the ELF sizes of a library as counters. The sizes don't change
+// between iterations, so only one is run.
+static void BM_LibSize(benchmark::State& state, const string& lib_path) {
+  ElfStats stats;
+  for (auto _ : state) {
+    if (!ReadElfStats(lib_path, &stats)) {
+      state.SkipWithError(("can't read " + lib_path).c_str());
+      return;
+    }
+  }
+  state.counters["file_bytes"] = stats.file_bytes;
+  state.counters["text_bytes"] = stats.text_bytes;
+  state.counters["dynamic_symbols"] = stats.dynamic_symbols;
+  state.counters["relocations"] = stats.relocations;
+}
+
+// Measures loading a library that is not loaded in the process yet, through
+// DllLoader::Load as the agent does, and creating and deleting a driver with
+// the factory of hal if factory_name is not empty. The library is unloaded
+// between iterations; the libraries it depends on may stay loaded.
+static void BM_ColdLoad(benchmark::State& state, const string& lib_path,
+                        const string& factory_name) {
+  for (auto _ : state) {
+    void* handle;
+    {
+      DllLoader loader;
+      handle = loader.Load(lib_path.c_str());
+      if (!handle) {
+        state.SkipWithError(("can't load " + lib_path).c_str());
+        return;
+      }
+      if (!factory_name.empty()) {
+        loader_function factory =
+            loader.GetLoaderFunction(factory_name.c_str());
+        if (!factory) {
+          dlclose(handle);
+          state.SkipWithError(("can't find " + factory_name).c_str());
+          return;
+        }
+        DriverBase* driver = factory();
+        state.PauseTiming();
+        delete driver;
+        state.ResumeTiming();
+      }
+    }
+    state.PauseTiming();
+    dlclose(handle);
+    state.ResumeTiming();
+  }
+}
+
+static void RegisterBenchmarks(const string& lib_dir) {
+  for (const auto& hal : kGoldenHals) {
+    ComponentSpecificationMessage spec;
+    spec.set_component_class(HAL_HIDL);
+    spec.set_package(hal.package);
+    spec.set_component_type_version_major(hal.version_major);
+    spec.set_component_type_version_minor(hal.version_minor);
+    spec.set_component_name(hal.component_name);
+    string factory_name = GetFunctionNamePrefix(spec);
+    for (const char* lib_type : {"driver", "profiler"}) {
+      string lib_path = GetLibPath(lib_dir, hal, lib_type);
+      string name = string(hal.component_name) + "/" + lib_type;
+      benchmark::RegisterBenchmark(("BM_LibSize/" + name).c_str(), BM_LibSize,
+                                   lib_path)
+          ->Iterations(1);
+      // profilers have no factory.
+      benchmark::RegisterBenchmark(
+          ("BM_ColdLoad/" + name).c_str(), BM_ColdLoad, lib_path,
+          strcmp(lib_type, "driver") == 0 ? factory_name : "");
+    }
+  }
+}
+
+}  // namespace vts
+}  // namespace android
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  string lib_dir =
+      argc > 1 ? argv[1] : "/data/local/tmp/" + to_string(sizeof(void*) * 8);
+  if (lib_dir.back() != '/') lib_dir += "/";
+  android::vts::RegisterBenchmarks(lib_dir);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
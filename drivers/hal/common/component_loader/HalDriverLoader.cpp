@@ -43,9 +43,6 @@ bool HalDriverLoader::FindComponentSpecification(
     const int version_major, const int version_minor,
     const string& component_name, const int component_type,
     ComponentSpecificationMessage* spec_msg) {
-  DIR* dir;
-  struct dirent* ent;
-
   // Derive the package-specific dir which contains .vts files
   string driver_lib_dir = dir_path_;
   if (!endsWith(driver_lib_dir, "/")) {
@@ -56,47 +53,69 @@ bool HalDriverLoader::FindComponentSpecification(
   driver_lib_dir += package_path + "/";
   driver_lib_dir += GetVersionString(version_major, version_minor);
 
-  if (!(dir = opendir(driver_lib_dir.c_str()))) {
-    LOG(ERROR) << "Can't open dir " << driver_lib_dir;
+  lock_guard<mutex> lock(spec_catalog_lock_);
+  const vector<shared_ptr<const ComponentSpecificationMessage>>* specs =
+      GetCatalogSpecs(driver_lib_dir);
+  if (!specs) {
     return false;
   }
+  for (const auto& spec_ptr : *specs) {
+    const ComponentSpecificationMessage& spec = *spec_ptr;
+    if (spec.component_class() != component_class) {
+      continue;
+    }
+    if (spec.component_class() != HAL_HIDL) {
+      if (spec.component_type() != component_type ||
+          spec.component_type_version_major() != version_major ||
+          spec.component_type_version_minor() != version_minor) {
+        continue;
+      }
+    } else {
+      if (spec.package() != package_name ||
+          spec.component_type_version_major() != version_major ||
+          spec.component_type_version_minor() != version_minor) {
+        continue;
+      }
+      if (!component_name.empty()) {
+        if (spec.component_name() != component_name) {
+          continue;
+        }
+      }
+    }
+    *spec_msg = spec;
+    return true;
+  }
+  return false;
+}
+
+const vector<shared_ptr<const ComponentSpecificationMessage>>*
+HalDriverLoader::GetCatalogSpecs(const string& driver_lib_dir) {
+  auto res = spec_catalog_.find(driver_lib_dir);
+  if (res != spec_catalog_.end()) {
+    return &res->second;
+  }
 
+  DIR* dir;
+  struct dirent* ent;
+  if (!(dir = opendir(driver_lib_dir.c_str()))) {
+    LOG(ERROR) << "Can't open dir " << driver_lib_dir;
+    return nullptr;
+  }
+  vector<shared_ptr<const ComponentSpecificationMessage>>& specs =
+      spec_catalog_[driver_lib_dir];
   while ((ent = readdir(dir))) {
     if (ent->d_type == DT_REG &&
         string(ent->d_name).find(kSpecFileExt) != std::string::npos) {
-      LOG(DEBUG) << "Checking a file " << ent->d_name;
+      LOG(DEBUG) << "Parsing a file " << ent->d_name;
       const string file_path = driver_lib_dir + "/" + string(ent->d_name);
-      if (ParseInterfaceSpec(file_path.c_str(), spec_msg)) {
-        if (spec_msg->component_class() != component_class) {
-          continue;
-        }
-        if (spec_msg->component_class() != HAL_HIDL) {
-          if (spec_msg->component_type() != component_type ||
-              spec_msg->component_type_version_major() != version_major ||
-              spec_msg->component_type_version_minor() != version_minor) {
-            continue;
-          }
-          closedir(dir);
-          return true;
-        } else {
-          if (spec_msg->package() != package_name ||
-              spec_msg->component_type_version_major() != version_major ||
-              spec_msg->component_type_version_minor() != version_minor) {
-            continue;
-          }
-          if (!component_name.empty()) {
-            if (spec_msg->component_name() != component_name) {
-              continue;
-            }
-          }
-          closedir(dir);
-          return true;
-        }
+      auto spec = GetInterfaceSpec(file_path, spec_cache_dir_);
+      if (spec) {
+        specs.push_back(std::move(spec));
       }
     }
   }
   closedir(dir);
-  return false;
+  return &specs;
 }
 
 DriverBase* HalDriverLoader::GetDriver(
@@ -200,17 +219,46 @@ DriverBase* HalDriverLoader::GetHidlHalDriver(
   return driver;
 }
 
-DriverBase* HalDriverLoader::LoadDriver(
+void* HalDriverLoader::GetDriverFactory(
     const string& driver_lib_path,
-    const ComponentSpecificationMessage& spec_msg) {
+    const ComponentSpecificationMessage& spec_msg, bool with_arg) {
+  auto key = make_tuple(
+      driver_lib_path, static_cast<int>(spec_msg.component_class()),
+      static_cast<int>(spec_msg.component_type()),
+      spec_msg.component_type_version_major(),
+      spec_msg.component_type_version_minor(), spec_msg.package(),
+      spec_msg.component_name(), with_arg);
+  lock_guard<mutex> lock(driver_factories_lock_);
+  auto res = driver_factories_.find(key);
+  if (res != driver_factories_.end()) {
+    return res->second;
+  }
   if (!dll_loader_.Load(driver_lib_path.c_str())) {
     LOG(ERROR) << "Failed to load  " << driver_lib_path;
     return nullptr;
   }
   LOG(DEBUG) << "DLL loaded " << driver_lib_path;
   string function_name_prefix = GetFunctionNamePrefix(spec_msg);
-  loader_function func =
-      dll_loader_.GetLoaderFunction(function_name_prefix.c_str());
+  void* func;
+  if (with_arg) {
+    function_name_prefix += "with_arg";
+    func = reinterpret_cast<void*>(
+        dll_loader_.GetLoaderFunctionWithArg(function_name_prefix.c_str()));
+  } else {
+    func = reinterpret_cast<void*>(
+        dll_loader_.GetLoaderFunction(function_name_prefix.c_str()));
+  }
+  if (func) {
+    driver_factories_[key] = func;
+  }
+  return func;
+}
+
+DriverBase* HalDriverLoader::LoadDriver(
+    const string& driver_lib_path,
+    const ComponentSpecificationMessage& spec_msg) {
+  loader_function func = reinterpret_cast<loader_function>(
+      GetDriverFactory(driver_lib_path, spec_msg, false));
   if (!func) {
     LOG(ERROR) << "Function not found.";
     return nullptr;
@@ -228,15 +276,8 @@ DriverBase* HalDriverLoader::LoadDriverWithInterfacePointer(
   // the by the driver's linking dependency.
   // Example: name (android::hardware::gnss::V1_0::IAGnssRil) converted to
   // function name (vts_func_4_android_hardware_tests_bar_V1_0_IBar_with_arg)
-  if (!dll_loader_.Load(driver_lib_path.c_str())) {
-    LOG(ERROR) << "Failed to load  " << driver_lib_path;
-    return nullptr;
-  }
-  LOG(DEBUG) << "DLL loaded " << driver_lib_path;
-  string function_name_prefix = GetFunctionNamePrefix(spec_msg);
-  function_name_prefix += "with_arg";
-  loader_function_with_arg func =
-      dll_loader_.GetLoaderFunctionWithArg(function_name_prefix.c_str());
+  loader_function_with_arg func = reinterpret_cast<loader_function_with_arg>(
+      GetDriverFactory(driver_lib_path, spec_msg, true));
   if (!func) {
     LOG(ERROR) << "Function not found.";
     return nullptr;
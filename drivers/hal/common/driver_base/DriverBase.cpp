@@ -18,12 +18,21 @@
 #include "driver_base/DriverBase.h"
 
 #include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <android-base/logging.h>
 
+#include "GcdaDelta.h"
 #include "GcdaParser.h"
 #include "component_loader/DllLoader.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
@@ -39,6 +48,15 @@ namespace vts {
 
 const string default_gcov_output_basepath = "/data/misc/gcov";
 
+// maximum number of threads ScanAllGcdaFiles parses the files with.
+static constexpr size_t kMaxGcdaParseThreads = 4;
+
+// the changes of a directory that invalidate the list of the GCDA files.
+static constexpr uint32_t kGcdaDirEvents = IN_CREATE | IN_DELETE |
+                                           IN_MOVED_FROM | IN_MOVED_TO |
+                                           IN_DELETE_SELF | IN_MOVE_SELF |
+                                           IN_ONLYDIR;
+
 static void RemoveDir(char* path) {
   struct dirent* entry = NULL;
   DIR* dir = opendir(path);
@@ -68,9 +86,20 @@ DriverBase::DriverBase(int target_class)
       target_dll_path_(NULL),
       target_class_(target_class),
       component_filename_(NULL),
-      gcov_output_basepath_(NULL) {}
-
-DriverBase::~DriverBase() { free(component_filename_); }
+      gcov_output_basepath_(NULL),
+      gcov_output_basepath_found_(false),
+      gcov_reset_supported_(false),
+      include_raw_coverage_data_(true),
+      report_coverage_delta_(false),
+      in_memory_coverage_(false),
+      gcda_files_inotify_fd_(-1) {}
+
+DriverBase::~DriverBase() {
+  free(component_filename_);
+  if (gcda_files_inotify_fd_ >= 0) {
+    close(gcda_files_inotify_fd_);
+  }
+}
 
 void wfn() { LOG(DEBUG) << "debug"; }
 
@@ -87,6 +116,10 @@ bool DriverBase::LoadTargetComponent(const char* target_dll_path) {
   target_dll_path_ = (char*)malloc(strlen(target_dll_path) + 1);
   strcpy(target_dll_path_, target_dll_path);
   LOG(DEBUG) << "Loaded the target";
+  // The gcov dir depends on the component.
+  free(gcov_output_basepath_);
+  gcov_output_basepath_ = NULL;
+  gcov_output_basepath_found_ = false;
   if (target_class_ == HAL_LEGACY) return true;
   LOG(DEBUG) << "Loaded a non-legacy HAL file.";
 
@@ -130,6 +163,23 @@ bool DriverBase::Fuzz(vts::ComponentSpecificationMessage* message,
 }
 
 void DriverBase::FunctionCallBegin() {
+  if (in_memory_coverage_ && target_loader_.ProfileResetCounters()) {
+    return;
+  }
+  if (!gcov_output_basepath_found_) {
+    gcov_output_basepath_found_ = true;
+    FindGcovOutputBasepath();
+    gcov_reset_supported_ = target_loader_.GcovReset();
+    return;
+  }
+  // Drops the counts of anything run since the last call, without touching
+  // the gcov dir.
+  if (gcov_reset_supported_) {
+    target_loader_.GcovReset();
+  }
+}
+
+void DriverBase::FindGcovOutputBasepath() {
   char product_path[4096];
   char product[128];
   char module_basepath[4096];
@@ -217,76 +267,137 @@ void DriverBase::FunctionCallBegin() {
   closedir(srcdir);
 }
 
-bool DriverBase::ReadGcdaFile(const string& basepath, const string& filename,
-                              FunctionSpecificationMessage* msg) {
+void DriverBase::ParseGcdaFile(GcdaCoverage* coverage) const {
+  // The file is mapped once, then parsed and copied from the mapping.
+  int gcda_fd = open(coverage->path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (gcda_fd < 0) {
+    LOG(ERROR) << "Unable to open a gcda file. " << coverage->path;
+    return;
+  }
+  LOG(DEBUG) << "Opened a gcda file. " << coverage->path;
+  struct stat st;
+  if (fstat(gcda_fd, &st) < 0) {
+    LOG(ERROR) << "Unable to stat a gcda file. " << coverage->path;
+    close(gcda_fd);
+    return;
+  }
+  size_t size = st.st_size;
 #if VTS_GCOV_DEBUG
-  LOG(DEBUG) << "file = " << dent->d_name;
+  LOG(DEBUG) << "File size " << size << " bytes";
 #endif
-  if (string(filename).rfind(".gcda") != string::npos) {
-    string buffer = basepath + "/" + filename;
-    vector<unsigned> processed_data =
-        android::vts::GcdaRawCoverageParser(buffer.c_str()).Parse();
-    for (const auto& data : processed_data) {
-      msg->mutable_processed_coverage_data()->Add(data);
+  void* data = NULL;
+  if (size > 0) {
+    data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, gcda_fd, 0);
+  }
+  close(gcda_fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map a gcda file. " << coverage->path;
+    return;
+  }
+
+  string* snapshot = coverage->snapshot;
+  if (snapshot && !snapshot->empty() && CanDiffGcda(*snapshot, size)) {
+    coverage->is_delta = true;
+    DiffGcda(*snapshot, data, &coverage->indexes, &coverage->values);
+    if (!coverage->indexes.empty()) {
+      ApplyGcdaDelta(coverage->indexes.data(), coverage->values.data(),
+                     coverage->indexes.size(), snapshot);
     }
+  } else {
+    coverage->processed_data = android::vts::GcdaRawCoverageParser(
+                                   coverage->path.c_str(), data, size)
+                                   .Parse();
+    if (include_raw_coverage_data_) {
+      coverage->data.assign(static_cast<const char*>(data), size);
+    }
+    if (snapshot) {
+      snapshot->assign(static_cast<const char*>(data), size);
+    }
+  }
+  if (data) {
+    munmap(data, size);
+  }
+  coverage->parsed = true;
+}
 
-    FILE* gcda_file = fopen(buffer.c_str(), "rb");
-    if (!gcda_file) {
-      LOG(ERROR) << "Unable to open a gcda file. " << buffer;
-    } else {
-      LOG(DEBUG) << "Opened a gcda file. " << buffer;
-      fseek(gcda_file, 0, SEEK_END);
-      long gcda_file_size = ftell(gcda_file);
+void DriverBase::AddGcdaCoverage(GcdaCoverage* coverage,
+                                 FunctionSpecificationMessage* msg) const {
+  if (!coverage->parsed) return;
+  if (coverage->is_delta) {
+    if (coverage->indexes.empty() || !include_raw_coverage_data_) return;
+    NativeCodeCoverageRawDataMessage* raw_msg =
+        msg->mutable_raw_coverage_data()->Add();
+    raw_msg->set_file_path(coverage->filename);
+    raw_msg->set_is_delta(true);
+    raw_msg->mutable_gcda_delta_index()->Reserve(coverage->indexes.size());
+    raw_msg->mutable_gcda_delta_value()->Reserve(coverage->values.size());
+    for (size_t i = 0; i < coverage->indexes.size(); i++) {
+      raw_msg->add_gcda_delta_index(coverage->indexes[i]);
+      raw_msg->add_gcda_delta_value(coverage->values[i]);
+    }
+    return;
+  }
+
+  msg->mutable_processed_coverage_data()->Reserve(
+      msg->processed_coverage_data_size() + coverage->processed_data.size());
+  for (const auto& id : coverage->processed_data) {
+    msg->mutable_processed_coverage_data()->Add(id);
+  }
+
+  if (include_raw_coverage_data_) {
 #if VTS_GCOV_DEBUG
-      LOG(DEBUG) << "File size " << gcda_file_size << " bytes";
+    LOG(DEBUG) << "GCDA field populated.";
 #endif
-      fseek(gcda_file, 0, SEEK_SET);
-
-      char* gcda_file_buffer = (char*)malloc(gcda_file_size + 1);
-      if (!gcda_file_buffer) {
-        LOG(ERROR) << "Unable to allocate memory to read a gcda file.";
-      } else {
-        if (fread(gcda_file_buffer, gcda_file_size, 1, gcda_file) != 1) {
-          LOG(ERROR) << "File read error";
-        } else {
+    NativeCodeCoverageRawDataMessage* raw_msg =
+        msg->mutable_raw_coverage_data()->Add();
+    raw_msg->set_file_path(coverage->filename);
+    raw_msg->set_gcda(move(coverage->data));
+  }
+}
+
+bool DriverBase::ReadGcdaFile(const string& basepath, const string& filename,
+                              FunctionSpecificationMessage* msg) {
 #if VTS_GCOV_DEBUG
-          LOG(DEBUG) << "GCDA field populated.";
+  LOG(DEBUG) << "file = " << filename;
 #endif
-          gcda_file_buffer[gcda_file_size] = '\0';
-          NativeCodeCoverageRawDataMessage* raw_msg =
-              msg->mutable_raw_coverage_data()->Add();
-          raw_msg->set_file_path(filename.c_str());
-          string gcda_file_buffer_string(gcda_file_buffer, gcda_file_size);
-          raw_msg->set_gcda(gcda_file_buffer_string);
-          free(gcda_file_buffer);
-        }
-      }
-      fclose(gcda_file);
-    }
-#if USE_GCOV_DEBUG
-    if (result) {
-      for (unsigned int index = 0; index < result->size(); index++) {
-        LOG(DEBUG) << result->at(index);
-      }
-    }
-#endif
-    return true;
+  if (filename.rfind(".gcda") == string::npos) {
+    return false;
+  }
+  GcdaCoverage coverage;
+  coverage.path = basepath + "/" + filename;
+  coverage.filename = filename;
+  if (report_coverage_delta_) {
+    coverage.snapshot = &gcda_snapshots_[coverage.path];
   }
-  return false;
+  ParseGcdaFile(&coverage);
+  AddGcdaCoverage(&coverage, msg);
+  return true;
 }
 
-bool DriverBase::ScanAllGcdaFiles(const string& basepath,
-                                  FunctionSpecificationMessage* msg) {
-  DIR* srcdir = opendir(basepath.c_str());
+// Appends the GCDA files under dir to files, as pairs of directory and file
+// name, and watches the directories with *inotify_fd if it is not -1. Stops
+// watching, and sets *inotify_fd to -1, if a directory can't be watched.
+// Returns false if dir can't be opened.
+static bool collectGcdaFiles(const string& dir, int* inotify_fd,
+                             vector<pair<string, string>>* files) {
+  // The directory is watched before it is read, so that no file created
+  // meanwhile is missed.
+  if (*inotify_fd >= 0 &&
+      inotify_add_watch(*inotify_fd, dir.c_str(), kGcdaDirEvents) < 0) {
+    PLOG(WARNING) << "Couldn't watch " << dir;
+    close(*inotify_fd);
+    *inotify_fd = -1;
+  }
+  DIR* srcdir = opendir(dir.c_str());
   if (!srcdir) {
-    LOG(ERROR) << "Couln't open " << basepath;
+    LOG(ERROR) << "Couln't open " << dir;
     return false;
   }
 
   struct dirent* dent;
   while ((dent = readdir(srcdir)) != NULL) {
 #if VTS_GCOV_DEBUG
-    LOG(DEBUG) << "readdir(" << basepath << ") for " << dent->d_name;
+    LOG(DEBUG) << "readdir(" << dir << ") for " << dent->d_name;
 #endif
     struct stat st;
     if (strcmp(dent->d_name, ".") == 0 || strcmp(dent->d_name, "..") == 0) {
@@ -297,20 +408,105 @@ bool DriverBase::ScanAllGcdaFiles(const string& basepath,
       continue;
     }
     if (S_ISDIR(st.st_mode)) {
-      ScanAllGcdaFiles(basepath + "/" + dent->d_name, msg);
-    } else {
-      ReadGcdaFile(basepath, dent->d_name, msg);
+      collectGcdaFiles(dir + "/" + dent->d_name, inotify_fd, files);
+    } else if (string(dent->d_name).rfind(".gcda") != string::npos) {
+      files->emplace_back(dir, dent->d_name);
     }
   }
-#if VTS_GCOV_DEBUG
-  LOG(DEBUG) << "closedir(" << srcdir << ")";
-#endif
   closedir(srcdir);
   return true;
 }
 
+bool DriverBase::ListGcdaFiles(const string& basepath) {
+  if (gcda_files_inotify_fd_ >= 0 && basepath == gcda_files_basepath_) {
+    // Any event means that a file or directory was added, removed or moved.
+    char buffer[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t n = read(gcda_files_inotify_fd_, buffer, sizeof(buffer));
+    if (n < 0 && errno == EAGAIN) {
+      return true;
+    }
+  }
+  if (gcda_files_inotify_fd_ >= 0) {
+    close(gcda_files_inotify_fd_);
+  }
+  gcda_files_inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (gcda_files_inotify_fd_ < 0) {
+    PLOG(WARNING) << "Couldn't init inotify, listing the gcda files each time";
+  }
+  gcda_files_basepath_ = basepath;
+  gcda_files_.clear();
+  if (!collectGcdaFiles(basepath, &gcda_files_inotify_fd_, &gcda_files_)) {
+    if (gcda_files_inotify_fd_ >= 0) {
+      close(gcda_files_inotify_fd_);
+      gcda_files_inotify_fd_ = -1;
+    }
+    return false;
+  }
+  sort(gcda_files_.begin(), gcda_files_.end(),
+       [](const pair<string, string>& a, const pair<string, string>& b) {
+         return a.first + "/" + a.second < b.first + "/" + b.second;
+       });
+  return true;
+}
+
+bool DriverBase::ScanAllGcdaFiles(const string& basepath,
+                                  FunctionSpecificationMessage* msg) {
+  if (!ListGcdaFiles(basepath)) {
+    return false;
+  }
+  vector<GcdaCoverage> coverages(gcda_files_.size());
+  for (size_t i = 0; i < gcda_files_.size(); i++) {
+    GcdaCoverage& coverage = coverages[i];
+    coverage.path = gcda_files_[i].first + "/" + gcda_files_[i].second;
+    coverage.filename = gcda_files_[i].second;
+    // The snapshots are created before the threads start, as inserting into
+    // gcda_snapshots_ doesn't move the others.
+    if (report_coverage_delta_) {
+      coverage.snapshot = &gcda_snapshots_[coverage.path];
+    }
+  }
+
+  // The files are parsed on a few threads, then added in order.
+  atomic<size_t> next_index(0);
+  auto parse_files = [this, &coverages, &next_index]() {
+    size_t index;
+    while ((index = next_index++) < coverages.size()) {
+      ParseGcdaFile(&coverages[index]);
+    }
+  };
+  size_t thread_count = min<size_t>(
+      min<size_t>(kMaxGcdaParseThreads, thread::hardware_concurrency()),
+      coverages.size());
+  vector<thread> threads;
+  for (size_t i = 1; i < thread_count; i++) {
+    threads.emplace_back(parse_files);
+  }
+  parse_files();
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto& coverage : coverages) {
+    AddGcdaCoverage(&coverage, msg);
+  }
+  return true;
+}
+
 bool DriverBase::FunctionCallEnd(FunctionSpecificationMessage* msg) {
 #if USE_GCOV
+  if (in_memory_coverage_) {
+    string profile;
+    if (target_loader_.ProfileWriteBuffer(&profile)) {
+      NativeCodeCoverageRawDataMessage* raw_msg =
+          msg->mutable_raw_coverage_data()->Add();
+      if (target_dll_path_) {
+        raw_msg->set_file_path(target_dll_path_);
+      }
+      raw_msg->mutable_profile()->swap(profile);
+      return true;
+    }
+    LOG(WARNING) << "No in-memory profile, falling back to gcda files";
+  }
   target_loader_.GcovFlush();
   // find the file.
   if (!gcov_output_basepath_) {
@@ -323,6 +519,10 @@ bool DriverBase::FunctionCallEnd(FunctionSpecificationMessage* msg) {
     return false;
   }
 
+  // The first gcda file is reported. The next flush would merge into every
+  // file of the dir, so all of them are removed for the next call to only
+  // report its own counts.
+  bool reported = false;
   struct dirent* dent;
   while ((dent = readdir(srcdir)) != NULL) {
     LOG(DEBUG) << "readdir(" << srcdir << ") for " << dent->d_name;
@@ -335,10 +535,13 @@ bool DriverBase::FunctionCallEnd(FunctionSpecificationMessage* msg) {
       LOG(ERROR) << "error " << dent->d_name;
       continue;
     }
-    if (!S_ISDIR(st.st_mode) &&
-        ReadGcdaFile(gcov_output_basepath_, dent->d_name, msg)) {
-      break;
+    if (S_ISDIR(st.st_mode)) {
+      continue;
+    }
+    if (!reported) {
+      reported = ReadGcdaFile(gcov_output_basepath_, dent->d_name, msg);
     }
+    unlinkat(dirfd(srcdir), dent->d_name, 0);
   }
   LOG(DEBUG) << "closedir(" << srcdir << ")";
   closedir(srcdir);
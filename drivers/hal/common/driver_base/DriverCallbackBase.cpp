@@ -17,6 +17,18 @@
 
 #include "driver_base/DriverCallbackBase.h"
 
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include <VtsDriverCommUtil.h>
 #include <android-base/logging.h>
 
@@ -30,7 +42,16 @@ using namespace std;
 namespace android {
 namespace vts {
 
-static std::map<string, string> id_map_;
+// The callback ids, by callback name. Register publishes a new table with
+// the ids it adds, and the tables and ids are kept for the life of the
+// process, so that GetCallbackID reads them without a lock in the HAL's
+// threads.
+typedef unordered_map<string, const string*> CallbackIdTable;
+static atomic<const CallbackIdTable*> callback_id_table_(nullptr);
+// protects the members below, which own the published tables and ids.
+static mutex callback_ids_lock_;
+static vector<unique_ptr<const CallbackIdTable>> callback_id_tables_;
+static vector<unique_ptr<const string>> callback_ids_;
 
 DriverCallbackBase::DriverCallbackBase() {}
 
@@ -48,18 +69,318 @@ bool DriverCallbackBase::Register(const VariableSpecificationMessage& message) {
     return false;
   }
 
+  lock_guard<mutex> lock(callback_ids_lock_);
+  const CallbackIdTable* current =
+      callback_id_table_.load(memory_order_relaxed);
+  unique_ptr<CallbackIdTable> table(current ? new CallbackIdTable(*current)
+                                            : new CallbackIdTable());
+  bool changed = false;
   for (const auto& func_pt : message.function_pointer()) {
     LOG(DEBUG) << "map[" << func_pt.function_name() << "] = " << func_pt.id();
-    id_map_[func_pt.function_name()] = func_pt.id();
+    auto res = table->find(func_pt.function_name());
+    if (res != table->end() && *res->second == func_pt.id()) {
+      continue;
+    }
+    callback_ids_.emplace_back(new string(func_pt.id()));
+    (*table)[func_pt.function_name()] = callback_ids_.back().get();
+    changed = true;
+  }
+  if (changed) {
+    callback_id_table_.store(table.get(), memory_order_release);
+    callback_id_tables_.push_back(move(table));
   }
   return true;
 }
 
 const char* DriverCallbackBase::GetCallbackID(const string& name) {
-  // TODO: handle when not found.
-  LOG(DEBUG) << "GetCallbackID for " << name << "returns '"
-             << id_map_[name].c_str() << "'";
-  return id_map_[name].c_str();
+  const CallbackIdTable* table =
+      callback_id_table_.load(memory_order_acquire);
+  if (table) {
+    auto res = table->find(name);
+    if (res != table->end()) {
+      return res->second->c_str();
+    }
+  }
+  LOG(WARNING) << "No callback id registered for " << name;
+  return "";
+}
+
+// A long-lived connection to a callback socket. Callers queue their
+// message, then whoever holds send_lock sends everything queued so far, so
+// that concurrent callbacks go out in batches.
+struct CallbackConnection {
+  mutex send_lock;
+  VtsDriverCommUtil util;
+  bool connected = false;
+
+  mutex pending_lock;
+  vector<AndroidSystemCallbackRequestMessage> pending;
+};
+
+static bool persistent_callback_connection_ = false;
+static size_t callback_batch_size_ = 1;
+static mutex callback_connections_lock_;
+static map<string, unique_ptr<CallbackConnection>> callback_connections_;
+
+static atomic<uint64_t> callback_count_(0);
+static atomic<int64_t> first_callback_time_ns_(0);
+static atomic<uint64_t> dropped_callback_count_(0);
+
+static int64_t NowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void CountCallbacks(size_t count) {
+  int64_t no_time = 0;
+  first_callback_time_ns_.compare_exchange_strong(no_time, NowNs());
+  callback_count_ += count;
+}
+
+void DriverCallbackBase::SetPersistentConnection(bool persistent) {
+  persistent_callback_connection_ = persistent;
+}
+
+void DriverCallbackBase::SetCallbackBatchSize(size_t batch_size) {
+  callback_batch_size_ = max<size_t>(batch_size, 1);
+}
+
+uint64_t DriverCallbackBase::GetCallbackCount() {
+  return callback_count_;
+}
+
+double DriverCallbackBase::GetCallbackRate() {
+  int64_t first_callback_time_ns = first_callback_time_ns_;
+  if (first_callback_time_ns == 0) {
+    return 0;
+  }
+  int64_t elapsed_ns = NowNs() - first_callback_time_ns;
+  return elapsed_ns > 0 ? callback_count_ * 1e9 / elapsed_ns : 0;
+}
+
+// Sends the batch over the persistent connection. Returns false if the
+// agent can't be reached. The callbacks which can't be sent are dropped.
+static bool SendCallbackBatch(
+    CallbackConnection* connection,
+    const vector<AndroidSystemCallbackRequestMessage>& batch,
+    const string& callback_socket_name) {
+  vector<const google::protobuf::Message*> messages;
+  for (const auto& batch_message : batch) {
+    messages.push_back(&batch_message);
+  }
+  // reconnects once if the connection is broken.
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!connection->connected) {
+      if (!connection->util.Connect(callback_socket_name)) {
+        dropped_callback_count_ += batch.size();
+        return false;
+      }
+      connection->connected = true;
+    }
+    if (connection->util.VtsSocketSendMessages(messages)) {
+      CountCallbacks(batch.size());
+      return true;
+    }
+    connection->util.Close();
+    connection->connected = false;
+  }
+  LOG(ERROR) << "Failed to send " << batch.size() << " callbacks to "
+             << callback_socket_name;
+  dropped_callback_count_ += batch.size();
+  return true;
+}
+
+static CallbackConnection* GetCallbackConnection(
+    const string& callback_socket_name) {
+  lock_guard<mutex> lock(callback_connections_lock_);
+  unique_ptr<CallbackConnection>& entry =
+      callback_connections_[callback_socket_name];
+  if (!entry) entry.reset(new CallbackConnection());
+  return entry.get();
+}
+
+// Delivers the callbacks to the agent. Returns false if the agent can't be
+// reached. The callbacks which can't be sent are dropped.
+static bool DeliverCallbacks(
+    vector<AndroidSystemCallbackRequestMessage>* messages,
+    const string& callback_socket_name) {
+  if (!persistent_callback_connection_) {
+    for (size_t i = 0; i < messages->size(); i++) {
+      VtsDriverCommUtil util;
+      if (!util.Connect(callback_socket_name)) {
+        dropped_callback_count_ += messages->size() - i;
+        return false;
+      }
+      if (util.VtsSocketSendMessage((*messages)[i])) {
+        CountCallbacks(1);
+      } else {
+        dropped_callback_count_++;
+      }
+      util.Close();
+    }
+    return true;
+  }
+
+  CallbackConnection* connection = GetCallbackConnection(callback_socket_name);
+  {
+    lock_guard<mutex> lock(connection->pending_lock);
+    move(messages->begin(), messages->end(),
+         back_inserter(connection->pending));
+  }
+
+  lock_guard<mutex> lock(connection->send_lock);
+  while (true) {
+    vector<AndroidSystemCallbackRequestMessage> batch;
+    {
+      lock_guard<mutex> pending_lock(connection->pending_lock);
+      if (connection->pending.size() <= callback_batch_size_) {
+        batch.swap(connection->pending);
+      } else {
+        auto end = connection->pending.begin() + callback_batch_size_;
+        move(connection->pending.begin(), end, back_inserter(batch));
+        connection->pending.erase(connection->pending.begin(), end);
+      }
+    }
+    // the messages were sent in the batch of another callback.
+    if (batch.empty()) return true;
+    if (!SendCallbackBatch(connection, batch, callback_socket_name)) {
+      return false;
+    }
+    // a synchronous caller sends at most one batch, as before.
+    if (messages->size() <= 1) return true;
+  }
+}
+
+// A callback waiting in the async queue.
+struct QueuedCallback {
+  string callback_socket_name;
+  AndroidSystemCallbackRequestMessage message;
+};
+
+static mutex async_queue_lock_;
+static condition_variable async_queue_not_empty_;
+static condition_variable async_queue_not_full_;
+static size_t async_queue_capacity_ = 0;
+static bool async_sender_started_ = false;
+// the queued callbacks. The one at the front has sequence number
+// async_queue_front_seq_ and each following one the next number.
+static deque<QueuedCallback> async_queue_;
+static uint64_t async_queue_front_seq_ = 0;
+// the sequence number of the last queued callback of each socket and name,
+// for coalescing.
+static map<pair<string, string>, uint64_t> async_queue_last_seq_;
+static map<string, CallbackQueuePolicy> callback_queue_policies_;
+static atomic<uint64_t> coalesced_callback_count_(0);
+
+// Removes the callback at the front of the async queue into callback.
+static void PopQueuedCallback(QueuedCallback* callback) {
+  *callback = move(async_queue_.front());
+  async_queue_.pop_front();
+  auto last_seq = async_queue_last_seq_.find(
+      make_pair(callback->callback_socket_name, callback->message.name()));
+  if (last_seq != async_queue_last_seq_.end() &&
+      last_seq->second == async_queue_front_seq_) {
+    async_queue_last_seq_.erase(last_seq);
+  }
+  async_queue_front_seq_++;
+}
+
+// Delivers the queued callbacks, in batches of consecutive callbacks to the
+// same socket.
+static void RunAsyncCallbackSender() {
+  while (true) {
+    string callback_socket_name;
+    vector<AndroidSystemCallbackRequestMessage> batch;
+    {
+      unique_lock<mutex> lock(async_queue_lock_);
+      async_queue_not_empty_.wait(lock, [] { return !async_queue_.empty(); });
+      callback_socket_name = async_queue_.front().callback_socket_name;
+      QueuedCallback callback;
+      while (!async_queue_.empty() && batch.size() < callback_batch_size_ &&
+             async_queue_.front().callback_socket_name ==
+                 callback_socket_name) {
+        PopQueuedCallback(&callback);
+        batch.push_back(move(callback.message));
+      }
+    }
+    async_queue_not_full_.notify_all();
+    if (!DeliverCallbacks(&batch, callback_socket_name)) {
+      LOG(ERROR) << "Can't connect to " << callback_socket_name
+                 << ", dropping the callbacks.";
+    }
+  }
+}
+
+// Adds the callback to the async queue, applying the policy of its name when
+// the queue is full.
+static void QueueCallback(const AndroidSystemCallbackRequestMessage& message,
+                          const string& callback_socket_name) {
+  unique_lock<mutex> lock(async_queue_lock_);
+  if (!async_sender_started_) {
+    thread(RunAsyncCallbackSender).detach();
+    async_sender_started_ = true;
+  }
+  CallbackQueuePolicy policy = kCallbackQueueBlock;
+  auto policy_entry = callback_queue_policies_.find(message.name());
+  if (policy_entry != callback_queue_policies_.end()) {
+    policy = policy_entry->second;
+  }
+  pair<string, string> key(callback_socket_name, message.name());
+  if (policy == kCallbackQueueCoalesce) {
+    auto last_seq = async_queue_last_seq_.find(key);
+    if (last_seq != async_queue_last_seq_.end()) {
+      async_queue_[last_seq->second - async_queue_front_seq_].message = message;
+      coalesced_callback_count_++;
+      return;
+    }
+  }
+  if (async_queue_.size() >= async_queue_capacity_) {
+    QueuedCallback oldest;
+    switch (policy) {
+      case kCallbackQueueBlock:
+        async_queue_not_full_.wait(lock, [] {
+          return async_queue_.size() < max<size_t>(async_queue_capacity_, 1);
+        });
+        break;
+      case kCallbackQueueDropOldest:
+        PopQueuedCallback(&oldest);
+        dropped_callback_count_++;
+        break;
+      case kCallbackQueueDropNewest:
+      case kCallbackQueueCoalesce:
+        dropped_callback_count_++;
+        return;
+    }
+  }
+  async_queue_last_seq_[key] = async_queue_front_seq_ + async_queue_.size();
+  async_queue_.push_back({callback_socket_name, message});
+  lock.unlock();
+  async_queue_not_empty_.notify_one();
+}
+
+void DriverCallbackBase::SetAsyncQueueCapacity(size_t capacity) {
+  lock_guard<mutex> lock(async_queue_lock_);
+  async_queue_capacity_ = capacity;
+}
+
+void DriverCallbackBase::SetCallbackQueuePolicy(const string& callback_name,
+                                                CallbackQueuePolicy policy) {
+  lock_guard<mutex> lock(async_queue_lock_);
+  callback_queue_policies_[callback_name] = policy;
+}
+
+size_t DriverCallbackBase::GetQueuedCallbackCount() {
+  lock_guard<mutex> lock(async_queue_lock_);
+  return async_queue_.size();
+}
+
+uint64_t DriverCallbackBase::GetDroppedCallbackCount() {
+  return dropped_callback_count_;
+}
+
+uint64_t DriverCallbackBase::GetCoalescedCallbackCount() {
+  return coalesced_callback_count_;
 }
 
 void DriverCallbackBase::RpcCallToAgent(
@@ -70,10 +391,17 @@ void DriverCallbackBase::RpcCallToAgent(
     LOG(DEBUG) << "Abort callback forwarding.";
     return;
   }
-  VtsDriverCommUtil util;
-  if (!util.Connect(callback_socket_name)) exit(-1);
-  util.VtsSocketSendMessage(message);
-  util.Close();
+  bool async;
+  {
+    lock_guard<mutex> lock(async_queue_lock_);
+    async = async_queue_capacity_ > 0;
+  }
+  if (async) {
+    QueueCallback(message, callback_socket_name);
+    return;
+  }
+  vector<AndroidSystemCallbackRequestMessage> messages(1, message);
+  if (!DeliverCallbacks(&messages, callback_socket_name)) exit(-1);
 }
 
 }  // namespace vts
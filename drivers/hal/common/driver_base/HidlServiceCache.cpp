@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "driver_base/HidlServiceCache.h"
+
+#include <android-base/logging.h>
+
+using android::hidl::base::V1_0::IBase;
+
+namespace android {
+namespace vts {
+
+HidlServiceCache& HidlServiceCache::GetInstance() {
+  // never destroyed, since drivers may get services while exiting.
+  static HidlServiceCache* instance = new HidlServiceCache();
+  return *instance;
+}
+
+HidlServiceCache::HidlServiceCache()
+    : next_cookie_(1), death_recipient_(new DeathRecipient(this)) {}
+
+sp<IBase> HidlServiceCache::Find(const string& descriptor,
+                                 const string& instance, bool get_stub) {
+  lock_guard<mutex> lock(lock_);
+  auto res = entries_.find(make_tuple(descriptor, instance, get_stub));
+  if (res == entries_.end()) return nullptr;
+  return res->second.service;
+}
+
+sp<IBase> HidlServiceCache::Add(const string& descriptor,
+                                const string& instance, bool get_stub,
+                                const sp<IBase>& service) {
+  Key key = make_tuple(descriptor, instance, get_stub);
+  uint64_t cookie;
+  {
+    lock_guard<mutex> lock(lock_);
+    auto res = entries_.find(key);
+    if (res != entries_.end()) return res->second.service;
+    cookie = service->isRemote() ? next_cookie_++ : 0;
+    entries_[key] = {service, cookie};
+    if (cookie != 0) keys_[cookie] = key;
+  }
+  // linked outside the lock, since the death notification takes it.
+  if (cookie != 0) {
+    auto ret = service->linkToDeath(death_recipient_, cookie);
+    if (!ret.isOk() || !ret) {
+      LOG(WARNING) << "Can't link to the death of " << descriptor << "/"
+                   << instance << ", not caching it.";
+      Remove(cookie);
+    }
+  }
+  return service;
+}
+
+void HidlServiceCache::Clear() {
+  map<Key, Entry> entries;
+  {
+    lock_guard<mutex> lock(lock_);
+    entries.swap(entries_);
+    keys_.clear();
+  }
+  for (const auto& entry : entries) {
+    if (entry.second.cookie != 0) {
+      entry.second.service->unlinkToDeath(death_recipient_);
+    }
+  }
+}
+
+void HidlServiceCache::Remove(uint64_t cookie) {
+  sp<IBase> service;
+  {
+    lock_guard<mutex> lock(lock_);
+    auto res = keys_.find(cookie);
+    if (res == keys_.end()) return;
+    auto entry = entries_.find(res->second);
+    // released outside the lock, in case it is the last reference.
+    service = entry->second.service;
+    entries_.erase(entry);
+    keys_.erase(res);
+  }
+}
+
+void HidlServiceCache::DeathRecipient::serviceDied(
+    uint64_t cookie, const wp<IBase>& /*who*/) {
+  LOG(INFO) << "A cached HIDL service died, removing it from the cache.";
+  cache_->Remove(cookie);
+}
+
+}  // namespace vts
+}  // namespace android
@@ -17,12 +17,15 @@
 
 #include "driver_manager/VtsHalDriverManager.h"
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <string>
 
 #include <android-base/logging.h>
 #include <google/protobuf/text_format.h>
 
+#include "utils/DriverTrace.h"
 #include "utils/InterfaceSpecUtil.h"
 #include "utils/StringUtil.h"
 
@@ -33,14 +36,119 @@ static constexpr const int kInvalidDriverId = -1;
 namespace android {
 namespace vts {
 
+// Returns message serialized in the binary format if binary_result is true,
+// or printed in the text format otherwise.
+static string FormatResult(const google::protobuf::Message& message,
+                           bool binary_result) {
+  string output;
+  if (binary_result) {
+    message.SerializeToString(&output);
+  } else {
+    google::protobuf::TextFormat::PrintToString(message, &output);
+  }
+  return output;
+}
+
+// Tells whether a variable of a Hidl HAL specification may hold a resource,
+// i.e. an interface, FMQ, hidl_memory or handle, by looking into the types
+// it contains. A type that is not declared in the types added is assumed to
+// hold one.
+class ResourceTypeFinder {
+ public:
+  // Adds the types declared in attributes, with their nested types.
+  void AddTypes(const google::protobuf::RepeatedPtrField<
+                VariableSpecificationMessage>& attributes) {
+    for (const auto& attribute : attributes) {
+      if (!attribute.name().empty()) {
+        types_.emplace(attribute.name(), &attribute);
+      }
+      AddTypes(attribute.sub_struct());
+      AddTypes(attribute.sub_union());
+      AddTypes(attribute.sub_safe_union());
+    }
+  }
+
+  bool MayHoldResource(const VariableSpecificationMessage& var) {
+    switch (var.type()) {
+      case TYPE_HIDL_INTERFACE:
+      case TYPE_FMQ_SYNC:
+      case TYPE_FMQ_UNSYNC:
+      case TYPE_HIDL_MEMORY:
+      case TYPE_HANDLE:
+        return true;
+      case TYPE_ARRAY:
+      case TYPE_VECTOR:
+        // the element type.
+        return var.vector_value_size() == 0 || AnyMayHoldResource(
+            var.vector_value());
+      case TYPE_REF:
+        return !var.has_ref_value() || MayHoldResource(var.ref_value());
+      case TYPE_STRUCT:
+      case TYPE_UNION:
+      case TYPE_SAFE_UNION:
+        if (var.struct_value_size() > 0 || var.union_value_size() > 0 ||
+            var.safe_union_value_size() > 0) {
+          return AnyMayHoldResource(var.struct_value()) ||
+                 AnyMayHoldResource(var.union_value()) ||
+                 AnyMayHoldResource(var.safe_union_value());
+        }
+        return MayTypeHoldResource(var.predefined_type());
+      default:
+        return false;
+    }
+  }
+
+ private:
+  bool AnyMayHoldResource(const google::protobuf::RepeatedPtrField<
+                          VariableSpecificationMessage>& vars) {
+    for (const auto& var : vars) {
+      if (MayHoldResource(var)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool MayTypeHoldResource(const string& type_name) {
+    auto result = type_results_.find(type_name);
+    if (result != type_results_.end()) {
+      return result->second;
+    }
+    auto type = types_.find(type_name);
+    if (type == types_.end()) {
+      return true;
+    }
+    // a type containing itself, e.g. through a vector, holds a resource
+    // only through its other fields.
+    type_results_[type_name] = false;
+    bool may_hold = MayHoldResource(*type->second);
+    type_results_[type_name] = may_hold;
+    return may_hold;
+  }
+
+  unordered_map<string, const VariableSpecificationMessage*> types_;
+  unordered_map<string, bool> type_results_;
+};
+
 VtsHalDriverManager::VtsHalDriverManager(const string& spec_dir,
                                          const int epoch_count,
                                          const string& callback_socket_name,
                                          VtsResourceManager* resource_manager)
     : callback_socket_name_(callback_socket_name),
-      hal_driver_loader_(
-          HalDriverLoader(spec_dir, epoch_count, callback_socket_name)),
-      resource_manager_(resource_manager) {}
+      hal_driver_loader_(spec_dir, epoch_count, callback_socket_name),
+      resource_manager_(resource_manager),
+      stopping_(false) {}
+
+VtsHalDriverManager::~VtsHalDriverManager() {
+  {
+    lock_guard<mutex> lock(call_queue_lock_);
+    stopping_ = true;
+  }
+  call_queue_cond_.notify_all();
+  for (auto& worker : call_workers_) {
+    worker.join();
+  }
+}
 
 DriverId VtsHalDriverManager::LoadTargetComponent(
     const string& dll_file_name, const string& spec_lib_file_path,
@@ -99,10 +207,10 @@ DriverId VtsHalDriverManager::LoadTargetComponent(
   return RegisterDriver(std::move(hal_driver), spec_message, interface_pt);
 }
 
-string VtsHalDriverManager::CallFunction(FunctionCallMessage* call_msg) {
-  string output = "";
-  DriverBase* driver = GetDriverWithCallMsg(*call_msg);
-  if (!driver) {
+string VtsHalDriverManager::CallFunction(FunctionCallMessage* call_msg,
+                                         bool binary_result) {
+  HalDriverInfo* info = GetDriverInfoWithCallMsg(*call_msg);
+  if (!info) {
     LOG(ERROR) << "can't find driver for component: "
                << GetComponentDebugMsg(
                       call_msg->component_class(), call_msg->component_type(),
@@ -112,40 +220,123 @@ string VtsHalDriverManager::CallFunction(FunctionCallMessage* call_msg) {
                       call_msg->package_name(), call_msg->component_name());
     return kErrorString;
   }
+  return CallDriverFunction(info, call_msg, binary_result);
+}
+
+int VtsHalDriverManager::PrepareCall(const FunctionCallMessage& call_msg) {
+  HalDriverInfo* info = GetDriverInfoWithCallMsg(call_msg);
+  if (!info) {
+    LOG(ERROR) << "Can't prepare call " << call_msg.api().name()
+               << " without a driver.";
+    return -1;
+  }
+  lock_guard<mutex> lock(prepared_calls_lock_);
+  int handle = prepared_calls_.size();
+  prepared_calls_.emplace_back(info, call_msg);
+  return handle;
+}
+
+string VtsHalDriverManager::ExecuteCall(
+    int handle,
+    const google::protobuf::RepeatedPtrField<CallArgumentOverrideMessage>&
+        overrides,
+    bool binary_result) {
+  HalDriverInfo* info;
+  FunctionCallMessage call_msg;
+  {
+    lock_guard<mutex> lock(prepared_calls_lock_);
+    if (handle < 0 || handle >= static_cast<int>(prepared_calls_.size())) {
+      LOG(ERROR) << "Unknown prepared call handle " << handle;
+      return kErrorString;
+    }
+    info = prepared_calls_[handle].first;
+    call_msg = prepared_calls_[handle].second;
+  }
+  FunctionSpecificationMessage* api = call_msg.mutable_api();
+  for (const auto& arg_override : overrides) {
+    if (arg_override.index() < 0 || arg_override.index() >= api->arg_size()) {
+      LOG(ERROR) << "Argument index " << arg_override.index()
+                 << " out of range for " << api->name();
+      return kErrorString;
+    }
+    VariableSpecificationMessage* arg = api->mutable_arg(arg_override.index());
+    if (arg_override.has_arg()) {
+      *arg = arg_override.arg();
+    } else {
+      *arg->mutable_scalar_value() = arg_override.scalar_value();
+    }
+  }
+  return CallDriverFunction(info, &call_msg, binary_result);
+}
 
+string VtsHalDriverManager::CallDriverFunction(HalDriverInfo* info,
+                                               FunctionCallMessage* call_msg,
+                                               bool binary_result) {
+  DriverBase* driver = info->driver.get();
   FunctionSpecificationMessage* api = call_msg->mutable_api();
+  ScopedDriverTrace trace("VtsHalDriverManager::CallFunction", api->name());
   void* result;
   FunctionSpecificationMessage result_msg;
-  driver->FunctionCallBegin();
+  // the time spent in each stage, recorded once the call succeeds.
+  int64_t stage_ns[kDriverStageCount];
+  fill(begin(stage_ns), end(stage_ns), -1);
+  int64_t stage_start = VtsHalDriverStats::NowNs();
+  auto end_stage = [&stage_ns, &stage_start](DriverStage stage) {
+    int64_t now = VtsHalDriverStats::NowNs();
+    stage_ns[stage] = now - stage_start;
+    stage_start = now;
+  };
+  {
+    ScopedDriverTrace stage_trace("coverage");
+    driver->FunctionCallBegin();
+  }
+  // resetting the coverage counts as coverage collection.
+  end_stage(kStageCoverage);
+  int64_t coverage_begin_ns = stage_ns[kStageCoverage];
   LOG(DEBUG) << "Call Function " << api->name();
   if (call_msg->component_class() == HAL_HIDL) {
     // Pre-processing if we want to call an API with an interface as argument.
-    for (int index = 0; index < api->arg_size(); index++) {
-      auto* arg = api->mutable_arg(index);
-      bool process_success = PreprocessHidlHalFunctionCallArgs(arg);
-      if (!process_success) {
-        LOG(ERROR) << "Error in preprocess argument index " << index;
+    {
+      ScopedDriverTrace stage_trace("preprocess");
+      if (!PreprocessHidlHalFunctionCallArgs(*info, api)) {
         return kErrorString;
       }
     }
+    end_stage(kStagePreprocess);
     // For Hidl HAL, use CallFunction method.
+    ScopedDriverTrace stage_trace("call");
     if (!driver->CallFunction(*api, callback_socket_name_, &result_msg)) {
       LOG(ERROR) << "Failed to call function: " << api->DebugString();
       return kErrorString;
     }
   } else {
+    ScopedDriverTrace stage_trace("call");
     if (!driver->Fuzz(api, &result, callback_socket_name_)) {
       LOG(ERROR) << "Failed to call function: " << api->DebugString();
       return kErrorString;
     }
   }
+  end_stage(kStageCall);
   LOG(DEBUG) << "Called function " << api->name();
 
   // set coverage data.
-  driver->FunctionCallEnd(api);
+  {
+    ScopedDriverTrace stage_trace("coverage");
+    driver->FunctionCallEnd(api);
+  }
+  end_stage(kStageCoverage);
+  stage_ns[kStageCoverage] += coverage_begin_ns;
 
+  string output = kVoidString;
+  ScopedDriverTrace results_trace("results");
   if (call_msg->component_class() == HAL_HIDL) {
+    auto api_types = info->api_resource_types.find(api->name());
     for (int index = 0; index < result_msg.return_type_hidl_size(); index++) {
+      if (api_types != info->api_resource_types.end() &&
+          index < static_cast<int>(api_types->second.returns.size()) &&
+          !api_types->second.returns[index]) {
+        continue;
+      }
       auto* return_val = result_msg.mutable_return_type_hidl(index);
       bool set_success = SetHidlHalFunctionCallResults(return_val);
       if (!set_success) {
@@ -153,12 +344,103 @@ string VtsHalDriverManager::CallFunction(FunctionCallMessage* call_msg) {
         return kErrorString;
       }
     }
-    google::protobuf::TextFormat::PrintToString(result_msg, &output);
-    return output;
+    end_stage(kStageResults);
+    output = FormatResult(result_msg, binary_result);
   } else if (call_msg->component_class() == LIB_SHARED) {
-    return ProcessFuncResultsForLibrary(api, result);
+    output = ProcessFuncResultsForLibrary(api, result, binary_result);
+  }
+  end_stage(kStageFormat);
+  stats_.Record(call_msg->component_name() + "::" + api->name(), stage_ns);
+  return output;
+}
+
+bool VtsHalDriverManager::CallFunctions(
+    google::protobuf::RepeatedPtrField<FunctionCallMessage>* call_msgs,
+    bool stop_on_error, bool binary_result, vector<string>* results) {
+  bool success = true;
+  results->reserve(results->size() + call_msgs->size());
+  for (auto& call_msg : *call_msgs) {
+    results->push_back(CallFunction(&call_msg, binary_result));
+    if (results->back() == kErrorString) {
+      success = false;
+      if (stop_on_error) {
+        LOG(ERROR) << "Stop calling functions after "
+                   << call_msg.api().name();
+        break;
+      }
+    }
+  }
+  return success;
+}
+
+void VtsHalDriverManager::CallFunctionAsync(
+    const FunctionCallMessage& call_msg, bool binary_result,
+    function<void(const string&)> done) {
+  DriverBase* driver = GetDriverWithCallMsg(call_msg);
+  // traces the call from the time it is queued.
+  int32_t trace_cookie = 0;
+  if (IsDriverTraceEnabled()) {
+    trace_cookie = ++async_trace_cookie_;
+    DriverTraceAsyncBegin("VtsHalDriverManager::CallFunctionAsync",
+                          trace_cookie);
+  }
+  auto call = [this, msg = call_msg, binary_result, done,
+               trace_cookie]() mutable {
+    done(CallFunction(&msg, binary_result));
+    if (trace_cookie) {
+      DriverTraceAsyncEnd("VtsHalDriverManager::CallFunctionAsync",
+                          trace_cookie);
+    }
+  };
+  if (call_workers_.empty() || !driver) {
+    call();
+    return;
+  }
+  {
+    lock_guard<mutex> lock(call_queue_lock_);
+    deque<function<void()>>& queue = driver_call_queues_[driver];
+    queue.push_back(move(call));
+    if (queue.size() > 1) {
+      // a worker runs the call after the ones before it.
+      return;
+    }
+    ready_drivers_.push_back(driver);
+  }
+  call_queue_cond_.notify_one();
+}
+
+void VtsHalDriverManager::SetCallWorkerCount(size_t count) {
+  if (!call_workers_.empty()) {
+    LOG(ERROR) << "Call workers already started.";
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    call_workers_.emplace_back(&VtsHalDriverManager::RunCallWorker, this);
+  }
+}
+
+void VtsHalDriverManager::RunCallWorker() {
+  unique_lock<mutex> lock(call_queue_lock_);
+  while (true) {
+    call_queue_cond_.wait(
+        lock, [this] { return stopping_ || !ready_drivers_.empty(); });
+    if (ready_drivers_.empty()) {
+      return;
+    }
+    DriverBase* driver = ready_drivers_.front();
+    ready_drivers_.pop_front();
+    deque<function<void()>>& queue = driver_call_queues_[driver];
+    function<void()> call = move(queue.front());
+    lock.unlock();
+    call();
+    lock.lock();
+    queue.pop_front();
+    if (!queue.empty()) {
+      // goes after the other ready drivers to share the workers fairly.
+      ready_drivers_.push_back(driver);
+      call_queue_cond_.notify_one();
+    }
   }
-  return kVoidString;
 }
 
 bool VtsHalDriverManager::VerifyResults(
@@ -172,8 +454,147 @@ bool VtsHalDriverManager::VerifyResults(
   return driver->VerifyResults(expected_result, actual_result);
 }
 
-string VtsHalDriverManager::GetAttribute(FunctionCallMessage* call_msg) {
-  string output = "";
+bool VtsHalDriverManager::SetCoverageOptions(
+    const VtsDriverControlCommandMessage& command) {
+  DriverBase* driver = GetDriverById(command.coverage_driver_id());
+  if (!driver) {
+    LOG(ERROR) << "Can't find driver with id: "
+               << command.coverage_driver_id();
+    return false;
+  }
+  if (command.has_include_raw_coverage_data()) {
+    driver->SetIncludeRawCoverageData(command.include_raw_coverage_data());
+  }
+  if (command.has_report_coverage_delta()) {
+    driver->SetReportCoverageDelta(command.report_coverage_delta());
+  }
+  if (command.reset_coverage_delta()) {
+    driver->ResetCoverageDelta();
+  }
+  if (command.has_in_memory_coverage()) {
+    driver->SetInMemoryCoverage(command.in_memory_coverage());
+  }
+  return true;
+}
+
+bool VtsHalDriverManager::CallFunctionAndVerify(
+    FunctionCallMessage* call_msg,
+    const FunctionSpecificationMessage& expected_result, bool* verified) {
+  *verified = false;
+  if (call_msg->component_class() != HAL_HIDL) {
+    LOG(ERROR) << "Only HIDL HAL calls can be verified on the driver side.";
+    return false;
+  }
+  HalDriverInfo* info = GetDriverInfoWithCallMsg(*call_msg);
+  if (!info) {
+    LOG(ERROR) << "Can't find driver for " << call_msg->component_name();
+    return false;
+  }
+  DriverBase* driver = info->driver.get();
+  FunctionSpecificationMessage* api = call_msg->mutable_api();
+  // the time spent in each stage, recorded once the call succeeds. There is
+  // no result stage, since the results are not converted.
+  int64_t stage_ns[kDriverStageCount];
+  fill(begin(stage_ns), end(stage_ns), -1);
+  int64_t stage_start = VtsHalDriverStats::NowNs();
+  auto end_stage = [&stage_ns, &stage_start](DriverStage stage) {
+    int64_t now = VtsHalDriverStats::NowNs();
+    stage_ns[stage] = now - stage_start;
+    stage_start = now;
+  };
+  driver->FunctionCallBegin();
+  end_stage(kStageCoverage);
+  int64_t coverage_begin_ns = stage_ns[kStageCoverage];
+  if (!PreprocessHidlHalFunctionCallArgs(*info, api)) {
+    return false;
+  }
+  end_stage(kStagePreprocess);
+  if (!driver->CallFunctionAndVerify(*api, callback_socket_name_,
+                                     expected_result, verified)) {
+    LOG(ERROR) << "Failed to call function: " << api->DebugString();
+    return false;
+  }
+  end_stage(kStageCall);
+  driver->FunctionCallEnd(api);
+  end_stage(kStageCoverage);
+  stage_ns[kStageCoverage] += coverage_begin_ns;
+  stats_.Record(call_msg->component_name() + "::" + api->name(), stage_ns);
+  return true;
+}
+
+string VtsHalDriverManager::CallFunctionRepeated(FunctionCallMessage* call_msg,
+                                                 int count,
+                                                 bool binary_result) {
+  if (call_msg->component_class() != LIB_SHARED) {
+    LOG(ERROR) << "Only shared library functions can be called repeatedly.";
+    return kErrorString;
+  }
+  if (count < 0 || count > kMaxRepeatCount) {
+    LOG(ERROR) << "Invalid repeat count " << count;
+    return kErrorString;
+  }
+  HalDriverInfo* info = GetDriverInfoWithCallMsg(*call_msg);
+  if (!info) {
+    LOG(ERROR) << "Can't find driver for " << call_msg->component_name();
+    return kErrorString;
+  }
+  DriverBase* driver = info->driver.get();
+  FunctionSpecificationMessage* api = call_msg->mutable_api();
+  ScopedDriverTrace trace("VtsHalDriverManager::CallFunctionRepeated",
+                          api->name());
+  vector<void*> results;
+  results.reserve(count);
+  driver->FunctionCallBegin();
+  int64_t start_ns = VtsHalDriverStats::NowNs();
+  int call_count =
+      driver->FuzzRepeated(api, count, callback_socket_name_, &results);
+  int64_t elapsed_ns = VtsHalDriverStats::NowNs() - start_ns;
+  driver->FunctionCallEnd(api);
+  if (call_count < count) {
+    LOG(ERROR) << "Failed to call function " << api->name() << " after "
+               << call_count << " calls";
+  }
+
+  RepeatedCallResultMessage result_msg;
+  result_msg.set_call_count(call_count);
+  result_msg.set_elapsed_ns(elapsed_ns);
+  if (api->has_return_type() && api->return_type().type() != TYPE_VOID) {
+    // The values are read as ProcessFuncResultsForLibrary does, i.e. the
+    // 32-bit scalars from the lower half of the pointer.
+    const string& scalar_type = api->return_type().scalar_type();
+    bool is_32_bit = api->return_type().type() == TYPE_SCALAR &&
+                     (scalar_type == "int32_t" || scalar_type == "uint32_t" ||
+                      scalar_type == "int16_t" || scalar_type == "uint16_t");
+    // the index in result_msg of each value counted.
+    unordered_map<int64_t, int> result_index;
+    int64_t other_result_count = 0;
+    for (int i = 0; i < call_count && i < static_cast<int>(results.size());
+         i++) {
+      int64_t value = reinterpret_cast<intptr_t>(results[i]);
+      if (is_32_bit) {
+        value = static_cast<int32_t>(value);
+      }
+      auto it = result_index.find(value);
+      if (it != result_index.end()) {
+        auto* result = result_msg.mutable_result(it->second);
+        result->set_count(result->count() + 1);
+      } else if (result_msg.result_size() < kMaxRepeatedCallResults) {
+        result_index.emplace(value, result_msg.result_size());
+        auto* result = result_msg.add_result();
+        result->set_value(value);
+        result->set_count(1);
+      } else {
+        other_result_count++;
+      }
+    }
+    result_msg.set_other_result_count(other_result_count);
+  }
+  *result_msg.mutable_api() = std::move(*api);
+  return FormatResult(result_msg, binary_result);
+}
+
+string VtsHalDriverManager::GetAttribute(FunctionCallMessage* call_msg,
+                                         bool binary_result) {
   DriverBase* driver = GetDriverWithCallMsg(*call_msg);
   if (!driver) {
     LOG(ERROR) << "Can't find driver for component: "
@@ -202,11 +623,9 @@ string VtsHalDriverManager::GetAttribute(FunctionCallMessage* call_msg) {
     api->mutable_return_type()->mutable_string_value()->set_length(
         ((string*)result)->size());
     free(result);
-    string* output = new string();
-    google::protobuf::TextFormat::PrintToString(*api, output);
-    return *output;
+    return FormatResult(*api, binary_result);
   } else if (call_msg->component_class() == LIB_SHARED) {
-    return ProcessFuncResultsForLibrary(api, result);
+    return ProcessFuncResultsForLibrary(api, result, binary_result);
   }
   return kVoidString;
 }
@@ -215,36 +634,64 @@ DriverId VtsHalDriverManager::RegisterDriver(
     std::unique_ptr<DriverBase> driver,
     const ComponentSpecificationMessage& spec_msg,
     const uint64_t interface_pt) {
+  lock_guard<mutex> lock(driver_register_lock_);
   DriverId driver_id = FindDriverIdInternal(spec_msg, interface_pt, true);
-  if (driver_id == kInvalidDriverId) {
-    driver_id = hal_driver_map_.size();
-    hal_driver_map_.insert(make_pair(
-        driver_id, HalDriverInfo(spec_msg, interface_pt, std::move(driver))));
-  } else {
+  if (driver_id != kInvalidDriverId) {
     LOG(WARNING) << "Driver already exists. ";
+    return driver_id;
+  }
+  driver_id = driver_count_.load(memory_order_relaxed);
+  size_t chunk = driver_id / kDriverChunkSize;
+  if (chunk >= kMaxDriverChunks) {
+    LOG(ERROR) << "Too many drivers registered: " << driver_id;
+    return kInvalidDriverId;
+  }
+  if (driver_chunks_[chunk] == nullptr) {
+    owned_driver_chunks_.emplace_back(new HalDriverInfo*[kDriverChunkSize]);
+    driver_chunks_[chunk] = owned_driver_chunks_.back().get();
+  }
+  drivers_.emplace_back(
+      new HalDriverInfo(spec_msg, interface_pt, std::move(driver)));
+  if (spec_msg.component_class() == HAL_HIDL) {
+    FindApiResourceTypes(spec_msg, &drivers_.back()->api_resource_types);
+  }
+  driver_chunks_[chunk][driver_id % kDriverChunkSize] = drivers_.back().get();
+  driver_count_.store(driver_id + 1, memory_order_release);
+  if (IsIndexedHidlSpec(spec_msg)) {
+    string key = GetHidlDriverKey(spec_msg);
+    // keeps the first driver of the interface, as the scan did.
+    AddHidlDriverId(key, driver_id);
+    AddHidlDriverId(GetHidlDriverKey(key, interface_pt), driver_id);
   }
-
   return driver_id;
 }
 
+VtsHalDriverManager::HalDriverInfo* VtsHalDriverManager::GetDriverInfoById(
+    const DriverId id) {
+  if (id < 0 || id >= driver_count_.load(memory_order_acquire)) {
+    return nullptr;
+  }
+  return driver_chunks_[id / kDriverChunkSize][id % kDriverChunkSize];
+}
+
 DriverBase* VtsHalDriverManager::GetDriverById(const DriverId id) {
-  auto res = hal_driver_map_.find(id);
-  if (res == hal_driver_map_.end()) {
+  HalDriverInfo* info = GetDriverInfoById(id);
+  if (info == nullptr) {
     LOG(ERROR) << "Failed to find driver info with id: " << id;
     return nullptr;
   }
   LOG(DEBUG) << "Found driver info with id: " << id;
-  return res->second.driver.get();
+  return info->driver.get();
 }
 
 uint64_t VtsHalDriverManager::GetDriverPointerById(const DriverId id) {
-  auto res = hal_driver_map_.find(id);
-  if (res == hal_driver_map_.end()) {
+  HalDriverInfo* info = GetDriverInfoById(id);
+  if (info == nullptr) {
     LOG(ERROR) << "Failed to find driver info with id: " << id;
     return 0;
   }
   LOG(DEBUG) << "Found driver info with id: " << id;
-  return res->second.hidl_hal_proxy_pt;
+  return info->hidl_hal_proxy_pt;
 }
 
 DriverId VtsHalDriverManager::GetDriverIdForHidlHalInterface(
@@ -280,13 +727,56 @@ bool VtsHalDriverManager::FindComponentSpecification(
 
 ComponentSpecificationMessage*
 VtsHalDriverManager::GetComponentSpecification() {
-  if (hal_driver_map_.empty()) {
+  HalDriverInfo* info = GetDriverInfoById(0);
+  if (info == nullptr) {
     return nullptr;
   } else {
-    return &(hal_driver_map_.find(0)->second.spec_msg);
+    return &info->spec_msg;
   }
 }
 
+DriverId VtsHalDriverManager::FindHidlDriverId(const string& key) {
+  HidlDriverIndexShard& shard =
+      hidl_driver_index_[hash<string>()(key) % kHidlDriverIndexShardCount];
+  shared_lock<shared_mutex> lock(shard.lock);
+  auto res = shard.driver_ids.find(key);
+  if (res == shard.driver_ids.end()) {
+    return kInvalidDriverId;
+  }
+  return res->second;
+}
+
+void VtsHalDriverManager::AddHidlDriverId(const string& key, DriverId id) {
+  HidlDriverIndexShard& shard =
+      hidl_driver_index_[hash<string>()(key) % kHidlDriverIndexShardCount];
+  lock_guard<shared_mutex> lock(shard.lock);
+  shard.driver_ids.emplace(key, id);
+}
+
+bool VtsHalDriverManager::IsIndexedHidlSpec(
+    const ComponentSpecificationMessage& spec_msg) {
+  return spec_msg.component_class() == HAL_HIDL && spec_msg.has_package() &&
+         spec_msg.has_component_type_version_major() &&
+         spec_msg.has_component_type_version_minor();
+}
+
+string VtsHalDriverManager::GetHidlDriverKey(
+    const ComponentSpecificationMessage& spec_msg) {
+  string key = spec_msg.package();
+  key += '@';
+  key += to_string(spec_msg.component_type_version_major());
+  key += '.';
+  key += to_string(spec_msg.component_type_version_minor());
+  key += "::";
+  key += spec_msg.component_name();
+  return key;
+}
+
+string VtsHalDriverManager::GetHidlDriverKey(const string& key,
+                                             const uint64_t interface_pt) {
+  return key + '#' + to_string(interface_pt);
+}
+
 DriverId VtsHalDriverManager::FindDriverIdInternal(
     const ComponentSpecificationMessage& spec_msg, const uint64_t interface_pt,
     bool with_interface_pointer) {
@@ -309,8 +799,23 @@ DriverId VtsHalDriverManager::FindDriverIdInternal(
       return kInvalidDriverId;
     }
   }
-  for (auto it = hal_driver_map_.begin(); it != hal_driver_map_.end(); ++it) {
-    ComponentSpecificationMessage cur_spec_msg = it->second.spec_msg;
+  if (spec_msg.component_class() == HAL_HIDL) {
+    string key = GetHidlDriverKey(spec_msg);
+    if (with_interface_pointer) {
+      key = GetHidlDriverKey(key, interface_pt);
+    }
+    DriverId driver_id = FindHidlDriverId(key);
+    if (driver_id == kInvalidDriverId) {
+      LOG(DEBUG) << "Couldn't find the hidl hal driver.";
+      return kInvalidDriverId;
+    }
+    LOG(DEBUG) << "Found hidl hal driver with id: " << driver_id;
+    return driver_id;
+  }
+  DriverId driver_count = driver_count_.load(memory_order_acquire);
+  for (DriverId id = 0; id < driver_count; id++) {
+    const ComponentSpecificationMessage& cur_spec_msg =
+        GetDriverInfoById(id)->spec_msg;
     if (cur_spec_msg.component_class() != spec_msg.component_class()) {
       continue;
     }
@@ -333,21 +838,11 @@ DriverId VtsHalDriverManager::FindDriverIdInternal(
         continue;
       }
     }
-    if (spec_msg.component_class() == HAL_HIDL) {
-      if (cur_spec_msg.component_name() != spec_msg.component_name()) {
-        continue;
-      }
-      if (with_interface_pointer &&
-          it->second.hidl_hal_proxy_pt != interface_pt) {
-        continue;
-      }
-      LOG(DEBUG) << "Found hidl hal driver with id: " << it->first;
-      return it->first;
-    } else if (spec_msg.component_class() == LIB_SHARED) {
+    if (spec_msg.component_class() == LIB_SHARED) {
       if (spec_msg.has_component_type() &&
           cur_spec_msg.component_type() == spec_msg.component_type()) {
-        LOG(DEBUG) << "Found shared lib driver with id: " << it->first;
-        return it->first;
+        LOG(DEBUG) << "Found shared lib driver with id: " << id;
+        return id;
       }
     }
   }
@@ -356,6 +851,13 @@ DriverId VtsHalDriverManager::FindDriverIdInternal(
 
 DriverBase* VtsHalDriverManager::GetDriverWithCallMsg(
     const FunctionCallMessage& call_msg) {
+  HalDriverInfo* info = GetDriverInfoWithCallMsg(call_msg);
+  return info ? info->driver.get() : nullptr;
+}
+
+VtsHalDriverManager::HalDriverInfo*
+VtsHalDriverManager::GetDriverInfoWithCallMsg(
+    const FunctionCallMessage& call_msg) {
   DriverId driver_id = kInvalidDriverId;
   // If call_mag contains driver_id, use that given driver id.
   if (call_msg.has_hal_driver_id() &&
@@ -381,14 +883,16 @@ DriverBase* VtsHalDriverManager::GetDriverWithCallMsg(
                << GetVersionString(call_msg.component_type_version_major(),
                                    call_msg.component_type_version_minor());
     return nullptr;
-  } else {
-    return GetDriverById(driver_id);
   }
+  HalDriverInfo* info = GetDriverInfoById(driver_id);
+  if (!info) {
+    LOG(ERROR) << "Failed to find driver info with id: " << driver_id;
+  }
+  return info;
 }
 
 string VtsHalDriverManager::ProcessFuncResultsForLibrary(
-    FunctionSpecificationMessage* func_msg, void* result) {
-  string output = "";
+    FunctionSpecificationMessage* func_msg, void* result, bool binary_result) {
   if (func_msg->return_type().type() == TYPE_PREDEFINED) {
     // TODO: actually handle this case.
     if (result != NULL) {
@@ -398,32 +902,27 @@ string VtsHalDriverManager::ProcessFuncResultsForLibrary(
       LOG(ERROR) << "Return value = NULL";
     }
     LOG(ERROR) << "Todo: support aggregate";
-    google::protobuf::TextFormat::PrintToString(*func_msg, &output);
-    return output;
+    return FormatResult(*func_msg, binary_result);
   } else if (func_msg->return_type().type() == TYPE_SCALAR) {
     // TODO handle when the size > 1.
     // todo handle more types;
     if (!strcmp(func_msg->return_type().scalar_type().c_str(), "int32_t")) {
       func_msg->mutable_return_type()->mutable_scalar_value()->set_int32_t(
           *((int*)(&result)));
-      google::protobuf::TextFormat::PrintToString(*func_msg, &output);
-      return output;
+      return FormatResult(*func_msg, binary_result);
     } else if (!strcmp(func_msg->return_type().scalar_type().c_str(),
                        "uint32_t")) {
       func_msg->mutable_return_type()->mutable_scalar_value()->set_uint32_t(
           *((int*)(&result)));
-      google::protobuf::TextFormat::PrintToString(*func_msg, &output);
-      return output;
+      return FormatResult(*func_msg, binary_result);
     } else if (!strcmp(func_msg->return_type().scalar_type().c_str(),
                        "int16_t")) {
       func_msg->mutable_return_type()->mutable_scalar_value()->set_int16_t(
           *((int*)(&result)));
-      google::protobuf::TextFormat::PrintToString(*func_msg, &output);
-      return output;
+      return FormatResult(*func_msg, binary_result);
     } else if (!strcmp(func_msg->return_type().scalar_type().c_str(),
                        "uint16_t")) {
-      google::protobuf::TextFormat::PrintToString(*func_msg, &output);
-      return output;
+      return FormatResult(*func_msg, binary_result);
     }
   }
   return kVoidString;
@@ -442,11 +941,83 @@ string VtsHalDriverManager::GetComponentDebugMsg(const int component_class,
   }
 }
 
+void VtsHalDriverManager::FindApiResourceTypes(
+    const ComponentSpecificationMessage& spec_msg,
+    unordered_map<string, ApiResourceTypes>* apis) {
+  // the specifications declaring the types the APIs may use.
+  vector<ComponentSpecificationMessage> type_specs(1, spec_msg);
+  for (const auto& import : spec_msg.import()) {
+    // e.g. android.hardware.nfc@1.0::types
+    string::size_type at = import.find('@');
+    string::size_type colons = import.find("::");
+    ComponentSpecificationMessage import_spec;
+    if (at == string::npos || colons == string::npos || colons < at ||
+        !hal_driver_loader_.FindComponentSpecification(
+            HAL_HIDL, import.substr(0, at),
+            GetVersionMajor(import.substr(at + 1, colons - at - 1)),
+            GetVersionMinor(import.substr(at + 1, colons - at - 1)),
+            import.substr(colons + 2), 0, &import_spec)) {
+      // the types it declares are assumed to hold resources.
+      LOG(DEBUG) << "Can't find the specification of " << import;
+      continue;
+    }
+    type_specs.push_back(move(import_spec));
+  }
+  ResourceTypeFinder finder;
+  for (const auto& type_spec : type_specs) {
+    finder.AddTypes(type_spec.attribute());
+    finder.AddTypes(type_spec.interface().attribute());
+  }
+  for (const auto& api : spec_msg.interface().api()) {
+    ApiResourceTypes& api_types = (*apis)[api.name()];
+    for (const auto& arg : api.arg()) {
+      api_types.args.push_back(finder.MayHoldResource(arg));
+    }
+    for (const auto& return_val : api.return_type_hidl()) {
+      api_types.returns.push_back(finder.MayHoldResource(return_val));
+    }
+  }
+}
+
+bool VtsHalDriverManager::PreprocessHidlHalFunctionCallArgs(
+    const HalDriverInfo& info, FunctionSpecificationMessage* api) {
+  auto api_types = info.api_resource_types.find(api->name());
+  for (int index = 0; index < api->arg_size(); index++) {
+    auto* arg = api->mutable_arg(index);
+    // a vector given in a hidl_memory is preprocessed whatever its type.
+    if (api_types != info.api_resource_types.end() &&
+        index < static_cast<int>(api_types->second.args.size()) &&
+        !api_types->second.args[index] && !arg->has_vector_memory_region()) {
+      continue;
+    }
+    if (!PreprocessHidlHalFunctionCallArgs(arg)) {
+      LOG(ERROR) << "Error in preprocess argument index " << index;
+      return false;
+    }
+  }
+  return true;
+}
+
 bool VtsHalDriverManager::PreprocessHidlHalFunctionCallArgs(
     VariableSpecificationMessage* arg) {
   switch (arg->type()) {
     case TYPE_ARRAY:
     case TYPE_VECTOR: {
+      if (arg->has_vector_memory_region()) {
+        // Preprocess a vector whose elements are in an existing hidl_memory.
+        // resource_manager returns the address of the range, and
+        // driver_manager fills the address in the proto field, which can be
+        // read by vtsc.
+        size_t region_address;
+        bool success = resource_manager_->GetHidlMemoryRegionAddress(
+            arg->vector_memory_region(), &region_address);
+        if (!success) {
+          LOG(ERROR) << "Unable to find the range of hidl_memory with id "
+                     << arg->vector_memory_region().mem_id();
+          return false;
+        }
+        arg->mutable_vector_memory_region()->set_address(region_address);
+      }
       // Recursively parse each element in the vector/array.
       for (int i = 0; i < arg->vector_size(); i++) {
         if (!PreprocessHidlHalFunctionCallArgs(arg->mutable_vector_value(i))) {
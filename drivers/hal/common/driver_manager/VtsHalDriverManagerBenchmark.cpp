@@ -0,0 +1,474 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "driver_manager/VtsHalDriverManager.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <android-base/logging.h>
+#include <benchmark/benchmark.h>
+#include <google/protobuf/text_format.h>
+
+#include "VtsDriverCommUtil.h"
+#include "VtsLatencyHistogram.h"
+#include "driver_manager/VtsHalDriverStats.h"
+#include "resource_manager/VtsResourceManager.h"
+#include "test/vts/proto/AndroidSystemControlMessage.pb.h"
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
+
+using namespace std;
+
+// Measures the round trip of the commands from a client to the HAL driver
+// over a unix socket, as the host sends them through the agent, with the
+// driver of the Bar test HAL whose generated code is in
+// compilation_tools/vtsc/test/golden. Reports the calls per second and the
+// latency percentiles of each kind of call, then the time the driver spent
+// in each stage of the commands, from GET_STATS.
+//
+// The driver serves the commands on a thread of this process, with a
+// VtsHalDriverManager as the driver process does, so that the benchmark
+// doesn't depend on the agent.
+//
+// Usage: vts_hal_driver_benchmark [<spec dir> [<socket dir>]]
+// where <spec dir> holds the interface specification files, by default
+// /data/local/tmp/spec/, and <socket dir> is where the driver and callback
+// sockets are made, by default /data/local/tmp/. The Bar HAL service has to
+// be running, e.g. android.hardware.tests.bar@1.0-service.
+
+namespace android {
+namespace vts {
+
+static const char kBarPackage[] = "android.hardware.tests.bar";
+static const int kBarVersionMajor = 1;
+static const int kBarVersionMinor = 0;
+static const char kBarComponentName[] = "IBar";
+static const char kBarServiceName[] = "default";
+
+// The value returned by VtsHalDriverManager on error.
+static const char kDriverErrorString[] = "error";
+
+// Returns a unix socket listening at path, or -1 on error.
+static int ListenUnixSocket(const string& path) {
+  struct sockaddr_un addr = {};
+  if (path.size() >= sizeof(addr.sun_path)) {
+    LOG(ERROR) << "Socket path too long: " << path;
+    return -1;
+  }
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path.c_str());
+  unlink(path.c_str());
+  int sockfd = socket(PF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sockfd < 0) {
+    PLOG(ERROR) << "Can't open a socket";
+    return -1;
+  }
+  if (bind(sockfd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) <
+          0 ||
+      listen(sockfd, 5) < 0) {
+    PLOG(ERROR) << "Can't listen at " << path;
+    close(sockfd);
+    return -1;
+  }
+  return sockfd;
+}
+
+// Counts the callback messages that the driver sends to the agent. Each
+// connection is read until the driver closes it, which it does after each
+// message unless the callback connection is persistent.
+class CallbackListener {
+ public:
+  CallbackListener() : listen_fd_(-1), message_count_(0) {}
+
+  ~CallbackListener() { Stop(); }
+
+  // Starts to accept the connections at socket_name.
+  // Returns true iff successful.
+  bool Start(const string& socket_name) {
+    listen_fd_ = ListenUnixSocket(socket_name);
+    if (listen_fd_ < 0) return false;
+    thread_ = thread(&CallbackListener::Run, this);
+    return true;
+  }
+
+  void Stop() {
+    if (listen_fd_ < 0) return;
+    shutdown(listen_fd_, SHUT_RDWR);
+    thread_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+  }
+
+  uint64_t GetMessageCount() const { return message_count_; }
+
+ private:
+  void Run() {
+    int sockfd;
+    while ((sockfd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC)) >=
+           0) {
+      VtsDriverCommUtil util(sockfd);
+      AndroidSystemCallbackRequestMessage message;
+      while (util.VtsSocketRecvMessage(&message)) {
+        message_count_++;
+      }
+      util.Close();
+    }
+  }
+
+  int listen_fd_;
+  thread thread_;
+  atomic<uint64_t> message_count_;
+};
+
+// Serves the commands of one client with a VtsHalDriverManager, as the
+// driver process does for the agent. Records the time spent receiving and
+// sending each command in the stats of the driver manager, which records
+// the other stages.
+class DriverServer {
+ public:
+  DriverServer(const string& spec_dir, const string& callback_socket_name)
+      : driver_manager_(spec_dir, 10, callback_socket_name,
+                        &resource_manager_),
+        listen_fd_(-1) {}
+
+  ~DriverServer() { Stop(); }
+
+  // Starts to serve the first connection at socket_name.
+  // Returns true iff successful.
+  bool Start(const string& socket_name) {
+    listen_fd_ = ListenUnixSocket(socket_name);
+    if (listen_fd_ < 0) return false;
+    thread_ = thread(&DriverServer::Run, this);
+    return true;
+  }
+
+  // Waits for the client to close its connection or to send EXIT.
+  void Stop() {
+    if (listen_fd_ < 0) return;
+    shutdown(listen_fd_, SHUT_RDWR);
+    thread_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+  }
+
+ private:
+  void Run() {
+    int sockfd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (sockfd < 0) return;
+    VtsDriverCommUtil util(sockfd);
+    struct pollfd readable = {sockfd, POLLIN, 0};
+    while (true) {
+      // the receive stage starts once the command arrives, not while the
+      // client prepares it.
+      if (poll(&readable, 1, -1) < 0) {
+        if (errno == EINTR) continue;
+        PLOG(ERROR) << "Can't poll the driver socket";
+        break;
+      }
+      int64_t receive_start_ns = VtsHalDriverStats::NowNs();
+      VtsDriverControlCommandMessage command;
+      if (!util.VtsSocketRecvMessage(&command)) break;
+      if (command.command_type() == EXIT) break;
+      string api;
+      FunctionCallMessage call_msg;
+      if (command.command_type() == CALL_FUNCTION) {
+        if (!google::protobuf::TextFormat::ParseFromString(command.arg(),
+                                                           &call_msg)) {
+          LOG(ERROR) << "Can't parse the function call.";
+        }
+        api = call_msg.component_name() + "::" + call_msg.api().name();
+      } else {
+        api = VtsDriverCommandType_Name(command.command_type());
+      }
+      int64_t receive_ns = VtsHalDriverStats::NowNs() - receive_start_ns;
+
+      VtsDriverControlResponseMessage response;
+      response.set_request_id(command.request_id());
+      response.set_response_code(
+          ProcessCommand(command, &call_msg, &response)
+              ? VTS_DRIVER_RESPONSE_SUCCESS
+              : VTS_DRIVER_RESPONSE_FAIL);
+
+      int64_t send_start_ns = VtsHalDriverStats::NowNs();
+      if (!util.VtsSocketSendMessage(response)) break;
+      VtsHalDriverStats* stats = driver_manager_.GetStats();
+      stats->Record(api, kStageReceive, receive_ns);
+      stats->Record(api, kStageSend,
+                    VtsHalDriverStats::NowNs() - send_start_ns);
+    }
+    util.Close();
+  }
+
+  // Runs command, whose function call is parsed into call_msg if it is a
+  // CALL_FUNCTION, and fills in response.
+  // Returns true iff successful.
+  bool ProcessCommand(const VtsDriverControlCommandMessage& command,
+                      FunctionCallMessage* call_msg,
+                      VtsDriverControlResponseMessage* response) {
+    switch (command.command_type()) {
+      case LOAD_HAL: {
+        DriverId driver_id = driver_manager_.LoadTargetComponent(
+            command.file_path(), command.module_name(), command.target_class(),
+            command.target_type(), command.target_version_major(),
+            command.target_version_minor(), command.target_package(),
+            command.target_component_name(),
+            command.hw_binder_service_name());
+        response->set_return_value(driver_id);
+        return driver_id >= 0;
+      }
+      case CALL_FUNCTION: {
+        string result = driver_manager_.CallFunction(
+            call_msg, command.binary_return_message());
+        if (result == kDriverErrorString) return false;
+        response->set_return_message(result);
+        response->set_binary_return_message(command.binary_return_message());
+        return true;
+      }
+      case SET_COVERAGE_OPTIONS:
+        return driver_manager_.SetCoverageOptions(command);
+      case GET_STATS:
+        response->set_return_message(driver_manager_.GetStats()->Dump());
+        return true;
+      case RESET_STATS:
+        driver_manager_.GetStats()->Reset();
+        return true;
+      default:
+        LOG(ERROR) << "Unsupported command "
+                   << VtsDriverCommandType_Name(command.command_type());
+        return false;
+    }
+  }
+
+  VtsResourceManager resource_manager_;
+  VtsHalDriverManager driver_manager_;
+  int listen_fd_;
+  thread thread_;
+};
+
+// Sends command to the driver and receives its response.
+// Returns true iff the driver succeeds.
+static bool SendCommand(VtsDriverCommUtil* util,
+                        const VtsDriverControlCommandMessage& command,
+                        VtsDriverControlResponseMessage* response) {
+  if (!util->VtsSocketSendMessage(command) ||
+      !util->VtsSocketRecvMessage(response)) {
+    LOG(ERROR) << "Lost the connection to the driver.";
+    return false;
+  }
+  return response->response_code() == VTS_DRIVER_RESPONSE_SUCCESS;
+}
+
+// Returns the CALL_FUNCTION command of api, with the arguments already set,
+// for the Bar driver of driver_id.
+static VtsDriverControlCommandMessage MakeCallCommand(
+    int driver_id, const FunctionSpecificationMessage& api) {
+  FunctionCallMessage call_msg;
+  call_msg.set_hal_driver_id(driver_id);
+  call_msg.set_component_class(HAL_HIDL);
+  call_msg.set_package_name(kBarPackage);
+  call_msg.set_component_type_version_major(kBarVersionMajor);
+  call_msg.set_component_type_version_minor(kBarVersionMinor);
+  call_msg.set_component_name(kBarComponentName);
+  *call_msg.mutable_api() = api;
+
+  VtsDriverControlCommandMessage command;
+  command.set_command_type(CALL_FUNCTION);
+  google::protobuf::TextFormat::PrintToString(call_msg,
+                                              command.mutable_arg());
+  command.set_binary_return_message(true);
+  return command;
+}
+
+// Calls api of the Bar driver of driver_id once per iteration, and reports
+// the calls per second, the latency percentiles of the round trips and the
+// callbacks received per call. The results are parsed, as the host does.
+static void BM_Call(benchmark::State& state, VtsDriverCommUtil* util,
+                    int driver_id, const FunctionSpecificationMessage* api,
+                    const CallbackListener* callback_listener) {
+  VtsDriverControlCommandMessage command = MakeCallCommand(driver_id, *api);
+  VtsLatencyHistogram latencies;
+  uint64_t callback_count = callback_listener->GetMessageCount();
+  for (auto _ : state) {
+    int64_t start_ns = VtsHalDriverStats::NowNs();
+    VtsDriverControlResponseMessage response;
+    FunctionSpecificationMessage result;
+    if (!SendCommand(util, command, &response) ||
+        !result.ParseFromString(response.return_message())) {
+      state.SkipWithError(("can't call " + api->name()).c_str());
+      return;
+    }
+    latencies.Record(VtsHalDriverStats::NowNs() - start_ns);
+  }
+  callback_count = callback_listener->GetMessageCount() - callback_count;
+  state.counters["calls_per_s"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["p50_us"] = latencies.GetPercentileNs(50) / 1e3;
+  state.counters["p90_us"] = latencies.GetPercentileNs(90) / 1e3;
+  state.counters["p99_us"] = latencies.GetPercentileNs(99) / 1e3;
+  state.counters["callbacks_per_call"] =
+      benchmark::Counter(callback_count, benchmark::Counter::kAvgIterations);
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(command.ByteSizeLong()));
+}
+
+// The calls of the benchmarks. They live until the benchmarks are run.
+static FunctionSpecificationMessage empty_call_;
+static FunctionSpecificationMessage scalar_call_;
+static FunctionSpecificationMessage vector_calls_[3];
+static const int kVectorCallBytes[] = {1 << 10, 1 << 16, 1 << 20};
+static FunctionSpecificationMessage callback_call_;
+
+static void InitCalls() {
+  empty_call_.set_name("thisIsNew");
+
+  scalar_call_.set_name("doThatAndReturnSomething");
+  VariableSpecificationMessage* arg = scalar_call_.add_arg();
+  arg->set_type(TYPE_SCALAR);
+  arg->set_scalar_type("int64_t");
+  arg->mutable_scalar_value()->set_int64_t(42);
+
+  for (int i = 0; i < 3; i++) {
+    vector_calls_[i].set_name("sendVec");
+    arg = vector_calls_[i].add_arg();
+    arg->set_type(TYPE_VECTOR);
+    arg->set_vector_size(kVectorCallBytes[i]);
+    arg->set_vector_raw_value(string(kVectorCallBytes[i], '\x5a'));
+  }
+
+  // the callback methods that the Bar HAL calls back from callMe.
+  callback_call_.set_name("callMe");
+  arg = callback_call_.add_arg();
+  arg->set_type(TYPE_FUNCTION_POINTER);
+  arg->set_is_callback(true);
+  int callback_id = 0;
+  for (const char* name :
+       {"heyItsYou", "heyItsYouIsntIt", "heyItsTheMeaningOfLife"}) {
+    FunctionPointerSpecificationMessage* function_pointer =
+        arg->add_function_pointer();
+    function_pointer->set_function_name(name);
+    function_pointer->set_id(to_string(++callback_id));
+  }
+}
+
+static void RegisterBenchmarks(VtsDriverCommUtil* util, int driver_id,
+                               const CallbackListener* callback_listener) {
+  InitCalls();
+  benchmark::RegisterBenchmark("BM_Call/empty", BM_Call, util, driver_id,
+                               &empty_call_, callback_listener)
+      ->UseRealTime();
+  benchmark::RegisterBenchmark("BM_Call/scalar", BM_Call, util, driver_id,
+                               &scalar_call_, callback_listener)
+      ->UseRealTime();
+  for (int i = 0; i < 3; i++) {
+    benchmark::RegisterBenchmark(
+        ("BM_Call/vector/" + to_string(kVectorCallBytes[i])).c_str(),
+        BM_Call, util, driver_id, &vector_calls_[i], callback_listener)
+        ->UseRealTime();
+  }
+  benchmark::RegisterBenchmark("BM_Call/callback", BM_Call, util, driver_id,
+                               &callback_call_, callback_listener)
+      ->UseRealTime();
+}
+
+// Loads the Bar driver.
+// Returns its driver id, or -1 on error.
+static int LoadBarDriver(VtsDriverCommUtil* util) {
+  VtsDriverControlCommandMessage command;
+  command.set_command_type(LOAD_HAL);
+  command.set_target_class(HAL_HIDL);
+  command.set_target_type(0);
+  command.set_target_version_major(kBarVersionMajor);
+  command.set_target_version_minor(kBarVersionMinor);
+  command.set_target_package(kBarPackage);
+  command.set_target_component_name(kBarComponentName);
+  command.set_hw_binder_service_name(kBarServiceName);
+  VtsDriverControlResponseMessage response;
+  if (!SendCommand(util, command, &response)) {
+    LOG(ERROR) << "Can't load the driver of " << kBarPackage << "@"
+               << kBarVersionMajor << "." << kBarVersionMinor
+               << "::" << kBarComponentName;
+    return -1;
+  }
+  return response.return_value();
+}
+
+// Sends a command without arguments, e.g. GET_STATS, and sets
+// return_message, if not null, to the message of the response.
+// Returns true iff successful.
+static bool SendSimpleCommand(VtsDriverCommUtil* util,
+                              VtsDriverCommandType command_type,
+                              string* return_message) {
+  VtsDriverControlCommandMessage command;
+  command.set_command_type(command_type);
+  VtsDriverControlResponseMessage response;
+  if (!SendCommand(util, command, &response)) return false;
+  if (return_message) *return_message = response.return_message();
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
+
+int main(int argc, char** argv) {
+  using namespace android::vts;
+  benchmark::Initialize(&argc, argv);
+  string spec_dir = argc > 1 ? argv[1] : "/data/local/tmp/spec/";
+  string socket_dir = argc > 2 ? argv[2] : "/data/local/tmp/";
+  if (socket_dir.back() != '/') socket_dir += "/";
+  string socket_prefix =
+      socket_dir + "vts_hal_driver_benchmark_" + to_string(getpid());
+  string driver_socket_name = socket_prefix + "_driver";
+  string callback_socket_name = socket_prefix + "_callback";
+
+  CallbackListener callback_listener;
+  DriverServer server(spec_dir, callback_socket_name);
+  if (!callback_listener.Start(callback_socket_name) ||
+      !server.Start(driver_socket_name)) {
+    return 1;
+  }
+  VtsDriverCommUtil util;
+  int result = 1;
+  if (util.Connect(driver_socket_name)) {
+    int driver_id = LoadBarDriver(&util);
+    if (driver_id >= 0 && SendSimpleCommand(&util, RESET_STATS, nullptr)) {
+      RegisterBenchmarks(&util, driver_id, &callback_listener);
+      benchmark::RunSpecifiedBenchmarks();
+      string stats;
+      if (SendSimpleCommand(&util, GET_STATS, &stats)) {
+        cout << "Driver time per stage:" << endl << stats;
+        result = 0;
+      }
+    }
+    // the driver exits without a response.
+    VtsDriverControlCommandMessage exit_command;
+    exit_command.set_command_type(EXIT);
+    util.VtsSocketSendMessage(exit_command);
+    util.Close();
+  }
+  server.Stop();
+  callback_listener.Stop();
+  unlink(driver_socket_name.c_str());
+  unlink(callback_socket_name.c_str());
+  return result;
+}
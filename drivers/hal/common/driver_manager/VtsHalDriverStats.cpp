@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "driver_manager/VtsHalDriverStats.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <algorithm>
+
+namespace android {
+namespace vts {
+
+static const char* const kDriverStageNames[kDriverStageCount] = {
+    "receive", "preprocess", "call", "coverage", "results", "format", "send"};
+
+int64_t VtsHalDriverStats::NowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void VtsHalDriverStats::Histogram::Add(int64_t elapsed_ns) {
+  count++;
+  total_ns += elapsed_ns;
+  max_ns = max(max_ns, elapsed_ns);
+  // bucket i holds the times in [2^(i-1), 2^i) ns.
+  int bucket = elapsed_ns > 0 ? 64 - __builtin_clzll(elapsed_ns) : 0;
+  buckets[min(bucket, 63)]++;
+}
+
+int64_t VtsHalDriverStats::Histogram::Percentile(int percentile) const {
+  uint64_t rank = (count * percentile + 99) / 100;
+  uint64_t seen = 0;
+  for (int bucket = 0; bucket < 64; bucket++) {
+    seen += buckets[bucket];
+    if (seen >= rank) {
+      return min<int64_t>(max_ns, bucket == 0 ? 0 : (1LL << bucket) - 1);
+    }
+  }
+  return max_ns;
+}
+
+void VtsHalDriverStats::Record(const string& api,
+                               const int64_t (&stage_ns)[kDriverStageCount]) {
+  lock_guard<mutex> lock(lock_);
+  auto& histograms = stats_[api];
+  for (int stage = 0; stage < kDriverStageCount; stage++) {
+    if (stage_ns[stage] >= 0) {
+      histograms[stage].Add(stage_ns[stage]);
+    }
+  }
+}
+
+void VtsHalDriverStats::Record(const string& api, DriverStage stage,
+                               int64_t elapsed_ns) {
+  lock_guard<mutex> lock(lock_);
+  stats_[api][stage].Add(elapsed_ns);
+}
+
+string VtsHalDriverStats::Dump() {
+  lock_guard<mutex> lock(lock_);
+  string output = "api stage count mean_ns p50_ns p90_ns p99_ns max_ns\n";
+  char line[128];
+  for (const auto& api_stats : stats_) {
+    for (int stage = 0; stage < kDriverStageCount; stage++) {
+      const Histogram& histogram = api_stats.second[stage];
+      if (histogram.count == 0) {
+        continue;
+      }
+      snprintf(line, sizeof(line),
+               " %s %" PRIu64 " %" PRId64 " %" PRId64 " %" PRId64 " %" PRId64
+               " %" PRId64 "\n",
+               kDriverStageNames[stage], histogram.count,
+               histogram.total_ns / static_cast<int64_t>(histogram.count),
+               histogram.Percentile(50), histogram.Percentile(90),
+               histogram.Percentile(99), histogram.max_ns);
+      output += api_stats.first;
+      output += line;
+    }
+  }
+  return output;
+}
+
+void VtsHalDriverStats::Reset() {
+  lock_guard<mutex> lock(lock_);
+  stats_.clear();
+}
+
+}  // namespace vts
+}  // namespace android
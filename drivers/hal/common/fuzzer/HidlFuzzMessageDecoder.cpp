@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fuzzer/HidlFuzzMessageDecoder.h"
+
+#include <android-base/logging.h>
+
+#include "utils/InterfaceSpecUtil.h"
+#include "utils/TypeConversionUtil.h"
+
+namespace android {
+namespace vts {
+
+// Decodes a scalar of type T into value.
+template <typename T>
+static bool DecodeScalar(FuzzDataCursor& cursor,
+                         ScalarDataValueMessage* value) {
+  T scalar_value;
+  if (!DecodeFuzzValue(cursor, &scalar_value)) return false;
+  VtsScalarTraits<T>::Set(value, scalar_value);
+  return true;
+}
+
+// The decoders of the scalar types, by scalar_type name.
+typedef bool (*ScalarDecoder)(FuzzDataCursor&, ScalarDataValueMessage*);
+
+static const map<string, ScalarDecoder>& GetScalarDecoders() {
+  static const map<string, ScalarDecoder> decoders = {
+      {VtsScalarTraits<bool>::Name(), DecodeScalar<bool>},
+      {VtsScalarTraits<int8_t>::Name(), DecodeScalar<int8_t>},
+      {VtsScalarTraits<uint8_t>::Name(), DecodeScalar<uint8_t>},
+      {VtsScalarTraits<int16_t>::Name(), DecodeScalar<int16_t>},
+      {VtsScalarTraits<uint16_t>::Name(), DecodeScalar<uint16_t>},
+      {VtsScalarTraits<int32_t>::Name(), DecodeScalar<int32_t>},
+      {VtsScalarTraits<uint32_t>::Name(), DecodeScalar<uint32_t>},
+      {VtsScalarTraits<int64_t>::Name(), DecodeScalar<int64_t>},
+      {VtsScalarTraits<uint64_t>::Name(), DecodeScalar<uint64_t>},
+      {VtsScalarTraits<float>::Name(), DecodeScalar<float>},
+      {VtsScalarTraits<double>::Name(), DecodeScalar<double>},
+  };
+  return decoders;
+}
+
+HidlFuzzMessageDecoder::HidlFuzzMessageDecoder(
+    const ComponentSpecificationMessage& component, HalDriverLoader* loader)
+    : loader_(loader) {
+  for (const auto& attribute : component.attribute()) {
+    AddType(attribute);
+  }
+  for (const auto& attribute : component.interface().attribute()) {
+    AddType(attribute);
+  }
+  for (const auto& api : component.interface().api()) {
+    bool supported = true;
+    for (const auto& arg : api.arg()) {
+      supported = supported && IsSupported(arg);
+    }
+    if (!supported) {
+      LOG(INFO) << "Not fuzzing " << api.name()
+                << ", whose arguments can't be decoded.";
+      continue;
+    }
+    function_specs_.push_back(api);
+    function_calls_.push_back(api);
+  }
+}
+
+int HidlFuzzMessageDecoder::FindFunction(const string& name) const {
+  for (size_t i = 0; i < function_specs_.size(); i++) {
+    if (function_specs_[i].name() == name) return i;
+  }
+  return -1;
+}
+
+const FunctionSpecificationMessage* HidlFuzzMessageDecoder::DecodeCall(
+    size_t index, FuzzDataCursor& cursor) {
+  const FunctionSpecificationMessage& spec = function_specs_[index];
+  FunctionSpecificationMessage* call = &function_calls_[index];
+  for (int i = 0; i < spec.arg_size(); i++) {
+    if (!DecodeVariable(spec.arg(i), cursor, call->mutable_arg(i))) {
+      return nullptr;
+    }
+  }
+  return call;
+}
+
+bool HidlFuzzMessageDecoder::IsSupported(
+    const VariableSpecificationMessage& spec) {
+  switch (spec.type()) {
+    case TYPE_SCALAR:
+    case TYPE_MASK:
+      return GetScalarDecoders().count(spec.scalar_type()) > 0;
+    case TYPE_STRING:
+      return true;
+    case TYPE_ENUM: {
+      const VariableSpecificationMessage* type =
+          FindType(spec.predefined_type());
+      if (!type || type->type() != TYPE_ENUM) return false;
+      const EnumDataValueMessage& enum_value = type->enum_value();
+      return enum_value.scalar_value_size() > 0 ||
+             GetScalarDecoders().count(enum_value.scalar_type()) > 0;
+    }
+    case TYPE_VECTOR:
+    case TYPE_ARRAY:
+      return spec.vector_value_size() > 0 &&
+             IsSupported(spec.vector_value(0));
+    case TYPE_STRUCT: {
+      const VariableSpecificationMessage* type =
+          spec.struct_value_size() > 0 ? &spec
+                                       : FindType(spec.predefined_type());
+      if (!type || type->type() != TYPE_STRUCT) return false;
+      for (const auto& field : type->struct_value()) {
+        if (!IsSupported(field)) return false;
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+bool HidlFuzzMessageDecoder::DecodeVariable(
+    const VariableSpecificationMessage& spec, FuzzDataCursor& cursor,
+    VariableSpecificationMessage* var) {
+  switch (spec.type()) {
+    case TYPE_SCALAR:
+    case TYPE_MASK:
+      return GetScalarDecoders().at(spec.scalar_type())(
+          cursor, var->mutable_scalar_value());
+    case TYPE_STRING: {
+      size_t length;
+      if (!cursor.ConsumeLength(&length)) return false;
+      const uint8_t* data = cursor.Consume(length);
+      var->mutable_string_value()->set_message(data, length);
+      var->mutable_string_value()->set_length(length);
+      return true;
+    }
+    case TYPE_ENUM: {
+      // an enumerator is more likely to pass the checks of the HAL than any
+      // value of the scalar type.
+      const EnumDataValueMessage& enum_value =
+          FindType(spec.predefined_type())->enum_value();
+      if (enum_value.scalar_value_size() == 0) {
+        return GetScalarDecoders().at(enum_value.scalar_type())(
+            cursor, var->mutable_scalar_value());
+      }
+      uint8_t index;
+      if (!cursor.ConsumeBytes(&index, sizeof(index))) return false;
+      *var->mutable_scalar_value() =
+          enum_value.scalar_value(index % enum_value.scalar_value_size());
+      return true;
+    }
+    case TYPE_VECTOR:
+    case TYPE_ARRAY: {
+      size_t length;
+      if (spec.type() == TYPE_ARRAY) {
+        length = spec.vector_size();
+      } else if (!cursor.ConsumeLength(&length)) {
+        return false;
+      }
+      // the messages of the elements are reused, as far as there are.
+      auto* elements = var->mutable_vector_value();
+      while (static_cast<size_t>(elements->size()) > length) {
+        elements->RemoveLast();
+      }
+      while (static_cast<size_t>(elements->size()) < length) {
+        *elements->Add() = spec.vector_value(0);
+      }
+      var->clear_vector_raw_value();
+      var->set_vector_size(length);
+      for (size_t i = 0; i < length; i++) {
+        if (!DecodeVariable(spec.vector_value(0), cursor,
+                            elements->Mutable(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case TYPE_STRUCT: {
+      const VariableSpecificationMessage* type =
+          spec.struct_value_size() > 0 ? &spec
+                                       : FindType(spec.predefined_type());
+      for (int i = 0; i < type->struct_value_size(); i++) {
+        if (var->struct_value_size() <= i) {
+          *var->add_struct_value() = type->struct_value(i);
+        }
+        if (!DecodeVariable(type->struct_value(i), cursor,
+                            var->mutable_struct_value(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      LOG(ERROR) << "Can't decode type " << spec.type();
+      return false;
+  }
+}
+
+const VariableSpecificationMessage* HidlFuzzMessageDecoder::FindType(
+    const string& type_name) {
+  auto res = types_.find(type_name);
+  if (res != types_.end()) return &res->second;
+  if (type_name.find("::V") == string::npos) return nullptr;
+
+  string package_name = GetPackageName(type_name);
+  string version = GetVersion(type_name);
+  if (!loaded_packages_.insert(package_name + "@" + version).second) {
+    return nullptr;
+  }
+  ComponentSpecificationMessage types_spec;
+  if (!loader_->FindComponentSpecification(
+          HAL_HIDL, package_name, GetVersionMajor(version, true),
+          GetVersionMinor(version, true), "types", 0, &types_spec)) {
+    LOG(WARNING) << "Can't find the types of " << package_name << "@"
+                 << version;
+    return nullptr;
+  }
+  for (const auto& attribute : types_spec.attribute()) {
+    AddType(attribute);
+  }
+  res = types_.find(type_name);
+  return res != types_.end() ? &res->second : nullptr;
+}
+
+void HidlFuzzMessageDecoder::AddType(
+    const VariableSpecificationMessage& attribute) {
+  for (const auto& sub_struct : attribute.sub_struct()) {
+    AddType(sub_struct);
+  }
+  types_[attribute.name()] = attribute;
+}
+
+}  // namespace vts
+}  // namespace android
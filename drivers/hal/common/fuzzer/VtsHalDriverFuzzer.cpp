@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+
+#include <android-base/logging.h>
+
+#include "component_loader/HalDriverLoader.h"
+#include "driver_base/DriverBase.h"
+#include "fuzzer/HidlFuzzMessageDecoder.h"
+#include "utils/FuzzDecodeUtil.h"
+#include "utils/FuzzRemoteCoverage.h"
+#include "utils/InterfaceSpecUtil.h"
+
+using namespace std;
+
+// A libFuzzer entry point that fuzzes a HIDL HAL in process through its
+// generated -vts.driver.so, without the agent and the driver process. The
+// driver is loaded once, and each input is decoded into calls of the
+// driver's CallFunction.
+//
+// Usage: vts_hal_driver_fuzzer --vts_target_package=<package>
+//            --vts_target_version=<version> --vts_target_component=<name>
+//            [--vts_target_func=<function>] [--vts_service_name=<name>]
+//            [--vts_spec_dir=<dir>] [--vts_remote_coverage=<path>]
+//            [<libFuzzer flags>]
+// e.g. --vts_target_package=android.hardware.nfc --vts_target_version=1.0
+//      --vts_target_component=INfc.
+// Without --vts_target_func, each call in an input is a byte selecting the
+// function, followed by its arguments, so that sequences of calls across
+// the interface are fuzzed. With --vts_remote_coverage, the fuzzing is
+// guided by the coverage of the HAL server, see utils/FuzzRemoteCoverage.h.
+
+namespace android {
+namespace vts {
+
+static constexpr const char* kDefaultSpecDir = "/data/local/tmp/spec";
+
+// The parameters of the fuzzer, from the --vts_ flags.
+struct DriverFuzzerParams {
+  string spec_dir = kDefaultSpecDir;
+  string package;
+  string version;
+  string component;
+  string service_name;
+  string target_func;
+};
+
+// The state set up by LLVMFuzzerInitialize.
+struct DriverFuzzer {
+  unique_ptr<HalDriverLoader> loader;
+  unique_ptr<DriverBase> driver;
+  unique_ptr<HidlFuzzMessageDecoder> decoder;
+  // the index of the function to fuzz, -1 to fuzz all the functions.
+  int target_index = -1;
+  FuzzRemoteCoverage remote_coverage;
+};
+
+static DriverFuzzer* fuzzer = nullptr;
+
+// Returns the value of flag in arg, e.g. "1.0" for
+// ParseFlag("--vts_target_version=1.0", "vts_target_version", &value).
+static bool ParseFlag(const char* arg, const string& flag, string* value) {
+  string prefix = "--" + flag + "=";
+  if (strncmp(arg, prefix.c_str(), prefix.size()) != 0) return false;
+  *value = arg + prefix.size();
+  return true;
+}
+
+static DriverFuzzerParams ParseParams(int argc, char** argv) {
+  DriverFuzzerParams params;
+  for (int i = 1; i < argc; i++) {
+    // the other flags are left to libFuzzer, which ignores those starting
+    // with "--".
+    ParseFlag(argv[i], "vts_spec_dir", &params.spec_dir) ||
+        ParseFlag(argv[i], "vts_target_package", &params.package) ||
+        ParseFlag(argv[i], "vts_target_version", &params.version) ||
+        ParseFlag(argv[i], "vts_target_component", &params.component) ||
+        ParseFlag(argv[i], "vts_service_name", &params.service_name) ||
+        ParseFlag(argv[i], "vts_target_func", &params.target_func);
+  }
+  return params;
+}
+
+static void Initialize(const DriverFuzzerParams& params, int* argc,
+                       char*** argv) {
+  if (params.package.empty() || params.version.empty() ||
+      params.component.empty()) {
+    LOG(FATAL) << "--vts_target_package, --vts_target_version and "
+               << "--vts_target_component are required.";
+  }
+  int version_major = GetVersionMajor(params.version);
+  int version_minor = GetVersionMinor(params.version);
+
+  fuzzer = new DriverFuzzer();
+  fuzzer->remote_coverage.ExtractAndMap(argc, argv);
+  fuzzer->loader.reset(new HalDriverLoader(params.spec_dir, 0, ""));
+  ComponentSpecificationMessage spec;
+  if (!fuzzer->loader->FindComponentSpecification(
+          HAL_HIDL, params.package, version_major, version_minor,
+          params.component, 0, &spec)) {
+    LOG(FATAL) << "Can't find the specification of "
+               << GetInterfaceFQName(params.package, version_major,
+                                     version_minor, params.component)
+               << " in " << params.spec_dir;
+  }
+  fuzzer->driver.reset(fuzzer->loader->GetDriver(
+      GetHidlHalDriverLibName(params.package, version_major, version_minor),
+      spec, params.service_name, 0, false, ""));
+  if (!fuzzer->driver) {
+    LOG(FATAL) << "Can't load the driver of " << params.component;
+  }
+
+  fuzzer->decoder.reset(new HidlFuzzMessageDecoder(spec, fuzzer->loader.get()));
+  if (fuzzer->decoder->GetFunctionCount() == 0) {
+    LOG(FATAL) << "No function of " << params.component << " can be fuzzed.";
+  }
+  if (!params.target_func.empty()) {
+    fuzzer->target_index = fuzzer->decoder->FindFunction(params.target_func);
+    if (fuzzer->target_index < 0) {
+      LOG(FATAL) << "Can't fuzz function " << params.target_func;
+    }
+  }
+}
+
+// Decodes a call of the function at index from cursor, and calls it.
+//
+// @return false if the input is too short.
+static bool FuzzCall(size_t index, FuzzDataCursor& cursor,
+                     FunctionSpecificationMessage* result_msg) {
+  const FunctionSpecificationMessage* call =
+      fuzzer->decoder->DecodeCall(index, cursor);
+  if (call == nullptr) return false;
+  result_msg->Clear();
+  fuzzer->driver->CallFunction(*call, "", result_msg);
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
+
+using namespace android::vts;
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv) {
+  Initialize(ParseParams(*argc, *argv), argc, argv);
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  // reused between calls.
+  static FunctionSpecificationMessage result_msg;
+  fuzzer->remote_coverage.BeginInput();
+  FuzzDataCursor cursor(data, size);
+  if (fuzzer->target_index >= 0) {
+    FuzzCall(fuzzer->target_index, cursor, &result_msg);
+  } else {
+    size_t function_count = fuzzer->decoder->GetFunctionCount();
+    uint8_t index;
+    while (cursor.ConsumeBytes(&index, sizeof(index))) {
+      if (!FuzzCall(index % function_count, cursor, &result_msg)) break;
+    }
+  }
+  fuzzer->remote_coverage.EndInput();
+  return 0;
+}
@@ -18,16 +18,16 @@
 #define __VTS_FUZZER_BINDER_SERVICE_H__
 
 #include <string>
+#include <vector>
 
 #include <utils/RefBase.h>
 #include <utils/String8.h>
 
 #include <binder/IBinder.h>
 #include <binder/IInterface.h>
+#include <binder/Parcel.h>
 #include <binder/ProcessState.h>
 
-// #ifdef VTS_FUZZER_BINDER_DEBUG
-
 #define VTS_FUZZER_BINDER_SERVICE_NAME "VtsFuzzer"
 
 using namespace std;
@@ -35,6 +35,43 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// The callback of the async calls of IVtsFuzzer, implemented by the client.
+class IVtsFuzzerCallback : public IInterface {
+ public:
+  enum { CALLS_COMPLETE = IBinder::FIRST_CALL_TRANSACTION };
+
+  // Receives the results of the calls of an async call request, in the order
+  // of the calls, with the cookie of the request.
+  virtual void OnCallsComplete(int64_t cookie,
+                               const vector<string>& results) = 0;
+
+  DECLARE_META_INTERFACE(VtsFuzzerCallback);
+};
+
+// For the driver, which sends the results.
+class BpVtsFuzzerCallback : public BpInterface<IVtsFuzzerCallback> {
+ public:
+  explicit BpVtsFuzzerCallback(const sp<IBinder>& impl)
+      : BpInterface<IVtsFuzzerCallback>(impl) {}
+
+  void OnCallsComplete(int64_t cookie, const vector<string>& results);
+};
+
+// For the client, which implements OnCallsComplete.
+class BnVtsFuzzerCallback : public BnInterface<IVtsFuzzerCallback> {
+ public:
+  status_t onTransact(uint32_t code, const Parcel& data, Parcel* reply,
+                      uint32_t flags = 0) override;
+};
+
+// Writes a list of calls or results to parcel, as the number of entries
+// followed by each entry as its size and bytes.
+void WriteVtsFuzzerCallList(const vector<string>& entries, Parcel* parcel);
+
+// Reads a list written by WriteVtsFuzzerCallList. Returns false if the list
+// is truncated.
+bool ReadVtsFuzzerCallList(const Parcel& parcel, vector<string>* entries);
+
 // VTS Fuzzer Binder Interface
 class IVtsFuzzer : public IInterface {
  public:
@@ -43,7 +80,9 @@ class IVtsFuzzer : public IInterface {
     LOAD_HAL,
     STATUS,
     CALL,
-    GET_FUNCTIONS
+    GET_FUNCTIONS,
+    CALL_MANY,
+    CALL_ASYNC
   };
 
   // Sends an exit command.
@@ -67,6 +106,18 @@ class IVtsFuzzer : public IInterface {
 
   virtual const char* GetFunctions() = 0;
 
+  // Requests to make the calls, in order, in one transaction. Each call is a
+  // binary-serialized FunctionSpecificationMessage, unlike the text format of
+  // Call. Returns the result of each call, or none if the transaction failed.
+  virtual vector<string> CallMany(const vector<string>& call_payloads) = 0;
+
+  // Requests the calls of CallMany without waiting for them. Their results
+  // are sent to callback with cookie. Returns the status of the oneway
+  // transaction.
+  virtual status_t CallAsync(const vector<string>& call_payloads,
+                             const sp<IVtsFuzzerCallback>& callback,
+                             int64_t cookie) = 0;
+
   DECLARE_META_INTERFACE(VtsFuzzer);
 };
 
@@ -89,6 +140,9 @@ class BpVtsFuzzer : public BpInterface<IVtsFuzzer> {
   int32_t Status(int32_t type);
   string Call(const string& call_payload);
   const char* GetFunctions();
+  vector<string> CallMany(const vector<string>& call_payloads);
+  status_t CallAsync(const vector<string>& call_payloads,
+                     const sp<IVtsFuzzerCallback>& callback, int64_t cookie);
 };
 
 }  // namespace vts
@@ -17,6 +17,9 @@
 #ifndef __VTS_SYSFUZZER_COMMON_COMPONENTLOADER_DLLLOADER_H__
 #define __VTS_SYSFUZZER_COMMON_COMPONENTLOADER_DLLLOADER_H__
 
+#include <map>
+#include <string>
+
 #include "hardware/hardware.h"
 
 namespace android {
@@ -36,7 +39,8 @@ class DllLoader {
   DllLoader();
   virtual ~DllLoader();
 
-  // Loads a DLL file.
+  // Loads a DLL file. A file already loaded by this loader is not opened
+  // again; its handle becomes the current one.
   // Returns a handle (void *) if successful; NULL otherwise.
   void* Load(const char* file_path);
 
@@ -55,9 +59,21 @@ class DllLoader {
   // (for gcov) flush to file(s).
   bool GcovFlush();
 
+  // (for gcov) reset the counters in memory.
+  bool GcovReset();
+
+  // (for llvm profile) write the raw profile of the counters to buffer,
+  // without writing a file.
+  bool ProfileWriteBuffer(std::string* buffer);
+
+  // (for llvm profile) reset the counters.
+  bool ProfileResetCounters();
+
  private:
   // pointer to a handle of the loaded DLL file.
   void* handle_;
+  // handles of all the DLL files loaded, by path.
+  std::map<std::string, void*> handles_;
 
   // Loads a symbol and prints error message.
   // Returns the symbol value if successful; NULL otherwise.
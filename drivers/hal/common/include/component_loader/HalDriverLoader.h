@@ -17,8 +17,13 @@
 #ifndef __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUILDER_H__
 #define __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUILDER_H__
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "component_loader/DllLoader.h"
 #include "driver_base/DriverBase.h"
@@ -36,8 +41,9 @@ class HalDriverLoader {
   HalDriverLoader(const string dir_path, int epoch_count,
                   const string& callback_socket_name);
 
-  // Scans the dir and returns an component specification for a requested
-  // component.
+  // Returns an component specification for a requested component. The
+  // specification files of a package version are parsed once, on the first
+  // request for that package version.
   // Args:
   //   version_major: int, hal major version, e.g. 1.0 -> 1
   //   version_minor: int, hal minor version, e.g. 1.0 -> 0
@@ -49,6 +55,10 @@ class HalDriverLoader {
                                   const int component_type,
                                   ComponentSpecificationMessage* spec_msg);
 
+  // Sets the dir of the binary spec cache shared by the driver processes,
+  // see ParseInterfaceSpecCached. Empty, the default, disables the cache.
+  void SetSpecCacheDir(const string& cache_dir) { spec_cache_dir_ = cache_dir; }
+
   // Create driver for given component.
   DriverBase* GetDriver(const string& driver_lib_path,
                         const ComponentSpecificationMessage& spec_msg,
@@ -97,10 +107,25 @@ class HalDriverLoader {
       const ComponentSpecificationMessage& spec_msg,
       const uint64_t interface_pt);
 
+  // Returns the factory function of the driver for spec_msg in the driver
+  // library, the one taking the hidl proxy pointer if with_arg is true.
+  // Loads the library and resolves the function on the first request only.
+  // Returns nullptr if not found.
+  void* GetDriverFactory(const string& driver_lib_path,
+                         const ComponentSpecificationMessage& spec_msg,
+                         bool with_arg);
+
   // Helper method to load a driver library with the given path.
   DriverBase* LoadDriver(const string& driver_lib_path,
                          const ComponentSpecificationMessage& spec_msg);
 
+  // Returns the parsed specifications of the .vts files in driver_lib_dir,
+  // scanning the dir if it isn't in spec_catalog_ yet. Returns nullptr if
+  // the dir can't be opened. spec_catalog_lock_ must be held.
+  const vector<shared_ptr<const ComponentSpecificationMessage>>*
+  GetCatalogSpecs(
+      const string& driver_lib_dir);
+
   // A DLL Loader instance used to load the driver library.
   DllLoader dll_loader_;
   // the path of a dir which contains interface specification ASCII proto files.
@@ -109,6 +134,21 @@ class HalDriverLoader {
   const int epoch_count_;
   // the server socket port # of the agent.
   const string callback_socket_name_;
+  // the factory functions resolved by GetDriverFactory, by library path,
+  // component class, type, version, package, name and with_arg.
+  map<tuple<string, int, int, int, int, string, string, bool>, void*>
+      driver_factories_;
+  // protects dll_loader_ and driver_factories_.
+  mutex driver_factories_lock_;
+  // the dir of the binary spec cache.
+  string spec_cache_dir_;
+  // the parsed specifications in each scanned package version dir, in the
+  // order of the dir entries, shared with the other loaders of the process
+  // by GetInterfaceSpec.
+  map<string, vector<shared_ptr<const ComponentSpecificationMessage>>>
+      spec_catalog_;
+  // protects spec_catalog_.
+  mutex spec_catalog_lock_;
   // fuzzing job queue. Used by Process method.
   queue<pair<FunctionSpecificationMessage*, DriverBase*>> job_queue_;
 };
@@ -17,6 +17,10 @@
 #ifndef __VTS_SYSFUZZER_COMMON_FUZZER_BASE_H__
 #define __VTS_SYSFUZZER_COMMON_FUZZER_BASE_H__
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "component_loader/DllLoader.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
@@ -57,6 +61,24 @@ class DriverBase {
     return false;
   };
 
+  // Calls the function of func_msg count times, as Fuzz does, and appends
+  // the result of each call to results. The generated shared library drivers
+  // look the function up once and call it in a loop, so that calls which
+  // take nanoseconds are not measured by the cost of a Fuzz call each.
+  // Returns the number of calls made, which is less than count on error.
+  virtual int FuzzRepeated(vts::FunctionSpecificationMessage* func_msg,
+                           int count, const string& callback_socket_name,
+                           vector<void*>* results) {
+    for (int i = 0; i < count; i++) {
+      void* result;
+      if (!Fuzz(func_msg, &result, callback_socket_name)) {
+        return i;
+      }
+      results->push_back(result);
+    }
+    return count;
+  }
+
   virtual bool CallFunction(
       const vts::FunctionSpecificationMessage& /*func_msg*/,
       const string& /*callback_socket_name*/,
@@ -70,25 +92,114 @@ class DriverBase {
     return false;
   };
 
+  // Calls a function as CallFunction does, and verifies its results against
+  // expected_result as VerifyResults does. The generated HIDL HAL drivers
+  // compare the C++ values returned by the HAL, without building the result
+  // message.
+  // Returns true iff the call succeeds. verified is set to whether the
+  // results match.
+  virtual bool CallFunctionAndVerify(
+      const vts::FunctionSpecificationMessage& func_msg,
+      const string& callback_socket_name,
+      const vts::FunctionSpecificationMessage& expected_result,
+      bool* verified) {
+    vts::FunctionSpecificationMessage result_msg;
+    if (!CallFunction(func_msg, callback_socket_name, &result_msg)) {
+      return false;
+    }
+    *verified = VerifyResults(expected_result, result_msg);
+    return true;
+  }
+
   virtual bool GetAttribute(vts::FunctionSpecificationMessage* /*func_msg*/,
                             void** /*result*/) {
     return false;
   }
 
-  // Called before calling a target function.
+  // Called before calling a target function. Resets the coverage counters.
+  // The gcov dir of the component is found, and cleaned, by the first call
+  // only.
   void FunctionCallBegin();
 
   // Called after calling a target function. Fills in the code coverage info.
   bool FunctionCallEnd(FunctionSpecificationMessage* msg);
 
-  // Scans all GCDA files under a given dir and adds to the message.
+  // Scans all GCDA files under a given dir and adds to the message, in the
+  // order of their paths. The files are parsed on several threads. The list
+  // of the files is kept until a directory of the tree changes.
   bool ScanAllGcdaFiles(const string& basepath,
                         FunctionSpecificationMessage* msg);
 
+  // Sets whether the content of the GCDA files is added to the messages as
+  // raw coverage data, in addition to the processed coverage data. Set it to
+  // false if only the processed coverage data is needed.
+  void SetIncludeRawCoverageData(bool include_raw_coverage_data) {
+    include_raw_coverage_data_ = include_raw_coverage_data;
+  }
+
+  // Sets whether to only report the coverage that changed since the previous
+  // call. If set, a GCDA file already reported is skipped if unchanged, and
+  // is otherwise reported as a delta of the previous one (see
+  // NativeCodeCoverageRawDataMessage.is_delta) without processed coverage
+  // data, since the processed data of a file never changes between calls.
+  void SetReportCoverageDelta(bool report_coverage_delta) {
+    report_coverage_delta_ = report_coverage_delta;
+    gcda_snapshots_.clear();
+  }
+
+  // Sets whether to collect the coverage from the counters in memory of the
+  // loaded component, through the LLVM profile runtime, instead of from the
+  // GCDA files it writes. Falls back to the GCDA files if the component does
+  // not export the runtime.
+  void SetInMemoryCoverage(bool in_memory_coverage) {
+    in_memory_coverage_ = in_memory_coverage;
+  }
+
+  // Forgets the GCDA files reported so far, so that the next call reports
+  // the full coverage, e.g. for the host to rebuild its coverage report.
+  void ResetCoverageDelta() { gcda_snapshots_.clear(); }
+
  protected:
   bool ReadGcdaFile(const string& basepath, const string& filename,
                     FunctionSpecificationMessage* msg);
 
+  // Finds the gcov output dir of the loaded component, sets
+  // gcov_output_basepath_ and removes the existing files in it.
+  void FindGcovOutputBasepath();
+
+  // Coverage of a GCDA file, parsed by ParseGcdaFile before it is added to
+  // a message by AddGcdaCoverage.
+  struct GcdaCoverage {
+    string path;
+    string filename;
+    // the snapshot of the file if report_coverage_delta_ is set. Only the
+    // thread parsing the file accesses it.
+    string* snapshot = NULL;
+    // whether the file was read.
+    bool parsed = false;
+    // whether the coverage is a delta of the snapshot, made of the counters
+    // at indexes set to values. Nothing is added if it is empty.
+    bool is_delta = false;
+    vector<unsigned> indexes;
+    vector<unsigned> values;
+    vector<unsigned> processed_data;
+    // the content of the file, if include_raw_coverage_data_ is set.
+    string data;
+  };
+
+  // Reads and parses the GCDA file at coverage->path into coverage, and
+  // updates its snapshot. Thread-safe for different files.
+  void ParseGcdaFile(GcdaCoverage* coverage) const;
+
+  // Adds the coverage of a GCDA file, if parsed, to msg.
+  void AddGcdaCoverage(GcdaCoverage* coverage,
+                       FunctionSpecificationMessage* msg) const;
+
+  // Sets gcda_files_ to the paths of the GCDA files under basepath, sorted,
+  // unless they were already listed and no directory changed since.
+  // Returns false if basepath can't be opened.
+  bool ListGcdaFiles(const string& basepath);
+
   // a pointer to a HAL data structure of the loaded component.
   struct hw_device_t* device_;
 
@@ -114,6 +225,32 @@ class DriverBase {
 
   // path to store the gcov output files.
   char* gcov_output_basepath_;
+
+  // whether FindGcovOutputBasepath was called for the loaded component.
+  bool gcov_output_basepath_found_;
+
+  // whether the loaded component can reset its gcov counters.
+  bool gcov_reset_supported_;
+
+  // whether to add the content of the GCDA files to the messages.
+  bool include_raw_coverage_data_;
+
+  // whether to report the coverage that changed since the previous call.
+  bool report_coverage_delta_;
+
+  // the content of each GCDA file when last reported, by path, if
+  // report_coverage_delta_ is set.
+  map<string, string> gcda_snapshots_;
+
+  // whether to collect the coverage from the counters in memory.
+  bool in_memory_coverage_;
+
+  // the GCDA files found under gcda_files_basepath_, as pairs of directory
+  // and file name, and the inotify instance watching the directories of the
+  // tree, which are listed again once it has an event. -1 if not watched.
+  string gcda_files_basepath_;
+  vector<pair<string, string>> gcda_files_;
+  int gcda_files_inotify_fd_;
 };
 
 }  // namespace vts
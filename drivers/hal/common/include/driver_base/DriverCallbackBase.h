@@ -17,6 +17,8 @@
 #ifndef __VTS_SYSFUZZER_COMMON_FUZZER_CALLBACK_BASE_H__
 #define __VTS_SYSFUZZER_COMMON_FUZZER_CALLBACK_BASE_H__
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
 
 #include "component_loader/DllLoader.h"
@@ -28,6 +30,20 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// What to do with a callback when the async callback queue is full.
+enum CallbackQueuePolicy {
+  // Waits in the HAL's thread until the queue has room. Nothing is lost.
+  kCallbackQueueBlock,
+  // Drops the new callback.
+  kCallbackQueueDropNewest,
+  // Drops the oldest queued callback to make room.
+  kCallbackQueueDropOldest,
+  // Replaces the queued, not yet sent callback of the same name, if any, so
+  // only the latest arguments reach the host. Otherwise drops the new one
+  // when the queue is full.
+  kCallbackQueueCoalesce,
+};
+
 class DriverCallbackBase {
  public:
   DriverCallbackBase();
@@ -35,6 +51,45 @@ class DriverCallbackBase {
 
   static bool Register(const VariableSpecificationMessage& message);
 
+  // Sets whether the callbacks are sent over one long-lived connection per
+  // callback socket, instead of a new connection per callback. The agent
+  // must read more than one message per connection. A broken connection is
+  // reconnected, but the callbacks it was still carrying are lost. Off by
+  // default.
+  static void SetPersistentConnection(bool persistent);
+
+  // Sets the maximum number of queued callbacks sent in one write over a
+  // persistent connection. Default is 1, i.e. no batching.
+  static void SetCallbackBatchSize(size_t batch_size);
+
+  // Returns the number of callbacks delivered to the agent.
+  static uint64_t GetCallbackCount();
+
+  // Returns the number of callbacks delivered per second since the first.
+  static double GetCallbackRate();
+
+  // Sets the capacity of the queue from which a sender thread delivers the
+  // callbacks, so that the HAL's callback threads don't wait on the socket.
+  // 0, the default, delivers each callback synchronously in the HAL's
+  // thread.
+  static void SetAsyncQueueCapacity(size_t capacity);
+
+  // Sets the policy applied when the async queue is full and a callback
+  // named callback_name (e.g., <class name>::<method name>) arrives. The
+  // default is kCallbackQueueBlock.
+  static void SetCallbackQueuePolicy(const string& callback_name,
+                                     CallbackQueuePolicy policy);
+
+  // Returns the number of callbacks waiting in the async queue.
+  static size_t GetQueuedCallbackCount();
+
+  // Returns the number of callbacks dropped because the async queue was
+  // full, or because they couldn't be sent to the agent.
+  static uint64_t GetDroppedCallbackCount();
+
+  // Returns the number of queued callbacks replaced by a newer one.
+  static uint64_t GetCoalescedCallbackCount();
+
  protected:
   static const char* GetCallbackID(const string& name);
 
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_DRIVERBASE_HIDLSERVICECACHE_H__
+#define __VTS_SYSFUZZER_COMMON_DRIVERBASE_HIDLSERVICECACHE_H__
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <android/hidl/base/1.0/IBase.h>
+#include <hidl/HidlSupport.h>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// A process-wide cache of the HIDL services got by the generated drivers,
+// so that creating many drivers of the same HAL looks up hwservicemanager
+// once. The entry of a binderized service is removed when the service dies.
+// Thread-safe.
+class HidlServiceCache {
+ public:
+  static HidlServiceCache& GetInstance();
+
+  // Finds a service.
+  //
+  // @param descriptor interface descriptor, e.g. android.hardware.nfc@1.0::INfc.
+  // @param instance   service instance name.
+  // @param get_stub   whether the service is passthrough.
+  //
+  // @return the service, nullptr if not cached.
+  sp<hidl::base::V1_0::IBase> Find(const string& descriptor,
+                                   const string& instance, bool get_stub);
+
+  // Adds a service, unless one is already cached with the same key, and
+  // links to its death if it is remote.
+  //
+  // @param descriptor interface descriptor.
+  // @param instance   service instance name.
+  // @param get_stub   whether the service is passthrough.
+  // @param service    the service.
+  //
+  // @return the cached service, which is service unless another thread
+  //         added one first.
+  sp<hidl::base::V1_0::IBase> Add(const string& descriptor,
+                                  const string& instance, bool get_stub,
+                                  const sp<hidl::base::V1_0::IBase>& service);
+
+  // Removes all the services.
+  void Clear();
+
+ private:
+  // Removes the entry of a dead service.
+  class DeathRecipient : public hardware::hidl_death_recipient {
+   public:
+    explicit DeathRecipient(HidlServiceCache* cache) : cache_(cache) {}
+
+    void serviceDied(uint64_t cookie,
+                     const wp<hidl::base::V1_0::IBase>& who) override;
+
+   private:
+    HidlServiceCache* cache_;
+  };
+
+  // descriptor, instance name and get_stub.
+  typedef tuple<string, string, bool> Key;
+
+  // a cached service.
+  struct Entry {
+    sp<hidl::base::V1_0::IBase> service;
+    // identifies the entry in the death notification, 0 if not linked.
+    uint64_t cookie;
+  };
+
+  HidlServiceCache();
+
+  // Removes the entry with cookie.
+  void Remove(uint64_t cookie);
+
+  // protects entries_, keys_ and next_cookie_.
+  mutex lock_;
+  // the services, by key.
+  map<Key, Entry> entries_;
+  // keys of the linked entries, by cookie.
+  map<uint64_t, Key> keys_;
+  // cookie of the next linked entry.
+  uint64_t next_cookie_;
+  sp<DeathRecipient> death_recipient_;
+};
+
+// Returns a service of interface T from HidlServiceCache, or from
+// T::getService if not cached, e.g.
+//   sp<INfc> nfc = GetCachedHidlService<INfc>("default", false);
+//
+// @param instance service instance name, "default" if nullptr.
+// @param get_stub whether to get the passthrough service.
+//
+// @return the service, nullptr if not found.
+template <typename T>
+sp<T> GetCachedHidlService(const char* instance, bool get_stub) {
+  HidlServiceCache& cache = HidlServiceCache::GetInstance();
+  string instance_name = instance ? instance : "default";
+  // the entries of T's descriptor only hold T's services.
+  sp<hidl::base::V1_0::IBase> service =
+      cache.Find(T::descriptor, instance_name, get_stub);
+  if (service == nullptr) {
+    sp<T> new_service = T::getService(instance_name, get_stub);
+    if (new_service == nullptr) return nullptr;
+    service = cache.Add(T::descriptor, instance_name, get_stub, new_service);
+  }
+  return static_cast<T*>(service.get());
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_DRIVERBASE_HIDLSERVICECACHE_H__
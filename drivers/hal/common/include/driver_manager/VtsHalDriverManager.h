@@ -17,13 +17,24 @@
 #ifndef __VTS_DRIVER_HAL_VTSHALDRIVERMANAGER_H
 #define __VTS_DRIVER_HAL_VTSHALDRIVERMANAGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <resource_manager/VtsResourceManager.h>
 #include "component_loader/HalDriverLoader.h"
 #include "driver_base/DriverBase.h"
+#include "driver_manager/VtsHalDriverStats.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
 
 using namespace std;
 using DriverId = int32_t;
@@ -39,9 +50,12 @@ class VtsHalDriverManager {
                       const string& callback_socket_name,
                       VtsResourceManager* resource_manager);
 
+  // Waits for the calls made with CallFunctionAsync to finish.
+  ~VtsHalDriverManager();
+
   // Loads the driver library for the target HAL, creates the corresponding
   // driver instance, assign it a driver id and registers the created driver
-  // instance in hal_driver_map_.
+  // instance.
   // Returns the generated driver id.
   // Args:
   //   version_major: int, hal major version, e.g. 1.0 -> 1.
@@ -63,16 +77,64 @@ class VtsHalDriverManager {
   // Returns a string which contians the return results (a text format of the
   // returned protobuf).
   // For error cases, returns string "error";
+  // If binary_result is true, the returned protobuf is serialized in the
+  // binary format instead, which is much faster to encode and decode.
   // TODO (zhuoyao): use FunctionCallMessage instead of
   // FunctionSpecificationMessage which contains info such as component name and
   // driver id.
-  string CallFunction(FunctionCallMessage* func_msg);
+  string CallFunction(FunctionCallMessage* func_msg,
+                      bool binary_result = false);
+
+  // Registers the API call specified in call_msg, to be run repeatedly with
+  // ExecuteCall. The driver instance is looked up once, here. Used to serve
+  // the PrepareCall request from host.
+  // Returns the handle of the call, or -1 if no driver matches call_msg.
+  int PrepareCall(const FunctionCallMessage& call_msg);
+
+  // Runs the call registered with handle by PrepareCall, as CallFunction
+  // does, after replacing the arguments specified in overrides. Used to serve
+  // the ExecuteCall request from host.
+  string ExecuteCall(
+      int handle,
+      const google::protobuf::RepeatedPtrField<CallArgumentOverrideMessage>&
+          overrides,
+      bool binary_result = false);
+
+  // Calls the APIs specified in call_msgs in order, as CallFunction does, and
+  // appends the result of each call to results. If stop_on_error is true,
+  // skips the remaining calls after the first call that fails. Used to serve
+  // the CallFunctions request from host, which saves a round trip per call.
+  // Returns true if all the calls succeed, false otherwise.
+  bool CallFunctions(
+      google::protobuf::RepeatedPtrField<FunctionCallMessage>* call_msgs,
+      bool stop_on_error, bool binary_result, vector<string>* results);
 
-  // Searches hal_driver_map_ for Hidl HAL driver instance with the given
-  // package name, version and component (interface) name. If found, returns
-  // the correponding driver instance, otherwise, creates a new driver instance
-  // with the given info, registers it in hal_driver_map_ and returns the
-  // generated driver instance. This is used by VTS replay test.
+  // Calls the API specified in call_msg as CallFunction does, and passes the
+  // result to done. The calls run on the worker threads started by
+  // SetCallWorkerCount, or inline if there is none. Calls to the same driver
+  // run one at a time in the order they are made, while calls to different
+  // drivers may run concurrently, so that a blocking HAL call doesn't stall
+  // the other HALs. Used to serve pipelined requests from host.
+  void CallFunctionAsync(const FunctionCallMessage& call_msg,
+                         bool binary_result,
+                         function<void(const string&)> done);
+
+  // Starts count worker threads for CallFunctionAsync. Can only be called
+  // once. Coverage measurement is per process, so it should stay at 0 while
+  // collecting the coverage of several drivers.
+  void SetCallWorkerCount(size_t count);
+
+  // Sets the dir of the binary spec cache shared by the driver processes, so
+  // that only the first process parses the text specification files.
+  void SetSpecCacheDir(const string& cache_dir) {
+    hal_driver_loader_.SetSpecCacheDir(cache_dir);
+  }
+
+  // Searches the registered drivers for Hidl HAL driver instance with the
+  // given package name, version and component (interface) name. If found,
+  // returns the correponding driver instance, otherwise, creates a new driver
+  // instance with the given info, registers it and returns the generated
+  // driver instance. This is used by VTS replay test.
   // Args:
   //   version_major: int, hal major version, e.g. 1.0 -> 1.
   //   version_minor: int, hal minor version, e.g. 1.0 -> 0.
@@ -89,6 +151,28 @@ class VtsHalDriverManager {
                      const FunctionSpecificationMessage& expected_result,
                      const FunctionSpecificationMessage& actual_result);
 
+  // Calls the HIDL HAL API specified in call_msg as CallFunction does, and
+  // verifies its results against expected_result, without building or
+  // formatting the result message. Used to serve the
+  // CALL_FUNCTION_AND_VERIFY request from host, e.g. by replay tests that
+  // only need to know whether each call returns the recorded results.
+  // Returns true iff the call succeeds. verified is set to whether the
+  // results match.
+  bool CallFunctionAndVerify(FunctionCallMessage* call_msg,
+                             const FunctionSpecificationMessage& expected_result,
+                             bool* verified);
+
+  // Calls the shared library function specified in call_msg count times in
+  // the driver, with a random value for each call for the arguments without
+  // a value. Used to serve the CALL_FUNCTION_REPEATED request from host, so
+  // that fuzzing library functions that take nanoseconds is not bound by a
+  // round trip per call.
+  // Returns a RepeatedCallResultMessage with the number of calls that
+  // returned each value and the coverage of all the calls, formatted as in
+  // CallFunction, or "error".
+  string CallFunctionRepeated(FunctionCallMessage* call_msg, int count,
+                              bool binary_result = false);
+
   // Loads the specification message for component with given component info
   // such as component_class etc. Used to server the ReadSpecification request
   // from host.
@@ -112,20 +196,57 @@ class VtsHalDriverManager {
 
   // Used to serve the GetAttribute request from host. Only supported by
   // conventional HAL.
+  // The result is formatted as in CallFunction.
   // TODO (zhuoyao): consider deprecate this method.
-  string GetAttribute(FunctionCallMessage* func_msg);
+  string GetAttribute(FunctionCallMessage* func_msg,
+                      bool binary_result = false);
+
+  // Sets the coverage options given in a SET_COVERAGE_OPTIONS command on the
+  // driver it names. Used to serve the SetCoverageOptions request from host.
+  // Returns false if there is no such driver.
+  bool SetCoverageOptions(const VtsDriverControlCommandMessage& command);
+
+  // Returns the time spent in each stage of the commands served, per API.
+  // CallFunction records the stages it runs, and the socket server records
+  // the receive and send stages. Used to serve the GetStats and ResetStats
+  // requests from host.
+  VtsHalDriverStats* GetStats() {
+    return &stats_;
+  }
 
  private:
-  // Internal method to register a HAL driver in hal_driver_map_.
+  struct HalDriverInfo;
+
+  // Whether each argument and return value of an API may hold a resource,
+  // i.e. an interface, FMQ, hidl_memory or handle, as told by the types in
+  // its specification. The others are not preprocessed nor walked for
+  // results, which saves visiting every element of e.g. a vector of structs
+  // of scalars.
+  struct ApiResourceTypes {
+    vector<bool> args;
+    vector<bool> returns;
+  };
+
+  // Internal method to call the API specified in call_msg using the given
+  // driver instance. Returns as CallFunction.
+  string CallDriverFunction(HalDriverInfo* info, FunctionCallMessage* call_msg,
+                            bool binary_result);
+
+  // Internal method to register a HAL driver in driver_chunks_ and, for a
+  // Hidl HAL, in hidl_driver_index_. Thread-safe.
   // Returns the driver id of registed driver.
   DriverId RegisterDriver(std::unique_ptr<DriverBase> driver,
                           const ComponentSpecificationMessage& spec_msg,
                           const uint64_t interface_pt);
 
   // Internal method to get the HAL driver based on the driver id. Returns
-  // nullptr if no driver instance existes with given id.
+  // nullptr if no driver instance existes with given id. Lock-free.
   DriverBase* GetDriverById(const DriverId id);
 
+  // Internal method to get the registered driver info based on driver id.
+  // Returns nullptr if no driver instance existes with given id. Lock-free.
+  HalDriverInfo* GetDriverInfoById(const DriverId id);
+
   // Internal method to get the registered driver pointer based on driver id.
   // Returns -1 if no driver instance existes with given id.
   uint64_t GetDriverPointerById(const DriverId id);
@@ -133,15 +254,36 @@ class VtsHalDriverManager {
   // Internal method to get the HAL driver based on FunctionCallMessage.
   DriverBase* GetDriverWithCallMsg(const FunctionCallMessage& call_msg);
 
+  // Internal method to get the registered driver info based on
+  // FunctionCallMessage.
+  HalDriverInfo* GetDriverInfoWithCallMsg(const FunctionCallMessage& call_msg);
+
   // Internal method to find the driver id based on component spec and
   // (for Hidl HAL) address to the hidl proxy.
   DriverId FindDriverIdInternal(const ComponentSpecificationMessage& spec_msg,
                                 const uint64_t interface_pt = 0,
                                 bool with_interface_pointer = false);
 
+  // Returns the id of the Hidl HAL driver with key in hidl_driver_index_,
+  // or kInvalidDriverId if there is none.
+  DriverId FindHidlDriverId(const string& key);
+
+  // Adds the Hidl HAL driver with key to hidl_driver_index_, unless a driver
+  // is already indexed with key.
+  void AddHidlDriverId(const string& key, DriverId id);
+
+  // Returns true if a Hidl HAL driver with spec_msg belongs in
+  // hidl_driver_index_.
+  static bool IsIndexedHidlSpec(const ComponentSpecificationMessage& spec_msg);
+
+  // Returns the key of hidl_driver_index_ for the package, version and
+  // interface of spec_msg, and for the same with the hidl proxy address.
+  static string GetHidlDriverKey(const ComponentSpecificationMessage& spec_msg);
+  static string GetHidlDriverKey(const string& key, const uint64_t interface_pt);
+
   // Internal method to process function return results for library.
   string ProcessFuncResultsForLibrary(FunctionSpecificationMessage* func_msg,
-                                      void* result);
+                                      void* result, bool binary_result);
 
   // Util method to generate debug message with component info.
   string GetComponentDebugMsg(const int component_class,
@@ -149,6 +291,18 @@ class VtsHalDriverManager {
                               const string& package_name,
                               const string& component_name);
 
+  // Finds, for each API of the Hidl HAL in spec_msg, which arguments and
+  // return values may hold a resource, from the types in spec_msg and in the
+  // specifications it imports.
+  void FindApiResourceTypes(const ComponentSpecificationMessage& spec_msg,
+                            unordered_map<string, ApiResourceTypes>* apis);
+
+  // Preprocesses the arguments of the API in call_msg that may hold a
+  // resource as told by info, or all of them if info doesn't know the API.
+  // Returns true if preprocessing succeeds, false otherwise.
+  bool PreprocessHidlHalFunctionCallArgs(const HalDriverInfo& info,
+                                         FunctionSpecificationMessage* api);
+
   // Recursively preprocess HAL function call arguments that have special types
   // such as TYPE_HIDL_INTERFACE, TYPE_FMQ_SYNC, TYPE_FMQ_UNSYNC,
   // TYPE_HIDL_MEMORY, TYPE_HANDLE.
@@ -167,6 +321,10 @@ class VtsHalDriverManager {
   // @return true if setting results succeeds, false otherwise.
   bool SetHidlHalFunctionCallResults(VariableSpecificationMessage* return_val);
 
+  // Runs the calls queued by CallFunctionAsync until the manager is
+  // destroyed.
+  void RunCallWorker();
+
   // ============== attributes ===================
 
   // The server socket port # of the agent.
@@ -182,6 +340,9 @@ class VtsHalDriverManager {
     uint64_t hidl_hal_proxy_pt;
     // A HAL driver instance.
     std::unique_ptr<DriverBase> driver;
+    // The resource types of each API, by name, for HIDL HAL only. Set before
+    // the driver is registered.
+    unordered_map<string, ApiResourceTypes> api_resource_types;
 
     // Constructor for halDriverInfo
     HalDriverInfo(const ComponentSpecificationMessage& spec_msg,
@@ -191,11 +352,38 @@ class VtsHalDriverManager {
           hidl_hal_proxy_pt(interface_pt),
           driver(std::move(driver)) {}
   };
-  // map to keep all the active HAL driver instances and their corresponding
-  // meta info.
-  // TODO(zhuoyao): consider to use unordered_map for performance optimization.
-  map<DriverId, HalDriverInfo> hal_driver_map_;
-  // TODO(zhuoyao): use mutex to protect hal_driver_map_;
+  // the maximum count of CallFunctionRepeated, and the number of distinct
+  // return values it counts.
+  static constexpr int kMaxRepeatCount = 1 << 20;
+  static constexpr int kMaxRepeatedCallResults = 64;
+
+  // the registered drivers, by driver id, in chunks of kDriverChunkSize.
+  // drivers are never unregistered, so a HalDriverInfo and its driver live as
+  // long as the manager, and GetDriverById reads them without a lock:
+  // RegisterDriver fills the slot of a new id before publishing the id in
+  // driver_count_, and a slot is never written again.
+  static constexpr size_t kDriverChunkSize = 64;
+  static constexpr size_t kMaxDriverChunks = 1024;
+  HalDriverInfo** driver_chunks_[kMaxDriverChunks] = {};
+  // the number of registered drivers, which are ids 0 to driver_count_ - 1.
+  atomic<DriverId> driver_count_{0};
+  // serializes RegisterDriver, so that a driver is registered once, and
+  // protects the members below.
+  mutex driver_register_lock_;
+  // own the registered drivers and the chunks of driver_chunks_.
+  vector<std::unique_ptr<HalDriverInfo>> drivers_;
+  vector<std::unique_ptr<HalDriverInfo*[]>> owned_driver_chunks_;
+
+  // a shard of the index of the Hidl HAL drivers by GetHidlDriverKey, with
+  // and without the hidl proxy address. the index is sharded by the hash of
+  // the key, so that the lookups of the calls to different HALs don't
+  // contend on a lock.
+  struct HidlDriverIndexShard {
+    shared_mutex lock;
+    unordered_map<string, DriverId> driver_ids;
+  };
+  static constexpr size_t kHidlDriverIndexShardCount = 16;
+  HidlDriverIndexShard hidl_driver_index_[kHidlDriverIndexShardCount];
 
   // Hold onto a resource_manager because some function calls need to reference
   // resources allocated on the target side.
@@ -203,6 +391,29 @@ class VtsHalDriverManager {
   // resource_manager are both started by the agent. driver_manager only holds
   // this pointer because it is easy to call functions in resource_manager.
   VtsResourceManager* resource_manager_;
+
+  // protects the members below.
+  mutex call_queue_lock_;
+  // signaled when a driver is ready or the workers stop.
+  condition_variable call_queue_cond_;
+  // the calls of each driver. the front call is running if the driver is not
+  // in ready_drivers_.
+  map<DriverBase*, deque<function<void()>>> driver_call_queues_;
+  // the drivers with calls to run, none of which is running.
+  deque<DriverBase*> ready_drivers_;
+  // whether the workers should exit once the queues are drained.
+  bool stopping_;
+  vector<thread> call_workers_;
+  // the cookie of the last async call traced.
+  atomic<int32_t> async_trace_cookie_{0};
+
+  // the time spent in each stage of the commands.
+  VtsHalDriverStats stats_;
+
+  // protects prepared_calls_.
+  mutex prepared_calls_lock_;
+  // the calls registered by PrepareCall with their driver, by handle.
+  vector<pair<HalDriverInfo*, FunctionCallMessage>> prepared_calls_;
 };
 
 }  // namespace vts
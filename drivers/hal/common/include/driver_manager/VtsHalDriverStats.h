@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_DRIVER_HAL_VTSHALDRIVERSTATS_H
+#define __VTS_DRIVER_HAL_VTSHALDRIVERSTATS_H
+
+#include <stdint.h>
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// The stages of a command served by the driver.
+enum DriverStage {
+  // Reading the command from the socket and parsing it.
+  kStageReceive,
+  // Preprocessing the arguments, e.g. PreprocessHidlHalFunctionCallArgs.
+  kStagePreprocess,
+  // The HAL call itself.
+  kStageCall,
+  // Collecting the coverage in FunctionCallEnd.
+  kStageCoverage,
+  // Setting the results, e.g. SetHidlHalFunctionCallResults.
+  kStageResults,
+  // Formatting the results into the return message.
+  kStageFormat,
+  // Serializing the response and writing it to the socket.
+  kStageSend,
+  kDriverStageCount
+};
+
+// Aggregates the time spent in each stage of the commands into a histogram
+// per API and stage. Thread-safe.
+class VtsHalDriverStats {
+ public:
+  // Returns the current time in ns, on the clock used for the samples.
+  static int64_t NowNs();
+
+  // Adds the time spent by one command for api in each stage, in ns. A
+  // negative time means the command didn't go through the stage.
+  void Record(const string& api, const int64_t (&stage_ns)[kDriverStageCount]);
+
+  // Adds the time spent by one command for api in a single stage, in ns.
+  void Record(const string& api, DriverStage stage, int64_t elapsed_ns);
+
+  // Returns the statistics in text, one line per API and stage with the
+  // count, mean, approximate percentiles and max time.
+  string Dump();
+
+  // Clears all the statistics.
+  void Reset();
+
+ private:
+  // the histogram of the times of a stage, in buckets of powers of 2 ns.
+  struct Histogram {
+    uint64_t count = 0;
+    int64_t total_ns = 0;
+    int64_t max_ns = 0;
+    uint64_t buckets[64] = {};
+
+    void Add(int64_t elapsed_ns);
+
+    // Returns the upper bound of the bucket holding the given percentile.
+    int64_t Percentile(int percentile) const;
+  };
+
+  // protects stats_.
+  mutex lock_;
+  // the histograms of each API.
+  map<string, array<Histogram, kDriverStageCount>> stats_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  //__VTS_DRIVER_HAL_VTSHALDRIVERSTATS_H
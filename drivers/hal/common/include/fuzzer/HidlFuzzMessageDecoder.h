@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_FUZZER_HIDLFUZZMESSAGEDECODER_H__
+#define __VTS_SYSFUZZER_COMMON_FUZZER_HIDLFUZZMESSAGEDECODER_H__
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "component_loader/HalDriverLoader.h"
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "utils/FuzzDecodeUtil.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Decodes the input of a fuzzer into the function call messages of a HIDL
+// HAL driver, so that the input can be passed to DriverBase::CallFunction
+// in process. The arguments are decoded as utils/FuzzDecodeUtil.h decodes
+// the C++ values, except that an enum takes one of its enumerators.
+//
+// The functions whose arguments can't be decoded, e.g. interfaces, handles
+// and queues, are not fuzzed.
+class HidlFuzzMessageDecoder {
+ public:
+  // @param component the specification of the interface to fuzz.
+  // @param loader    to find the specifications of the types that the
+  //                  interface uses from the types.hal of a package.
+  HidlFuzzMessageDecoder(const ComponentSpecificationMessage& component,
+                         HalDriverLoader* loader);
+
+  // Returns the number of the functions that can be fuzzed.
+  size_t GetFunctionCount() const { return function_specs_.size(); }
+
+  // Returns the index of the function named name, -1 if it can't be fuzzed.
+  int FindFunction(const string& name) const;
+
+  // Decodes a call of a function from cursor.
+  //
+  // @param index  index of the function, less than GetFunctionCount().
+  // @param cursor the input.
+  //
+  // @return the call message, which is reused by the next call of the same
+  //         function, nullptr if the input is too short.
+  const FunctionSpecificationMessage* DecodeCall(size_t index,
+                                                 FuzzDataCursor& cursor);
+
+ private:
+  // Returns whether a variable of the given specification can be decoded.
+  bool IsSupported(const VariableSpecificationMessage& spec);
+
+  // Decodes a variable of the given specification into var.
+  //
+  // @return false if the input is too short.
+  bool DecodeVariable(const VariableSpecificationMessage& spec,
+                      FuzzDataCursor& cursor,
+                      VariableSpecificationMessage* var);
+
+  // Returns the declaration of a struct or an enum, nullptr if not found.
+  // The types.hal of the package of type_name is loaded on the first lookup.
+  const VariableSpecificationMessage* FindType(const string& type_name);
+
+  // Adds attribute and the types nested in it to types_.
+  void AddType(const VariableSpecificationMessage& attribute);
+
+  HalDriverLoader* loader_;
+  // the specifications of the functions that can be fuzzed.
+  vector<FunctionSpecificationMessage> function_specs_;
+  // the call messages of function_specs_, reused between calls.
+  vector<FunctionSpecificationMessage> function_calls_;
+  // the declared types, by fully qualified name.
+  map<string, VariableSpecificationMessage> types_;
+  // the packages, as package@version, whose types.hal was looked up.
+  set<string> loaded_packages_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_FUZZER_HIDLFUZZMESSAGEDECODER_H__
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_DRIVER_HAL_VTSHALTRACEREPLAYER_H
+#define __VTS_DRIVER_HAL_VTSHALTRACEREPLAYER_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// The options of a VtsHalTraceReplayer.
+struct TraceReplayOptions {
+  // the dir of the interface specification files.
+  string spec_dir;
+  // the name of the HAL services to replay the calls on, empty for the
+  // default one.
+  string service_name;
+  // whether each call is made when it was recorded, relative to the first
+  // call, instead of right after the previous one. The calls are then made
+  // in the order of their timestamps rather than of the trace records.
+  bool timed = false;
+  // the number of sessions replaying the trace concurrently, each with its
+  // own drivers.
+  int sessions = 1;
+  // the number of times each session replays the trace.
+  int repeat = 1;
+  // the number of threads of each session calling the drivers, or 0 to make
+  // the calls on the session thread. with threads, the calls to each driver
+  // are made in order, one at a time, but the calls to different drivers
+  // run concurrently, so a blocking HAL doesn't hold up the others.
+  int call_workers = 0;
+};
+
+// The results of a replay.
+struct TraceReplayStats {
+  // the calls made, and those that failed.
+  uint64_t calls = 0;
+  uint64_t failed_calls = 0;
+  // the time from the start of the first session to the end of the last.
+  int64_t elapsed_ns = 0;
+  // the latency of each call that succeeded, including the time it waited for
+  // the calls before it to the same driver with call_workers.
+  vector<int64_t> latencies_ns;
+  // in timed mode, how late each call was made compared to the trace.
+  vector<int64_t> lags_ns;
+};
+
+// Replays the HIDL HAL calls recorded in a trace on device, in process, by
+// calling the generated drivers through a VtsHalDriverManager per session,
+// without the agent and a socket round trip per call.
+//
+// Only the calls received by the HALs are replayed, i.e. the
+// SERVER_API_ENTRY and PASSTHROUGH_ENTRY records. The trace must be made of
+// delimited records that are not compressed, as read by VtsTraceReader;
+// other traces can be converted with trace_processor first.
+class VtsHalTraceReplayer {
+ public:
+  explicit VtsHalTraceReplayer(const TraceReplayOptions& options)
+      : options_(options) {}
+
+  // Reads the calls to replay from trace_file.
+  //
+  // @return false if the trace can't be read or has no call to replay.
+  bool LoadTrace(const string& trace_file);
+
+  // Replays the calls loaded by LoadTrace.
+  //
+  // @return false if a session can't get the drivers of the calls.
+  bool Replay(TraceReplayStats* stats);
+
+ private:
+  // A call to replay.
+  struct Call {
+    // the time it was recorded, relative to the first call in the trace,
+    // or to the earliest call in timed mode.
+    int64_t offset_ns;
+    // the call, without the driver id, which differs between sessions.
+    FunctionCallMessage call_msg;
+    // the index of its interface in interfaces_.
+    size_t interface_index;
+  };
+
+  // A HAL interface called in the trace.
+  struct Interface {
+    string package;
+    int version_major;
+    int version_minor;
+    string name;
+  };
+
+  // Replays the calls options_.repeat times with its own drivers.
+  //
+  // @return false if it can't get the drivers.
+  bool RunSession(TraceReplayStats* stats);
+
+  TraceReplayOptions options_;
+  vector<Call> calls_;
+  vector<Interface> interfaces_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_DRIVER_HAL_VTSHALTRACEREPLAYER_H
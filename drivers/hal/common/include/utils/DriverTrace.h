@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_DRIVERTRACE_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_DRIVERTRACE_H__
+
+#include <stdint.h>
+
+#include <string>
+
+#include <cutils/trace.h>
+
+namespace android {
+namespace vts {
+
+// The driver traces the stages of the commands it serves, from the binder
+// service and the socket server down to VtsHalDriverManager, as atrace
+// slices in the hal category, e.g. "atrace -c hal" or a perfetto config
+// with the "hal" atrace category. When the category is off, a trace point
+// costs one load and branch, and no name is formatted.
+
+// Returns whether the driver traces are recorded.
+inline bool IsDriverTraceEnabled() {
+  return atrace_is_tag_enabled(ATRACE_TAG_HAL);
+}
+
+// Traces a slice on the calling thread for the lifetime of the object.
+class ScopedDriverTrace {
+ public:
+  explicit ScopedDriverTrace(const char* name)
+      : enabled_(IsDriverTraceEnabled()) {
+    if (enabled_) atrace_begin(ATRACE_TAG_HAL, name);
+  }
+
+  // The slice is named "<name> <detail>", e.g. the API called.
+  ScopedDriverTrace(const char* name, const std::string& detail)
+      : enabled_(IsDriverTraceEnabled()) {
+    if (enabled_) {
+      atrace_begin(ATRACE_TAG_HAL, (std::string(name) + " " + detail).c_str());
+    }
+  }
+
+  // The slice is named "<name> <detail>", e.g. the size of a payload.
+  ScopedDriverTrace(const char* name, int64_t detail)
+      : enabled_(IsDriverTraceEnabled()) {
+    if (enabled_) {
+      atrace_begin(ATRACE_TAG_HAL,
+                   (std::string(name) + " " + std::to_string(detail)).c_str());
+    }
+  }
+
+  ~ScopedDriverTrace() {
+    if (enabled_) atrace_end(ATRACE_TAG_HAL);
+  }
+
+  ScopedDriverTrace(const ScopedDriverTrace&) = delete;
+  ScopedDriverTrace& operator=(const ScopedDriverTrace&) = delete;
+
+ private:
+  // whether the slice was begun, so that it ends even if the category is
+  // turned off meanwhile.
+  const bool enabled_;
+};
+
+// Traces a slice that may begin and end on different threads, e.g. an async
+// call from the time it is queued to the time it is done. cookie tells apart
+// the slices of the same name that overlap.
+inline void DriverTraceAsyncBegin(const char* name, int32_t cookie) {
+  atrace_async_begin(ATRACE_TAG_HAL, name, cookie);
+}
+
+inline void DriverTraceAsyncEnd(const char* name, int32_t cookie) {
+  atrace_async_end(ATRACE_TAG_HAL, name, cookie);
+}
+
+// Traces a value, e.g. the depth of a queue.
+inline void DriverTraceCounter(const char* name, int64_t value) {
+  atrace_int64(ATRACE_TAG_HAL, name, value);
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_DRIVERTRACE_H__
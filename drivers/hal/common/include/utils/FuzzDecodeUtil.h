@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_FUZZDECODEUTIL_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_FUZZDECODEUTIL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <hidl/HidlSupport.h>
+
+// the mutator of libFuzzer, for the inputs not mutated by MutateFuzzInput.
+extern "C" size_t LLVMFuzzerMutate(uint8_t* data, size_t size,
+                                   size_t max_size);
+
+using namespace std;
+
+// Header-only decoding of the arguments of HIDL HAL functions from the input
+// of the generated fuzzers. Scalars and other trivially copyable values are
+// copied from the input as they are. Strings and vectors are prefixed by
+// their length. Structs are decoded field by field.
+//
+// The generated fuzzers decode into arguments that they reuse between
+// inputs, so that a vector is only reallocated when its length changes.
+//
+// The enums and the masks in an input are copied as they are too, but their
+// valid values are known from the HIDL types, so MutateFuzzInput can find
+// them by decoding the input and set them to valid values. The generated
+// fuzzers use it as their LLVMFuzzerCustomMutator.
+
+namespace android {
+namespace vts {
+
+// An enum or a mask found in an input by MutateFuzzInput.
+struct FuzzTypedField {
+  // the offset of the value in the input, and its size in bytes.
+  size_t offset;
+  size_t size;
+  // the valid values of the enum, or the bits of the mask.
+  const vector<uint64_t>* values;
+  bool is_mask;
+};
+
+// Reads the input of a fuzzer from the front.
+class FuzzDataCursor {
+ public:
+  FuzzDataCursor(const uint8_t* data, size_t size)
+      : begin_(data), data_(data), size_(size) {}
+
+  // Returns the number of bytes left.
+  size_t remaining() const { return size_; }
+
+  // Makes the decoders add the enums and the masks that they decode to
+  // fields, for MutateFuzzInput.
+  void set_fields(vector<FuzzTypedField>* fields) { fields_ = fields; }
+  bool has_fields() const { return fields_ != nullptr; }
+
+  // Adds the value decoded from the size bytes at bytes to the fields, if
+  // set_fields was called.
+  void AddField(const uint8_t* bytes, size_t size,
+                const vector<uint64_t>& values, bool is_mask) {
+    if (fields_ == nullptr || values.empty()) return;
+    fields_->push_back({static_cast<size_t>(bytes - begin_), size, &values,
+                        is_mask});
+  }
+
+  // Consumes the next size bytes.
+  //
+  // @return the bytes, nullptr if less than size bytes are left, consuming
+  //         nothing.
+  const uint8_t* Consume(size_t size) {
+    if (size_ < size) return nullptr;
+    const uint8_t* bytes = data_;
+    data_ += size;
+    size_ -= size;
+    return bytes;
+  }
+
+  // Copies the next size bytes to dest.
+  //
+  // @return false if less than size bytes are left, consuming nothing.
+  bool ConsumeBytes(void* dest, size_t size) {
+    const uint8_t* bytes = Consume(size);
+    if (bytes == nullptr) return false;
+    memcpy(dest, bytes, size);
+    return true;
+  }
+
+  // Reads the length of a string or a vector, as a 16-bit value that is
+  // reduced to at most the number of bytes left after it.
+  //
+  // @return false if the input is too short.
+  bool ConsumeLength(size_t* length) {
+    uint16_t value;
+    if (!ConsumeBytes(&value, sizeof(value))) return false;
+    *length = value % (size_ + 1);
+    return true;
+  }
+
+ private:
+  const uint8_t* begin_;
+  const uint8_t* data_;
+  size_t size_;
+  vector<FuzzTypedField>* fields_ = nullptr;
+};
+
+// Returns the values of the HIDL enum E, each converted from the underlying
+// type of E, e.g. sign-extended.
+template <typename E>
+const vector<uint64_t>& GetFuzzEnumValues() {
+  static const vector<uint64_t> values = [] {
+    vector<uint64_t> result;
+    for (E value : hardware::hidl_enum_range<E>()) {
+      result.push_back(static_cast<uint64_t>(
+          static_cast<typename underlying_type<E>::type>(value)));
+    }
+    return result;
+  }();
+  return values;
+}
+
+// Decodes a value of type T. vtsc specializes it for the structs of the
+// interface being fuzzed. The other types that can't be copied from the
+// input, e.g. interfaces and handles, are left as they are.
+template <typename T, typename Enable = void>
+struct VtsFuzzDecoder {
+  static bool Decode(FuzzDataCursor& cursor, T* value) {
+    if constexpr (is_trivially_copyable<T>::value) {
+      return cursor.ConsumeBytes(value, sizeof(T));
+    } else {
+      return true;
+    }
+  }
+};
+
+template <typename T>
+struct VtsFuzzDecoder<T, typename enable_if<is_enum<T>::value>::type> {
+  static bool Decode(FuzzDataCursor& cursor, T* value) {
+    const uint8_t* bytes = cursor.Consume(sizeof(T));
+    if (bytes == nullptr) return false;
+    memcpy(value, bytes, sizeof(T));
+    if (cursor.has_fields()) {
+      cursor.AddField(bytes, sizeof(T), GetFuzzEnumValues<T>(), false);
+    }
+    return true;
+  }
+};
+
+// Decodes value from cursor, e.g.
+//   DecodeFuzzValue(cursor, &arg0).
+//
+// @return false if the input is too short.
+template <typename T>
+bool DecodeFuzzValue(FuzzDataCursor& cursor, T* value) {
+  return VtsFuzzDecoder<T>::Decode(cursor, value);
+}
+
+// Decodes a mask of the bits of the HIDL enum E, whose type is the
+// underlying scalar type T of E, e.g.
+//   DecodeFuzzMask<IFoo::BitField>(cursor, &arg0).
+//
+// @return false if the input is too short.
+template <typename E, typename T>
+bool DecodeFuzzMask(FuzzDataCursor& cursor, T* value) {
+  const uint8_t* bytes = cursor.Consume(sizeof(T));
+  if (bytes == nullptr) return false;
+  memcpy(value, bytes, sizeof(T));
+  if (cursor.has_fields()) {
+    cursor.AddField(bytes, sizeof(T), GetFuzzEnumValues<E>(), true);
+  }
+  return true;
+}
+
+// Decodes count elements of type T into the array at elements.
+template <typename T>
+bool DecodeFuzzElements(FuzzDataCursor& cursor, size_t count, T* elements) {
+  // bool is excluded, since not every byte is a valid bool. The enums are
+  // decoded one by one when MutateFuzzInput looks for them.
+  if constexpr ((is_arithmetic<T>::value || is_enum<T>::value) &&
+                !is_same<T, bool>::value) {
+    if (!is_enum<T>::value || !cursor.has_fields()) {
+      return cursor.ConsumeBytes(elements, count * sizeof(T));
+    }
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!DecodeFuzzValue(cursor, &elements[i])) return false;
+  }
+  return true;
+}
+
+template <>
+struct VtsFuzzDecoder<bool> {
+  static bool Decode(FuzzDataCursor& cursor, bool* value) {
+    uint8_t byte;
+    if (!cursor.ConsumeBytes(&byte, sizeof(byte))) return false;
+    *value = byte & 1;
+    return true;
+  }
+};
+
+template <>
+struct VtsFuzzDecoder<hardware::hidl_string> {
+  static bool Decode(FuzzDataCursor& cursor, hardware::hidl_string* value) {
+    size_t length;
+    if (!cursor.ConsumeLength(&length)) return false;
+    // copied, since the string must be null-terminated.
+    *value = hardware::hidl_string(
+        reinterpret_cast<const char*>(cursor.Consume(length)), length);
+    return true;
+  }
+};
+
+template <typename T>
+struct VtsFuzzDecoder<hardware::hidl_vec<T>> {
+  static bool Decode(FuzzDataCursor& cursor, hardware::hidl_vec<T>* value) {
+    size_t length;
+    if (!cursor.ConsumeLength(&length)) return false;
+    if (value->size() != length) value->resize(length);
+    return DecodeFuzzElements(cursor, length, value->data());
+  }
+};
+
+template <typename T, size_t SIZE1, size_t... SIZES>
+struct VtsFuzzDecoder<hardware::hidl_array<T, SIZE1, SIZES...>> {
+  static bool Decode(FuzzDataCursor& cursor,
+                     hardware::hidl_array<T, SIZE1, SIZES...>* value) {
+    // the elements of all the dimensions are contiguous.
+    return DecodeFuzzElements(cursor, SIZE1 * (SIZES * ... * 1),
+                              value->data());
+  }
+};
+
+// Mutates the input of a fuzzer at data, as LLVMFuzzerCustomMutator does.
+// decode decodes the whole input from the FuzzDataCursor it is given, e.g.
+// with a null HAL, so that the enums and the masks in the input are found.
+// Half of the time, one of them is set to a valid value of the enum, or a
+// bit of the mask is set or cleared. The other inputs, and those without
+// enums or masks, are mutated by libFuzzer.
+template <typename DecodeFunc>
+size_t MutateFuzzInput(uint8_t* data, size_t size, size_t max_size,
+                       unsigned int seed, DecodeFunc decode) {
+  static vector<FuzzTypedField> fields;
+  minstd_rand random(seed);
+  if (random() % 2 == 0) return LLVMFuzzerMutate(data, size, max_size);
+
+  fields.clear();
+  FuzzDataCursor cursor(data, size);
+  cursor.set_fields(&fields);
+  decode(cursor);
+  if (fields.empty()) return LLVMFuzzerMutate(data, size, max_size);
+
+  const FuzzTypedField& field = fields[random() % fields.size()];
+  const vector<uint64_t>& values = *field.values;
+  uint64_t value = values[random() % values.size()];
+  if (field.is_mask) {
+    uint64_t mask = 0;
+    memcpy(&mask, data + field.offset, field.size);
+    value = random() % 2 == 0 ? mask | value : mask & ~value;
+  }
+  // the low bytes of the values, on a little-endian device.
+  memcpy(data + field.offset, &value, field.size);
+  return size;
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_FUZZDECODEUTIL_H__
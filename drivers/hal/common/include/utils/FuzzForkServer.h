@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_FUZZFORKSERVER_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_FUZZFORKSERVER_H__
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace android {
+namespace vts {
+
+// Runs the inputs of a libFuzzer fuzzer in batches, each in a child forked
+// from the fuzzer process, so that every batch starts from the state that
+// the process had before its first input, e.g. right after it got its HAL
+// service. That resets a stateful HAL without getting the service and
+// initializing the HAL again.
+//
+// The first input forks the first child, which returns from BeginInput and
+// goes on fuzzing, while the parent waits. The child exits before running
+// batch_size more inputs, and the parent forks the next one. If a child
+// stops otherwise, e.g. when it crashes, after libFuzzer wrote the crash
+// input, or when it is done fuzzing, the parent exits the same way.
+//
+// The parent never returns from its first input, so every child starts
+// from the libFuzzer state of that input: -runs doesn't stop the fuzzing,
+// use -max_total_time instead, and the inputs found by a child are only
+// kept if libFuzzer writes them to a corpus dir. A child doesn't inherit
+// the -rss_limit_mb thread of libFuzzer either.
+class FuzzForkServer {
+ public:
+  // Removes the --vts_fork_batch_size=<size> flag from the arguments given
+  // to LLVMFuzzerInitialize, and sets the batch size to its value.
+  // Without the flag, the batch size is 0 and the inputs are not forked.
+  void ExtractBatchSize(int* argc, char*** argv) {
+    static const char kFlag[] = "--vts_fork_batch_size=";
+    int count = 0;
+    for (int i = 0; i < *argc; i++) {
+      char* arg = (*argv)[i];
+      if (strncmp(arg, kFlag, strlen(kFlag)) == 0) {
+        batch_size_ = strtoul(arg + strlen(kFlag), nullptr, 10);
+      } else {
+        (*argv)[count++] = arg;
+      }
+    }
+    *argc = count;
+  }
+
+  // Called at the start of each input, after the state shared by the
+  // batches is set up. Returns in the child that runs the input.
+  void BeginInput() {
+    if (batch_size_ == 0) return;
+    if (is_child_) {
+      if (++input_count_ > batch_size_) _exit(kBatchDoneExitCode);
+      return;
+    }
+    // the timers of libFuzzer, e.g. for -timeout, are not inherited by the
+    // children, and would time the parent out while it waits.
+    struct itimerval timer;
+    struct itimerval no_timer = {};
+    getitimer(ITIMER_REAL, &timer);
+    setitimer(ITIMER_REAL, &no_timer, nullptr);
+    while (true) {
+      pid_t pid = fork();
+      if (pid < 0) {
+        perror("fork failed, fuzzing without forking");
+        batch_size_ = 0;
+        setitimer(ITIMER_REAL, &timer, nullptr);
+        return;
+      }
+      if (pid == 0) {
+        is_child_ = true;
+        input_count_ = 1;
+        setitimer(ITIMER_REAL, &timer, nullptr);
+        return;
+      }
+      int status;
+      while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+          perror("waitpid failed");
+          _exit(1);
+        }
+      }
+      if (WIFEXITED(status)) {
+        if (WEXITSTATUS(status) == kBatchDoneExitCode) continue;
+        fprintf(stderr, "Fuzzing child %d exited with %d.\n", pid,
+                WEXITSTATUS(status));
+        _exit(WEXITSTATUS(status));
+      }
+      int signal = WTERMSIG(status);
+      fprintf(stderr, "Fuzzing child %d was killed by signal %d (%s).\n", pid,
+              signal, strsignal(signal));
+      _exit(128 + signal);
+    }
+  }
+
+ private:
+  // the exit code of a child that ran its batch.
+  static constexpr int kBatchDoneExitCode = 111;
+
+  // the number of inputs run by each child, 0 to not fork.
+  size_t batch_size_ = 0;
+  // whether this is a child.
+  bool is_child_ = false;
+  // the number of inputs run by this child.
+  size_t input_count_ = 0;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_FUZZFORKSERVER_H__
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_FUZZREMOTECOVERAGE_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_FUZZREMOTECOVERAGE_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/SharedEdgeCounters.h"
+
+namespace android {
+namespace vts {
+
+// The number of the extra coverage counters of libFuzzer that the remote
+// edges are folded into.
+static constexpr size_t kRemoteCoverageCounterCount = 1 << 16;
+
+// The counters that libFuzzer reads after each input in addition to the
+// coverage of the fuzzer process, see FuzzerExtraCounters.cpp. They are
+// used instead of __sanitizer_cov_8bit_counters_init, which libFuzzer would
+// reject for having no PC table.
+__attribute__((section("__libfuzzer_extra_counters"), used))
+static uint8_t remote_coverage_counters[kRemoteCoverageCounterCount];
+
+// Feeds the edge coverage of a HAL server process, which shares its edge
+// counters through libvts_measurement (see SharedEdgeCounters.h), to the
+// libFuzzer of a fuzzer calling that HAL, so that fuzzing a binderized HAL
+// is guided by the coverage of the HAL.
+//
+// The counters of the HAL are cleared before each input and folded into
+// remote_coverage_counters after it, so they also count the calls of other
+// clients made meanwhile.
+class FuzzRemoteCoverage {
+ public:
+  // Removes the --vts_remote_coverage=<path> flag from the arguments given
+  // to LLVMFuzzerInitialize, and maps the file at path, which the HAL
+  // server must have created. Without the flag, nothing is mapped and the
+  // other methods do nothing.
+  void ExtractAndMap(int* argc, char*** argv) {
+    static const char kFlag[] = "--vts_remote_coverage=";
+    int count = 0;
+    const char* path = nullptr;
+    for (int i = 0; i < *argc; i++) {
+      char* arg = (*argv)[i];
+      if (strncmp(arg, kFlag, strlen(kFlag)) == 0) {
+        path = arg + strlen(kFlag);
+      } else {
+        (*argv)[count++] = arg;
+      }
+    }
+    *argc = count;
+    if (path == nullptr) return;
+    counters_ = MapSharedEdgeCounters(path, false);
+    if (counters_ == nullptr) {
+      fprintf(stderr, "Can't map the edge counters in %s; is %s set for the "
+              "HAL server?\n", path, kSharedEdgeCountersProperty);
+      exit(1);
+    }
+  }
+
+  // Called at the start of each input. Clears the counters of the HAL.
+  void BeginInput() {
+    if (counters_ == nullptr) return;
+    memset(counters_->counters, 0, GetEdgeCount());
+  }
+
+  // Called at the end of each input. Folds the counters of the HAL into
+  // the extra counters of libFuzzer, which cleared them before the input.
+  void EndInput() {
+    if (counters_ == nullptr) return;
+    size_t edge_count = GetEdgeCount();
+    const uint8_t* counters = counters_->counters;
+    // most of the edges are not hit, so 8 counters are checked at a time.
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= edge_count; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, counters + i, sizeof(word));
+      if (word == 0) continue;
+      for (size_t j = i; j < i + sizeof(uint64_t); j++) {
+        AddHits(j, counters[j]);
+      }
+    }
+    for (; i < edge_count; i++) {
+      AddHits(i, counters[i]);
+    }
+  }
+
+ private:
+  size_t GetEdgeCount() const {
+    size_t edge_count = counters_->edge_count.load(std::memory_order_acquire);
+    return edge_count < kMaxSharedEdgeCount ? edge_count : kMaxSharedEdgeCount;
+  }
+
+  // Adds the hits of an edge to its extra counter, saturating.
+  static void AddHits(size_t edge, uint8_t hits) {
+    if (hits == 0) return;
+    uint8_t& counter =
+        remote_coverage_counters[edge % kRemoteCoverageCounterCount];
+    counter = counter > 255 - hits ? 255 : counter + hits;
+  }
+
+  // the counters shared by the HAL server, nullptr if not mapped.
+  SharedEdgeCounters* counters_ = nullptr;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_FUZZREMOTECOVERAGE_H__
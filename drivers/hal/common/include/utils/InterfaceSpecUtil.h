@@ -17,7 +17,11 @@
 #ifndef __VTS_SYSFUZZER_COMMON_UTILS_IFSPECUTIL_H__
 #define __VTS_SYSFUZZER_COMMON_UTILS_IFSPECUTIL_H__
 
+#include <string.h>
+
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
@@ -33,6 +37,21 @@ namespace vts {
 bool ParseInterfaceSpec(const char* file_path,
                         ComponentSpecificationMessage* message);
 
+// Same as ParseInterfaceSpec, but first looks up the binary serialized
+// message in cache_dir, keyed by the hash of the file contents. On a miss,
+// parses the text and writes the binary message to cache_dir for the next
+// process. An empty cache_dir disables the cache.
+bool ParseInterfaceSpecCached(const char* file_path, const string& cache_dir,
+                              ComponentSpecificationMessage* message);
+
+// Returns the specification in file_path, parsed as ParseInterfaceSpecCached
+// does. The parsed specifications are kept for the life of the process, by
+// path, and a file is parsed again only if its modification time or size
+// changed. The returned message is shared and must not be modified.
+// Thread-safe. Returns nullptr if the file can't be read or parsed.
+shared_ptr<const ComponentSpecificationMessage> GetInterfaceSpec(
+    const string& file_path, const string& cache_dir);
+
 // Returns the function name prefix of a given interface specification.
 string GetFunctionNamePrefix(const ComponentSpecificationMessage& message);
 
@@ -113,6 +132,32 @@ int GetVersionMinor(const string& version, bool for_macro = false);
 // e.g. ::android::hardware::nfc::V1_0::INfc -> INfc
 string GetComponentName(const string& type_name);
 
+// Returns the elements of a vector or an array of scalars, which are held
+// either as raw bytes in vector_raw_value or as messages in vector_value.
+// e.g. GetScalarVectorValues<int32_t>(var, &ScalarDataValueMessage::int32_t)
+template <typename T>
+vector<T> GetScalarVectorValues(const VariableSpecificationMessage& var,
+                                T (ScalarDataValueMessage::*getter)() const) {
+  vector<T> values;
+  if (var.has_vector_raw_value()) {
+    // copies element by element, since vector<bool> has no contiguous data.
+    const string& data = var.vector_raw_value();
+    values.reserve(data.size() / sizeof(T));
+    for (size_t offset = 0; offset + sizeof(T) <= data.size();
+         offset += sizeof(T)) {
+      T value;
+      memcpy(&value, data.data() + offset, sizeof(T));
+      values.push_back(value);
+    }
+  } else {
+    values.reserve(var.vector_value_size());
+    for (const auto& element : var.vector_value()) {
+      values.push_back((element.scalar_value().*getter)());
+    }
+  }
+  return values;
+}
+
 }  // namespace vts
 }  // namespace android
 
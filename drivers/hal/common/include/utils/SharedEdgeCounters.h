@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_SHAREDEDGECOUNTERS_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_SHAREDEDGECOUNTERS_H__
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+
+namespace android {
+namespace vts {
+
+// The property naming the file through which a process instrumented with
+// libvts_measurement shares its edge counters, e.g. for a fuzzer in another
+// process to get the coverage of a binderized HAL. The file is created by
+// the first module of the process that gets instrumented, so the property
+// must be set before the process starts. Only one process should use a
+// file at a time.
+static constexpr const char* kSharedEdgeCountersProperty =
+    "hal.instrumentation.coverage.shm";
+
+// The maximum number of edges of a process, beyond which edges are not
+// counted.
+static constexpr size_t kMaxSharedEdgeCount = 1 << 20;
+
+// The layout of the shared file.
+struct SharedEdgeCounters {
+  // the number of edges of the instrumented code loaded so far.
+  std::atomic<uint32_t> edge_count;
+  // the hit counter of each edge, indexed by the pc guard value minus 1.
+  uint8_t counters[kMaxSharedEdgeCount];
+};
+
+// Maps the shared edge counters in the file at path.
+//
+// @param path   path of the file.
+// @param create whether to create the file, as the instrumented process
+//               does, or to open the existing one.
+//
+// @return the counters, nullptr if the file can't be mapped.
+inline SharedEdgeCounters* MapSharedEdgeCounters(const char* path,
+                                                 bool create) {
+  // a file left by a previous process is cleared.
+  int flags = create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR;
+  int fd = open(path, flags | O_CLOEXEC, 0666);
+  if (fd < 0) return nullptr;
+  if (create && ftruncate(fd, sizeof(SharedEdgeCounters)) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  void* addr = mmap(nullptr, sizeof(SharedEdgeCounters),
+                    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return nullptr;
+  return static_cast<SharedEdgeCounters*>(addr);
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_SHAREDEDGECOUNTERS_H__
@@ -17,6 +17,8 @@
 #ifndef __VTS_SYSFUZZER_COMMON_UTILS_STRINGUTIL_H__
 #define __VTS_SYSFUZZER_COMMON_UTILS_STRINGUTIL_H__
 
+#include <stdint.h>
+
 #include <string>
 
 using namespace std;
@@ -32,6 +34,16 @@ bool endsWith(const string& s, const string& suffix);
 extern void ReplaceSubString(
     string& original, const string& from, const string& to);
 
+// returns the 64-bit FNV-1a hash of data, continuing from hash.
+uint64_t HashBytes(const string& data, uint64_t hash = 0xcbf29ce484222325ULL);
+
+// returns the 32-bit FNV-1a hash of a null-terminated string.
+// constexpr so that generated drivers can switch on the hash of an api name.
+constexpr uint32_t HashString(const char* s, uint32_t hash = 2166136261u) {
+  return *s == '\0'
+             ? hash
+             : HashString(s + 1, (hash ^ static_cast<uint8_t>(*s)) * 16777619u);
+}
 
 }  // namespace vts
 }  // namespace android
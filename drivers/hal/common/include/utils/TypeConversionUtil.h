@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_TYPECONVERSIONUTIL_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_TYPECONVERSIONUTIL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+
+using namespace std;
+
+// Header-only conversions between C++ values and VariableSpecificationMessage,
+// shared by the generated drivers and the resource manager, which does not
+// link libvts_common.
+
+namespace android {
+namespace vts {
+
+// Maps a C++ scalar type to its scalar_type name and its field in
+// ScalarDataValueMessage, e.g.
+//   VtsScalarTraits<float>::Name() is "float_t", and
+//   VtsScalarTraits<float>::Get(value) returns value.float_t().
+// kIsScalar is false for the other types, which have no other members.
+template <typename T>
+struct VtsScalarTraits {
+  static constexpr bool kIsScalar = false;
+};
+
+#define VTS_DEFINE_SCALAR_TRAITS(cpp_type, scalar_type)                      \
+  template <>                                                                \
+  struct VtsScalarTraits<cpp_type> {                                         \
+    static constexpr bool kIsScalar = true;                                  \
+    static const char* Name() { return #scalar_type; }                       \
+    static cpp_type Get(const ScalarDataValueMessage& value) {               \
+      return static_cast<cpp_type>(value.scalar_type());                     \
+    }                                                                        \
+    static void Set(ScalarDataValueMessage* value, cpp_type scalar_value) {  \
+      value->set_##scalar_type(scalar_value);                                \
+    }                                                                        \
+  };
+
+VTS_DEFINE_SCALAR_TRAITS(int8_t, int8_t)
+VTS_DEFINE_SCALAR_TRAITS(uint8_t, uint8_t)
+VTS_DEFINE_SCALAR_TRAITS(int16_t, int16_t)
+VTS_DEFINE_SCALAR_TRAITS(uint16_t, uint16_t)
+VTS_DEFINE_SCALAR_TRAITS(int32_t, int32_t)
+VTS_DEFINE_SCALAR_TRAITS(uint32_t, uint32_t)
+VTS_DEFINE_SCALAR_TRAITS(int64_t, int64_t)
+VTS_DEFINE_SCALAR_TRAITS(uint64_t, uint64_t)
+VTS_DEFINE_SCALAR_TRAITS(float, float_t)
+VTS_DEFINE_SCALAR_TRAITS(double, double_t)
+VTS_DEFINE_SCALAR_TRAITS(bool, bool_t)
+
+#undef VTS_DEFINE_SCALAR_TRAITS
+
+// Fills result_msg with a scalar value, e.g.
+//   SetScalarResult<int32_t>(result_msg, 1) sets the type, the scalar_type
+//   "int32_t" and scalar_value.int32_t.
+template <typename T>
+void SetScalarResult(VariableSpecificationMessage* result_msg, T value) {
+  result_msg->set_type(TYPE_SCALAR);
+  result_msg->set_scalar_type(VtsScalarTraits<T>::Name());
+  VtsScalarTraits<T>::Set(result_msg->mutable_scalar_value(), value);
+}
+
+// Returns the elements of type T in a memory region whose address was
+// filled in by the driver manager, and stores their number in count.
+//
+// @param region the memory region.
+// @param count  stores the number of elements.
+//
+// @return the first element, nullptr if the address is not aligned for T or
+//         the length is not a multiple of sizeof(T).
+template <typename T>
+T* GetMemoryRegionElements(const MemoryRegionMessage& region, size_t* count) {
+  if (region.address() % alignof(T) != 0 || region.length() % sizeof(T) != 0) {
+    return nullptr;
+  }
+  *count = region.length() / sizeof(T);
+  return reinterpret_cast<T*>(region.address());
+}
+
+// The conversion functions of a user-defined type T, which vtsc generates
+// as MessageTo<type> and SetResult<type> in the driver of T.
+template <typename T>
+struct VtsTypeConversion {
+  // converts a message to T.
+  void (*message_to)(const VariableSpecificationMessage& var_msg, T* arg,
+                     const string& callback_socket_name);
+  // converts T to a message.
+  void (*set_result)(VariableSpecificationMessage* result_msg,
+                     const T& result_value);
+};
+
+// An entry in the table of the user-defined types of a component, see
+// GetTypeConversionsSymbol. The functions are type-erased, use
+// MakeTypeConversionEntry and GetTypeConversion to convert them.
+struct VtsTypeConversionEntry {
+  // fully qualified C++ name, e.g. ::android::hardware::nfc::V1_0::NfcEvent.
+  const char* type_name;
+  // sizeof the type, checked before casting the functions back.
+  size_t type_size;
+  void (*message_to)();
+  void (*set_result)();
+  // whether the values of the type can be copied as raw bytes, i.e. vtsc
+  // found every bit pattern of it valid, and it is trivially copyable.
+  bool is_pod;
+};
+
+// the table function exported by a driver library for each component.
+typedef const VtsTypeConversionEntry* (*VtsTypeConversionsFn)(size_t* size);
+
+template <typename T>
+VtsTypeConversionEntry MakeTypeConversionEntry(
+    const char* type_name,
+    decltype(VtsTypeConversion<T>::message_to) message_to,
+    decltype(VtsTypeConversion<T>::set_result) set_result, bool is_pod) {
+  return {type_name, sizeof(T), reinterpret_cast<void (*)()>(message_to),
+          reinterpret_cast<void (*)()>(set_result),
+          is_pod && is_trivially_copyable<T>::value};
+}
+
+// Recovers the typed functions from a table entry.
+//
+// @param entry      the table entry of T.
+// @param conversion to be filled with the functions.
+//
+// @return true if successful, false if entry is not of a type of T's size.
+template <typename T>
+bool GetTypeConversion(const VtsTypeConversionEntry& entry,
+                       VtsTypeConversion<T>* conversion) {
+  if (entry.type_size != sizeof(T)) return false;
+  conversion->message_to =
+      reinterpret_cast<decltype(conversion->message_to)>(entry.message_to);
+  conversion->set_result =
+      reinterpret_cast<decltype(conversion->set_result)>(entry.set_result);
+  return true;
+}
+
+// Returns the extern "C" name of the table function of a component, e.g.
+// VtsTypeConversions__android__hardware__nfc__V1_0__types for
+// ::android::hardware::nfc::V1_0::types.
+inline string GetTypeConversionsSymbol(const string& component_cpp_name) {
+  string symbol = "VtsTypeConversions";
+  for (char c : component_cpp_name) {
+    symbol += (c == ':' ? '_' : c);
+  }
+  return symbol;
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_TYPECONVERSIONUTIL_H__
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_UTILS_VERIFICATIONUTIL_H__
+#define __VTS_SYSFUZZER_COMMON_UTILS_VERIFICATIONUTIL_H__
+
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+#include <type_traits>
+
+#include <android-base/logging.h>
+#include <hidl/HidlSupport.h>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "utils/TypeConversionUtil.h"
+
+using namespace std;
+
+// Header-only comparisons of the C++ values returned by a HIDL HAL with the
+// expected values in a VariableSpecificationMessage, so that the generated
+// drivers can verify the results of a call without converting them to
+// messages first. A value matches if the generated VerifyResults would
+// accept the message that SetResult makes of it.
+
+namespace android {
+namespace vts {
+
+// Verifies a value of type T. vtsc specializes it for the structs and the
+// unions of each HAL, in the driver of the type. The other types that the
+// drivers can't verify, e.g. interfaces and handles, always match.
+template <typename T, typename Enable = void>
+struct VtsValueVerifier {
+  static bool Verify(const VariableSpecificationMessage& /*expected_result*/,
+                     const T& /*actual_value*/) {
+    LOG(ERROR) << "Verifying this type is not supported yet.";
+    return true;
+  }
+};
+
+// Returns whether actual_value matches expected_result, e.g.
+//   VerifyValue(expected_result.return_type_hidl(0), result0).
+template <typename T>
+bool VerifyValue(const VariableSpecificationMessage& expected_result,
+                 const T& actual_value) {
+  return VtsValueVerifier<T>::Verify(expected_result, actual_value);
+}
+
+// Verifies the size elements of a vector or a one-dimensional array, given as
+// anything indexable. The expected scalar elements may be in vector_raw_value.
+template <typename T, typename A>
+bool VerifyElements(const VariableSpecificationMessage& expected_result,
+                    size_t size, const A& actual_elements) {
+  if constexpr (VtsScalarTraits<T>::kIsScalar) {
+    if (expected_result.has_vector_raw_value()) {
+      const string& data = expected_result.vector_raw_value();
+      if (data.size() != size * sizeof(T)) {
+        LOG(ERROR) << "Verification failed for raw vector size. expected: "
+                   << data.size() / sizeof(T) << " actual: " << size;
+        return false;
+      }
+      for (size_t i = 0; i < size; i++) {
+        T value;
+        memcpy(&value, data.data() + i * sizeof(T), sizeof(T));
+        if (value != actual_elements[i]) {
+          LOG(ERROR) << "Verification failed for raw vector value.";
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+  if (static_cast<size_t>(expected_result.vector_value_size()) != size) {
+    LOG(ERROR) << "Verification failed for vector size. expected: "
+               << expected_result.vector_value_size() << " actual: " << size;
+    return false;
+  }
+  for (size_t i = 0; i < size; i++) {
+    if (!VerifyValue(expected_result.vector_value(i), actual_elements[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Verifies a (possibly multi-dimensional) hidl_array of T, or the accessor
+// of one of its rows, given as actual_elements. Each dimension is nested in
+// vector_value.
+template <typename T, size_t SIZE1, size_t... SIZES, typename A>
+bool VerifyArrayElements(const VariableSpecificationMessage& expected_result,
+                         const A& actual_elements) {
+  if constexpr (sizeof...(SIZES) == 0) {
+    return VerifyElements<T>(expected_result, SIZE1, actual_elements);
+  } else {
+    if (static_cast<size_t>(expected_result.vector_value_size()) != SIZE1) {
+      LOG(ERROR) << "Verification failed for vector size. expected: "
+                 << expected_result.vector_value_size()
+                 << " actual: " << SIZE1;
+      return false;
+    }
+    for (size_t i = 0; i < SIZE1; i++) {
+      if (!VerifyArrayElements<T, SIZES...>(expected_result.vector_value(i),
+                                            actual_elements[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+template <typename T>
+struct VtsValueVerifier<
+    T, typename enable_if<VtsScalarTraits<T>::kIsScalar>::type> {
+  static bool Verify(const VariableSpecificationMessage& expected_result,
+                     const T& actual_value) {
+    return VtsScalarTraits<T>::Get(expected_result.scalar_value()) ==
+           actual_value;
+  }
+};
+
+// enums and masks are compared as their scalar type.
+template <typename T>
+struct VtsValueVerifier<T, typename enable_if<is_enum<T>::value>::type> {
+  static bool Verify(const VariableSpecificationMessage& expected_result,
+                     const T& actual_value) {
+    typedef typename underlying_type<T>::type U;
+    return VtsScalarTraits<U>::Get(expected_result.scalar_value()) ==
+           static_cast<U>(actual_value);
+  }
+};
+
+template <>
+struct VtsValueVerifier<hardware::hidl_string> {
+  static bool Verify(const VariableSpecificationMessage& expected_result,
+                     const hardware::hidl_string& actual_value) {
+    return strcmp(actual_value.c_str(),
+                  expected_result.string_value().message().c_str()) == 0;
+  }
+};
+
+template <typename T>
+struct VtsValueVerifier<hardware::hidl_vec<T>> {
+  static bool Verify(const VariableSpecificationMessage& expected_result,
+                     const hardware::hidl_vec<T>& actual_value) {
+    return VerifyElements<T>(expected_result, actual_value.size(),
+                             actual_value);
+  }
+};
+
+template <typename T, size_t SIZE1, size_t... SIZES>
+struct VtsValueVerifier<hardware::hidl_array<T, SIZE1, SIZES...>> {
+  static bool Verify(const VariableSpecificationMessage& expected_result,
+                     const hardware::hidl_array<T, SIZE1, SIZES...>&
+                         actual_value) {
+    return VerifyArrayElements<T, SIZE1, SIZES...>(expected_result,
+                                                   actual_value);
+  }
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_UTILS_VERIFICATIONUTIL_H__
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "replayer/VtsHalTraceReplayer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <android-base/logging.h>
+
+#include "VtsProfilingUtil.h"
+#include "VtsTraceReader.h"
+#include "driver_manager/VtsHalDriverManager.h"
+#include "resource_manager/VtsResourceManager.h"
+#include "utils/InterfaceSpecUtil.h"
+
+namespace android {
+namespace vts {
+
+// the result of VtsHalDriverManager::CallFunction for a failed call.
+static constexpr const char* kErrorString = "error";
+
+static int64_t NowNs() {
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool VtsHalTraceReplayer::LoadTrace(const string& trace_file) {
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file, false);
+  if (!reader) {
+    LOG(ERROR) << "Can't read trace file " << trace_file
+               << ", which must be made of delimited records that are not "
+               << "compressed.";
+    return false;
+  }
+  calls_.clear();
+  interfaces_.clear();
+  // the index of each interface in interfaces_, by full name.
+  map<string, size_t> interface_indexes;
+  VtsProfilingRecord record;
+  for (size_t i = 0; i < reader->Entries().size(); i++) {
+    if (!reader->ReadRecord(i, &record)) {
+      LOG(ERROR) << "Can't decode record " << i << " of " << trace_file;
+      return false;
+    }
+    if (record.event() != InstrumentationEventType::SERVER_API_ENTRY &&
+        record.event() != InstrumentationEventType::PASSTHROUGH_ENTRY) {
+      continue;
+    }
+    string interface_name =
+        GetInterfaceFQName(record.package(), record.version_major(),
+                           record.version_minor(), record.interface());
+    auto res = interface_indexes.emplace(interface_name, interfaces_.size());
+    if (res.second) {
+      interfaces_.push_back({record.package(), record.version_major(),
+                             record.version_minor(), record.interface()});
+    }
+
+    Call call;
+    // made relative to the first call below.
+    call.offset_ns = record.timestamp();
+    call.interface_index = res.first->second;
+    FunctionCallMessage& call_msg = call.call_msg;
+    call_msg.set_component_class(HAL_HIDL);
+    call_msg.set_package_name(record.package());
+    call_msg.set_component_type_version_major(record.version_major());
+    call_msg.set_component_type_version_minor(record.version_minor());
+    call_msg.set_component_name(record.interface());
+    *call_msg.mutable_api() = record.func_msg();
+    call_msg.mutable_api()->clear_return_type_hidl();
+    // the drivers take one value per element.
+    if (!expandRawVectorValues(call_msg.mutable_api())) {
+      LOG(WARNING) << "Can't expand the vectors of "
+                   << call_msg.api().name();
+    }
+    calls_.push_back(move(call));
+  }
+  if (calls_.empty()) {
+    LOG(ERROR) << "No call to replay in " << trace_file;
+    return false;
+  }
+  // the traces written by several threads are not ordered by time, and a
+  // timed replay makes the calls one after the other at their offsets.
+  if (options_.timed) {
+    stable_sort(calls_.begin(), calls_.end(),
+                [](const Call& call, const Call& other) {
+                  return call.offset_ns < other.offset_ns;
+                });
+  }
+  int64_t first_timestamp = calls_.front().offset_ns;
+  for (auto& call : calls_) {
+    call.offset_ns = max<int64_t>(call.offset_ns - first_timestamp, 0);
+  }
+  return true;
+}
+
+bool VtsHalTraceReplayer::Replay(TraceReplayStats* stats) {
+  vector<TraceReplayStats> session_stats(options_.sessions);
+  // whether each session could get its drivers.
+  vector<char> session_results(options_.sessions, false);
+  vector<thread> sessions;
+  int64_t start_ns = NowNs();
+  for (int i = 0; i < options_.sessions; i++) {
+    sessions.emplace_back([this, i, &session_stats, &session_results]() {
+      session_results[i] = RunSession(&session_stats[i]);
+    });
+  }
+  for (auto& session : sessions) {
+    session.join();
+  }
+  stats->elapsed_ns = NowNs() - start_ns;
+
+  for (const auto& session : session_stats) {
+    stats->calls += session.calls;
+    stats->failed_calls += session.failed_calls;
+    stats->latencies_ns.insert(stats->latencies_ns.end(),
+                               session.latencies_ns.begin(),
+                               session.latencies_ns.end());
+    stats->lags_ns.insert(stats->lags_ns.end(), session.lags_ns.begin(),
+                          session.lags_ns.end());
+  }
+  return find(session_results.begin(), session_results.end(), false) ==
+         session_results.end();
+}
+
+bool VtsHalTraceReplayer::RunSession(TraceReplayStats* stats) {
+  VtsResourceManager resource_manager;
+  VtsHalDriverManager driver_manager(options_.spec_dir, 0, "",
+                                     &resource_manager);
+  // the driver of each interface, looked up once.
+  vector<DriverId> driver_ids;
+  for (const auto& interface : interfaces_) {
+    DriverId driver_id = driver_manager.GetDriverIdForHidlHalInterface(
+        interface.package, interface.version_major, interface.version_minor,
+        interface.name, options_.service_name);
+    if (driver_id < 0) {
+      LOG(ERROR) << "Can't get the driver of "
+                 << GetInterfaceFQName(interface.package,
+                                       interface.version_major,
+                                       interface.version_minor,
+                                       interface.name);
+      return false;
+    }
+    driver_ids.push_back(driver_id);
+  }
+  driver_manager.SetCallWorkerCount(options_.call_workers);
+
+  stats->latencies_ns.reserve(calls_.size() * options_.repeat);
+  if (options_.timed) {
+    stats->lags_ns.reserve(calls_.size() * options_.repeat);
+  }
+  // protects stats and pending_calls, as the calls may end on the call
+  // workers of driver_manager.
+  mutex stats_lock;
+  condition_variable calls_done;
+  size_t pending_calls = 0;
+  auto record_call = [&](const string& result, int64_t latency_ns) {
+    lock_guard<mutex> lock(stats_lock);
+    stats->calls++;
+    if (result == kErrorString) {
+      stats->failed_calls++;
+    } else {
+      stats->latencies_ns.push_back(latency_ns);
+    }
+    if (options_.call_workers > 0 && --pending_calls == 0) {
+      calls_done.notify_all();
+    }
+  };
+  // the call messages are modified by the calls, e.g. by the preprocessing
+  // of their arguments, so each call is made on a copy.
+  FunctionCallMessage call_msg;
+  for (int round = 0; round < options_.repeat; round++) {
+    int64_t round_start_ns = NowNs();
+    for (const auto& call : calls_) {
+      if (options_.timed) {
+        int64_t due_ns = round_start_ns + call.offset_ns;
+        int64_t now_ns = NowNs();
+        if (due_ns > now_ns) {
+          this_thread::sleep_for(chrono::nanoseconds(due_ns - now_ns));
+        }
+        stats->lags_ns.push_back(max<int64_t>(NowNs() - due_ns, 0));
+      }
+      call_msg = call.call_msg;
+      call_msg.set_hal_driver_id(driver_ids[call.interface_index]);
+      int64_t call_start_ns = NowNs();
+      if (options_.call_workers > 0) {
+        {
+          lock_guard<mutex> lock(stats_lock);
+          pending_calls++;
+        }
+        driver_manager.CallFunctionAsync(
+            call_msg, true, [&, call_start_ns](const string& result) {
+              record_call(result, NowNs() - call_start_ns);
+            });
+        continue;
+      }
+      string result = driver_manager.CallFunction(&call_msg, true);
+      record_call(result, NowNs() - call_start_ns);
+    }
+    // the next round starts once all the calls of this one are done.
+    unique_lock<mutex> lock(stats_lock);
+    calls_done.wait(lock, [&pending_calls] { return pending_calls == 0; });
+  }
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "replayer/VtsHalTraceReplayer.h"
+
+using namespace std;
+using namespace android::vts;
+
+static constexpr const char* kDefaultSpecDir = "/data/local/tmp/spec";
+
+static void ShowUsage() {
+  printf(
+      "Usage:   vts_hal_trace_replayer [options] <trace file>\n"
+      "Replays the HIDL HAL calls recorded in a trace of delimited records "
+      "and prints the calls/s and the latency of the calls.\n"
+      "--spec_dir:     The dir of the interface specification files "
+      "(default: /data/local/tmp/spec).\n"
+      "--service_name: The name of the HAL services (default: default).\n"
+      "--timed:        Make each call when it was recorded, relative to the "
+      "first call, instead of as fast as possible.\n"
+      "--sessions:     The number of sessions replaying the trace "
+      "concurrently (default: 1).\n"
+      "--repeat:       The number of times each session replays the trace "
+      "(default: 1).\n"
+      "--call_workers: The number of threads of each session calling the "
+      "drivers, so that the calls to different HALs run concurrently, in "
+      "order for each HAL (default: 0, the calls are made one at a time).\n"
+      "--help:         Show help\n");
+  exit(-1);
+}
+
+// Prints the distribution of values, in us, as count, min, mean, p50, p90,
+// p99 and max.
+static void PrintDistribution(const char* name, vector<int64_t>* values) {
+  if (values->empty()) {
+    return;
+  }
+  sort(values->begin(), values->end());
+  auto percentile = [&values](double percent) {
+    size_t index = min(values->size() - 1,
+                       static_cast<size_t>(values->size() * percent / 100));
+    return (*values)[index] / 1000.0;
+  };
+  double sum = 0;
+  for (int64_t value : *values) {
+    sum += value;
+  }
+  printf("%s (us): count %zu, min %.1f, mean %.1f, p50 %.1f, p90 %.1f, "
+         "p99 %.1f, max %.1f\n",
+         name, values->size(), values->front() / 1000.0,
+         sum / values->size() / 1000.0, percentile(50), percentile(90),
+         percentile(99), values->back() / 1000.0);
+}
+
+int main(int argc, char** argv) {
+  TraceReplayOptions options;
+  options.spec_dir = kDefaultSpecDir;
+
+  const char* const short_opts = "hd:n:tS:r:w:";
+  const option long_opts[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"spec_dir", required_argument, nullptr, 'd'},
+      {"service_name", required_argument, nullptr, 'n'},
+      {"timed", no_argument, nullptr, 't'},
+      {"sessions", required_argument, nullptr, 'S'},
+      {"repeat", required_argument, nullptr, 'r'},
+      {"call_workers", required_argument, nullptr, 'w'},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  while (true) {
+    int opt = getopt_long(argc, argv, short_opts, long_opts, nullptr);
+    if (opt == -1) {
+      break;
+    }
+    switch (opt) {
+      case 'h':
+      case '?':
+        ShowUsage();
+        return 0;
+      case 'd':
+        options.spec_dir = optarg;
+        break;
+      case 'n':
+        options.service_name = optarg;
+        break;
+      case 't':
+        options.timed = true;
+        break;
+      case 'S':
+        options.sessions = max(1, atoi(optarg));
+        break;
+      case 'r':
+        options.repeat = max(1, atoi(optarg));
+        break;
+      case 'w':
+        options.call_workers = max(0, atoi(optarg));
+        break;
+      default:
+        printf("getopt_long returned unexpected value: %d\n", opt);
+        return -1;
+    }
+  }
+  if (optind != argc - 1) {
+    ShowUsage();
+  }
+
+  VtsHalTraceReplayer replayer(options);
+  if (!replayer.LoadTrace(argv[optind])) {
+    return -1;
+  }
+  TraceReplayStats stats;
+  bool success = replayer.Replay(&stats);
+  double elapsed_s = stats.elapsed_ns / 1e9;
+  printf("calls: %llu, failed: %llu, elapsed: %.3f s, calls/s: %.1f\n",
+         static_cast<unsigned long long>(stats.calls),
+         static_cast<unsigned long long>(stats.failed_calls), elapsed_s,
+         elapsed_s > 0 ? stats.calls / elapsed_s : 0);
+  PrintDistribution("latency", &stats.latencies_ns);
+  PrintDistribution("lag", &stats.lags_ns);
+  return success && stats.failed_calls == 0 ? 0 : 1;
+}
@@ -16,9 +16,16 @@
 
 #include "utils/InterfaceSpecUtil.h"
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include <android-base/logging.h>
 #include <assert.h>
@@ -53,6 +60,97 @@ bool ParseInterfaceSpec(const char* file_path,
   return true;
 }
 
+bool ParseInterfaceSpecCached(const char* file_path, const string& cache_dir,
+                              ComponentSpecificationMessage* message) {
+  if (cache_dir.empty()) {
+    return ParseInterfaceSpec(file_path, message);
+  }
+  ifstream in_file(file_path);
+  stringstream str_stream;
+  if (!in_file.is_open()) {
+    LOG(ERROR) << "Unable to open file. " << file_path;
+    return false;
+  }
+  str_stream << in_file.rdbuf();
+  in_file.close();
+  const string data = str_stream.str();
+
+  // the schema is part of the key so that a changed message definition
+  // doesn't read the entries serialized with the previous one.
+  static const uint64_t schema_hash = HashBytes(
+      ComponentSpecificationMessage::descriptor()->file()->DebugString());
+  char cache_name[32];
+  snprintf(cache_name, sizeof(cache_name), "%016" PRIx64 ".pb",
+           HashBytes(data, schema_hash));
+  const string cache_path = cache_dir + "/" + cache_name;
+
+  message->Clear();
+  ifstream cache_file(cache_path, ios::binary);
+  if (cache_file.is_open() && message->ParseFromIstream(&cache_file)) {
+    return true;
+  }
+  cache_file.close();
+
+  message->Clear();
+  if (!google::protobuf::TextFormat::MergeFromString(data, message)) {
+    LOG(ERROR) << "Can't parse a given proto file " << file_path;
+    return false;
+  }
+  // writes to a file of this process, then renames it, so that a concurrent
+  // process reads either no entry or a complete one.
+  const string temp_path = cache_path + "." + to_string(getpid());
+  ofstream out_file(temp_path, ios::binary | ios::trunc);
+  if (!out_file.is_open() || !message->SerializeToOstream(&out_file)) {
+    LOG(WARNING) << "Can't write the spec cache " << temp_path;
+    unlink(temp_path.c_str());
+    return true;
+  }
+  out_file.close();
+  if (rename(temp_path.c_str(), cache_path.c_str()) != 0) {
+    LOG(WARNING) << "Can't write the spec cache " << cache_path;
+    unlink(temp_path.c_str());
+  }
+  return true;
+}
+
+shared_ptr<const ComponentSpecificationMessage> GetInterfaceSpec(
+    const string& file_path, const string& cache_dir) {
+  // a parsed file, with the stat it was parsed at.
+  struct CachedSpec {
+    struct timespec mtime;
+    off_t size;
+    shared_ptr<const ComponentSpecificationMessage> spec;
+  };
+  static mutex cache_lock;
+  static unordered_map<string, CachedSpec> cache;
+
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0) {
+    LOG(ERROR) << "Unable to stat file. " << file_path;
+    return nullptr;
+  }
+  {
+    lock_guard<mutex> lock(cache_lock);
+    auto res = cache.find(file_path);
+    if (res != cache.end() &&
+        res->second.mtime.tv_sec == file_stat.st_mtim.tv_sec &&
+        res->second.mtime.tv_nsec == file_stat.st_mtim.tv_nsec &&
+        res->second.size == file_stat.st_size) {
+      return res->second.spec;
+    }
+  }
+  // parses without the lock, so that the threads loading different files
+  // don't wait for each other. a file parsed by two threads at once is
+  // cached by the last one.
+  auto spec = make_shared<ComponentSpecificationMessage>();
+  if (!ParseInterfaceSpecCached(file_path.c_str(), cache_dir, spec.get())) {
+    return nullptr;
+  }
+  lock_guard<mutex> lock(cache_lock);
+  cache[file_path] = {file_stat.st_mtim, file_stat.st_size, spec};
+  return spec;
+}
+
 string GetFunctionNamePrefix(const ComponentSpecificationMessage& message) {
   stringstream prefix_ss;
   if (message.component_class() != HAL_HIDL) {
@@ -38,6 +38,12 @@ void ReplaceSubString(string& original, const string& from, const string& to) {
   }
 }
 
+uint64_t HashBytes(const string& data, uint64_t hash) {
+  for (unsigned char c : data) {
+    hash = (hash ^ c) * 0x100000001b3ULL;
+  }
+  return hash;
+}
 
 }  // namespace vts
 }  // namespace android
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GcdaDelta.h"
+
+#include <string.h>
+
+namespace android {
+namespace vts {
+
+bool CanDiffGcda(const string& snapshot, size_t size) {
+  return snapshot.size() == size && size % sizeof(unsigned) == 0;
+}
+
+void DiffGcda(const string& snapshot, const void* data,
+              vector<unsigned>* indexes, vector<unsigned>* values) {
+  const unsigned* words = static_cast<const unsigned*>(data);
+  size_t num_words = snapshot.size() / sizeof(unsigned);
+  for (size_t i = 0; i < num_words; i++) {
+    unsigned word;
+    memcpy(&word, snapshot.data() + i * sizeof(unsigned), sizeof(word));
+    if (word != words[i]) {
+      indexes->push_back(i);
+      values->push_back(words[i]);
+    }
+  }
+}
+
+bool ApplyGcdaDelta(const unsigned* indexes, const unsigned* values,
+                    size_t count, string* snapshot) {
+  size_t num_words = snapshot->size() / sizeof(unsigned);
+  for (size_t i = 0; i < count; i++) {
+    if (indexes[i] >= num_words) return false;
+    memcpy(&(*snapshot)[indexes[i] * sizeof(unsigned)], &values[i],
+           sizeof(unsigned));
+  }
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_LIBMEASUREMENT_GCDA_DELTA_H__
+#define __VTS_SYSFUZZER_LIBMEASUREMENT_GCDA_DELTA_H__
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// A GCDA file differs from a previous snapshot of the same file only in its
+// counters, so a delta holds the indexes and new values of the 32-bit words
+// that changed.
+
+// Returns whether data, of the given size, can be encoded as a delta of
+// snapshot, i.e. both have the same size, which is a whole number of words.
+bool CanDiffGcda(const string& snapshot, size_t size);
+
+// Appends to indexes and values the words of data, of the size of snapshot,
+// that differ from snapshot. data must be 4-byte aligned.
+void DiffGcda(const string& snapshot, const void* data,
+              vector<unsigned>* indexes, vector<unsigned>* values);
+
+// Sets the words at the given indexes of snapshot to values, which gives the
+// GCDA file diffed by DiffGcda. Returns false if an index is out of range.
+bool ApplyGcdaDelta(const unsigned* indexes, const unsigned* values,
+                    size_t count, string* snapshot);
+
+}  // namespace vts
+}  // namespace android
+
+#endif
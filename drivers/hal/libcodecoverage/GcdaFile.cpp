@@ -16,12 +16,16 @@
 
 #include "GcdaFile.h"
 
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace android {
 namespace vts {
@@ -33,6 +37,33 @@ bool GcdaFile::Open() {
   memset(&gcov_var_, 0, sizeof(gcov_var_));
   gcov_var_.overread = -1u;
 
+  if (mapped_) {
+    if (mapping_open_) return false;
+    if (external_data_) {
+      mapping_ = static_cast<const unsigned*>(data_);
+      mapping_size_ = data_size_;
+    } else {
+      int fd = open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) return false;
+      struct stat st;
+      void* mapping = nullptr;
+      if (fstat(fd, &st) != 0) {
+        mapping = MAP_FAILED;
+      } else if (st.st_size > 0) {
+        mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+      close(fd);
+      if (mapping == MAP_FAILED) return false;
+      mapping_ = static_cast<const unsigned*>(mapping);
+      mapping_size_ = mapping ? st.st_size : 0;
+    }
+    mapping_open_ = true;
+    // The whole file is the block, as in a buffer that never needs refilling.
+    gcov_var_.length = mapping_size_ >> 2;
+    gcov_var_.mode = 0;
+    return true;
+  }
+
   gcov_var_.file = fopen(filename_.c_str(), "rb");
   if (!gcov_var_.file) return false;
   gcov_var_.mode = 0;
@@ -41,6 +72,15 @@ bool GcdaFile::Open() {
 }
 
 int GcdaFile::Close() {
+  if (mapping_open_) {
+    if (mapping_ && !external_data_) {
+      munmap(const_cast<unsigned*>(mapping_), mapping_size_);
+    }
+    mapping_open_ = false;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    gcov_var_.length = 0;
+  }
   if (gcov_var_.file) {
     fclose(gcov_var_.file);
     gcov_var_.file = 0;
@@ -54,6 +94,12 @@ int GcdaFile::Close() {
 }
 
 void GcdaFile::Sync(unsigned base, unsigned length) {
+  if (mapping_open_) {
+    // Past the end of the file, the next reads fail.
+    base += length;
+    gcov_var_.offset = base <= gcov_var_.length ? base : gcov_var_.length;
+    return;
+  }
   if (!gcov_var_.file) return;
 
   base += length;
@@ -102,6 +148,15 @@ const unsigned* GcdaFile::ReadWords(unsigned words) {
   const unsigned* result;
   unsigned excess = gcov_var_.length - gcov_var_.offset;
 
+  if (mapping_open_) {
+    if (excess < words) {
+      gcov_var_.overread += words - excess;
+      return 0;
+    }
+    result = &mapping_[gcov_var_.offset];
+    gcov_var_.offset += words;
+    return result;
+  }
   if (!gcov_var_.file) return 0;
 
   if (excess < words) {
@@ -29,8 +29,33 @@ namespace vts {
 // Basic I/O methods for a GCOV file.
 class GcdaFile {
  public:
-  explicit GcdaFile(const string& filename) : filename_(filename) {}
-  virtual ~GcdaFile() {};
+  // If mapped is set, the file is mapped in memory when opened and the read
+  // methods return pointers into the mapping, instead of reading the file
+  // into a buffer. Mapped files can only be read and do not support WriteBlock.
+  explicit GcdaFile(const string& filename, bool mapped = false)
+      : gcov_var_(),
+        filename_(filename),
+        mapped_(mapped),
+        external_data_(false),
+        data_(nullptr),
+        data_size_(0),
+        mapping_open_(false),
+        mapping_(nullptr),
+        mapping_size_(0) {}
+
+  // Reads the contents of the file from data, of the given size, as if it
+  // were mapped. data must be 4-byte aligned and outlive the GcdaFile.
+  GcdaFile(const string& filename, const void* data, size_t size)
+      : gcov_var_(),
+        filename_(filename),
+        mapped_(true),
+        external_data_(true),
+        data_(data),
+        data_size_(size),
+        mapping_open_(false),
+        mapping_(nullptr),
+        mapping_size_(0) {}
+  virtual ~GcdaFile() { Close(); };
 
   // Opens a file.
   bool Open();
@@ -72,7 +97,7 @@ class GcdaFile {
 
   // Returns non-zero error code if there's an error.
   inline int IsError() const {
-    return gcov_var_.file ? gcov_var_.error : 1;
+    return gcov_var_.file || mapping_open_ ? gcov_var_.error : 1;
   }
 
  protected:
@@ -88,6 +113,18 @@ class GcdaFile {
   // The GCOV var data structure for an opened file.
   struct gcov_var_t gcov_var_;
   const string& filename_;
+  // Whether the file is mapped when opened.
+  const bool mapped_;
+  // Whether the contents of the file are given by the caller in data_, in
+  // which case the file is not mapped.
+  const bool external_data_;
+  const void* data_;
+  size_t data_size_;
+  // Whether the file is open in mapped mode, and its mapping (nullptr if the
+  // file is empty).
+  bool mapping_open_;
+  const unsigned* mapping_;
+  size_t mapping_size_;
 };
 
 }  // namespace vts
@@ -27,20 +27,20 @@ namespace android {
 namespace vts {
 
 bool GcdaRawCoverageParser::ParseMagic() {
-  unsigned magic = gcda_file_->ReadUnsigned();
+  unsigned magic = gcda_file_.ReadUnsigned();
   unsigned version;
   const char* type = NULL;
   int endianness = 0;
   char m[4], v[4];
 
-  if ((endianness = gcda_file_->Magic(magic, GCOV_DATA_MAGIC))) {
+  if ((endianness = gcda_file_.Magic(magic, GCOV_DATA_MAGIC))) {
     type = "data";
   } else {
     cout << __func__ << ": not a GCOV file, " << filename_ << endl;
-    gcda_file_->Close();
+    gcda_file_.Close();
     return false;
   }
-  version = gcda_file_->ReadUnsigned();
+  version = gcda_file_.ReadUnsigned();
   GCOV_UNSIGNED2STRING(v, version);
   GCOV_UNSIGNED2STRING(m, magic);
   if (version != GCOV_VERSION) {
@@ -62,15 +62,15 @@ void GcdaRawCoverageParser::ParseBody() {
   int error;
   unsigned mask;
 
-  gcda_file_->ReadUnsigned();  // stamp
+  gcda_file_.ReadUnsigned();  // stamp
   while (1) {
-    position = gcda_file_->Position();
+    position = gcda_file_.Position();
 
-    tag = gcda_file_->ReadUnsigned();
+    tag = gcda_file_.ReadUnsigned();
     if (!tag) break;
 
-    length = gcda_file_->ReadUnsigned();
-    base = gcda_file_->Position();
+    length = gcda_file_.ReadUnsigned();
+    base = gcda_file_.Position();
     mask = GCOV_TAG_MASK(tag) >> 1;
     for (tag_depth = 4; mask; mask >>= 8) {
       if ((mask & 0xff) != 0xff) {
@@ -104,11 +104,11 @@ void GcdaRawCoverageParser::ParseBody() {
         TagLines(tag, length);
         break;
     }
-    gcda_file_->Sync(base, length);
+    gcda_file_.Sync(base, length);
 
-    if ((error = gcda_file_->IsError())) {
+    if ((error = gcda_file_.IsError())) {
       cerr << __func__ << ": I/O error at "
-           << gcda_file_->Position() << endl;
+           << gcda_file_.Position() << endl;
       break;
     }
   }
@@ -116,14 +116,14 @@ void GcdaRawCoverageParser::ParseBody() {
 
 vector<unsigned> GcdaRawCoverageParser::Parse() {
   result.clear();
-  if (!gcda_file_->Open()) {
+  if (!gcda_file_.Open()) {
     cerr << __func__ << " Cannot open a file, " << filename_ << endl;
     return result;
   }
 
   if (!ParseMagic()) return result;
   ParseBody();
-  gcda_file_->Close();
+  gcda_file_.Close();
   return result;
 }
 
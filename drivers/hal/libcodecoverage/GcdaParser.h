@@ -31,8 +31,16 @@ namespace vts {
 // Parses a GCDA file and extracts raw coverage info.
 class GcdaRawCoverageParser {
  public:
+  // The file is mapped rather than read, so that parsing it does not copy
+  // it.
   explicit GcdaRawCoverageParser(const char* filename)
-      : filename_(filename), gcda_file_(new GcdaFile(filename_)) {}
+      : filename_(filename), gcda_file_(filename_, true) {}
+
+  // Parses the contents of the file given in data, of the given size, which
+  // must be 4-byte aligned, e.g. a mapping of the file. filename is only used
+  // in error messages.
+  GcdaRawCoverageParser(const char* filename, const void* data, size_t size)
+      : filename_(filename), gcda_file_(filename_, data, size) {}
 
   virtual ~GcdaRawCoverageParser() {}
 
@@ -49,13 +57,13 @@ class GcdaRawCoverageParser {
 
   // Processes tag for functions.
   void TagFunction(unsigned /*tag*/, unsigned length) {
-    /* unsigned long pos = */ gcda_file_->Position();
+    /* unsigned long pos = */ gcda_file_.Position();
 
     if (length) {
-      gcda_file_->ReadUnsigned();  // ident %u
-      unsigned lineno_checksum = gcda_file_->ReadUnsigned();
+      gcda_file_.ReadUnsigned();  // ident %u
+      unsigned lineno_checksum = gcda_file_.ReadUnsigned();
       result.push_back(lineno_checksum);
-      gcda_file_->ReadUnsigned();  // cfg_checksum 0x%08x
+      gcda_file_.ReadUnsigned();  // cfg_checksum 0x%08x
     }
   }
 
@@ -81,7 +89,7 @@ class GcdaRawCoverageParser {
   const string filename_;
 
   // global GcovFile data structure.
-  GcdaFile* gcda_file_;
+  GcdaFile gcda_file_;
 
   // vector containing the parsed, raw coverage data.
   vector<unsigned> result;
@@ -78,6 +78,17 @@ camera_module_callbacks_t* GenerateCameraModuleCallbacks() {
   }
 }
 
+camera_module_callbacks_t* GenerateCameraModuleCallbacks(
+    camera_module_callbacks_t* callbacks) {
+  if (RandomBool()) {
+    return NULL;
+  } else {
+    callbacks->camera_device_status_change = vts_camera_device_status_change;
+    callbacks->torch_mode_status_change = vts_torch_mode_status_change;
+    return callbacks;
+  }
+}
+
 camera_notify_callback GenerateCameraNotifyCallback() {
   return vts_camera_notify_callback;
 }
@@ -94,22 +105,26 @@ camera_request_memory GenerateCameraRequestMemory() {
   return vts_camera_request_memory;
 }
 
+// Sets caminfo to random values.
+static void FillCameraInfo(camera_info_t* caminfo) {
+  caminfo->facing = RandomBool() ? CAMERA_FACING_BACK : CAMERA_FACING_FRONT;
+  // support CAMERA_FACING_EXTERNAL if CAMERA_MODULE_API_VERSION_2_4 or above
+  caminfo->orientation =
+      RandomBool() ? (RandomBool() ? 0 : 90) : (RandomBool() ? 180 : 270);
+  caminfo->device_version = CAMERA_MODULE_API_VERSION_2_1;
+  caminfo->static_camera_characteristics = NULL;
+  caminfo->resource_cost = 50;  // between 50 and 100.
+  caminfo->conflicting_devices = NULL;
+  caminfo->conflicting_devices_length = 0;
+}
+
 camera_info_t* GenerateCameraInfo() {
   cout << __func__ << endl;
   if (RandomBool()) {
     return NULL;
   } else {
     camera_info_t* caminfo = (camera_info_t*)malloc(sizeof(camera_info_t));
-    caminfo->facing = RandomBool() ? CAMERA_FACING_BACK : CAMERA_FACING_FRONT;
-    // support CAMERA_FACING_EXTERNAL if CAMERA_MODULE_API_VERSION_2_4 or above
-    caminfo->orientation =
-        RandomBool() ? (RandomBool() ? 0 : 90) : (RandomBool() ? 180 : 270);
-    caminfo->device_version = CAMERA_MODULE_API_VERSION_2_1;
-    caminfo->static_camera_characteristics = NULL;
-    caminfo->resource_cost = 50;  // between 50 and 100.
-    caminfo->conflicting_devices = NULL;
-    caminfo->conflicting_devices_length = 0;
-
+    FillCameraInfo(caminfo);
     return caminfo;
   }
   /**
@@ -181,21 +196,28 @@ camera_info_t* GenerateCameraInfo() {
    */
 }
 
+camera_info_t* GenerateCameraInfo(camera_info_t* caminfo) {
+  if (RandomBool()) {
+    return NULL;
+  } else {
+    FillCameraInfo(caminfo);
+    return caminfo;
+  }
+}
+
 camera_info_t* GenerateCameraInfoUsingMessage(
     const VariableSpecificationMessage& /*msg*/) {
   cout << __func__ << endl;
   // TODO: acutally use msg.
   camera_info_t* caminfo = (camera_info_t*)malloc(sizeof(camera_info_t));
-  caminfo->facing = RandomBool() ? CAMERA_FACING_BACK : CAMERA_FACING_FRONT;
-  // support CAMERA_FACING_EXTERNAL if CAMERA_MODULE_API_VERSION_2_4 or above
-  caminfo->orientation =
-      RandomBool() ? (RandomBool() ? 0 : 90) : (RandomBool() ? 180 : 270);
-  caminfo->device_version = CAMERA_MODULE_API_VERSION_2_1;
-  caminfo->static_camera_characteristics = NULL;
-  caminfo->resource_cost = 50;  // between 50 and 100.
-  caminfo->conflicting_devices = NULL;
-  caminfo->conflicting_devices_length = 0;
+  FillCameraInfo(caminfo);
+  return caminfo;
+}
 
+camera_info_t* GenerateCameraInfoUsingMessage(
+    const VariableSpecificationMessage& /*msg*/, camera_info_t* caminfo) {
+  // TODO: acutally use msg.
+  FillCameraInfo(caminfo);
   return caminfo;
 }
 
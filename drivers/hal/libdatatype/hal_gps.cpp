@@ -43,22 +43,35 @@ static pthread_t vts_gps_create_thread(
 }
 // } Callbacks
 
+// Sets cbs to the callbacks above.
+static void FillGpsCallbacks(GpsCallbacks* cbs) {
+  cbs->size = sizeof(GpsCallbacks);
+  cbs->location_cb = vts_gps_location_callback;
+  cbs->status_cb = vts_gps_status_callback;
+  cbs->sv_status_cb = vts_gps_sv_status_callback;
+  cbs->nmea_cb = vts_gps_nmea_callback;
+  cbs->set_capabilities_cb = vts_gps_set_capabilities;
+  cbs->acquire_wakelock_cb = vts_gps_acquire_wakelock;
+  cbs->release_wakelock_cb = vts_gps_release_wakelock;
+  cbs->create_thread_cb = vts_gps_create_thread;
+  cbs->request_utc_time_cb = vts_gps_request_utc_time;
+}
+
 GpsCallbacks* GenerateGpsCallbacks() {
   if (RandomBool()) {
     return NULL;
   } else {
     GpsCallbacks* cbs = (GpsCallbacks*)malloc(sizeof(GpsCallbacks));
-    cbs->size = sizeof(GpsCallbacks);
-    cbs->location_cb = vts_gps_location_callback;
-    cbs->status_cb = vts_gps_status_callback;
-    cbs->sv_status_cb = vts_gps_sv_status_callback;
-    cbs->nmea_cb = vts_gps_nmea_callback;
-    cbs->set_capabilities_cb = vts_gps_set_capabilities;
-    cbs->acquire_wakelock_cb = vts_gps_acquire_wakelock;
-    cbs->release_wakelock_cb = vts_gps_release_wakelock;
-    cbs->create_thread_cb = vts_gps_create_thread;
-    cbs->request_utc_time_cb = vts_gps_request_utc_time;
+    FillGpsCallbacks(cbs);
+    return cbs;
+  }
+}
 
+GpsCallbacks* GenerateGpsCallbacks(GpsCallbacks* cbs) {
+  if (RandomBool()) {
+    return NULL;
+  } else {
+    FillGpsCallbacks(cbs);
     return cbs;
   }
 }
@@ -31,34 +31,51 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// Sets state to random values.
+static void FillLightState(light_state_t* state) {
+  state->color = RandomUint32();
+  state->flashMode = RandomInt32();
+  state->flashOnMS = RandomInt32();
+  state->flashOffMS = RandomInt32();
+  if (RandomBool()) {  // normal values
+    if (RandomBool()) {
+      state->brightnessMode = BRIGHTNESS_MODE_USER;
+    } else {
+      state->brightnessMode = BRIGHTNESS_MODE_SENSOR;
+    }
+  } else {  // abnormal values
+    state->brightnessMode = RandomInt32();
+  }
+}
+
 light_state_t* GenerateLightState() {
   if (RandomBool()) {
     return NULL;
   } else {
     light_state_t* state = (light_state_t*)malloc(sizeof(light_state_t));
+    FillLightState(state);
+    return state;
+  }
+}
 
-    state->color = RandomUint32();
-    state->flashMode = RandomInt32();
-    state->flashOnMS = RandomInt32();
-    state->flashOffMS = RandomInt32();
-    if (RandomBool()) {  // normal values
-      if (RandomBool()) {
-        state->brightnessMode = BRIGHTNESS_MODE_USER;
-      } else {
-        state->brightnessMode = BRIGHTNESS_MODE_SENSOR;
-      }
-    } else {  // abnormal values
-      state->brightnessMode = RandomInt32();
-    }
-
+light_state_t* GenerateLightState(light_state_t* state) {
+  if (RandomBool()) {
+    return NULL;
+  } else {
+    FillLightState(state);
     return state;
   }
 }
 
 light_state_t* GenerateLightStateUsingMessage(
     const VariableSpecificationMessage& msg) {
-  cout << __func__ << " entry" << endl;
   light_state_t* state = (light_state_t*)malloc(sizeof(light_state_t));
+  return GenerateLightStateUsingMessage(msg, state);
+}
+
+light_state_t* GenerateLightStateUsingMessage(
+    const VariableSpecificationMessage& msg, light_state_t* state) {
+  cout << __func__ << " entry" << endl;
 
   // TODO: use a dict in the proto and handle when the key is missing (i.e.,
   // randomly generate that).
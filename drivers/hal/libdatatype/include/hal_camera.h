@@ -29,6 +29,12 @@ namespace vts {
 // Generates a camera_module_callbacks data structure.
 extern camera_module_callbacks_t* GenerateCameraModuleCallbacks();
 
+// Generates a camera_module_callbacks data structure in callbacks, which is
+// returned, or returns NULL. Lets a driver reuse one instance for all its
+// calls, as do the other functions taking the data structure to fill in.
+extern camera_module_callbacks_t* GenerateCameraModuleCallbacks(
+    camera_module_callbacks_t* callbacks);
+
 // Return the pointer to a camera_notify_callback function.
 extern camera_notify_callback GenerateCameraNotifyCallback();
 
@@ -48,6 +54,15 @@ extern camera_info_t* GenerateCameraInfo();
 extern camera_info_t* GenerateCameraInfoUsingMessage(
     const VariableSpecificationMessage& msg);
 
+// Generates a camera_info data structure in caminfo, which is returned, or
+// returns NULL.
+extern camera_info_t* GenerateCameraInfo(camera_info_t* caminfo);
+
+// Generates a camera_info data structure in caminfo using a given protobuf
+// msg's values, and returns caminfo.
+extern camera_info_t* GenerateCameraInfoUsingMessage(
+    const VariableSpecificationMessage& msg, camera_info_t* caminfo);
+
 // Converts camera_info to a protobuf message.
 extern bool ConvertCameraInfoToProtobuf(camera_info_t* raw,
                                         VariableSpecificationMessage* msg);
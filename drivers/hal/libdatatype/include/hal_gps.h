@@ -34,6 +34,10 @@ typedef uint32_t preferred_time;
 // Generates a GpsCallback instance used for GPS HAL v1 init().
 extern GpsCallbacks* GenerateGpsCallbacks();
 
+// Generates a GpsCallback instance in cbs, which is returned, or returns
+// NULL. Lets a driver reuse one instance for all its calls.
+extern GpsCallbacks* GenerateGpsCallbacks(GpsCallbacks* cbs);
+
 // Generates a GpsUtcTime value which is int64_t.
 extern GpsUtcTime GenerateGpsUtcTime();
 
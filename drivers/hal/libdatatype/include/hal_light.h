@@ -30,6 +30,14 @@ light_state_t* GenerateLightState();
 light_state_t* GenerateLightStateUsingMessage(
     const VariableSpecificationMessage& msg);
 
+// Generates a light_state_t instance in state, which is returned, or returns
+// NULL. Lets a driver reuse one instance for all its calls.
+light_state_t* GenerateLightState(light_state_t* state);
+
+// Sets state from msg and returns it.
+light_state_t* GenerateLightStateUsingMessage(
+    const VariableSpecificationMessage& msg, light_state_t* state);
+
 }  // namespace vts
 }  // namespace android
 
@@ -17,6 +17,9 @@
 #ifndef __VTS_DATATYPE_H__
 #define __VTS_DATATYPE_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "hal_camera.h"
 #include "hal_gps.h"
 #include "hal_light.h"
@@ -26,7 +29,19 @@
 namespace android {
 namespace vts {
 
+// The random values are drawn from a xoshiro256** generator of the calling
+// thread, without any lock. Unless reseeded, the first thread using it gets
+// the seed 1 and each later thread the next seed, so that a driver fuzzed
+// from one thread generates the same values in every run.
+
+// Reseeds the generator of the calling thread from the current time.
 extern void RandomNumberGeneratorReset();
+// Reseeds the generator of the calling thread with seed, and makes the
+// threads using a generator for the first time afterwards get the seeds
+// following it.
+extern void RandomNumberGeneratorReset(uint64_t seed);
+// Returns a random index below count, e.g. into a table of enumerators.
+extern size_t RandomIndex(size_t count);
 extern uint32_t RandomUint32();
 extern int32_t RandomInt32();
 extern uint64_t RandomUint64();
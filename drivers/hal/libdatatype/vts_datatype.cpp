@@ -19,32 +19,101 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include <atomic>
+
 namespace android {
 namespace vts {
 
-void RandomNumberGeneratorReset() { srand(time(NULL)); }
+namespace {
+
+// xoshiro256** of Blackman and Vigna, seeded by splitmix64 as its authors
+// recommend.
+class RandomNumberGenerator {
+ public:
+  explicit RandomNumberGenerator(uint64_t seed) { Seed(seed); }
+
+  void Seed(uint64_t seed) {
+    for (uint64_t& word : state_) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  uint64_t Next() {
+    uint64_t result = RotateLeft(state_[1] * 5, 7) * 9;
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = RotateLeft(state_[3], 45);
+    return result;
+  }
+
+ private:
+  static uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
 
-uint32_t RandomUint32() { return (unsigned int)rand(); }
+  uint64_t state_[4];
+};
 
-int32_t RandomInt32() { return rand(); }
+// the seed of the next thread getting its generator.
+std::atomic<uint64_t> next_thread_seed(1);
 
-uint64_t RandomUint64() {
-  uint64_t num = (unsigned int)rand();
-  return (num << 32) | (unsigned int)rand();
+RandomNumberGenerator& GetGenerator() {
+  static thread_local RandomNumberGenerator generator(next_thread_seed++);
+  return generator;
 }
 
+// Returns a value in [0, 2^31 - 1], the range of rand().
+int32_t RandomNonNegativeInt32() {
+  return static_cast<int32_t>(GetGenerator().Next() >> 33);
+}
+
+// Returns two values of rand() in the high and low words, i.e. a value with
+// bits 31 and 63 cleared.
+uint64_t RandomTwoNonNegativeInt32() {
+  return GetGenerator().Next() & 0x7fffffff7fffffffULL;
+}
+
+}  // namespace
+
+void RandomNumberGeneratorReset() { GetGenerator().Seed(time(NULL)); }
+
+void RandomNumberGeneratorReset(uint64_t seed) {
+  next_thread_seed = seed + 1;
+  GetGenerator().Seed(seed);
+}
+
+size_t RandomIndex(size_t count) {
+  // maps the high 32 bits to [0, count) with a multiplication.
+  return static_cast<size_t>(((GetGenerator().Next() >> 32) * count) >> 32);
+}
+
+uint32_t RandomUint32() { return RandomNonNegativeInt32(); }
+
+int32_t RandomInt32() { return RandomNonNegativeInt32(); }
+
+uint64_t RandomUint64() { return RandomTwoNonNegativeInt32(); }
+
 int64_t RandomInt64() {
-  int64_t num = rand();
-  return (num << 32) | rand();
+  return static_cast<int64_t>(RandomTwoNonNegativeInt32());
 }
 
-float RandomFloat() { return (float)rand() / (float)(RAND_MAX / 1000000000.0); }
+float RandomFloat() {
+  return (float)RandomNonNegativeInt32() / (float)(RAND_MAX / 1000000000.0);
+}
 
 double RandomDouble() {
-  return (double)rand() / (double)(RAND_MAX / 1000000000.0);
+  return (double)RandomNonNegativeInt32() / (double)(RAND_MAX / 1000000000.0);
 }
 
-bool RandomBool() { return (abs(rand()) % 2) == 1; }
+bool RandomBool() { return (GetGenerator().Next() >> 63) == 1; }
 
 char* RandomCharPointer() {
   int len = RandomUint32() % MAX_CHAR_POINTER_LENGTH;
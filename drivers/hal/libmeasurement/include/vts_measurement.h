@@ -17,37 +17,76 @@
 #ifndef __VTS_MEASUREMENT_H__
 #define __VTS_MEASUREMENT_H__
 
-#if USE_CTIME
-#include <time.h>
-#else
-#include <sys/time.h>
-#endif
-
-#include <vector>
+#include <stddef.h>
+#include <stdint.h>
 
-using namespace std;
+#include "VtsLatencyHistogram.h"
 
 namespace android {
 namespace vts {
 
+// The values measured between VtsMeasurement::Start and Stop.
+struct VtsMeasurementResult {
+  // elapsed time in nanoseconds, on CLOCK_MONOTONIC.
+  int64_t elapsed_time_ns;
+  // number of edges covered, i.e. sanitizer coverage pc guards hit.
+  size_t covered_edge_count;
+  // number of the covered edges that no previous measurement covered.
+  size_t new_edge_count;
+};
+
+// The distribution of repeated measurements of elapsed time, e.g. of the
+// calls of one function (see VtsLatencyHistogram.h).
+typedef VtsLatencyHistogram VtsMeasurementHistogram;
+
+// A measurement of the elapsed time only, started by
+// VtsMeasurement::StartTimer.
+struct VtsMeasurementHandle {
+  // the start time in nanoseconds, on CLOCK_MONOTONIC.
+  int64_t start_time_ns;
+};
+
 // Class to do measurements before and after calling a target function.
+//
+// The edge coverage comes from the code built with
+// -fsanitize-coverage=trace-pc-guard, whose callbacks are defined in this
+// library. Each edge has an 8-bit hit counter in a preallocated array, which
+// Start clears. The counters are shared by the process, so measurements
+// should not overlap. If hal.instrumentation.coverage.shm is set when the
+// process starts, the counters are also shared with other processes, through
+// the file it names (see utils/SharedEdgeCounters.h).
 class VtsMeasurement {
  public:
-  VtsMeasurement() {}
+  VtsMeasurement() : start_time_ns_(0) {}
 
   // Starts the measurement
   void Start();
 
-  // Stops the measurement and returns the measured values.
-  vector<float>* Stop();
+  // Stops the measurement and returns the measured values. The elapsed time
+  // is also recorded in histogram if it is not null.
+  VtsMeasurementResult Stop(VtsMeasurementHistogram* histogram = nullptr);
+
+  // Starts measuring the elapsed time only. Unlike the edge coverage, which
+  // is counted for the whole process, timers are independent of each other,
+  // so they may be nested, e.g. around each stage of a call, or run on
+  // several threads at once.
+  static VtsMeasurementHandle StartTimer();
+
+  // Returns the nanoseconds elapsed since handle was started. They are also
+  // recorded in histogram if it is not null.
+  static int64_t StopTimer(const VtsMeasurementHandle& handle,
+                           VtsMeasurementHistogram* histogram = nullptr);
+
+  // Returns the edge counters, of size GetEdgeCount(), e.g. for a fuzzer to
+  // tell which edges the last measurement covered.
+  static const uint8_t* GetEdgeCounters();
+
+  // Returns the number of edges of the instrumented code loaded so far.
+  static size_t GetEdgeCount();
 
  private:
-// data structure to keep the start time.
-#if USE_CTIME
-  struct timeval tv_;
-#else
-  timespec ts_;
-#endif
+  // the start time in nanoseconds.
+  int64_t start_time_ns_;
 };
 
 }  // namespace vts
@@ -16,104 +16,120 @@
 
 #include "vts_measurement.h"
 
-#if USE_CTIME
+#include <string.h>
 #include <time.h>
-#else
-#include <sys/time.h>
-#endif
-#include <stdlib.h>
 
-#include <iostream>
+#include <cutils/properties.h>
 
-#define COVERAGE_SANCOV 0
+#include "utils/SharedEdgeCounters.h"
 
-#if COVERAGE_SANCOV
-#include <sanitizer/coverage_interface.h>
-#endif
+using android::vts::MapSharedEdgeCounters;
+using android::vts::SharedEdgeCounters;
 
-#include <vector>
+// The maximum number of edges, beyond which edges are not counted.
+static constexpr size_t kMaxEdgeCount = android::vts::kMaxSharedEdgeCount;
 
-using namespace std;
+// The hit counter of each edge, indexed by the pc guard value minus 1.
+static uint8_t local_edge_counters[kMaxEdgeCount];
 
-#if COVERAGE_SANCOV
+// The counters in use, those in the file named by
+// hal.instrumentation.coverage.shm if it is set.
+static uint8_t* edge_counters = local_edge_counters;
 
+// The shared counters, nullptr if not shared.
+static SharedEdgeCounters* shared_edge_counters;
+
+// The edges covered by any measurement so far, one bit per edge.
+static uint64_t covered_edges[kMaxEdgeCount / 64];
+
+// The number of edges with a pc guard, at most kMaxEdgeCount.
+static size_t edge_count;
+
+// The callbacks are weak so that a sanitizer runtime or a fuzzer linked into
+// the same process keeps its own definitions.
 extern "C" {
-// Re-declare some of the sanitizer functions as "weak" so that
-// libFuzzer can be linked w/o the sanitizers and sanitizer-coverage
-// (in which case it will complain at start-up time).
-__attribute__((weak)) void __sanitizer_print_stack_trace();
-__attribute__((weak)) void __sanitizer_reset_coverage();
-__attribute__((weak)) size_t __sanitizer_get_total_unique_caller_callee_pairs();
-__attribute__((weak)) size_t __sanitizer_get_total_unique_coverage();
-__attribute__((weak)) void __sanitizer_set_death_callback(
-    void (*callback)(void));
-__attribute__((weak)) size_t __sanitizer_get_number_of_counters();
-__attribute__((weak)) uintptr_t
-__sanitizer_update_counter_bitset_and_clear_counters(uint8_t* bitset);
+// Called once per instrumented module to number its guards.
+__attribute__((weak)) void __sanitizer_cov_trace_pc_guard_init(
+    uint32_t* start, uint32_t* stop) {
+  static bool shared_edge_counters_checked = false;
+  if (!shared_edge_counters_checked) {
+    shared_edge_counters_checked = true;
+    char path[PROPERTY_VALUE_MAX];
+    if (property_get(android::vts::kSharedEdgeCountersProperty, path, "") >
+        0) {
+      shared_edge_counters = MapSharedEdgeCounters(path, true);
+      if (shared_edge_counters) edge_counters = shared_edge_counters->counters;
+    }
+  }
+  if (start == stop || *start) return;
+  for (uint32_t* guard = start; guard < stop; guard++) {
+    // Guard 0 is never counted.
+    *guard = edge_count < kMaxEdgeCount ? ++edge_count : 0;
+  }
+  if (shared_edge_counters) {
+    shared_edge_counters->edge_count.store(edge_count,
+                                           std::memory_order_release);
+  }
 }
 
-#define CHECK_WEAK_API_FUNCTION(fn)       \
-  do {                                    \
-    if (!fn) MissingWeakApiFunction(#fn); \
-  } while (false)
+// Called on every edge.
+__attribute__((weak)) void __sanitizer_cov_trace_pc_guard(uint32_t* guard) {
+  uint32_t index = *guard;
+  if (index) edge_counters[index - 1]++;
+}
+}
 
-static void MissingWeakApiFunction(const char* FnName) {
-  cerr << "ERROR: " << FnName << " is not defined. Exiting.\n"
-       << "Did you use -fsanitize-coverage=... to build your code?" << endl;
-  exit(1);
+static int64_t nowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
 }
-#endif
 
 namespace android {
 namespace vts {
 
 void VtsMeasurement::Start() {
-#if COVERAGE_SANCOV
-  cout << "reset coverage";
-  CHECK_WEAK_API_FUNCTION(__sanitizer_reset_coverage);
-  __sanitizer_reset_coverage();
-  cout << endl;
-#endif
-
-#if USE_CTIME
-  gettimeofday(&tv_, NULL);
-#else
-  clock_gettime(CLOCK_REALTIME, &ts_);
-#endif
+  memset(edge_counters, 0, edge_count);
+  start_time_ns_ = nowNs();
 }
 
-vector<float>* VtsMeasurement::Stop() {
-#if USE_CTIME
-  struct timeval curr_tv;
-  gettimeofday(&curr_tv, NULL);
-#else
-  timespec ts_now;
-  clock_gettime(CLOCK_REALTIME, &ts_now);
-#endif
-
-  vector<float>* result = new vector<float>;
-
-#if USE_CTIME
-  float stop_time_usecs;
-  float start_time_usecs;
-  stop_time_usecs = curr_tv.tv_sec + curr_tv.tv_usec / 1000000.0;
-  start_time_usecs = tv_.tv_sec + tv_.tv_usec / 1000000.0;
-  result->push_back(stop_time_usecs - start_time_usecs);
-#else
-  float stop_time_usecs;
-  float start_time_usecs;
-  stop_time_usecs = ts_now.tv_sec + ts_now.tv_nsec / 1000000000.0;
-  start_time_usecs = ts_.tv_sec + ts_.tv_nsec / 1000000000.0;
-  result->push_back(stop_time_usecs - start_time_usecs);
-#endif
-
-#if COVERAGE_SANCOV
-  cout << "coverage: ";
-  cout << __sanitizer_get_total_unique_caller_callee_pairs() << endl;
-#endif
-
+VtsMeasurementResult VtsMeasurement::Stop(
+    VtsMeasurementHistogram* histogram) {
+  VtsMeasurementResult result;
+  result.elapsed_time_ns = nowNs() - start_time_ns_;
+  if (histogram) histogram->Record(result.elapsed_time_ns);
+  result.covered_edge_count = 0;
+  result.new_edge_count = 0;
+
+  // The counters past edge_count are never hit, so whole words of 64 edges
+  // are scanned.
+  for (size_t begin = 0; begin < edge_count; begin += 64) {
+    uint64_t hits = 0;
+    for (size_t i = 0; i < 64; i++) {
+      hits |= static_cast<uint64_t>(edge_counters[begin + i] != 0) << i;
+    }
+    uint64_t& covered = covered_edges[begin / 64];
+    result.covered_edge_count += __builtin_popcountll(hits);
+    result.new_edge_count += __builtin_popcountll(hits & ~covered);
+    covered |= hits;
+  }
   return result;
 }
 
+VtsMeasurementHandle VtsMeasurement::StartTimer() {
+  return VtsMeasurementHandle{nowNs()};
+}
+
+int64_t VtsMeasurement::StopTimer(const VtsMeasurementHandle& handle,
+                                  VtsMeasurementHistogram* histogram) {
+  int64_t elapsed_time_ns = nowNs() - handle.start_time_ns;
+  if (histogram) histogram->Record(elapsed_time_ns);
+  return elapsed_time_ns;
+}
+
+const uint8_t* VtsMeasurement::GetEdgeCounters() { return edge_counters; }
+
+size_t VtsMeasurement::GetEdgeCount() { return edge_count; }
+
 }  // namespace vts
 }  // namespace android
@@ -18,20 +18,42 @@
 
 #include "VtsDriverCommUtil.h"
 
+#include <ctype.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
-#include <sstream>
+#include <unistd.h>
+#include <algorithm>
+#include <limits>
 
 #include <android-base/logging.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
 
 using namespace std;
 
 #define MAX_HEADER_BUFFER_SIZE 128
+#define RECV_BUFFER_SIZE 4096
+// The largest message accepted, so that a corrupt length header fails the
+// receive instead of allocating whatever it claims.
+#define MAX_MESSAGE_SIZE (256 << 20)
+
+// The protocol v2 length header is one of these markers followed by the
+// message length as a 4 or 8 byte little endian integer. The text header of
+// the protocol v1 is the decimal length followed by a newline, so it never
+// starts with a marker.
+#define BINARY_HEADER_MARKER_32 '\x04'
+#define BINARY_HEADER_MARKER_64 '\x08'
 
 namespace android {
 namespace vts {
@@ -41,7 +63,7 @@ bool VtsDriverCommUtil::Connect(const string& socket_name) {
   struct hostent* server;
 
   LOG(DEBUG) << "Connect socket: " << socket_name;
-  sockfd_ = socket(PF_UNIX, SOCK_STREAM, 0);
+  SetSockfd(socket(PF_UNIX, SOCK_STREAM, 0));
   if (sockfd_ < 0) {
     LOG(ERROR) << "ERROR opening socket.";
     return false;
@@ -74,35 +96,164 @@ int VtsDriverCommUtil::Close() {
       LOG(ERROR) << "ERROR closing socket (errno = " << errno << ")";
     }
 
-    sockfd_ = -1;
+    SetSockfd(-1);
   }
 
   return result;
 }
 
+// Formats the length header of a message of msg_len bytes into header,
+// which holds MAX_HEADER_BUFFER_SIZE bytes. Returns the header length.
+static size_t FormatHeader(bool binary_header, uint64_t msg_len, char* header) {
+  if (!binary_header) {
+    return snprintf(header, MAX_HEADER_BUFFER_SIZE, "%" PRIu64 "\n", msg_len);
+  }
+  size_t width = msg_len > UINT32_MAX ? 8 : 4;
+  header[0] = width == 8 ? BINARY_HEADER_MARKER_64 : BINARY_HEADER_MARKER_32;
+  for (size_t i = 0; i < width; i++) {
+    header[1 + i] = static_cast<char>(msg_len >> (8 * i));
+  }
+  return 1 + width;
+}
+
+// Reads the body of a message from the bytes already received, then from
+// the socket. Bytes read past the end of the message stay in the receive
+// buffer for the next message.
+class VtsDriverCommUtil::SocketInputStream
+    : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  SocketInputStream(VtsDriverCommUtil* util, uint64_t size)
+      : util_(util), remaining_(size), byte_count_(0) {}
+
+  bool Next(const void** data, int* size) override {
+    if (remaining_ == 0) {
+      return false;
+    }
+    if (util_->recv_begin_ == util_->recv_end_) {
+      util_->recv_begin_ = util_->recv_end_ = 0;
+      if (util_->recv_buffer_.size() < RECV_BUFFER_SIZE) {
+        util_->recv_buffer_.resize(RECV_BUFFER_SIZE);
+      }
+      if (!util_->FillRecvBuffer(1)) {
+        return false;
+      }
+    }
+    uint64_t available = util_->recv_end_ - util_->recv_begin_;
+    *size = static_cast<int>(min<uint64_t>(min(available, remaining_),
+                                           numeric_limits<int>::max()));
+    *data = util_->recv_buffer_.data() + util_->recv_begin_;
+    util_->recv_begin_ += *size;
+    remaining_ -= *size;
+    byte_count_ += *size;
+    return true;
+  }
+
+  void BackUp(int count) override {
+    util_->recv_begin_ -= count;
+    remaining_ += count;
+    byte_count_ -= count;
+  }
+
+  bool Skip(int count) override {
+    const void* data;
+    int size;
+    while (count > 0) {
+      if (!Next(&data, &size)) {
+        return false;
+      }
+      if (size > count) {
+        BackUp(size - count);
+        size = count;
+      }
+      count -= size;
+    }
+    return true;
+  }
+
+  int64_t ByteCount() const override {
+    return byte_count_;
+  }
+
+  // the number of bytes of the message not consumed yet
+  uint64_t remaining() const {
+    return remaining_;
+  }
+
+ private:
+  VtsDriverCommUtil* util_;
+  uint64_t remaining_;
+  int64_t byte_count_;
+};
+
+// Writes to the socket without raising SIGPIPE when the peer is gone, so
+// that a caller can reconnect instead.
+class SocketOutputStream : public google::protobuf::io::CopyingOutputStream {
+ public:
+  explicit SocketOutputStream(int sockfd) : sockfd_(sockfd) {}
+
+  bool Write(const void* buffer, int size) override {
+    const char* data = static_cast<const char*>(buffer);
+    while (size > 0) {
+      ssize_t n = TEMP_FAILURE_RETRY(send(sockfd_, data, size, MSG_NOSIGNAL));
+      if (n <= 0) {
+        return false;
+      }
+      data += n;
+      size -= n;
+    }
+    return true;
+  }
+
+ private:
+  int sockfd_;
+};
+
 bool VtsDriverCommUtil::VtsSocketSendBytes(const string& message) {
   if (sockfd_ == -1) {
     LOG(ERROR) << "ERROR sockfd not set.";
     return false;
   }
-  stringstream header;
-  header << message.length() << "\n";
-  LOG(DEBUG) << "[agent->driver] len = " << message.length();
-  int n = write(sockfd_, header.str().c_str(), header.str().length());
-  if (n < 0) {
-    LOG(ERROR) << " ERROR writing to socket.";
-    return false;
-  }
+  uint64_t msg_len = message.length();
+  char header[MAX_HEADER_BUFFER_SIZE];
+  size_t header_len = FormatHeader(binary_header_, msg_len, header);
+  LOG(DEBUG) << "[agent->driver] len = " << msg_len;
 
-  int bytes_sent = 0;
-  int msg_len = message.length();
-  while (bytes_sent < msg_len) {
-    n = write(sockfd_, &message.c_str()[bytes_sent], msg_len - bytes_sent);
+  struct iovec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = header_len;
+  iov[1].iov_base = const_cast<char*>(message.data());
+  iov[1].iov_len = msg_len;
+  struct iovec* pending = iov;
+  int pending_count = msg_len > 0 ? 2 : 1;
+  while (pending_count > 0) {
+    struct msghdr msg = {};
+    msg.msg_iov = pending;
+    msg.msg_iovlen = pending_count;
+    ssize_t n = TEMP_FAILURE_RETRY(sendmsg(sockfd_, &msg, MSG_NOSIGNAL));
     if (n <= 0) {
       LOG(ERROR) << "ERROR writing to socket.";
       return false;
     }
-    bytes_sent += n;
+    while (pending_count > 0 && static_cast<size_t>(n) >= pending->iov_len) {
+      n -= pending->iov_len;
+      pending++;
+      pending_count--;
+    }
+    if (pending_count > 0) {
+      pending->iov_base = static_cast<char*>(pending->iov_base) + n;
+      pending->iov_len -= n;
+    }
+  }
+  return true;
+}
+
+// Returns false if a received length header claims more than
+// MAX_MESSAGE_SIZE bytes.
+static bool CheckMessageLength(uint64_t msg_len) {
+  if (msg_len > MAX_MESSAGE_SIZE) {
+    LOG(ERROR) << "ERROR the message length " << msg_len
+               << " is over the limit of " << MAX_MESSAGE_SIZE << " bytes.";
+    return false;
   }
   return true;
 }
@@ -112,60 +263,133 @@ string VtsDriverCommUtil::VtsSocketRecvBytes() {
     LOG(ERROR) << "ERROR sockfd not set.";
     return string();
   }
+  uint64_t msg_len;
+  if (!RecvHeader(&msg_len)) {
+    return string();
+  }
+  if (!FillRecvBuffer(msg_len)) {
+    LOG(ERROR) << "ERROR read failed.";
+    return string();
+  }
+  string message(recv_buffer_.data() + recv_begin_, msg_len);
+  recv_begin_ += msg_len;
+  return message;
+}
 
-  int header_index = 0;
-  char header_buffer[MAX_HEADER_BUFFER_SIZE];
+bool VtsDriverCommUtil::RecvHeader(uint64_t* msg_len) {
+  if (!FillRecvBuffer(1)) {
+    return false;
+  }
+  *msg_len = 0;
+  char marker = recv_buffer_[recv_begin_];
+  if (marker == BINARY_HEADER_MARKER_32 || marker == BINARY_HEADER_MARKER_64) {
+    // the peer speaks the protocol v2, so reply the same way.
+    binary_header_ = true;
+    size_t width = marker == BINARY_HEADER_MARKER_64 ? 8 : 4;
+    if (!FillRecvBuffer(1 + width)) {
+      return false;
+    }
+    const unsigned char* header =
+        reinterpret_cast<const unsigned char*>(&recv_buffer_[recv_begin_ + 1]);
+    for (size_t i = 0; i < width; i++) {
+      *msg_len |= static_cast<uint64_t>(header[i]) << (8 * i);
+    }
+    recv_begin_ += 1 + width;
+    return CheckMessageLength(*msg_len);
+  }
 
-  for (header_index = 0; header_index < MAX_HEADER_BUFFER_SIZE;
-       header_index++) {
-    int ret = read(sockfd_, &header_buffer[header_index], 1);
-    if (ret != 1) {
-      int errno_save = errno;
-      LOG(DEBUG) << "ERROR reading the length ret = " << ret
-                 << " sockfd = " << sockfd_ << " "
-                 << " errno = " << errno_save << " " << strerror(errno_save);
-      return string();
+  size_t header_len = 0;
+  while (true) {
+    if (header_len == MAX_HEADER_BUFFER_SIZE) {
+      LOG(ERROR) << "ERROR the length header is too long.";
+      return false;
+    }
+    if (!FillRecvBuffer(header_len + 1)) {
+      return false;
     }
-    if (header_buffer[header_index] == '\n' ||
-        header_buffer[header_index] == '\r') {
-      header_buffer[header_index] = '\0';
+    char c = recv_buffer_[recv_begin_ + header_len];
+    if (c == '\n' || c == '\r') {
       break;
     }
+    if (!isdigit(static_cast<unsigned char>(c))) {
+      LOG(ERROR) << "ERROR the length header is not a number.";
+      return false;
+    }
+    header_len++;
   }
+  *msg_len = strtoull(string(&recv_buffer_[recv_begin_], header_len).c_str(),
+                      NULL, 10);
+  recv_begin_ += header_len + 1;
+  return CheckMessageLength(*msg_len);
+}
 
-  int msg_len = atoi(header_buffer);
-  char* msg = (char*)malloc(msg_len + 1);
-  if (!msg) {
-    LOG(ERROR) << "ERROR malloc failed.";
-    return string();
+bool VtsDriverCommUtil::FillRecvBuffer(size_t size) {
+  if (recv_end_ - recv_begin_ >= size) {
+    return true;
   }
-
-  int bytes_read = 0;
-  while (bytes_read < msg_len) {
-    int result = read(sockfd_, &msg[bytes_read], msg_len - bytes_read);
-    if (result <= 0) {
-      LOG(ERROR) << "ERROR read failed.";
-      return string();
+  // moves the pending bytes to the front, then grows the buffer if the
+  // whole message still doesn't fit.
+  if (recv_begin_ > 0) {
+    memmove(recv_buffer_.data(), recv_buffer_.data() + recv_begin_,
+            recv_end_ - recv_begin_);
+    recv_end_ -= recv_begin_;
+    recv_begin_ = 0;
+  }
+  if (recv_buffer_.size() < size) {
+    recv_buffer_.resize(max(size, max(recv_buffer_.size() * 2,
+                                      static_cast<size_t>(RECV_BUFFER_SIZE))));
+  }
+  while (recv_end_ < size) {
+    ssize_t ret = TEMP_FAILURE_RETRY(read(sockfd_, &recv_buffer_[recv_end_],
+                                          recv_buffer_.size() - recv_end_));
+    if (ret <= 0) {
+      int errno_save = errno;
+      LOG(DEBUG) << "ERROR reading from socket ret = " << ret
+                 << " sockfd = " << sockfd_ << " "
+                 << " errno = " << errno_save << " " << strerror(errno_save);
+      return false;
     }
-    bytes_read += result;
+    recv_end_ += ret;
   }
-  msg[msg_len] = '\0';
-  return string(msg, msg_len);
+  return true;
 }
 
 bool VtsDriverCommUtil::VtsSocketSendMessage(
     const google::protobuf::Message& message) {
+  return VtsSocketSendMessages({&message});
+}
+
+bool VtsDriverCommUtil::VtsSocketSendMessages(
+    const vector<const google::protobuf::Message*>& messages) {
   if (sockfd_ == -1) {
     LOG(ERROR) << "ERROR sockfd not set.";
     return false;
   }
 
-  string message_string;
-  if (!message.SerializeToString(&message_string)) {
-    LOG(ERROR) << "ERROR can't serialize the message to a string.";
+  // serializes straight into the socket instead of a temporary string.
+  SocketOutputStream socket_output(sockfd_);
+  google::protobuf::io::CopyingOutputStreamAdaptor output(&socket_output);
+  bool success = true;
+  {
+    google::protobuf::io::CodedOutputStream coded_output(&output);
+    char header[MAX_HEADER_BUFFER_SIZE];
+    for (const auto* message : messages) {
+      uint64_t msg_len = message->ByteSizeLong();
+      LOG(DEBUG) << "[agent->driver] len = " << msg_len;
+      coded_output.WriteRaw(header,
+                            FormatHeader(binary_header_, msg_len, header));
+      message->SerializeWithCachedSizes(&coded_output);
+      if (coded_output.HadError()) {
+        success = false;
+        break;
+      }
+    }
+  }
+  if (!output.Flush() || !success) {
+    LOG(ERROR) << "ERROR writing to socket.";
     return false;
   }
-  return VtsSocketSendBytes(message_string);
+  return true;
 }
 
 bool VtsDriverCommUtil::VtsSocketRecvMessage(
@@ -175,13 +399,25 @@ bool VtsDriverCommUtil::VtsSocketRecvMessage(
     return false;
   }
 
-  string message_string = VtsSocketRecvBytes();
-  if (message_string.length() == 0) {
+  uint64_t msg_len;
+  if (!RecvHeader(&msg_len) || msg_len == 0) {
     LOG(DEBUG) << "ERROR message string zero length.";
     return false;
   }
 
-  return message->ParseFromString(message_string);
+  // parses straight from the socket, so a large message is never buffered
+  // whole.
+  SocketInputStream input(this, msg_len);
+  bool success = message->ParseFromZeroCopyStream(&input);
+  if (input.remaining() > 0) {
+    // skips the rest of a malformed message to stay in sync.
+    success = false;
+    const void* data;
+    int size;
+    while (input.Next(&data, &size)) {
+    }
+  }
+  return success && input.remaining() == 0;
 }
 
 }  // namespace vts
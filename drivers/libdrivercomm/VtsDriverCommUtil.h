@@ -17,7 +17,10 @@
 #ifndef __VTS_DRIVER_COMM_UTIL_H_
 #define __VTS_DRIVER_COMM_UTIL_H_
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
 
@@ -28,9 +31,17 @@ namespace vts {
 
 class VtsDriverCommUtil {
  public:
-  VtsDriverCommUtil() : sockfd_(-1) {}
-
-  explicit VtsDriverCommUtil(int sockfd) : sockfd_(sockfd) {}
+  VtsDriverCommUtil()
+      : sockfd_(-1),
+        binary_header_(false),
+        recv_begin_(0),
+        recv_end_(0) {}
+
+  explicit VtsDriverCommUtil(int sockfd)
+      : sockfd_(sockfd),
+        binary_header_(false),
+        recv_begin_(0),
+        recv_end_(0) {}
 
   ~VtsDriverCommUtil() {
     //    if (sockfd_ != -1) Close();
@@ -42,6 +53,15 @@ class VtsDriverCommUtil {
   // sets sockfd_
   void SetSockfd(int sockfd) {
     sockfd_ = sockfd;
+    recv_begin_ = recv_end_ = 0;
+  }
+
+  // sets whether the messages are sent with the binary length header of
+  // the protocol v2 instead of the text header. it is set automatically
+  // once a message with a binary header is received, so that a peer which
+  // only knows the text header keeps working.
+  void SetBinaryHeader(bool binary_header) {
+    binary_header_ = binary_header;
   }
 
   // closes the channel. returns 0 if success or socket already closed
@@ -56,12 +76,36 @@ class VtsDriverCommUtil {
   // Sends a protobuf message.
   bool VtsSocketSendMessage(const google::protobuf::Message& message);
 
+  // Sends protobuf messages back to back, with as few writes as possible.
+  bool VtsSocketSendMessages(
+      const vector<const google::protobuf::Message*>& messages);
+
   // Receives a protobuf message.
   bool VtsSocketRecvMessage(google::protobuf::Message* message);
 
  private:
+  // Reads the body of a message from the socket.
+  class SocketInputStream;
+
+  // Receives the length header of the next message into msg_len. Returns
+  // false if the connection is closed or on error.
+  bool RecvHeader(uint64_t* msg_len);
+
+  // Reads from the socket until recv_buffer_ holds at least size bytes
+  // after recv_begin_.
+  bool FillRecvBuffer(size_t size);
+
   // sockfd
   int sockfd_;
+
+  // whether the messages are sent with the binary length header
+  bool binary_header_;
+
+  // the bytes received but not consumed yet are
+  // recv_buffer_[recv_begin_, recv_end_)
+  vector<char> recv_buffer_;
+  size_t recv_begin_;
+  size_t recv_end_;
 };
 
 }  // namespace vts
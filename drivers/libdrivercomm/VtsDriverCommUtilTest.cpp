@@ -0,0 +1,163 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "VtsDriverCommUtil.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Unit test of the socket protocol, with the test as the peer at the other
+// end of a socket pair.
+class VtsDriverCommUtilTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { Connect(SOCK_STREAM); }
+
+  virtual void TearDown() {
+    util_.Close();
+    if (peer_fd_ >= 0) {
+      close(peer_fd_);
+    }
+  }
+
+  // Replaces the socket pair with one of the given type.
+  void Connect(int type) {
+    util_.Close();
+    if (peer_fd_ >= 0) {
+      close(peer_fd_);
+    }
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, type, 0, fds));
+    util_.SetSockfd(fds[0]);
+    peer_fd_ = fds[1];
+  }
+
+  // Sends data from the peer, in a single write.
+  void PeerSend(const string& data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()),
+              write(peer_fd_, data.data(), data.size()));
+  }
+
+  // Receives up to size bytes on the peer.
+  string PeerRecv(size_t size) {
+    string data(size, '\0');
+    ssize_t n = read(peer_fd_, &data[0], size);
+    data.resize(n > 0 ? n : 0);
+    return data;
+  }
+
+  VtsDriverCommUtil util_;
+  int peer_fd_ = -1;
+};
+
+// Tests a message with the text header of the protocol v1.
+TEST_F(VtsDriverCommUtilTest, TextHeader) {
+  PeerSend("5\nhello");
+  EXPECT_EQ("hello", util_.VtsSocketRecvBytes());
+  PeerSend("0\n");
+  EXPECT_EQ("", util_.VtsSocketRecvBytes());
+  PeerSend("12ab\nhello");
+  EXPECT_EQ("", util_.VtsSocketRecvBytes());
+}
+
+// Tests messages with the 4 and 8 byte binary headers of the protocol v2.
+TEST_F(VtsDriverCommUtilTest, BinaryHeaders) {
+  PeerSend(string("\x04\x05\x00\x00\x00hello", 10));
+  EXPECT_EQ("hello", util_.VtsSocketRecvBytes());
+  PeerSend(string("\x08\x03\x00\x00\x00\x00\x00\x00\x00" "abc", 12));
+  EXPECT_EQ("abc", util_.VtsSocketRecvBytes());
+}
+
+// Tests two messages received in a single read.
+TEST_F(VtsDriverCommUtilTest, TwoMessagesInOneRead) {
+  PeerSend(string("5\nhello\x04\x05\x00\x00\x00world", 17));
+  EXPECT_EQ("hello", util_.VtsSocketRecvBytes());
+  EXPECT_EQ("world", util_.VtsSocketRecvBytes());
+}
+
+// Tests headers and messages split across reads. Each write on a
+// SOCK_SEQPACKET socket is a separate read.
+TEST_F(VtsDriverCommUtilTest, SplitAcrossReads) {
+  Connect(SOCK_SEQPACKET);
+  PeerSend("1");
+  PeerSend("2\nhello ");
+  PeerSend("world!");
+  EXPECT_EQ("hello world!", util_.VtsSocketRecvBytes());
+  PeerSend(string("\x04\x03", 2));
+  PeerSend(string("\x00\x00", 2));
+  PeerSend(string("\x00" "a", 2));
+  PeerSend("bc");
+  EXPECT_EQ("abc", util_.VtsSocketRecvBytes());
+}
+
+// Tests that a length over the limit is rejected before the message is read.
+TEST_F(VtsDriverCommUtilTest, OverLimitLength) {
+  PeerSend("268435457\nx");
+  EXPECT_EQ("", util_.VtsSocketRecvBytes());
+  Connect(SOCK_STREAM);
+  PeerSend(string("\x08\x00\x00\x00\x00\x00\x01\x00\x00x", 10));
+  EXPECT_EQ("", util_.VtsSocketRecvBytes());
+  Connect(SOCK_STREAM);
+  PeerSend("99999999999999999999\nx");
+  EXPECT_EQ("", util_.VtsSocketRecvBytes());
+  Connect(SOCK_STREAM);
+  PeerSend(string(200, '1') + "\nx");
+  EXPECT_EQ("", util_.VtsSocketRecvBytes());
+}
+
+// Tests that the text header is sent until a message with a binary header
+// is received, and the binary header afterwards.
+TEST_F(VtsDriverCommUtilTest, SwitchToBinaryHeader) {
+  ASSERT_TRUE(util_.VtsSocketSendBytes("hi"));
+  EXPECT_EQ("2\nhi", PeerRecv(64));
+  PeerSend("2\nv1");
+  EXPECT_EQ("v1", util_.VtsSocketRecvBytes());
+  ASSERT_TRUE(util_.VtsSocketSendBytes("hi"));
+  EXPECT_EQ("2\nhi", PeerRecv(64));
+  PeerSend(string("\x04\x02\x00\x00\x00v2", 7));
+  EXPECT_EQ("v2", util_.VtsSocketRecvBytes());
+  ASSERT_TRUE(util_.VtsSocketSendBytes("ok"));
+  EXPECT_EQ(string("\x04\x02\x00\x00\x00ok", 7), PeerRecv(64));
+}
+
+// Tests sending and receiving protobuf messages with both headers.
+TEST_F(VtsDriverCommUtilTest, ProtobufMessages) {
+  VtsDriverControlCommandMessage command;
+  command.set_command_type(CALL_FUNCTION);
+  command.set_request_id(42);
+  command.set_arg(string(10000, 'a'));
+  VtsDriverCommUtil peer(peer_fd_);
+  for (bool binary_header : {false, true}) {
+    peer.SetBinaryHeader(binary_header);
+    ASSERT_TRUE(peer.VtsSocketSendMessages({&command, &command}));
+    for (int i = 0; i < 2; i++) {
+      VtsDriverControlCommandMessage received;
+      ASSERT_TRUE(util_.VtsSocketRecvMessage(&received));
+      EXPECT_EQ(command.SerializeAsString(), received.SerializeAsString());
+    }
+  }
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,484 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "fmq_driver/VtsFmqDriver.h"
+#include "resource_manager/VtsResourceManager.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using android::hardware::kSynchronizedReadWrite;
+using android::hardware::kUnsynchronizedWrite;
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// An item of kSize bytes.
+template <size_t kSize>
+struct Element {
+  uint8_t bytes[kSize];
+};
+
+// data type of the queues created through the driver API.
+static constexpr const char* kElementType = "element";
+// wait time of the blocking calls.
+static constexpr int64_t kTimeOutNanos = 100 * 1000000LL;
+
+// The ways a reader or writer waits for the other side.
+enum WaitMode {
+  // retries the non-blocking call.
+  kWaitSpin,
+  // uses the blocking call with the event flag of the queue.
+  kWaitBlocking,
+  // uses the long-form blocking call with an event flag word shared by the
+  // queues.
+  kWaitEventFlag
+};
+
+// notification bits of the queues in kWaitEventFlag mode.
+static constexpr uint32_t kRequestNotEmpty = 1 << 0;
+static constexpr uint32_t kRequestNotFull = 1 << 1;
+static constexpr uint32_t kResponseNotEmpty = 1 << 2;
+static constexpr uint32_t kResponseNotFull = 1 << 3;
+
+// A pair of sync queues, i.e. a writer and a reader object of the same FMQ.
+template <typename T>
+struct SyncQueue {
+  QueueId writer_id;
+  QueueId reader_id;
+  uint32_t not_empty;
+  uint32_t not_full;
+};
+
+// Creates a sync queue of queue_size items, returns false on failure.
+template <typename T>
+static bool CreateSyncQueue(VtsFmqDriver* driver, size_t queue_size,
+                            bool blocking, SyncQueue<T>* queue) {
+  queue->writer_id = driver->CreateFmq<T, kSynchronizedReadWrite>(
+      kElementType, queue_size, blocking);
+  if (queue->writer_id == kInvalidQueueId) return false;
+  queue->reader_id = driver->CreateFmq<T, kSynchronizedReadWrite>(
+      kElementType, queue->writer_id, false);
+  return queue->reader_id != kInvalidQueueId;
+}
+
+// Writes data_size items to the queue, waiting for space as per mode.
+template <typename T>
+static bool WriteSyncQueue(VtsFmqDriver* driver, const SyncQueue<T>& queue,
+                           WaitMode mode, atomic<uint32_t>* event_flag_word,
+                           T* data, size_t data_size,
+                           const atomic<bool>& stop) {
+  while (!stop.load(memory_order_relaxed)) {
+    bool success = false;
+    switch (mode) {
+      case kWaitSpin:
+        success = driver->WriteFmq<T, kSynchronizedReadWrite>(
+            kElementType, queue.writer_id, data, data_size);
+        break;
+      case kWaitBlocking:
+        success = driver->WriteFmqBlocking<T, kSynchronizedReadWrite>(
+            kElementType, queue.writer_id, data, data_size, kTimeOutNanos);
+        break;
+      case kWaitEventFlag:
+        success = driver->WriteFmqBlocking<T, kSynchronizedReadWrite>(
+            kElementType, queue.writer_id, data, data_size, queue.not_full,
+            queue.not_empty, kTimeOutNanos, event_flag_word);
+        break;
+    }
+    if (success) return true;
+  }
+  return false;
+}
+
+// Reads data_size items from the queue, waiting for data as per mode.
+template <typename T>
+static bool ReadSyncQueue(VtsFmqDriver* driver, const SyncQueue<T>& queue,
+                          WaitMode mode, atomic<uint32_t>* event_flag_word,
+                          T* data, size_t data_size,
+                          const atomic<bool>& stop) {
+  while (!stop.load(memory_order_relaxed)) {
+    bool success = false;
+    switch (mode) {
+      case kWaitSpin:
+        success = driver->ReadFmq<T, kSynchronizedReadWrite>(
+            kElementType, queue.reader_id, data, data_size);
+        break;
+      case kWaitBlocking:
+        success = driver->ReadFmqBlocking<T, kSynchronizedReadWrite>(
+            kElementType, queue.reader_id, data, data_size, kTimeOutNanos);
+        break;
+      case kWaitEventFlag:
+        success = driver->ReadFmqBlocking<T, kSynchronizedReadWrite>(
+            kElementType, queue.reader_id, data, data_size, queue.not_full,
+            queue.not_empty, kTimeOutNanos, event_flag_word);
+        break;
+    }
+    if (success) return true;
+  }
+  return false;
+}
+
+// Reports the items and bytes moved by the benchmark.
+template <typename T>
+static void SetProcessed(benchmark::State& state, size_t items_per_iteration) {
+  state.SetItemsProcessed(state.iterations() * items_per_iteration);
+  state.SetBytesProcessed(state.iterations() * items_per_iteration *
+                          sizeof(T));
+}
+
+// Writes then reads back a batch of items in one thread.
+// Args: number of items in the queue, number of items in a batch.
+template <typename T, hardware::MQFlavor flavor>
+static void BM_DriverWriteRead(benchmark::State& state) {
+  size_t queue_size = state.range(0);
+  size_t batch_size = state.range(1);
+  VtsFmqDriver driver;
+  QueueId writer_id =
+      driver.CreateFmq<T, flavor>(kElementType, queue_size, false);
+  QueueId reader_id = driver.CreateFmq<T, flavor>(kElementType, writer_id,
+                                                  false);
+  vector<T> write_data(batch_size);
+  vector<T> read_data(batch_size);
+  while (state.KeepRunning()) {
+    if (!driver.WriteFmq<T, flavor>(kElementType, writer_id,
+                                    write_data.data(), batch_size) ||
+        !driver.ReadFmq<T, flavor>(kElementType, reader_id, read_data.data(),
+                                   batch_size)) {
+      state.SkipWithError("failed to write or read the queue.");
+      break;
+    }
+  }
+  SetProcessed<T>(state, batch_size);
+}
+
+// Streams batches of items from the benchmark thread to a reader thread.
+// Args: number of items in the queue, number of items in a batch, WaitMode
+// other than kWaitEventFlag.
+template <typename T>
+static void BM_DriverSyncThroughput(benchmark::State& state) {
+  size_t queue_size = state.range(0);
+  size_t batch_size = state.range(1);
+  WaitMode mode = static_cast<WaitMode>(state.range(2));
+  VtsFmqDriver driver;
+  SyncQueue<T> queue;
+  if (!CreateSyncQueue(&driver, queue_size, mode == kWaitBlocking, &queue)) {
+    state.SkipWithError("failed to create the queue.");
+    return;
+  }
+
+  atomic<bool> stop(false);
+  size_t batch_count = state.max_iterations;
+  thread reader([&]() {
+    vector<T> read_data(batch_size);
+    for (size_t i = 0; i < batch_count; i++) {
+      if (!ReadSyncQueue(&driver, queue, mode, nullptr, read_data.data(),
+                         batch_size, stop)) {
+        break;
+      }
+    }
+  });
+
+  vector<T> write_data(batch_size);
+  while (state.KeepRunning()) {
+    if (!WriteSyncQueue(&driver, queue, mode, nullptr, write_data.data(),
+                        batch_size, stop)) {
+      state.SkipWithError("failed to write the queue.");
+      break;
+    }
+  }
+  if (state.error_occurred()) stop = true;
+  reader.join();
+  SetProcessed<T>(state, batch_size);
+}
+
+// Sends one item to an echo thread and waits for it to come back.
+// Args: WaitMode.
+template <typename T>
+static void BM_DriverRoundTrip(benchmark::State& state) {
+  static constexpr size_t kQueueSize = 16;
+  WaitMode mode = static_cast<WaitMode>(state.range(0));
+  VtsFmqDriver driver;
+  SyncQueue<T> request;
+  SyncQueue<T> response;
+  atomic<uint32_t>* event_flag_word = nullptr;
+  // In kWaitEventFlag mode, both queues share the event flag word of the
+  // request queue.
+  if (!CreateSyncQueue(&driver, kQueueSize, mode != kWaitSpin, &request) ||
+      !CreateSyncQueue(&driver, kQueueSize, mode == kWaitBlocking,
+                       &response) ||
+      (mode == kWaitEventFlag &&
+       !driver.GetEventFlagWord<T, kSynchronizedReadWrite>(
+           kElementType, request.writer_id, &event_flag_word))) {
+    state.SkipWithError("failed to create the queues.");
+    return;
+  }
+  request.not_empty = kRequestNotEmpty;
+  request.not_full = kRequestNotFull;
+  response.not_empty = kResponseNotEmpty;
+  response.not_full = kResponseNotFull;
+
+  atomic<bool> stop(false);
+  size_t round_trips = state.max_iterations;
+  thread echo([&]() {
+    T item;
+    for (size_t i = 0; i < round_trips; i++) {
+      if (!ReadSyncQueue(&driver, request, mode, event_flag_word, &item, 1,
+                         stop) ||
+          !WriteSyncQueue(&driver, response, mode, event_flag_word, &item, 1,
+                          stop)) {
+        break;
+      }
+    }
+  });
+
+  T item = {};
+  while (state.KeepRunning()) {
+    if (!WriteSyncQueue(&driver, request, mode, event_flag_word, &item, 1,
+                        stop) ||
+        !ReadSyncQueue(&driver, response, mode, event_flag_word, &item, 1,
+                       stop)) {
+      state.SkipWithError("failed to send or receive the item.");
+      break;
+    }
+  }
+  if (state.error_occurred()) stop = true;
+  echo.join();
+  SetProcessed<T>(state, 1);
+}
+
+// Writes a batch of items to an unsync queue and reads it from each reader.
+// Args: number of readers, number of items in a batch.
+template <typename T>
+static void BM_DriverUnsyncMultiReader(benchmark::State& state) {
+  static constexpr size_t kQueueSize = 1024;
+  size_t reader_count = state.range(0);
+  size_t batch_size = state.range(1);
+  VtsFmqDriver driver;
+  QueueId writer_id = driver.CreateFmq<T, kUnsynchronizedWrite>(
+      kElementType, kQueueSize, false);
+  vector<QueueId> reader_ids;
+  for (size_t i = 0; i < reader_count; i++) {
+    reader_ids.push_back(driver.CreateFmq<T, kUnsynchronizedWrite>(
+        kElementType, writer_id, false));
+  }
+  vector<T> write_data(batch_size);
+  vector<T> read_data(batch_size);
+  while (state.KeepRunning()) {
+    bool success = driver.WriteFmq<T, kUnsynchronizedWrite>(
+        kElementType, writer_id, write_data.data(), batch_size);
+    for (QueueId reader_id : reader_ids) {
+      success = success &&
+                driver.ReadFmq<T, kUnsynchronizedWrite>(
+                    kElementType, reader_id, read_data.data(), batch_size);
+    }
+    if (!success) {
+      state.SkipWithError("failed to write or read the queue.");
+      break;
+    }
+  }
+  SetProcessed<T>(state, batch_size * reader_count);
+}
+
+// Sets the value of an item in a FmqRequestMessage.
+static void SetScalarValue(ScalarDataValueMessage* value, uint8_t item) {
+  value->set_uint8_t(item);
+}
+
+static void SetScalarValue(ScalarDataValueMessage* value, uint32_t item) {
+  value->set_uint32_t(item);
+}
+
+static void SetScalarValue(ScalarDataValueMessage* value, uint64_t item) {
+  value->set_uint64_t(item);
+}
+
+// Returns the data type of the queues of T in FmqRequestMessage.
+template <typename T>
+static const char* ScalarDataType();
+
+template <>
+const char* ScalarDataType<uint8_t>() {
+  return "uint8_t";
+}
+
+template <>
+const char* ScalarDataType<uint32_t>() {
+  return "uint32_t";
+}
+
+template <>
+const char* ScalarDataType<uint64_t>() {
+  return "uint64_t";
+}
+
+// Sends a request to the resource manager, returns whether it succeeded.
+static bool SendFmqRequest(VtsResourceManager* manager,
+                           const FmqRequestMessage& fmq_request,
+                           FmqResponseMessage* fmq_response) {
+  fmq_response->Clear();
+  manager->ProcessFmqCommand(fmq_request, fmq_response);
+  return fmq_response->success();
+}
+
+// Writes then reads back a batch of items through the resource manager, as
+// the host side does.
+// Args: number of items in a batch, whether to send the items as raw bytes.
+template <typename T>
+static void BM_ManagerWriteRead(benchmark::State& state) {
+  size_t batch_size = state.range(0);
+  bool raw = state.range(1);
+  VtsResourceManager manager;
+  FmqResponseMessage fmq_response;
+
+  FmqRequestMessage create_request;
+  create_request.set_operation(FMQ_CREATE);
+  create_request.set_data_type(ScalarDataType<T>());
+  create_request.set_sync(true);
+  create_request.set_queue_size(batch_size * 2);
+  create_request.set_blocking(false);
+  if (!SendFmqRequest(&manager, create_request, &fmq_response)) {
+    state.SkipWithError("failed to create the queue.");
+    return;
+  }
+  int writer_id = fmq_response.queue_id();
+  create_request.set_queue_id(writer_id);
+  if (!SendFmqRequest(&manager, create_request, &fmq_response)) {
+    state.SkipWithError("failed to create the reader.");
+    return;
+  }
+  int reader_id = fmq_response.queue_id();
+
+  FmqRequestMessage write_request;
+  write_request.set_operation(FMQ_WRITE);
+  write_request.set_data_type(ScalarDataType<T>());
+  write_request.set_sync(true);
+  write_request.set_queue_id(writer_id);
+  vector<T> write_data(batch_size);
+  for (size_t i = 0; i < batch_size; i++) {
+    write_data[i] = static_cast<T>(i);
+  }
+  if (raw) {
+    write_request.set_write_data_raw(write_data.data(),
+                                     batch_size * sizeof(T));
+  } else {
+    for (size_t i = 0; i < batch_size; i++) {
+      SetScalarValue(write_request.add_write_data()->mutable_scalar_value(),
+                     write_data[i]);
+    }
+  }
+
+  FmqRequestMessage read_request;
+  read_request.set_operation(FMQ_READ);
+  read_request.set_data_type(ScalarDataType<T>());
+  read_request.set_sync(true);
+  read_request.set_queue_id(reader_id);
+  read_request.set_read_data_size(batch_size);
+  read_request.set_raw_read_data(raw);
+
+  while (state.KeepRunning()) {
+    if (!SendFmqRequest(&manager, write_request, &fmq_response) ||
+        !SendFmqRequest(&manager, read_request, &fmq_response)) {
+      state.SkipWithError("failed to write or read the queue.");
+      break;
+    }
+  }
+  SetProcessed<T>(state, batch_size);
+}
+
+// Adds queue sizes from 16 to 4096 items, each with a batch of one item and
+// a batch of half the queue.
+static void QueueSizeArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int queue_size = 16; queue_size <= 4096; queue_size *= 16) {
+    benchmark->Args({queue_size, 1});
+    benchmark->Args({queue_size, queue_size / 2});
+  }
+}
+
+// Adds the arguments of QueueSizeArgs in spin and blocking modes.
+static void ThroughputArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int queue_size = 16; queue_size <= 4096; queue_size *= 16) {
+    for (int mode : {kWaitSpin, kWaitBlocking}) {
+      benchmark->Args({queue_size, 1, mode});
+      benchmark->Args({queue_size, queue_size / 2, mode});
+    }
+  }
+}
+
+// Adds 1, 4 and 16 readers, each with a batch of 1 and 256 items.
+static void MultiReaderArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int reader_count = 1; reader_count <= 16; reader_count *= 4) {
+    benchmark->Args({reader_count, 1});
+    benchmark->Args({reader_count, 256});
+  }
+}
+
+// Adds batches of 1, 64 and 1024 items, sent as proto values and raw bytes.
+static void ManagerArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int batch_size = 1; batch_size <= 1024; batch_size *= 64) {
+    benchmark->Args({batch_size, 0});
+    benchmark->Args({batch_size, 1});
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, uint8_t, kSynchronizedReadWrite)
+    ->Apply(QueueSizeArgs);
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, uint64_t, kSynchronizedReadWrite)
+    ->Apply(QueueSizeArgs);
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, Element<64>, kSynchronizedReadWrite)
+    ->Apply(QueueSizeArgs);
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, Element<512>, kSynchronizedReadWrite)
+    ->Apply(QueueSizeArgs);
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, Element<4096>, kSynchronizedReadWrite)
+    ->Apply(QueueSizeArgs);
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, uint8_t, kUnsynchronizedWrite)
+    ->Apply(QueueSizeArgs);
+BENCHMARK_TEMPLATE(BM_DriverWriteRead, Element<4096>, kUnsynchronizedWrite)
+    ->Apply(QueueSizeArgs);
+
+BENCHMARK_TEMPLATE(BM_DriverSyncThroughput, uint8_t)
+    ->Apply(ThroughputArgs)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_DriverSyncThroughput, Element<64>)
+    ->Apply(ThroughputArgs)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_DriverSyncThroughput, Element<4096>)
+    ->Apply(ThroughputArgs)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_DriverRoundTrip, uint8_t)
+    ->DenseRange(kWaitSpin, kWaitEventFlag)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_DriverRoundTrip, Element<4096>)
+    ->DenseRange(kWaitSpin, kWaitEventFlag)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_DriverUnsyncMultiReader, uint8_t)
+    ->Apply(MultiReaderArgs);
+BENCHMARK_TEMPLATE(BM_DriverUnsyncMultiReader, Element<512>)
+    ->Apply(MultiReaderArgs);
+
+BENCHMARK_TEMPLATE(BM_ManagerWriteRead, uint8_t)->Apply(ManagerArgs);
+BENCHMARK_TEMPLATE(BM_ManagerWriteRead, uint32_t)->Apply(ManagerArgs);
+BENCHMARK_TEMPLATE(BM_ManagerWriteRead, uint64_t)->Apply(ManagerArgs);
+
+}  // namespace vts
+}  // namespace android
+
+BENCHMARK_MAIN();
@@ -26,6 +26,8 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <thread>
+
 #include <fmq/MessageQueue.h>
 #include <gtest/gtest.h>
 
@@ -61,8 +63,6 @@ class SyncReadWrites : public ::testing::Test {
 };
 
 // A test that initializes a single writer and a single reader.
-// TODO: add tests for blocking between multiple queues later when there is more
-// use case.
 class BlockingReadWrites : public ::testing::Test {
  protected:
   virtual void SetUp() {
@@ -258,6 +258,50 @@ TEST_F(SyncReadWrites, WrongType) {
       "uint32_t", writer_id_, write_data, DATA_SIZE)));
 }
 
+// Pass the wrong C++ type, flavor or queue ID.
+TEST_F(SyncReadWrites, WrongQueue) {
+  static constexpr size_t DATA_SIZE = 2;
+  uint16_t write_data[DATA_SIZE];
+  uint32_t write_data32[DATA_SIZE] = {1, 2};
+
+  // initialize data to transfer
+  InitData(write_data, DATA_SIZE);
+
+  // attempt to write as uint32_t
+  ASSERT_FALSE((manager_.WriteFmq<uint32_t, kSynchronizedReadWrite>(
+      "uint16_t", writer_id_, write_data32, DATA_SIZE)));
+  // attempt to write as an unsynchronized queue
+  ASSERT_FALSE((manager_.WriteFmq<uint16_t, kUnsynchronizedWrite>(
+      "uint16_t", writer_id_, write_data, DATA_SIZE)));
+  // attempt to use queues that don't exist
+  ASSERT_FALSE((manager_.IsValid<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_ + 1)));
+  ASSERT_FALSE((manager_.IsValid<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", kInvalidQueueId)));
+}
+
+// Tests the queues created past the first chunk of the registry.
+TEST_F(SyncReadWrites, ManyQueues) {
+  static constexpr int NUM_QUEUES = 600;
+  QueueId last_id = reader_id_;
+  for (int i = 0; i < NUM_QUEUES; i++) {
+    QueueId queue_id = manager_.CreateFmq<uint16_t, kSynchronizedReadWrite>(
+        "uint16_t", writer_id_);
+    ASSERT_EQ(last_id + 1, queue_id);
+    last_id = queue_id;
+  }
+
+  // write from the writer, and read from the last reader.
+  uint16_t write_data[4];
+  uint16_t read_data[4];
+  InitData(write_data, 4);
+  ASSERT_TRUE((manager_.WriteFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", writer_id_, write_data, 4)));
+  ASSERT_TRUE((manager_.ReadFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", last_id, read_data, 4)));
+  ASSERT_EQ(0, memcmp(read_data, write_data, sizeof(write_data)));
+}
+
 // Tests consecutive interaction between writer and reader.
 // Reader immediately reads back what writer writes.
 TEST_F(SyncReadWrites, ConsecutiveReadWrite) {
@@ -284,6 +328,59 @@ TEST_F(SyncReadWrites, ConsecutiveReadWrite) {
   ASSERT_EQ(0, reader_available_reads);
 }
 
+// Tests zero-copy writes and reads through memory transactions.
+TEST_F(SyncReadWrites, ZeroCopyReadWrite) {
+  static constexpr size_t DATA_SIZE = 64;
+  uint16_t write_data[DATA_SIZE];
+  uint16_t read_data[DATA_SIZE];
+  InitData(write_data, DATA_SIZE);
+
+  MessageQueue<uint16_t, kSynchronizedReadWrite>::MemTransaction transaction;
+  ASSERT_TRUE((manager_.BeginWriteFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", writer_id_, DATA_SIZE, &transaction)));
+  ASSERT_TRUE(transaction.copyTo(write_data, 0, DATA_SIZE));
+  ASSERT_TRUE((manager_.CommitWriteFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", writer_id_, DATA_SIZE)));
+
+  ASSERT_TRUE((manager_.BeginReadFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_, DATA_SIZE, &transaction)));
+  ASSERT_TRUE(transaction.copyFrom(read_data, 0, DATA_SIZE));
+  ASSERT_TRUE((manager_.CommitReadFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_, DATA_SIZE)));
+  ASSERT_EQ(0, memcmp(write_data, read_data, DATA_SIZE * sizeof(uint16_t)));
+
+  // nothing left to read
+  ASSERT_FALSE((manager_.BeginReadFmq<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_, 1, &transaction)));
+}
+
+// Tests writing and reading several transactions in one call.
+// The queue of 2048 items holds 32 transactions of 64 items.
+TEST_F(SyncReadWrites, ReadWriteTransactions) {
+  static constexpr size_t DATA_SIZE = 64;
+  uint16_t write_data[DATA_SIZE];
+  uint16_t read_data[DATA_SIZE];
+  InitData(write_data, DATA_SIZE);
+  size_t count;
+
+  ASSERT_TRUE((manager_.WriteFmqTransactions<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", writer_id_, write_data, DATA_SIZE, 40, &count)));
+  ASSERT_EQ(32, count);
+
+  ASSERT_TRUE((manager_.ReadFmqTransactions<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_, read_data, DATA_SIZE, 10, &count)));
+  ASSERT_EQ(10, count);
+  ASSERT_TRUE((manager_.ReadFmqTransactions<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_, read_data, DATA_SIZE, 40, &count)));
+  ASSERT_EQ(22, count);
+  ASSERT_EQ(0, memcmp(write_data, read_data, DATA_SIZE * sizeof(uint16_t)));
+
+  size_t reader_available_reads;
+  ASSERT_TRUE((manager_.AvailableToRead<uint16_t, kSynchronizedReadWrite>(
+      "uint16_t", reader_id_, &reader_available_reads)));
+  ASSERT_EQ(0, reader_available_reads);
+}
+
 // Tests reader waiting for data to be available.
 // Writer waits for 0.05s and writes the data.
 // Reader blocks for at most 0.1s and reads the data if it is available.
@@ -321,6 +418,55 @@ TEST_F(BlockingReadWrites, BlockingTimeOut) {
       "uint16_t", reader_id_, read_data, DATA_SIZE, 50 * 1000000)));
 }
 
+// Tests a queue without an event flag of its own blocking on the event flag
+// of another queue of a different type, as in a group of queues signaled
+// over one event flag.
+TEST_F(BlockingReadWrites, SharedEventFlag) {
+  static constexpr uint32_t kNotFull = 1 << 0;
+  static constexpr uint32_t kNotEmpty = 1 << 1;
+  static constexpr size_t kCommandQueueSize = 16;
+  QueueId command_writer_id =
+      manager_.CreateFmq<uint32_t, kSynchronizedReadWrite>(
+          "uint32_t", kCommandQueueSize, false);
+  ASSERT_NE(command_writer_id, -1);
+  QueueId command_reader_id =
+      manager_.CreateFmq<uint32_t, kSynchronizedReadWrite>("uint32_t",
+                                                           command_writer_id);
+  ASSERT_NE(command_reader_id, -1);
+  atomic<uint32_t>* event_flag_word;
+  ASSERT_FALSE(manager_.GetEventFlagWord(command_writer_id, &event_flag_word));
+  ASSERT_TRUE(manager_.GetEventFlagWord(writer_id_, &event_flag_word));
+
+  // The reader blocks until the writer sets kNotEmpty, 0.05s later.
+  uint32_t write_command = 42;
+  thread writer([this, command_writer_id, event_flag_word, &write_command] {
+    struct timespec writer_wait_time = {0, 50 * 1000000};
+    nanosleep(&writer_wait_time, NULL);
+    ASSERT_TRUE((manager_.WriteFmqBlocking<uint32_t, kSynchronizedReadWrite>(
+        "uint32_t", command_writer_id, &write_command, 1, kNotFull, kNotEmpty,
+        100 * 1000000, event_flag_word)));
+  });
+  uint32_t read_command = 0;
+  ASSERT_TRUE((manager_.ReadFmqBlocking<uint32_t, kSynchronizedReadWrite>(
+      "uint32_t", command_reader_id, &read_command, 1, kNotFull, kNotEmpty,
+      1000 * 1000000, event_flag_word)));
+  writer.join();
+  ASSERT_EQ(write_command, read_command);
+
+  // The read set kNotFull, which is consumed by the first wait only.
+  uint32_t woken_bits;
+  ASSERT_TRUE(
+      manager_.WaitEventFlag(writer_id_, kNotFull, 1000000, &woken_bits));
+  ASSERT_EQ(kNotFull, woken_bits);
+  ASSERT_FALSE(
+      manager_.WaitEventFlag(writer_id_, kNotFull, 1000000, &woken_bits));
+  // The reader queue shares the event flag of the writer queue.
+  ASSERT_TRUE(manager_.WakeEventFlag(writer_id_, kNotEmpty));
+  ASSERT_TRUE(
+      manager_.WaitEventFlag(reader_id_, kNotEmpty, 1000000, &woken_bits));
+  ASSERT_EQ(kNotEmpty, woken_bits);
+}
+
 // Tests two readers can both read back what writer writes correctly.
 TEST_F(UnsynchronizedWrites, ReadWriteSuccess) {
   static constexpr size_t DATA_SIZE = 64;
@@ -17,11 +17,16 @@
 
 #include "hidl_handle_driver/VtsHidlHandleDriver.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
 #include <vector>
 
 #include <android-base/logging.h>
@@ -33,11 +38,71 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// Repeats a read or write system call until num_bytes are transferred, the
+// end of the file is reached, or an error other than EINTR occurs.
+// transfer is called with the number of bytes done and left, and returns
+// the result of the system call.
+//
+// @return number of bytes transferred, -1 if none is and an error occurs.
+template <typename TransferFn>
+static ssize_t TransferFully(size_t num_bytes, TransferFn transfer) {
+  size_t done = 0;
+  while (done < num_bytes) {
+    ssize_t result = transfer(done, num_bytes - done);
+    if (result == -1) {
+      if (errno == EINTR) continue;
+      return done > 0 ? done : -1;
+    }
+    if (result == 0) break;  // end of file
+    done += result;
+  }
+  return done;
+}
+
+// Repeats a readv or writev system call until all the buffers in iov are
+// transferred, the end of the file is reached, or an error other than EINTR
+// occurs. transfer is called with the buffers left and their count.
+//
+// @return number of bytes transferred, -1 if none is and an error occurs.
+template <typename TransferFn>
+static ssize_t TransferVectorFully(const struct iovec* iov, int iov_count,
+                                   TransferFn transfer) {
+  vector<struct iovec> left(iov, iov + iov_count);
+  size_t first = 0;
+  size_t done = 0;
+  while (first < left.size()) {
+    if (left[first].iov_len == 0) {
+      first++;
+      continue;
+    }
+    int count = min<size_t>(left.size() - first, IOV_MAX);
+    ssize_t result = transfer(&left[first], count);
+    if (result == -1) {
+      if (errno == EINTR) continue;
+      return done > 0 ? done : -1;
+    }
+    if (result == 0) break;  // end of file
+    done += result;
+    // Skips the bytes transferred, possibly in the middle of a buffer.
+    for (size_t remaining = result; remaining > 0;) {
+      size_t step = min(remaining, left[first].iov_len);
+      left[first].iov_base = static_cast<char*>(left[first].iov_base) + step;
+      left[first].iov_len -= step;
+      remaining -= step;
+      if (left[first].iov_len == 0) first++;
+    }
+  }
+  return done;
+}
+
+FileMapping::~FileMapping() { munmap(address, length); }
+
 VtsHidlHandleDriver::VtsHidlHandleDriver() {}
 
 VtsHidlHandleDriver::~VtsHidlHandleDriver() {
   // clears objects in the map.
-  hidl_handle_map_.clear();
+  file_mappings_.clear();
+  hidl_handle_map_.Clear();
 }
 
 HandleId VtsHidlHandleDriver::CreateFileHandle(string filepath, int flag,
@@ -74,35 +139,65 @@ HandleId VtsHidlHandleDriver::CreateFileHandle(string filepath, int flag,
   unique_ptr<hidl_handle> hidl_handle_ptr(new hidl_handle());
   hidl_handle_ptr->setTo(native_handle, true);
   // Insert the handle object into the map.
-  map_mutex_.lock();
-  size_t new_handle_id = hidl_handle_map_.size();
-  hidl_handle_map_.emplace(new_handle_id, move(hidl_handle_ptr));
-  map_mutex_.unlock();
-  return new_handle_id;
+  return hidl_handle_map_.Insert(move(hidl_handle_ptr));
 }
 
 bool VtsHidlHandleDriver::UnregisterHidlHandle(HandleId handle_id) {
-  // true flag to indicate we want smart pointer to release ownership.
-  hidl_handle* handle_obj = FindHandle(handle_id, true);
-  if (handle_obj == nullptr) return false;  // unable to find handle object.
-  delete handle_obj;  // This closes open file descriptors in the handle object.
+  UnmapFile(handle_id);
+  // Deleting the handle object closes its open file descriptors.
+  if (hidl_handle_map_.Remove(handle_id) == nullptr) {
+    LOG(ERROR) << "Unable to find hidl_handle associated with handle_id "
+               << handle_id;
+    return false;
+  }
   return true;
 }
 
 ssize_t VtsHidlHandleDriver::ReadFile(HandleId handle_id, void* read_data,
                                       size_t num_bytes) {
-  hidl_handle* handle_obj = FindHandle(handle_id);
-  if (handle_obj == nullptr) return -1;
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Read from", &handle);
+  if (fd == -1) return -1;
+  char* data = static_cast<char*>(read_data);
+  ssize_t read_result =
+      TransferFully(num_bytes, [&](size_t done, size_t left) {
+        return read(fd, data + done, left);
+      });
+  if (read_result == -1) {
+    LOG(ERROR) << "Read from file failure: read from file with descriptor "
+               << fd << " failure: " << strerror(errno);
+  }
+  return read_result;
+}
 
-  const native_handle_t* native_handle = handle_obj->getNativeHandle();
-  // Check if a file descriptor exists.
-  if (native_handle->numFds == 0) {
-    LOG(ERROR) << "Read from file failure: handle object with id " << handle_id
-               << " has no file descriptor.";
-    return -1;
+ssize_t VtsHidlHandleDriver::ReadFileAt(HandleId handle_id, void* read_data,
+                                        size_t num_bytes, off_t offset) {
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Read from", &handle);
+  if (fd == -1) return -1;
+  char* data = static_cast<char*>(read_data);
+  ssize_t read_result =
+      TransferFully(num_bytes, [&](size_t done, size_t left) {
+        return pread(fd, data + done, left, offset + done);
+      });
+  if (read_result == -1) {
+    LOG(ERROR) << "Read from file failure: read from file with descriptor "
+               << fd << " at offset " << offset
+               << " failure: " << strerror(errno);
   }
-  int fd = native_handle->data[0];
-  ssize_t read_result = read(fd, read_data, num_bytes);
+  return read_result;
+}
+
+ssize_t VtsHidlHandleDriver::ReadFileVector(HandleId handle_id,
+                                            const struct iovec* iov,
+                                            int iov_count) {
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Read from", &handle);
+  if (fd == -1) return -1;
+  ssize_t read_result = TransferVectorFully(
+      iov, iov_count, [&](const struct iovec* left, int count) {
+        return readv(fd, left, count);
+      });
   if (read_result == -1) {
     LOG(ERROR) << "Read from file failure: read from file with descriptor "
                << fd << " failure: " << strerror(errno);
@@ -113,18 +208,49 @@ ssize_t VtsHidlHandleDriver::ReadFile(HandleId handle_id, void* read_data,
 ssize_t VtsHidlHandleDriver::WriteFile(HandleId handle_id,
                                        const void* write_data,
                                        size_t num_bytes) {
-  hidl_handle* handle_obj = FindHandle(handle_id);
-  if (handle_obj == nullptr) return -1;
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Write to", &handle);
+  if (fd == -1) return -1;
+  const char* data = static_cast<const char*>(write_data);
+  ssize_t write_result =
+      TransferFully(num_bytes, [&](size_t done, size_t left) {
+        return write(fd, data + done, left);
+      });
+  if (write_result == -1) {
+    LOG(ERROR) << "Write to file failure: write to file with descriptor " << fd
+               << " failure: " << strerror(errno);
+  }
+  return write_result;
+}
 
-  const native_handle_t* native_handle = handle_obj->getNativeHandle();
-  // Check if a file descriptor exists.
-  if (native_handle->numFds == 0) {
-    LOG(ERROR) << "Write to file failure: handle object with id " << handle_id
-               << " has no file descriptor.";
-    return -1;
+ssize_t VtsHidlHandleDriver::WriteFileAt(HandleId handle_id,
+                                         const void* write_data,
+                                         size_t num_bytes, off_t offset) {
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Write to", &handle);
+  if (fd == -1) return -1;
+  const char* data = static_cast<const char*>(write_data);
+  ssize_t write_result =
+      TransferFully(num_bytes, [&](size_t done, size_t left) {
+        return pwrite(fd, data + done, left, offset + done);
+      });
+  if (write_result == -1) {
+    LOG(ERROR) << "Write to file failure: write to file with descriptor " << fd
+               << " at offset " << offset << " failure: " << strerror(errno);
   }
-  int fd = native_handle->data[0];
-  ssize_t write_result = write(fd, write_data, num_bytes);
+  return write_result;
+}
+
+ssize_t VtsHidlHandleDriver::WriteFileVector(HandleId handle_id,
+                                             const struct iovec* iov,
+                                             int iov_count) {
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Write to", &handle);
+  if (fd == -1) return -1;
+  ssize_t write_result = TransferVectorFully(
+      iov, iov_count, [&](const struct iovec* left, int count) {
+        return writev(fd, left, count);
+      });
   if (write_result == -1) {
     LOG(ERROR) << "Write to file failure: write to file with descriptor " << fd
                << " failure: " << strerror(errno);
@@ -132,43 +258,135 @@ ssize_t VtsHidlHandleDriver::WriteFile(HandleId handle_id,
   return write_result;
 }
 
+bool VtsHidlHandleDriver::MapFile(HandleId handle_id, off_t offset,
+                                  size_t length) {
+  shared_ptr<hidl_handle> handle;
+  int fd = FindFileDescriptor(handle_id, "Map", &handle);
+  if (fd == -1) return false;
+  if (length == 0) {
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1 || file_stat.st_size <= offset) {
+      LOG(ERROR) << "Map file failure: nothing to map in file with "
+                 << "descriptor " << fd << " from offset " << offset;
+      return false;
+    }
+    length = file_stat.st_size - offset;
+  }
+  int flags = fcntl(fd, F_GETFL);
+  if (flags == -1) {
+    LOG(ERROR) << "Map file failure: unable to get the flags of file with "
+               << "descriptor " << fd << ": " << strerror(errno);
+    return false;
+  }
+  bool writable = (flags & O_ACCMODE) == O_RDWR;
+  void* address = mmap(nullptr, length, PROT_READ | (writable ? PROT_WRITE : 0),
+                       MAP_SHARED, fd, offset);
+  if (address == MAP_FAILED) {
+    LOG(ERROR) << "Map file failure: map file with descriptor " << fd
+               << " failure: " << strerror(errno);
+    return false;
+  }
+  unique_ptr<FileMapping> mapping(new FileMapping{address, length, writable});
+  lock_guard<shared_mutex> lock(mappings_lock_);
+  file_mappings_[handle_id] = move(mapping);
+  return true;
+}
+
+bool VtsHidlHandleDriver::UnmapFile(HandleId handle_id) {
+  lock_guard<shared_mutex> lock(mappings_lock_);
+  return file_mappings_.erase(handle_id) > 0;
+}
+
+bool VtsHidlHandleDriver::ReadMappedBytes(HandleId handle_id, char* read_data,
+                                          uint64_t length, uint64_t start) {
+  shared_lock<shared_mutex> lock(mappings_lock_);
+  char* mapped_data = FindMappedRange(handle_id, start, length, false);
+  if (mapped_data == nullptr) return false;
+  memcpy(read_data, mapped_data, length);
+  return true;
+}
+
+bool VtsHidlHandleDriver::UpdateMappedBytes(HandleId handle_id,
+                                            const char* write_data,
+                                            uint64_t length, uint64_t start) {
+  shared_lock<shared_mutex> lock(mappings_lock_);
+  char* mapped_data = FindMappedRange(handle_id, start, length, true);
+  if (mapped_data == nullptr) return false;
+  memcpy(mapped_data, write_data, length);
+  return true;
+}
+
+bool VtsHidlHandleDriver::GetMappedRangeAddress(HandleId handle_id,
+                                                uint64_t start,
+                                                uint64_t length,
+                                                size_t* result) {
+  shared_lock<shared_mutex> lock(mappings_lock_);
+  char* mapped_data = FindMappedRange(handle_id, start, length, false);
+  if (mapped_data == nullptr) return false;
+  *result = reinterpret_cast<size_t>(mapped_data);
+  return true;
+}
+
 HandleId VtsHidlHandleDriver::RegisterHidlHandle(size_t hidl_handle_address) {
   unique_ptr<hidl_handle> hidl_handle_ptr(
       reinterpret_cast<hidl_handle*>(hidl_handle_address));
-
-  map_mutex_.lock();
-  size_t new_handle_id = hidl_handle_map_.size();
-  hidl_handle_map_.emplace(new_handle_id, move(hidl_handle_ptr));
-  map_mutex_.unlock();
-  return new_handle_id;
+  return hidl_handle_map_.Insert(move(hidl_handle_ptr));
 }
 
 bool VtsHidlHandleDriver::GetHidlHandleAddress(HandleId handle_id,
                                                size_t* result) {
-  hidl_handle* handle = FindHandle(handle_id);
+  shared_ptr<hidl_handle> handle = FindHandle(handle_id);
   if (handle == nullptr) return false;  // unable to find handle object.
-  *result = reinterpret_cast<size_t>(handle);
+  *result = reinterpret_cast<size_t>(handle.get());
   return true;
 }
 
-hidl_handle* VtsHidlHandleDriver::FindHandle(HandleId handle_id, bool release) {
-  hidl_handle* handle;
-  map_mutex_.lock();
-  auto iterator = hidl_handle_map_.find(handle_id);
-  if (iterator == hidl_handle_map_.end()) {
+shared_ptr<hidl_handle> VtsHidlHandleDriver::FindHandle(HandleId handle_id) {
+  shared_ptr<hidl_handle> handle = hidl_handle_map_.Find(handle_id);
+  if (handle == nullptr) {
     LOG(ERROR) << "Unable to find hidl_handle associated with handle_id "
                << handle_id;
-    map_mutex_.unlock();
-    return nullptr;
   }
-  // During unregistering a handle, unique_ptr releases ownership.
-  if (release)
-    handle = (iterator->second).release();
-  else
-    handle = (iterator->second).get();
-  map_mutex_.unlock();
   return handle;
 }
 
+int VtsHidlHandleDriver::FindFileDescriptor(HandleId handle_id,
+                                            const char* operation,
+                                            shared_ptr<hidl_handle>* handle) {
+  *handle = FindHandle(handle_id);
+  if (*handle == nullptr) return -1;
+
+  const native_handle_t* native_handle = (*handle)->getNativeHandle();
+  // Check if a file descriptor exists.
+  if (native_handle == nullptr || native_handle->numFds == 0) {
+    LOG(ERROR) << operation << " file failure: handle object with id "
+               << handle_id << " has no file descriptor.";
+    return -1;
+  }
+  return native_handle->data[0];
+}
+
+char* VtsHidlHandleDriver::FindMappedRange(HandleId handle_id, uint64_t start,
+                                           uint64_t length, bool write) {
+  auto iterator = file_mappings_.find(handle_id);
+  if (iterator == file_mappings_.end()) {
+    LOG(ERROR) << "File of handle object with id " << handle_id
+               << " is not mapped.";
+    return nullptr;
+  }
+  FileMapping* mapping = iterator->second.get();
+  if (write && !mapping->writable) {
+    LOG(ERROR) << "File of handle object with id " << handle_id
+               << " is not mapped for writing.";
+    return nullptr;
+  }
+  if (start > mapping->length || length > mapping->length - start) {
+    LOG(ERROR) << "Range [" << start << ", " << start + length
+               << ") is out of the mapping of size " << mapping->length;
+    return nullptr;
+  }
+  return static_cast<char*>(mapping->address) + start;
+}
+
 }  // namespace vts
 }  // namespace android
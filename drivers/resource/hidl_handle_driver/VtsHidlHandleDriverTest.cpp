@@ -23,6 +23,9 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace std;
 
 static constexpr const char* kTestFilePath = "/data/local/tmp/test.txt";
@@ -81,6 +84,54 @@ TEST_F(HidlHandleDriverUnitTest, UnregisterHandle) {
   ASSERT_EQ(handle_driver_.ReadFile(new_id, nullptr, 0), -1);
 }
 
+// Tests creating handles after unregistering others, in a long session.
+TEST_F(HidlHandleDriverUnitTest, RecycleHandleId) {
+  int old_id = handle_driver_.CreateFileHandle(string(kTestFilePath), O_RDONLY,
+                                               0, vector<int>());
+  ASSERT_NE(old_id, -1);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(handle_driver_.UnregisterHidlHandle(old_id));
+    int new_id = handle_driver_.CreateFileHandle(
+        string(kTestFilePath), O_RDONLY, 0, vector<int>());
+    ASSERT_NE(new_id, -1);
+    // The freed id is not reused as is, and doesn't refer to the new handle.
+    ASSERT_NE(new_id, old_id);
+    ASSERT_EQ(handle_driver_.ReadFile(old_id, nullptr, 0), -1);
+    ASSERT_EQ(handle_driver_.ReadFile(new_id, nullptr, 0), 0);
+    old_id = new_id;
+  }
+  ASSERT_TRUE(handle_driver_.UnregisterHidlHandle(old_id));
+  // The existing handles are not affected.
+  ASSERT_EQ(handle_driver_.ReadFile(client2_id_, nullptr, 0), 0);
+}
+
+// Tests looking up handles while others are created and unregistered.
+TEST_F(HidlHandleDriverUnitTest, ConcurrentLookup) {
+  atomic<bool> done(false);
+  atomic<int> failures(0);
+  vector<thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([this, &done, &failures] {
+      while (!done.load()) {
+        if (handle_driver_.ReadFile(client2_id_, nullptr, 0) != 0) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 2000; i++) {
+    int new_id = handle_driver_.CreateFileHandle(
+        string(kTestFilePath), O_RDONLY, 0, vector<int>());
+    ASSERT_NE(new_id, -1);
+    ASSERT_TRUE(handle_driver_.UnregisterHidlHandle(new_id));
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(failures.load(), 0);
+}
+
 // Tests simple read/write operations on the same file from two clients.
 TEST_F(HidlHandleDriverUnitTest, SimpleReadWrite) {
   string write_data = "Hello World!";
@@ -130,5 +181,68 @@ TEST_F(HidlHandleDriverUnitTest, LargeReadWrite) {
   }
 }
 
+// Tests reading and writing at offsets, which doesn't move the file position.
+TEST_F(HidlHandleDriverUnitTest, ReadWriteAt) {
+  const string write_data = "0123456789";
+  ASSERT_EQ(handle_driver_.WriteFile(client1_id_, write_data.c_str(),
+                                     write_data.length()),
+            write_data.length());
+  ASSERT_EQ(handle_driver_.WriteFileAt(client1_id_, "ab", 2, 4), 2);
+
+  char read_data[10];
+  ASSERT_EQ(handle_driver_.ReadFileAt(client2_id_, read_data, 4, 3), 4);
+  ASSERT_EQ(string("3ab6"), string(read_data, 4));
+  // Reads up to the end of the file.
+  ASSERT_EQ(handle_driver_.ReadFileAt(client2_id_, read_data, 10, 8), 2);
+  ASSERT_EQ(string("89"), string(read_data, 2));
+  // The file position of the reader is still at the start.
+  ASSERT_EQ(handle_driver_.ReadFile(client2_id_, read_data, 10), 10);
+  ASSERT_EQ(string("0123ab6789"), string(read_data, 10));
+}
+
+// Tests reading and writing several buffers at once.
+TEST_F(HidlHandleDriverUnitTest, ReadWriteVector) {
+  char part1[] = "Hello";
+  char part2[] = " ";
+  char part3[] = "World!";
+  struct iovec write_iov[] = {
+      {part1, 5}, {part2, 1}, {nullptr, 0}, {part3, 6}};
+  ASSERT_EQ(handle_driver_.WriteFileVector(client1_id_, write_iov, 4), 12);
+
+  char read1[3];
+  char read2[20];
+  struct iovec read_iov[] = {{read1, 3}, {read2, 20}};
+  ASSERT_EQ(handle_driver_.ReadFileVector(client2_id_, read_iov, 2), 12);
+  ASSERT_EQ(string("Hel"), string(read1, 3));
+  ASSERT_EQ(string("lo World!"), string(read2, 9));
+}
+
+// Tests reading and writing a file through its mapping.
+TEST_F(HidlHandleDriverUnitTest, MappedReadWrite) {
+  const string write_data = "Hello World!";
+  ASSERT_EQ(handle_driver_.WriteFile(client1_id_, write_data.c_str(),
+                                     write_data.length()),
+            write_data.length());
+  // client1 is open for read and write, client2 is read only.
+  ASSERT_TRUE(handle_driver_.MapFile(client1_id_, 0, 0));
+  ASSERT_TRUE(handle_driver_.MapFile(client2_id_, 0, write_data.length()));
+
+  ASSERT_TRUE(handle_driver_.UpdateMappedBytes(client1_id_, "J", 1, 6));
+  ASSERT_FALSE(handle_driver_.UpdateMappedBytes(client2_id_, "J", 1, 6));
+  char read_data[12];
+  ASSERT_TRUE(handle_driver_.ReadMappedBytes(client2_id_, read_data, 12));
+  ASSERT_EQ(string("Hello Jorld!"), string(read_data, 12));
+  ASSERT_FALSE(handle_driver_.ReadMappedBytes(client2_id_, read_data, 2, 11));
+
+  size_t address;
+  ASSERT_TRUE(
+      handle_driver_.GetMappedRangeAddress(client2_id_, 6, 6, &address));
+  ASSERT_EQ(0, memcmp(reinterpret_cast<const char*>(address), "Jorld!", 6));
+
+  ASSERT_TRUE(handle_driver_.UnmapFile(client2_id_));
+  ASSERT_FALSE(handle_driver_.UnmapFile(client2_id_));
+  ASSERT_FALSE(handle_driver_.ReadMappedBytes(client2_id_, read_data, 1));
+}
+
 }  // namespace vts
 }  // namespace android
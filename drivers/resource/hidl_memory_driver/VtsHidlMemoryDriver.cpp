@@ -17,8 +17,9 @@
 
 #include "hidl_memory_driver/VtsHidlMemoryDriver.h"
 
+#include <string.h>
+
 #include <android-base/logging.h>
-#include <android/hidl/allocator/1.0/IAllocator.h>
 #include <hidlmemory/mapping.h>
 
 using android::sp;
@@ -34,29 +35,16 @@ namespace vts {
 VtsHidlMemoryDriver::VtsHidlMemoryDriver() {}
 
 VtsHidlMemoryDriver::~VtsHidlMemoryDriver() {
-  // clears objects in the map.
-  hidl_memory_map_.clear();
+  // clears objects in the map and the pool.
+  hidl_memory_map_.Clear();
+  memory_pool_.clear();
 }
 
 MemoryId VtsHidlMemoryDriver::Allocate(size_t mem_size) {
-  sp<IAllocator> ashmem_allocator = IAllocator::getService("ashmem");
-  unique_ptr<MemoryInfo> mem_info = nullptr;
-  ashmem_allocator->allocate(
-      mem_size, [&](bool success, const hidl_memory& mem) {
-        if (!success) {  // error
-          LOG(ERROR) << "Allocate memory failure.";
-        } else {
-          unique_ptr<hidl_memory> hidl_mem_ptr(new hidl_memory(mem));
-          sp<IMemory> mem_ptr = mapMemory(mem);
-          mem_info.reset(new MemoryInfo{move(hidl_mem_ptr), mem_ptr});
-        }
-      });
+  shared_ptr<MemoryInfo> mem_info = TakeFromPool(mem_size);
+  if (mem_info == nullptr) mem_info = AllocateRegion(mem_size);
   if (mem_info == nullptr) return -1;
-  map_mutex_.lock();
-  size_t new_mem_id = hidl_memory_map_.size();
-  hidl_memory_map_.emplace(new_mem_id, move(mem_info));
-  map_mutex_.unlock();
-  return new_mem_id;
+  return hidl_memory_map_.Insert(move(mem_info));
 }
 
 MemoryId VtsHidlMemoryDriver::RegisterHidlMemory(size_t hidl_mem_address) {
@@ -68,16 +56,49 @@ MemoryId VtsHidlMemoryDriver::RegisterHidlMemory(size_t hidl_mem_address) {
                << "Unable to map hidl_memory to IMemory object.";
     return -1;
   }
-  unique_ptr<MemoryInfo> mem_info(new MemoryInfo{move(hidl_mem_ptr), mem_ptr});
-  map_mutex_.lock();
-  size_t new_mem_id = hidl_memory_map_.size();
-  hidl_memory_map_.emplace(new_mem_id, move(mem_info));
-  map_mutex_.unlock();
-  return new_mem_id;
+  unique_ptr<MemoryInfo> mem_info(
+      new MemoryInfo{move(hidl_mem_ptr), mem_ptr, false});
+  return hidl_memory_map_.Insert(move(mem_info));
+}
+
+bool VtsHidlMemoryDriver::FreeMemory(MemoryId mem_id) {
+  shared_ptr<MemoryInfo> mem_info = hidl_memory_map_.Remove(mem_id);
+  if (mem_info == nullptr) {
+    LOG(ERROR) << "Unable to find memory region associated with mem_id "
+               << mem_id;
+    return false;
+  }
+  ReturnToPool(move(mem_info));
+  return true;
+}
+
+void VtsHidlMemoryDriver::SetPoolCapacity(size_t capacity) {
+  lock_guard<mutex> lock(pool_lock_);
+  pool_capacity_ = capacity;
+  for (auto& pooled_regions : memory_pool_) {
+    if (pooled_regions.second.size() > capacity) {
+      pooled_regions.second.resize(capacity);
+    }
+  }
+}
+
+size_t VtsHidlMemoryDriver::FillPool(size_t mem_size, size_t count) {
+  size_t added = 0;
+  for (size_t i = 0; i < count; i++) {
+    {
+      lock_guard<mutex> lock(pool_lock_);
+      if (memory_pool_[mem_size].size() >= pool_capacity_) break;
+    }
+    unique_ptr<MemoryInfo> mem_info = AllocateRegion(mem_size);
+    if (mem_info == nullptr) break;
+    ReturnToPool(move(mem_info));
+    added++;
+  }
+  return added;
 }
 
 bool VtsHidlMemoryDriver::Update(MemoryId mem_id) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   (mem_info->memory)->update();
   return true;
@@ -85,14 +106,14 @@ bool VtsHidlMemoryDriver::Update(MemoryId mem_id) {
 
 bool VtsHidlMemoryDriver::UpdateRange(MemoryId mem_id, uint64_t start,
                                       uint64_t length) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   (mem_info->memory)->updateRange(start, length);
   return true;
 }
 
 bool VtsHidlMemoryDriver::Read(MemoryId mem_id) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   (mem_info->memory)->read();
   return true;
@@ -100,7 +121,7 @@ bool VtsHidlMemoryDriver::Read(MemoryId mem_id) {
 
 bool VtsHidlMemoryDriver::ReadRange(MemoryId mem_id, uint64_t start,
                                     uint64_t length) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   (mem_info->memory)->readRange(start, length);
   return true;
@@ -108,7 +129,7 @@ bool VtsHidlMemoryDriver::ReadRange(MemoryId mem_id, uint64_t start,
 
 bool VtsHidlMemoryDriver::UpdateBytes(MemoryId mem_id, const char* write_data,
                                       uint64_t length, uint64_t start) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   void* memory_ptr = (mem_info->memory)->getPointer();
   char* memory_char_ptr = static_cast<char*>(memory_ptr);
@@ -118,7 +139,7 @@ bool VtsHidlMemoryDriver::UpdateBytes(MemoryId mem_id, const char* write_data,
 
 bool VtsHidlMemoryDriver::ReadBytes(MemoryId mem_id, char* read_data,
                                     uint64_t length, uint64_t start) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   void* memory_ptr = (mem_info->memory)->getPointer();
   char* memory_char_ptr = static_cast<char*>(memory_ptr);
@@ -126,15 +147,60 @@ bool VtsHidlMemoryDriver::ReadBytes(MemoryId mem_id, char* read_data,
   return true;
 }
 
+bool VtsHidlMemoryDriver::UpdateRanges(MemoryId mem_id,
+                                       const MemoryRange* ranges,
+                                       size_t range_count,
+                                       const char* write_data, uint64_t length,
+                                       bool bracket) {
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
+  if (mem_info == nullptr) return false;
+  if (!CheckRanges(mem_info.get(), ranges, range_count, length)) return false;
+  IMemory* memory = (mem_info->memory).get();
+  char* memory_char_ptr = static_cast<char*>(memory->getPointer());
+  if (bracket) {
+    for (size_t i = 0; i < range_count; i++) {
+      memory->updateRange(ranges[i].start, ranges[i].length);
+    }
+  }
+  for (size_t i = 0; i < range_count; i++) {
+    memcpy(memory_char_ptr + ranges[i].start, write_data, ranges[i].length);
+    write_data += ranges[i].length;
+  }
+  if (bracket) memory->commit();
+  return true;
+}
+
+bool VtsHidlMemoryDriver::ReadRanges(MemoryId mem_id,
+                                     const MemoryRange* ranges,
+                                     size_t range_count, char* read_data,
+                                     uint64_t length, bool bracket) {
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
+  if (mem_info == nullptr) return false;
+  if (!CheckRanges(mem_info.get(), ranges, range_count, length)) return false;
+  IMemory* memory = (mem_info->memory).get();
+  const char* memory_char_ptr = static_cast<char*>(memory->getPointer());
+  if (bracket) {
+    for (size_t i = 0; i < range_count; i++) {
+      memory->readRange(ranges[i].start, ranges[i].length);
+    }
+  }
+  for (size_t i = 0; i < range_count; i++) {
+    memcpy(read_data, memory_char_ptr + ranges[i].start, ranges[i].length);
+    read_data += ranges[i].length;
+  }
+  if (bracket) memory->commit();
+  return true;
+}
+
 bool VtsHidlMemoryDriver::Commit(MemoryId mem_id) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   (mem_info->memory)->commit();
   return true;
 }
 
 bool VtsHidlMemoryDriver::GetSize(MemoryId mem_id, size_t* result) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;
   *result = (mem_info->memory)->getSize();
   return true;
@@ -142,25 +208,122 @@ bool VtsHidlMemoryDriver::GetSize(MemoryId mem_id, size_t* result) {
 
 bool VtsHidlMemoryDriver::GetHidlMemoryAddress(MemoryId mem_id,
                                                size_t* result) {
-  MemoryInfo* mem_info = FindMemory(mem_id);
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
   if (mem_info == nullptr) return false;  // unable to find memory object.
   hidl_memory* hidl_mem_ptr = (mem_info->hidl_mem_ptr).get();
   *result = reinterpret_cast<size_t>(hidl_mem_ptr);
   return true;
 }
 
-MemoryInfo* VtsHidlMemoryDriver::FindMemory(MemoryId mem_id) {
-  MemoryInfo* mem_info;
-  map_mutex_.lock();
-  auto iterator = hidl_memory_map_.find(mem_id);
-  if (iterator == hidl_memory_map_.end()) {
+bool VtsHidlMemoryDriver::GetRangeAddress(MemoryId mem_id, uint64_t start,
+                                          uint64_t length, size_t* result) {
+  shared_ptr<MemoryInfo> mem_info = FindMemory(mem_id);
+  if (mem_info == nullptr) return false;  // unable to find memory object.
+  uint64_t mem_size = (mem_info->memory)->getSize();
+  if (start > mem_size || length > mem_size - start) {
+    LOG(ERROR) << "Range [" << start << ", " << start + length
+               << ") is out of the memory of size " << mem_size;
+    return false;
+  }
+  char* memory_char_ptr = static_cast<char*>((mem_info->memory)->getPointer());
+  *result = reinterpret_cast<size_t>(memory_char_ptr + start);
+  return true;
+}
+
+bool VtsHidlMemoryDriver::CheckRanges(MemoryInfo* mem_info,
+                                      const MemoryRange* ranges,
+                                      size_t range_count, uint64_t length) {
+  uint64_t mem_size = (mem_info->memory)->getSize();
+  uint64_t total_length = 0;
+  for (size_t i = 0; i < range_count; i++) {
+    const MemoryRange& range = ranges[i];
+    if (range.start > mem_size || range.length > mem_size - range.start) {
+      LOG(ERROR) << "Range [" << range.start << ", "
+                 << range.start + range.length
+                 << ") is out of the memory of size " << mem_size;
+      return false;
+    }
+    // Stops once past length, so that the sum can't overflow.
+    total_length += range.length;
+    if (total_length > length) break;
+  }
+  if (total_length != length) {
+    LOG(ERROR) << "The ranges don't have the length of the data, " << length;
+    return false;
+  }
+  return true;
+}
+
+unique_ptr<MemoryInfo> VtsHidlMemoryDriver::AllocateRegion(size_t mem_size) {
+  sp<IAllocator> ashmem_allocator = GetAllocator();
+  if (ashmem_allocator == nullptr) return nullptr;
+  unique_ptr<MemoryInfo> mem_info = nullptr;
+  auto ret = ashmem_allocator->allocate(
+      mem_size, [&](bool success, const hidl_memory& mem) {
+        if (!success) {  // error
+          LOG(ERROR) << "Allocate memory failure.";
+        } else {
+          unique_ptr<hidl_memory> hidl_mem_ptr(new hidl_memory(mem));
+          sp<IMemory> mem_ptr = mapMemory(mem);
+          mem_info.reset(new MemoryInfo{move(hidl_mem_ptr), mem_ptr, true});
+        }
+      });
+  if (!ret.isOk()) {
+    LOG(ERROR) << "Allocate memory failure: " << ret.description();
+    // The allocator may have died, fetches it again next time.
+    lock_guard<mutex> lock(allocator_lock_);
+    ashmem_allocator_ = nullptr;
+  }
+  return mem_info;
+}
+
+sp<IAllocator> VtsHidlMemoryDriver::GetAllocator() {
+  lock_guard<mutex> lock(allocator_lock_);
+  if (ashmem_allocator_ == nullptr) {
+    ashmem_allocator_ = IAllocator::getService("ashmem");
+    if (ashmem_allocator_ == nullptr) {
+      LOG(ERROR) << "Unable to get the ashmem allocator service.";
+    }
+  }
+  return ashmem_allocator_;
+}
+
+shared_ptr<MemoryInfo> VtsHidlMemoryDriver::TakeFromPool(size_t mem_size) {
+  shared_ptr<MemoryInfo> mem_info;
+  {
+    lock_guard<mutex> lock(pool_lock_);
+    auto iterator = memory_pool_.find(mem_size);
+    if (iterator == memory_pool_.end() || iterator->second.empty()) {
+      return nullptr;
+    }
+    mem_info = move(iterator->second.back());
+    iterator->second.pop_back();
+  }
+  // Clears the region, as a new allocation would be.
+  sp<IMemory> memory = mem_info->memory;
+  memory->update();
+  memset(memory->getPointer(), 0, memory->getSize());
+  memory->commit();
+  return mem_info;
+}
+
+void VtsHidlMemoryDriver::ReturnToPool(shared_ptr<MemoryInfo> mem_info) {
+  if (!mem_info->allocated || mem_info->memory == nullptr) return;
+  // An operation which found the region before it was freed still uses it.
+  if (mem_info.use_count() > 1) return;
+  lock_guard<mutex> lock(pool_lock_);
+  auto& pooled_regions = memory_pool_[mem_info->memory->getSize()];
+  if (pooled_regions.size() < pool_capacity_) {
+    pooled_regions.push_back(move(mem_info));
+  }
+}
+
+shared_ptr<MemoryInfo> VtsHidlMemoryDriver::FindMemory(MemoryId mem_id) {
+  shared_ptr<MemoryInfo> mem_info = hidl_memory_map_.Find(mem_id);
+  if (mem_info == nullptr) {
     LOG(ERROR) << "Unable to find memory region associated with mem_id "
                << mem_id;
-    map_mutex_.unlock();
-    return nullptr;
   }
-  mem_info = (iterator->second).get();
-  map_mutex_.unlock();
   return mem_info;
 }
 
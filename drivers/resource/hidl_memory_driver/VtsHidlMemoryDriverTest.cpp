@@ -61,6 +61,42 @@ TEST_F(HidlMemoryDriverUnitTest, GetSizeTest) {
   ASSERT_EQ(100, mem_size);
 }
 
+// Tests freeing a memory object, and reusing its slot.
+TEST_F(HidlMemoryDriverUnitTest, FreeMemory) {
+  ASSERT_TRUE(mem_driver_.FreeMemory(mem_id_));
+  ASSERT_FALSE(mem_driver_.Read(mem_id_));
+  ASSERT_FALSE(mem_driver_.FreeMemory(mem_id_));
+
+  // The new memory object gets a new id, and the freed id stays invalid.
+  int new_mem_id = mem_driver_.Allocate(200);
+  ASSERT_NE(new_mem_id, -1);
+  ASSERT_NE(new_mem_id, mem_id_);
+  size_t mem_size;
+  ASSERT_FALSE(mem_driver_.GetSize(mem_id_, &mem_size));
+  ASSERT_TRUE(mem_driver_.GetSize(new_mem_id, &mem_size));
+  ASSERT_EQ(200, mem_size);
+  mem_id_ = new_mem_id;
+}
+
+// Tests reusing a freed memory region from the pool.
+TEST_F(HidlMemoryDriverUnitTest, PooledMemory) {
+  mem_driver_.SetPoolCapacity(1);
+  ASSERT_TRUE(mem_driver_.UpdateBytes(mem_id_, "abcdefghij", 10));
+  ASSERT_TRUE(mem_driver_.FreeMemory(mem_id_));
+
+  // The reused region has the same size, and is cleared.
+  mem_id_ = mem_driver_.Allocate(100);
+  ASSERT_NE(mem_id_, -1);
+  size_t mem_size;
+  ASSERT_TRUE(mem_driver_.GetSize(mem_id_, &mem_size));
+  ASSERT_EQ(100, mem_size);
+  char read_data[10];
+  ASSERT_TRUE(mem_driver_.ReadBytes(mem_id_, read_data, 10));
+  ASSERT_EQ(string(10, '\0'), string(read_data, 10));
+
+  ASSERT_EQ(1, mem_driver_.FillPool(50, 3));
+}
+
 // Tests writing to the memory and reading the same data back.
 TEST_F(HidlMemoryDriverUnitTest, SimpleWriteRead) {
   string write_data = "abcdef";
@@ -146,5 +182,37 @@ TEST_F(HidlMemoryDriverUnitTest, WriteTwoRegionsInOneBuffer) {
   ASSERT_EQ(0, strncmp(read_data1, write_data1.c_str(), write_data1.length()));
 }
 
+// Tests writing and reading several ranges in one call each.
+TEST_F(HidlMemoryDriverUnitTest, WriteReadRanges) {
+  string write_data = "abcdefghijklmno";
+  MemoryRange ranges[] = {{50, 9}, {0, 6}};
+  ASSERT_TRUE(mem_driver_.UpdateRanges(mem_id_, ranges, 2, write_data.c_str(),
+                                       write_data.length(), true));
+
+  char read_data[write_data.length()];
+  ASSERT_TRUE(mem_driver_.ReadBytes(mem_id_, read_data, 6));
+  ASSERT_EQ(0, strncmp(read_data, "jklmno", 6));
+  ASSERT_TRUE(mem_driver_.ReadBytes(mem_id_, read_data, 9, 50));
+  ASSERT_EQ(0, strncmp(read_data, "abcdefghi", 9));
+
+  ASSERT_TRUE(mem_driver_.ReadRanges(mem_id_, ranges, 2, read_data,
+                                     write_data.length(), true));
+  ASSERT_EQ(0, strncmp(read_data, write_data.c_str(), write_data.length()));
+}
+
+// Tests ranges out of the memory, or not matching the length of the data.
+TEST_F(HidlMemoryDriverUnitTest, InvalidRanges) {
+  char data[20] = {};
+  MemoryRange out_of_memory[] = {{95, 10}};
+  ASSERT_FALSE(
+      mem_driver_.UpdateRanges(mem_id_, out_of_memory, 1, data, 10, false));
+  ASSERT_FALSE(
+      mem_driver_.ReadRanges(mem_id_, out_of_memory, 1, data, 10, false));
+  MemoryRange ranges[] = {{0, 10}, {10, 10}};
+  ASSERT_FALSE(mem_driver_.UpdateRanges(mem_id_, ranges, 2, data, 15, false));
+  ASSERT_FALSE(mem_driver_.ReadRanges(mem_id_, ranges, 2, data, 25, false));
+  ASSERT_TRUE(mem_driver_.ReadRanges(mem_id_, ranges, 2, data, 20, false));
+}
+
 }  // namespace vts
 }  // namespace android
@@ -17,9 +17,11 @@
 #ifndef __VTS_RESOURCE_VTSFMQDRIVER_H
 #define __VTS_RESOURCE_VTSFMQDRIVER_H
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <unordered_map>
 
 #include <android-base/logging.h>
 #include <fmq/MessageQueue.h>
@@ -40,12 +42,16 @@ namespace vts {
 
 // struct to store queue information.
 struct QueueInfo {
+  // id of the C++ type of data and flavor of the queue.
+  int queue_type_id;
   // type of data in the queue.
   string queue_data_type;
   // flavor of the queue (sync or unsync).
   hardware::MQFlavor queue_flavor;
   // pointer to the actual queue object.
   shared_ptr<void> queue_object;
+  // the event flag word of the queue, nullptr if it has none.
+  atomic<uint32_t>* event_flag_word;
 };
 
 // A fast message queue class that manages all fast message queues created
@@ -73,8 +79,9 @@ class VtsFmqDriver {
 
   // Destructor to clean up the class.
   ~VtsFmqDriver() {
-    // Clears objects in the map.
-    fmq_map_.clear();
+    for (auto& event_flag : event_flags_) {
+      hardware::EventFlag::deleteEventFlag(&event_flag.second);
+    }
   }
 
   // Creates a brand new FMQ, i.e. the "first message queue object".
@@ -160,7 +167,8 @@ class VtsFmqDriver {
   // @param write_notification notification bits to wait on when blocking.
   //                           Read will fail if this argument is 0.
   // @param time_out_nanos     wait time when blocking.
-  // @param event_flag_word    event flag word shared by multiple queues.
+  // @param event_flag_word    event flag word shared by multiple queues, or
+  //                           nullptr to use the event flag of the queue.
   //
   // @return true if no error happens when reading from FMQ,
   //         false otherwise.
@@ -215,7 +223,8 @@ class VtsFmqDriver {
   //                           Write will fail if this argument is 0.
   // @param write_notification notification bits to set when finish writing.
   // @param time_out_nanos     wait time when blocking.
-  // @param event_flag_word    event flag word shared by multiple queues.
+  // @param event_flag_word    event flag word shared by multiple queues, or
+  //                           nullptr to use the event flag of the queue.
   //
   // @return true if no error happens when writing to FMQ,
   //         false otherwise.
@@ -225,6 +234,104 @@ class VtsFmqDriver {
                         uint32_t write_notification, int64_t time_out_nanos,
                         atomic<uint32_t>* event_flag_word);
 
+  // Starts a zero-copy write of data_size items. The caller fills the slots
+  // of transaction, then calls CommitWriteFmq to make them visible to the
+  // readers.
+  //
+  // @param data_type   type of data in the queue. This information is
+  //                    verified by the driver before calling the API on FMQ.
+  // @param queue_id    identifies the message queue object.
+  // @param data_size   number of items to write.
+  // @param transaction to be filled with the regions of the queue to write.
+  //
+  // @return true if queue is found and there is space for data_size items,
+  //         false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool BeginWriteFmq(
+      const string& data_type, QueueId queue_id, size_t data_size,
+      typename MessageQueue<T, flavor>::MemTransaction* transaction);
+
+  // Commits a zero-copy write started by BeginWriteFmq.
+  //
+  // @param data_type type of data in the queue. This information is
+  //                  verified by the driver before calling the API on FMQ.
+  // @param queue_id  identifies the message queue object.
+  // @param data_size number of items written.
+  //
+  // @return true if queue is found and the write is committed,
+  //         false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool CommitWriteFmq(const string& data_type, QueueId queue_id,
+                      size_t data_size);
+
+  // Starts a zero-copy read of data_size items. The caller reads the slots
+  // of transaction, then calls CommitReadFmq to release them to the writer.
+  //
+  // @param data_type   type of data in the queue. This information is
+  //                    verified by the driver before calling the API on FMQ.
+  // @param queue_id    identifies the message queue object.
+  // @param data_size   number of items to read.
+  // @param transaction to be filled with the regions of the queue to read.
+  //
+  // @return true if queue is found and data_size items are available,
+  //         false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool BeginReadFmq(
+      const string& data_type, QueueId queue_id, size_t data_size,
+      typename MessageQueue<T, flavor>::MemTransaction* transaction);
+
+  // Commits a zero-copy read started by BeginReadFmq.
+  //
+  // @param data_type type of data in the queue. This information is
+  //                  verified by the driver before calling the API on FMQ.
+  // @param queue_id  identifies the message queue object.
+  // @param data_size number of items read.
+  //
+  // @return true if queue is found and the read is committed,
+  //         false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool CommitReadFmq(const string& data_type, QueueId queue_id,
+                     size_t data_size);
+
+  // Writes the data_size items in data as up to transaction_count
+  // consecutive transactions, through zero-copy writes. Stops at the first
+  // transaction that doesn't fit in the queue.
+  //
+  // @param data_type         type of data in the queue. This information is
+  //                          verified by the driver before calling the API
+  //                          on FMQ.
+  // @param queue_id          identifies the message queue object.
+  // @param data              pointer to the start of data of a transaction.
+  // @param data_size         number of items in a transaction.
+  // @param transaction_count number of transactions to write.
+  // @param result            to store the number of transactions written.
+  //
+  // @return true if queue is found and type matches, false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool WriteFmqTransactions(const string& data_type, QueueId queue_id,
+                            const T* data, size_t data_size,
+                            size_t transaction_count, size_t* result);
+
+  // Reads up to transaction_count consecutive transactions of data_size
+  // items, through zero-copy reads. Stops at the first transaction that
+  // isn't available.
+  //
+  // @param data_type         type of data in the queue. This information is
+  //                          verified by the driver before calling the API
+  //                          on FMQ.
+  // @param queue_id          identifies the message queue object.
+  // @param data              pointer to the start of data to be filled with
+  //                          the last transaction read. Can be nullptr.
+  // @param data_size         number of items in a transaction.
+  // @param transaction_count number of transactions to read.
+  // @param result            to store the number of transactions read.
+  //
+  // @return true if queue is found and type matches, false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool ReadFmqTransactions(const string& data_type, QueueId queue_id, T* data,
+                           size_t data_size, size_t transaction_count,
+                           size_t* result);
+
   // Gets space available to write in the queue.
   //
   // @param data_type type of data in the queue. This information is
@@ -313,6 +420,37 @@ class VtsFmqDriver {
   bool GetEventFlagWord(const string& data_type, QueueId queue_id,
                         atomic<uint32_t>** result);
 
+  // Gets event flag word of the queue, whatever its type of data and
+  // flavor, e.g. to share the event flag of a queue with other queues of
+  // different types.
+  //
+  // @param queue_id identifies the message queue object.
+  // @param result   pointer to store the event flag word.
+  //
+  // @return true if the queue is found and has an event flag word,
+  //         false otherwise.
+  bool GetEventFlagWord(QueueId queue_id, atomic<uint32_t>** result);
+
+  // Waits on bits of the event flag of a queue, which may be shared by a
+  // group of queues.
+  //
+  // @param queue_id       identifies the message queue object.
+  // @param bits           bits to wait on.
+  // @param time_out_nanos wait time, 0 to wait forever.
+  // @param result         pointer to store the bits woken.
+  //
+  // @return true if any of the bits is woken, false on error or time out.
+  bool WaitEventFlag(QueueId queue_id, uint32_t bits, int64_t time_out_nanos,
+                     uint32_t* result);
+
+  // Sets bits of the event flag of a queue, and wakes up the waiters.
+  //
+  // @param queue_id identifies the message queue object.
+  // @param bits     bits to set.
+  //
+  // @return true if the bits are set, false otherwise.
+  bool WakeEventFlag(QueueId queue_id, uint32_t bits);
+
   // Gets the address of queue descriptor in memory. This function is called by
   // driver_manager to preprocess arguments that are FMQs.
   //
@@ -329,7 +467,8 @@ class VtsFmqDriver {
                            size_t* result);
 
  private:
-  // Finds the queue in the map based on the input queue ID.
+  // Finds the queue in the registry based on the input queue ID. This
+  // function doesn't take any lock.
   //
   // @param data_type type of data in the queue. This function verifies this
   //                  information.
@@ -340,9 +479,9 @@ class VtsFmqDriver {
   template <typename T, hardware::MQFlavor flavor>
   MessageQueue<T, flavor>* FindQueue(const string& data_type, QueueId queue_id);
 
-  // Inserts a FMQ object into the map, along with its type of data and queue
-  // flavor. This function ensures only one thread is inserting queue into the
-  // map at once.
+  // Inserts a FMQ object into the registry, along with its type of data and
+  // queue flavor. This function ensures only one thread is inserting queue
+  // into the registry at once.
   //
   // @param data_type    type of data in the queue. This information is stored
   //                     in the driver.
@@ -353,17 +492,59 @@ class VtsFmqDriver {
   QueueId InsertQueue(const string& data_type,
                       shared_ptr<MessageQueue<T, flavor>> queue_object);
 
-  // a hashtable to keep track of all ongoing FMQ's.
-  // The key of the hashtable is the queue ID.
-  // The value of the hashtable is a smart pointer to message queue object
-  // information struct associated with the queue ID.
-  unordered_map<QueueId, unique_ptr<QueueInfo>> fmq_map_;
+  // Finds the info of the queue with queue_id, whatever its type. This
+  // function doesn't take any lock.
+  //
+  // @return the pointer to the queue info, nullptr if queue ID is invalid.
+  QueueInfo* FindQueueInfo(QueueId queue_id);
+
+  // Gets the event flag of an event flag word. The event flag is created on
+  // the first use of the word, and shared by all the operations on it until
+  // the driver is destroyed, so that a group of queues blocks on the same
+  // event flag, and no event flag is created per operation.
+  //
+  // @param event_flag_word the event flag word.
+  //
+  // @return the event flag, nullptr on error.
+  hardware::EventFlag* GetEventFlag(atomic<uint32_t>* event_flag_word);
+
+  // Returns the id of the queues of data type T and the given flavor.
+  template <typename T, hardware::MQFlavor flavor>
+  static int GetQueueTypeId() {
+    static const int type_id = NextQueueTypeId();
+    return type_id;
+  }
+
+  // Returns a new id for GetQueueTypeId.
+  static int NextQueueTypeId() {
+    static atomic<int> next_type_id(0);
+    return next_type_id++;
+  }
+
+  // number of queues in a chunk of the registry.
+  static constexpr int kQueueChunkSize = 256;
+  // max number of chunks in the registry.
+  static constexpr int kMaxQueueChunks = 256;
+
+  // the registry of all ongoing FMQ's, indexed by queue ID. It only grows:
+  // a chunk is never moved or freed once allocated, and a slot is never
+  // changed once published, so the readers need no lock.
+  unique_ptr<QueueInfo[]> fmq_chunks_[kMaxQueueChunks];
+
+  // number of queues published in fmq_chunks_.
+  atomic<int> fmq_count_{0};
+
+  // a mutex to ensure only one thread is inserting a queue at once.
+  mutex insert_mutex_;
 
-  // a mutex to ensure mutual exclusion of operations on fmq_map_
-  mutex map_mutex_;
+  // the event flags created by GetEventFlag, keyed by event flag word.
+  map<atomic<uint32_t>*, hardware::EventFlag*> event_flags_;
+  // protects event_flags_.
+  mutex event_flags_mutex_;
 };
 
-// Implementations follow, because all the methods are template methods.
+// Implementations follow, because the methods are template or inline
+// methods.
 template <typename T, hardware::MQFlavor flavor>
 QueueId VtsFmqDriver::CreateFmq(const string& data_type, size_t queue_size,
                                 bool blocking) {
@@ -377,6 +558,7 @@ QueueId VtsFmqDriver::CreateFmq(const string& data_type, QueueId queue_id,
                                 bool reset_pointers) {
   MessageQueue<T, flavor>* queue_object =
       FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return kInvalidQueueId;
   const hardware::MQDescriptor<T, flavor>* descriptor = queue_object->getDesc();
   if (descriptor == nullptr) {
     LOG(ERROR) << "FMQ Driver: cannot find descriptor for the specified "
@@ -441,20 +623,17 @@ bool VtsFmqDriver::ReadFmqBlocking(const string& data_type, QueueId queue_id,
     return false;
   }
 
+  // The queue uses its own event flag if ef_group is nullptr.
   hardware::EventFlag* ef_group = nullptr;
-  status_t status;
-  // create an event flag out of the event flag word
-  status = hardware::EventFlag::createEventFlag(event_flag_word, &ef_group);
-  if (status != NO_ERROR) {  // check status
-    LOG(ERROR) << "FMQ Driver: cannot create event flag with the specified "
-               << "event flag word.";
-    return false;
+  if (event_flag_word != nullptr) {
+    ef_group = GetEventFlag(event_flag_word);
+    if (ef_group == nullptr) return false;
   }
 
   MessageQueue<T, kSynchronizedReadWrite>* queue_object =
       FindQueue<T, kSynchronizedReadWrite>(data_type, queue_id);
-  if (queue_object == nullptr) return false;
-  return queue_object->readBlocking(data, data_size, read_notification,
+  return queue_object != nullptr &&
+         queue_object->readBlocking(data, data_size, read_notification,
                                     write_notification, time_out_nanos,
                                     ef_group);
 }
@@ -497,24 +676,107 @@ bool VtsFmqDriver::WriteFmqBlocking(const string& data_type, QueueId queue_id,
     return false;
   }
 
+  // The queue uses its own event flag if ef_group is nullptr.
   hardware::EventFlag* ef_group = nullptr;
-  status_t status;
-  // create an event flag out of the event flag word
-  status = hardware::EventFlag::createEventFlag(event_flag_word, &ef_group);
-  if (status != NO_ERROR) {  // check status
-    LOG(ERROR) << "FMQ Driver: cannot create event flag with the specified "
-               << "event flag word.";
-    return false;
+  if (event_flag_word != nullptr) {
+    ef_group = GetEventFlag(event_flag_word);
+    if (ef_group == nullptr) return false;
   }
 
   MessageQueue<T, kSynchronizedReadWrite>* queue_object =
       FindQueue<T, kSynchronizedReadWrite>(data_type, queue_id);
-  if (queue_object == nullptr) return false;
-  return queue_object->writeBlocking(data, data_size, read_notification,
+  return queue_object != nullptr &&
+         queue_object->writeBlocking(data, data_size, read_notification,
                                      write_notification, time_out_nanos,
                                      ef_group);
 }
 
+template <typename T, hardware::MQFlavor flavor>
+bool VtsFmqDriver::BeginWriteFmq(
+    const string& data_type, QueueId queue_id, size_t data_size,
+    typename MessageQueue<T, flavor>::MemTransaction* transaction) {
+  MessageQueue<T, flavor>* queue_object =
+      FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return false;
+  return queue_object->beginWrite(data_size, transaction);
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsFmqDriver::CommitWriteFmq(const string& data_type, QueueId queue_id,
+                                  size_t data_size) {
+  MessageQueue<T, flavor>* queue_object =
+      FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return false;
+  return queue_object->commitWrite(data_size);
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsFmqDriver::BeginReadFmq(
+    const string& data_type, QueueId queue_id, size_t data_size,
+    typename MessageQueue<T, flavor>::MemTransaction* transaction) {
+  MessageQueue<T, flavor>* queue_object =
+      FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return false;
+  return queue_object->beginRead(data_size, transaction);
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsFmqDriver::CommitReadFmq(const string& data_type, QueueId queue_id,
+                                 size_t data_size) {
+  MessageQueue<T, flavor>* queue_object =
+      FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return false;
+  return queue_object->commitRead(data_size);
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsFmqDriver::WriteFmqTransactions(const string& data_type,
+                                        QueueId queue_id, const T* data,
+                                        size_t data_size,
+                                        size_t transaction_count,
+                                        size_t* result) {
+  MessageQueue<T, flavor>* queue_object =
+      FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return false;
+  typename MessageQueue<T, flavor>::MemTransaction transaction;
+  size_t written = 0;
+  while (written < transaction_count &&
+         queue_object->beginWrite(data_size, &transaction) &&
+         transaction.copyTo(data, 0, data_size) &&
+         queue_object->commitWrite(data_size)) {
+    written++;
+  }
+  *result = written;
+  return true;
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsFmqDriver::ReadFmqTransactions(const string& data_type,
+                                       QueueId queue_id, T* data,
+                                       size_t data_size,
+                                       size_t transaction_count,
+                                       size_t* result) {
+  MessageQueue<T, flavor>* queue_object =
+      FindQueue<T, flavor>(data_type, queue_id);
+  if (queue_object == nullptr) return false;
+  typename MessageQueue<T, flavor>::MemTransaction transaction;
+  size_t read = 0;
+  while (read < transaction_count &&
+         queue_object->beginRead(data_size, &transaction)) {
+    // only copies out the transaction if it may be the last one.
+    bool last = read + 1 == transaction_count ||
+                queue_object->availableToRead() < 2 * data_size;
+    if (data != nullptr && last &&
+        !transaction.copyFrom(data, 0, data_size)) {
+      break;
+    }
+    if (!queue_object->commitRead(data_size)) break;
+    read++;
+  }
+  *result = read;
+  return true;
+}
+
 template <typename T, hardware::MQFlavor flavor>
 bool VtsFmqDriver::AvailableToWrite(const string& data_type, QueueId queue_id,
                                     size_t* result) {
@@ -586,35 +848,34 @@ bool VtsFmqDriver::GetQueueDescAddress(const string& data_type,
 template <typename T, hardware::MQFlavor flavor>
 MessageQueue<T, flavor>* VtsFmqDriver::FindQueue(const string& data_type,
                                                  QueueId queue_id) {
-  map_mutex_.lock();  // Ensure mutual exclusion.
-  auto iterator = fmq_map_.find(queue_id);
-  if (iterator == fmq_map_.end()) {  // queue not found
-    LOG(ERROR) << "FMQ Driver: cannot find Fast Message Queue with ID "
-               << queue_id;
+  QueueInfo* queue_info = FindQueueInfo(queue_id);
+  if (queue_info == nullptr) return nullptr;
+
+  if (queue_info->queue_type_id != GetQueueTypeId<T, flavor>()) {
+    if (queue_info->queue_flavor != flavor) {  // queue flavor incorrect
+      LOG(ERROR) << "FMQ Driver: caller specified flavor " << flavor
+                 << "doesn't match with the stored queue flavor "
+                 << queue_info->queue_flavor << ".";
+    } else {  // queue C++ type incorrect
+      LOG(ERROR) << "FMQ Driver: caller specified C++ type for data type "
+                 << data_type << " doesn't match with the C++ type of the "
+                 << "queue with data type " << queue_info->queue_data_type
+                 << ".";
+    }
     return nullptr;
   }
 
-  QueueInfo* queue_info = (iterator->second).get();
-  if (queue_info->queue_data_type != data_type) {  // queue data type incorrect
+  // The C++ type matches, still rejects a caller that names the data type
+  // differently from the creator.
+  if (queue_info->queue_data_type != data_type) {
     LOG(ERROR) << "FMQ Driver: caller specified data type " << data_type
                << " doesn't match with the data type "
                << queue_info->queue_data_type << " stored in driver.";
     return nullptr;
   }
 
-  if (queue_info->queue_flavor != flavor) {  // queue flavor incorrect
-    LOG(ERROR) << "FMQ Driver: caller specified flavor " << flavor
-               << "doesn't match with the stored queue flavor "
-               << queue_info->queue_flavor << ".";
-    return nullptr;
-  }
-
   // type check passes, extract queue from the struct
-  shared_ptr<MessageQueue<T, flavor>> queue_object =
-      static_pointer_cast<MessageQueue<T, flavor>>(queue_info->queue_object);
-  MessageQueue<T, flavor>* result = queue_object.get();
-  map_mutex_.unlock();
-  return result;
+  return static_cast<MessageQueue<T, flavor>*>(queue_info->queue_object.get());
 }
 
 template <typename T, hardware::MQFlavor flavor>
@@ -625,17 +886,87 @@ QueueId VtsFmqDriver::InsertQueue(
                << "using FMQ constructor.";
     return kInvalidQueueId;
   }
-  // Create a struct to store queue object, type of data, and
-  // queue flavor.
-  unique_ptr<QueueInfo> new_queue_info(new QueueInfo{
-      string(data_type), flavor, static_pointer_cast<void>(queue_object)});
-  map_mutex_.lock();
-  size_t new_queue_id = fmq_map_.size();
-  fmq_map_.emplace(new_queue_id, move(new_queue_info));
-  map_mutex_.unlock();
+  lock_guard<mutex> lock(insert_mutex_);
+  int new_queue_id = fmq_count_.load(memory_order_relaxed);
+  int chunk = new_queue_id / kQueueChunkSize;
+  if (chunk >= kMaxQueueChunks) {
+    LOG(ERROR) << "FMQ Driver Error: too many Fast Message Queues.";
+    return kInvalidQueueId;
+  }
+  if (fmq_chunks_[chunk] == nullptr) {
+    fmq_chunks_[chunk].reset(new QueueInfo[kQueueChunkSize]);
+  }
+  // Fills the slot to store queue object, type of data, and queue flavor,
+  // then publishes it to the readers.
+  QueueInfo* queue_info =
+      &fmq_chunks_[chunk][new_queue_id % kQueueChunkSize];
+  queue_info->queue_type_id = GetQueueTypeId<T, flavor>();
+  queue_info->queue_data_type = data_type;
+  queue_info->queue_flavor = flavor;
+  queue_info->queue_object = static_pointer_cast<void>(queue_object);
+  queue_info->event_flag_word = queue_object->getEventFlagWord();
+  fmq_count_.store(new_queue_id + 1, memory_order_release);
   return new_queue_id;
 }
 
+inline bool VtsFmqDriver::GetEventFlagWord(QueueId queue_id,
+                                           atomic<uint32_t>** result) {
+  QueueInfo* queue_info = FindQueueInfo(queue_id);
+  if (queue_info == nullptr) return false;
+  if (queue_info->event_flag_word == nullptr) {
+    LOG(ERROR) << "FMQ Driver: Fast Message Queue with ID " << queue_id
+               << " has no event flag word.";
+    return false;
+  }
+  *result = queue_info->event_flag_word;
+  return true;
+}
+
+inline bool VtsFmqDriver::WaitEventFlag(QueueId queue_id, uint32_t bits,
+                                        int64_t time_out_nanos,
+                                        uint32_t* result) {
+  atomic<uint32_t>* event_flag_word;
+  if (!GetEventFlagWord(queue_id, &event_flag_word)) return false;
+  hardware::EventFlag* event_flag = GetEventFlag(event_flag_word);
+  if (event_flag == nullptr) return false;
+  *result = 0;
+  return event_flag->wait(bits, result, time_out_nanos) == NO_ERROR &&
+         *result != 0;
+}
+
+inline bool VtsFmqDriver::WakeEventFlag(QueueId queue_id, uint32_t bits) {
+  atomic<uint32_t>* event_flag_word;
+  if (!GetEventFlagWord(queue_id, &event_flag_word)) return false;
+  hardware::EventFlag* event_flag = GetEventFlag(event_flag_word);
+  return event_flag != nullptr && event_flag->wake(bits) == NO_ERROR;
+}
+
+inline QueueInfo* VtsFmqDriver::FindQueueInfo(QueueId queue_id) {
+  // The acquire pairs with the release in InsertQueue, so the slot is fully
+  // visible once its ID is below the count.
+  if (queue_id < 0 || queue_id >= fmq_count_.load(memory_order_acquire)) {
+    LOG(ERROR) << "FMQ Driver: cannot find Fast Message Queue with ID "
+               << queue_id;
+    return nullptr;
+  }
+  return &fmq_chunks_[queue_id / kQueueChunkSize][queue_id % kQueueChunkSize];
+}
+
+inline hardware::EventFlag* VtsFmqDriver::GetEventFlag(
+    atomic<uint32_t>* event_flag_word) {
+  lock_guard<mutex> lock(event_flags_mutex_);
+  hardware::EventFlag*& event_flag = event_flags_[event_flag_word];
+  if (event_flag == nullptr &&
+      hardware::EventFlag::createEventFlag(event_flag_word, &event_flag) !=
+          NO_ERROR) {
+    LOG(ERROR) << "FMQ Driver: cannot create event flag with the specified "
+               << "event flag word.";
+    event_flags_.erase(event_flag_word);
+    return nullptr;
+  }
+  return event_flag;
+}
+
 }  // namespace vts
 }  // namespace android
 #endif  //__VTS_RESOURCE_VTSFMQDRIVER_H
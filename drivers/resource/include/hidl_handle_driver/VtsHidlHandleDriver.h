@@ -17,13 +17,19 @@
 #ifndef __VTS_RESOURCE_VTSHIDLHANDLEDRIVER_H
 #define __VTS_RESOURCE_VTSHIDLHANDLEDRIVER_H
 
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <map>
 #include <mutex>
-#include <unordered_map>
+#include <shared_mutex>
 
 #include <android-base/logging.h>
 #include <cutils/native_handle.h>
 #include <hidl/HidlSupport.h>
 
+#include "resource_id/VtsResourceIdMap.h"
+
 using android::hardware::hidl_handle;
 
 using namespace std;
@@ -32,6 +38,18 @@ using HandleId = int;
 namespace android {
 namespace vts {
 
+// A mapping of the file in a handle object into memory.
+struct FileMapping {
+  ~FileMapping();
+
+  // start of the mapping.
+  void* address;
+  // length of the mapping in bytes.
+  size_t length;
+  // whether the mapping can be written.
+  bool writable;
+};
+
 // A hidl_handle driver that manages all hidl_handle objects created
 // on the target side. Users can create handle objects to manage their
 // File I/O.
@@ -73,6 +91,7 @@ class VtsHidlHandleDriver {
                             vector<int> data);
 
   // Closes all file descriptors in the handle object associated with input ID.
+  // The ID becomes invalid, and may be reused with another generation.
   //
   // @param handle_id identifies the handle object.
   //
@@ -84,6 +103,7 @@ class VtsHidlHandleDriver {
   // This function assumes caller only wants to read from a single file,
   // so it will access the first file descriptor in the native_handle_t struct,
   // and the first descriptor must be a file.
+  // Reads until num_bytes are read or the end of the file is reached.
   //
   // @param handle_id identifies the handle object.
   // @param read_data data read back from file.
@@ -92,6 +112,31 @@ class VtsHidlHandleDriver {
   // @return number of bytes read, -1 to signal failure.
   ssize_t ReadFile(HandleId handle_id, void* read_data, size_t num_bytes);
 
+  // Reads a file in the handle object at an offset, without moving the file
+  // position. Reads until num_bytes are read or the end of the file is
+  // reached.
+  //
+  // @param handle_id identifies the handle object.
+  // @param read_data data read back from file.
+  // @param num_bytes number of bytes to read.
+  // @param offset    offset in the file to read from.
+  //
+  // @return number of bytes read, -1 to signal failure.
+  ssize_t ReadFileAt(HandleId handle_id, void* read_data, size_t num_bytes,
+                     off_t offset);
+
+  // Reads a file in the handle object into several buffers, in one readv
+  // call when possible. Fills the buffers in order until they are full or
+  // the end of the file is reached.
+  //
+  // @param handle_id identifies the handle object.
+  // @param iov       the buffers to fill.
+  // @param iov_count number of buffers.
+  //
+  // @return total number of bytes read, -1 to signal failure.
+  ssize_t ReadFileVector(HandleId handle_id, const struct iovec* iov,
+                         int iov_count);
+
   // Writes to a file in the handle object.
   // Caller specifies the handle_id and number of bytes to write.
   // This function assumes caller only wants to write to a single file,
@@ -106,6 +151,84 @@ class VtsHidlHandleDriver {
   ssize_t WriteFile(HandleId handle_id, const void* write_data,
                     size_t num_bytes);
 
+  // Writes to a file in the handle object at an offset, without moving the
+  // file position.
+  //
+  // @param handle_id  identifies the handle object.
+  // @param write_data data to be written into to file.
+  // @param num_bytes  number of bytes to write.
+  // @param offset     offset in the file to write to.
+  //
+  // @return number of bytes written, -1 to signal failure.
+  ssize_t WriteFileAt(HandleId handle_id, const void* write_data,
+                      size_t num_bytes, off_t offset);
+
+  // Writes several buffers to a file in the handle object, in one writev
+  // call when possible.
+  //
+  // @param handle_id identifies the handle object.
+  // @param iov       the buffers to write.
+  // @param iov_count number of buffers.
+  //
+  // @return total number of bytes written, -1 to signal failure.
+  ssize_t WriteFileVector(HandleId handle_id, const struct iovec* iov,
+                          int iov_count);
+
+  // Maps the file in the handle object into memory, so that it can be read
+  // and written without a system call per operation. The mapping is writable
+  // if the file is opened for read and write. Replaces any previous mapping
+  // of the handle object.
+  //
+  // @param handle_id identifies the handle object.
+  // @param offset    offset in the file of the mapping, a multiple of the
+  //                  page size.
+  // @param length    number of bytes to map, 0 to map up to the end of the
+  //                  file.
+  //
+  // @return true if the file is mapped, false otherwise.
+  bool MapFile(HandleId handle_id, off_t offset, size_t length);
+
+  // Unmaps the file in the handle object.
+  //
+  // @param handle_id identifies the handle object.
+  //
+  // @return true if the file was mapped, false otherwise.
+  bool UnmapFile(HandleId handle_id);
+
+  // Reads bytes from the mapping of the file in the handle object.
+  //
+  // @param handle_id identifies the handle object.
+  // @param read_data pointer to the start of buffer to be filled.
+  // @param length    number of bytes to read.
+  // @param start     offset from the start of the mapping.
+  //
+  // @return true if the range is within the mapping, false otherwise.
+  bool ReadMappedBytes(HandleId handle_id, char* read_data, uint64_t length,
+                       uint64_t start = 0);
+
+  // Writes bytes to the mapping of the file in the handle object.
+  //
+  // @param handle_id  identifies the handle object.
+  // @param write_data pointer to the start of buffer to be written.
+  // @param length     number of bytes to write.
+  // @param start      offset from the start of the mapping.
+  //
+  // @return true if the range is within a writable mapping, false otherwise.
+  bool UpdateMappedBytes(HandleId handle_id, const char* write_data,
+                         uint64_t length, uint64_t start = 0);
+
+  // Get the address of a range of the mapping of the file in the handle
+  // object, e.g. to use the bytes in place as a HAL function call argument.
+  //
+  // @param handle_id identifies the handle object.
+  // @param start     offset from the start of the mapping.
+  // @param length    number of bytes in the range.
+  // @param result    stores the address of the first byte of the range.
+  //
+  // @return true if the range is within the mapping, false otherwise.
+  bool GetMappedRangeAddress(HandleId handle_id, uint64_t start,
+                             uint64_t length, size_t* result);
+
   // Registers a handle object in the driver using an existing
   // hidl_handle address created by vtsc.
   //
@@ -128,18 +251,46 @@ class VtsHidlHandleDriver {
   // Logs error if handle_id is not found.
   //
   // @param handle_id identifies the handle object.
-  // @param release   whether to release the handle object managed unique_ptr.
-  //        This parameter is only true if UnregisterHidlHandle() is called.
   //
-  // @return hidl_handle pointer.
-  hidl_handle* FindHandle(HandleId handle_id, bool release = false);
+  // @return hidl_handle pointer. It stays valid while it is held, even if
+  //         the handle is unregistered meanwhile.
+  shared_ptr<hidl_handle> FindHandle(HandleId handle_id);
+
+  // Finds the first file descriptor of the handle object with ID handle_id.
+  // Logs error if handle_id is not found or the handle has no descriptor.
+  //
+  // @param handle_id identifies the handle object.
+  // @param operation the operation for the error message, e.g. "Read from".
+  // @param handle    stores the handle object, which keeps the descriptor
+  //                  open while it is held.
+  //
+  // @return the file descriptor, -1 if not found.
+  int FindFileDescriptor(HandleId handle_id, const char* operation,
+                         shared_ptr<hidl_handle>* handle);
+
+  // Finds the mapping of the file in the handle object, and checks that a
+  // range is within it. Logs error if not. Must be called with
+  // mappings_lock_ held, shared or not.
+  //
+  // @param handle_id identifies the handle object.
+  // @param start     offset from the start of the mapping.
+  // @param length    number of bytes in the range.
+  // @param write     whether the range is to be written.
+  //
+  // @return the address of the first byte of the range, nullptr on error.
+  char* FindMappedRange(HandleId handle_id, uint64_t start, uint64_t length,
+                        bool write);
 
   // A map to keep track of each hidl_handle information.
-  // Store hidl_handle smart pointers.
-  unordered_map<HandleId, unique_ptr<hidl_handle>> hidl_handle_map_;
+  // Store hidl_handle smart pointers. The map is thread-safe.
+  VtsResourceIdMap<hidl_handle> hidl_handle_map_;
 
-  // A mutex to ensure insert and lookup on hidl_handle_map_ are thread-safe.
-  mutex map_mutex_;
+  // protects file_mappings_. Reading and writing the mapped bytes only
+  // needs it shared, so that concurrent accesses don't serialize; mapping
+  // and unmapping need it exclusive.
+  shared_mutex mappings_lock_;
+  // the mappings of files, keyed by handle ID.
+  map<HandleId, unique_ptr<FileMapping>> file_mappings_;
 };
 
 }  // namespace vts
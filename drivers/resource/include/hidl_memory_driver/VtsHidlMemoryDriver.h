@@ -17,15 +17,20 @@
 #ifndef __VTS_RESOURCE_VTSHIDLMEMORYDRIVER_H
 #define __VTS_RESOURCE_VTSHIDLMEMORYDRIVER_H
 
+#include <map>
 #include <mutex>
-#include <unordered_map>
+#include <vector>
 
 #include <android-base/logging.h>
+#include <android/hidl/allocator/1.0/IAllocator.h>
 #include <android/hidl/memory/1.0/IMemory.h>
 #include <hidl/HidlSupport.h>
 
+#include "resource_id/VtsResourceIdMap.h"
+
 using android::sp;
 using android::hardware::hidl_memory;
+using android::hidl::allocator::V1_0::IAllocator;
 using android::hidl::memory::V1_0::IMemory;
 
 using namespace std;
@@ -44,6 +49,17 @@ struct MemoryInfo {
   unique_ptr<hidl_memory> hidl_mem_ptr;
   // Pointer to IMemory that allows actual memory operation.
   sp<IMemory> memory;
+  // Whether the driver allocated the memory, as opposed to registered it.
+  // Only allocated memory can be pooled.
+  bool allocated;
+};
+
+// A range of bytes of a memory object.
+struct MemoryRange {
+  // offset from the start of the memory region.
+  uint64_t start;
+  // number of bytes.
+  uint64_t length;
 };
 
 // A hidl_memory driver that manages all hidl_memory objects created
@@ -89,6 +105,30 @@ class VtsHidlMemoryDriver {
   //         -1 if registration fails.
   MemoryId RegisterHidlMemory(size_t hidl_mem_address);
 
+  // Frees a memory object allocated or registered in the driver. Its id
+  // becomes invalid, and may be reused with another generation.
+  //
+  // @param mem_id identifies the memory object.
+  //
+  // @return true if memory object is found, false otherwise.
+  bool FreeMemory(MemoryId mem_id);
+
+  // Sets the max number of freed memory regions of each size that are kept
+  // mapped, so that Allocate() can reuse them instead of allocating new
+  // ones. A reused region is cleared. The default, 0, disables the pool.
+  //
+  // @param capacity max number of pooled regions per size.
+  void SetPoolCapacity(size_t capacity);
+
+  // Allocates memory regions of size mem_size into the pool, up to the pool
+  // capacity, e.g. before a test that allocates many regions of that size.
+  //
+  // @param mem_size size of the memory regions.
+  // @param count    number of regions to allocate.
+  //
+  // @return number of regions added to the pool.
+  size_t FillPool(size_t mem_size, size_t count);
+
   // Notify that caller will possibly write to all memory region with id mem_id.
   //
   // @param mem_id identifies the memory object.
@@ -149,6 +189,44 @@ class VtsHidlMemoryDriver {
   bool ReadBytes(MemoryId mem_id, char* read_data, uint64_t length,
                  uint64_t start = 0);
 
+  // Writes several ranges of the memory at once, e.g. to fill a buffer made
+  // of separate planes or channels with a single request.
+  // If bracket is set, calls UpdateRange on each range before writing, and
+  // Commit after, so that the caller doesn't have to.
+  //
+  // @param mem_id      identifies the memory object.
+  // @param ranges      ranges of the memory to be written.
+  // @param range_count number of ranges.
+  // @param write_data  the bytes of all the ranges, in order.
+  // @param length      number of bytes in write_data, which must be the
+  //                    total length of the ranges.
+  // @param bracket     whether to call UpdateRange and Commit.
+  //
+  // @return true if memory object is found and the ranges are within the
+  //              memory, false otherwise.
+  bool UpdateRanges(MemoryId mem_id, const MemoryRange* ranges,
+                    size_t range_count, const char* write_data,
+                    uint64_t length, bool bracket);
+
+  // Reads several ranges of the memory at once.
+  // If bracket is set, calls ReadRange on each range before reading, and
+  // Commit after.
+  //
+  // @param mem_id      identifies the memory object.
+  // @param ranges      ranges of the memory to be read.
+  // @param range_count number of ranges.
+  // @param read_data   buffer to be filled with the bytes of all the ranges,
+  //                    in order.
+  // @param length      size of read_data, which must be the total length of
+  //                    the ranges.
+  // @param bracket     whether to call ReadRange and Commit.
+  //
+  // @return true if memory object is found and the ranges are within the
+  //              memory, false otherwise.
+  bool ReadRanges(MemoryId mem_id, const MemoryRange* ranges,
+                  size_t range_count, char* read_data, uint64_t length,
+                  bool bracket);
+
   // Caller signals done with reading from or writing to memory.
   //
   // @param mem_id identifies the memory object.
@@ -171,6 +249,19 @@ class VtsHidlMemoryDriver {
   // @return true if memory object is found, false otherwise.
   bool GetHidlMemoryAddress(MemoryId mem_id, size_t* result);
 
+  // Get the address of a range of the mapped memory, e.g. to use the bytes
+  // in place as a HAL function call argument.
+  //
+  // @param mem_id identifies the memory object.
+  // @param start  starting index of the range.
+  // @param length number of bytes in the range.
+  // @param result stores the address of the first byte of the range.
+  //
+  // @return true if memory object is found and the range is within the
+  //              memory, false otherwise.
+  bool GetRangeAddress(MemoryId mem_id, uint64_t start, uint64_t length,
+                       size_t* result);
+
  private:
   // Finds the memory object with ID mem_id.
   // Logs error if mem_id is not found.
@@ -178,16 +269,61 @@ class VtsHidlMemoryDriver {
   // @param mem_id identifies the memory object.
   //
   // @return MemoryInfo pointer, which contains both hidl_memory pointer and
-  //         IMemory pointer.
-  MemoryInfo* FindMemory(MemoryId mem_id);
+  //         IMemory pointer. It stays valid while it is held, even if the
+  //         memory is freed meanwhile.
+  shared_ptr<MemoryInfo> FindMemory(MemoryId mem_id);
+
+  // Checks that ranges are within the memory and that their total length is
+  // length. Logs error otherwise.
+  //
+  // @param mem_info    the memory object.
+  // @param ranges      ranges of the memory.
+  // @param range_count number of ranges.
+  // @param length      expected total length of the ranges.
+  //
+  // @return true if the ranges are valid, false otherwise.
+  bool CheckRanges(MemoryInfo* mem_info, const MemoryRange* ranges,
+                   size_t range_count, uint64_t length);
+
+  // Allocates and maps a new memory region with the ashmem allocator.
+  //
+  // @param mem_size size of the memory.
+  //
+  // @return the memory object, nullptr if allocation fails.
+  unique_ptr<MemoryInfo> AllocateRegion(size_t mem_size);
+
+  // Returns the ashmem allocator service, nullptr if it's unavailable.
+  sp<IAllocator> GetAllocator();
+
+  // Takes a free memory region of size mem_size from the pool.
+  //
+  // @param mem_size size of the memory.
+  //
+  // @return the memory object, nullptr if there is none in the pool.
+  shared_ptr<MemoryInfo> TakeFromPool(size_t mem_size);
+
+  // Puts a free memory region into the pool, or drops it if the pool is
+  // full, the region can't be pooled or it is still in use.
+  //
+  // @param mem_info the memory object.
+  void ReturnToPool(shared_ptr<MemoryInfo> mem_info);
 
   // A map to keep track of each hidl_memory information.
   // Store MemoryInfo smart pointer, which contains both hidl_memory,
-  // and actual memory pointer.
-  unordered_map<MemoryId, unique_ptr<MemoryInfo>> hidl_memory_map_;
+  // and actual memory pointer. The map is thread-safe.
+  VtsResourceIdMap<MemoryInfo> hidl_memory_map_;
+
+  // protects ashmem_allocator_.
+  mutex allocator_lock_;
+  // the ashmem allocator service, fetched on first use.
+  sp<IAllocator> ashmem_allocator_;
 
-  // A mutex to ensure insert and lookup on hidl_memory_map_ are thread-safe.
-  mutex map_mutex_;
+  // protects pool_capacity_ and memory_pool_.
+  mutex pool_lock_;
+  // max number of pooled regions per size.
+  size_t pool_capacity_ = 0;
+  // the free memory regions, keyed by their size.
+  map<size_t, vector<shared_ptr<MemoryInfo>>> memory_pool_;
 };
 
 }  // namespace vts
@@ -0,0 +1,200 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef __VTS_RESOURCE_VTSRESOURCEIDMAP_H
+#define __VTS_RESOURCE_VTSRESOURCEIDMAP_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// A map from ids to the resource objects owned by a driver.
+// The low bits of an id are the index of a slot, and the high bits are the
+// generation of the slot. The slot of a removed object is reused by the
+// next insertion with the next generation, so the indices stay dense, and
+// an id of a removed object is rejected instead of referring to the new
+// object. Thread-safe, all operations are O(1). Find() doesn't take the
+// map lock, so that the lookups of concurrent operations on different
+// objects don't contend; only Insert() and Remove() synchronize with each
+// other. The slots are allocated in chunks that never move, so Find() can
+// read them while others are added. The objects are shared, so an object
+// found by one thread stays valid until it is released, even if another
+// thread removes it meanwhile.
+// Example:
+//   VtsResourceIdMap<hidl_handle> handles;
+//   int id = handles.Insert(make_shared<hidl_handle>());
+//   shared_ptr<hidl_handle> handle = handles.Find(id);
+//   handles.Remove(id);  // now handles.Find(id) returns nullptr, but
+//                        // handle is valid until it is released.
+template <typename T>
+class VtsResourceIdMap {
+ public:
+  // number of bits of the slot index in an id.
+  static constexpr int kIndexBits = 20;
+  // max number of objects in the map.
+  static constexpr int kMaxSlots = 1 << kIndexBits;
+  // generations wrap around at this value, which keeps the ids positive.
+  static constexpr int kMaxGenerations = 1 << (31 - kIndexBits);
+  // number of bits of the index of a slot in its chunk.
+  static constexpr int kChunkBits = 10;
+  static constexpr int kChunkSize = 1 << kChunkBits;
+  static constexpr int kMaxChunks = kMaxSlots / kChunkSize;
+
+  VtsResourceIdMap() : slot_count_(0) {
+    for (auto& chunk : chunks_) {
+      chunk.store(nullptr, memory_order_relaxed);
+    }
+  }
+
+  ~VtsResourceIdMap() {
+    Clear();
+    for (auto& chunk : chunks_) {
+      delete[] chunk.load(memory_order_relaxed);
+    }
+  }
+
+  VtsResourceIdMap(const VtsResourceIdMap&) = delete;
+  VtsResourceIdMap& operator=(const VtsResourceIdMap&) = delete;
+
+  // Inserts an object into the map.
+  //
+  // @param object the object to share.
+  //
+  // @return id of the object, -1 if object is nullptr or the map is full.
+  int Insert(shared_ptr<T> object) {
+    if (object == nullptr) return -1;
+    lock_guard<mutex> lock(lock_);
+    int index;
+    if (!free_indices_.empty()) {
+      index = free_indices_.back();
+      free_indices_.pop_back();
+    } else if (slot_count_ < kMaxSlots) {
+      index = slot_count_++;
+      atomic<Slot*>& chunk = chunks_[index >> kChunkBits];
+      if (chunk.load(memory_order_relaxed) == nullptr) {
+        chunk.store(new Slot[kChunkSize], memory_order_release);
+      }
+    } else {
+      return -1;
+    }
+    Slot& slot = GetSlot(index);
+    int id = (slot.generation << kIndexBits) | index;
+    atomic_store_explicit(&slot.object, move(object), memory_order_relaxed);
+    // publishes the object to Find() with its id.
+    slot.id.store(id, memory_order_release);
+    return id;
+  }
+
+  // Finds an object in the map. Doesn't take the map lock.
+  //
+  // @param id identifies the object.
+  //
+  // @return the object, nullptr if id is invalid or the object has been
+  //         removed.
+  shared_ptr<T> Find(int id) const {
+    if (id < 0) return nullptr;
+    int index = id & (kMaxSlots - 1);
+    const Slot* chunk =
+        chunks_[index >> kChunkBits].load(memory_order_acquire);
+    if (chunk == nullptr) return nullptr;
+    const Slot& slot = chunk[index & (kChunkSize - 1)];
+    if (slot.id.load(memory_order_acquire) != id) return nullptr;
+    shared_ptr<T> object =
+        atomic_load_explicit(&slot.object, memory_order_acquire);
+    // the object may have been removed, and the slot reused, meanwhile.
+    if (slot.id.load(memory_order_acquire) != id) return nullptr;
+    return object;
+  }
+
+  // Removes an object from the map, and frees the id.
+  //
+  // @param id identifies the object.
+  //
+  // @return the removed object, nullptr if id is invalid or the object has
+  //         already been removed. Objects found before the removal may
+  //         still share it.
+  shared_ptr<T> Remove(int id) {
+    lock_guard<mutex> lock(lock_);
+    if (id < 0 || (id & (kMaxSlots - 1)) >= slot_count_) return nullptr;
+    int index = id & (kMaxSlots - 1);
+    Slot& slot = GetSlot(index);
+    if (slot.id.load(memory_order_relaxed) != id) return nullptr;
+    return RemoveSlot(index);
+  }
+
+  // Removes all the objects.
+  void Clear() {
+    lock_guard<mutex> lock(lock_);
+    for (int index = 0; index < slot_count_; index++) {
+      if (GetSlot(index).id.load(memory_order_relaxed) != -1) {
+        RemoveSlot(index);
+      }
+    }
+  }
+
+ private:
+  // a slot for one object.
+  struct Slot {
+    // the id of the object, -1 if the slot is free.
+    atomic<int> id{-1};
+    // the object, shared by the map, nullptr if the slot is free. Only
+    // accessed with the atomic shared_ptr functions.
+    shared_ptr<T> object;
+    // incremented every time the object is removed. Only accessed with
+    // lock_ held.
+    int generation = 0;
+  };
+
+  // Returns the slot of index, which must be below slot_count_.
+  Slot& GetSlot(int index) {
+    return chunks_[index >> kChunkBits].load(
+        memory_order_relaxed)[index & (kChunkSize - 1)];
+  }
+
+  // Removes the object in the slot of index, and frees the slot.
+  // Must be called with lock_ held.
+  shared_ptr<T> RemoveSlot(int index) {
+    Slot& slot = GetSlot(index);
+    // hides the object from Find() before it is returned.
+    slot.id.store(-1, memory_order_release);
+    shared_ptr<T> object = atomic_exchange_explicit(
+        &slot.object, shared_ptr<T>(), memory_order_relaxed);
+    slot.generation = (slot.generation + 1) % kMaxGenerations;
+    free_indices_.push_back(index);
+    return object;
+  }
+
+  // protects slot_count_, free_indices_, the generations of the slots, and
+  // the changes of the slots and chunks.
+  mutex lock_;
+  // the chunks of slots, allocated as needed. The slot of index i is at
+  // chunks_[i / kChunkSize][i % kChunkSize].
+  atomic<Slot*> chunks_[kMaxChunks];
+  // the number of slots used so far.
+  int slot_count_;
+  // indices of the free slots.
+  vector<int> free_indices_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  //__VTS_RESOURCE_VTSRESOURCEIDMAP_H
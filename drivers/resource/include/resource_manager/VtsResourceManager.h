@@ -25,11 +25,21 @@
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/text_format.h>
 
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "fmq_driver/VtsFmqDriver.h"
 #include "hidl_handle_driver/VtsHidlHandleDriver.h"
 #include "hidl_memory_driver/VtsHidlMemoryDriver.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 #include "test/vts/proto/VtsResourceControllerMessage.pb.h"
+#include "utils/TypeConversionUtil.h"
 
 using namespace std;
 
@@ -134,6 +144,19 @@ class VtsResourceManager {
   bool GetHidlMemoryAddress(const VariableSpecificationMessage& hidl_memory_msg,
                             size_t* result);
 
+  // Gets the address of a range of a memory object in hidl_memory_driver_.
+  // If caller wants to pass the bytes of a memory object as an argument, it
+  // specifies the mem_id and the range in MemoryRegionMessage.
+  //
+  // @param region contains memory object mem_id and the range.
+  // @param result stores the address of the first byte of the range.
+  //
+  // @return true if the memory object with mem_id is found and contains the
+  //              range, and stores the address in result,
+  //         false otherwise.
+  bool GetHidlMemoryRegionAddress(const MemoryRegionMessage& region,
+                                  size_t* result);
+
   // Processes command for operations on Fast Message Queue.
   // The arguments are specified in fmq_request, and this function stores result
   // in fmq_response.
@@ -170,6 +193,22 @@ class VtsResourceManager {
   bool GetQueueDescAddress(const VariableSpecificationMessage& queue_msg,
                            size_t* result);
 
+  // Sets where the HAL driver shared libraries with the translation
+  // functions of user-defined FMQ types are loaded from. The default is
+  // /data/local/tmp/ with the bitness of this process.
+  //
+  // @param base_path dir containing a dir per bitness.
+  // @param bitness   32 or 64.
+  void SetDriverLibPath(const string& base_path, int bitness);
+
+  // Sets the max number of freed hidl_memory regions of each size kept for
+  // reuse, see VtsHidlMemoryDriver::SetPoolCapacity().
+  //
+  // @param capacity max number of pooled regions per size.
+  void SetHidlMemoryPoolCapacity(size_t capacity) {
+    hidl_memory_driver_.SetPoolCapacity(capacity);
+  }
+
  private:
   // Function template used in our map that maps type name to function
   // with template.
@@ -190,6 +229,61 @@ class VtsResourceManager {
   void ProcessFmqCommandWithType(const FmqRequestMessage& fmq_request,
                                  FmqResponseMessage* fmq_response);
 
+  // Returns true if the items of type T in a queue of data_type can be sent
+  // as raw bytes, i.e. if T is a scalar type whose every bit pattern is
+  // valid, or a user-defined type marked as POD in the conversion table of
+  // its driver library, see VtsTypeConversionEntry.
+  //
+  // @param data_type type name.
+  template <typename T>
+  bool IsRawFmqData(const string& data_type);
+
+  // Writes the write_data_raw bytes in fmq_request straight into the slots of
+  // the queue, through a zero-copy write.
+  //
+  // @param fmq_request contains the queue and write_data_raw.
+  //
+  // @return true if the data is written, false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool WriteFmqRaw(const FmqRequestMessage& fmq_request);
+
+  // Reads read_data_size items from the queue straight into read_data_raw of
+  // fmq_response, through a zero-copy read.
+  //
+  // @param fmq_request  contains the queue and read_data_size.
+  // @param fmq_response to be filled by the function.
+  //
+  // @return true if the data is read, false otherwise.
+  template <typename T, hardware::MQFlavor flavor>
+  bool ReadFmqRaw(const FmqRequestMessage& fmq_request,
+                  FmqResponseMessage* fmq_response);
+
+  // A reusable buffer for the data read from or written to a queue, so that
+  // the requests don't allocate their data.
+  struct FmqScratchBuffer {
+    // held while a request uses the buffer.
+    mutex lock;
+    // the buffer, aligned for any scalar type.
+    vector<max_align_t> data;
+
+    // Returns the buffer as an array of count items, growing it if needed.
+    template <typename T>
+    T* Get(size_t count) {
+      size_t size = (count * sizeof(T) + sizeof(max_align_t) - 1) /
+                    sizeof(max_align_t);
+      if (data.size() < size) data.resize(size);
+      return reinterpret_cast<T*>(data.data());
+    }
+  };
+
+  // Returns the scratch buffer used to read from or write to a queue.
+  //
+  // @param queue_id queue id.
+  // @param is_read  whether the buffer is used to read from the queue.
+  //
+  // @return the buffer of the queue, created on the first call.
+  FmqScratchBuffer* GetFmqScratchBuffer(int queue_id, bool is_read);
+
   // A helper method to call methods on fmq_driver.
   // This method already has the template type and flavor of FMQ.
   //
@@ -199,7 +293,8 @@ class VtsResourceManager {
   void ProcessFmqCommandInternal(const FmqRequestMessage& fmq_request,
                                  FmqResponseMessage* fmq_response);
 
-  // Converts write_data field in fmq_request to a C++ buffer.
+  // Converts write_data field in fmq_request to a C++ buffer, or copies
+  // write_data_raw if it is set and the type can be sent as raw bytes.
   // For user-defined type, dynamically load the HAL shared library
   // to parse protobuf message to C++ type.
   //
@@ -221,59 +316,86 @@ class VtsResourceManager {
   //
   // @param fmq_response   to be filled by the function. The function fills the
   //                       read_data field, which is represented as a repeated
-  //                       proto field.
+  //                       proto field, or read_data_raw if raw is true.
   // @param data_type      type of data in FMQ, this information will be
   //                       written into protobuf message.
   // @param read_data      contains data read from FMQ read operation.
   // @param read_data_size number of items in read_data.
+  // @param raw            whether to copy the raw bytes of read_data.
   //
   // @return true if parsing is successful, false otherwise.
   //         This function can fail if loading shared library or locating
   //         function symbols fails in user-defined type.
   template <typename T>
   bool FmqCpp2Proto(FmqResponseMessage* fmq_response, const string& data_type,
-                    T* read_data, size_t read_data_size);
+                    T* read_data, size_t read_data_size, bool raw);
+
+  // Returns the conversion functions between C++ and protobuf for
+  // data_type, see FindTypeConversionEntry.
+  //
+  // @param data_type  type name.
+  // @param conversion to be filled with the functions.
+  //
+  // @return true if found, false otherwise.
+  template <typename T>
+  bool GetFmqTypeConversion(const string& data_type,
+                            VtsTypeConversion<T>* conversion);
+
+  // Returns the conversion table entry of data_type. On the first call for
+  // a type, loads the HAL shared library and the conversion table of the
+  // component that declares the type.
+  //
+  // @param data_type type name.
+  // @param entry     stores a copy of the entry.
+  //
+  // @return true if the entry is found, false otherwise.
+  bool FindTypeConversionEntry(const string& data_type,
+                               VtsTypeConversionEntry* entry);
 
   // Loads the corresponding HAL driver shared library from the type name.
   // This function parses the shared library path from a type name, and
-  // loads the shared library object from the path.
+  // loads the shared library object from the path, unless it is already
+  // in shared_libs_.
   //
   // Example:
   // For type ::android::hardware::audio::V4_0::IStreamIn::ReadParameters,
   // the path that is parsed from the type name is
-  // /data/local/tmp/android.hardware.audio@4.0-vts.driver.so.
+  // /data/local/tmp/64/android.hardware.audio@4.0-vts.driver.so.
   // Then the function loads the shared library object from this path.
   //
-  // TODO: Consider determining the path and bitness by passing a field
-  // in the protobuf message.
-  //
   // @param data_type type name.
   //
   // @return shared library object.
   void* LoadSharedLibFromTypeName(const string& data_type);
 
-  // Load the translation function between C++ and protobuf.
-  // This method parses the function name that can translate C++ to protobuf
-  // or translate protobuf to C++ from data_type.
-  // Then it loads the function symbol from shared_lib_obj, which is an opened
-  // HAL shared library.
+  // Loads the conversion table of the component that declares data_type
+  // from shared_lib_obj, which is an opened HAL shared library, into
+  // type_conversions_. The table is exported by the generated driver of the
+  // component, see GetTypeConversionsSymbol.
   //
-  // Example: type name is
+  // Example: for type
   // ::android::hardware::audio::V4_0::IStreamIn::ReadParameters,
-  // and we have the shared library pointer shared_lib_obj.
-  // To translate from protobuf to C++, we need to call
-  // GetTranslationFuncPtr(shared_lib_obj, data_type, true);
-  // To translate from C++ to protobuf, we need to call
-  // GetTranslationFuncPtr(shared_lib_obj, data_type, false);
-  //
-  // @param shared_lib_obj  opened HAL shared library object.
-  // @param data_type       type name.
-  // @param is_proto_to_cpp whether the function is to convert proto to C++.
+  // the table of ::android::hardware::audio::V4_0::IStreamIn is loaded, and
+  // the table of ::android::hardware::audio::V4_0::types if the type is not
+  // found there.
   //
-  // @return name of the translation function.
-  void* GetTranslationFuncPtr(void* shared_lib_obj, const string& data_type,
-                              bool is_proto_to_cpp);
+  // @param shared_lib_obj opened HAL shared library object.
+  // @param data_type      type name.
+  void LoadTypeConversions(void* shared_lib_obj, const string& data_type);
 
+  // protects fmq_scratch_buffers_.
+  mutex fmq_scratch_buffers_lock_;
+  // the scratch buffers of the queues, by queue id and whether for reading.
+  map<pair<int, bool>, unique_ptr<FmqScratchBuffer>> fmq_scratch_buffers_;
+  // protects driver_lib_dir_, shared_libs_ and type_conversions_.
+  mutex translation_funcs_lock_;
+  // dir of the HAL driver shared libraries, ending with /.
+  string driver_lib_dir_ =
+      "/data/local/tmp/" + to_string(sizeof(void*) * 8) + "/";
+  // the loaded HAL driver shared libraries, by path.
+  map<string, void*> shared_libs_;
+  // the loaded conversion table entries, by type name.
+  map<string, VtsTypeConversionEntry> type_conversions_;
   // Manages Fast Message Queue (FMQ) driver.
   VtsFmqDriver fmq_driver_;
   // Manages hidl_memory driver.
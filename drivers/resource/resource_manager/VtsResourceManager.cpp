@@ -17,10 +17,14 @@
 
 #include "resource_manager/VtsResourceManager.h"
 
+#include <ctype.h>
 #include <dlfcn.h>
 #include <fcntl.h>
+#include <string.h>
 #include <sys/stat.h>
-#include <regex>
+
+#include <algorithm>
+#include <type_traits>
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 #include "test/vts/proto/VtsResourceControllerMessage.pb.h"
@@ -35,7 +39,11 @@ namespace vts {
 
 VtsResourceManager::VtsResourceManager() {}
 
-VtsResourceManager::~VtsResourceManager() {}
+VtsResourceManager::~VtsResourceManager() {
+  for (const auto& shared_lib : shared_libs_) {
+    dlclose(shared_lib.second);
+  }
+}
 
 void VtsResourceManager::ProcessHidlHandleCommand(
     const HidlHandleRequestMessage& hidl_handle_request,
@@ -47,6 +55,7 @@ void VtsResourceManager::ProcessHidlHandleCommand(
   const void* write_data =
       static_cast<const void*>(hidl_handle_request.write_data().c_str());
   size_t write_data_size = hidl_handle_request.write_data().length();
+  int64_t offset = hidl_handle_request.offset();
   bool success = false;
 
   switch (operation) {
@@ -125,19 +134,59 @@ void VtsResourceManager::ProcessHidlHandleCommand(
       break;
     }
     case HANDLE_PROTO_READ_FILE: {
-      char read_data[read_data_size];
-      // Call API on hidl_handle driver to read the file.
-      ssize_t read_success_bytes = hidl_handle_driver_.ReadFile(
-          handle_id, static_cast<void*>(read_data), read_data_size);
+      if (hidl_handle_request.read_data_vector_sizes_size() > 0) {
+        // Reads into one response buffer per requested size.
+        vector<struct iovec> iov;
+        for (uint64_t size : hidl_handle_request.read_data_vector_sizes()) {
+          string* buffer = hidl_handle_response->add_read_data_vector();
+          buffer->resize(size);
+          iov.push_back({size > 0 ? &(*buffer)[0] : nullptr,
+                         static_cast<size_t>(size)});
+        }
+        ssize_t read_success_bytes =
+            hidl_handle_driver_.ReadFileVector(handle_id, iov.data(),
+                                               iov.size());
+        success = read_success_bytes != -1;
+        size_t left = success ? read_success_bytes : 0;
+        for (string& buffer :
+             *hidl_handle_response->mutable_read_data_vector()) {
+          buffer.resize(min(left, buffer.size()));
+          left -= buffer.size();
+        }
+        break;
+      }
+      // Call API on hidl_handle driver to read the file, straight into the
+      // response.
+      string* read_data = hidl_handle_response->mutable_read_data();
+      read_data->resize(read_data_size);
+      void* read_buffer = read_data_size > 0 ? &(*read_data)[0] : nullptr;
+      ssize_t read_success_bytes =
+          offset == -1
+              ? hidl_handle_driver_.ReadFile(handle_id, read_buffer,
+                                             read_data_size)
+              : hidl_handle_driver_.ReadFileAt(handle_id, read_buffer,
+                                               read_data_size, offset);
       success = read_success_bytes != -1;
-      hidl_handle_response->set_read_data(
-          string(read_data, read_success_bytes));
+      read_data->resize(success ? read_success_bytes : 0);
       break;
     }
     case HANDLE_PROTO_WRITE_FILE: {
       // Call API on hidl_handle driver to write to the file.
-      ssize_t write_success_bytes =
-          hidl_handle_driver_.WriteFile(handle_id, write_data, write_data_size);
+      ssize_t write_success_bytes;
+      if (hidl_handle_request.write_data_vector_size() > 0) {
+        vector<struct iovec> iov;
+        for (const string& buffer : hidl_handle_request.write_data_vector()) {
+          iov.push_back({const_cast<char*>(buffer.data()), buffer.size()});
+        }
+        write_success_bytes = hidl_handle_driver_.WriteFileVector(
+            handle_id, iov.data(), iov.size());
+      } else if (offset == -1) {
+        write_success_bytes = hidl_handle_driver_.WriteFile(
+            handle_id, write_data, write_data_size);
+      } else {
+        write_success_bytes = hidl_handle_driver_.WriteFileAt(
+            handle_id, write_data, write_data_size, offset);
+      }
       success = write_success_bytes != -1;
       hidl_handle_response->set_write_data_size(write_success_bytes);
       break;
@@ -147,6 +196,31 @@ void VtsResourceManager::ProcessHidlHandleCommand(
       success = hidl_handle_driver_.UnregisterHidlHandle(handle_id);
       break;
     }
+    case HANDLE_PROTO_MAP_FILE: {
+      success = hidl_handle_driver_.MapFile(handle_id, max<int64_t>(offset, 0),
+                                            hidl_handle_request.map_length());
+      break;
+    }
+    case HANDLE_PROTO_UNMAP_FILE: {
+      success = hidl_handle_driver_.UnmapFile(handle_id);
+      break;
+    }
+    case HANDLE_PROTO_READ_MAPPED: {
+      string* read_data = hidl_handle_response->mutable_read_data();
+      read_data->resize(read_data_size);
+      success = hidl_handle_driver_.ReadMappedBytes(
+          handle_id, read_data_size > 0 ? &(*read_data)[0] : nullptr,
+          read_data_size, max<int64_t>(offset, 0));
+      if (!success) read_data->clear();
+      break;
+    }
+    case HANDLE_PROTO_WRITE_MAPPED: {
+      success = hidl_handle_driver_.UpdateMappedBytes(
+          handle_id, hidl_handle_request.write_data().data(), write_data_size,
+          max<int64_t>(offset, 0));
+      if (success) hidl_handle_response->set_write_data_size(write_data_size);
+      break;
+    }
     default:
       LOG(ERROR) << "Unknown operation.";
       break;
@@ -213,9 +287,66 @@ void VtsResourceManager::ProcessHidlMemoryCommand(
       break;
     }
     case MEM_PROTO_READ_BYTES: {
-      char read_data[length];
-      success = hidl_memory_driver_.ReadBytes(mem_id, read_data, length, start);
-      hidl_memory_response->set_read_data(string(read_data, length));
+      // The response is sized before the driver checks the range, so the
+      // range is bounded by the size of the memory here.
+      size_t mem_size;
+      if (!hidl_memory_driver_.GetSize(mem_id, &mem_size)) break;
+      if (start > mem_size || length > mem_size - start) {
+        LOG(ERROR) << "Range [" << start << ", " << start + length
+                   << ") is out of the memory of size " << mem_size;
+        break;
+      }
+      // Reads straight into the response.
+      string* read_data = hidl_memory_response->mutable_read_data();
+      read_data->resize(length);
+      success = hidl_memory_driver_.ReadBytes(mem_id, &(*read_data)[0],
+                                              length, start);
+      if (!success) read_data->clear();
+      break;
+    }
+    case MEM_PROTO_READ_RANGES:
+    case MEM_PROTO_UPDATE_RANGES: {
+      // The driver checks the ranges, but the ranges and the response are
+      // sized before, so they are bounded by the size of the memory here.
+      size_t mem_size;
+      if (!hidl_memory_driver_.GetSize(mem_id, &mem_size)) break;
+      if (static_cast<size_t>(hidl_memory_request.ranges_size()) > mem_size) {
+        LOG(ERROR) << hidl_memory_request.ranges_size()
+                   << " ranges are more than the bytes of the memory of size "
+                   << mem_size;
+        break;
+      }
+      vector<MemoryRange> ranges;
+      ranges.reserve(hidl_memory_request.ranges_size());
+      for (const auto& range : hidl_memory_request.ranges()) {
+        ranges.push_back({range.start(), range.length()});
+      }
+      bool bracket = hidl_memory_request.bracket();
+      if (hidl_memory_request.operation() == MEM_PROTO_UPDATE_RANGES) {
+        success = hidl_memory_driver_.UpdateRanges(
+            mem_id, ranges.data(), ranges.size(), write_data.data(),
+            write_data.size(), bracket);
+        break;
+      }
+      // Stops once past the size of the memory, so that the sum can't
+      // overflow.
+      uint64_t total_length = 0;
+      for (const auto& range : ranges) {
+        total_length += range.length;
+        if (total_length > mem_size) break;
+      }
+      if (total_length > mem_size) {
+        LOG(ERROR) << "Ranges of total length " << total_length
+                   << " are longer than the memory of size " << mem_size;
+        break;
+      }
+      // Reads straight into the response.
+      string* read_data = hidl_memory_response->mutable_read_data();
+      read_data->resize(total_length);
+      success = hidl_memory_driver_.ReadRanges(mem_id, ranges.data(),
+                                               ranges.size(), &(*read_data)[0],
+                                               total_length, bracket);
+      if (!success) read_data->clear();
       break;
     }
     case MEM_PROTO_COMMIT: {
@@ -228,6 +359,10 @@ void VtsResourceManager::ProcessHidlMemoryCommand(
       hidl_memory_response->set_mem_size(result_mem_size);
       break;
     }
+    case MEM_PROTO_FREE: {
+      success = hidl_memory_driver_.FreeMemory(mem_id);
+      break;
+    }
     default:
       LOG(ERROR) << "unknown operation in hidl_memory_driver.";
       break;
@@ -255,6 +390,12 @@ bool VtsResourceManager::GetHidlMemoryAddress(
   return success;
 }
 
+bool VtsResourceManager::GetHidlMemoryRegionAddress(
+    const MemoryRegionMessage& region, size_t* result) {
+  return hidl_memory_driver_.GetRangeAddress(region.mem_id(), region.offset(),
+                                             region.length(), result);
+}
+
 void VtsResourceManager::ProcessFmqCommand(const FmqRequestMessage& fmq_request,
                                            FmqResponseMessage* fmq_response) {
   const string& data_type = fmq_request.data_type();
@@ -269,6 +410,15 @@ void VtsResourceManager::ProcessFmqCommand(const FmqRequestMessage& fmq_request,
   }
 }
 
+// Returns the type of data of the queue in queue_msg, the scalar type, or
+// the name of the user-defined type, which is set for the other types.
+static const string& GetFmqDataType(
+    const VariableSpecificationMessage& queue_msg) {
+  const VariableSpecificationMessage& value = queue_msg.fmq_value(0);
+  return value.type() == TYPE_SCALAR ? value.scalar_type()
+                                     : value.predefined_type();
+}
+
 int VtsResourceManager::RegisterFmq(
     const VariableSpecificationMessage& queue_msg) {
   size_t queue_desc_addr = queue_msg.fmq_value(0).fmq_desc_address();
@@ -283,9 +433,7 @@ int VtsResourceManager::RegisterFmq(
   FmqResponseMessage fmq_response;
   fmq_request.set_operation(FMQ_CREATE);
   fmq_request.set_sync(queue_msg.type() == TYPE_FMQ_SYNC);
-  // TODO: support user-defined types in the future, only support scalar types
-  // for now.
-  fmq_request.set_data_type(queue_msg.fmq_value(0).scalar_type());
+  fmq_request.set_data_type(GetFmqDataType(queue_msg));
   fmq_request.set_queue_desc_addr(queue_desc_addr);
   ProcessFmqCommand(fmq_request, &fmq_response);
   return fmq_response.queue_id();
@@ -297,9 +445,7 @@ bool VtsResourceManager::GetQueueDescAddress(
   FmqResponseMessage fmq_response;
   fmq_request.set_operation(FMQ_GET_DESC_ADDR);
   fmq_request.set_sync(queue_msg.type() == TYPE_FMQ_SYNC);
-  // TODO: support user-defined types in the future, only support scalar types
-  // for now.
-  fmq_request.set_data_type(queue_msg.fmq_value(0).scalar_type());
+  fmq_request.set_data_type(GetFmqDataType(queue_msg));
   fmq_request.set_queue_id(queue_msg.fmq_value(0).fmq_id());
   ProcessFmqCommand(fmq_request, &fmq_response);
   bool success = fmq_response.success();
@@ -307,6 +453,13 @@ bool VtsResourceManager::GetQueueDescAddress(
   return success;
 }
 
+// Returns true if the items of type T can be sent as raw bytes, i.e. if T
+// is a scalar type whose every bit pattern is valid.
+template <typename T>
+static constexpr bool IsRawFmqType() {
+  return is_arithmetic<T>::value && !is_same<T, bool>::value;
+}
+
 template <typename T>
 void VtsResourceManager::ProcessFmqCommandWithType(
     const FmqRequestMessage& fmq_request, FmqResponseMessage* fmq_response) {
@@ -328,22 +481,51 @@ void VtsResourceManager::ProcessFmqCommandInternal(
   size_t queue_size = fmq_request.queue_size();
   bool blocking = fmq_request.blocking();
   bool reset_pointers = fmq_request.reset_pointers();
-  size_t write_data_size = fmq_request.write_data_size();
-  T write_data[write_data_size];
+  size_t write_data_size = fmq_request.has_write_data_raw()
+                               ? fmq_request.write_data_raw().size() / sizeof(T)
+                               : fmq_request.write_data_size();
   size_t read_data_size = fmq_request.read_data_size();
-  T read_data[read_data_size];
   size_t queue_desc_addr = fmq_request.queue_desc_addr();
   int64_t time_out_nanos = fmq_request.time_out_nanos();
-  // TODO: The three variables below are manually created.
-  // In the future, get these from host side when we support long-form
-  // blocking from host side.
-  uint32_t read_notification = 0;
-  uint32_t write_notification = 0;
-  atomic<uint32_t> event_flag_word;
+  uint32_t read_notification = fmq_request.read_notification();
+  uint32_t write_notification = fmq_request.write_notification();
+  int event_flag_queue_id = fmq_request.event_flag_queue_id();
+  // nullptr for the long-form blocking operations to use the event flag of
+  // the queue itself.
+  atomic<uint32_t>* event_flag_word = nullptr;
   bool success = false;
   size_t sizet_result;
 
-  switch (fmq_request.operation()) {
+  size_t transaction_count = fmq_request.transaction_count();
+  bool raw_read_data = fmq_request.raw_read_data();
+
+  // Borrows the scratch buffer of the queue for the data read or written,
+  // unless the raw data is copied straight from or to the queue.
+  FmqOp operation = fmq_request.operation();
+  bool is_read = operation == FMQ_READ || operation == FMQ_READ_BLOCKING ||
+                 operation == FMQ_READ_BLOCKING_LONG ||
+                 operation == FMQ_READ_TRANSACTIONS;
+  bool is_write = operation == FMQ_WRITE || operation == FMQ_WRITE_BLOCKING ||
+                  operation == FMQ_WRITE_BLOCKING_LONG ||
+                  operation == FMQ_WRITE_TRANSACTIONS;
+  bool zero_copy =
+      ((operation == FMQ_READ && raw_read_data) ||
+       (operation == FMQ_WRITE && fmq_request.has_write_data_raw())) &&
+      IsRawFmqData<T>(data_type);
+  unique_lock<mutex> buffer_lock;
+  T* read_data = nullptr;
+  T* write_data = nullptr;
+  if ((is_read || is_write) && !zero_copy) {
+    FmqScratchBuffer* buffer = GetFmqScratchBuffer(queue_id, is_read);
+    buffer_lock = unique_lock<mutex>(buffer->lock);
+    if (is_read) {
+      read_data = buffer->Get<T>(read_data_size);
+    } else {
+      write_data = buffer->Get<T>(write_data_size);
+    }
+  }
+
+  switch (operation) {
     case FMQ_CREATE: {
       int new_queue_id = -1;
       if (queue_id == -1) {
@@ -363,10 +545,14 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       break;
     }
     case FMQ_READ: {
+      if (zero_copy) {
+        success = ReadFmqRaw<T, flavor>(fmq_request, fmq_response);
+        break;
+      }
       success = fmq_driver_.ReadFmq<T, flavor>(data_type, queue_id, read_data,
                                                read_data_size);
       if (!FmqCpp2Proto<T>(fmq_response, data_type, read_data,
-                           read_data_size)) {
+                           read_data_size, raw_read_data)) {
         LOG(ERROR) << "Resource manager: failed to convert C++ type into "
                    << "protobuf message for type " << data_type;
         break;
@@ -377,7 +563,7 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       success = fmq_driver_.ReadFmqBlocking<T, flavor>(
           data_type, queue_id, read_data, read_data_size, time_out_nanos);
       if (!FmqCpp2Proto<T>(fmq_response, data_type, read_data,
-                           read_data_size)) {
+                           read_data_size, raw_read_data)) {
         LOG(ERROR) << "Resource manager: failed to convert C++ type into "
                    << "protobuf message for type " << data_type;
         break;
@@ -385,13 +571,16 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       break;
     }
     case FMQ_READ_BLOCKING_LONG: {
-      // TODO: implement a meaningful long-form blocking mechanism
-      // Currently passing a test event flag word.
+      if (event_flag_queue_id != -1 &&
+          !fmq_driver_.GetEventFlagWord(event_flag_queue_id,
+                                        &event_flag_word)) {
+        break;
+      }
       success = fmq_driver_.ReadFmqBlocking<T, flavor>(
           data_type, queue_id, read_data, read_data_size, read_notification,
-          write_notification, time_out_nanos, &event_flag_word);
+          write_notification, time_out_nanos, event_flag_word);
       if (!FmqCpp2Proto<T>(fmq_response, data_type, read_data,
-                           read_data_size)) {
+                           read_data_size, raw_read_data)) {
         LOG(ERROR) << "Resource manager: failed to convert C++ type into "
                    << "protobuf message for type " << data_type;
         break;
@@ -399,6 +588,10 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       break;
     }
     case FMQ_WRITE: {
+      if (zero_copy) {
+        success = WriteFmqRaw<T, flavor>(fmq_request);
+        break;
+      }
       if (!FmqProto2Cpp<T>(fmq_request, write_data, write_data_size)) {
         LOG(ERROR) << "Resource manager: failed to convert protobuf message "
                    << "into C++ types for type " << data_type;
@@ -419,8 +612,11 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       break;
     }
     case FMQ_WRITE_BLOCKING_LONG: {
-      // TODO: implement a meaningful long-form blocking mechanism
-      // Currently passing a test event flag word.
+      if (event_flag_queue_id != -1 &&
+          !fmq_driver_.GetEventFlagWord(event_flag_queue_id,
+                                        &event_flag_word)) {
+        break;
+      }
       if (!FmqProto2Cpp<T>(fmq_request, write_data, write_data_size)) {
         LOG(ERROR) << "Resource manager: failed to convert protobuf message "
                    << "into C++ types for type " << data_type;
@@ -428,7 +624,33 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       }
       success = fmq_driver_.WriteFmqBlocking<T, flavor>(
           data_type, queue_id, write_data, write_data_size, read_notification,
-          write_notification, time_out_nanos, &event_flag_word);
+          write_notification, time_out_nanos, event_flag_word);
+      break;
+    }
+    case FMQ_WRITE_TRANSACTIONS: {
+      if (!FmqProto2Cpp<T>(fmq_request, write_data, write_data_size)) {
+        LOG(ERROR) << "Resource manager: failed to convert protobuf message "
+                   << "into C++ types for type " << data_type;
+        break;
+      }
+      success = fmq_driver_.WriteFmqTransactions<T, flavor>(
+          data_type, queue_id, write_data, write_data_size, transaction_count,
+          &sizet_result);
+      fmq_response->set_sizet_return_val(sizet_result);
+      break;
+    }
+    case FMQ_READ_TRANSACTIONS: {
+      success = fmq_driver_.ReadFmqTransactions<T, flavor>(
+          data_type, queue_id, read_data, read_data_size, transaction_count,
+          &sizet_result);
+      if (!success) break;
+      fmq_response->set_sizet_return_val(sizet_result);
+      if (sizet_result > 0 &&
+          !FmqCpp2Proto<T>(fmq_response, data_type, read_data,
+                           read_data_size, raw_read_data)) {
+        LOG(ERROR) << "Resource manager: failed to convert C++ type into "
+                   << "protobuf message for type " << data_type;
+      }
       break;
     }
     case FMQ_AVAILABLE_WRITE: {
@@ -465,222 +687,236 @@ void VtsResourceManager::ProcessFmqCommandInternal(
       fmq_response->set_sizet_return_val(sizet_result);
       break;
     }
+    case FMQ_WAIT_EVENT_FLAG: {
+      uint32_t woken_bits;
+      success = fmq_driver_.WaitEventFlag(
+          event_flag_queue_id != -1 ? event_flag_queue_id : queue_id,
+          fmq_request.event_flag_bits(), time_out_nanos, &woken_bits);
+      fmq_response->set_sizet_return_val(success ? woken_bits : 0);
+      break;
+    }
+    case FMQ_WAKE_EVENT_FLAG: {
+      success = fmq_driver_.WakeEventFlag(
+          event_flag_queue_id != -1 ? event_flag_queue_id : queue_id,
+          fmq_request.event_flag_bits());
+      break;
+    }
     default:
       LOG(ERROR) << "Resource manager: Unsupported FMQ operation.";
   }
   fmq_response->set_success(success);
 }
 
+template <typename T>
+bool VtsResourceManager::IsRawFmqData(const string& data_type) {
+  if constexpr (VtsScalarTraits<T>::kIsScalar) {
+    return IsRawFmqType<T>();
+  } else {
+    // The entry is loaded once, and the items are then copied in a batch
+    // instead of converted one by one.
+    VtsTypeConversionEntry entry;
+    return FindTypeConversionEntry(data_type, &entry) &&
+           entry.type_size == sizeof(T) && entry.is_pod;
+  }
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsResourceManager::WriteFmqRaw(const FmqRequestMessage& fmq_request) {
+  const string& raw_data = fmq_request.write_data_raw();
+  if (raw_data.size() % sizeof(T) != 0) {
+    LOG(ERROR) << "Resource manager: invalid raw data of size "
+               << raw_data.size() << " for type " << fmq_request.data_type();
+    return false;
+  }
+  size_t data_size = raw_data.size() / sizeof(T);
+  typename MessageQueue<T, flavor>::MemTransaction transaction;
+  if (!fmq_driver_.BeginWriteFmq<T, flavor>(fmq_request.data_type(),
+                                            fmq_request.queue_id(), data_size,
+                                            &transaction)) {
+    return false;
+  }
+  // the transaction wraps around the end of the queue in a second region.
+  const auto& first = transaction.getFirstRegion();
+  const auto& second = transaction.getSecondRegion();
+  size_t first_bytes = first.getLengthInBytes();
+  if (first_bytes > 0) {
+    memcpy(first.getAddress(), raw_data.data(), first_bytes);
+  }
+  if (second.getLengthInBytes() > 0) {
+    memcpy(second.getAddress(), raw_data.data() + first_bytes,
+           second.getLengthInBytes());
+  }
+  return fmq_driver_.CommitWriteFmq<T, flavor>(
+      fmq_request.data_type(), fmq_request.queue_id(), data_size);
+}
+
+template <typename T, hardware::MQFlavor flavor>
+bool VtsResourceManager::ReadFmqRaw(const FmqRequestMessage& fmq_request,
+                                    FmqResponseMessage* fmq_response) {
+  size_t data_size = fmq_request.read_data_size();
+  typename MessageQueue<T, flavor>::MemTransaction transaction;
+  if (!fmq_driver_.BeginReadFmq<T, flavor>(fmq_request.data_type(),
+                                           fmq_request.queue_id(), data_size,
+                                           &transaction)) {
+    return false;
+  }
+  const auto& first = transaction.getFirstRegion();
+  const auto& second = transaction.getSecondRegion();
+  string* raw_data = fmq_response->mutable_read_data_raw();
+  raw_data->reserve(data_size * sizeof(T));
+  raw_data->assign(reinterpret_cast<const char*>(first.getAddress()),
+                   first.getLengthInBytes());
+  if (second.getLengthInBytes() > 0) {
+    raw_data->append(reinterpret_cast<const char*>(second.getAddress()),
+                     second.getLengthInBytes());
+  }
+  return fmq_driver_.CommitReadFmq<T, flavor>(
+      fmq_request.data_type(), fmq_request.queue_id(), data_size);
+}
+
+VtsResourceManager::FmqScratchBuffer* VtsResourceManager::GetFmqScratchBuffer(
+    int queue_id, bool is_read) {
+  lock_guard<mutex> lock(fmq_scratch_buffers_lock_);
+  unique_ptr<FmqScratchBuffer>& buffer =
+      fmq_scratch_buffers_[make_pair(queue_id, is_read)];
+  if (!buffer) buffer.reset(new FmqScratchBuffer());
+  return buffer.get();
+}
+
 template <typename T>
 bool VtsResourceManager::FmqProto2Cpp(const FmqRequestMessage& fmq_request,
                                       T* write_data, size_t write_data_size) {
   const string& data_type = fmq_request.data_type();
-  // Read from different proto fields based on type.
-  if (data_type == "int8_t") {
-    int8_t* convert_data = reinterpret_cast<int8_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = (fmq_request.write_data(i).scalar_value().int8_t());
-    }
-  } else if (data_type == "uint8_t") {
-    uint8_t* convert_data = reinterpret_cast<uint8_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().uint8_t();
-    }
-  } else if (data_type == "int16_t") {
-    int16_t* convert_data = reinterpret_cast<int16_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().int16_t();
-    }
-  } else if (data_type == "uint16_t") {
-    uint16_t* convert_data = reinterpret_cast<uint16_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().uint16_t();
-    }
-  } else if (data_type == "int32_t") {
-    int32_t* convert_data = reinterpret_cast<int32_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().int32_t();
-    }
-  } else if (data_type == "uint32_t") {
-    uint32_t* convert_data = reinterpret_cast<uint32_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().uint32_t();
-    }
-  } else if (data_type == "int64_t") {
-    int64_t* convert_data = reinterpret_cast<int64_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().int64_t();
-    }
-  } else if (data_type == "uint64_t") {
-    uint64_t* convert_data = reinterpret_cast<uint64_t*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().uint64_t();
-    }
-  } else if (data_type == "float_t") {
-    float* convert_data = reinterpret_cast<float*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().float_t();
-    }
-  } else if (data_type == "double_t") {
-    double* convert_data = reinterpret_cast<double*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().double_t();
-    }
-  } else if (data_type == "bool_t") {
-    bool* convert_data = reinterpret_cast<bool*>(write_data);
-    for (int i = 0; i < write_data_size; i++) {
-      convert_data[i] = fmq_request.write_data(i).scalar_value().bool_t();
+  if (fmq_request.has_write_data_raw()) {
+    const string& raw_data = fmq_request.write_data_raw();
+    if (!IsRawFmqData<T>(data_type) || raw_data.size() % sizeof(T) != 0) {
+      LOG(ERROR) << "Resource manager: invalid raw data of size "
+                 << raw_data.size() << " for type " << data_type;
+      return false;
+    }
+    memcpy(write_data, raw_data.data(), raw_data.size());
+    return true;
+  }
+  if constexpr (VtsScalarTraits<T>::kIsScalar) {
+    for (size_t i = 0; i < write_data_size; i++) {
+      write_data[i] =
+          VtsScalarTraits<T>::Get(fmq_request.write_data(i).scalar_value());
     }
   } else {
     // Encounter a predefined type in HAL service.
-    LOG(INFO) << "Resource manager: detected host side specifies a "
-              << "predefined type.";
-    void* shared_lib_obj = LoadSharedLibFromTypeName(data_type);
-
-    // Locate the symbol for the translation function.
-    typedef void (*parse_fn)(const VariableSpecificationMessage&, T*,
-                             const string&);
-    parse_fn parser =
-        (parse_fn)(GetTranslationFuncPtr(shared_lib_obj, data_type, true));
-    if (!parser) return false;  // Error logged in helper function.
-
+    VtsTypeConversion<T> conversion;
+    if (!GetFmqTypeConversion(data_type, &conversion)) {
+      return false;  // Error logged in helper function.
+    }
     // Parse the data from protobuf to C++.
-    for (int i = 0; i < write_data_size; i++) {
-      (*parser)(fmq_request.write_data(i), &write_data[i], "");
+    for (size_t i = 0; i < write_data_size; i++) {
+      conversion.message_to(fmq_request.write_data(i), &write_data[i], "");
     }
-    dlclose(shared_lib_obj);
   }
   return true;
 }
 
-// TODO: support user-defined types, only support primitive types now.
 template <typename T>
 bool VtsResourceManager::FmqCpp2Proto(FmqResponseMessage* fmq_response,
                                       const string& data_type, T* read_data,
-                                      size_t read_data_size) {
+                                      size_t read_data_size, bool raw) {
   fmq_response->clear_read_data();
-  // Write to different proto fields based on type.
-  if (data_type == "int8_t") {
-    int8_t* convert_data = reinterpret_cast<int8_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_int8_t(convert_data[i]);
-    }
-  } else if (data_type == "uint8_t") {
-    uint8_t* convert_data = reinterpret_cast<uint8_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_uint8_t(convert_data[i]);
-    }
-  } else if (data_type == "int16_t") {
-    int16_t* convert_data = reinterpret_cast<int16_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_int16_t(convert_data[i]);
-    }
-  } else if (data_type == "uint16_t") {
-    uint16_t* convert_data = reinterpret_cast<uint16_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_uint16_t(convert_data[i]);
-    }
-  } else if (data_type == "int32_t") {
-    int32_t* convert_data = reinterpret_cast<int32_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_int32_t(convert_data[i]);
-    }
-  } else if (data_type == "uint32_t") {
-    uint32_t* convert_data = reinterpret_cast<uint32_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_uint32_t(convert_data[i]);
-    }
-  } else if (data_type == "int64_t") {
-    int64_t* convert_data = reinterpret_cast<int64_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_int64_t(convert_data[i]);
-    }
-  } else if (data_type == "uint64_t") {
-    uint64_t* convert_data = reinterpret_cast<uint64_t*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_uint64_t(convert_data[i]);
-    }
-  } else if (data_type == "float_t") {
-    float* convert_data = reinterpret_cast<float*>(read_data);
+  if (raw) {
+    if (!IsRawFmqData<T>(data_type)) {
+      LOG(ERROR) << "Resource manager: raw data not supported for type "
+                 << data_type;
+      return false;
+    }
+    fmq_response->set_read_data_raw(read_data, read_data_size * sizeof(T));
+    return true;
+  }
+  fmq_response->mutable_read_data()->Reserve(read_data_size);
+  if constexpr (VtsScalarTraits<T>::kIsScalar) {
     for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_float_t(convert_data[i]);
+      SetScalarResult<T>(fmq_response->add_read_data(), read_data[i]);
     }
-  } else if (data_type == "double_t") {
-    double* convert_data = reinterpret_cast<double*>(read_data);
-    for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_double_t(convert_data[i]);
+  } else {
+    // Encounter a predefined type in HAL service.
+    VtsTypeConversion<T> conversion;
+    if (!GetFmqTypeConversion(data_type, &conversion)) {
+      return false;  // Error logged in helper function.
     }
-  } else if (data_type == "bool_t") {
-    bool* convert_data = reinterpret_cast<bool*>(read_data);
+    // Parse the data from C++ to protobuf.
     for (size_t i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      item->set_type(TYPE_SCALAR);
-      item->set_scalar_type(data_type);
-      (item->mutable_scalar_value())->set_bool_t(convert_data[i]);
+      conversion.set_result(fmq_response->add_read_data(), read_data[i]);
     }
-  } else {
-    // Encounter a predefined type in HAL service.
-    LOG(INFO) << "Resource manager: detected host side specifies a "
-              << "predefined type.";
+  }
+  return true;
+}
+
+void VtsResourceManager::SetDriverLibPath(const string& base_path,
+                                          int bitness) {
+  lock_guard<mutex> lock(translation_funcs_lock_);
+  driver_lib_dir_ = base_path;
+  if (driver_lib_dir_.empty() || driver_lib_dir_.back() != '/') {
+    driver_lib_dir_ += "/";
+  }
+  driver_lib_dir_ += to_string(bitness) + "/";
+  type_conversions_.clear();
+}
+
+template <typename T>
+bool VtsResourceManager::GetFmqTypeConversion(
+    const string& data_type, VtsTypeConversion<T>* conversion) {
+  VtsTypeConversionEntry entry;
+  if (!FindTypeConversionEntry(data_type, &entry)) {
+    return false;  // Error logged in helper function.
+  }
+  if (!GetTypeConversion(entry, conversion)) {
+    LOG(ERROR) << "Resource manager: size of type " << data_type
+               << " doesn't match the one in its driver library.";
+    return false;
+  }
+  return true;
+}
+
+bool VtsResourceManager::FindTypeConversionEntry(
+    const string& data_type, VtsTypeConversionEntry* entry) {
+  lock_guard<mutex> lock(translation_funcs_lock_);
+  auto res = type_conversions_.find(data_type);
+  if (res == type_conversions_.end()) {
     void* shared_lib_obj = LoadSharedLibFromTypeName(data_type);
     if (!shared_lib_obj) return false;
+    LoadTypeConversions(shared_lib_obj, data_type);
+    res = type_conversions_.find(data_type);
+    if (res == type_conversions_.end()) {
+      LOG(ERROR) << "Resource manager: no conversion functions for type "
+                 << data_type << " in its driver library.";
+      return false;
+    }
+  }
+  // Copied under the lock, since SetDriverLibPath may clear the map.
+  *entry = res->second;
+  return true;
+}
 
-    // Locate the symbol for the translation function.
-    typedef void (*set_result_fn)(VariableSpecificationMessage*, T);
-    set_result_fn parser =
-        (set_result_fn)(GetTranslationFuncPtr(shared_lib_obj, data_type, 0));
-    if (!parser) return false;  // Error logged in helper function.
-
-    // Parse the data from C++ to protobuf.
-    for (int i = 0; i < read_data_size; i++) {
-      VariableSpecificationMessage* item = fmq_response->add_read_data();
-      (*parser)(item, read_data[i]);
+// Returns true if str is a version in a type name, e.g. V4_0.
+static bool IsVersionString(const string& str) {
+  size_t separator = str.find('_');
+  if (str.size() < 4 || str[0] != 'V' || separator == string::npos ||
+      separator == 1 || separator == str.size() - 1) {
+    return false;
+  }
+  for (size_t i = 1; i < str.size(); i++) {
+    if (i != separator && !isdigit(static_cast<unsigned char>(str[i]))) {
+      return false;
     }
-    dlclose(shared_lib_obj);
   }
   return true;
 }
 
 void* VtsResourceManager::LoadSharedLibFromTypeName(const string& data_type) {
   // Base path.
-  // TODO: Consider determining the path and bitness by passing a field
-  // in the protobuf message.
-  string shared_lib_path = "/data/local/tmp/64/";
+  string shared_lib_path = driver_lib_dir_;
   // Start searching after the first ::
   size_t curr_index = 0;
   size_t next_index;
   bool success = false;
-  regex version_regex("V[0-9]+_[0-9]+");
   const string split_str = "::";
 
   while ((next_index = data_type.find(split_str, curr_index)) != string::npos) {
@@ -692,7 +928,7 @@ void* VtsResourceManager::LoadSharedLibFromTypeName(const string& data_type) {
     }
     string curr_string = data_type.substr(curr_index, next_index - curr_index);
     // Check if it is a version, e.g. V4_0.
-    if (regex_match(curr_string, version_regex)) {
+    if (IsVersionString(curr_string)) {
       size_t length = shared_lib_path.length();
       // Change _ into ., e.g. V4_0 to V4.0.
       size_t separator = curr_string.find("_");
@@ -713,6 +949,10 @@ void* VtsResourceManager::LoadSharedLibFromTypeName(const string& data_type) {
   if (!success) return nullptr;
 
   shared_lib_path += "-vts.driver.so";
+  auto res = shared_libs_.find(shared_lib_path);
+  if (res != shared_libs_.end()) {
+    return res->second;
+  }
   // Load the shared library that contains translation functions.
   void* shared_lib_obj = dlopen(shared_lib_path.c_str(), RTLD_LAZY);
   if (!shared_lib_obj) {
@@ -722,38 +962,52 @@ void* VtsResourceManager::LoadSharedLibFromTypeName(const string& data_type) {
   }
   LOG(INFO) << "Resource manager: successfully loaded shared library "
             << shared_lib_path;
+  shared_libs_[shared_lib_path] = shared_lib_obj;
   return shared_lib_obj;
 }
 
-void* VtsResourceManager::GetTranslationFuncPtr(void* shared_lib_obj,
-                                                const string& data_type,
-                                                bool is_proto_to_cpp) {
-  string translation_func_name = data_type;
-  // Replace all :: with __.
-  // TODO: there might be a special case where part of the type name involves
-  // a single :. Consider fixing this in the future.
-  replace(translation_func_name.begin(), translation_func_name.end(), ':', '_');
-
-  void* func_ptr = nullptr;
-  if (is_proto_to_cpp) {
-    func_ptr =
-        dlsym(shared_lib_obj, ("MessageTo" + translation_func_name).c_str());
-    if (!func_ptr) {
-      LOG(ERROR) << "Resource manager: failed to load function name "
-                 << "MessageTo" << translation_func_name << " or "
-                 << "EnumValue" << translation_func_name
-                 << " to parse protobuf message into C++ type.";
-    }
-  } else {
-    func_ptr =
-        dlsym(shared_lib_obj, ("SetResult" + translation_func_name).c_str());
-    if (!func_ptr) {
-      LOG(ERROR) << "Resource manager: failed to load the function name "
-                 << "SetResult" << translation_func_name
-                 << " to parse C++ type into protobuf message.";
+void VtsResourceManager::LoadTypeConversions(void* shared_lib_obj,
+                                             const string& data_type) {
+  // Split the type name, e.g. ::android::hardware::audio::V4_0::IStreamIn::
+  // ReadParameters, into the package scope ending with the version and the
+  // rest of the name.
+  const string split_str = "::";
+  size_t curr_index = 0;
+  size_t next_index;
+  string scope;
+  while ((next_index = data_type.find(split_str, curr_index)) != string::npos) {
+    string curr_string = data_type.substr(curr_index, next_index - curr_index);
+    if (!curr_string.empty()) {
+      scope += split_str + curr_string;
+      if (IsVersionString(curr_string)) break;
     }
+    curr_index = next_index + split_str.length();
+  }
+  if (next_index == string::npos) return;
+  // The type is declared in an interface if the name after the version is
+  // followed by another name, and otherwise in types.hal.
+  vector<string> components;
+  string rest = data_type.substr(next_index + split_str.length());
+  size_t nested_index = rest.find(split_str);
+  if (nested_index != string::npos) {
+    components.push_back(scope + split_str + rest.substr(0, nested_index));
+  }
+  components.push_back(scope + split_str + "types");
+
+  for (const auto& component : components) {
+    string symbol = GetTypeConversionsSymbol(component);
+    VtsTypeConversionsFn table_fn = reinterpret_cast<VtsTypeConversionsFn>(
+        dlsym(shared_lib_obj, symbol.c_str()));
+    if (!table_fn) continue;
+    size_t size = 0;
+    const VtsTypeConversionEntry* table = (*table_fn)(&size);
+    for (size_t i = 0; i < size; i++) {
+      type_conversions_.emplace(table[i].type_name, table[i]);
+    }
+    if (type_conversions_.count(data_type)) return;
   }
-  return func_ptr;
+  LOG(ERROR) << "Resource manager: failed to load the conversion table of "
+             << "type " << data_type << ".";
 }
 
 }  // namespace vts
@@ -0,0 +1,765 @@
+# Generated by the protocol buffer compiler.  DO NOT EDIT!
+# source: VtsDriverControlMessage.proto
+
+import sys
+_b=sys.version_info[0]<3 and (lambda x:x) or (lambda x:x.encode('latin1'))
+from google.protobuf.internal import enum_type_wrapper
+from google.protobuf import descriptor as _descriptor
+from google.protobuf import message as _message
+from google.protobuf import reflection as _reflection
+from google.protobuf import symbol_database as _symbol_database
+from google.protobuf import descriptor_pb2
+# @@protoc_insertion_point(imports)
+
+_sym_db = _symbol_database.Default()
+
+
+import ComponentSpecificationMessage_pb2 as ComponentSpecificationMessage__pb2
+import VtsResourceControllerMessage_pb2 as VtsResourceControllerMessage__pb2
+
+
+DESCRIPTOR = _descriptor.FileDescriptor(
+  name='VtsDriverControlMessage.proto',
+  package='android.vts',
+  syntax='proto2',
+  serialized_pb=_b('\n\x1dVtsDriverControlMessage.proto\x12\x0b\x61ndroid.vts\x1a#ComponentSpecificationMessage.proto\x1a\"VtsResourceControllerMessage.proto\"\x89\n\n\x1eVtsDriverControlCommandMessage\x12\x37\n\x0c\x63ommand_type\x18\x01 \x01(\x0e\x32!.android.vts.VtsDriverCommandType\x12\x12\n\nrequest_id\x18\x02 \x01(\x03\x12\x14\n\x0bstatus_type\x18\xcd\x08 \x01(\x05\x12\x12\n\tfile_path\x18\xb1\t \x01(\x0c\x12\x15\n\x0ctarget_class\x18\xb2\t \x01(\x05\x12\x14\n\x0btarget_type\x18\xb3\t \x01(\x05\x12\x1b\n\x0etarget_version\x18\xb4\t \x01(\x02\x42\x02\x18\x01\x12\x14\n\x0bmodule_name\x18\xb5\t \x01(\x0c\x12\x17\n\x0etarget_package\x18\xb6\t \x01(\x0c\x12\x1e\n\x15target_component_name\x18\xb7\t \x01(\x0c\x12!\n\x14target_version_major\x18\xb8\t \x01(\x05:\x02-1\x12!\n\x14target_version_minor\x18\xb9\t \x01(\x05:\x02-1\x12\x1f\n\x16hw_binder_service_name\x18\xc5\t \x01(\x0c\x12\x0c\n\x03\x61rg\x18\xf9\n \x01(\x0c\x12\x1e\n\x15\x62inary_return_message\x18\xfa\n \x01(\x08\x12\x38\n\rfunction_call\x18\x83\x0b \x03(\x0b\x32 .android.vts.FunctionCallMessage\x12\x16\n\rstop_on_error\x18\x84\x0b \x01(\x08\x12\x38\n\rcall_template\x18\x8d\x0b \x01(\x0b\x32 .android.vts.FunctionCallMessage\x12\x14\n\x0b\x63\x61ll_handle\x18\x8e\x0b \x01(\x05\x12?\n\x0c\x61rg_override\x18\x8f\x0b \x03(\x0b\x32(.android.vts.CallArgumentOverrideMessage\x12\x38\n\rverified_call\x18\x97\x0b \x01(\x0b\x32 .android.vts.FunctionCallMessage\x12\x43\n\x0f\x65xpected_result\x18\x98\x0b \x01(\x0b\x32).android.vts.FunctionSpecificationMessage\x12\x38\n\rrepeated_call\x18\xa1\x0b \x01(\x0b\x32 .android.vts.FunctionCallMessage\x12\x15\n\x0crepeat_count\x18\xa2\x0b \x01(\x05\x12\x1b\n\x12\x63overage_driver_id\x18\xab\x0b \x01(\x05\x12\"\n\x19include_raw_coverage_data\x18\xac\x0b \x01(\x08\x12\x1e\n\x15report_coverage_delta\x18\xad\x0b \x01(\x08\x12\x1d\n\x14reset_coverage_delta\x18\xae\x0b \x01(\x08\x12\x1b\n\x12in_memory_coverage\x18\xaf\x0b \x01(\x08\x12\x1a\n\x11\x64river_caller_uid\x18\xdd\x0b \x01(\x0c\x12\x16\n\rshell_command\x18\xd1\x0f \x03(\x0c\x12\x34\n\x0b\x66mq_request\x18\xb9\x17 \x01(\x0b\x32\x1e.android.vts.FmqRequestMessage\x12\x43\n\x13hidl_memory_request\x18\xba\x17 \x01(\x0b\x32%.android.vts.HidlMemoryRequestMessage\x12\x43\n\x13hidl_handle_request\x18\xbb\x17 \x01(\x0b\x32%.android.vts.HidlHandleRequestMessage\"\x9f\x01\n\x1b\x43\x61llArgumentOverrideMessage\x12\r\n\x05index\x18\x01 \x01(\x05\x12\x39\n\x0cscalar_value\x18\x02 \x01(\x0b\x32#.android.vts.ScalarDataValueMessage\x12\x36\n\x03\x61rg\x18\x03 \x01(\x0b\x32).android.vts.VariableSpecificationMessage\"\xd4\x01\n\x19RepeatedCallResultMessage\x12\x12\n\ncall_count\x18\x01 \x01(\x05\x12\x12\n\nelapsed_ns\x18\x02 \x01(\x03\x12;\n\x06result\x18\x03 \x03(\x0b\x32+.android.vts.RepeatedCallResultCountMessage\x12\x1a\n\x12other_result_count\x18\x04 \x01(\x03\x12\x36\n\x03\x61pi\x18\x05 \x01(\x0b\x32).android.vts.FunctionSpecificationMessage\">\n\x1eRepeatedCallResultCountMessage\x12\r\n\x05value\x18\x01 \x01(\x03\x12\r\n\x05\x63ount\x18\x02 \x01(\x03\"\xe7\x03\n\x1fVtsDriverControlResponseMessage\x12\x39\n\rresponse_code\x18\x01 \x01(\x0e\x32\".android.vts.VtsDriverResponseCode\x12\x12\n\nrequest_id\x18\x02 \x01(\x03\x12\x14\n\x0creturn_value\x18\x0b \x01(\x05\x12\x16\n\x0ereturn_message\x18\x0c \x01(\x0c\x12\x1d\n\x15\x62inary_return_message\x18\r \x01(\x08\x12\x0f\n\x06stdout\x18\xe9\x07 \x03(\x0c\x12\x0f\n\x06stderr\x18\xea\x07 \x03(\x0c\x12\x12\n\texit_code\x18\xeb\x07 \x03(\x05\x12\r\n\x04spec\x18\xd1\x0f \x03(\x0c\x12\x1d\n\x14\x66unction_call_result\x18\xb5\x10 \x03(\x0c\x12\x36\n\x0c\x66mq_response\x18\xb9\x17 \x01(\x0b\x32\x1f.android.vts.FmqResponseMessage\x12\x45\n\x14hidl_memory_response\x18\xba\x17 \x01(\x0b\x32&.android.vts.HidlMemoryResponseMessage\x12\x45\n\x14hidl_handle_response\x18\xbb\x17 \x01(\x0b\x32&.android.vts.HidlHandleResponseMessage*\xeb\x03\n\x14VtsDriverCommandType\x12#\n\x1fUNKNOWN_VTS_DRIVER_COMMAND_TYPE\x10\x00\x12\x08\n\x04\x45XIT\x10\x01\x12\x0e\n\nGET_STATUS\x10\x02\x12\r\n\tGET_STATS\x10\x03\x12\x0f\n\x0bRESET_STATS\x10\x04\x12\x0c\n\x08LOAD_HAL\x10\x65\x12\x12\n\x0eLIST_FUNCTIONS\x10\x66\x12\x11\n\rCALL_FUNCTION\x10g\x12\x11\n\rGET_ATTRIBUTE\x10h\x12)\n%VTS_DRIVER_COMMAND_READ_SPECIFICATION\x10i\x12\x12\n\x0e\x43\x41LL_FUNCTIONS\x10j\x12\x10\n\x0cPREPARE_CALL\x10k\x12\x10\n\x0c\x45XECUTE_CALL\x10l\x12\x1c\n\x18\x43\x41LL_FUNCTION_AND_VERIFY\x10m\x12\x1a\n\x16\x43\x41LL_FUNCTION_REPEATED\x10n\x12\x18\n\x14SET_COVERAGE_OPTIONS\x10o\x12\x14\n\x0f\x45XECUTE_COMMAND\x10\xc9\x01\x12\x13\n\x0eINVOKE_SYSCALL\x10\xca\x01\x12\x12\n\rFMQ_OPERATION\x10\xad\x02\x12\x1a\n\x15HIDL_MEMORY_OPERATION\x10\xae\x02\x12\x1a\n\x15HIDL_HANDLE_OPERATION\x10\xaf\x02*|\n\x15VtsDriverResponseCode\x12$\n UNKNOWN_VTS_DRIVER_RESPONSE_CODE\x10\x00\x12\x1f\n\x1bVTS_DRIVER_RESPONSE_SUCCESS\x10\x01\x12\x1c\n\x18VTS_DRIVER_RESPONSE_FAIL\x10\x02')
+  ,
+  dependencies=[ComponentSpecificationMessage__pb2.DESCRIPTOR,VtsResourceControllerMessage__pb2.DESCRIPTOR,])
+_sym_db.RegisterFileDescriptor(DESCRIPTOR)
+
+_VTSDRIVERCOMMANDTYPE = _descriptor.EnumDescriptor(
+  name='VtsDriverCommandType',
+  full_name='android.vts.VtsDriverCommandType',
+  filename=None,
+  file=DESCRIPTOR,
+  values=[
+    _descriptor.EnumValueDescriptor(
+      name='UNKNOWN_VTS_DRIVER_COMMAND_TYPE', index=0, number=0,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='EXIT', index=1, number=1,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='GET_STATUS', index=2, number=2,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='GET_STATS', index=3, number=3,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='RESET_STATS', index=4, number=4,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='LOAD_HAL', index=5, number=101,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='LIST_FUNCTIONS', index=6, number=102,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='CALL_FUNCTION', index=7, number=103,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='GET_ATTRIBUTE', index=8, number=104,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='VTS_DRIVER_COMMAND_READ_SPECIFICATION', index=9, number=105,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='CALL_FUNCTIONS', index=10, number=106,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='PREPARE_CALL', index=11, number=107,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='EXECUTE_CALL', index=12, number=108,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='CALL_FUNCTION_AND_VERIFY', index=13, number=109,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='CALL_FUNCTION_REPEATED', index=14, number=110,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='SET_COVERAGE_OPTIONS', index=15, number=111,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='EXECUTE_COMMAND', index=16, number=201,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='INVOKE_SYSCALL', index=17, number=202,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='FMQ_OPERATION', index=18, number=301,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='HIDL_MEMORY_OPERATION', index=19, number=302,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='HIDL_HANDLE_OPERATION', index=20, number=303,
+      options=None,
+      type=None),
+  ],
+  containing_type=None,
+  options=None,
+  serialized_start=2343,
+  serialized_end=2834,
+)
+_sym_db.RegisterEnumDescriptor(_VTSDRIVERCOMMANDTYPE)
+
+VtsDriverCommandType = enum_type_wrapper.EnumTypeWrapper(_VTSDRIVERCOMMANDTYPE)
+_VTSDRIVERRESPONSECODE = _descriptor.EnumDescriptor(
+  name='VtsDriverResponseCode',
+  full_name='android.vts.VtsDriverResponseCode',
+  filename=None,
+  file=DESCRIPTOR,
+  values=[
+    _descriptor.EnumValueDescriptor(
+      name='UNKNOWN_VTS_DRIVER_RESPONSE_CODE', index=0, number=0,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='VTS_DRIVER_RESPONSE_SUCCESS', index=1, number=1,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='VTS_DRIVER_RESPONSE_FAIL', index=2, number=2,
+      options=None,
+      type=None),
+  ],
+  containing_type=None,
+  options=None,
+  serialized_start=2836,
+  serialized_end=2960,
+)
+_sym_db.RegisterEnumDescriptor(_VTSDRIVERRESPONSECODE)
+
+VtsDriverResponseCode = enum_type_wrapper.EnumTypeWrapper(_VTSDRIVERRESPONSECODE)
+UNKNOWN_VTS_DRIVER_COMMAND_TYPE = 0
+EXIT = 1
+GET_STATUS = 2
+GET_STATS = 3
+RESET_STATS = 4
+LOAD_HAL = 101
+LIST_FUNCTIONS = 102
+CALL_FUNCTION = 103
+GET_ATTRIBUTE = 104
+VTS_DRIVER_COMMAND_READ_SPECIFICATION = 105
+CALL_FUNCTIONS = 106
+PREPARE_CALL = 107
+EXECUTE_CALL = 108
+CALL_FUNCTION_AND_VERIFY = 109
+CALL_FUNCTION_REPEATED = 110
+SET_COVERAGE_OPTIONS = 111
+EXECUTE_COMMAND = 201
+INVOKE_SYSCALL = 202
+FMQ_OPERATION = 301
+HIDL_MEMORY_OPERATION = 302
+HIDL_HANDLE_OPERATION = 303
+UNKNOWN_VTS_DRIVER_RESPONSE_CODE = 0
+VTS_DRIVER_RESPONSE_SUCCESS = 1
+VTS_DRIVER_RESPONSE_FAIL = 2
+
+
+
+_VTSDRIVERCONTROLCOMMANDMESSAGE = _descriptor.Descriptor(
+  name='VtsDriverControlCommandMessage',
+  full_name='android.vts.VtsDriverControlCommandMessage',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='command_type', full_name='android.vts.VtsDriverControlCommandMessage.command_type', index=0,
+      number=1, type=14, cpp_type=8, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='request_id', full_name='android.vts.VtsDriverControlCommandMessage.request_id', index=1,
+      number=2, type=3, cpp_type=2, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='status_type', full_name='android.vts.VtsDriverControlCommandMessage.status_type', index=2,
+      number=1101, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='file_path', full_name='android.vts.VtsDriverControlCommandMessage.file_path', index=3,
+      number=1201, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_class', full_name='android.vts.VtsDriverControlCommandMessage.target_class', index=4,
+      number=1202, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_type', full_name='android.vts.VtsDriverControlCommandMessage.target_type', index=5,
+      number=1203, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_version', full_name='android.vts.VtsDriverControlCommandMessage.target_version', index=6,
+      number=1204, type=2, cpp_type=6, label=1,
+      has_default_value=False, default_value=float(0),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=_descriptor._ParseOptions(descriptor_pb2.FieldOptions(), _b('\030\001'))),
+    _descriptor.FieldDescriptor(
+      name='module_name', full_name='android.vts.VtsDriverControlCommandMessage.module_name', index=7,
+      number=1205, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_package', full_name='android.vts.VtsDriverControlCommandMessage.target_package', index=8,
+      number=1206, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_component_name', full_name='android.vts.VtsDriverControlCommandMessage.target_component_name', index=9,
+      number=1207, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_version_major', full_name='android.vts.VtsDriverControlCommandMessage.target_version_major', index=10,
+      number=1208, type=5, cpp_type=1, label=1,
+      has_default_value=True, default_value=-1,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='target_version_minor', full_name='android.vts.VtsDriverControlCommandMessage.target_version_minor', index=11,
+      number=1209, type=5, cpp_type=1, label=1,
+      has_default_value=True, default_value=-1,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='hw_binder_service_name', full_name='android.vts.VtsDriverControlCommandMessage.hw_binder_service_name', index=12,
+      number=1221, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='arg', full_name='android.vts.VtsDriverControlCommandMessage.arg', index=13,
+      number=1401, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='binary_return_message', full_name='android.vts.VtsDriverControlCommandMessage.binary_return_message', index=14,
+      number=1402, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='function_call', full_name='android.vts.VtsDriverControlCommandMessage.function_call', index=15,
+      number=1411, type=11, cpp_type=10, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='stop_on_error', full_name='android.vts.VtsDriverControlCommandMessage.stop_on_error', index=16,
+      number=1412, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='call_template', full_name='android.vts.VtsDriverControlCommandMessage.call_template', index=17,
+      number=1421, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='call_handle', full_name='android.vts.VtsDriverControlCommandMessage.call_handle', index=18,
+      number=1422, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='arg_override', full_name='android.vts.VtsDriverControlCommandMessage.arg_override', index=19,
+      number=1423, type=11, cpp_type=10, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='verified_call', full_name='android.vts.VtsDriverControlCommandMessage.verified_call', index=20,
+      number=1431, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='expected_result', full_name='android.vts.VtsDriverControlCommandMessage.expected_result', index=21,
+      number=1432, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='repeated_call', full_name='android.vts.VtsDriverControlCommandMessage.repeated_call', index=22,
+      number=1441, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='repeat_count', full_name='android.vts.VtsDriverControlCommandMessage.repeat_count', index=23,
+      number=1442, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='coverage_driver_id', full_name='android.vts.VtsDriverControlCommandMessage.coverage_driver_id', index=24,
+      number=1451, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='include_raw_coverage_data', full_name='android.vts.VtsDriverControlCommandMessage.include_raw_coverage_data', index=25,
+      number=1452, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='report_coverage_delta', full_name='android.vts.VtsDriverControlCommandMessage.report_coverage_delta', index=26,
+      number=1453, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='reset_coverage_delta', full_name='android.vts.VtsDriverControlCommandMessage.reset_coverage_delta', index=27,
+      number=1454, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='in_memory_coverage', full_name='android.vts.VtsDriverControlCommandMessage.in_memory_coverage', index=28,
+      number=1455, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='driver_caller_uid', full_name='android.vts.VtsDriverControlCommandMessage.driver_caller_uid', index=29,
+      number=1501, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='shell_command', full_name='android.vts.VtsDriverControlCommandMessage.shell_command', index=30,
+      number=2001, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='fmq_request', full_name='android.vts.VtsDriverControlCommandMessage.fmq_request', index=31,
+      number=3001, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='hidl_memory_request', full_name='android.vts.VtsDriverControlCommandMessage.hidl_memory_request', index=32,
+      number=3002, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='hidl_handle_request', full_name='android.vts.VtsDriverControlCommandMessage.hidl_handle_request', index=33,
+      number=3003, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto2',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=120,
+  serialized_end=1409,
+)
+
+
+_CALLARGUMENTOVERRIDEMESSAGE = _descriptor.Descriptor(
+  name='CallArgumentOverrideMessage',
+  full_name='android.vts.CallArgumentOverrideMessage',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='index', full_name='android.vts.CallArgumentOverrideMessage.index', index=0,
+      number=1, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='scalar_value', full_name='android.vts.CallArgumentOverrideMessage.scalar_value', index=1,
+      number=2, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='arg', full_name='android.vts.CallArgumentOverrideMessage.arg', index=2,
+      number=3, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto2',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=1412,
+  serialized_end=1571,
+)
+
+
+_REPEATEDCALLRESULTMESSAGE = _descriptor.Descriptor(
+  name='RepeatedCallResultMessage',
+  full_name='android.vts.RepeatedCallResultMessage',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='call_count', full_name='android.vts.RepeatedCallResultMessage.call_count', index=0,
+      number=1, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='elapsed_ns', full_name='android.vts.RepeatedCallResultMessage.elapsed_ns', index=1,
+      number=2, type=3, cpp_type=2, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='result', full_name='android.vts.RepeatedCallResultMessage.result', index=2,
+      number=3, type=11, cpp_type=10, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='other_result_count', full_name='android.vts.RepeatedCallResultMessage.other_result_count', index=3,
+      number=4, type=3, cpp_type=2, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='api', full_name='android.vts.RepeatedCallResultMessage.api', index=4,
+      number=5, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto2',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=1574,
+  serialized_end=1786,
+)
+
+
+_REPEATEDCALLRESULTCOUNTMESSAGE = _descriptor.Descriptor(
+  name='RepeatedCallResultCountMessage',
+  full_name='android.vts.RepeatedCallResultCountMessage',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='value', full_name='android.vts.RepeatedCallResultCountMessage.value', index=0,
+      number=1, type=3, cpp_type=2, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='count', full_name='android.vts.RepeatedCallResultCountMessage.count', index=1,
+      number=2, type=3, cpp_type=2, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto2',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=1788,
+  serialized_end=1850,
+)
+
+
+_VTSDRIVERCONTROLRESPONSEMESSAGE = _descriptor.Descriptor(
+  name='VtsDriverControlResponseMessage',
+  full_name='android.vts.VtsDriverControlResponseMessage',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='response_code', full_name='android.vts.VtsDriverControlResponseMessage.response_code', index=0,
+      number=1, type=14, cpp_type=8, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='request_id', full_name='android.vts.VtsDriverControlResponseMessage.request_id', index=1,
+      number=2, type=3, cpp_type=2, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='return_value', full_name='android.vts.VtsDriverControlResponseMessage.return_value', index=2,
+      number=11, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='return_message', full_name='android.vts.VtsDriverControlResponseMessage.return_message', index=3,
+      number=12, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='binary_return_message', full_name='android.vts.VtsDriverControlResponseMessage.binary_return_message', index=4,
+      number=13, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='stdout', full_name='android.vts.VtsDriverControlResponseMessage.stdout', index=5,
+      number=1001, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='stderr', full_name='android.vts.VtsDriverControlResponseMessage.stderr', index=6,
+      number=1002, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='exit_code', full_name='android.vts.VtsDriverControlResponseMessage.exit_code', index=7,
+      number=1003, type=5, cpp_type=1, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='spec', full_name='android.vts.VtsDriverControlResponseMessage.spec', index=8,
+      number=2001, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='function_call_result', full_name='android.vts.VtsDriverControlResponseMessage.function_call_result', index=9,
+      number=2101, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='fmq_response', full_name='android.vts.VtsDriverControlResponseMessage.fmq_response', index=10,
+      number=3001, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='hidl_memory_response', full_name='android.vts.VtsDriverControlResponseMessage.hidl_memory_response', index=11,
+      number=3002, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='hidl_handle_response', full_name='android.vts.VtsDriverControlResponseMessage.hidl_handle_response', index=12,
+      number=3003, type=11, cpp_type=10, label=1,
+      has_default_value=False, default_value=None,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto2',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=1853,
+  serialized_end=2340,
+)
+
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['command_type'].enum_type = _VTSDRIVERCOMMANDTYPE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['function_call'].message_type = ComponentSpecificationMessage__pb2._FUNCTIONCALLMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['call_template'].message_type = ComponentSpecificationMessage__pb2._FUNCTIONCALLMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['arg_override'].message_type = _CALLARGUMENTOVERRIDEMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['verified_call'].message_type = ComponentSpecificationMessage__pb2._FUNCTIONCALLMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['expected_result'].message_type = ComponentSpecificationMessage__pb2._FUNCTIONSPECIFICATIONMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['repeated_call'].message_type = ComponentSpecificationMessage__pb2._FUNCTIONCALLMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['fmq_request'].message_type = VtsResourceControllerMessage__pb2._FMQREQUESTMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['hidl_memory_request'].message_type = VtsResourceControllerMessage__pb2._HIDLMEMORYREQUESTMESSAGE
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['hidl_handle_request'].message_type = VtsResourceControllerMessage__pb2._HIDLHANDLEREQUESTMESSAGE
+_CALLARGUMENTOVERRIDEMESSAGE.fields_by_name['scalar_value'].message_type = ComponentSpecificationMessage__pb2._SCALARDATAVALUEMESSAGE
+_CALLARGUMENTOVERRIDEMESSAGE.fields_by_name['arg'].message_type = ComponentSpecificationMessage__pb2._VARIABLESPECIFICATIONMESSAGE
+_REPEATEDCALLRESULTMESSAGE.fields_by_name['result'].message_type = _REPEATEDCALLRESULTCOUNTMESSAGE
+_REPEATEDCALLRESULTMESSAGE.fields_by_name['api'].message_type = ComponentSpecificationMessage__pb2._FUNCTIONSPECIFICATIONMESSAGE
+_VTSDRIVERCONTROLRESPONSEMESSAGE.fields_by_name['response_code'].enum_type = _VTSDRIVERRESPONSECODE
+_VTSDRIVERCONTROLRESPONSEMESSAGE.fields_by_name['fmq_response'].message_type = VtsResourceControllerMessage__pb2._FMQRESPONSEMESSAGE
+_VTSDRIVERCONTROLRESPONSEMESSAGE.fields_by_name['hidl_memory_response'].message_type = VtsResourceControllerMessage__pb2._HIDLMEMORYRESPONSEMESSAGE
+_VTSDRIVERCONTROLRESPONSEMESSAGE.fields_by_name['hidl_handle_response'].message_type = VtsResourceControllerMessage__pb2._HIDLHANDLERESPONSEMESSAGE
+DESCRIPTOR.message_types_by_name['VtsDriverControlCommandMessage'] = _VTSDRIVERCONTROLCOMMANDMESSAGE
+DESCRIPTOR.message_types_by_name['CallArgumentOverrideMessage'] = _CALLARGUMENTOVERRIDEMESSAGE
+DESCRIPTOR.message_types_by_name['RepeatedCallResultMessage'] = _REPEATEDCALLRESULTMESSAGE
+DESCRIPTOR.message_types_by_name['RepeatedCallResultCountMessage'] = _REPEATEDCALLRESULTCOUNTMESSAGE
+DESCRIPTOR.message_types_by_name['VtsDriverControlResponseMessage'] = _VTSDRIVERCONTROLRESPONSEMESSAGE
+DESCRIPTOR.enum_types_by_name['VtsDriverCommandType'] = _VTSDRIVERCOMMANDTYPE
+DESCRIPTOR.enum_types_by_name['VtsDriverResponseCode'] = _VTSDRIVERRESPONSECODE
+
+VtsDriverControlCommandMessage = _reflection.GeneratedProtocolMessageType('VtsDriverControlCommandMessage', (_message.Message,), dict(
+  DESCRIPTOR = _VTSDRIVERCONTROLCOMMANDMESSAGE,
+  __module__ = 'VtsDriverControlMessage_pb2'
+  # @@protoc_insertion_point(class_scope:android.vts.VtsDriverControlCommandMessage)
+  ))
+_sym_db.RegisterMessage(VtsDriverControlCommandMessage)
+
+CallArgumentOverrideMessage = _reflection.GeneratedProtocolMessageType('CallArgumentOverrideMessage', (_message.Message,), dict(
+  DESCRIPTOR = _CALLARGUMENTOVERRIDEMESSAGE,
+  __module__ = 'VtsDriverControlMessage_pb2'
+  # @@protoc_insertion_point(class_scope:android.vts.CallArgumentOverrideMessage)
+  ))
+_sym_db.RegisterMessage(CallArgumentOverrideMessage)
+
+RepeatedCallResultMessage = _reflection.GeneratedProtocolMessageType('RepeatedCallResultMessage', (_message.Message,), dict(
+  DESCRIPTOR = _REPEATEDCALLRESULTMESSAGE,
+  __module__ = 'VtsDriverControlMessage_pb2'
+  # @@protoc_insertion_point(class_scope:android.vts.RepeatedCallResultMessage)
+  ))
+_sym_db.RegisterMessage(RepeatedCallResultMessage)
+
+RepeatedCallResultCountMessage = _reflection.GeneratedProtocolMessageType('RepeatedCallResultCountMessage', (_message.Message,), dict(
+  DESCRIPTOR = _REPEATEDCALLRESULTCOUNTMESSAGE,
+  __module__ = 'VtsDriverControlMessage_pb2'
+  # @@protoc_insertion_point(class_scope:android.vts.RepeatedCallResultCountMessage)
+  ))
+_sym_db.RegisterMessage(RepeatedCallResultCountMessage)
+
+VtsDriverControlResponseMessage = _reflection.GeneratedProtocolMessageType('VtsDriverControlResponseMessage', (_message.Message,), dict(
+  DESCRIPTOR = _VTSDRIVERCONTROLRESPONSEMESSAGE,
+  __module__ = 'VtsDriverControlMessage_pb2'
+  # @@protoc_insertion_point(class_scope:android.vts.VtsDriverControlResponseMessage)
+  ))
+_sym_db.RegisterMessage(VtsDriverControlResponseMessage)
+
+
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['target_version'].has_options = True
+_VTSDRIVERCONTROLCOMMANDMESSAGE.fields_by_name['target_version']._options = _descriptor._ParseOptions(descriptor_pb2.FieldOptions(), _b('\030\001'))
+# @@protoc_insertion_point(module_scope)
@@ -21,7 +21,7 @@ DESCRIPTOR = _descriptor.FileDescriptor(
   name='VtsResourceControllerMessage.proto',
   package='android.vts',
   syntax='proto2',
-  serialized_pb=_b('\n\"VtsResourceControllerMessage.proto\x12\x0b\x61ndroid.vts\x1a#ComponentSpecificationMessage.proto\"\xb7\x02\n\x11\x46mqRequestMessage\x12%\n\toperation\x18\x01 \x01(\x0e\x32\x12.android.vts.FmqOp\x12\x11\n\tdata_type\x18\x02 \x01(\x0c\x12\x0c\n\x04sync\x18\x03 \x01(\x08\x12\x14\n\x08queue_id\x18\x04 \x01(\x05:\x02-1\x12\x12\n\nqueue_size\x18\x05 \x01(\x04\x12\x10\n\x08\x62locking\x18\x06 \x01(\x08\x12\x16\n\x0ereset_pointers\x18\x07 \x01(\x08\x12=\n\nwrite_data\x18\x08 \x03(\x0b\x32).android.vts.VariableSpecificationMessage\x12\x16\n\x0eread_data_size\x18\t \x01(\x04\x12\x16\n\x0etime_out_nanos\x18\n \x01(\x03\x12\x17\n\x0fqueue_desc_addr\x18\x0b \x01(\x04\"\x8f\x01\n\x12\x46mqResponseMessage\x12<\n\tread_data\x18\x01 \x03(\x0b\x32).android.vts.VariableSpecificationMessage\x12\x18\n\x10sizet_return_val\x18\x02 \x01(\x04\x12\x10\n\x08queue_id\x18\x03 \x01(\x05\x12\x0f\n\x07success\x18\x04 \x01(\x08\"\xa1\x01\n\x18HidlMemoryRequestMessage\x12,\n\toperation\x18\x01 \x01(\x0e\x32\x19.android.vts.HidlMemoryOp\x12\x12\n\x06mem_id\x18\x02 \x01(\x05:\x02-1\x12\x10\n\x08mem_size\x18\x03 \x01(\x04\x12\r\n\x05start\x18\x04 \x01(\x04\x12\x0e\n\x06length\x18\x05 \x01(\x04\x12\x12\n\nwrite_data\x18\x06 \x01(\x0c\"e\n\x19HidlMemoryResponseMessage\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x12\n\nnew_mem_id\x18\x02 \x01(\x05\x12\x10\n\x08mem_size\x18\x03 \x01(\x04\x12\x11\n\tread_data\x18\x04 \x01(\x0c\"\xc5\x01\n\x18HidlHandleRequestMessage\x12,\n\toperation\x18\x01 \x01(\x0e\x32\x19.android.vts.HidlHandleOp\x12\x15\n\thandle_id\x18\x02 \x01(\x05:\x02-1\x12\x38\n\x0bhandle_info\x18\x03 \x01(\x0b\x32#.android.vts.HandleDataValueMessage\x12\x16\n\x0eread_data_size\x18\x04 \x01(\x04\x12\x12\n\nwrite_data\x18\x05 \x01(\x0c\"o\n\x19HidlHandleResponseMessage\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x15\n\rnew_handle_id\x18\x02 \x01(\x05\x12\x11\n\tread_data\x18\x03 \x01(\x0c\x12\x17\n\x0fwrite_data_size\x18\x04 \x01(\x03*\xbc\x02\n\x05\x46mqOp\x12\x0f\n\x0b\x46MQ_UNKNOWN\x10\x00\x12\x0e\n\nFMQ_CREATE\x10\x01\x12\x0c\n\x08\x46MQ_READ\x10\x02\x12\x15\n\x11\x46MQ_READ_BLOCKING\x10\x03\x12\x1a\n\x16\x46MQ_READ_BLOCKING_LONG\x10\x04\x12\r\n\tFMQ_WRITE\x10\x05\x12\x16\n\x12\x46MQ_WRITE_BLOCKING\x10\x06\x12\x1b\n\x17\x46MQ_WRITE_BLOCKING_LONG\x10\x07\x12\x17\n\x13\x46MQ_AVAILABLE_WRITE\x10\x08\x12\x16\n\x12\x46MQ_AVAILABLE_READ\x10\t\x12\x18\n\x14\x46MQ_GET_QUANTUM_SIZE\x10\n\x12\x19\n\x15\x46MQ_GET_QUANTUM_COUNT\x10\x0b\x12\x10\n\x0c\x46MQ_IS_VALID\x10\x0c\x12\x15\n\x11\x46MQ_GET_DESC_ADDR\x10\r*\x99\x02\n\x0cHidlMemoryOp\x12\x15\n\x11MEM_PROTO_UNKNOWN\x10\x00\x12\x16\n\x12MEM_PROTO_ALLOCATE\x10\x01\x12\x18\n\x14MEM_PROTO_START_READ\x10\x02\x12\x1e\n\x1aMEM_PROTO_START_READ_RANGE\x10\x03\x12\x18\n\x14MEM_PROTO_READ_BYTES\x10\x04\x12\x1a\n\x16MEM_PROTO_START_UPDATE\x10\x05\x12 \n\x1cMEM_PROTO_START_UPDATE_RANGE\x10\x06\x12\x1a\n\x16MEM_PROTO_UPDATE_BYTES\x10\x07\x12\x14\n\x10MEM_PROTO_COMMIT\x10\x08\x12\x16\n\x12MEM_PROTO_GET_SIZE\x10\t*\x98\x01\n\x0cHidlHandleOp\x12\x18\n\x14HANDLE_PROTO_UNKNOWN\x10\x00\x12\x1c\n\x18HANDLE_PROTO_CREATE_FILE\x10\x01\x12\x1a\n\x16HANDLE_PROTO_READ_FILE\x10\x02\x12\x1b\n\x17HANDLE_PROTO_WRITE_FILE\x10\x03\x12\x17\n\x13HANDLE_PROTO_DELETE\x10\x04\x42\x35\n\x15\x63om.android.vts.protoB\x1cVtsResourceControllerMessage')
+  serialized_pb=_b('\n\"VtsResourceControllerMessage.proto\x12\x0b\x61ndroid.vts\x1a#ComponentSpecificationMessage.proto\"\xf2\x03\n\x11\x46mqRequestMessage\x12%\n\toperation\x18\x01 \x01(\x0e\x32\x12.android.vts.FmqOp\x12\x11\n\tdata_type\x18\x02 \x01(\x0c\x12\x0c\n\x04sync\x18\x03 \x01(\x08\x12\x14\n\x08queue_id\x18\x04 \x01(\x05:\x02-1\x12\x12\n\nqueue_size\x18\x05 \x01(\x04\x12\x10\n\x08\x62locking\x18\x06 \x01(\x08\x12\x16\n\x0ereset_pointers\x18\x07 \x01(\x08\x12=\n\nwrite_data\x18\x08 \x03(\x0b\x32).android.vts.VariableSpecificationMessage\x12\x16\n\x0eread_data_size\x18\t \x01(\x04\x12\x16\n\x0etime_out_nanos\x18\n \x01(\x03\x12\x17\n\x0fqueue_desc_addr\x18\x0b \x01(\x04\x12\x16\n\x0ewrite_data_raw\x18\x0c \x01(\x0c\x12\x15\n\rraw_read_data\x18\r \x01(\x08\x12\x19\n\x11transaction_count\x18\x0e \x01(\x04\x12\x19\n\x11read_notification\x18\x0f \x01(\r\x12\x1a\n\x12write_notification\x18\x10 \x01(\r\x12\x1f\n\x13\x65vent_flag_queue_id\x18\x11 \x01(\x05:\x02-1\x12\x17\n\x0f\x65vent_flag_bits\x18\x12 \x01(\r\"\xa6\x01\n\x12\x46mqResponseMessage\x12<\n\tread_data\x18\x01 \x03(\x0b\x32).android.vts.VariableSpecificationMessage\x12\x18\n\x10sizet_return_val\x18\x02 \x01(\x04\x12\x10\n\x08queue_id\x18\x03 \x01(\x05\x12\x0f\n\x07success\x18\x04 \x01(\x08\x12\x15\n\rread_data_raw\x18\x05 \x01(\x0c\"\xe7\x01\n\x18HidlMemoryRequestMessage\x12,\n\toperation\x18\x01 \x01(\x0e\x32\x19.android.vts.HidlMemoryOp\x12\x12\n\x06mem_id\x18\x02 \x01(\x05:\x02-1\x12\x10\n\x08mem_size\x18\x03 \x01(\x04\x12\r\n\x05start\x18\x04 \x01(\x04\x12\x0e\n\x06length\x18\x05 \x01(\x04\x12\x12\n\nwrite_data\x18\x06 \x01(\x0c\x12\x33\n\x06ranges\x18\x07 \x03(\x0b\x32#.android.vts.HidlMemoryRangeMessage\x12\x0f\n\x07\x62racket\x18\x08 \x01(\x08\"7\n\x16HidlMemoryRangeMessage\x12\r\n\x05start\x18\x01 \x01(\x04\x12\x0e\n\x06length\x18\x02 \x01(\x04\"e\n\x19HidlMemoryResponseMessage\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x12\n\nnew_mem_id\x18\x02 \x01(\x05\x12\x10\n\x08mem_size\x18\x03 \x01(\x04\x12\x11\n\tread_data\x18\x04 \x01(\x0c\"\xa8\x02\n\x18HidlHandleRequestMessage\x12,\n\toperation\x18\x01 \x01(\x0e\x32\x19.android.vts.HidlHandleOp\x12\x15\n\thandle_id\x18\x02 \x01(\x05:\x02-1\x12\x38\n\x0bhandle_info\x18\x03 \x01(\x0b\x32#.android.vts.HandleDataValueMessage\x12\x16\n\x0eread_data_size\x18\x04 \x01(\x04\x12\x12\n\nwrite_data\x18\x05 \x01(\x0c\x12\x12\n\x06offset\x18\x06 \x01(\x03:\x02-1\x12\x12\n\nmap_length\x18\x07 \x01(\x04\x12\x1e\n\x16read_data_vector_sizes\x18\x08 \x03(\x04\x12\x19\n\x11write_data_vector\x18\t \x03(\x0c\"\x89\x01\n\x19HidlHandleResponseMessage\x12\x0f\n\x07success\x18\x01 \x01(\x08\x12\x15\n\rnew_handle_id\x18\x02 \x01(\x05\x12\x11\n\tread_data\x18\x03 \x01(\x0c\x12\x17\n\x0fwrite_data_size\x18\x04 \x01(\x03\x12\x18\n\x10read_data_vector\x18\x05 \x03(\x0c*\xa5\x03\n\x05\x46mqOp\x12\x0f\n\x0b\x46MQ_UNKNOWN\x10\x00\x12\x0e\n\nFMQ_CREATE\x10\x01\x12\x0c\n\x08\x46MQ_READ\x10\x02\x12\x15\n\x11\x46MQ_READ_BLOCKING\x10\x03\x12\x1a\n\x16\x46MQ_READ_BLOCKING_LONG\x10\x04\x12\r\n\tFMQ_WRITE\x10\x05\x12\x16\n\x12\x46MQ_WRITE_BLOCKING\x10\x06\x12\x1b\n\x17\x46MQ_WRITE_BLOCKING_LONG\x10\x07\x12\x17\n\x13\x46MQ_AVAILABLE_WRITE\x10\x08\x12\x16\n\x12\x46MQ_AVAILABLE_READ\x10\t\x12\x18\n\x14\x46MQ_GET_QUANTUM_SIZE\x10\n\x12\x19\n\x15\x46MQ_GET_QUANTUM_COUNT\x10\x0b\x12\x10\n\x0c\x46MQ_IS_VALID\x10\x0c\x12\x15\n\x11\x46MQ_GET_DESC_ADDR\x10\r\x12\x1a\n\x16\x46MQ_WRITE_TRANSACTIONS\x10\x0e\x12\x19\n\x15\x46MQ_READ_TRANSACTIONS\x10\x0f\x12\x17\n\x13\x46MQ_WAIT_EVENT_FLAG\x10\x10\x12\x17\n\x13\x46MQ_WAKE_EVENT_FLAG\x10\x11*\xe5\x02\n\x0cHidlMemoryOp\x12\x15\n\x11MEM_PROTO_UNKNOWN\x10\x00\x12\x16\n\x12MEM_PROTO_ALLOCATE\x10\x01\x12\x18\n\x14MEM_PROTO_START_READ\x10\x02\x12\x1e\n\x1aMEM_PROTO_START_READ_RANGE\x10\x03\x12\x18\n\x14MEM_PROTO_READ_BYTES\x10\x04\x12\x1a\n\x16MEM_PROTO_START_UPDATE\x10\x05\x12 \n\x1cMEM_PROTO_START_UPDATE_RANGE\x10\x06\x12\x1a\n\x16MEM_PROTO_UPDATE_BYTES\x10\x07\x12\x14\n\x10MEM_PROTO_COMMIT\x10\x08\x12\x16\n\x12MEM_PROTO_GET_SIZE\x10\t\x12\x12\n\x0eMEM_PROTO_FREE\x10\n\x12\x19\n\x15MEM_PROTO_READ_RANGES\x10\x0b\x12\x1b\n\x17MEM_PROTO_UPDATE_RANGES\x10\x0c*\x8d\x02\n\x0cHidlHandleOp\x12\x18\n\x14HANDLE_PROTO_UNKNOWN\x10\x00\x12\x1c\n\x18HANDLE_PROTO_CREATE_FILE\x10\x01\x12\x1a\n\x16HANDLE_PROTO_READ_FILE\x10\x02\x12\x1b\n\x17HANDLE_PROTO_WRITE_FILE\x10\x03\x12\x17\n\x13HANDLE_PROTO_DELETE\x10\x04\x12\x19\n\x15HANDLE_PROTO_MAP_FILE\x10\x05\x12\x1b\n\x17HANDLE_PROTO_UNMAP_FILE\x10\x06\x12\x1c\n\x18HANDLE_PROTO_READ_MAPPED\x10\x07\x12\x1d\n\x19HANDLE_PROTO_WRITE_MAPPED\x10\x08\x42\x35\n\x15\x63om.android.vts.protoB\x1cVtsResourceControllerMessage')
   ,
   dependencies=[ComponentSpecificationMessage__pb2.DESCRIPTOR,])
 _sym_db.RegisterFileDescriptor(DESCRIPTOR)
@@ -88,11 +88,27 @@ _FMQOP = _descriptor.EnumDescriptor(
       name='FMQ_GET_DESC_ADDR', index=13, number=13,
       options=None,
       type=None),
+    _descriptor.EnumValueDescriptor(
+      name='FMQ_WRITE_TRANSACTIONS', index=14, number=14,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='FMQ_READ_TRANSACTIONS', index=15, number=15,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='FMQ_WAIT_EVENT_FLAG', index=16, number=16,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='FMQ_WAKE_EVENT_FLAG', index=17, number=17,
+      options=None,
+      type=None),
   ],
   containing_type=None,
   options=None,
-  serialized_start=1129,
-  serialized_end=1445,
+  serialized_start=1592,
+  serialized_end=2013,
 )
 _sym_db.RegisterEnumDescriptor(_FMQOP)
 
@@ -143,11 +159,23 @@ _HIDLMEMORYOP = _descriptor.EnumDescriptor(
       name='MEM_PROTO_GET_SIZE', index=9, number=9,
       options=None,
       type=None),
+    _descriptor.EnumValueDescriptor(
+      name='MEM_PROTO_FREE', index=10, number=10,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='MEM_PROTO_READ_RANGES', index=11, number=11,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='MEM_PROTO_UPDATE_RANGES', index=12, number=12,
+      options=None,
+      type=None),
   ],
   containing_type=None,
   options=None,
-  serialized_start=1448,
-  serialized_end=1729,
+  serialized_start=2016,
+  serialized_end=2373,
 )
 _sym_db.RegisterEnumDescriptor(_HIDLMEMORYOP)
 
@@ -178,11 +206,27 @@ _HIDLHANDLEOP = _descriptor.EnumDescriptor(
       name='HANDLE_PROTO_DELETE', index=4, number=4,
       options=None,
       type=None),
+    _descriptor.EnumValueDescriptor(
+      name='HANDLE_PROTO_MAP_FILE', index=5, number=5,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='HANDLE_PROTO_UNMAP_FILE', index=6, number=6,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='HANDLE_PROTO_READ_MAPPED', index=7, number=7,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='HANDLE_PROTO_WRITE_MAPPED', index=8, number=8,
+      options=None,
+      type=None),
   ],
   containing_type=None,
   options=None,
-  serialized_start=1732,
-  serialized_end=1884,
+  serialized_start=2376,
+  serialized_end=2645,
 )
 _sym_db.RegisterEnumDescriptor(_HIDLHANDLEOP)
 
@@ -201,6 +245,10 @@ FMQ_GET_QUANTUM_SIZE = 10
 FMQ_GET_QUANTUM_COUNT = 11
 FMQ_IS_VALID = 12
 FMQ_GET_DESC_ADDR = 13
+FMQ_WRITE_TRANSACTIONS = 14
+FMQ_READ_TRANSACTIONS = 15
+FMQ_WAIT_EVENT_FLAG = 16
+FMQ_WAKE_EVENT_FLAG = 17
 MEM_PROTO_UNKNOWN = 0
 MEM_PROTO_ALLOCATE = 1
 MEM_PROTO_START_READ = 2
@@ -211,11 +259,18 @@ MEM_PROTO_START_UPDATE_RANGE = 6
 MEM_PROTO_UPDATE_BYTES = 7
 MEM_PROTO_COMMIT = 8
 MEM_PROTO_GET_SIZE = 9
+MEM_PROTO_FREE = 10
+MEM_PROTO_READ_RANGES = 11
+MEM_PROTO_UPDATE_RANGES = 12
 HANDLE_PROTO_UNKNOWN = 0
 HANDLE_PROTO_CREATE_FILE = 1
 HANDLE_PROTO_READ_FILE = 2
 HANDLE_PROTO_WRITE_FILE = 3
 HANDLE_PROTO_DELETE = 4
+HANDLE_PROTO_MAP_FILE = 5
+HANDLE_PROTO_UNMAP_FILE = 6
+HANDLE_PROTO_READ_MAPPED = 7
+HANDLE_PROTO_WRITE_MAPPED = 8
 
 
 
@@ -303,6 +358,55 @@ _FMQREQUESTMESSAGE = _descriptor.Descriptor(
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
+    _descriptor.FieldDescriptor(
+      name='write_data_raw', full_name='android.vts.FmqRequestMessage.write_data_raw', index=11,
+      number=12, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='raw_read_data', full_name='android.vts.FmqRequestMessage.raw_read_data', index=12,
+      number=13, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='transaction_count', full_name='android.vts.FmqRequestMessage.transaction_count', index=13,
+      number=14, type=4, cpp_type=4, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='read_notification', full_name='android.vts.FmqRequestMessage.read_notification', index=14,
+      number=15, type=13, cpp_type=3, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='write_notification', full_name='android.vts.FmqRequestMessage.write_notification', index=15,
+      number=16, type=13, cpp_type=3, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='event_flag_queue_id', full_name='android.vts.FmqRequestMessage.event_flag_queue_id', index=16,
+      number=17, type=5, cpp_type=1, label=1,
+      has_default_value=True, default_value=-1,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='event_flag_bits', full_name='android.vts.FmqRequestMessage.event_flag_bits', index=17,
+      number=18, type=13, cpp_type=3, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
   ],
   extensions=[
   ],
@@ -316,7 +420,7 @@ _FMQREQUESTMESSAGE = _descriptor.Descriptor(
   oneofs=[
   ],
   serialized_start=89,
-  serialized_end=400,
+  serialized_end=587,
 )
 
 
@@ -355,6 +459,13 @@ _FMQRESPONSEMESSAGE = _descriptor.Descriptor(
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
+    _descriptor.FieldDescriptor(
+      name='read_data_raw', full_name='android.vts.FmqResponseMessage.read_data_raw', index=4,
+      number=5, type=12, cpp_type=9, label=1,
+      has_default_value=False, default_value=_b(""),
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
   ],
   extensions=[
   ],
@@ -367,8 +478,8 @@ _FMQRESPONSEMESSAGE = _descriptor.Descriptor(
   extension_ranges=[],
   oneofs=[
   ],
-  serialized_start=403,
-  serialized_end=546,
+  serialized_start=590,
+  serialized_end=756,
 )
 
 
@@ -421,6 +532,20 @@ _HIDLMEMORYREQUESTMESSAGE = _descriptor.Descriptor(
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
+    _descriptor.FieldDescriptor(
+      name='ranges', full_name='android.vts.HidlMemoryRequestMessage.ranges', index=6,
+      number=7, type=11, cpp_type=10, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='bracket', full_name='android.vts.HidlMemoryRequestMessage.bracket', index=7,
+      number=8, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
   ],
   extensions=[
   ],
@@ -433,8 +558,46 @@ _HIDLMEMORYREQUESTMESSAGE = _descriptor.Descriptor(
   extension_ranges=[],
   oneofs=[
   ],
-  serialized_start=549,
-  serialized_end=710,
+  serialized_start=759,
+  serialized_end=990,
+)
+
+
+_HIDLMEMORYRANGEMESSAGE = _descriptor.Descriptor(
+  name='HidlMemoryRangeMessage',
+  full_name='android.vts.HidlMemoryRangeMessage',
+  filename=None,
+  file=DESCRIPTOR,
+  containing_type=None,
+  fields=[
+    _descriptor.FieldDescriptor(
+      name='start', full_name='android.vts.HidlMemoryRangeMessage.start', index=0,
+      number=1, type=4, cpp_type=4, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='length', full_name='android.vts.HidlMemoryRangeMessage.length', index=1,
+      number=2, type=4, cpp_type=4, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+  ],
+  extensions=[
+  ],
+  nested_types=[],
+  enum_types=[
+  ],
+  options=None,
+  is_extendable=False,
+  syntax='proto2',
+  extension_ranges=[],
+  oneofs=[
+  ],
+  serialized_start=992,
+  serialized_end=1047,
 )
 
 
@@ -485,8 +648,8 @@ _HIDLMEMORYRESPONSEMESSAGE = _descriptor.Descriptor(
   extension_ranges=[],
   oneofs=[
   ],
-  serialized_start=712,
-  serialized_end=813,
+  serialized_start=1049,
+  serialized_end=1150,
 )
 
 
@@ -532,6 +695,34 @@ _HIDLHANDLEREQUESTMESSAGE = _descriptor.Descriptor(
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
+    _descriptor.FieldDescriptor(
+      name='offset', full_name='android.vts.HidlHandleRequestMessage.offset', index=5,
+      number=6, type=3, cpp_type=2, label=1,
+      has_default_value=True, default_value=-1,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='map_length', full_name='android.vts.HidlHandleRequestMessage.map_length', index=6,
+      number=7, type=4, cpp_type=4, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='read_data_vector_sizes', full_name='android.vts.HidlHandleRequestMessage.read_data_vector_sizes', index=7,
+      number=8, type=4, cpp_type=4, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='write_data_vector', full_name='android.vts.HidlHandleRequestMessage.write_data_vector', index=8,
+      number=9, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
   ],
   extensions=[
   ],
@@ -544,8 +735,8 @@ _HIDLHANDLEREQUESTMESSAGE = _descriptor.Descriptor(
   extension_ranges=[],
   oneofs=[
   ],
-  serialized_start=816,
-  serialized_end=1013,
+  serialized_start=1153,
+  serialized_end=1449,
 )
 
 
@@ -584,6 +775,13 @@ _HIDLHANDLERESPONSEMESSAGE = _descriptor.Descriptor(
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
+    _descriptor.FieldDescriptor(
+      name='read_data_vector', full_name='android.vts.HidlHandleResponseMessage.read_data_vector', index=4,
+      number=5, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
   ],
   extensions=[
   ],
@@ -596,19 +794,21 @@ _HIDLHANDLERESPONSEMESSAGE = _descriptor.Descriptor(
   extension_ranges=[],
   oneofs=[
   ],
-  serialized_start=1015,
-  serialized_end=1126,
+  serialized_start=1452,
+  serialized_end=1589,
 )
 
 _FMQREQUESTMESSAGE.fields_by_name['operation'].enum_type = _FMQOP
 _FMQREQUESTMESSAGE.fields_by_name['write_data'].message_type = ComponentSpecificationMessage__pb2._VARIABLESPECIFICATIONMESSAGE
 _FMQRESPONSEMESSAGE.fields_by_name['read_data'].message_type = ComponentSpecificationMessage__pb2._VARIABLESPECIFICATIONMESSAGE
 _HIDLMEMORYREQUESTMESSAGE.fields_by_name['operation'].enum_type = _HIDLMEMORYOP
+_HIDLMEMORYREQUESTMESSAGE.fields_by_name['ranges'].message_type = _HIDLMEMORYRANGEMESSAGE
 _HIDLHANDLEREQUESTMESSAGE.fields_by_name['operation'].enum_type = _HIDLHANDLEOP
 _HIDLHANDLEREQUESTMESSAGE.fields_by_name['handle_info'].message_type = ComponentSpecificationMessage__pb2._HANDLEDATAVALUEMESSAGE
 DESCRIPTOR.message_types_by_name['FmqRequestMessage'] = _FMQREQUESTMESSAGE
 DESCRIPTOR.message_types_by_name['FmqResponseMessage'] = _FMQRESPONSEMESSAGE
 DESCRIPTOR.message_types_by_name['HidlMemoryRequestMessage'] = _HIDLMEMORYREQUESTMESSAGE
+DESCRIPTOR.message_types_by_name['HidlMemoryRangeMessage'] = _HIDLMEMORYRANGEMESSAGE
 DESCRIPTOR.message_types_by_name['HidlMemoryResponseMessage'] = _HIDLMEMORYRESPONSEMESSAGE
 DESCRIPTOR.message_types_by_name['HidlHandleRequestMessage'] = _HIDLHANDLEREQUESTMESSAGE
 DESCRIPTOR.message_types_by_name['HidlHandleResponseMessage'] = _HIDLHANDLERESPONSEMESSAGE
@@ -637,6 +837,13 @@ HidlMemoryRequestMessage = _reflection.GeneratedProtocolMessageType('HidlMemoryR
   ))
 _sym_db.RegisterMessage(HidlMemoryRequestMessage)
 
+HidlMemoryRangeMessage = _reflection.GeneratedProtocolMessageType('HidlMemoryRangeMessage', (_message.Message,), dict(
+  DESCRIPTOR = _HIDLMEMORYRANGEMESSAGE,
+  __module__ = 'VtsResourceControllerMessage_pb2'
+  # @@protoc_insertion_point(class_scope:android.vts.HidlMemoryRangeMessage)
+  ))
+_sym_db.RegisterMessage(HidlMemoryRangeMessage)
+
 HidlMemoryResponseMessage = _reflection.GeneratedProtocolMessageType('HidlMemoryResponseMessage', (_message.Message,), dict(
   DESCRIPTOR = _HIDLMEMORYRESPONSEMESSAGE,
   __module__ = 'VtsResourceControllerMessage_pb2'
@@ -0,0 +1,86 @@
+#
+# Copyright (C) 2020 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import logging
+import struct
+
+# Size of the words of a gcda delta, which are in the byte order of the
+# device, i.e. little-endian.
+_WORD_FORMAT = "<I"
+_WORD_SIZE = struct.calcsize(_WORD_FORMAT)
+
+
+class GcdaSnapshots(object):
+    """Rebuilds the gcda files that a driver reports as deltas.
+
+    A driver that reports coverage deltas (see report_coverage_delta in
+    VtsDriverControlCommandMessage) sends a gcda file in full the first time,
+    then only the 32-bit words that changed since the previous message for
+    the same file (see NativeCodeCoverageRawDataMessage.is_delta).
+
+    Attributes:
+        _snapshots: dict, the latest content of each gcda file as a
+                    bytearray, by file path.
+    """
+
+    def __init__(self):
+        self._snapshots = {}
+
+    def Reset(self):
+        """Forgets all the gcda files, e.g. after asking the driver to reset
+        its coverage delta."""
+        self._snapshots.clear()
+
+    def Merge(self, raw_coverage_data):
+        """Replaces each delta of raw_coverage_data with the full gcda file.
+
+        Args:
+            raw_coverage_data: list of NativeCodeCoverageRawDataMessage, the
+                               coverage of a call, updated in place.
+
+        Returns:
+            bool, false if a delta refers to a file that was not reported in
+            full before, or is out of its range. Such a delta is left as is.
+        """
+        success = True
+        for raw_data in raw_coverage_data:
+            if not raw_data.is_delta:
+                if raw_data.gcda:
+                    self._snapshots[raw_data.file_path] = bytearray(
+                        raw_data.gcda)
+                continue
+            snapshot = self._snapshots.get(raw_data.file_path)
+            if snapshot is None:
+                logging.error("gcda delta of an unknown file %s",
+                              raw_data.file_path)
+                success = False
+                continue
+            if len(raw_data.gcda_delta_index) != len(
+                    raw_data.gcda_delta_value) or any(
+                        (index + 1) * _WORD_SIZE > len(snapshot)
+                        for index in raw_data.gcda_delta_index):
+                logging.error("invalid gcda delta of %s", raw_data.file_path)
+                success = False
+                continue
+            for index, value in zip(raw_data.gcda_delta_index,
+                                    raw_data.gcda_delta_value):
+                struct.pack_into(_WORD_FORMAT, snapshot, index * _WORD_SIZE,
+                                 value)
+            raw_data.gcda = bytes(snapshot)
+            raw_data.is_delta = False
+            del raw_data.gcda_delta_index[:]
+            del raw_data.gcda_delta_value[:]
+        return success
@@ -0,0 +1,98 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2020 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import struct
+import unittest
+
+from vts.runners.host.tcp_client import gcda_delta
+
+
+class FakeRawCoverageData(object):
+    """Has the fields of NativeCodeCoverageRawDataMessage used by
+    GcdaSnapshots."""
+
+    def __init__(self, file_path, gcda=b"", delta=None):
+        self.file_path = file_path
+        self.gcda = gcda
+        self.is_delta = delta is not None
+        self.gcda_delta_index = [index for index, _ in delta or []]
+        self.gcda_delta_value = [value for _, value in delta or []]
+
+
+def _Words(*words):
+    return struct.pack("<%dI" % len(words), *words)
+
+
+class GcdaSnapshotsTest(unittest.TestCase):
+    """Checks that the deltas of the drivers give back the full gcda files."""
+
+    def setUp(self):
+        self._snapshots = gcda_delta.GcdaSnapshots()
+
+    def testDeltaIsAppliedToThePreviousFile(self):
+        self.assertTrue(
+            self._snapshots.Merge([FakeRawCoverageData("a.gcda",
+                                                       _Words(1, 2, 3))]))
+        delta = FakeRawCoverageData("a.gcda", delta=[(0, 7), (2, 9)])
+        self.assertTrue(self._snapshots.Merge([delta]))
+        self.assertFalse(delta.is_delta)
+        self.assertEqual(delta.gcda, _Words(7, 2, 9))
+        self.assertEqual(delta.gcda_delta_index, [])
+        self.assertEqual(delta.gcda_delta_value, [])
+
+        # The next delta applies to the file rebuilt from the previous one.
+        delta = FakeRawCoverageData("a.gcda", delta=[(1, 5)])
+        self.assertTrue(self._snapshots.Merge([delta]))
+        self.assertEqual(delta.gcda, _Words(7, 5, 9))
+
+    def testFilesAreTrackedSeparately(self):
+        self._snapshots.Merge([
+            FakeRawCoverageData("a.gcda", _Words(1, 1)),
+            FakeRawCoverageData("b.gcda", _Words(2, 2))
+        ])
+        deltas = [
+            FakeRawCoverageData("b.gcda", delta=[(1, 4)]),
+            FakeRawCoverageData("a.gcda", delta=[(0, 3)])
+        ]
+        self.assertTrue(self._snapshots.Merge(deltas))
+        self.assertEqual(deltas[0].gcda, _Words(2, 4))
+        self.assertEqual(deltas[1].gcda, _Words(3, 1))
+
+    def testFullFileReplacesTheSnapshot(self):
+        self._snapshots.Merge([FakeRawCoverageData("a.gcda", _Words(1))])
+        self._snapshots.Merge([FakeRawCoverageData("a.gcda", _Words(6, 6))])
+        delta = FakeRawCoverageData("a.gcda", delta=[(1, 8)])
+        self.assertTrue(self._snapshots.Merge([delta]))
+        self.assertEqual(delta.gcda, _Words(6, 8))
+
+    def testInvalidDeltasAreLeftAsIs(self):
+        unknown = FakeRawCoverageData("a.gcda", delta=[(0, 1)])
+        self.assertFalse(self._snapshots.Merge([unknown]))
+        self.assertTrue(unknown.is_delta)
+
+        self._snapshots.Merge([FakeRawCoverageData("a.gcda", _Words(1))])
+        out_of_range = FakeRawCoverageData("a.gcda", delta=[(1, 1)])
+        self.assertFalse(self._snapshots.Merge([out_of_range]))
+        self.assertTrue(out_of_range.is_delta)
+
+        self._snapshots.Reset()
+        forgotten = FakeRawCoverageData("a.gcda", delta=[(0, 2)])
+        self.assertFalse(self._snapshots.Merge([forgotten]))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -25,7 +25,9 @@ from vts.proto import ComponentSpecificationMessage_pb2 as CompSpecMsg_pb2
 from vts.proto import VtsResourceControllerMessage_pb2 as ResControlMsg_pb2
 from vts.runners.host import const
 from vts.runners.host import errors
+from vts.runners.host.tcp_client import gcda_delta
 from vts.utils.python.mirror import mirror_object
+from vts.utils.python.mirror import pb2py
 
 from google.protobuf import text_format
 
@@ -63,6 +65,8 @@ class VtsTcpClient(object):
         error: string, ongoing tcp connection error. None means no error.
         _mode: the connection mode (adb_forwarding or ssh_tunnel)
         timeout: tcp connection timeout.
+        _gcda_snapshots: GcdaSnapshots, rebuilds the gcda files returned as
+                         deltas by the drivers.
     """
 
     NO_RESPONSE_MSG = "Framework error: TCP client did not receive response from device."
@@ -76,6 +80,7 @@ class VtsTcpClient(object):
         self._mode = mode
         self.timeout = timeout
         self.error = None
+        self._gcda_snapshots = gcda_delta.GcdaSnapshots()
 
     @property
     def timeout(self):
@@ -321,6 +326,8 @@ class VtsTcpClient(object):
             return result
         elif (var_spec_msg.type == CompSpecMsg_pb2.TYPE_VECTOR
               or var_spec_msg.type == CompSpecMsg_pb2.TYPE_ARRAY):
+            if var_spec_msg.HasField("vector_raw_value"):
+                return pb2py.PbRawVector2PyList(var_spec_msg)
             result = []
             for vector_value in var_spec_msg.vector_value:
                 result.append(
@@ -367,6 +374,8 @@ class VtsTcpClient(object):
                         self.GetPythonDataOfVariableSpecMsg(return_type_hidl))
 
             if len(result.raw_coverage_data) > 0:
+                # The callers always get the full gcda files.
+                self._gcda_snapshots.Merge(result.raw_coverage_data)
                 return result_value, {"coverage": result.raw_coverage_data}
             else:
                 return result_value
@@ -21,14 +21,20 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <map>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -100,9 +106,51 @@ static int global_test_run_deadline_ms = DEFAULT_GLOBAL_TEST_RUN_DEADLINE_MS;
 // It takes effect only with --isolate option.
 static int global_test_run_warnline_ms = DEFAULT_GLOBAL_TEST_RUN_WARNLINE_MS;
 
+constexpr size_t DEFAULT_GLOBAL_MAX_TEST_OUTPUT_BYTES = 1024 * 1024;
+
+// The output of each test kept in memory, the rest is spilled to a temporary
+// file until the test result is printed.
+// It takes effect only with --isolate option.
+static size_t global_max_test_output_bytes =
+    DEFAULT_GLOBAL_MAX_TEST_OUTPUT_BYTES;
+
+// The CPU time (user and system) and the max RSS of the process above which
+// a test is reported, 0 for no limit. The test fails if
+// global_fail_over_resource_limits is set.
+// It takes effect only with --isolate option.
+static int64_t global_max_test_cpu_time_ms = 0;
+static int64_t global_max_test_rss_kb = 0;
+static bool global_fail_over_resource_limits = false;
+
+// The buffer size of the xml and result stream files.
+constexpr size_t RESULT_FILE_BUFFER_SIZE = 256 * 1024;
+
+// The duration of each test in previous runs, in ms, read from and written
+// to the file given by --timing-db.
+static std::map<std::string, int64_t> test_duration_history_ms;
+
+// The deadline of a test with a duration in test_duration_history_ms is that
+// many times the duration, at least MIN_HISTORY_DEADLINE_MS. The history only
+// extends global_test_run_deadline_ms, so that a test which was fast before
+// doesn't time out earlier than without a database.
+constexpr int HISTORY_DEADLINE_FACTOR = 5;
+constexpr int MIN_HISTORY_DEADLINE_MS = 10000;
+
+// The shard of the tests run by this process, out of shard_count shards,
+// see SelectShardTests. It takes effect only with --isolate option.
+static size_t global_shard_index = 0;
+static size_t global_shard_count = 1;
+
 // Return deadline duration for a test, in ms.
-static int GetDeadlineInfo(const std::string& /*test_name*/) {
-  return global_test_run_deadline_ms;
+static int GetDeadlineInfo(const std::string& test_name) {
+  auto it = test_duration_history_ms.find(test_name);
+  if (it == test_duration_history_ms.end()) {
+    return global_test_run_deadline_ms;
+  }
+  int64_t deadline_ms = std::max<int64_t>(
+      it->second * HISTORY_DEADLINE_FACTOR, MIN_HISTORY_DEADLINE_MS);
+  return static_cast<int>(std::min<int64_t>(
+      std::max<int64_t>(deadline_ms, global_test_run_deadline_ms), INT_MAX));
 }
 
 // Return warnline duration for a test, in ms.
@@ -128,6 +176,51 @@ static void PrintHelpInfo() {
       "      Test running longer than [TIME_IN_MS] will be warned.\n"
       "      It takes effect only in isolation mode. Default warnline is 2000 "
       "ms.\n"
+      "  --tests-per-proc=[TEST_COUNT]\n"
+      "      Run up to TEST_COUNT tests in each child process, so that the "
+      "global\n"
+      "      test environment is set up once for several tests. The tests a "
+      "child\n"
+      "      process didn't run as it crashed or timed out run in a new one.\n"
+      "      It takes effect only in isolation mode. Default is 1.\n"
+      "  --max-test-output=[BYTES]\n"
+      "      Keep up to BYTES of the output of each test in memory, and spill "
+      "the\n"
+      "      rest to a temporary file until the test result is printed. Only "
+      "the\n"
+      "      output kept in memory is written to the xml file.\n"
+      "      It takes effect only in isolation mode. Default is 1048576.\n"
+      "  --result-stream=[FILE]\n"
+      "      Write a compact binary record to FILE for each test as soon as it "
+      "ends,\n"
+      "      see WriteResultStreamRecord.\n"
+      "      It takes effect only in isolation mode.\n"
+      "  --timing-db=[FILE]\n"
+      "      Read the durations of the tests in previous runs from FILE, to "
+      "run the\n"
+      "      longest tests first and derive the deadline of each test from "
+      "its\n"
+      "      duration, then write the durations of this run back to FILE.\n"
+      "      FILE is only read when the tests are sharded.\n"
+      "      It takes effect only in isolation mode.\n"
+      "  --max-test-cpu-time=[TIME_IN_MS] --max-test-rss=[KB]\n"
+      "      Warn about the tests that use more CPU time, user and system, or "
+      "whose\n"
+      "      process reaches a larger max RSS.\n"
+      "      It takes effect only in isolation mode. Default is no limit.\n"
+      "  --fail-over-resource-limits\n"
+      "      Fail the tests over --max-test-cpu-time or --max-test-rss "
+      "instead of\n"
+      "      warning about them.\n"
+      "  --shard-index=[INDEX] --shard-count=[COUNT]\n"
+      "      Run only the tests of shard INDEX out of COUNT shards, e.g. one "
+      "shard per\n"
+      "      device. The shards are balanced by the durations in --timing-db "
+      "if\n"
+      "      given, and are the same for the same tests and timing database,\n"
+      "      which is why the shards don't write it back.\n"
+      "      Default to GTEST_SHARD_INDEX and GTEST_TOTAL_SHARDS.\n"
+      "      It takes effect only in isolation mode.\n"
       "  --gtest-filter=POSITIVE_PATTERNS[-NEGATIVE_PATTERNS]\n"
       "      Used as a synonym for --gtest_filter option in gtest.\n"
       "Default vts unit test option is -j.\n"
@@ -141,6 +234,73 @@ static void PrintHelpInfo() {
 
 enum TestResult { TEST_SUCCESS = 0, TEST_FAILED, TEST_TIMEOUT };
 
+// The resources used by a test, from getrusage() in the child process for
+// the tests that ended, and from wait4() for the test a child process was
+// running when it exited or was killed. They include the setup of the test
+// case and the time between tests. max_rss_kb is the max RSS of the process
+// by the end of the test.
+struct TestUsage {
+  int64_t user_time_us = 0;
+  int64_t system_time_us = 0;
+  int64_t max_rss_kb = 0;
+  int64_t minor_faults = 0;
+  int64_t major_faults = 0;
+  int64_t voluntary_switches = 0;
+  int64_t involuntary_switches = 0;
+};
+
+static TestUsage GetTestUsage(const struct rusage& usage) {
+  TestUsage result;
+  result.user_time_us =
+      usage.ru_utime.tv_sec * 1000000LL + usage.ru_utime.tv_usec;
+  result.system_time_us =
+      usage.ru_stime.tv_sec * 1000000LL + usage.ru_stime.tv_usec;
+  result.max_rss_kb = usage.ru_maxrss;
+  result.minor_faults = usage.ru_minflt;
+  result.major_faults = usage.ru_majflt;
+  result.voluntary_switches = usage.ru_nvcsw;
+  result.involuntary_switches = usage.ru_nivcsw;
+  return result;
+}
+
+// Returns the usage between the cumulative usages start and end of a
+// process.
+static TestUsage SubtractTestUsage(const TestUsage& end,
+                                   const TestUsage& start) {
+  TestUsage result;
+  result.user_time_us = end.user_time_us - start.user_time_us;
+  result.system_time_us = end.system_time_us - start.system_time_us;
+  result.max_rss_kb = end.max_rss_kb;
+  result.minor_faults = end.minor_faults - start.minor_faults;
+  result.major_faults = end.major_faults - start.major_faults;
+  result.voluntary_switches = end.voluntary_switches - start.voluntary_switches;
+  result.involuntary_switches =
+      end.involuntary_switches - start.involuntary_switches;
+  return result;
+}
+
+// Returns the resource limits exceeded by usage, empty if none.
+static std::string GetExceededResourceLimits(const TestUsage& usage) {
+  std::string exceeded;
+  char buf[100];
+  int64_t cpu_time_ms = (usage.user_time_us + usage.system_time_us) / 1000;
+  if (global_max_test_cpu_time_ms > 0 &&
+      cpu_time_ms > global_max_test_cpu_time_ms) {
+    snprintf(buf, sizeof(buf),
+             "CPU time %" PRId64 " ms over %" PRId64 " ms", cpu_time_ms,
+             global_max_test_cpu_time_ms);
+    exceeded += buf;
+  }
+  if (global_max_test_rss_kb > 0 &&
+      usage.max_rss_kb > global_max_test_rss_kb) {
+    snprintf(buf, sizeof(buf), "%smax RSS %" PRId64 " KB over %" PRId64 " KB",
+             exceeded.empty() ? "" : ", ", usage.max_rss_kb,
+             global_max_test_rss_kb);
+    exceeded += buf;
+  }
+  return exceeded;
+}
+
 class Test {
  public:
   Test() {}  // For std::vector<Test>.
@@ -158,15 +318,97 @@ class Test {
 
   int64_t GetTestTime() const { return elapsed_time_ns_; }
 
-  void AppendTestOutput(const std::string& s) { output_ += s; }
+  void SetTestUsage(const TestUsage& usage) { usage_ = usage; }
+
+  const TestUsage& GetTestUsage() const { return usage_; }
+
+  // Appends output of the test. Up to global_max_test_output_bytes are kept
+  // in memory, the rest is spilled to a temporary file.
+  void AppendTestOutput(const std::string& s) {
+    size_t kept_size = 0;
+    if (spilled_output_size_ == 0 &&
+        output_.size() < global_max_test_output_bytes) {
+      kept_size =
+          std::min(s.size(), global_max_test_output_bytes - output_.size());
+      output_.append(s, 0, kept_size);
+    }
+    if (kept_size == s.size()) {
+      return;
+    }
+    if (spilled_output_size_ == 0) {
+      spill_fp_ = tmpfile();
+      if (spill_fp_ == NULL) {
+        perror("failed to create test output spill file");
+      } else {
+        // Unbuffered, so that no pending data is copied into the children
+        // forked while the file is open.
+        setvbuf(spill_fp_, NULL, _IONBF, 0);
+      }
+    }
+    if (spill_fp_ != NULL) {
+      fwrite(s.data() + kept_size, 1, s.size() - kept_size, spill_fp_);
+    }
+    spilled_output_size_ += s.size() - kept_size;
+  }
+
+  // Appends a message of the runner about the test, which is always kept in
+  // memory.
+  void AppendTestMessage(const std::string& s) {
+    if (spilled_output_size_ == 0) {
+      output_ += s;
+    } else {
+      message_ += s;
+    }
+  }
+
+  // Returns the output kept in memory and the messages of the runner.
+  std::string GetTestOutput() const {
+    if (spilled_output_size_ == 0) {
+      return output_;
+    }
+    char buf[100];
+    snprintf(buf, sizeof(buf), "\n[... %zu bytes of output not kept ...]\n",
+             spilled_output_size_);
+    return output_ + buf + message_;
+  }
+
+  // Prints the whole output and the messages of the runner, and deletes the
+  // spill file.
+  void PrintTestOutput() {
+    printf("%s", output_.c_str());
+    if (spill_fp_ != NULL) {
+      fflush(stdout);
+      rewind(spill_fp_);
+      char buf[4096];
+      size_t size;
+      while ((size = fread(buf, 1, sizeof(buf), spill_fp_)) > 0) {
+        fwrite(buf, 1, size, stdout);
+      }
+      fclose(spill_fp_);
+      spill_fp_ = NULL;
+    }
+    printf("%s", message_.c_str());
+  }
 
-  const std::string& GetTestOutput() const { return output_; }
+  void ClearTestOutput() {
+    std::string().swap(output_);
+    std::string().swap(message_);
+    if (spill_fp_ != NULL) {
+      fclose(spill_fp_);
+      spill_fp_ = NULL;
+    }
+    spilled_output_size_ = 0;
+  }
 
  private:
   const std::string name_;
   TestResult result_;
   int64_t elapsed_time_ns_;
+  TestUsage usage_;
   std::string output_;
+  std::string message_;  // Messages of the runner after spilled output.
+  FILE* spill_fp_ = NULL;
+  size_t spilled_output_size_ = 0;
 };
 
 class TestCase {
@@ -217,6 +459,16 @@ class TestCase {
     return test_list_[test_id].GetTestTime();
   }
 
+  void SetTestUsage(size_t test_id, const TestUsage& usage) {
+    VerifyTestId(test_id);
+    test_list_[test_id].SetTestUsage(usage);
+  }
+
+  const TestUsage& GetTestUsage(size_t test_id) const {
+    VerifyTestId(test_id);
+    return test_list_[test_id].GetTestUsage();
+  }
+
  private:
   void VerifyTestId(size_t test_id) const {
     if (test_id >= test_list_.size()) {
@@ -262,52 +514,93 @@ static int64_t NanoTime() {
   return static_cast<int64_t>(duration.count());
 }
 
-static bool EnumerateTests(int argc, char** argv,
-                           std::vector<TestCase>& testcase_list) {
-  std::string command;
-  for (int i = 0; i < argc; ++i) {
-    command += argv[i];
-    command += " ";
+// Returns true if str matches pattern, which ends with '\0' or ':' and may
+// contain the '*' and '?' wildcards, as in gtest.
+static bool PatternMatchesString(const char* pattern, const char* str) {
+  switch (*pattern) {
+    case '\0':
+    case ':':
+      return *str == '\0';
+    case '?':
+      return *str != '\0' && PatternMatchesString(pattern + 1, str + 1);
+    case '*':
+      return (*str != '\0' && PatternMatchesString(pattern, str + 1)) ||
+             PatternMatchesString(pattern + 1, str);
+    default:
+      return *pattern == *str && PatternMatchesString(pattern + 1, str + 1);
   }
-  command += "--gtest_list_tests";
-  FILE* fp = popen(command.c_str(), "r");
-  if (fp == NULL) {
-    perror("popen");
-    return false;
+}
+
+// Returns true if name matches one of the ':'-separated patterns of filter.
+static bool MatchesFilter(const std::string& name, const char* filter) {
+  for (const char* pattern = filter; pattern != NULL;
+       pattern = strchr(pattern, ':')) {
+    if (*pattern == ':') {
+      ++pattern;
+    }
+    if (PatternMatchesString(pattern, name.c_str())) {
+      return true;
+    }
   }
+  return false;
+}
 
-  char buf[200];
-  while (fgets(buf, sizeof(buf), fp) != NULL) {
-    char* p = buf;
-
-    while (*p != '\0' && isspace(*p)) {
-      ++p;
-    }
-    if (*p == '\0') continue;
-    char* start = p;
-    while (*p != '\0' && !isspace(*p)) {
-      ++p;
-    }
-    char* end = p;
-    while (*p != '\0' && isspace(*p)) {
-      ++p;
-    }
-    if (*p != '\0' && *p != '#') {
-      // This is not we want, gtest must meet with some error when parsing the
-      // arguments.
-      fprintf(stderr, "argument error, check with --help\n");
-      return false;
-    }
-    *end = '\0';
-    if (*(end - 1) == '.') {
-      *(end - 1) = '\0';
-      testcase_list.push_back(TestCase(start));
-    } else {
-      testcase_list.back().AppendTest(start);
+// Returns true if the test is selected by --gtest_filter, which is made of
+// POSITIVE_PATTERNS[-NEGATIVE_PATTERNS].
+static bool FilterMatchesTest(const std::string& test_name) {
+  const std::string filter = testing::GTEST_FLAG(filter);
+  size_t dash_pos = filter.find('-');
+  std::string positive = filter.substr(0, dash_pos);
+  std::string negative =
+      dash_pos == std::string::npos ? "" : filter.substr(dash_pos + 1);
+  if (positive.empty()) {
+    positive = "*";
+  }
+  return MatchesFilter(test_name, positive.c_str()) &&
+         !MatchesFilter(test_name, negative.c_str());
+}
+
+// Returns true if a test case or test name disables the test, as in gtest.
+static bool IsDisabledName(const char* name) {
+  return MatchesFilter(name, "DISABLED_*:*/DISABLED_*");
+}
+
+// Enumerates the tests to run from the gtest registry, instead of listing
+// them in another process with --gtest_list_tests. This also initializes
+// gtest for the child processes, which are forked from this process.
+static bool EnumerateTests(int argc, char** argv,
+                           std::vector<TestCase>& testcase_list) {
+  // InitGoogleTest removes the arguments it parses, keep argv as it is.
+  std::vector<char*> args(argv, argv + argc);
+  args.push_back(NULL);
+  int args_count = argc;
+  testing::InitGoogleTest(&args_count, args.data());
+
+  testing::UnitTest* unit_test = testing::UnitTest::GetInstance();
+  for (int i = 0; i < unit_test->total_test_case_count(); ++i) {
+    const testing::TestCase* test_case = unit_test->GetTestCase(i);
+    bool testcase_added = false;
+    for (int j = 0; j < test_case->total_test_count(); ++j) {
+      const testing::TestInfo* test_info = test_case->GetTestInfo(j);
+      std::string test_name =
+          std::string(test_case->name()) + "." + test_info->name();
+      if (!FilterMatchesTest(test_name)) {
+        continue;
+      }
+      // The child processes don't run the disabled tests.
+      if (!testing::GTEST_FLAG(also_run_disabled_tests) &&
+          (IsDisabledName(test_case->name()) ||
+           IsDisabledName(test_info->name()))) {
+        continue;
+      }
+      if (!testcase_added) {
+        testcase_list.push_back(TestCase(test_case->name()));
+        testcase_added = true;
+      }
+      testcase_list.back().AppendTest(test_info->name());
     }
   }
-  int result = pclose(fp);
-  return (result != -1 && WEXITSTATUS(result) == 0);
+  return true;
 }
 
 // Part of the following *Print functions are copied from
@@ -329,19 +622,22 @@ static void OnTestIterationStartPrint(
     test_count += testcase.TestCount();
   }
 
-  printf("Running %zu %s from %zu %s.\n", test_count,
+  printf("Running %zu %s from %zu %s", test_count,
          (test_count == 1) ? "test" : "tests", testcase_count,
          (testcase_count == 1) ? "test case" : "test cases");
+  if (global_shard_count > 1) {
+    printf(" (shard %zu of %zu)", global_shard_index, global_shard_count);
+  }
+  printf(".\n");
   fflush(stdout);
 }
 
 // vts cts test needs gtest output format.
-static void OnTestEndPrint(const TestCase& testcase, size_t test_id) {
+static void OnTestEndPrint(TestCase& testcase, size_t test_id) {
   ColoredPrintf(COLOR_GREEN, "[ RUN      ] ");
   printf("%s\n", testcase.GetTestName(test_id).c_str());
 
-  const std::string& test_output = testcase.GetTest(test_id).GetTestOutput();
-  printf("%s", test_output.c_str());
+  testcase.GetTest(test_id).PrintTestOutput();
 
   TestResult result = testcase.GetTestResult(test_id);
   if (result == TEST_SUCCESS) {
@@ -365,6 +661,11 @@ static void OnTestIterationEndPrint(const std::vector<TestCase>& testcase_list,
 
   // For tests run exceed warnline but not timeout.
   std::vector<std::tuple<std::string, int64_t, int>> slow_test_list;
+  // For tests over the resource limits.
+  std::vector<std::pair<std::string, std::string>> over_limit_test_list;
+  int64_t total_cpu_time_us = 0;
+  std::pair<std::string, int64_t> max_cpu_time_test("", -1);
+  std::pair<std::string, int64_t> max_rss_test("", -1);
   size_t testcase_count = testcase_list.size();
   size_t test_count = 0;
   size_t success_test_count = 0;
@@ -388,6 +689,22 @@ static void OnTestIterationEndPrint(const std::vector<TestCase>& testcase_list,
             std::make_tuple(testcase.GetTestName(i), testcase.GetTestTime(i),
                             GetWarnlineInfo(testcase.GetTestName(i))));
       }
+      const TestUsage& usage = testcase.GetTestUsage(i);
+      std::string exceeded = GetExceededResourceLimits(usage);
+      if (!exceeded.empty()) {
+        over_limit_test_list.push_back(
+            std::make_pair(testcase.GetTestName(i), exceeded));
+      }
+      int64_t cpu_time_us = usage.user_time_us + usage.system_time_us;
+      total_cpu_time_us += cpu_time_us;
+      if (cpu_time_us > max_cpu_time_test.second) {
+        max_cpu_time_test =
+            std::make_pair(testcase.GetTestName(i), cpu_time_us);
+      }
+      if (usage.max_rss_kb > max_rss_test.second) {
+        max_rss_test =
+            std::make_pair(testcase.GetTestName(i), usage.max_rss_kb);
+      }
     }
   }
 
@@ -442,6 +759,33 @@ static void OnTestIterationEndPrint(const std::vector<TestCase>& testcase_list,
     }
   }
 
+  // Print tests over the resource limits, which failed too if
+  // global_fail_over_resource_limits is set.
+  size_t over_limit_test_count = over_limit_test_list.size();
+  if (over_limit_test_count > 0) {
+    const char* color =
+        global_fail_over_resource_limits ? COLOR_RED : COLOR_YELLOW;
+    ColoredPrintf(color, "[ RESOURCE ] ");
+    printf("%zu %s, listed below:\n", over_limit_test_count,
+           (over_limit_test_count == 1) ? "test" : "tests");
+    for (const auto& over_limit_pair : over_limit_test_list) {
+      ColoredPrintf(color, "[ RESOURCE ] ");
+      printf("%s (%s)\n", over_limit_pair.first.c_str(),
+             over_limit_pair.second.c_str());
+    }
+  }
+
+  // Print the resource usage, to size the job count.
+  if (testing::GTEST_FLAG(print_time) && test_count > 0) {
+    ColoredPrintf(COLOR_GREEN, "[  USAGE   ] ");
+    printf("%" PRId64 " ms CPU time total, most by %s (%" PRId64 " ms)\n",
+           total_cpu_time_us / 1000, max_cpu_time_test.first.c_str(),
+           max_cpu_time_test.second / 1000);
+    ColoredPrintf(COLOR_GREEN, "[  USAGE   ] ");
+    printf("Largest max RSS by %s (%" PRId64 " KB)\n",
+           max_rss_test.first.c_str(), max_rss_test.second);
+  }
+
   if (fail_test_count > 0) {
     printf("\n%2zu FAILED %s\n", fail_test_count,
            (fail_test_count == 1) ? "TEST" : "TESTS");
@@ -505,6 +849,7 @@ void OnTestIterationEndXmlPrint(const std::string& xml_output_filename,
             strerror(errno));
     exit(1);
   }
+  setvbuf(fp, NULL, _IOFBF, RESULT_FILE_BUFFER_SIZE);
 
   size_t total_test_count = 0;
   size_t total_failed_count = 0;
@@ -534,8 +879,14 @@ void OnTestIterationEndXmlPrint(const std::string& xml_output_filename,
       fp,
       "<testsuites tests=\"%zu\" failures=\"%zu\" disabled=\"0\" errors=\"0\"",
       total_test_count, total_failed_count);
-  fprintf(fp, " timestamp=\"%s\" time=\"%.3lf\" name=\"AllTests\">\n",
-          timestamp, elapsed_time_ns / 1e9);
+  fprintf(fp, " timestamp=\"%s\" time=\"%.3lf\"", timestamp,
+          elapsed_time_ns / 1e9);
+  // The results of the shards are merged by the host.
+  if (global_shard_count > 1) {
+    fprintf(fp, " shard_index=\"%zu\" shard_count=\"%zu\"",
+            global_shard_index, global_shard_count);
+  }
+  fputs(" name=\"AllTests\">\n", fp);
   for (size_t i = 0; i < testcase_list.size(); ++i) {
     auto& testcase = testcase_list[i];
     fprintf(fp,
@@ -551,11 +902,20 @@ void OnTestIterationEndXmlPrint(const std::string& xml_output_filename,
               "classname=\"%s\"",
               testcase.GetTest(j).GetName().c_str(),
               testcase.GetTestTime(j) / 1e9, testcase.GetName().c_str());
+      const TestUsage& usage = testcase.GetTestUsage(j);
+      fprintf(fp,
+              " user_time=\"%.3lf\" system_time=\"%.3lf\" "
+              "max_rss_kb=\"%" PRId64 "\" minor_faults=\"%" PRId64
+              "\" major_faults=\"%" PRId64 "\" voluntary_switches=\"%" PRId64
+              "\" involuntary_switches=\"%" PRId64 "\"",
+              usage.user_time_us / 1e6, usage.system_time_us / 1e6,
+              usage.max_rss_kb, usage.minor_faults, usage.major_faults,
+              usage.voluntary_switches, usage.involuntary_switches);
       if (testcase.GetTestResult(j) == TEST_SUCCESS) {
         fputs(" />\n", fp);
       } else {
         fputs(">\n", fp);
-        const std::string& test_output = testcase.GetTest(j).GetTestOutput();
+        const std::string test_output = testcase.GetTest(j).GetTestOutput();
         const std::string escaped_test_output = XmlEscape(test_output);
         fprintf(fp, "      <failure message=\"%s\" type=\"\">\n",
                 escaped_test_output.c_str());
@@ -570,20 +930,99 @@ void OnTestIterationEndXmlPrint(const std::string& xml_output_filename,
   fclose(fp);
 }
 
+// Appends the raw bytes of value to buffer.
+template <typename T>
+static void AppendValue(std::string& buffer, T value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// The file given by --result-stream. It is buffered in memory rather than
+// with stdio, as the child processes would flush a stdio buffer they inherit.
+struct ResultStream {
+  int fd;
+  std::string buffer;
+};
+
+static void FlushResultStream(ResultStream& stream) {
+  const char* p = stream.buffer.data();
+  size_t size = stream.buffer.size();
+  while (size > 0) {
+    ssize_t written = TEMP_FAILURE_RETRY(write(stream.fd, p, size));
+    if (written == -1) {
+      perror("failed to write result stream");
+      exit(1);
+    }
+    p += written;
+    size -= written;
+  }
+  stream.buffer.clear();
+}
+
+// Writes the result of a finished test to the file given by --result-stream,
+// as a record of fields in host byte order (little-endian on Android):
+//   uint32_t record size, excluding this field
+//   uint32_t iteration
+//   uint8_t  result, a TestResult
+//   int64_t  elapsed time in ns
+//   uint16_t name size, followed by the test name
+//   uint32_t output size, followed by the output in the xml file
+void WriteResultStreamRecord(ResultStream& stream, size_t iteration,
+                             const TestCase& testcase, size_t test_id) {
+  std::string name = testcase.GetTestName(test_id);
+  name.resize(std::min<size_t>(name.size(), UINT16_MAX));
+  std::string output = testcase.GetTest(test_id).GetTestOutput();
+  std::string record;
+  AppendValue<uint32_t>(record, iteration);
+  AppendValue<uint8_t>(record, testcase.GetTestResult(test_id));
+  AppendValue<int64_t>(record, testcase.GetTestTime(test_id));
+  AppendValue<uint16_t>(record, name.size());
+  record += name;
+  AppendValue<uint32_t>(record, output.size());
+  record += output;
+  AppendValue<uint32_t>(stream.buffer, record.size());
+  stream.buffer += record;
+  if (stream.buffer.size() >= RESULT_FILE_BUFFER_SIZE) {
+    FlushResultStream(stream);
+  }
+}
+
 static bool sigint_flag;
 static bool sigquit_flag;
 
+// Self-pipe written by the signal handlers, so that WaitChildProcs can wait
+// for the output of the child processes, their exit (SIGCHLD) and the
+// signals of the user together in poll(), without missing a signal that
+// arrives before poll() is called.
+static int signal_pipe_fds[2] = {-1, -1};
+
+static void WakeUpWaitChildProcs() {
+  if (signal_pipe_fds[1] != -1) {
+    int saved_errno = errno;
+    char byte = 0;
+    // The pipe is non-blocking, a full pipe already wakes up poll().
+    write(signal_pipe_fds[1], &byte, 1);
+    errno = saved_errno;
+  }
+}
+
 static void signal_handler(int sig) {
   if (sig == SIGINT) {
     sigint_flag = true;
   } else if (sig == SIGQUIT) {
     sigquit_flag = true;
   }
+  WakeUpWaitChildProcs();
 }
 
+static void sigchld_handler(int /*sig*/) { WakeUpWaitChildProcs(); }
+
 static bool RegisterSignalHandler() {
   sigint_flag = false;
   sigquit_flag = false;
+  if (pipe2(signal_pipe_fds, O_NONBLOCK | O_CLOEXEC) == -1) {
+    perror("RegisterSignalHandler");
+    return false;
+  }
   sig_t ret = signal(SIGINT, signal_handler);
   if (ret != SIG_ERR) {
     ret = signal(SIGQUIT, signal_handler);
@@ -592,6 +1031,13 @@ static bool RegisterSignalHandler() {
     perror("RegisterSignalHandler");
     return false;
   }
+  struct sigaction action = {};
+  action.sa_handler = sigchld_handler;
+  action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+  if (sigaction(SIGCHLD, &action, nullptr) == -1) {
+    perror("RegisterSignalHandler");
+    return false;
+  }
   return true;
 }
 
@@ -600,47 +1046,137 @@ static bool UnregisterSignalHandler() {
   if (ret != SIG_ERR) {
     ret = signal(SIGQUIT, SIG_DFL);
   }
+  if (ret != SIG_ERR) {
+    ret = signal(SIGCHLD, SIG_DFL);
+  }
   if (ret == SIG_ERR) {
     perror("UnregisterSignalHandler");
     return false;
   }
+  for (int& fd : signal_pipe_fds) {
+    if (fd != -1) {
+      close(fd);
+      fd = -1;
+    }
+  }
   return true;
 }
 
+// Each child process writes a marker line to its output when a test starts
+// and ends, so that the parent process can split the output of a child
+// process running several tests between them, and get the result of each
+// test. A marker line starts with TEST_MARKER_PREFIX, followed by
+// TEST_START_MARKER and the test name, or by TEST_END_MARKER, '0' if the
+// test passed or '1' if it failed, and the cumulative TestUsage of the child
+// process, see FormatTestUsage.
+static constexpr char TEST_MARKER_PREFIX = '\x1e';
+static constexpr char TEST_START_MARKER = 'S';
+static constexpr char TEST_END_MARKER = 'E';
+
+// Returns usage as a marker field, made of " " and its values separated by
+// ",".
+static std::string FormatTestUsage(const TestUsage& usage) {
+  char buf[200];
+  snprintf(buf, sizeof(buf),
+           " %" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64
+           ",%" PRId64 ",%" PRId64,
+           usage.user_time_us, usage.system_time_us, usage.max_rss_kb,
+           usage.minor_faults, usage.major_faults, usage.voluntary_switches,
+           usage.involuntary_switches);
+  return buf;
+}
+
+// Parses a marker field written by FormatTestUsage. Returns false if it's
+// invalid.
+static bool ParseTestUsage(const char* field, TestUsage* usage) {
+  return sscanf(field,
+                " %" SCNd64 ",%" SCNd64 ",%" SCNd64 ",%" SCNd64 ",%" SCNd64
+                ",%" SCNd64 ",%" SCNd64,
+                &usage->user_time_us, &usage->system_time_us,
+                &usage->max_rss_kb, &usage->minor_faults,
+                &usage->major_faults, &usage->voluntary_switches,
+                &usage->involuntary_switches) == 7;
+}
+
+class TestMarkerPrinter : public testing::EmptyTestEventListener {
+ public:
+  virtual void OnTestStart(const testing::TestInfo& test_info) {
+    WriteMarker(TEST_START_MARKER + std::string(test_info.test_case_name()) +
+                "." + test_info.name());
+  }
+  virtual void OnTestEnd(const testing::TestInfo& test_info) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == -1) {
+      perror("getrusage");
+      memset(&usage, 0, sizeof(usage));
+    }
+    WriteMarker(std::string(1, TEST_END_MARKER) +
+                (test_info.result()->Failed() ? "1" : "0") +
+                FormatTestUsage(GetTestUsage(usage)));
+  }
+
+ private:
+  static void WriteMarker(const std::string& marker) {
+    // Flush the output of the test first, as the marker bypasses stdio.
+    fflush(stdout);
+    fflush(stderr);
+    std::string line = TEST_MARKER_PREFIX + marker + "\n";
+    if (TEMP_FAILURE_RETRY(write(STDOUT_FILENO, line.data(), line.size())) ==
+        -1) {
+      perror("failed to write test marker");
+    }
+  }
+};
+
 struct ChildProcInfo {
   pid_t pid;
-  int64_t start_time_ns;
+  int64_t start_time_ns;  // The time when the current test started.
   int64_t end_time_ns;
   int64_t
       deadline_end_time_ns;  // The time when the test is thought of as timeout.
-  size_t testcase_id, test_id;
+  // The tests run by the child process, as [testcase_id, test_id].
+  std::vector<std::pair<size_t, size_t>> test_list;
+  std::vector<bool> test_ended;  // Whether each test in test_list has ended.
+  int running_test;     // Index in test_list of the running test, or -1.
+  int last_ended_test;  // Index in test_list of the last ended test, or -1.
+  // Output that is not part of a test, e.g. of the global test environment.
+  std::string unattributed_output;
+  // Output not parsed yet, which starts with an incomplete marker line.
+  std::string read_buffer;
+  // The cumulative usage of the child process at the end of its last ended
+  // test, and when it exited.
+  TestUsage last_ended_usage;
+  TestUsage exit_usage;
   bool finished;
   bool timed_out;
   int exit_status;
   int child_read_fd;  // File descriptor to read child test failure info.
+  bool child_read_eof;  // Whether all the output of the child was read.
 };
 
-// Forked Child process, run the single test.
-static void ChildProcessFn(int argc, char** argv,
-                           const std::string& test_name) {
-  char** new_argv = new char*[argc + 2];
-  memcpy(new_argv, argv, sizeof(char*) * argc);
-
-  char* filter_arg = new char[test_name.size() + 20];
-  strcpy(filter_arg, "--gtest_filter=");
-  strcat(filter_arg, test_name.c_str());
-  new_argv[argc] = filter_arg;
-  new_argv[argc + 1] = NULL;
-
-  int new_argc = argc + 1;
-  testing::InitGoogleTest(&new_argc, new_argv);
+// Forked Child process, run the tests matching filter. gtest was initialized
+// with the arguments of the test program by EnumerateTests.
+static void ChildProcessFn(const std::string& filter) {
+  testing::GTEST_FLAG(filter) = filter;
+  testing::UnitTest::GetInstance()->listeners().Append(new TestMarkerPrinter);
   int result = RUN_ALL_TESTS();
-  exit(result);
+  fflush(stdout);
+  fflush(stderr);
+  // _exit, so that the stdio streams inherited from the parent are not
+  // flushed again by the child.
+  _exit(result);
 }
 
-static ChildProcInfo RunChildProcess(const std::string& test_name,
-                                     int testcase_id, int test_id, int argc,
-                                     char** argv) {
+static ChildProcInfo RunChildProcess(
+    const std::vector<TestCase>& testcase_list,
+    const std::vector<std::pair<size_t, size_t>>& test_list) {
+  std::string filter;
+  for (const auto& test : test_list) {
+    if (!filter.empty()) {
+      filter += ":";
+    }
+    filter += testcase_list[test.first].GetTestName(test.second);
+  }
   int pipefd[2];
   if (pipe(pipefd) == -1) {
     perror("pipe in RunTestInSeparateProc");
@@ -650,12 +1186,14 @@ static ChildProcInfo RunChildProcess(const std::string& test_name,
     perror("fcntl in RunTestInSeparateProc");
     exit(1);
   }
+  // Output buffered by the parent must not be written again by the child.
+  fflush(NULL);
   pid_t pid = fork();
   if (pid == -1) {
     perror("fork in RunTestInSeparateProc");
     exit(1);
   } else if (pid == 0) {
-    // In child process, run a single test.
+    // In child process, run the tests.
     close(pipefd[0]);
     close(STDOUT_FILENO);
     close(STDERR_FILENO);
@@ -663,9 +1201,9 @@ static ChildProcInfo RunChildProcess(const std::string& test_name,
     dup2(pipefd[1], STDERR_FILENO);
 
     if (!UnregisterSignalHandler()) {
-      exit(1);
+      _exit(1);
     }
-    ChildProcessFn(argc, argv, test_name);
+    ChildProcessFn(filter);
     // Unreachable.
   }
   // In parent process, initialize child process info.
@@ -674,14 +1212,39 @@ static ChildProcInfo RunChildProcess(const std::string& test_name,
   child_proc.child_read_fd = pipefd[0];
   child_proc.pid = pid;
   child_proc.start_time_ns = NanoTime();
+  const auto& first_test = test_list.front();
   child_proc.deadline_end_time_ns =
-      child_proc.start_time_ns + GetDeadlineInfo(test_name) * 1000000LL;
-  child_proc.testcase_id = testcase_id;
-  child_proc.test_id = test_id;
+      child_proc.start_time_ns +
+      GetDeadlineInfo(testcase_list[first_test.first].GetTestName(
+          first_test.second)) *
+          1000000LL;
+  child_proc.test_list = test_list;
+  child_proc.test_ended.assign(test_list.size(), false);
+  child_proc.running_test = -1;
+  child_proc.last_ended_test = -1;
   child_proc.finished = false;
+  child_proc.child_read_eof = false;
   return child_proc;
 }
 
+// Returns the name of the running test of a child process, or of the next
+// test it runs.
+static std::string GetChildProcTestName(
+    const std::vector<TestCase>& testcase_list,
+    const ChildProcInfo& child_proc) {
+  int index = child_proc.running_test;
+  for (size_t i = 0; index == -1 && i < child_proc.test_list.size(); ++i) {
+    if (!child_proc.test_ended[i]) {
+      index = static_cast<int>(i);
+    }
+  }
+  if (index == -1) {
+    index = child_proc.last_ended_test;
+  }
+  const auto& test = child_proc.test_list[index];
+  return testcase_list[test.first].GetTestName(test.second);
+}
+
 static void HandleSignals(std::vector<TestCase>& testcase_list,
                           std::vector<ChildProcInfo>& child_proc_list) {
   if (sigquit_flag) {
@@ -691,8 +1254,7 @@ static void HandleSignals(std::vector<TestCase>& testcase_list,
     for (const auto& child_proc : child_proc_list) {
       if (child_proc.pid != 0) {
         std::string test_name =
-            testcase_list[child_proc.testcase_id].GetTestName(
-                child_proc.test_id);
+            GetChildProcTestName(testcase_list, child_proc);
         int64_t current_time_ns = NanoTime();
         int64_t run_time_ms =
             (current_time_ns - child_proc.start_time_ns) / 1000000;
@@ -715,12 +1277,14 @@ static void HandleSignals(std::vector<TestCase>& testcase_list,
 }
 
 static bool CheckChildProcExit(pid_t exit_pid, int exit_status,
+                               const struct rusage& exit_usage,
                                std::vector<ChildProcInfo>& child_proc_list) {
   for (size_t i = 0; i < child_proc_list.size(); ++i) {
     if (child_proc_list[i].pid == exit_pid) {
       child_proc_list[i].finished = true;
       child_proc_list[i].timed_out = false;
       child_proc_list[i].exit_status = exit_status;
+      child_proc_list[i].exit_usage = GetTestUsage(exit_usage);
       child_proc_list[i].end_time_ns = NanoTime();
       return true;
     }
@@ -743,29 +1307,127 @@ static size_t CheckChildProcTimeout(
   return timeout_child_count;
 }
 
+// Appends output of a child process to its running test.
+static void AppendChildProcOutput(std::vector<TestCase>& testcase_list,
+                                  ChildProcInfo& child_proc,
+                                  const std::string& output) {
+  if (child_proc.running_test == -1) {
+    child_proc.unattributed_output += output;
+    return;
+  }
+  const auto& test = child_proc.test_list[child_proc.running_test];
+  testcase_list[test.first].GetTest(test.second).AppendTestOutput(output);
+}
+
+// Handles a marker line written by TestMarkerPrinter, without the prefix.
+static void HandleTestMarker(std::vector<TestCase>& testcase_list,
+                             ChildProcInfo& child_proc,
+                             const std::string& marker) {
+  if (marker.empty()) {
+    return;
+  }
+  if (marker[0] == TEST_START_MARKER) {
+    std::string test_name = marker.substr(1);
+    for (size_t i = 0; i < child_proc.test_list.size(); ++i) {
+      const auto& test = child_proc.test_list[i];
+      TestCase& testcase = testcase_list[test.first];
+      if (!child_proc.test_ended[i] &&
+          testcase.GetTestName(test.second) == test_name) {
+        child_proc.running_test = static_cast<int>(i);
+        testcase.GetTest(test.second)
+            .AppendTestOutput(child_proc.unattributed_output);
+        child_proc.unattributed_output.clear();
+        child_proc.deadline_end_time_ns =
+            child_proc.start_time_ns + GetDeadlineInfo(test_name) * 1000000LL;
+        return;
+      }
+    }
+  } else if (marker[0] == TEST_END_MARKER && child_proc.running_test != -1) {
+    int64_t current_time_ns = NanoTime();
+    int index = child_proc.running_test;
+    const auto& test = child_proc.test_list[index];
+    TestCase& testcase = testcase_list[test.first];
+    testcase.SetTestResult(test.second,
+                           marker[1] == '0' ? TEST_SUCCESS : TEST_FAILED);
+    testcase.SetTestTime(test.second,
+                         current_time_ns - child_proc.start_time_ns);
+    TestUsage usage;
+    if (marker.size() > 2 && ParseTestUsage(marker.c_str() + 2, &usage)) {
+      testcase.SetTestUsage(
+          test.second, SubtractTestUsage(usage, child_proc.last_ended_usage));
+      child_proc.last_ended_usage = usage;
+    }
+    child_proc.test_ended[index] = true;
+    child_proc.last_ended_test = index;
+    child_proc.running_test = -1;
+    // The next test, including its test case setup, starts now.
+    child_proc.start_time_ns = current_time_ns;
+    child_proc.deadline_end_time_ns =
+        current_time_ns +
+        GetDeadlineInfo(GetChildProcTestName(testcase_list, child_proc)) *
+            1000000LL;
+  }
+}
+
+// Splits the output in the read buffer of a child process between its tests.
+static void ParseChildProcOutput(std::vector<TestCase>& testcase_list,
+                                 ChildProcInfo& child_proc) {
+  const std::string& buffer = child_proc.read_buffer;
+  size_t pos = 0;
+  while (pos < buffer.size()) {
+    size_t marker_pos = buffer.find(TEST_MARKER_PREFIX, pos);
+    if (marker_pos == std::string::npos) {
+      AppendChildProcOutput(testcase_list, child_proc, buffer.substr(pos));
+      pos = buffer.size();
+      break;
+    }
+    if (marker_pos > pos) {
+      AppendChildProcOutput(testcase_list, child_proc,
+                            buffer.substr(pos, marker_pos - pos));
+      pos = marker_pos;
+    }
+    size_t marker_end = buffer.find('\n', marker_pos);
+    if (marker_end == std::string::npos) {
+      break;  // Wait for the rest of the marker line.
+    }
+    std::string marker =
+        buffer.substr(marker_pos + 1, marker_end - marker_pos - 1);
+    HandleTestMarker(testcase_list, child_proc, marker);
+    pos = marker_end + 1;
+  }
+  child_proc.read_buffer.erase(0, pos);
+}
+
 static void ReadChildProcOutput(std::vector<TestCase>& testcase_list,
-                                std::vector<ChildProcInfo>& child_proc_list) {
-  for (const auto& child_proc : child_proc_list) {
-    TestCase& testcase = testcase_list[child_proc.testcase_id];
-    int test_id = child_proc.test_id;
-    while (true) {
-      char buf[1024];
-      ssize_t bytes_read = TEMP_FAILURE_RETRY(
-          read(child_proc.child_read_fd, buf, sizeof(buf) - 1));
-      if (bytes_read > 0) {
-        buf[bytes_read] = '\0';
-        testcase.GetTest(test_id).AppendTestOutput(buf);
-      } else if (bytes_read == 0) {
-        break;  // Read end.
-      } else {
-        if (errno == EAGAIN) {
-          break;
-        }
-        perror("failed to read child_read_fd");
-        exit(1);
+                                ChildProcInfo& child_proc) {
+  if (child_proc.child_read_eof) {
+    return;
+  }
+  while (true) {
+    char buf[1024];
+    ssize_t bytes_read = TEMP_FAILURE_RETRY(
+        read(child_proc.child_read_fd, buf, sizeof(buf)));
+    if (bytes_read > 0) {
+      child_proc.read_buffer.append(buf, bytes_read);
+    } else if (bytes_read == 0) {
+      child_proc.child_read_eof = true;
+      break;  // Read end.
+    } else {
+      if (errno == EAGAIN) {
+        break;
       }
+      perror("failed to read child_read_fd");
+      exit(1);
     }
   }
+  ParseChildProcOutput(testcase_list, child_proc);
+}
+
+static void ReadChildProcOutput(std::vector<TestCase>& testcase_list,
+                                std::vector<ChildProcInfo>& child_proc_list) {
+  for (auto& child_proc : child_proc_list) {
+    ReadChildProcOutput(testcase_list, child_proc);
+  }
 }
 
 static void WaitChildProcs(std::vector<TestCase>& testcase_list,
@@ -773,9 +1435,11 @@ static void WaitChildProcs(std::vector<TestCase>& testcase_list,
   size_t finished_child_count = 0;
   while (true) {
     int status;
+    struct rusage usage;
     pid_t result;
-    while ((result = TEMP_FAILURE_RETRY(waitpid(-1, &status, WNOHANG))) > 0) {
-      if (CheckChildProcExit(result, status, child_proc_list)) {
+    while ((result = TEMP_FAILURE_RETRY(wait4(-1, &status, WNOHANG, &usage))) >
+           0) {
+      if (CheckChildProcExit(result, status, usage, child_proc_list)) {
         ++finished_child_count;
       }
     }
@@ -799,17 +1463,43 @@ static void WaitChildProcs(std::vector<TestCase>& testcase_list,
 
     HandleSignals(testcase_list, child_proc_list);
 
-    // sleep 1 ms to avoid busy looping.
-    timespec sleep_time;
-    sleep_time.tv_sec = 0;
-    sleep_time.tv_nsec = 1000000;
-    nanosleep(&sleep_time, NULL);
+    // Wait for the output of a child, a signal, including the SIGCHLD of a
+    // child that exits, or the nearest deadline of a child.
+    std::vector<pollfd> poll_fds;
+    poll_fds.push_back({signal_pipe_fds[0], POLLIN, 0});
+    int64_t nearest_deadline_ns = INT64_MAX;
+    for (const auto& child_proc : child_proc_list) {
+      if (!child_proc.child_read_eof) {
+        poll_fds.push_back({child_proc.child_read_fd, POLLIN, 0});
+      }
+      nearest_deadline_ns =
+          std::min(nearest_deadline_ns, child_proc.deadline_end_time_ns);
+    }
+    int timeout_ms = -1;
+    if (nearest_deadline_ns != INT64_MAX) {
+      int64_t wait_ns = std::max<int64_t>(nearest_deadline_ns - NanoTime(), 0);
+      // Rounded up, so that the deadline has passed when poll() times out.
+      timeout_ms = static_cast<int>(
+          std::min<int64_t>((wait_ns + 999999) / 1000000, INT_MAX));
+    }
+    if (poll(poll_fds.data(), poll_fds.size(), timeout_ms) == -1 &&
+        errno != EINTR) {
+      perror("poll");
+      exit(1);
+    }
+    char buf[64];
+    while (read(signal_pipe_fds[0], buf, sizeof(buf)) > 0) {
+    }
   }
 }
 
-static TestResult WaitForOneChild(pid_t pid) {
+static TestResult WaitForOneChild(pid_t pid, TestUsage* exit_usage) {
   int exit_status;
-  pid_t result = TEMP_FAILURE_RETRY(waitpid(pid, &exit_status, 0));
+  struct rusage usage;
+  pid_t result = TEMP_FAILURE_RETRY(wait4(pid, &exit_status, 0, &usage));
+  if (result == pid) {
+    *exit_usage = GetTestUsage(usage);
+  }
 
   TestResult test_result = TEST_SUCCESS;
   if (result != pid || WEXITSTATUS(exit_status) != 0) {
@@ -818,18 +1508,86 @@ static TestResult WaitForOneChild(pid_t pid) {
   return test_result;
 }
 
-static void CollectChildTestResult(const ChildProcInfo& child_proc,
-                                   TestCase& testcase) {
-  int test_id = child_proc.test_id;
-  testcase.SetTestTime(test_id,
-                       child_proc.end_time_ns - child_proc.start_time_ns);
+// Collects the results of the tests run by a finished child process, and
+// returns the tests that got a result, as [testcase_id, test_id]. The exit
+// status of the child process is the result of its running test; of the
+// first test it didn't start, e.g. if the global test environment crashed;
+// or of its last test if it exited abnormally after all its tests. The
+// other tests it didn't start are added to retry_test_list.
+static std::vector<std::pair<size_t, size_t>> CollectChildTestResults(
+    ChildProcInfo& child_proc, std::vector<TestCase>& testcase_list,
+    std::deque<std::pair<size_t, size_t>>& retry_test_list) {
   if (child_proc.timed_out) {
     // The child process marked as timed_out has not exited, and we should kill
     // it manually.
     kill(child_proc.pid, SIGKILL);
-    WaitForOneChild(child_proc.pid);
+    WaitForOneChild(child_proc.pid, &child_proc.exit_usage);
   }
+  // The output the child process wrote before it exited.
+  ReadChildProcOutput(testcase_list, child_proc);
   close(child_proc.child_read_fd);
+  // Output left after an incomplete marker line.
+  AppendChildProcOutput(testcase_list, child_proc, child_proc.read_buffer);
+  child_proc.read_buffer.clear();
+
+  bool child_failed = child_proc.timed_out ||
+                      WIFSIGNALED(child_proc.exit_status) ||
+                      WEXITSTATUS(child_proc.exit_status) != 0;
+  int failed_test = child_proc.running_test;
+  for (size_t i = 0; failed_test == -1 && i < child_proc.test_list.size();
+       ++i) {
+    if (!child_proc.test_ended[i]) {
+      failed_test = static_cast<int>(i);
+    }
+  }
+  // gtest exits with 1 when a test failed, which doesn't need to be blamed
+  // on another test.
+  bool exit_status_explained = false;
+  if (!child_proc.timed_out && WIFEXITED(child_proc.exit_status) &&
+      WEXITSTATUS(child_proc.exit_status) == 1) {
+    for (size_t i = 0; i < child_proc.test_list.size(); ++i) {
+      const auto& test = child_proc.test_list[i];
+      if (child_proc.test_ended[i] &&
+          testcase_list[test.first].GetTestResult(test.second) !=
+              TEST_SUCCESS) {
+        exit_status_explained = true;
+      }
+    }
+  }
+  if (failed_test == -1 && child_failed && !exit_status_explained) {
+    failed_test = child_proc.last_ended_test;
+  }
+
+  std::vector<std::pair<size_t, size_t>> result_list;
+  for (size_t i = 0; i < child_proc.test_list.size(); ++i) {
+    if (static_cast<int>(i) == failed_test) {
+      continue;
+    } else if (child_proc.test_ended[i]) {
+      result_list.push_back(child_proc.test_list[i]);
+    } else {
+      retry_test_list.push_back(child_proc.test_list[i]);
+    }
+  }
+  if (failed_test == -1) {
+    return result_list;
+  }
+  result_list.push_back(child_proc.test_list[failed_test]);
+
+  TestCase& testcase = testcase_list[child_proc.test_list[failed_test].first];
+  size_t test_id = child_proc.test_list[failed_test].second;
+  bool ended = child_proc.test_ended[failed_test];
+  bool started = ended || failed_test == child_proc.running_test;
+  testcase.GetTest(test_id).AppendTestOutput(child_proc.unattributed_output);
+  if (!ended) {
+    // The output of the child process may be read after it exited.
+    testcase.SetTestTime(test_id,
+                         std::max<int64_t>(
+                             child_proc.end_time_ns - child_proc.start_time_ns,
+                             0));
+    testcase.SetTestUsage(test_id,
+                          SubtractTestUsage(child_proc.exit_usage,
+                                            child_proc.last_ended_usage));
+  }
 
   if (child_proc.timed_out) {
     testcase.SetTestResult(test_id, TEST_TIMEOUT);
@@ -838,7 +1596,7 @@ static void CollectChildTestResult(const ChildProcInfo& child_proc,
              "%s killed because of timeout at %" PRId64 " ms.\n",
              testcase.GetTestName(test_id).c_str(),
              testcase.GetTestTime(test_id) / 1000000);
-    testcase.GetTest(test_id).AppendTestOutput(buf);
+    testcase.GetTest(test_id).AppendTestMessage(buf);
 
   } else if (WIFSIGNALED(child_proc.exit_status)) {
     // Record signal terminated test as failed.
@@ -847,7 +1605,14 @@ static void CollectChildTestResult(const ChildProcInfo& child_proc,
     snprintf(buf, sizeof(buf), "%s terminated by signal: %s.\n",
              testcase.GetTestName(test_id).c_str(),
              strsignal(WTERMSIG(child_proc.exit_status)));
-    testcase.GetTest(test_id).AppendTestOutput(buf);
+    testcase.GetTest(test_id).AppendTestMessage(buf);
+
+  } else if (!started && !child_failed) {
+    testcase.SetTestResult(test_id, TEST_FAILED);
+    char buf[1024];
+    snprintf(buf, sizeof(buf), "%s was not run by the test process.\n",
+             testcase.GetTestName(test_id).c_str());
+    testcase.GetTest(test_id).AppendTestMessage(buf);
 
   } else {
     int exitcode = WEXITSTATUS(child_proc.exit_status);
@@ -856,19 +1621,190 @@ static void CollectChildTestResult(const ChildProcInfo& child_proc,
       char buf[1024];
       snprintf(buf, sizeof(buf), "%s exited with exitcode %d.\n",
                testcase.GetTestName(test_id).c_str(), exitcode);
-      testcase.GetTest(test_id).AppendTestOutput(buf);
+      testcase.GetTest(test_id).AppendTestMessage(buf);
+    }
+  }
+  return result_list;
+}
+
+// Reads test_duration_history_ms from a timing database file, made of lines
+// of "<test name> <duration in ms>". A missing file is an empty database.
+static bool LoadTestTimingDb(const std::string& timing_db_filename) {
+  FILE* fp = fopen(timing_db_filename.c_str(), "r");
+  if (fp == NULL) {
+    if (errno == ENOENT) {
+      return true;
+    }
+    fprintf(stderr, "failed to open '%s': %s\n", timing_db_filename.c_str(),
+            strerror(errno));
+    return false;
+  }
+  char* line = NULL;
+  size_t line_size = 0;
+  while (getline(&line, &line_size, fp) != -1) {
+    char* separator = strchr(line, ' ');
+    if (separator == NULL) {
+      continue;
+    }
+    *separator = '\0';
+    test_duration_history_ms[line] = strtoll(separator + 1, NULL, 10);
+  }
+  free(line);
+  fclose(fp);
+  return true;
+}
+
+// Records the durations of the tests that passed in the last iteration in
+// test_duration_history_ms, and writes it to the timing database file. The
+// duration of a failed or timed out test isn't that of a normal run, so the
+// previous one is kept.
+static void SaveTestTimingDb(const std::string& timing_db_filename,
+                             const std::vector<TestCase>& testcase_list) {
+  for (const auto& testcase : testcase_list) {
+    for (size_t i = 0; i < testcase.TestCount(); ++i) {
+      if (testcase.GetTestResult(i) != TEST_SUCCESS) {
+        continue;
+      }
+      test_duration_history_ms[testcase.GetTestName(i)] =
+          testcase.GetTestTime(i) / 1000000;
     }
   }
+  // Write to a temporary file first, so that an interrupted run doesn't
+  // leave a truncated database.
+  std::string tmp_filename = timing_db_filename + ".tmp";
+  FILE* fp = fopen(tmp_filename.c_str(), "w");
+  if (fp == NULL) {
+    fprintf(stderr, "failed to open '%s': %s\n", tmp_filename.c_str(),
+            strerror(errno));
+    return;
+  }
+  for (const auto& entry : test_duration_history_ms) {
+    fprintf(fp, "%s %" PRId64 "\n", entry.first.c_str(), entry.second);
+  }
+  if (fclose(fp) != 0 ||
+      rename(tmp_filename.c_str(), timing_db_filename.c_str()) != 0) {
+    fprintf(stderr, "failed to write '%s': %s\n", timing_db_filename.c_str(),
+            strerror(errno));
+  }
+}
+
+// Returns the tests in the order to run them: the longest first according
+// to test_duration_history_ms, so that a long test doesn't start last and
+// delay the end of the iteration. The tests without a duration come first,
+// in list order.
+static std::vector<std::pair<size_t, size_t>> GetTestRunOrder(
+    const std::vector<TestCase>& testcase_list) {
+  std::vector<std::pair<int64_t, std::pair<size_t, size_t>>> duration_list;
+  for (size_t i = 0; i < testcase_list.size(); ++i) {
+    for (size_t j = 0; j < testcase_list[i].TestCount(); ++j) {
+      auto it =
+          test_duration_history_ms.find(testcase_list[i].GetTestName(j));
+      int64_t duration_ms =
+          it == test_duration_history_ms.end() ? INT64_MAX : it->second;
+      duration_list.push_back(
+          std::make_pair(duration_ms, std::make_pair(i, j)));
+    }
+  }
+  std::stable_sort(
+      duration_list.begin(), duration_list.end(),
+      [](const std::pair<int64_t, std::pair<size_t, size_t>>& a,
+         const std::pair<int64_t, std::pair<size_t, size_t>>& b) {
+        return a.first > b.first;
+      });
+  std::vector<std::pair<size_t, size_t>> test_order;
+  for (const auto& entry : duration_list) {
+    test_order.push_back(entry.second);
+  }
+  return test_order;
+}
+
+// Keeps only the tests of shard global_shard_index in testcase_list. The
+// tests are spread over the shards by decreasing duration in
+// test_duration_history_ms, each to the shard with the least total duration,
+// so that the shards take about the same time. The tests without a duration
+// count as the mean duration, or all the same when there is none, which
+// spreads them in turn. Ties go to the lowest shard, so that each process
+// computes the same shards from the same tests and timing database.
+static void SelectShardTests(std::vector<TestCase>& testcase_list) {
+  int64_t total_history_ms = 0;
+  size_t history_count = 0;
+  for (const auto& testcase : testcase_list) {
+    for (size_t j = 0; j < testcase.TestCount(); ++j) {
+      auto it = test_duration_history_ms.find(testcase.GetTestName(j));
+      if (it != test_duration_history_ms.end()) {
+        total_history_ms += it->second;
+        ++history_count;
+      }
+    }
+  }
+  int64_t default_duration_ms =
+      history_count == 0
+          ? 1
+          : std::max<int64_t>(total_history_ms / history_count, 1);
+
+  std::vector<std::pair<int64_t, std::pair<size_t, size_t>>> duration_list;
+  for (size_t i = 0; i < testcase_list.size(); ++i) {
+    for (size_t j = 0; j < testcase_list[i].TestCount(); ++j) {
+      auto it =
+          test_duration_history_ms.find(testcase_list[i].GetTestName(j));
+      int64_t duration_ms = it == test_duration_history_ms.end()
+                                ? default_duration_ms
+                                : std::max<int64_t>(it->second, 1);
+      duration_list.push_back(
+          std::make_pair(duration_ms, std::make_pair(i, j)));
+    }
+  }
+  std::stable_sort(
+      duration_list.begin(), duration_list.end(),
+      [](const std::pair<int64_t, std::pair<size_t, size_t>>& a,
+         const std::pair<int64_t, std::pair<size_t, size_t>>& b) {
+        return a.first > b.first;
+      });
+
+  std::vector<int64_t> shard_duration_list(global_shard_count, 0);
+  std::vector<std::vector<bool>> selected_list(testcase_list.size());
+  for (size_t i = 0; i < testcase_list.size(); ++i) {
+    selected_list[i].resize(testcase_list[i].TestCount(), false);
+  }
+  for (const auto& entry : duration_list) {
+    size_t shard = std::min_element(shard_duration_list.begin(),
+                                    shard_duration_list.end()) -
+                   shard_duration_list.begin();
+    shard_duration_list[shard] += entry.first;
+    if (shard == global_shard_index) {
+      selected_list[entry.second.first][entry.second.second] = true;
+    }
+  }
+
+  std::vector<TestCase> shard_testcase_list;
+  for (size_t i = 0; i < testcase_list.size(); ++i) {
+    bool testcase_added = false;
+    for (size_t j = 0; j < testcase_list[i].TestCount(); ++j) {
+      if (!selected_list[i][j]) {
+        continue;
+      }
+      if (!testcase_added) {
+        shard_testcase_list.push_back(
+            TestCase(testcase_list[i].GetName().c_str()));
+        testcase_added = true;
+      }
+      shard_testcase_list.back().AppendTest(
+          testcase_list[i].GetTest(j).GetName().c_str());
+    }
+  }
+  testcase_list.swap(shard_testcase_list);
 }
 
 // We choose to use multi-fork and multi-wait here instead of multi-thread,
 // because it always
 // makes deadlock to use fork in multi-thread.
 // Returns true if all tests run successfully, otherwise return false.
-static bool RunTestInSeparateProc(int argc, char** argv,
-                                  std::vector<TestCase>& testcase_list,
+static bool RunTestInSeparateProc(std::vector<TestCase>& testcase_list,
                                   int iteration_count, size_t job_count,
-                                  const std::string& xml_output_filename) {
+                                  size_t tests_per_proc,
+                                  const std::string& xml_output_filename,
+                                  const std::string& timing_db_filename,
+                                  const std::string& result_stream_filename) {
   // Stop default result printer to avoid environment setup/teardown information
   // for each test.
   testing::UnitTest::GetInstance()->listeners().Release(
@@ -879,21 +1815,47 @@ static bool RunTestInSeparateProc(int argc, char** argv,
     exit(1);
   }
 
+  ResultStream result_stream;
+  result_stream.fd = -1;
+  if (!result_stream_filename.empty()) {
+    result_stream.fd =
+        open(result_stream_filename.c_str(),
+             O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (result_stream.fd == -1) {
+      fprintf(stderr, "failed to open '%s': %s\n",
+              result_stream_filename.c_str(), strerror(errno));
+      exit(1);
+    }
+    result_stream.buffer.reserve(RESULT_FILE_BUFFER_SIZE);
+  }
+
   bool all_tests_passed = true;
 
   for (size_t iteration = 1;
        iteration_count < 0 || iteration <= static_cast<size_t>(iteration_count);
        ++iteration) {
     OnTestIterationStartPrint(testcase_list, iteration, iteration_count);
+    for (auto& testcase : testcase_list) {
+      for (size_t i = 0; i < testcase.TestCount(); ++i) {
+        testcase.GetTest(i).ClearTestOutput();
+      }
+    }
     int64_t iteration_start_time_ns = NanoTime();
     time_t epoch_iteration_start_time = time(NULL);
 
-    // Run up to job_count tests in parallel, each test in a child process.
+    // Run up to job_count child processes in parallel, each running up to
+    // tests_per_proc tests.
     std::vector<ChildProcInfo> child_proc_list;
 
-    // Next test to run is [next_testcase_id:next_test_id].
-    size_t next_testcase_id = 0;
-    size_t next_test_id = 0;
+    // Next test to run is test_order[next_test_index].
+    std::vector<std::pair<size_t, size_t>> test_order =
+        GetTestRunOrder(testcase_list);
+    size_t next_test_index = 0;
+
+    // Tests to run in a new child process, as the child process that should
+    // have run them crashed or timed out first. They run before the next test.
+    std::deque<std::pair<size_t, size_t>> retry_test_list;
+    size_t unscheduled_test_count = test_order.size();
 
     // Record how many tests are finished.
     std::vector<size_t> finished_test_count_list(testcase_list.size(), 0);
@@ -901,17 +1863,23 @@ static bool RunTestInSeparateProc(int argc, char** argv,
 
     while (finished_testcase_count < testcase_list.size()) {
       // run up to job_count child processes.
-      while (child_proc_list.size() < job_count &&
-             next_testcase_id < testcase_list.size()) {
-        std::string test_name =
-            testcase_list[next_testcase_id].GetTestName(next_test_id);
-        ChildProcInfo child_proc = RunChildProcess(test_name, next_testcase_id,
-                                                   next_test_id, argc, argv);
-        child_proc_list.push_back(child_proc);
-        if (++next_test_id == testcase_list[next_testcase_id].TestCount()) {
-          next_test_id = 0;
-          ++next_testcase_id;
+      while (child_proc_list.size() < job_count && unscheduled_test_count > 0) {
+        // Spread the remaining tests over the jobs.
+        size_t batch_size = std::min(
+            tests_per_proc,
+            std::max<size_t>(1, unscheduled_test_count / job_count));
+        std::vector<std::pair<size_t, size_t>> test_list;
+        while (test_list.size() < batch_size) {
+          if (!retry_test_list.empty()) {
+            test_list.push_back(retry_test_list.front());
+            retry_test_list.pop_front();
+          } else {
+            test_list.push_back(test_order[next_test_index++]);
+          }
+          --unscheduled_test_count;
         }
+        child_proc_list.push_back(
+            RunChildProcess(testcase_list, test_list));
       }
 
       // Wait for any child proc finish or timeout.
@@ -922,18 +1890,40 @@ static bool RunTestInSeparateProc(int argc, char** argv,
       while (it != child_proc_list.end()) {
         auto& child_proc = *it;
         if (child_proc.finished == true) {
-          size_t testcase_id = child_proc.testcase_id;
-          size_t test_id = child_proc.test_id;
-          TestCase& testcase = testcase_list[testcase_id];
-
-          CollectChildTestResult(child_proc, testcase);
-          OnTestEndPrint(testcase, test_id);
-
-          if (++finished_test_count_list[testcase_id] == testcase.TestCount()) {
-            ++finished_testcase_count;
-          }
-          if (testcase.GetTestResult(test_id) != TEST_SUCCESS) {
-            all_tests_passed = false;
+          size_t retry_test_count = retry_test_list.size();
+          auto result_list = CollectChildTestResults(child_proc, testcase_list,
+                                                     retry_test_list);
+          unscheduled_test_count += retry_test_list.size() - retry_test_count;
+          for (const auto& test : result_list) {
+            size_t testcase_id = test.first;
+            size_t test_id = test.second;
+            TestCase& testcase = testcase_list[testcase_id];
+            if (global_fail_over_resource_limits) {
+              std::string exceeded =
+                  GetExceededResourceLimits(testcase.GetTestUsage(test_id));
+              if (!exceeded.empty()) {
+                testcase.SetTestResult(test_id, TEST_FAILED);
+                testcase.GetTest(test_id).AppendTestMessage(
+                    testcase.GetTestName(test_id) + " used too much: " +
+                    exceeded + ".\n");
+              }
+            }
+            OnTestEndPrint(testcase, test_id);
+            if (result_stream.fd != -1) {
+              WriteResultStreamRecord(result_stream, iteration, testcase,
+                                      test_id);
+            }
+
+            if (++finished_test_count_list[testcase_id] ==
+                testcase.TestCount()) {
+              ++finished_testcase_count;
+            }
+            if (testcase.GetTestResult(test_id) != TEST_SUCCESS) {
+              all_tests_passed = false;
+            } else {
+              // Only the output of the failed tests is in the xml file.
+              testcase.GetTest(test_id).ClearTestOutput();
+            }
           }
 
           it = child_proc_list.erase(it);
@@ -945,6 +1935,14 @@ static bool RunTestInSeparateProc(int argc, char** argv,
 
     int64_t elapsed_time_ns = NanoTime() - iteration_start_time_ns;
     OnTestIterationEndPrint(testcase_list, iteration, elapsed_time_ns);
+    // Each shard must compute its tests from the same database, so the
+    // shards only read it.
+    if (!timing_db_filename.empty() && global_shard_count == 1) {
+      SaveTestTimingDb(timing_db_filename, testcase_list);
+    }
+    if (result_stream.fd != -1) {
+      FlushResultStream(result_stream);
+    }
     if (!xml_output_filename.empty()) {
       OnTestIterationEndXmlPrint(xml_output_filename, testcase_list,
                                  epoch_iteration_start_time, elapsed_time_ns);
@@ -955,6 +1953,9 @@ static bool RunTestInSeparateProc(int argc, char** argv,
     exit(1);
   }
 
+  if (result_stream.fd != -1) {
+    close(result_stream.fd);
+  }
   return all_tests_passed;
 }
 
@@ -998,12 +1999,36 @@ struct IsolationTestOptions {
   size_t job_count;
   int test_deadline_ms;
   int test_warnline_ms;
+  size_t tests_per_proc;
   std::string gtest_color;
   bool gtest_print_time;
   int gtest_repeat;
   std::string gtest_output;
+  std::string timing_db;
+  size_t max_test_output_bytes;
+  std::string result_stream;
+  size_t shard_index;
+  size_t shard_count;
+  int64_t max_test_cpu_time_ms;
+  int64_t max_test_rss_kb;
+  bool fail_over_resource_limits;
 };
 
+// Reads a non negative integer from the environment variable name, or
+// returns default_value if it isn't set. Returns -1 if it's invalid.
+static long long GetEnvCount(const char* name, long long default_value) {
+  const char* value = getenv(name);
+  if (value == NULL) {
+    return default_value;
+  }
+  char* end;
+  long long count = strtoll(value, &end, 10);
+  if (*value == '\0' || *end != '\0' || count < 0) {
+    return -1;
+  }
+  return count;
+}
+
 // Pick options not for gtest: There are two parts in args, one part is used in
 // isolation test mode
 // as described in PrintHelpInfo(), the other part is handled by
@@ -1083,11 +2108,31 @@ static bool PickOptions(std::vector<char*>& args,
   options.job_count = GetDefaultJobCount();
   options.test_deadline_ms = DEFAULT_GLOBAL_TEST_RUN_DEADLINE_MS;
   options.test_warnline_ms = DEFAULT_GLOBAL_TEST_RUN_WARNLINE_MS;
+  options.tests_per_proc = 1;
+  options.max_test_output_bytes = DEFAULT_GLOBAL_MAX_TEST_OUTPUT_BYTES;
+  options.max_test_cpu_time_ms = 0;
+  options.max_test_rss_kb = 0;
+  options.fail_over_resource_limits = false;
   options.gtest_color = testing::GTEST_FLAG(color);
   options.gtest_print_time = testing::GTEST_FLAG(print_time);
   options.gtest_repeat = testing::GTEST_FLAG(repeat);
   options.gtest_output = testing::GTEST_FLAG(output);
 
+  // The sharding environment variables of gtest. They are removed, so that
+  // the child processes run all the tests they are given.
+  long long shard_index = GetEnvCount("GTEST_SHARD_INDEX", 0);
+  long long shard_count = GetEnvCount("GTEST_TOTAL_SHARDS", 1);
+  unsetenv("GTEST_SHARD_INDEX");
+  unsetenv("GTEST_TOTAL_SHARDS");
+  if (getenv("GTEST_SHARD_STATUS_FILE") != NULL) {
+    // Tell the test driver that sharding is supported, as gtest does.
+    FILE* fp = fopen(getenv("GTEST_SHARD_STATUS_FILE"), "w");
+    if (fp != NULL) {
+      fclose(fp);
+    }
+    unsetenv("GTEST_SHARD_STATUS_FILE");
+  }
+
   // Parse arguments speficied for isolation mode.
   for (size_t i = 1; i < args.size(); ++i) {
     if (strncmp(args[i], "-j", strlen("-j")) == 0) {
@@ -1120,6 +2165,60 @@ static bool PickOptions(std::vector<char*>& args,
         return false;
       }
       options.test_warnline_ms = time_ms;
+    } else if (strncmp(args[i], "--tests-per-proc=",
+                       strlen("--tests-per-proc=")) == 0) {
+      int count = atoi(args[i] + strlen("--tests-per-proc="));
+      if (count <= 0) {
+        fprintf(stderr, "invalid tests per proc: %d\n", count);
+        return false;
+      }
+      options.tests_per_proc = static_cast<size_t>(count);
+    } else if (strncmp(args[i], "--max-test-output=",
+                       strlen("--max-test-output=")) == 0) {
+      long long bytes = atoll(args[i] + strlen("--max-test-output="));
+      if (bytes < 0) {
+        fprintf(stderr, "invalid max test output: %lld\n", bytes);
+        return false;
+      }
+      options.max_test_output_bytes = static_cast<size_t>(bytes);
+    } else if (strncmp(args[i], "--result-stream=",
+                       strlen("--result-stream=")) == 0) {
+      options.result_stream = args[i] + strlen("--result-stream=");
+      if (options.result_stream.empty()) {
+        fprintf(stderr, "invalid result stream file: %s\n", args[i]);
+        return false;
+      }
+    } else if (strncmp(args[i], "--timing-db=", strlen("--timing-db=")) ==
+               0) {
+      options.timing_db = args[i] + strlen("--timing-db=");
+      if (options.timing_db.empty()) {
+        fprintf(stderr, "invalid timing db file: %s\n", args[i]);
+        return false;
+      }
+    } else if (strncmp(args[i], "--max-test-cpu-time=",
+                       strlen("--max-test-cpu-time=")) == 0) {
+      long long time_ms = atoll(args[i] + strlen("--max-test-cpu-time="));
+      if (time_ms <= 0) {
+        fprintf(stderr, "invalid max test cpu time: %lld\n", time_ms);
+        return false;
+      }
+      options.max_test_cpu_time_ms = time_ms;
+    } else if (strncmp(args[i], "--max-test-rss=", strlen("--max-test-rss=")) ==
+               0) {
+      long long rss_kb = atoll(args[i] + strlen("--max-test-rss="));
+      if (rss_kb <= 0) {
+        fprintf(stderr, "invalid max test rss: %lld\n", rss_kb);
+        return false;
+      }
+      options.max_test_rss_kb = rss_kb;
+    } else if (strcmp(args[i], "--fail-over-resource-limits") == 0) {
+      options.fail_over_resource_limits = true;
+    } else if (strncmp(args[i], "--shard-index=", strlen("--shard-index=")) ==
+               0) {
+      shard_index = atoll(args[i] + strlen("--shard-index="));
+    } else if (strncmp(args[i], "--shard-count=", strlen("--shard-count=")) ==
+               0) {
+      shard_count = atoll(args[i] + strlen("--shard-count="));
     } else if (strncmp(args[i], "--gtest_color=", strlen("--gtest_color=")) ==
                0) {
       options.gtest_color = args[i] + strlen("--gtest_color=");
@@ -1173,6 +2272,14 @@ static bool PickOptions(std::vector<char*>& args,
     }
   }
 
+  if (shard_count <= 0 || shard_index < 0 || shard_index >= shard_count) {
+    fprintf(stderr, "invalid shard index %lld of shard count %lld\n",
+            shard_index, shard_count);
+    return false;
+  }
+  options.shard_index = static_cast<size_t>(shard_index);
+  options.shard_count = static_cast<size_t>(shard_count);
+
   // Add --no-isolate in args to prevent child process from running in isolation
   // mode again.
   // As DeathTest will try to call execve(), this argument should always be
@@ -1196,6 +2303,12 @@ int main(int argc, char** argv) {
     // Set global variables.
     global_test_run_deadline_ms = options.test_deadline_ms;
     global_test_run_warnline_ms = options.test_warnline_ms;
+    global_max_test_output_bytes = options.max_test_output_bytes;
+    global_shard_index = options.shard_index;
+    global_shard_count = options.shard_count;
+    global_max_test_cpu_time_ms = options.max_test_cpu_time_ms;
+    global_max_test_rss_kb = options.max_test_rss_kb;
+    global_fail_over_resource_limits = options.fail_over_resource_limits;
     testing::GTEST_FLAG(color) = options.gtest_color.c_str();
     testing::GTEST_FLAG(print_time) = options.gtest_print_time;
     std::vector<TestCase> testcase_list;
@@ -1205,9 +2318,17 @@ int main(int argc, char** argv) {
     if (EnumerateTests(argc, arg_list.data(), testcase_list) == false) {
       return 1;
     }
+    if (!options.timing_db.empty() &&
+        !LoadTestTimingDb(options.timing_db)) {
+      return 1;
+    }
+    if (global_shard_count > 1) {
+      SelectShardTests(testcase_list);
+    }
     bool all_test_passed = RunTestInSeparateProc(
-        argc, arg_list.data(), testcase_list, options.gtest_repeat,
-        options.job_count, options.gtest_output);
+        testcase_list, options.gtest_repeat, options.job_count,
+        options.tests_per_proc, options.gtest_output, options.timing_db,
+        options.result_stream);
     return all_test_passed ? 0 : 1;
   } else {
     argc = static_cast<int>(arg_list.size());
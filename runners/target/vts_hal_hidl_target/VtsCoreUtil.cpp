@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <ctype.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <log/log.h>
@@ -53,10 +55,124 @@ bool checkSubstringInCommandOutput(const char* cmd, const char* feature) {
   return hasFeature;
 }
 
-// Runs "pm list features" and attempts to find the specified feature in its
-// output.
+static constexpr const char* kListFeaturesCommand =
+    "/system/bin/pm list features";
+static constexpr const char* kFeaturePrefix = "feature:";
+// The list of features of the current boot is cached in this dir, named
+// after the boot id.
+static constexpr const char* kFeatureCacheDir = "/data/local/tmp";
+
+// Adds the features listed in input, one per line, with or without the
+// "feature:" prefix, to features.
+static void readFeatures(FILE* input,
+                         std::unordered_set<std::string>* features) {
+  char* line = NULL;
+  size_t len = 0;
+  ssize_t read;
+  while ((read = getline(&line, &len, input)) > 0) {
+    std::string feature(line, read);
+    while (!feature.empty() && isspace(feature.back())) {
+      feature.pop_back();
+    }
+    if (feature.compare(0, strlen(kFeaturePrefix), kFeaturePrefix) == 0) {
+      feature.erase(0, strlen(kFeaturePrefix));
+    }
+    if (feature.empty()) {
+      continue;
+    }
+    size_t version = feature.find('=');
+    if (version != std::string::npos) {
+      features->insert(feature.substr(0, version));
+    }
+    features->insert(feature);
+  }
+  free(line);
+}
+
+// Returns the path of the cache of the features of the current boot, or an
+// empty string if the boot id can't be read.
+static std::string getFeatureCachePath() {
+  FILE* boot_id_file = fopen("/proc/sys/kernel/random/boot_id", "re");
+  if (!boot_id_file) {
+    return "";
+  }
+  char boot_id[64] = {};
+  bool read = fgets(boot_id, sizeof(boot_id), boot_id_file) != NULL;
+  fclose(boot_id_file);
+  if (!read) {
+    return "";
+  }
+  boot_id[strcspn(boot_id, "\n")] = '\0';
+  return std::string(kFeatureCacheDir) + "/vts_device_features_" + boot_id;
+}
+
+// Runs "pm list features" and returns the features it lists, unless they are
+// cached for the current boot already.
+static std::unordered_set<std::string> loadDeviceFeatures() {
+  std::unordered_set<std::string> features;
+  std::string cache_path = getFeatureCachePath();
+  if (!cache_path.empty()) {
+    FILE* cache = fopen(cache_path.c_str(), "re");
+    if (cache) {
+      readFeatures(cache, &features);
+      fclose(cache);
+      return features;
+    }
+  }
+  // This is one of the best stable native interface. Calling AIDL directly
+  // would be problematic if the binder interface changes.
+  FILE* p = popen(kListFeaturesCommand, "re");
+  if (!p) {
+    __android_log_print(ANDROID_LOG_FATAL, LOG_TAG, "popen failed: %d", errno);
+    _exit(EXIT_FAILURE);
+  }
+  readFeatures(p, &features);
+  if (pclose(p) != 0 || cache_path.empty()) {
+    return features;
+  }
+  // Written to a file of this process, then renamed, so that the processes
+  // starting at the same time never read a partial list.
+  std::string temp_path = cache_path + "." + std::to_string(getpid());
+  FILE* cache = fopen(temp_path.c_str(), "we");
+  if (cache) {
+    bool written = true;
+    for (const auto& feature : features) {
+      written &= fprintf(cache, "%s\n", feature.c_str()) >= 0;
+    }
+    written &= fclose(cache) == 0;
+    if (!written || rename(temp_path.c_str(), cache_path.c_str()) != 0) {
+      unlink(temp_path.c_str());
+    }
+  }
+  return features;
+}
+
+const std::unordered_set<std::string>& getDeviceFeatures() {
+  static const std::unordered_set<std::string> features =
+      loadDeviceFeatures();
+  return features;
+}
+
+// Looks the specified feature up in the features listed by
+// "pm list features".
 bool deviceSupportsFeature(const char* feature) {
-  return checkSubstringInCommandOutput("/system/bin/pm list features", feature);
+  if (strncmp(feature, kFeaturePrefix, strlen(kFeaturePrefix)) == 0) {
+    feature += strlen(kFeaturePrefix);
+  }
+  bool hasFeature = getDeviceFeatures().count(feature) > 0;
+  __android_log_print(ANDROID_LOG_INFO, LOG_TAG, "Feature %s: %ssupported",
+                      feature, hasFeature ? "" : "not ");
+  return hasFeature;
+}
+
+std::vector<bool> deviceSupportsFeatures(
+    const std::vector<std::string>& features) {
+  std::vector<bool> supported;
+  supported.reserve(features.size());
+  for (const auto& feature : features) {
+    supported.push_back(deviceSupportsFeature(feature.c_str()));
+  }
+  return supported;
 }
 
 }  // namespace testing
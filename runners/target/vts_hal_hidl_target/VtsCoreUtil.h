@@ -16,9 +16,28 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 namespace testing {
 
 bool checkSubstringInCommandOutput(const char* cmd, const char* feature);
+
+// Returns the features of the device listed by "pm list features", e.g.
+// android.hardware.wifi, and with their version if they have one, e.g.
+// android.hardware.vulkan.level=1 as well as android.hardware.vulkan.level.
+// pm only runs once per process, and once per boot as long as the list can be
+// cached in /data/local/tmp.
+const std::unordered_set<std::string>& getDeviceFeatures();
+
+// Returns whether the device has the given feature, e.g.
+// android.hardware.wifi. The "feature:" prefix of the output of pm is
+// optional.
 bool deviceSupportsFeature(const char* feature);
 
+// Returns whether the device has each of the given features, in order.
+std::vector<bool> deviceSupportsFeatures(
+    const std::vector<std::string>& features);
+
 }  // namespace testing
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "VtsHalHidlTargetBenchmark"
+
+#include "VtsHalHidlTargetBenchmark.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+namespace testing {
+
+// Returns the first line of the file at path, empty if it can't be read.
+static string ReadFirstLine(const string& path) {
+  ifstream in(path);
+  string line;
+  getline(in, line);
+  return line;
+}
+
+// Returns the names of the entries of dir that start with prefix, sorted.
+static vector<string> ListDir(const string& dir, const char* prefix) {
+  vector<string> names;
+  DIR* d = opendir(dir.c_str());
+  if (d == nullptr) return names;
+  struct dirent* entry;
+  while ((entry = readdir(d)) != nullptr) {
+    if (strncmp(entry->d_name, prefix, strlen(prefix)) == 0) {
+      names.push_back(entry->d_name);
+    }
+  }
+  closedir(d);
+  sort(names.begin(), names.end());
+  return names;
+}
+
+VtsHalBenchmarkResult VtsHalHidlTargetBenchmark::Run(
+    const function<void()>& operation) const {
+  for (size_t i = 0; i < warmup_iterations_; i++) {
+    operation();
+  }
+  vector<pair<string, string>> device_state = CaptureDeviceState();
+  vector<int64_t> latencies_ns;
+  latencies_ns.reserve(iterations_);
+  for (size_t i = 0; i < iterations_; i++) {
+    auto start = chrono::steady_clock::now();
+    operation();
+    latencies_ns.push_back(chrono::duration_cast<chrono::nanoseconds>(
+                               chrono::steady_clock::now() - start)
+                               .count());
+  }
+  VtsHalBenchmarkResult result = ComputeResult(name_, move(latencies_ns));
+  result.device_state = move(device_state);
+  return result;
+}
+
+VtsHalBenchmarkResult VtsHalHidlTargetBenchmark::ComputeResult(
+    const string& name, vector<int64_t> latencies_ns) {
+  VtsHalBenchmarkResult result;
+  result.name = name;
+  result.iterations = latencies_ns.size();
+  if (latencies_ns.empty()) return result;
+  sort(latencies_ns.begin(), latencies_ns.end());
+  // nearest-rank percentile.
+  auto percentile = [&latencies_ns](size_t percent) {
+    size_t rank = (latencies_ns.size() * percent + 99) / 100;
+    return latencies_ns[max<size_t>(rank, 1) - 1];
+  };
+  int64_t sum = 0;
+  for (int64_t latency : latencies_ns) {
+    sum += latency;
+  }
+  result.min_ns = latencies_ns.front();
+  result.mean_ns = sum / static_cast<int64_t>(latencies_ns.size());
+  result.p50_ns = percentile(50);
+  result.p90_ns = percentile(90);
+  result.p99_ns = percentile(99);
+  result.max_ns = latencies_ns.back();
+  return result;
+}
+
+vector<pair<string, string>> VtsHalHidlTargetBenchmark::CaptureDeviceState() {
+  vector<pair<string, string>> state;
+  static const string kCpuDir = "/sys/devices/system/cpu";
+  for (const auto& cpu : ListDir(kCpuDir, "cpu")) {
+    if (cpu.size() <= 3 || !isdigit(cpu[3])) continue;
+    string freq =
+        ReadFirstLine(kCpuDir + "/" + cpu + "/cpufreq/scaling_cur_freq");
+    if (!freq.empty()) state.emplace_back(cpu + "_freq_khz", freq);
+  }
+  static const string kThermalDir = "/sys/class/thermal";
+  for (const auto& zone : ListDir(kThermalDir, "thermal_zone")) {
+    string type = ReadFirstLine(kThermalDir + "/" + zone + "/type");
+    string temp = ReadFirstLine(kThermalDir + "/" + zone + "/temp");
+    if (type.empty() || temp.empty()) continue;
+    state.emplace_back("thermal_" + type + "_mc", temp);
+  }
+  return state;
+}
+
+void VtsHalHidlTargetBenchmark::Report(const VtsHalBenchmarkResult& result) {
+  ALOGI("[Benchmark] %s: %zu iterations, min %lld ns, mean %lld ns, "
+        "p50 %lld ns, p90 %lld ns, p99 %lld ns, max %lld ns",
+        result.name.c_str(), result.iterations, (long long)result.min_ns,
+        (long long)result.mean_ns, (long long)result.p50_ns,
+        (long long)result.p90_ns, (long long)result.p99_ns,
+        (long long)result.max_ns);
+  // "<label>=<value>,...;<option>=<value>,...", parsed by
+  // gtest_binary_test into the labels, values and options of a
+  // ProfilingReportMessage.
+  ostringstream value;
+  value << "min=" << result.min_ns << ",mean=" << result.mean_ns
+        << ",p50=" << result.p50_ns << ",p90=" << result.p90_ns
+        << ",p99=" << result.p99_ns << ",max=" << result.max_ns
+        << ";iterations=" << result.iterations;
+  for (const auto& counter : result.counters) {
+    value << "," << counter.first << "=" << counter.second;
+  }
+  for (const auto& state : result.device_state) {
+    value << "," << state.first << "=" << state.second;
+  }
+  Test::RecordProperty(kVtsHalBenchmarkPropertyPrefix + result.name,
+                       value.str());
+}
+
+}  // namespace testing
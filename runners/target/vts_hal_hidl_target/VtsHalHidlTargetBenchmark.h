@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_HAL_HIDL_TARGET_BENCHMARK_H
+#define __VTS_HAL_HIDL_TARGET_BENCHMARK_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// The prefix of the gtest properties that carry the benchmark results to the
+// host, where gtest_binary_test adds them to the profiling reports of
+// VtsReportMessage.proto.
+constexpr char kVtsHalBenchmarkPropertyPrefix[] = "vts_benchmark:";
+
+namespace testing {
+
+/*
+ * The results of a benchmark.
+ */
+struct VtsHalBenchmarkResult {
+  // the name of the benchmark, used as the profiling point name.
+  string name;
+  // the number of measured iterations.
+  size_t iterations = 0;
+  // the latency distribution of the iterations in nanoseconds.
+  int64_t min_ns = 0;
+  int64_t mean_ns = 0;
+  int64_t p50_ns = 0;
+  int64_t p90_ns = 0;
+  int64_t p99_ns = 0;
+  int64_t max_ns = 0;
+  // other values measured with the latencies, as key and value, e.g.
+  // ("notify_count", "1000").
+  vector<pair<string, string>> counters;
+  // the state of the device when the measurement started, as key and value,
+  // e.g. ("cpu0_freq_khz", "1766400") or ("thermal_cpu0_mc", "41200").
+  vector<pair<string, string>> device_state;
+};
+
+/*
+ * VTS target side helper to measure the latency of HAL calls.
+ *
+ * A typical usage looks like this:
+ *
+ * TEST_F(PowerHidlTest, SetInteractiveLatency) {
+ *   VtsHalHidlTargetBenchmark benchmark("power_setInteractive");
+ *   VtsHalHidlTargetBenchmark::Report(
+ *       benchmark.Run([&]() { power->setInteractive(true); }));
+ * }
+ *
+ * Run calls the operation warmup_iterations times without measuring it, then
+ * measures each of the iterations calls. Report logs the results and records
+ * them as a gtest property, which the host adds to the test report as a
+ * labeled vector profiling point, so that regressions show on the dashboard.
+ */
+class VtsHalHidlTargetBenchmark {
+ public:
+  VtsHalHidlTargetBenchmark(const string& name, size_t warmup_iterations = 10,
+                            size_t iterations = 100)
+      : name_(name),
+        warmup_iterations_(warmup_iterations),
+        iterations_(iterations) {}
+
+  /*
+   * Measures operation and returns the latency distribution of its calls.
+   */
+  VtsHalBenchmarkResult Run(const function<void()>& operation) const;
+
+  /*
+   * Computes the results of a benchmark from the latency of each iteration
+   * in nanoseconds.
+   */
+  static VtsHalBenchmarkResult ComputeResult(const string& name,
+                                             vector<int64_t> latencies_ns);
+
+  /*
+   * Returns the state of the device that affects the latency: the current
+   * frequency of each CPU and the temperature of each thermal zone.
+   */
+  static vector<pair<string, string>> CaptureDeviceState();
+
+  /*
+   * Logs result and records it as a gtest property of the current test.
+   */
+  static void Report(const VtsHalBenchmarkResult& result);
+
+ private:
+  string name_;
+  size_t warmup_iterations_;
+  size_t iterations_;
+};
+
+}  // namespace testing
+
+#endif  // __VTS_HAL_HIDL_TARGET_BENCHMARK_H
@@ -17,13 +17,25 @@
 #ifndef __VTS_HAL_HIDL_TARGET_CALLBACK_BASE_H
 #define __VTS_HAL_HIDL_TARGET_CALLBACK_BASE_H
 
+#include <stdint.h>
+
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <iostream>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <queue>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
+
+#include "VtsHalHidlTargetBenchmark.h"
 
 using namespace ::std;
 using namespace ::std::chrono;
@@ -31,6 +43,7 @@ using namespace ::std::chrono;
 constexpr char kVtsHalHidlTargetCallbackDefaultName[] =
     "VtsHalHidlTargetCallbackDefaultName";
 constexpr milliseconds DEFAULT_CALLBACK_WAIT_TIMEOUT_INITIAL = minutes(1);
+constexpr size_t DEFAULT_CALLBACK_QUEUE_CAPACITY = 256;
 
 namespace testing {
 
@@ -88,9 +101,43 @@ namespace testing {
  *
  * Note type of CallbackArgsTemplateClass is same across the class, which means
  * all WaitForCallback method will return the same data type.
+ *
+ * Callbacks called at a high rate, e.g. sensor events, can be registered
+ * first. Notifying a registered callback doesn't look up its name, take a
+ * lock or allocate: the args are constructed in place in a bounded queue,
+ * and the waiting test is woken up only if it is blocked.
+ *
+ * class MyCallback ... {
+ *  public:
+ *   MyCallback() { event_id_ = RegisterCallback("onEvent"); }
+ *   onEvent(const Event& event) { NotifyFromCallback(event_id_, event); }
+ *   CallbackId event_id_;
+ * }
+ *
+ * Test(MyTest) {
+ *   auto result = cb_.WaitForCallback(cb_.event_id_);
+ * }
+ *
+ * A registered callback must be notified by one thread at a time, and
+ * waited for by one thread at a time.
+ *
+ * The notifications of each callback function are timed, from the notify to
+ * the return of the wait that gets it. A test that waits for callbacks in a
+ * loop can report these as a benchmark:
+ *
+ * Test(MyTest) {
+ *   for (int i = 0; i < 1000; i++) {
+ *     CallApi1();
+ *     EXPECT_TRUE(cb_.WaitForCallback("CallbackApi1").no_timeout);
+ *   }
+ *   cb_.ReportCallbackStats("CallbackApi1");
+ * }
  */
 template <class CallbackArgsTemplateClass>
 class VtsHalHidlTargetCallbackBase {
+ private:
+  class CallbackLock;
+
  public:
   struct WaitForCallbackResult {
     WaitForCallbackResult()
@@ -106,8 +153,78 @@ class VtsHalHidlTargetCallbackBase {
     string name;
   };
 
+  /*
+   * Statistics of the notifications of a callback function.
+   */
+  struct CallbackStats {
+    // Number of notifications, including the dropped ones
+    uint64_t notify_count = 0;
+    // Time of the first and last notification, in steady_clock nanoseconds
+    int64_t first_notify_ns = 0;
+    int64_t last_notify_ns = 0;
+    // Number of notifications returned by a wait
+    uint64_t delivered_count = 0;
+    // Time from a notification to the return of the wait that got it, in
+    // nanoseconds
+    int64_t min_latency_ns = 0;
+    int64_t max_latency_ns = 0;
+    int64_t total_latency_ns = 0;
+    // latency_histogram[i] counts the latencies in [2^i, 2^(i+1)) ns, and
+    // latency_histogram[0] also those under 1 ns
+    uint64_t latency_histogram[64] = {};
+
+    /* Get the notifications per second from the first to the last one. */
+    double GetNotifyRate() const {
+      if (notify_count < 2 || last_notify_ns <= first_notify_ns) {
+        return 0;
+      }
+      return (notify_count - 1) * 1e9 / (last_notify_ns - first_notify_ns);
+    }
+
+    /* Get the mean latency of the delivered notifications. */
+    int64_t GetMeanLatencyNs() const {
+      if (delivered_count == 0) {
+        return 0;
+      }
+      return total_latency_ns / static_cast<int64_t>(delivered_count);
+    }
+
+    /*
+     * Get the nearest-rank latency percentile, rounded up to the end of its
+     * histogram bucket.
+     */
+    int64_t GetLatencyPercentileNs(size_t percent) const {
+      uint64_t rank = max<uint64_t>((delivered_count * percent + 99) / 100, 1);
+      uint64_t count = 0;
+      for (size_t i = 0; i < 64; i++) {
+        count += latency_histogram[i];
+        if (count >= rank) {
+          int64_t bucket_end =
+              i >= 62 ? INT64_MAX : (static_cast<int64_t>(2) << i) - 1;
+          return max(min(bucket_end, max_latency_ns), min_latency_ns);
+        }
+      }
+      return max_latency_ns;
+    }
+  };
+
+  /*
+   * Identifies a callback function registered with RegisterCallback.
+   */
+  class CallbackId {
+   public:
+    CallbackId() : lock_(nullptr) {}
+
+   private:
+    friend class VtsHalHidlTargetCallbackBase;
+    explicit CallbackId(CallbackLock* lock) : lock_(lock) {}
+
+    CallbackLock* lock_;
+  };
+
   VtsHalHidlTargetCallbackBase()
-      : cb_default_wait_timeout_(DEFAULT_CALLBACK_WAIT_TIMEOUT_INITIAL) {}
+      : cb_default_wait_timeout_(DEFAULT_CALLBACK_WAIT_TIMEOUT_INITIAL),
+        cb_wait_any_waiter_count_(0) {}
 
   virtual ~VtsHalHidlTargetCallbackBase() {
     for (auto it : cb_lock_map_) {
@@ -129,6 +246,15 @@ class VtsHalHidlTargetCallbackBase {
     return GetCallbackLock(callback_function_name)->WaitForCallback(timeout);
   }
 
+  /*
+   * Wait for a registered callback function in a test.
+   * Returns a WaitForCallbackResult object containing wait results.
+   */
+  WaitForCallbackResult WaitForCallback(
+      CallbackId callback_id, milliseconds timeout = milliseconds(-1)) {
+    return callback_id.lock_->WaitForCallback(timeout);
+  }
+
   /*
    * Wait for any of the callback functions specified.
    * Returns a WaitForCallbackResult object containing wait results.
@@ -142,23 +268,109 @@ class VtsHalHidlTargetCallbackBase {
       const vector<string>& callback_function_names = vector<string>(),
       milliseconds timeout_any = milliseconds(-1)) {
     unique_lock<mutex> lock(cb_wait_any_mtx_);
+    // Registered callbacks notify without cb_wait_any_mtx_, and take it only
+    // if a test waits.
+    cb_wait_any_waiter_count_++;
 
     auto start_time = steady_clock::now();
+    auto expiration =
+        GetWaitAnyTimeout(callback_function_names, start_time, timeout_any);
+    unordered_set<CallbackLock*> locks;
+    for (auto const& name : callback_function_names) {
+      locks.insert(GetCallbackLock(name));
+    }
 
-    WaitForCallbackResult res = PeekCallbackLocks(callback_function_names);
+    WaitForCallbackResult res = PopReadyCallbackLock(locks);
     while (!res.no_timeout) {
-      auto expiration =
-          GetWaitAnyTimeout(callback_function_names, start_time, timeout_any);
       auto status = cb_wait_any_cv_.wait_until(lock, expiration);
       if (status == cv_status::timeout) {
         cerr << "Timed out waiting for callback functions." << endl;
         break;
       }
-      res = PeekCallbackLocks(callback_function_names);
+      res = PopReadyCallbackLock(locks);
     }
+    cb_wait_any_waiter_count_--;
     return res;
   }
 
+  /*
+   * Register a callback function, to notify and wait for it by id.
+   * Up to queue_capacity notifications can be pending, the args of the
+   * notifications beyond are dropped.
+   */
+  CallbackId RegisterCallback(
+      const string& callback_function_name =
+          kVtsHalHidlTargetCallbackDefaultName,
+      size_t queue_capacity = DEFAULT_CALLBACK_QUEUE_CAPACITY) {
+    CallbackLock* lock = GetCallbackLock(callback_function_name);
+    lock->EnableQueue(queue_capacity);
+    return CallbackId(lock);
+  }
+
+  /*
+   * Notify a waiting test when a registered callback is invoked, with the
+   * args constructed in place from args.
+   * Returns false if the args were dropped as the queue of the callback
+   * function is full.
+   */
+  template <typename... Args>
+  bool NotifyFromCallback(CallbackId callback_id, Args&&... args) {
+    bool queued =
+        callback_id.lock_->NotifyFromCallbackQueue(forward<Args>(args)...);
+    if (queued) {
+      PushReadyCallbackLock(callback_id.lock_);
+    }
+    if (cb_wait_any_waiter_count_.load() > 0) {
+      unique_lock<mutex> lock(cb_wait_any_mtx_);
+      cb_wait_any_cv_.notify_one();
+    }
+    return queued;
+  }
+
+  /*
+   * Get the number of notifications of a registered callback function whose
+   * args were dropped as its queue was full.
+   */
+  uint64_t GetDroppedCallbackCount(CallbackId callback_id) {
+    return callback_id.lock_->GetDroppedCount();
+  }
+
+  /*
+   * Get the statistics of the notifications of a callback function.
+   * If callback_function_name is not provided, a default name will be used.
+   */
+  CallbackStats GetCallbackStats(const string& callback_function_name =
+                                     kVtsHalHidlTargetCallbackDefaultName) {
+    return GetCallbackLock(callback_function_name)->GetStats();
+  }
+
+  /*
+   * Get the statistics of the notifications of a registered callback
+   * function.
+   */
+  CallbackStats GetCallbackStats(CallbackId callback_id) {
+    return callback_id.lock_->GetStats();
+  }
+
+  /*
+   * Log the statistics of a callback function and record them as a benchmark
+   * result of the current test, see VtsHalHidlTargetBenchmark::Report.
+   * If callback_function_name is not provided, a default name will be used.
+   */
+  void ReportCallbackStats(const string& callback_function_name =
+                               kVtsHalHidlTargetCallbackDefaultName) {
+    ReportStats(callback_function_name,
+                GetCallbackStats(callback_function_name));
+  }
+
+  /*
+   * Log the statistics of a registered callback function and record them as
+   * a benchmark result of the current test.
+   */
+  void ReportCallbackStats(CallbackId callback_id) {
+    ReportStats(callback_id.lock_->GetName(), GetCallbackStats(callback_id));
+  }
+
   /*
    * Notify a waiting test when a callback is invoked.
    * If callback_function_name is not provided, a default name will be used.
@@ -166,7 +378,9 @@ class VtsHalHidlTargetCallbackBase {
   void NotifyFromCallback(const string& callback_function_name =
                               kVtsHalHidlTargetCallbackDefaultName) {
     unique_lock<mutex> lock(cb_wait_any_mtx_);
-    GetCallbackLock(callback_function_name)->NotifyFromCallback();
+    CallbackLock* cb_lock = GetCallbackLock(callback_function_name);
+    cb_lock->NotifyFromCallback();
+    PushReadyCallbackLock(cb_lock);
     cb_wait_any_cv_.notify_one();
   }
 
@@ -184,7 +398,9 @@ class VtsHalHidlTargetCallbackBase {
   void NotifyFromCallback(const string& callback_function_name,
                           const CallbackArgsTemplateClass& data) {
     unique_lock<mutex> lock(cb_wait_any_mtx_);
-    GetCallbackLock(callback_function_name)->NotifyFromCallback(data);
+    CallbackLock* cb_lock = GetCallbackLock(callback_function_name);
+    cb_lock->NotifyFromCallback(data);
+    PushReadyCallbackLock(cb_lock);
     cb_wait_any_cv_.notify_one();
   }
 
@@ -234,6 +450,80 @@ class VtsHalHidlTargetCallbackBase {
   }
 
  private:
+  /*
+   * A bounded single-producer, single-consumer queue of callback args, which
+   * are constructed in place in preallocated slots, with the time of their
+   * notification.
+   * tail_ is accessed with sequential consistency, so that a notifier either
+   * sees a waiter count incremented before a waiter checks the queue, or the
+   * waiter sees the args. On ARMv8 this costs the same as release/acquire.
+   */
+  class CallbackQueue {
+   public:
+    explicit CallbackQueue(size_t capacity)
+        : capacity_(capacity),
+          slots_(new Slot[capacity]),
+          notify_times_ns_(new int64_t[capacity]),
+          head_(0),
+          tail_(0) {}
+
+    ~CallbackQueue() {
+      for (size_t i = head_; i != tail_; i++) {
+        GetSlot(i)->~CallbackArgsTemplateClass();
+      }
+    }
+
+    /* Construct args at the tail. Returns false if the queue is full. */
+    template <typename... Args>
+    bool TryEmplace(int64_t notify_time_ns, Args&&... args) {
+      size_t tail = tail_.load(memory_order_relaxed);
+      if (tail - head_.load(memory_order_acquire) == capacity_) {
+        return false;
+      }
+      new (GetSlot(tail)) CallbackArgsTemplateClass(forward<Args>(args)...);
+      notify_times_ns_[tail % capacity_] = notify_time_ns;
+      tail_.store(tail + 1);
+      return true;
+    }
+
+    /*
+     * Move the args at the head to args, and get the time of their
+     * notification. Returns false if it's empty.
+     */
+    bool TryPop(shared_ptr<CallbackArgsTemplateClass>* args,
+                int64_t* notify_time_ns) {
+      size_t head = head_.load(memory_order_relaxed);
+      if (head == tail_.load()) {
+        return false;
+      }
+      CallbackArgsTemplateClass* slot = GetSlot(head);
+      *args = make_shared<CallbackArgsTemplateClass>(move(*slot));
+      *notify_time_ns = notify_times_ns_[head % capacity_];
+      slot->~CallbackArgsTemplateClass();
+      head_.store(head + 1, memory_order_release);
+      return true;
+    }
+
+   private:
+    using Slot =
+        typename aligned_storage<sizeof(CallbackArgsTemplateClass),
+                                 alignof(CallbackArgsTemplateClass)>::type;
+
+    CallbackArgsTemplateClass* GetSlot(size_t index) {
+      return reinterpret_cast<CallbackArgsTemplateClass*>(
+          &slots_[index % capacity_]);
+    }
+
+    const size_t capacity_;
+    unique_ptr<Slot[]> slots_;
+    // Notification time of the args in each slot
+    unique_ptr<int64_t[]> notify_times_ns_;
+    // Index of the next args to pop, only written by the consumer.
+    alignas(64) atomic<size_t> head_;
+    // Index of the next args to construct, only written by the producer.
+    alignas(64) atomic<size_t> tail_;
+  };
+
   /*
    * A utility class to store semaphore and data for a callback name.
    */
@@ -243,7 +533,18 @@ class VtsHalHidlTargetCallbackBase {
         : wait_count_(0),
           parent_(parent),
           timeout_(milliseconds(-1)),
-          name_(name) {}
+          name_(name),
+          waiter_count_(0),
+          dropped_count_(0),
+          notify_count_(0),
+          first_notify_ns_(0),
+          last_notify_ns_(0) {}
+
+    // Whether the lock is in the ready stack or list of the parent, see
+    // PushReadyCallbackLock.
+    atomic<bool> ready_{false};
+    // Next lock in the ready stack of the parent.
+    CallbackLock* next_ready_ = nullptr;
 
     /*
      * Wait for represented callback function.
@@ -268,6 +569,7 @@ class VtsHalHidlTargetCallbackBase {
     /* Notify from represented callback function. */
     void NotifyFromCallback() {
       unique_lock<mutex> lock(wait_mtx_);
+      notify_times_ns_.push(RecordNotify());
       Notify();
     }
 
@@ -275,9 +577,72 @@ class VtsHalHidlTargetCallbackBase {
     void NotifyFromCallback(const CallbackArgsTemplateClass& data) {
       unique_lock<mutex> wait_lock(wait_mtx_);
       arg_data_.push(make_shared<CallbackArgsTemplateClass>(data));
+      notify_times_ns_.push(RecordNotify());
       Notify();
     }
 
+    /* Make the callback use a queue of in place constructed args. */
+    void EnableQueue(size_t capacity) {
+      unique_lock<mutex> lock(wait_mtx_);
+      if (!queue_) {
+        queue_.reset(new CallbackQueue(capacity));
+      }
+    }
+
+    /* Notify from represented callback function through its queue. */
+    template <typename... Args>
+    bool NotifyFromCallbackQueue(Args&&... args) {
+      if (!queue_->TryEmplace(RecordNotify(), forward<Args>(args)...)) {
+        dropped_count_++;
+        return false;
+      }
+      if (waiter_count_.load() > 0) {
+        unique_lock<mutex> lock(wait_mtx_);
+        wait_cv_.notify_one();
+      }
+      return true;
+    }
+
+    /* Get the number of notifications dropped as the queue was full. */
+    uint64_t GetDroppedCount() { return dropped_count_.load(); }
+
+    /* Get the statistics of the notifications. */
+    CallbackStats GetStats() {
+      unique_lock<mutex> lock(stats_mtx_);
+      CallbackStats stats = stats_;
+      stats.notify_count = notify_count_.load();
+      stats.first_notify_ns = first_notify_ns_.load();
+      stats.last_notify_ns = last_notify_ns_.load();
+      return stats;
+    }
+
+    /* Get the name of the represented callback function. */
+    const string& GetName() { return name_; }
+
+    /*
+     * Drop the pending notifications, and reset the wait timeout and the
+     * statistics.
+     */
+    void Clear() {
+      unique_lock<mutex> lock(wait_mtx_);
+      wait_count_ = 0;
+      arg_data_ = queue<shared_ptr<CallbackArgsTemplateClass>>();
+      notify_times_ns_ = queue<int64_t>();
+      timeout_ = milliseconds(-1);
+      if (queue_) {
+        shared_ptr<CallbackArgsTemplateClass> args;
+        int64_t notify_time_ns;
+        while (queue_->TryPop(&args, &notify_time_ns)) {
+        }
+      }
+      dropped_count_ = 0;
+      notify_count_ = 0;
+      first_notify_ns_ = 0;
+      last_notify_ns_ = 0;
+      unique_lock<mutex> stats_lock(stats_mtx_);
+      stats_ = CallbackStats();
+    }
+
     /* Set wait timeout for represented callback function. */
     void SetWaitTimeout(milliseconds timeout) { timeout_ = timeout; }
 
@@ -297,6 +662,9 @@ class VtsHalHidlTargetCallbackBase {
      * use the time out set for the callback or default callback wait time out.
      */
     WaitForCallbackResult Wait(milliseconds timeout, bool no_wait_blocking) {
+      if (queue_) {
+        return WaitQueue(timeout, no_wait_blocking);
+      }
       unique_lock<mutex> lock(wait_mtx_);
       WaitForCallbackResult res;
       res.name = name_;
@@ -322,9 +690,86 @@ class VtsHalHidlTargetCallbackBase {
         res.args = arg_data_.front();
         arg_data_.pop();
       }
+      RecordDelivery(notify_times_ns_.front());
+      notify_times_ns_.pop();
+      return res;
+    }
+
+    /*
+     * Wait for represented callback function through its queue. wait_mtx_
+     * is only taken to block, see NotifyFromCallbackQueue.
+     */
+    WaitForCallbackResult WaitQueue(milliseconds timeout,
+                                    bool no_wait_blocking) {
+      WaitForCallbackResult res;
+      res.name = name_;
+      int64_t notify_time_ns;
+      if (queue_->TryPop(&res.args, &notify_time_ns)) {
+        res.no_timeout = true;
+        RecordDelivery(notify_time_ns);
+        return res;
+      }
+      if (no_wait_blocking) {
+        return res;
+      }
+      if (timeout < milliseconds(0)) {
+        timeout = GetWaitTimeout();
+      }
+      auto expiration = steady_clock::now() + timeout;
+      unique_lock<mutex> lock(wait_mtx_);
+      waiter_count_++;
+      bool popped = queue_->TryPop(&res.args, &notify_time_ns);
+      while (!popped) {
+        auto status = wait_cv_.wait_until(lock, expiration);
+        popped = queue_->TryPop(&res.args, &notify_time_ns);
+        if (!popped && status == cv_status::timeout) {
+          break;
+        }
+      }
+      waiter_count_--;
+      if (!popped) {
+        cerr << "Timed out waiting for callback" << endl;
+        return res;
+      }
+      res.no_timeout = true;
+      RecordDelivery(notify_time_ns);
       return res;
     }
 
+    /* Count a notification and return its time. */
+    int64_t RecordNotify() {
+      int64_t now_ns = GetNowNs();
+      int64_t no_notify_ns = 0;
+      first_notify_ns_.compare_exchange_strong(no_notify_ns, now_ns,
+                                               memory_order_relaxed);
+      last_notify_ns_.store(now_ns, memory_order_relaxed);
+      notify_count_.fetch_add(1, memory_order_relaxed);
+      return now_ns;
+    }
+
+    /* Add the latency of a notification returned by a wait. */
+    void RecordDelivery(int64_t notify_time_ns) {
+      int64_t latency_ns = max<int64_t>(GetNowNs() - notify_time_ns, 0);
+      size_t bucket = 0;
+      while (bucket < 63 && (latency_ns >> (bucket + 1)) != 0) {
+        bucket++;
+      }
+      unique_lock<mutex> lock(stats_mtx_);
+      if (stats_.delivered_count == 0 || latency_ns < stats_.min_latency_ns) {
+        stats_.min_latency_ns = latency_ns;
+      }
+      stats_.max_latency_ns = max(stats_.max_latency_ns, latency_ns);
+      stats_.total_latency_ns += latency_ns;
+      stats_.delivered_count++;
+      stats_.latency_histogram[bucket]++;
+    }
+
+    static int64_t GetNowNs() {
+      return duration_cast<nanoseconds>(
+                 steady_clock::now().time_since_epoch())
+          .count();
+    }
+
     /* Notify from represented callback function. */
     void Notify() {
       wait_count_++;
@@ -339,12 +784,28 @@ class VtsHalHidlTargetCallbackBase {
     unsigned int wait_count_;
     // A queue of callback arg data
     queue<shared_ptr<CallbackArgsTemplateClass>> arg_data_;
+    // Notification time of each pending notification, for wait_count_
+    queue<int64_t> notify_times_ns_;
     // Pointer to parent class
     VtsHalHidlTargetCallbackBase& parent_;
     // Wait time out
     milliseconds timeout_;
     // Name of the represented callback function
     string name_;
+    // Queue of args of a registered callback function, see RegisterCallback
+    unique_ptr<CallbackQueue> queue_;
+    // Number of threads blocked in WaitQueue
+    atomic<int> waiter_count_;
+    // Number of notifications dropped as queue_ was full
+    atomic<uint64_t> dropped_count_;
+    // Notification statistics, updated by the notifying threads
+    atomic<uint64_t> notify_count_;
+    atomic<int64_t> first_notify_ns_;
+    atomic<int64_t> last_notify_ns_;
+    // Mutex for protecting stats_
+    mutex stats_mtx_;
+    // Delivery statistics, updated by the waiting threads
+    CallbackStats stats_;
   };
 
   /*
@@ -352,7 +813,8 @@ class VtsHalHidlTargetCallbackBase {
    * If callback_function_name is not provided, a default name will be used.
    * If callback_function_name does not exists in map yet, a new CallbackLock
    * object will be created.
-   * If auto_clear is true, the old CallbackLock will be deleted.
+   * If auto_clear is true, the old CallbackLock will be cleared. It is kept,
+   * as registered callback ids point to it.
    */
   CallbackLock* GetCallbackLock(const string& callback_function_name,
                                 bool auto_clear = false) {
@@ -364,13 +826,35 @@ class VtsHalHidlTargetCallbackBase {
       return result;
     } else {
       if (auto_clear) {
-        delete (found->second);
-        found->second = new CallbackLock(*this, callback_function_name);
+        found->second->Clear();
       }
       return found->second;
     }
   }
 
+  /*
+   * Log the statistics of a callback function and record them with
+   * VtsHalHidlTargetBenchmark::Report.
+   */
+  static void ReportStats(const string& callback_function_name,
+                          const CallbackStats& stats) {
+    VtsHalBenchmarkResult result;
+    result.name = "callback_" + callback_function_name;
+    result.iterations = stats.delivered_count;
+    result.min_ns = stats.min_latency_ns;
+    result.mean_ns = stats.GetMeanLatencyNs();
+    result.p50_ns = stats.GetLatencyPercentileNs(50);
+    result.p90_ns = stats.GetLatencyPercentileNs(90);
+    result.p99_ns = stats.GetLatencyPercentileNs(99);
+    result.max_ns = stats.max_latency_ns;
+    result.counters.emplace_back("notify_count",
+                                 to_string(stats.notify_count));
+    result.counters.emplace_back(
+        "notify_rate_hz",
+        to_string(static_cast<int64_t>(stats.GetNotifyRate())));
+    VtsHalHidlTargetBenchmark::Report(result);
+  }
+
   /*
    * Get wait timeout for a list of function names.
    * If timeout_any is not negative, start_time + timeout_any will be returned.
@@ -415,16 +899,52 @@ class VtsHalHidlTargetCallbackBase {
   }
 
   /*
-   * Peek into the list of callback locks to check whether any of the
-   * callback functions has been called.
+   * Add a callback lock with a new notification to the ready stack, unless
+   * it is ready already. The stack is lock-free, so that registered callbacks
+   * can push to it without taking cb_wait_any_mtx_.
    */
-  WaitForCallbackResult PeekCallbackLocks(
-      const vector<string>& callback_function_names) {
-    auto locks = GetWaitAnyCallbackLocks(callback_function_names);
-    for (auto lock : locks) {
-      auto test = lock->WaitForCallback(true);
-      if (test.no_timeout) {
-        return test;
+  void PushReadyCallbackLock(CallbackLock* cb_lock) {
+    if (cb_lock->ready_.exchange(true)) {
+      return;
+    }
+    CallbackLock* head = cb_ready_stack_.load();
+    do {
+      cb_lock->next_ready_ = head;
+    } while (!cb_ready_stack_.compare_exchange_weak(head, cb_lock));
+  }
+
+  /*
+   * Pop a notification from the first ready callback lock in locks, or in
+   * any ready callback lock if locks is empty. The ready callback locks
+   * skipped stay ready. Must be called with cb_wait_any_mtx_.
+   */
+  WaitForCallbackResult PopReadyCallbackLock(
+      const unordered_set<CallbackLock*>& locks) {
+    // Move the ready stack to the end of the ready list, in notification
+    // order.
+    vector<CallbackLock*> pushed;
+    for (CallbackLock* cb_lock = cb_ready_stack_.exchange(nullptr);
+         cb_lock != nullptr; cb_lock = cb_lock->next_ready_) {
+      pushed.push_back(cb_lock);
+    }
+    cb_ready_list_.insert(cb_ready_list_.end(), pushed.rbegin(),
+                          pushed.rend());
+
+    auto it = cb_ready_list_.begin();
+    while (it != cb_ready_list_.end()) {
+      CallbackLock* cb_lock = *it;
+      if (!locks.empty() && locks.find(cb_lock) == locks.end()) {
+        ++it;
+        continue;
+      }
+      it = cb_ready_list_.erase(it);
+      // A notification after this pushes the lock again.
+      cb_lock->ready_ = false;
+      auto res = cb_lock->WaitForCallback(true);
+      if (res.no_timeout) {
+        // It may have more notifications.
+        PushReadyCallbackLock(cb_lock);
+        return res;
       }
     }
     WaitForCallbackResult res;
@@ -441,6 +961,13 @@ class VtsHalHidlTargetCallbackBase {
   milliseconds cb_default_wait_timeout_;
   // Conditional variable for any callback notify
   condition_variable cb_wait_any_cv_;
+  // Number of threads in WaitForCallbackAny
+  atomic<int> cb_wait_any_waiter_count_;
+  // Callback locks with notifications, pushed by the notifying threads
+  atomic<CallbackLock*> cb_ready_stack_{nullptr};
+  // Callback locks with notifications, moved from cb_ready_stack_ by
+  // WaitForCallbackAny, in notification order
+  list<CallbackLock*> cb_ready_list_;
 };
 
 }  // namespace testing
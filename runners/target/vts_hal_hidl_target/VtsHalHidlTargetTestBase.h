@@ -100,8 +100,14 @@ class VtsHalHidlTargetTestBase : public ::testing::Test {
    */
   template <class T>
   static sp <T> getService(VtsHalHidlTargetTestEnvBase* testEnv) {
-    return T::getService(testEnv->getServiceName<T>(),
-                         VtsHalHidlTargetTestBase::VtsGetStub());
+    string serviceName = testEnv->getServiceName<T>();
+    if (!VtsHalHidlTargetTestBase::VtsGetStub()) {
+      sp<T> service = testEnv->getPrefetchedService<T>(serviceName);
+      if (service != nullptr) {
+        return service;
+      }
+    }
+    return T::getService(serviceName, VtsHalHidlTargetTestBase::VtsGetStub());
   }
 
 private:
@@ -20,8 +20,13 @@
 
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <hidl-util/FqInstance.h>
+#include <hidl/ServiceManagement.h>
+
+#include "VtsHalHidlTargetTestBase.h"
 
 static const std::string kListFlag = "--list_registered_services";
 static const std::string kServiceInstanceFlag = "--hal_service_instance=";
@@ -42,6 +47,10 @@ void VtsHalHidlTargetTestEnvBase::SetUp() {
     listRegisteredServices();
     exit(0);
   }
+  // Passthrough mode doesn't go through hwservicemanager.
+  if (prefetchServices_ && getenv(VTS_HAL_HIDL_GET_STUB) == NULL) {
+    prefetchServices();
+  }
   // Call the customized setup process.
   HidlSetUp();
 }
@@ -123,6 +132,40 @@ string VtsHalHidlTargetTestEnvBase::getServiceName(const string& instanceName,
   return defaultName;
 }
 
+void VtsHalHidlTargetTestEnvBase::prefetchServices() {
+  vector<string> halNames(registeredHalServices_.begin(),
+                          registeredHalServices_.end());
+  vector<string> serviceNames;
+  for (const string& halName : halNames) {
+    auto instance = halServiceInstances_.find(halName);
+    serviceNames.push_back(instance != halServiceInstances_.end()
+                               ? instance->second
+                               : kDefaultServiceName);
+  }
+  // Each getService may wait for the service to start, so look them all up
+  // at the same time.
+  vector<::android::sp<::android::hidl::base::V1_0::IBase>> services(
+      halNames.size());
+  vector<thread> threads;
+  for (size_t i = 0; i < halNames.size(); i++) {
+    threads.emplace_back([&, i] {
+      services[i] = ::android::hardware::details::getRawServiceInternal(
+          halNames[i], serviceNames[i], true /* retry */, false /* getStub */);
+    });
+  }
+  for (thread& t : threads) {
+    t.join();
+  }
+  for (size_t i = 0; i < halNames.size(); i++) {
+    if (services[i] == nullptr) {
+      cerr << "Failed to prefetch " << halNames[i] << "/" << serviceNames[i]
+           << endl;
+      continue;
+    }
+    prefetchedServices_[halNames[i] + "/" + serviceNames[i]] = services[i];
+  }
+}
+
 void VtsHalHidlTargetTestEnvBase::registerTestService(const string& FQName) {
   registeredHalServices_.insert(FQName);
 }
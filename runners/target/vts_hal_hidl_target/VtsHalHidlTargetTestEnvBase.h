@@ -17,7 +17,9 @@
 #ifndef __VTS_HAL_HIDL_TARGET_TEST_ENV_BASE_H
 #define __VTS_HAL_HIDL_TARGET_TEST_ENV_BASE_H
 
+#include <android/hidl/base/1.0/IBase.h>
 #include <gtest/gtest.h>
+#include <hidl/HidlSupport.h>
 
 static constexpr const char* kDefaultServiceName = "default";
 
@@ -96,6 +98,27 @@ class VtsHalHidlTargetTestEnvBase : public ::testing::Environment {
 
   void setServiceCombMode(HalServiceCombMode mode) { mode_ = mode; }
 
+  /*
+   * Sets whether SetUp resolves all the registered services concurrently,
+   * before HidlSetUp, so that getService returns the cached handles instead
+   * of waiting on hwservicemanager one service at a time. Off by default.
+   */
+  void setPrefetchServices(bool prefetch) { prefetchServices_ = prefetch; }
+
+  /*
+   * Gets the handle of the hal instance with the given service name resolved
+   * in SetUp. Returns nullptr if the instance was not prefetched.
+   */
+  template <class T>
+  ::android::sp<T> getPrefetchedService(const string& serviceName) {
+    auto service = prefetchedServices_.find(string(T::descriptor) + "/" +
+                                            serviceName);
+    if (service == prefetchedServices_.end()) {
+      return nullptr;
+    }
+    return T::castFrom(service->second);
+  }
+
  private:
   /*
    * Parses VTS specific flags, currently support two flags:
@@ -114,6 +137,12 @@ class VtsHalHidlTargetTestEnvBase : public ::testing::Environment {
    */
   void listRegisteredServices();
 
+  /*
+   * Resolves the services in registeredHalServices_ concurrently, and stores
+   * the found ones in prefetchedServices_.
+   */
+  void prefetchServices();
+
   /*
    * Internal method to get the service name for a hal instance.
    */
@@ -145,6 +174,11 @@ class VtsHalHidlTargetTestEnvBase : public ::testing::Environment {
   bool inited_ = false;
   // Required combination mode for hal service instances.
   HalServiceCombMode mode_ = HalServiceCombMode::FULL_PERMUTATION;
+  // Flag whether SetUp prefetches the registered services.
+  bool prefetchServices_ = false;
+  // Map of prefetched service handles, keyed by hal/service name.
+  map<string, ::android::sp<::android::hidl::base::V1_0::IBase>>
+      prefetchedServices_;
 };
 
 }  // namespace testing
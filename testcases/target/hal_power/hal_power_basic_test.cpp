@@ -24,6 +24,8 @@
 
 #include <iostream>
 
+#include <VtsHalHidlTargetBenchmark.h>
+
 using namespace std;
 
 namespace {
@@ -161,4 +163,25 @@ TEST_F(VtsStructuralTestHalPowerTest,
   free(list1);
   free(voter_list);
 }
+
+// Measures the latency of get_platform_low_power_stats.
+TEST_F(VtsStructuralTestHalPowerTest, get_platform_low_power_stats_latency) {
+  std::vector<power_state_platform_sleep_state_t> list(num_modes_);
+  std::vector<size_t> voter_list(num_modes_);
+  module_->get_voter_list(module_, voter_list.data());
+  std::vector<std::vector<power_state_voter_t>> voters(num_modes_);
+  for (int i = 0; i < num_modes_; i++) {
+    voters[i].resize(voter_list[i]);
+    list[i].voters = voters[i].data();
+  }
+  int failures = 0;
+  ::testing::VtsHalHidlTargetBenchmark benchmark(
+      "power_get_platform_low_power_stats");
+  ::testing::VtsHalHidlTargetBenchmark::Report(benchmark.Run([&]() {
+    if (module_->get_platform_low_power_stats(module_, list.data()) != 0) {
+      failures++;
+    }
+  }));
+  EXPECT_EQ(0, failures) << "get_platform_low_power_stats failed";
+}
 }  // namespace
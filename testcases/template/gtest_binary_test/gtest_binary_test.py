@@ -30,6 +30,8 @@ from vts.testcases.template.binary_test import binary_test_case
 from vts.testcases.template.gtest_binary_test import gtest_test_case
 
 _GTEST_RESULT_ATTRIBUTE_ALLOW_LIST = ('properties',)
+# Prefix of the gtest properties recorded by VtsHalHidlTargetBenchmark.
+_BENCHMARK_PROPERTY_PREFIX = 'vts_benchmark:'
 
 
 class GtestBinaryTest(binary_test.BinaryTest):
@@ -208,8 +210,54 @@ class GtestBinaryTest(binary_test.BinaryTest):
         if not success:
             asserts.fail('\n'.join([x for x in messages if x]))
 
+        self._AddBenchmarkResults(root)
         asserts.skipIf(root.get('disabled') == '1', 'Gtest test case disabled')
 
+    def _AddBenchmarkResults(self, root):
+        '''Adds the benchmark results recorded by the test cases to the report.
+
+        VtsHalHidlTargetBenchmark records each result as a gtest property
+        named 'vts_benchmark:<name>' with the value
+        '<label>=<value>,...;<option>=<value>,...', e.g.
+        'min=1200,mean=1500,p50=1400,p90=2100,p99=3000,max=3200;'
+        'iterations=100,cpu0_freq_khz=1766400'. Depending on the gtest
+        version, the properties are property elements or attributes of the
+        testcase elements.
+
+        Args:
+            root: xml.etree.ElementTree, parsed xml result.
+        '''
+        properties = []
+        for test_case in root.iter('testcase'):
+            properties.extend(test_case.attrib.items())
+        for prop in root.iter('property'):
+            properties.append((prop.get('name'), prop.get('value')))
+
+        for name, value in properties:
+            if not name or not name.startswith(_BENCHMARK_PROPERTY_PREFIX):
+                continue
+            name = name[len(_BENCHMARK_PROPERTY_PREFIX):]
+            stats, _, options = (value or '').partition(';')
+            labels = []
+            values = []
+            try:
+                for stat in stats.split(','):
+                    label, _, stat_value = stat.partition('=')
+                    labels.append(label)
+                    values.append(int(stat_value))
+            except ValueError:
+                logging.error('Invalid benchmark result %s: %s', name, value)
+                continue
+            logging.info('Benchmark %s (ns): %s', name,
+                         ', '.join('%s %s' % x for x in zip(labels, values)))
+            self.web.AddProfilingDataLabeledVector(
+                name,
+                labels,
+                values,
+                options=[x for x in options.split(',') if x],
+                x_axis_label='Latency statistic',
+                y_axis_label='Latency (nano secs)')
+
     def _ParseResultXmlString(self, xml_str):
         """Parses the xml result string into elements.
 
@@ -239,6 +287,7 @@ class GtestBinaryTest(binary_test.BinaryTest):
             xml_str: string, result xml output content
         '''
         root = self._ParseResultXmlString(xml_str)
+        self._AddBenchmarkResults(root)
 
         for test_suite in root:
             logging.debug('Test tag: %s, attribute: %s',
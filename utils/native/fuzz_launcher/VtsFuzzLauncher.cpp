@@ -0,0 +1,570 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsFuzzLauncher.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <json/json.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// the seconds that a worker may run over the end of its round, e.g. to
+// write its final stats, before it is killed.
+static constexpr int kKillGraceSeconds = 10;
+// the seconds between two checks of the workers.
+static constexpr int kPollIntervalSeconds = 1;
+
+// set by SIGINT and SIGTERM to stop the fuzzing.
+static volatile sig_atomic_t sStopRequested = 0;
+
+static void OnStopSignal(int) { sStopRequested = 1; }
+
+// Creates dir and its parents if they don't exist.
+static bool MakeDirs(const string& dir) {
+  for (size_t pos = dir.find('/', 1); pos != string::npos;
+       pos = dir.find('/', pos + 1)) {
+    string parent = dir.substr(0, pos);
+    if (mkdir(parent.c_str(), 0755) != 0 && errno != EEXIST) {
+      cerr << __func__ << ": Can not create dir: " << parent << endl;
+      return false;
+    }
+  }
+  if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    cerr << __func__ << ": Can not create dir: " << dir << endl;
+    return false;
+  }
+  return true;
+}
+
+// Removes the files in dir.
+static void ClearDir(const string& dir) {
+  DIR* d = opendir(dir.c_str());
+  if (d == nullptr) {
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(d)) != nullptr) {
+    if (entry->d_type == DT_REG) {
+      unlink((dir + "/" + entry->d_name).c_str());
+    }
+  }
+  closedir(d);
+}
+
+// Returns the number after the last occurrence of key in line, or -1.
+static int64_t ParseValueAfter(const string& line, const string& key) {
+  size_t pos = line.rfind(key);
+  if (pos == string::npos) {
+    return -1;
+  }
+  const char* value = line.c_str() + pos + key.size();
+  char* end;
+  int64_t result = strtoll(value, &end, 10);
+  return end == value ? -1 : result;
+}
+
+VtsFuzzLauncher::VtsFuzzLauncher(const FuzzLauncherOptions& options)
+    : options_(options), cores_(1) {}
+
+int VtsFuzzLauncher::Run(const string& summary_file) {
+  if (!SetUp()) {
+    return -1;
+  }
+  struct sigaction action = {};
+  action.sa_handler = OnStopSignal;
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  time_t start_time = time(nullptr);
+  time_t end_time = start_time + options_.max_total_time;
+  int rounds = 0;
+  while (!sStopRequested) {
+    time_t now = time(nullptr);
+    if (now >= end_time) {
+      break;
+    }
+    int duration = min<int>(options_.merge_interval, end_time - now);
+    for (size_t i = 0; i < workers_.size(); i++) {
+      if (!StartWorker(i, duration)) {
+        workers_[i].failures++;
+      }
+    }
+    RunRound(now + duration);
+    for (auto& group : groups_) {
+      MergeGroup(&group);
+    }
+    rounds++;
+  }
+
+  int elapsed = time(nullptr) - start_time;
+  if (!WriteSummary(summary_file, elapsed, rounds)) {
+    return -1;
+  }
+  for (const auto& worker : workers_) {
+    if (worker.failures > 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+bool VtsFuzzLauncher::SetUp() {
+  if (options_.fuzzer.empty() || options_.corpus_dir.empty() ||
+      options_.work_dir.empty()) {
+    cerr << __func__ << ": The fuzzer, corpus dir and work dir are required."
+         << endl;
+    return false;
+  }
+  if (options_.workers <= 0 || options_.max_total_time <= 0 ||
+      options_.merge_interval <= 0) {
+    cerr << __func__ << ": Invalid number of workers or time." << endl;
+    return false;
+  }
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  cores_ = cores > 0 ? cores : 1;
+
+  if (options_.target_funcs.empty()) {
+    WorkerGroup group;
+    group.corpus_dir = options_.corpus_dir + "/all";
+    groups_.push_back(group);
+  } else {
+    for (const auto& target_func : options_.target_funcs) {
+      WorkerGroup group;
+      group.target_func = target_func;
+      group.corpus_dir = options_.corpus_dir + "/" + target_func;
+      groups_.push_back(group);
+    }
+  }
+  for (const auto& group : groups_) {
+    if (!MakeDirs(group.corpus_dir)) {
+      return false;
+    }
+  }
+
+  for (int i = 0; i < options_.workers; i++) {
+    WorkerGroup& group = groups_[i % groups_.size()];
+    Worker worker;
+    string worker_dir = options_.work_dir + "/worker_" + to_string(i);
+    worker.target_func = group.target_func;
+    worker.corpus_dir = worker_dir + "/corpus";
+    worker.artifact_dir = worker_dir + "/artifacts";
+    worker.log_file = worker_dir + "/fuzz.log";
+    worker.seed = options_.seed + i;
+    if (!MakeDirs(worker.corpus_dir) || !MakeDirs(worker.artifact_dir)) {
+      return false;
+    }
+    group.workers.push_back(workers_.size());
+    workers_.push_back(worker);
+  }
+  return true;
+}
+
+bool VtsFuzzLauncher::StartWorker(size_t index, int duration) {
+  Worker& worker = workers_[index];
+  const WorkerGroup* group = nullptr;
+  for (const auto& candidate : groups_) {
+    if (find(candidate.workers.begin(), candidate.workers.end(), index) !=
+        candidate.workers.end()) {
+      group = &candidate;
+    }
+  }
+  // the worker writes the inputs it finds to the first corpus dir.
+  vector<string> args = {
+      options_.fuzzer,
+      worker.corpus_dir,
+      group->corpus_dir,
+      "-max_total_time=" + to_string(duration),
+      "-seed=" + to_string(worker.seed),
+      "-rss_limit_mb=" + to_string(options_.rss_limit_mb),
+      "-artifact_prefix=" + worker.artifact_dir + "/",
+      "-print_final_stats=1",
+  };
+  if (!worker.target_func.empty()) {
+    args.push_back("--vts_target_func=" + worker.target_func);
+  }
+  args.insert(args.end(), options_.fuzzer_args.begin(),
+              options_.fuzzer_args.end());
+
+  // the seeds of the workers stay distinct over their runs.
+  worker.seed += options_.workers;
+  worker.killed = false;
+  worker.runs++;
+  worker.pid = Spawn(args, worker.log_file, index % cores_);
+  if (worker.pid < 0) {
+    worker.pid = 0;
+    return false;
+  }
+  return true;
+}
+
+void VtsFuzzLauncher::RunRound(time_t deadline) {
+  while (true) {
+    bool running = false;
+    time_t now = time(nullptr);
+    for (auto& worker : workers_) {
+      if (worker.pid == 0 || worker.killed) {
+        running |= worker.pid != 0;
+        continue;
+      }
+      running = true;
+      if (sStopRequested) {
+        killpg(worker.pid, SIGKILL);
+        worker.killed = true;
+      } else if (now >= deadline + kKillGraceSeconds) {
+        killpg(worker.pid, SIGKILL);
+        worker.killed = true;
+        worker.time_kills++;
+      } else if (options_.rss_limit_mb > 0 &&
+                 GetGroupRssMb(worker.pid) >
+                     static_cast<uint64_t>(options_.rss_limit_mb)) {
+        cerr << "Worker " << worker.pid << " is over the RSS limit of "
+             << options_.rss_limit_mb << " Mb." << endl;
+        killpg(worker.pid, SIGKILL);
+        worker.killed = true;
+        worker.rss_kills++;
+      }
+    }
+    if (!running) {
+      return;
+    }
+
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+      for (size_t i = 0; i < workers_.size(); i++) {
+        if (workers_[i].pid != pid) {
+          continue;
+        }
+        int failures = workers_[i].failures;
+        OnWorkerExit(i, status);
+        // a crashed worker fuzzes on for the rest of the round.
+        now = time(nullptr);
+        if (workers_[i].failures > failures && !sStopRequested &&
+            now < deadline) {
+          StartWorker(i, deadline - now);
+        }
+        break;
+      }
+    }
+    sleep(kPollIntervalSeconds);
+  }
+}
+
+void VtsFuzzLauncher::OnWorkerExit(size_t index, int status) {
+  Worker& worker = workers_[index];
+  RunStats run_stats;
+  ParseWorkerLog(worker.log_file, &run_stats);
+  worker.stats.executed_units += run_stats.executed_units;
+  worker.stats.new_units += run_stats.new_units;
+  worker.stats.coverage = max(worker.stats.coverage, run_stats.coverage);
+  worker.stats.peak_rss_mb =
+      max(worker.stats.peak_rss_mb, run_stats.peak_rss_mb);
+
+  if (!worker.killed && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+    worker.failures++;
+    if (WIFEXITED(status)) {
+      cerr << "Worker " << worker.pid << " exited with "
+           << WEXITSTATUS(status) << ", see " << worker.log_file << endl;
+    } else {
+      cerr << "Worker " << worker.pid << " was killed by signal "
+           << WTERMSIG(status) << ", see " << worker.log_file << endl;
+    }
+    // keeps the output of the failed run.
+    rename(worker.log_file.c_str(),
+           (worker.log_file + "." + to_string(worker.runs)).c_str());
+  }
+  worker.pid = 0;
+}
+
+bool VtsFuzzLauncher::MergeGroup(WorkerGroup* group) {
+  vector<string> args = {options_.fuzzer, "-merge=1", group->corpus_dir};
+  for (size_t index : group->workers) {
+    args.push_back(workers_[index].corpus_dir);
+  }
+  if (!group->target_func.empty()) {
+    args.push_back("--vts_target_func=" + group->target_func);
+  }
+  // the merge runs the inputs one by one, so it doesn't fork them.
+  for (const auto& arg : options_.fuzzer_args) {
+    if (arg.find("--vts_") == 0 && arg.find("--vts_fork_batch_size") != 0) {
+      args.push_back(arg);
+    }
+  }
+
+  string log_file = options_.work_dir + "/merge_" +
+                    (group->target_func.empty() ? "all" : group->target_func) +
+                    ".log";
+  pid_t pid = Spawn(args, log_file, -1);
+  if (pid < 0) {
+    return false;
+  }
+  int status;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      cerr << __func__ << ": waitpid failed: " << strerror(errno) << endl;
+      return false;
+    }
+  }
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    cerr << __func__ << ": Failed to merge the corpus: " << group->corpus_dir
+         << ", see " << log_file << endl;
+    return false;
+  }
+
+  // e.g. "MERGE-OUTER: 12 new files with 34 new features added; 5 new
+  // coverage edges"
+  ifstream in(log_file);
+  string line;
+  while (getline(in, line)) {
+    if (line.find("MERGE-OUTER:") == string::npos ||
+        line.find("new files") == string::npos) {
+      continue;
+    }
+    int64_t files = ParseValueAfter(line, "MERGE-OUTER: ");
+    int64_t features = ParseValueAfter(line, "with ");
+    int64_t edges = ParseValueAfter(line, "added; ");
+    group->merged_files += max<int64_t>(files, 0);
+    group->new_features += max<int64_t>(features, 0);
+    group->new_edges += max<int64_t>(edges, 0);
+  }
+  // the useful inputs are in the shared corpus now.
+  for (size_t index : group->workers) {
+    ClearDir(workers_[index].corpus_dir);
+  }
+  return true;
+}
+
+pid_t VtsFuzzLauncher::Spawn(const vector<string>& args,
+                             const string& log_file, int cpu) {
+  pid_t pid = fork();
+  if (pid < 0) {
+    cerr << __func__ << ": fork failed: " << strerror(errno) << endl;
+    return -1;
+  }
+  if (pid > 0) {
+    // also set in the parent, so that killpg can't run before the child
+    // set it.
+    setpgid(pid, pid);
+    return pid;
+  }
+
+  setpgid(0, 0);
+  if (cpu >= 0) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+  }
+  int fd = open(log_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                0644);
+  if (fd < 0) {
+    cerr << "Can not open log file: " << log_file << endl;
+    _exit(1);
+  }
+  dup2(fd, STDOUT_FILENO);
+  dup2(fd, STDERR_FILENO);
+
+  vector<char*> argv;
+  for (const auto& arg : args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  execv(argv[0], argv.data());
+  cerr << "Can not run " << argv[0] << ": " << strerror(errno) << endl;
+  _exit(1);
+}
+
+uint64_t VtsFuzzLauncher::GetGroupRssMb(pid_t pgid) {
+  static const long kPageSize = sysconf(_SC_PAGESIZE);
+  uint64_t max_rss_mb = 0;
+  DIR* proc = opendir("/proc");
+  if (proc == nullptr) {
+    return 0;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(proc)) != nullptr) {
+    if (!isdigit(entry->d_name[0])) {
+      continue;
+    }
+    ifstream in(string("/proc/") + entry->d_name + "/stat");
+    string stat;
+    if (!getline(in, stat)) {
+      continue;
+    }
+    // the fields after the command name, which may contain spaces, are the
+    // state, ppid, pgrp, ... and rss in pages.
+    size_t pos = stat.rfind(')');
+    if (pos == string::npos) {
+      continue;
+    }
+    istringstream fields(stat.substr(pos + 1));
+    vector<string> values;
+    string value;
+    while (fields >> value && values.size() < 22) {
+      values.push_back(value);
+    }
+    if (values.size() < 22 || atoi(values[2].c_str()) != pgid) {
+      continue;
+    }
+    uint64_t rss_mb = strtoull(values[21].c_str(), nullptr, 10) * kPageSize /
+                      (1024 * 1024);
+    max_rss_mb = max(max_rss_mb, rss_mb);
+  }
+  closedir(proc);
+  return max_rss_mb;
+}
+
+void VtsFuzzLauncher::ParseWorkerLog(const string& log_file,
+                                     RunStats* stats) {
+  ifstream in(log_file);
+  string line;
+  // the values of the status lines, e.g.
+  // "#1024 NEW cov: 120 ft: 300 corp: 20/1Kb exec/s: 512 rss: 40Mb",
+  // used if the run was killed before it printed its final stats.
+  uint64_t last_units = 0;
+  uint64_t new_lines = 0;
+  bool has_final_stats = false;
+  while (getline(in, line)) {
+    if (line.find("stat::") == 0) {
+      has_final_stats = true;
+      int64_t value = ParseValueAfter(line, ": ");
+      if (value < 0) {
+        continue;
+      }
+      if (line.find("stat::number_of_executed_units:") == 0) {
+        stats->executed_units = value;
+      } else if (line.find("stat::new_units_added:") == 0) {
+        stats->new_units = value;
+      } else if (line.find("stat::peak_rss_mb:") == 0) {
+        stats->peak_rss_mb = max<uint64_t>(stats->peak_rss_mb, value);
+      }
+      continue;
+    }
+    if (line.empty() || line[0] != '#') {
+      continue;
+    }
+    int64_t units = strtoll(line.c_str() + 1, nullptr, 10);
+    if (units > 0) {
+      last_units = units;
+    }
+    if (line.find(" NEW ") != string::npos) {
+      new_lines++;
+    }
+    int64_t coverage = ParseValueAfter(line, "cov: ");
+    if (coverage > 0) {
+      stats->coverage = coverage;
+    }
+    int64_t rss = ParseValueAfter(line, "rss: ");
+    if (rss > 0) {
+      stats->peak_rss_mb = max<uint64_t>(stats->peak_rss_mb, rss);
+    }
+  }
+  if (!has_final_stats) {
+    stats->executed_units = last_units;
+    stats->new_units = new_lines;
+  }
+}
+
+bool VtsFuzzLauncher::WriteSummary(const string& summary_file, int elapsed,
+                                   int rounds) const {
+  uint64_t executed_units = 0;
+  uint64_t new_units = 0;
+  int failures = 0;
+  Json::Value worker_list(Json::arrayValue);
+  for (const auto& worker : workers_) {
+    Json::Value obj(Json::objectValue);
+    obj["target_func"] = worker.target_func;
+    obj["runs"] = worker.runs;
+    obj["executed_units"] = Json::UInt64(worker.stats.executed_units);
+    obj["new_units"] = Json::UInt64(worker.stats.new_units);
+    obj["coverage"] = Json::UInt64(worker.stats.coverage);
+    obj["peak_rss_mb"] = Json::UInt64(worker.stats.peak_rss_mb);
+    obj["failures"] = worker.failures;
+    obj["rss_kills"] = worker.rss_kills;
+    obj["time_kills"] = worker.time_kills;
+    obj["artifact_dir"] = worker.artifact_dir;
+    worker_list.append(obj);
+    executed_units += worker.stats.executed_units;
+    new_units += worker.stats.new_units;
+    failures += worker.failures;
+  }
+
+  uint64_t merged_files = 0;
+  uint64_t new_features = 0;
+  uint64_t new_edges = 0;
+  Json::Value group_list(Json::arrayValue);
+  for (const auto& group : groups_) {
+    Json::Value obj(Json::objectValue);
+    obj["target_func"] = group.target_func;
+    obj["corpus_dir"] = group.corpus_dir;
+    obj["workers"] = Json::UInt64(group.workers.size());
+    obj["merged_files"] = Json::UInt64(group.merged_files);
+    obj["new_features"] = Json::UInt64(group.new_features);
+    obj["new_edges"] = Json::UInt64(group.new_edges);
+    group_list.append(obj);
+    merged_files += group.merged_files;
+    new_features += group.new_features;
+    new_edges += group.new_edges;
+  }
+
+  Json::Value root(Json::objectValue);
+  root["fuzzer"] = options_.fuzzer;
+  root["elapsed_secs"] = elapsed;
+  root["rounds"] = rounds;
+  root["executed_units"] = Json::UInt64(executed_units);
+  root["execs_per_sec"] =
+      elapsed > 0 ? static_cast<double>(executed_units) / elapsed : 0.0;
+  root["new_units"] = Json::UInt64(new_units);
+  root["merged_files"] = Json::UInt64(merged_files);
+  root["new_features"] = Json::UInt64(new_features);
+  root["new_edges"] = Json::UInt64(new_edges);
+  root["failures"] = failures;
+  root["groups"] = group_list;
+  root["workers"] = worker_list;
+
+  if (summary_file.empty()) {
+    cout << root.toStyledString();
+    return true;
+  }
+  ofstream out(summary_file);
+  out << root.toStyledString();
+  if (!out) {
+    cerr << __func__ << ": Failed to write summary file: " << summary_file
+         << endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TOOLS_FUZZ_LAUNCHER_VTSFUZZLAUNCHER_H_
+#define TOOLS_FUZZ_LAUNCHER_VTSFUZZLAUNCHER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+namespace android {
+namespace vts {
+
+// The options of a VtsFuzzLauncher.
+struct FuzzLauncherOptions {
+  // path of the libFuzzer binary, e.g. a generated HIDL fuzzer.
+  std::string fuzzer;
+  // the dir of the shared corpora, one sub dir per target function.
+  std::string corpus_dir;
+  // the dir of the corpora, logs and crash inputs of the workers.
+  std::string work_dir;
+  // the number of workers.
+  int workers = 1;
+  // the functions given to the workers by --vts_target_func, round robin.
+  // Empty to fuzz all the functions of the HAL in each worker.
+  std::vector<std::string> target_funcs;
+  // the total fuzzing time in seconds.
+  int max_total_time = 3600;
+  // the time in seconds between the merges of the corpora of the workers.
+  int merge_interval = 600;
+  // the RSS limit of each worker in Mb, 0 for none.
+  int rss_limit_mb = 2048;
+  // the seed of the first worker, the others get the following ones.
+  unsigned int seed = 1;
+  // the extra arguments of each run of the fuzzer.
+  std::vector<std::string> fuzzer_args;
+};
+
+// Runs several instances of a libFuzzer fuzzer in parallel, one per core,
+// each on a target function or with its own seed.
+//
+// The fuzzing runs in rounds of merge_interval seconds. In a round, each
+// worker fuzzes from the shared corpus of its function, and writes the
+// inputs it finds to its own corpus. Between rounds, the inputs of the
+// workers that add coverage are merged into the shared corpus with
+// -merge=1, so the workers of a function start the next round from the
+// inputs that all of them found.
+//
+// A worker that crashes is restarted for the rest of the round. A worker
+// that runs over its RSS limit or over the end of the round is killed.
+class VtsFuzzLauncher {
+ public:
+  explicit VtsFuzzLauncher(const FuzzLauncherOptions& options);
+  virtual ~VtsFuzzLauncher(){};
+
+  // Fuzzes for max_total_time seconds and writes the JSON summary of the
+  // fuzzing to summary_file, or to stdout if summary_file is empty.
+  //
+  // @return 0 if no worker failed, 1 if one did, -1 on error.
+  int Run(const std::string& summary_file);
+
+ private:
+  // The stats of the runs of a worker.
+  struct RunStats {
+    // the inputs executed.
+    uint64_t executed_units = 0;
+    // the inputs added to the corpus.
+    uint64_t new_units = 0;
+    // the last coverage reported by libFuzzer.
+    uint64_t coverage = 0;
+    // the peak RSS in Mb reported by libFuzzer.
+    uint64_t peak_rss_mb = 0;
+  };
+
+  // The state and the stats of a worker.
+  struct Worker {
+    // the function given by --vts_target_func, empty for all the functions.
+    std::string target_func;
+    // the dir of the inputs it found.
+    std::string corpus_dir;
+    // the dir of its crash inputs.
+    std::string artifact_dir;
+    // the libFuzzer output of its last run.
+    std::string log_file;
+    // the pid of its running fuzzer, which leads its process group, 0 if
+    // it is not running.
+    pid_t pid = 0;
+    // the number of times it was started.
+    int runs = 0;
+    // the seed of its next run.
+    unsigned int seed = 0;
+    // whether the launcher killed its running fuzzer.
+    bool killed = false;
+    // the stats of all its runs, with the largest coverage and RSS.
+    RunStats stats;
+    // the runs that crashed or failed.
+    int failures = 0;
+    // the runs killed for running over the RSS limit.
+    int rss_kills = 0;
+    // the runs killed for running over the end of the round.
+    int time_kills = 0;
+  };
+
+  // The workers fuzzing a function, which share a corpus.
+  struct WorkerGroup {
+    // the function, empty for all the functions.
+    std::string target_func;
+    // the shared corpus.
+    std::string corpus_dir;
+    // the indices of the workers in workers_.
+    std::vector<size_t> workers;
+    // the inputs merged into the shared corpus.
+    uint64_t merged_files = 0;
+    // the features and edges that the merged inputs added.
+    uint64_t new_features = 0;
+    uint64_t new_edges = 0;
+  };
+
+  // Creates the dirs and the workers.
+  bool SetUp();
+
+  // Starts a run of a worker that fuzzes for duration seconds.
+  bool StartWorker(size_t index, int duration);
+
+  // Waits for the workers until the round ends at deadline, restarting the
+  // failed ones and killing the ones over their budgets.
+  void RunRound(time_t deadline);
+
+  // Handles the exit of a worker with the given wait status.
+  void OnWorkerExit(size_t index, int status);
+
+  // Merges the corpora of the workers of a group into its shared corpus.
+  bool MergeGroup(WorkerGroup* group);
+
+  // Runs the fuzzer with args in its own process group, with its output
+  // written to log_file, and returns its pid, or -1 if it can't be run.
+  // cpu is the core the process is pinned to, -1 for none.
+  pid_t Spawn(const std::vector<std::string>& args,
+              const std::string& log_file, int cpu);
+
+  // Returns the largest RSS in Mb of the processes in the process group
+  // pgid, e.g. a worker and the children of its fork server.
+  static uint64_t GetGroupRssMb(pid_t pgid);
+
+  // Reads the stats of a run from its libFuzzer output.
+  static void ParseWorkerLog(const std::string& log_file, RunStats* stats);
+
+  // Writes the summary in JSON.
+  bool WriteSummary(const std::string& summary_file, int elapsed,
+                    int rounds) const;
+
+  FuzzLauncherOptions options_;
+  // the number of online cores.
+  int cores_;
+  std::vector<Worker> workers_;
+  std::vector<WorkerGroup> groups_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // TOOLS_FUZZ_LAUNCHER_VTSFUZZLAUNCHER_H_
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <getopt.h>
+#include <stdlib.h>
+#include <sstream>
+#include <thread>
+
+#include "VtsFuzzLauncher.h"
+
+using namespace std;
+
+void ShowUsage() {
+  printf(
+      "Usage:   vts_fuzz_launcher [options] <fuzzer> [-- <fuzzer args>]\n"
+      "Runs workers of a libFuzzer fuzzer in parallel, one per core, and "
+      "merges the inputs they find into shared corpora between rounds.\n"
+      "--corpus_dir:     The dir of the shared corpora, one sub dir per "
+      "target function (required).\n"
+      "--work_dir:       The dir of the corpora, logs and crash inputs of the "
+      "workers (required).\n"
+      "--workers:        The number of workers, 0 for one per core "
+      "(default: 0).\n"
+      "--target_funcs:   The comma-separated functions given to the workers "
+      "by --vts_target_func, round robin. All the functions are fuzzed in "
+      "each worker without it.\n"
+      "--max_total_time: The total fuzzing time in seconds (default: 3600).\n"
+      "--merge_interval: The time in seconds between the merges of the "
+      "corpora (default: 600).\n"
+      "--rss_limit_mb:   The RSS limit of each worker in Mb, 0 for none "
+      "(default: 2048).\n"
+      "--seed:           The seed of the first worker, the others get the "
+      "following ones (default: 1).\n"
+      "--summary:        The file to write the JSON summary to (default: "
+      "stdout).\n"
+      "--help:           Show help\n");
+  exit(-1);
+}
+
+int main(int argc, char** argv) {
+  android::vts::FuzzLauncherOptions options;
+  options.workers = 0;
+  string summary_file;
+
+  const char* const short_opts = "hc:w:n:f:t:i:r:s:o:";
+  const option long_opts[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"corpus_dir", required_argument, nullptr, 'c'},
+      {"work_dir", required_argument, nullptr, 'w'},
+      {"workers", required_argument, nullptr, 'n'},
+      {"target_funcs", required_argument, nullptr, 'f'},
+      {"max_total_time", required_argument, nullptr, 't'},
+      {"merge_interval", required_argument, nullptr, 'i'},
+      {"rss_limit_mb", required_argument, nullptr, 'r'},
+      {"seed", required_argument, nullptr, 's'},
+      {"summary", required_argument, nullptr, 'o'},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  while (true) {
+    int opt = getopt_long(argc, argv, short_opts, long_opts, nullptr);
+    if (opt == -1) {
+      break;
+    }
+    switch (opt) {
+      case 'h':
+      case '?':
+        ShowUsage();
+        return 0;
+      case 'c': {
+        options.corpus_dir = string(optarg);
+        break;
+      }
+      case 'w': {
+        options.work_dir = string(optarg);
+        break;
+      }
+      case 'n': {
+        options.workers = atoi(optarg);
+        break;
+      }
+      case 'f': {
+        istringstream funcs(optarg);
+        string func;
+        while (getline(funcs, func, ',')) {
+          if (!func.empty()) {
+            options.target_funcs.push_back(func);
+          }
+        }
+        break;
+      }
+      case 't': {
+        options.max_total_time = atoi(optarg);
+        break;
+      }
+      case 'i': {
+        options.merge_interval = atoi(optarg);
+        break;
+      }
+      case 'r': {
+        options.rss_limit_mb = atoi(optarg);
+        break;
+      }
+      case 's': {
+        options.seed = strtoul(optarg, nullptr, 10);
+        break;
+      }
+      case 'o': {
+        summary_file = string(optarg);
+        break;
+      }
+      default:
+        printf("getopt_long returned unexpected value: %d\n", opt);
+        return -1;
+    }
+  }
+
+  // getopt_long stops at "--", the rest are the arguments of the fuzzer.
+  if (optind >= argc) {
+    ShowUsage();
+  }
+  options.fuzzer = argv[optind++];
+  for (; optind < argc; optind++) {
+    options.fuzzer_args.push_back(argv[optind]);
+  }
+  if (options.workers == 0) {
+    options.workers = thread::hardware_concurrency();
+  }
+
+  android::vts::VtsFuzzLauncher launcher(options);
+  return launcher.Run(summary_file);
+}
@@ -15,24 +15,185 @@
  */
 #include <android/hidl/manager/1.0/IServiceManager.h>
 #include <cutils/properties.h>
+#include <dirent.h>
+#include <fcntl.h>
 #include <hidl/ServiceManagement.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #include <iostream>
+#include <map>
+#include <thread>
+
+#include "VtsHalServiceVisitor.h"
 
 using namespace std;
 using namespace android;
 
 const string kSysPropHalCoverage = "hal.coverage.enable";
 
+// The directory the HAL processes dump their gcda files to, i.e. their
+// GCOV_PREFIX.
+const string kDefaultGcovDir = "/data/misc/trace";
+
+// The time without any gcda file written after which the dumps are taken as
+// done, and the longest time to wait for them.
+const int64_t kDumpSettleMs = 250;
+const int64_t kDumpTimeoutMs = 10000;
+
 // Print usage directions.
 void usage() {
   cout << "usage:\n";
   cout << "vts_coverage_configure flush\t\t\t\t: to flush coverage on all "
           "HALs\n";
   cout << "vts_coverage_configure flush <hal name>@<hal version>\t: to flush "
-          "coverage on one HAL name/version instance"
+          "coverage on one HAL name/version instance\n";
+  cout << "options of flush:\n";
+  cout << "  --since-last\t\t: dump only the coverage since the last flush, "
+          "the gcda files of the last flush must have been collected\n";
+  cout << "  --gcov-dir=<dir>\t: the directory of the gcda files, "
+       << kDefaultGcovDir << " by default" << std::endl;
+}
+
+// The size and modification time of a gcda file.
+struct GcdaFileInfo {
+  int64_t size = 0;
+  int64_t mtime_ns = 0;
+};
+
+int64_t GetRealtimeNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Adds the gcda files under dir, recursively, to files.
+void ListGcdaFiles(const string &dir, map<string, GcdaFileInfo> *files) {
+  DIR *srcdir = opendir(dir.c_str());
+  if (!srcdir) return;
+  struct dirent *dent;
+  while ((dent = readdir(srcdir)) != NULL) {
+    if (!strcmp(dent->d_name, ".") || !strcmp(dent->d_name, "..")) {
+      continue;
+    }
+    struct stat st;
+    if (fstatat(dirfd(srcdir), dent->d_name, &st, AT_SYMLINK_NOFOLLOW) < 0) {
+      continue;
+    }
+    string path = dir + "/" + dent->d_name;
+    if (S_ISDIR(st.st_mode)) {
+      ListGcdaFiles(path, files);
+    } else if (S_ISREG(st.st_mode) && path.size() > strlen(".gcda") &&
+               path.compare(path.size() - strlen(".gcda"), string::npos,
+                            ".gcda") == 0) {
+      GcdaFileInfo &info = (*files)[path];
+      info.size = st.st_size;
+      info.mtime_ns =
+          static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL +
+          st.st_mtim.tv_nsec;
+    }
+  }
+  closedir(srcdir);
+}
+
+// Waits until no gcda file under dir was written for kDumpSettleMs, and sets
+// dumped to the files written since start_ns.
+void WaitForGcdaDumps(const string &dir, int64_t start_ns,
+                      map<string, GcdaFileInfo> *dumped) {
+  int64_t last_change_ns = GetRealtimeNs();
+  size_t last_count = 0;
+  int64_t last_mtime_ns = 0;
+  while (true) {
+    this_thread::sleep_for(chrono::milliseconds(50));
+    map<string, GcdaFileInfo> files;
+    ListGcdaFiles(dir, &files);
+    dumped->clear();
+    int64_t max_mtime_ns = 0;
+    for (const auto &file : files) {
+      if (file.second.mtime_ns >= start_ns) {
+        dumped->insert(file);
+        max_mtime_ns = max(max_mtime_ns, file.second.mtime_ns);
+      }
+    }
+    int64_t now_ns = GetRealtimeNs();
+    if (dumped->size() != last_count || max_mtime_ns != last_mtime_ns) {
+      last_count = dumped->size();
+      last_mtime_ns = max_mtime_ns;
+      last_change_ns = now_ns;
+    }
+    if (now_ns - last_change_ns >= kDumpSettleMs * 1000000LL) break;
+    if (now_ns - start_ns >= kDumpTimeoutMs * 1000000LL) {
+      cerr << "gcda files still being written after " << kDumpTimeoutMs
+           << " ms" << std::endl;
+      break;
+    }
+  }
+}
+
+// Returns the module of a gcda file, i.e. the name of its
+// <module>_intermediates directory, or its directory.
+string GetGcdaModule(const string &path) {
+  const string suffix = "_intermediates/";
+  string::size_type n = path.find(suffix);
+  if (n == string::npos) return path.substr(0, path.rfind('/'));
+  return path.substr(path.rfind('/', n) + 1, n - path.rfind('/', n) - 1);
+}
+
+// Removes the gcda files under dir of the modules whose name starts with
+// halName, e.g. android.hardware.foo@1.0-impl for android.hardware.foo@1.0,
+// or all of them if halName is empty, so that the gcda files of the HALs that
+// are not flushed are kept. As the HAL processes reset their counters when
+// they flush, the next dump of a file then holds only the coverage since the
+// last flush, instead of being merged into the file of the last one.
+void RemoveGcdaFiles(const string &dir, const string &halName) {
+  map<string, GcdaFileInfo> files;
+  ListGcdaFiles(dir, &files);
+  size_t removed = 0;
+  for (const auto &file : files) {
+    if (GetGcdaModule(file.first).compare(0, halName.size(), halName) != 0) {
+      continue;
+    }
+    if (unlink(file.first.c_str()) < 0) {
+      cerr << "failed to remove " << file.first << std::endl;
+      continue;
+    }
+    removed++;
+  }
+  cout << "- removed " << removed << " gcda files of the last flush"
        << std::endl;
 }
 
+// Prints the files and bytes dumped for each module, and the time from
+// start_ns to its last write.
+void PrintGcdaDumps(const map<string, GcdaFileInfo> &dumped,
+                    int64_t start_ns) {
+  struct ModuleDump {
+    size_t files = 0;
+    int64_t bytes = 0;
+    int64_t last_mtime_ns = 0;
+  };
+  map<string, ModuleDump> modules;
+  int64_t total_bytes = 0;
+  int64_t last_mtime_ns = start_ns;
+  for (const auto &file : dumped) {
+    ModuleDump &module = modules[GetGcdaModule(file.first)];
+    module.files++;
+    module.bytes += file.second.size;
+    module.last_mtime_ns = max(module.last_mtime_ns, file.second.mtime_ns);
+    total_bytes += file.second.size;
+    last_mtime_ns = max(last_mtime_ns, file.second.mtime_ns);
+  }
+  for (const auto &module : modules) {
+    cout << "- dumped " << module.second.files << " gcda files, "
+         << module.second.bytes << " bytes for " << module.first << " ("
+         << (module.second.last_mtime_ns - start_ns) / 1000000 << " ms)"
+         << std::endl;
+  }
+  cout << "* dumped " << dumped.size() << " gcda files, " << total_bytes
+       << " bytes of " << modules.size() << " modules in "
+       << (last_mtime_ns - start_ns) / 1000000 << " ms" << std::endl;
+}
+
 // Parse the fully-qualified instance name and call the func with the interface
 // name, instance name, and HAL name.
 template <typename Lambda>
@@ -51,11 +212,12 @@ bool parseFqInstaceName(string fqInstanceName, Lambda &&func) {
 }
 
 // Flush coverage on all HAL processes, or just the provided HAL name if
-// provided.
-bool FlushHALCoverage(string flushHal = "") {
+// provided. With sinceLast, the dumps hold only the coverage since the last
+// flush. Reports the gcda files dumped to gcovDir.
+bool FlushHALCoverage(string flushHal = "", bool sinceLast = false,
+                      const string &gcovDir = kDefaultGcovDir) {
   using ::android::hidl::base::V1_0::IBase;
   using ::android::hidl::manager::V1_0::IServiceManager;
-  using ::android::hardware::hidl_string;
   using ::android::hardware::Return;
 
   sp<IServiceManager> sm = ::android::hardware::defaultServiceManager();
@@ -64,44 +226,48 @@ bool FlushHALCoverage(string flushHal = "") {
     cerr << "failed to get IServiceManager to poke HAL services." << std::endl;
     return false;
   }
-  property_set(kSysPropHalCoverage.c_str(), "true");
-  auto listRet = sm->list([&](const auto &interfaces) {
-    for (const string &fqInstanceName : interfaces) {
-      hidl_string fqInterfaceName;
-      hidl_string instanceName;
-      string halName;
-
-      auto cb = [&](string fqIface, string instance, string hal) {
-        fqInterfaceName = fqIface;
-        instanceName = instance;
-        halName = hal;
-      };
-      if (!parseFqInstaceName(fqInstanceName, cb)) continue;
-      if (halName.find("android.hidl") == 0) continue;
-      if (flushHal == "" || !flushHal.compare(halName)) {
-        Return<sp<IBase>> interfaceRet = sm->get(fqInterfaceName, instanceName);
-        if (!interfaceRet.isOk()) {
-          cerr << "failed to get service " << fqInstanceName << ": "
-               << interfaceRet.description() << std::endl;
-          continue;
-        }
-        sp<IBase> interface = interfaceRet;
-        auto notifyRet = interface->notifySyspropsChanged();
-        if (!notifyRet.isOk()) {
-          cerr << "failed to notifySyspropsChanged on service "
-               << fqInstanceName << ": " << notifyRet.description()
-               << std::endl;
-        }
-        cout << "- flushed the coverage for HAL " << fqInstanceName
-             << std::endl;
-      }
-    }
-  });
-  property_set(kSysPropHalCoverage.c_str(), "false");
-  if (!listRet.isOk()) {
-    cerr << "failed to list services: " << listRet.description() << std::endl;
+  vector<string> allFqInstanceNames;
+  if (!vts::listHalServices(sm, &allFqInstanceNames)) {
     return false;
   }
+  vector<string> fqInstanceNames;
+  for (const string &fqInstanceName : allFqInstanceNames) {
+    string halName;
+    auto cb = [&](string, string, string hal) { halName = hal; };
+    if (!parseFqInstaceName(fqInstanceName, cb)) continue;
+    if (halName.find("android.hidl") == 0) continue;
+    if (flushHal == "" || !flushHal.compare(halName)) {
+      fqInstanceNames.push_back(fqInstanceName);
+    }
+  }
+
+  // The coverage is flushed by a sysprop change callback of the process, so
+  // one instance per process is enough.
+  vts::HalServiceVisitOptions options;
+  options.one_call_per_process = true;
+  if (sinceLast) {
+    RemoveGcdaFiles(gcovDir, flushHal);
+  }
+  property_set(kSysPropHalCoverage.c_str(), "true");
+  // The file times come from a coarse clock, which lags by up to a tick.
+  int64_t dumpStartNs = GetRealtimeNs() - 20000000LL;
+  auto start = chrono::steady_clock::now();
+  auto results = vts::visitHalServices(
+      sm, fqInstanceNames,
+      [](const sp<IBase> &interface) -> Return<void> {
+        return interface->notifySyspropsChanged();
+      },
+      options);
+  int64_t elapsedMs = chrono::duration_cast<chrono::milliseconds>(
+                          chrono::steady_clock::now() - start)
+                          .count();
+  property_set(kSysPropHalCoverage.c_str(), "false");
+  vts::printHalServiceVisitResults("flushed the coverage for HAL", results,
+                                   elapsedMs);
+  // The flush is a oneway call, so the processes dump after it returns.
+  map<string, GcdaFileInfo> dumped;
+  WaitForGcdaDumps(gcovDir, dumpStartNs, &dumped);
+  PrintGcdaDumps(dumped, dumpStartNs);
   return true;
 }
 
@@ -110,6 +276,8 @@ bool FlushHALCoverage(string flushHal = "") {
 //   To flush gcov and/or sancov coverage data on all hals: <binary> flush
 //   To flush gcov and/or sancov coverage data on one hal: <binary> flush <hal
 //   name>@<hal version>
+//   To flush only the coverage since the last flush, e.g. of one test:
+//   <binary> flush --since-last [<hal name>@<hal version>]
 int main(int argc, char *argv[]) {
   bool flush_coverage = false;
   if (argc < 2) {
@@ -119,11 +287,22 @@ int main(int argc, char *argv[]) {
   if (!strcmp(argv[1], "flush")) {
     flush_coverage = true;
     string halString = "";
-    if (argc == 3) {
-      halString = string(argv[2]);
+    bool sinceLast = false;
+    string gcovDir = kDefaultGcovDir;
+    for (int i = 2; i < argc; i++) {
+      if (!strcmp(argv[i], "--since-last")) {
+        sinceLast = true;
+      } else if (!strncmp(argv[i], "--gcov-dir=", strlen("--gcov-dir="))) {
+        gcovDir = argv[i] + strlen("--gcov-dir=");
+      } else if (halString.empty()) {
+        halString = string(argv[i]);
+      } else {
+        usage();
+        return -1;
+      }
     }
     cout << "* flush coverage" << std::endl;
-    if (!FlushHALCoverage(halString)) {
+    if (!FlushHALCoverage(halString, sinceLast, gcovDir)) {
       cerr << "failed to flush coverage" << std::endl;
     }
   } else {
@@ -0,0 +1,363 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsCompactTrace.h"
+
+#include <string.h>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Size of an event chunk, excluding the chunk type and the arguments.
+static constexpr size_t kCompactEventSize = 16;
+
+static void appendVarint32(uint32_t value, string* out) {
+  // A varint32 takes at most 5 bytes.
+  uint8_t buffer[5];
+  uint8_t* end = CodedOutputStream::WriteVarint32ToArray(value, buffer);
+  out->append(reinterpret_cast<char*>(buffer), end - buffer);
+}
+
+static void appendVarint64(uint64_t value, string* out) {
+  // A varint64 takes at most 10 bytes.
+  uint8_t buffer[10];
+  uint8_t* end = CodedOutputStream::WriteVarint64ToArray(value, buffer);
+  out->append(reinterpret_cast<char*>(buffer), end - buffer);
+}
+
+static void appendFixed(uint64_t value, size_t size, string* out) {
+  for (size_t i = 0; i < size; i++) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+static uint64_t readFixed(const uint8_t* buffer, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; i++) {
+    value |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+  }
+  return value;
+}
+
+bool isCompactTrace(google::protobuf::io::ZeroCopyInputStream* in) {
+  const void* data;
+  int size;
+  if (!in->Next(&data, &size)) {
+    return false;
+  }
+  bool compact = size >= 0 && hasCompactTraceMagic(data, size);
+  in->BackUp(size);
+  return compact;
+}
+
+void VtsCompactTraceEncoder::EncodeHeader(string* out) {
+  out->append(kCompactTraceMagic, kCompactTraceMagicSize);
+}
+
+void VtsCompactTraceEncoder::EncodeClock(const VtsTraceClockCalibration& clock,
+                                         string* out) {
+  out->push_back(kCompactChunkClock);
+  appendVarint32(clock.source, out);
+  appendVarint64(clock.ticks_per_second, out);
+  appendFixed(clock.anchor_ticks, 8, out);
+  appendFixed(clock.anchor_monotonic_ns, 8, out);
+  appendFixed(clock.anchor_realtime_ns, 8, out);
+}
+
+uint32_t VtsCompactTraceEncoder::GetStringId(const string& str, string* out) {
+  auto found = string_ids_.find(str);
+  if (found != string_ids_.end()) {
+    return found->second;
+  }
+  uint32_t id = string_ids_.size();
+  string_ids_.emplace(str, id);
+  out->push_back(kCompactChunkString);
+  appendVarint32(id, out);
+  appendVarint32(str.size(), out);
+  out->append(str);
+  return id;
+}
+
+uint32_t VtsCompactTraceEncoder::GetHalId(const string& package,
+                                          int version_major,
+                                          int version_minor,
+                                          const string& interface,
+                                          string* out) {
+  uint32_t package_id = GetStringId(package, out);
+  uint32_t interface_id = GetStringId(interface, out);
+  auto key = make_tuple(package_id, version_major, version_minor, interface_id);
+  auto found = hal_ids_.find(key);
+  if (found != hal_ids_.end()) {
+    return found->second;
+  }
+  uint32_t id = hal_ids_.size();
+  hal_ids_.emplace(key, id);
+  out->push_back(kCompactChunkHal);
+  appendVarint32(id, out);
+  appendVarint32(package_id, out);
+  appendVarint32(WireFormatLite::ZigZagEncode32(version_major), out);
+  appendVarint32(WireFormatLite::ZigZagEncode32(version_minor), out);
+  appendVarint32(interface_id, out);
+  return id;
+}
+
+void VtsCompactTraceEncoder::EncodeEvent(
+    int64_t timestamp, int event_type, uint32_t hal_id,
+    const FunctionSpecificationMessage& func_msg, int32_t thread_id,
+    uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+    string* definitions, string* out) {
+  uint32_t method_id = GetStringId(func_msg.name(), definitions);
+  auto found = last_timestamps_.find(thread_id);
+  int64_t last_timestamp =
+      found == last_timestamps_.end() ? kNoTimestamp : found->second;
+  EncodeEventWithIds(timestamp, &last_timestamp, event_type, hal_id, method_id,
+                     func_msg, thread_id, call_id, cpu_sample, out);
+  last_timestamps_[thread_id] = last_timestamp;
+}
+
+void VtsCompactTraceEncoder::EncodeEventWithIds(
+    int64_t timestamp, int64_t* last_timestamp, int event_type,
+    uint32_t hal_id, uint32_t method_id,
+    const FunctionSpecificationMessage& func_msg, int32_t thread_id,
+    uint64_t call_id, const VtsThreadCpuSample& cpu_sample, string* out) {
+  // Start from a new base timestamp if the delta does not fit.
+  if (*last_timestamp == kNoTimestamp || timestamp < *last_timestamp ||
+      static_cast<uint64_t>(timestamp - *last_timestamp) > UINT32_MAX) {
+    out->push_back(kCompactChunkTimestamp);
+    appendVarint32(thread_id, out);
+    appendFixed(timestamp, 8, out);
+    *last_timestamp = timestamp;
+  }
+  uint32_t delta = timestamp - *last_timestamp;
+  *last_timestamp = timestamp;
+
+  // The name is the first field of the serialized message, skip it as the
+  // method id already identifies it.
+  size_t message_size = func_msg.ByteSize();
+  size_t name_size = 0;
+  if (func_msg.has_name()) {
+    name_size = WireFormatLite::TagSize(
+                    FunctionSpecificationMessage::kNameFieldNumber,
+                    WireFormatLite::TYPE_BYTES) +
+                WireFormatLite::LengthDelimitedSize(func_msg.name().size());
+  }
+  size_t args_size = message_size - name_size;
+
+  out->push_back(kCompactChunkEvent);
+  appendFixed(delta, 4, out);
+  appendFixed(event_type, 1, out);
+  bool has_cpu_time = cpu_sample.cpu_time_ns >= 0;
+  appendFixed((args_size > 0 ? kCompactEventHasArgs : 0) |
+                  (call_id != 0 ? kCompactEventHasCallId : 0) |
+                  (has_cpu_time ? kCompactEventHasCpuTime : 0),
+              1, out);
+  appendFixed(hal_id, 2, out);
+  appendFixed(method_id, 4, out);
+  appendFixed(thread_id, 4, out);
+  if (call_id != 0) {
+    appendVarint64(call_id, out);
+  }
+  if (has_cpu_time) {
+    appendVarint64(cpu_sample.cpu_time_ns, out);
+    appendVarint32(cpu_sample.cpu, out);
+  }
+  if (args_size == 0) {
+    return;
+  }
+  appendVarint32(args_size, out);
+  size_t offset = out->size();
+  out->resize(offset + message_size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(&(*out)[offset]);
+  func_msg.SerializeWithCachedSizesToArray(target);
+  out->erase(offset, name_size);
+}
+
+void VtsCompactTraceEncoder::EncodeRecord(const VtsProfilingRecord& record,
+                                          string* out) {
+  uint32_t hal_id =
+      GetHalId(record.package(), record.version_major(),
+               record.version_minor(), record.interface(), out);
+  VtsThreadCpuSample cpu_sample;
+  if (record.has_thread_cpu_time()) {
+    cpu_sample.cpu_time_ns = record.thread_cpu_time();
+    cpu_sample.cpu = record.cpu();
+  }
+  EncodeEvent(record.timestamp(), record.event(), hal_id, record.func_msg(),
+              record.thread_id(), record.call_id(), cpu_sample, out, out);
+}
+
+bool VtsCompactTraceDecoder::ReadHeader() {
+  CodedInputStream input(in_);
+  string magic;
+  if (!input.ReadString(&magic, kCompactTraceMagicSize) ||
+      !hasCompactTraceMagic(magic.data(), magic.size())) {
+    error_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool VtsCompactTraceDecoder::ReadRecord(VtsProfilingRecord* record,
+                                        int32_t* thread_id) {
+  // We create a new coded stream for each event so that the total size limit
+  // of the coded stream is imposed per event.
+  CodedInputStream input(in_);
+  uint8_t type;
+  while (input.ReadRaw(&type, 1)) {
+    switch (type) {
+      case kCompactChunkClock: {
+        VtsTraceClockCalibration clock;
+        uint64_t anchor_ticks, anchor_monotonic_ns, anchor_realtime_ns;
+        if (!input.ReadVarint32(&clock.source) ||
+            !input.ReadVarint64(&clock.ticks_per_second) ||
+            clock.ticks_per_second == 0 ||
+            !input.ReadLittleEndian64(&anchor_ticks) ||
+            !input.ReadLittleEndian64(&anchor_monotonic_ns) ||
+            !input.ReadLittleEndian64(&anchor_realtime_ns)) {
+          error_ = true;
+          return false;
+        }
+        clock.anchor_ticks = anchor_ticks;
+        clock.anchor_monotonic_ns = anchor_monotonic_ns;
+        clock.anchor_realtime_ns = anchor_realtime_ns;
+        clock_ = clock;
+        break;
+      }
+      case kCompactChunkString: {
+        uint32_t id, size;
+        string str;
+        if (!input.ReadVarint32(&id) || id != strings_.size() ||
+            !input.ReadVarint32(&size) || !input.ReadString(&str, size)) {
+          error_ = true;
+          return false;
+        }
+        strings_.push_back(move(str));
+        break;
+      }
+      case kCompactChunkHal: {
+        uint32_t id, major, minor;
+        Hal hal;
+        if (!input.ReadVarint32(&id) || id != hals_.size() ||
+            !input.ReadVarint32(&hal.package_id) ||
+            !input.ReadVarint32(&major) || !input.ReadVarint32(&minor) ||
+            !input.ReadVarint32(&hal.interface_id) ||
+            hal.package_id >= strings_.size() ||
+            hal.interface_id >= strings_.size()) {
+          error_ = true;
+          return false;
+        }
+        hal.version_major = WireFormatLite::ZigZagDecode32(major);
+        hal.version_minor = WireFormatLite::ZigZagDecode32(minor);
+        hals_.push_back(hal);
+        break;
+      }
+      case kCompactChunkTimestamp: {
+        uint32_t thread;
+        uint64_t timestamp;
+        if (!input.ReadVarint32(&thread) ||
+            !input.ReadLittleEndian64(&timestamp)) {
+          error_ = true;
+          return false;
+        }
+        last_timestamps_[static_cast<int32_t>(thread)] = timestamp;
+        break;
+      }
+      case kCompactChunkEvent: {
+        uint8_t buffer[kCompactEventSize];
+        if (!input.ReadRaw(buffer, sizeof(buffer))) {
+          error_ = true;
+          return false;
+        }
+        uint32_t delta = readFixed(buffer, 4);
+        int event_type = buffer[4];
+        uint8_t flags = buffer[5];
+        uint32_t hal_id = readFixed(buffer + 6, 2);
+        uint32_t method_id = readFixed(buffer + 8, 4);
+        int32_t thread = static_cast<int32_t>(readFixed(buffer + 12, 4));
+        auto last_timestamp = last_timestamps_.find(thread);
+        if (hal_id >= hals_.size() || method_id >= strings_.size() ||
+            last_timestamp == last_timestamps_.end() ||
+            !InstrumentationEventType_IsValid(event_type)) {
+          error_ = true;
+          return false;
+        }
+        last_timestamp->second += delta;
+
+        record->Clear();
+        if (flags & kCompactEventHasCallId) {
+          uint64_t call_id;
+          if (!input.ReadVarint64(&call_id)) {
+            error_ = true;
+            return false;
+          }
+          record->set_call_id(call_id);
+        }
+        if (flags & kCompactEventHasCpuTime) {
+          uint64_t cpu_time;
+          uint32_t cpu;
+          if (!input.ReadVarint64(&cpu_time) || !input.ReadVarint32(&cpu)) {
+            error_ = true;
+            return false;
+          }
+          record->set_thread_cpu_time(cpu_time);
+          record->set_cpu(static_cast<int32_t>(cpu));
+        }
+        if (flags & kCompactEventHasArgs) {
+          uint32_t size;
+          if (!input.ReadVarint32(&size)) {
+            error_ = true;
+            return false;
+          }
+          // The end of a truncated trace also ends the parsing cleanly.
+          auto limit = input.PushLimit(size);
+          if (!record->mutable_func_msg()->MergeFromCodedStream(&input) ||
+              !input.ConsumedEntireMessage() || input.BytesUntilLimit() != 0) {
+            error_ = true;
+            return false;
+          }
+          input.PopLimit(limit);
+        }
+        const Hal& hal = hals_[hal_id];
+        record->set_timestamp(clock_.TicksToNs(last_timestamp->second));
+        record->set_event(static_cast<InstrumentationEventType>(event_type));
+        record->set_package(strings_[hal.package_id]);
+        record->set_version_major(hal.version_major);
+        record->set_version_minor(hal.version_minor);
+        record->set_interface(strings_[hal.interface_id]);
+        record->mutable_func_msg()->set_name(strings_[method_id]);
+        record->set_thread_id(thread);
+        if (thread_id != nullptr) {
+          *thread_id = thread;
+        }
+        return true;
+      }
+      default:
+        error_ = true;
+        return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace vts
+}  // namespace android
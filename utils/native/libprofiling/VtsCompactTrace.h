@@ -0,0 +1,210 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_PROFILING_COMPACT_TRACE_H_
+#define __VTS_PROFILING_COMPACT_TRACE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "VtsTraceClock.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "test/vts/proto/VtsProfilingMessage.pb.h"
+
+// This file defines the compact (v2) trace format, an alternative to the
+// delimited VtsProfilingRecord format that does not repeat the package,
+// interface and method names in every record.
+//
+// A compact trace starts with the 8 bytes kCompactTraceMagic, followed by a
+// sequence of chunks. Each chunk starts with a one byte type:
+//   'S' string:     varint id, varint size, bytes.
+//   'H' HAL:        varint id, varint package string id, zigzag varint major
+//                   version, zigzag varint minor version, varint interface
+//                   string id.
+//   'C' clock:      varint clock source, varint64 ticks per second, fixed64
+//                   anchor ticks, fixed64 anchor CLOCK_MONOTONIC ns, fixed64
+//                   anchor CLOCK_REALTIME ns, see VtsTraceClockCalibration.
+//                   The timestamps of the events that follow are in the
+//                   ticks of the clock.
+//   'T' timestamp:  varint thread id, fixed64 timestamp. Sets the timestamp
+//                   the next event of the thread is relative to.
+//   'E' event:      fixed32 timestamp delta, uint8 event type, uint8 flags,
+//                   fixed16 HAL id, fixed32 method string id, fixed32 thread
+//                   id, followed by varint64 call id if flags has
+//                   kCompactEventHasCallId, then by varint64 thread CPU time
+//                   and varint CPU if flags has kCompactEventHasCpuTime, then
+//                   by varint size and the serialized
+//                   FunctionSpecificationMessage without its name if flags
+//                   has kCompactEventHasArgs.
+// All fixed width values are little endian. Strings and HALs are defined
+// before the events that refer to them. The timestamp delta of an event is
+// relative to the previous event of the same thread, so the events of
+// different threads may be interleaved in any order. The timestamps are in
+// CLOCK_MONOTONIC nano seconds until a clock chunk says otherwise; the
+// decoder converts them to nano seconds.
+//
+// No delimited trace can start with kCompactTraceMagic, as 'T' is not a valid
+// tag for a VtsProfilingRecord field.
+//
+// Traces written before the clock chunk start with kCompactTraceMagicV2
+// instead. They are still decoded, since they only lack the clock chunks,
+// while older decoders reject the traces that may have them.
+namespace android {
+namespace vts {
+
+static constexpr char kCompactTraceMagic[] = "VTSTRC03";
+static constexpr char kCompactTraceMagicV2[] = "VTSTRC02";
+static constexpr size_t kCompactTraceMagicSize = sizeof(kCompactTraceMagic) - 1;
+
+// Returns whether the size bytes at data start with the magic of a compact
+// trace of any version.
+inline bool hasCompactTraceMagic(const void* data, size_t size) {
+  return size >= kCompactTraceMagicSize &&
+         (memcmp(data, kCompactTraceMagic, kCompactTraceMagicSize) == 0 ||
+          memcmp(data, kCompactTraceMagicV2, kCompactTraceMagicSize) == 0);
+}
+
+static constexpr char kCompactChunkClock = 'C';
+static constexpr char kCompactChunkString = 'S';
+static constexpr char kCompactChunkHal = 'H';
+static constexpr char kCompactChunkTimestamp = 'T';
+static constexpr char kCompactChunkEvent = 'E';
+
+// Set in the flags of an event that carries the arguments or return values.
+static constexpr uint8_t kCompactEventHasArgs = 1;
+// Set in the flags of an event that carries the id of its call.
+static constexpr uint8_t kCompactEventHasCallId = 2;
+// Set in the flags of an event that carries the CPU time of its thread and
+// its CPU.
+static constexpr uint8_t kCompactEventHasCpuTime = 4;
+
+// Returns whether the trace read from in is a compact trace, without
+// consuming any data. Expects the first buffer of in to hold the header.
+bool isCompactTrace(google::protobuf::io::ZeroCopyInputStream* in);
+
+// Encodes trace events in the compact format. One encoder must be used per
+// trace file, as ids are assigned in the order the strings and HALs are
+// first seen. Not thread-safe.
+class VtsCompactTraceEncoder {
+ public:
+  VtsCompactTraceEncoder() {}
+
+  // Appends the header of the trace file to out.
+  void EncodeHeader(std::string* out);
+
+  // Appends the calibration of the clock of the timestamps of the events
+  // encoded next to out.
+  void EncodeClock(const VtsTraceClockCalibration& clock, std::string* out);
+
+  // Returns the id of the given string, appending its definition to out if
+  // it is new.
+  uint32_t GetStringId(const std::string& str, std::string* out);
+
+  // Returns the id of the given HAL interface, appending its definition
+  // (and the definitions of its strings) to out if it is new.
+  uint32_t GetHalId(const std::string& package, int version_major,
+                    int version_minor, const std::string& interface,
+                    std::string* out);
+
+  // Appends an event for the given HAL id, with func_msg as the called
+  // method, to out. Assigns an id to the method name if needed, in which
+  // case the definition of the name is appended to definitions (which may be
+  // out itself). call_id is only encoded if not 0, and cpu_sample if
+  // captured.
+  void EncodeEvent(int64_t timestamp, int event_type, uint32_t hal_id,
+                   const FunctionSpecificationMessage& func_msg,
+                   int32_t thread_id, uint64_t call_id,
+                   const VtsThreadCpuSample& cpu_sample,
+                   std::string* definitions, std::string* out);
+
+  // The last timestamp of a thread without any event yet.
+  static constexpr int64_t kNoTimestamp = INT64_MIN;
+
+  // Same as EncodeEvent, for the method whose name has id method_id, with
+  // last_timestamp holding the timestamp of the previous event of the thread
+  // in the trace file, or kNoTimestamp, updated to timestamp. Does not use
+  // the state of an encoder, so the events of several threads may be encoded
+  // at once, each with its own last_timestamp, once their ids are known.
+  static void EncodeEventWithIds(int64_t timestamp, int64_t* last_timestamp,
+                                 int event_type, uint32_t hal_id,
+                                 uint32_t method_id,
+                                 const FunctionSpecificationMessage& func_msg,
+                                 int32_t thread_id, uint64_t call_id,
+                                 const VtsThreadCpuSample& cpu_sample,
+                                 std::string* out);
+
+  // Appends the given record to out, with the definitions it needs.
+  void EncodeRecord(const VtsProfilingRecord& record, std::string* out);
+
+ private:
+  // Ids of the strings seen so far.
+  std::unordered_map<std::string, uint32_t> string_ids_;
+  // Ids of the HALs seen so far, keyed by package string id, major version,
+  // minor version and interface string id.
+  std::map<std::tuple<uint32_t, int, int, uint32_t>, uint32_t> hal_ids_;
+  // Timestamp of the last event of each thread.
+  std::unordered_map<int32_t, int64_t> last_timestamps_;
+};
+
+// Decodes the records of a compact trace.
+class VtsCompactTraceDecoder {
+ public:
+  explicit VtsCompactTraceDecoder(
+      google::protobuf::io::ZeroCopyInputStream* in)
+      : in_(in) {}
+
+  // Reads and checks the header. Must be called before ReadRecord.
+  bool ReadHeader();
+
+  // Reads the next event into record, including the id of the thread that
+  // traced it, also set into thread_id (if not nullptr). The timestamp of
+  // the record is converted to CLOCK_MONOTONIC nano seconds. Returns false at
+  // the end of the trace or on error, in which case HadError() returns true.
+  bool ReadRecord(VtsProfilingRecord* record, int32_t* thread_id);
+
+  bool HadError() const { return error_; }
+
+  // The calibration of the clock of the last record read, e.g. to convert
+  // its timestamp to CLOCK_REALTIME to align it with other traces.
+  const VtsTraceClockCalibration& Clock() const { return clock_; }
+
+ private:
+  struct Hal {
+    uint32_t package_id;
+    int version_major;
+    int version_minor;
+    uint32_t interface_id;
+  };
+
+  // Not owned.
+  google::protobuf::io::ZeroCopyInputStream* in_;
+  // Strings and HALs indexed by id.
+  std::vector<std::string> strings_;
+  std::vector<Hal> hals_;
+  // Timestamp of the last event of each thread, in ticks of clock_.
+  std::unordered_map<int32_t, int64_t> last_timestamps_;
+  VtsTraceClockCalibration clock_;
+  bool error_ = false;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_COMPACT_TRACE_H_
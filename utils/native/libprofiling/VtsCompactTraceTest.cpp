@@ -0,0 +1,248 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "VtsCompactTrace.h"
+#include "VtsProfilingUtil.h"
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <gtest/gtest.h>
+
+using google::protobuf::io::ArrayInputStream;
+using google::protobuf::io::StringOutputStream;
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Size of an event chunk without call id, CPU time or arguments.
+static constexpr size_t kPlainEventSize = 17;
+
+// Unit test of the encoding and decoding of compact traces.
+class VtsCompactTraceTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // Two threads with interleaved events, one with and one without
+    // arguments, call id and CPU time, and a delta above UINT32_MAX.
+    AddRecord(1000, 10, "android.hardware.foo", 1, 0, "IFoo", "open", 0);
+    AddRecord(500, 20, "android.hardware.bar", 2, 1, "IBar", "close", 0);
+    VtsProfilingRecord* record =
+        AddRecord(6000, 10, "android.hardware.foo", 1, 0, "IFoo", "write", 7);
+    VariableSpecificationMessage* arg = record->mutable_func_msg()->add_arg();
+    arg->set_type(TYPE_VECTOR);
+    arg->set_vector_size(3);
+    arg->set_vector_raw_value("abc");
+    record->set_thread_cpu_time(123456);
+    record->set_cpu(3);
+    AddRecord(6000 + (1LL << 32) + 5, 10, "android.hardware.foo", 1, 0,
+              "IFoo", "open", 8);
+    AddRecord(700, 20, "android.hardware.foo", 1, 0, "IFoo2", "open", 0);
+
+    VtsCompactTraceEncoder encoder;
+    encoder.EncodeHeader(&trace_);
+    for (const auto& record : records_) {
+      encoder.EncodeRecord(record, &trace_);
+    }
+  }
+
+  VtsProfilingRecord* AddRecord(int64_t timestamp, int32_t thread_id,
+                                const string& package, int version_major,
+                                int version_minor, const string& interface,
+                                const string& method, uint64_t call_id) {
+    records_.emplace_back();
+    VtsProfilingRecord* record = &records_.back();
+    record->set_timestamp(timestamp);
+    record->set_event(records_.size() % 2 ? SERVER_API_ENTRY
+                                          : SERVER_API_EXIT);
+    record->set_package(package);
+    record->set_version_major(version_major);
+    record->set_version_minor(version_minor);
+    record->set_interface(interface);
+    record->mutable_func_msg()->set_name(method);
+    record->set_thread_id(thread_id);
+    if (call_id != 0) {
+      record->set_call_id(call_id);
+    }
+    return record;
+  }
+
+  // Decodes the records of the first size bytes of trace_ into records.
+  // Returns false if the decoder fails.
+  bool Decode(size_t size, vector<VtsProfilingRecord>* records) {
+    ArrayInputStream in(trace_.data(), size);
+    VtsCompactTraceDecoder decoder(&in);
+    if (!decoder.ReadHeader()) {
+      return false;
+    }
+    VtsProfilingRecord record;
+    int32_t thread_id;
+    while (decoder.ReadRecord(&record, &thread_id)) {
+      EXPECT_EQ(record.thread_id(), thread_id);
+      records->push_back(record);
+    }
+    return !decoder.HadError();
+  }
+
+  vector<VtsProfilingRecord> records_;
+  string trace_;
+};
+
+// Tests that decoding gives the records written to a delimited trace.
+TEST_F(VtsCompactTraceTest, RoundTrip) {
+  string delimited;
+  {
+    StringOutputStream out(&delimited);
+    for (const auto& record : records_) {
+      ASSERT_TRUE(writeOneDelimited(record, &out));
+    }
+  }
+  vector<VtsProfilingRecord> decoded;
+  ASSERT_TRUE(Decode(trace_.size(), &decoded));
+  ASSERT_EQ(records_.size(), decoded.size());
+  ArrayInputStream in(delimited.data(), delimited.size());
+  for (const auto& record : decoded) {
+    VtsProfilingRecord expected;
+    ASSERT_TRUE(readOneDelimited(&expected, &in));
+    EXPECT_EQ(expected.SerializeAsString(), record.SerializeAsString())
+        << expected.DebugString() << record.DebugString();
+  }
+}
+
+// Tests that the strings and HALs are defined once.
+TEST_F(VtsCompactTraceTest, Interning) {
+  VtsCompactTraceEncoder encoder;
+  string out;
+  uint32_t foo = encoder.GetHalId("android.hardware.foo", 1, 0, "IFoo", &out);
+  EXPECT_FALSE(out.empty());
+  out.clear();
+  EXPECT_EQ(foo, encoder.GetHalId("android.hardware.foo", 1, 0, "IFoo", &out));
+  EXPECT_TRUE(out.empty());
+  // Another version is another HAL, which reuses the strings.
+  uint32_t foo_1_1 =
+      encoder.GetHalId("android.hardware.foo", 1, 1, "IFoo", &out);
+  EXPECT_NE(foo, foo_1_1);
+  ASSERT_FALSE(out.empty());
+  EXPECT_EQ(kCompactChunkHal, out[0]);
+  EXPECT_EQ(string::npos, out.find(kCompactChunkString));
+  out.clear();
+  uint32_t package = encoder.GetStringId("android.hardware.foo", &out);
+  EXPECT_TRUE(out.empty());
+  EXPECT_NE(package, encoder.GetStringId("IFoo2", &out));
+  EXPECT_FALSE(out.empty());
+
+  // Only the first event of a method defines its name.
+  FunctionSpecificationMessage message;
+  message.set_name("open");
+  VtsThreadCpuSample cpu_sample;
+  string definitions;
+  out.clear();
+  encoder.EncodeEvent(1000, SERVER_API_ENTRY, foo, message, 10, 0,
+                      cpu_sample, &definitions, &out);
+  EXPECT_FALSE(definitions.empty());
+  definitions.clear();
+  out.clear();
+  encoder.EncodeEvent(1001, SERVER_API_EXIT, foo, message, 10, 0, cpu_sample,
+                      &definitions, &out);
+  EXPECT_TRUE(definitions.empty());
+  EXPECT_EQ(kPlainEventSize, out.size());
+}
+
+// Tests that a delta above UINT32_MAX starts from a new base timestamp, as
+// does the first event of a thread and an event back in time.
+TEST_F(VtsCompactTraceTest, TimestampDeltas) {
+  FunctionSpecificationMessage message;
+  message.set_name("open");
+  VtsThreadCpuSample cpu_sample;
+  int64_t last_timestamp = VtsCompactTraceEncoder::kNoTimestamp;
+  string out;
+  VtsCompactTraceEncoder::EncodeEventWithIds(
+      100, &last_timestamp, SERVER_API_ENTRY, 0, 0, message, 10, 0,
+      cpu_sample, &out);
+  EXPECT_EQ(kCompactChunkTimestamp, out[0]);
+  EXPECT_EQ(100, last_timestamp);
+  for (int64_t delta : {int64_t(0), int64_t(UINT32_MAX)}) {
+    out.clear();
+    VtsCompactTraceEncoder::EncodeEventWithIds(
+        last_timestamp + delta, &last_timestamp, SERVER_API_ENTRY, 0, 0,
+        message, 10, 0, cpu_sample, &out);
+    EXPECT_EQ(kPlainEventSize, out.size());
+  }
+  for (int64_t delta : {int64_t(UINT32_MAX) + 1, int64_t(-1)}) {
+    int64_t timestamp = last_timestamp + delta;
+    out.clear();
+    VtsCompactTraceEncoder::EncodeEventWithIds(
+        timestamp, &last_timestamp, SERVER_API_ENTRY, 0, 0, message, 10, 0,
+        cpu_sample, &out);
+    EXPECT_EQ(kCompactChunkTimestamp, out[0]);
+    EXPECT_EQ(timestamp, last_timestamp);
+  }
+
+  vector<VtsProfilingRecord> decoded;
+  ASSERT_TRUE(Decode(trace_.size(), &decoded));
+  ASSERT_EQ(records_.size(), decoded.size());
+  EXPECT_EQ(6000 + (1LL << 32) + 5, decoded[3].timestamp());
+}
+
+// Tests that a truncated trace gives the records before the cut and an
+// error if the cut is within a chunk.
+TEST_F(VtsCompactTraceTest, Truncated) {
+  vector<VtsProfilingRecord> decoded;
+  EXPECT_FALSE(Decode(kCompactTraceMagicSize - 1, &decoded));
+  EXPECT_TRUE(Decode(kCompactTraceMagicSize, &decoded));
+  EXPECT_TRUE(decoded.empty());
+  for (size_t size = kCompactTraceMagicSize; size < trace_.size(); size++) {
+    decoded.clear();
+    Decode(size, &decoded);
+    ASSERT_LT(decoded.size(), records_.size());
+    for (size_t i = 0; i < decoded.size(); i++) {
+      EXPECT_EQ(records_[i].SerializeAsString(),
+                decoded[i].SerializeAsString());
+    }
+  }
+  decoded.clear();
+  EXPECT_FALSE(Decode(trace_.size() - 1, &decoded));
+  EXPECT_EQ(records_.size() - 1, decoded.size());
+}
+
+// Tests that the traces with the magic of the version before the clock chunk
+// are still decoded, and that those of other versions are not.
+TEST_F(VtsCompactTraceTest, Magic) {
+  vector<VtsProfilingRecord> decoded;
+  trace_.replace(0, kCompactTraceMagicSize, kCompactTraceMagicV2);
+  EXPECT_TRUE(Decode(trace_.size(), &decoded));
+  EXPECT_EQ(records_.size(), decoded.size());
+  for (const char* magic : {"VTSTRC01", "VTSTRC04", "VTSIDX01"}) {
+    trace_.replace(0, kCompactTraceMagicSize, magic);
+    EXPECT_FALSE(hasCompactTraceMagic(trace_.data(), trace_.size()));
+    decoded.clear();
+    EXPECT_FALSE(Decode(trace_.size(), &decoded));
+    EXPECT_TRUE(decoded.empty());
+  }
+
+  // A delimited trace is not taken for a compact one.
+  string delimited;
+  {
+    StringOutputStream out(&delimited);
+    ASSERT_TRUE(writeOneDelimited(records_[0], &out));
+  }
+  ArrayInputStream in(delimited.data(), delimited.size());
+  EXPECT_FALSE(isCompactTrace(&in));
+}
+
+}  // namespace vts
+}  // namespace android
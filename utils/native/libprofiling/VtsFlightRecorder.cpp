@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsFlightRecorder.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Writes all of the size bytes at data to fd with write only.
+static bool writeFully(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = TEMP_FAILURE_RETRY(write(fd, data, size));
+    if (written < 0) {
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+VtsFlightRecorder::VtsFlightRecorder(size_t capacity)
+    : capacity_(capacity),
+      buffer_(new char[capacity]),
+      head_(0),
+      size_(0),
+      evicted_count_(0) {}
+
+bool VtsFlightRecorder::Append(const string& record) {
+  if (record.size() > capacity_) {
+    evicted_count_++;
+    return false;
+  }
+  while (capacity_ - size_ < record.size()) {
+    EvictRecord();
+  }
+  // Copy the record into the free space after the held bytes, in two parts
+  // if it wraps around.
+  size_t tail = (head_ + size_) % capacity_;
+  size_t first_part = min(record.size(), capacity_ - tail);
+  memcpy(&buffer_[tail], record.data(), first_part);
+  memcpy(&buffer_[0], record.data() + first_part, record.size() - first_part);
+  size_ += record.size();
+  return true;
+}
+
+void VtsFlightRecorder::EvictRecord() {
+  // Decode the varint size of the record.
+  size_t record_size = 0;
+  size_t header_size = 0;
+  for (int shift = 0; header_size < size_ && shift < 64; shift += 7) {
+    uint8_t byte = buffer_[(head_ + header_size++) % capacity_];
+    record_size |= static_cast<size_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+  size_t evicted = min(size_, header_size + record_size);
+  head_ = (head_ + evicted) % capacity_;
+  size_ -= evicted;
+  evicted_count_++;
+}
+
+void VtsFlightRecorder::Read(string* out) const {
+  size_t first_part = min(size_, capacity_ - head_);
+  out->append(&buffer_[head_], first_part);
+  out->append(&buffer_[0], size_ - first_part);
+}
+
+bool VtsFlightRecorder::WriteTo(int fd) const {
+  size_t first_part = min(size_, capacity_ - head_);
+  return writeFully(fd, &buffer_[head_], first_part) &&
+         writeFully(fd, &buffer_[0], size_ - first_part);
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __VTS_PROFILING_FLIGHT_RECORDER_H_
+#define __VTS_PROFILING_FLIGHT_RECORDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+namespace android {
+namespace vts {
+
+// Default capacity of a flight recorder, in bytes.
+static constexpr size_t kDefaultFlightRecorderCapacity = 1024 * 1024;
+
+// A fixed-size in-memory ring of the most recent records of a trace, where
+// each record starts with its size as a varint, as the delimited
+// VtsProfilingRecord of the trace files do. Appending a record evicts the
+// oldest ones that do not fit any more, so that the ring always holds a valid
+// trace of the latest records. The memory is allocated once by the
+// constructor and no I/O is done until the records are written out.
+//
+// Not thread-safe, the caller synchronizes the calls.
+class VtsFlightRecorder {
+ public:
+  explicit VtsFlightRecorder(size_t capacity);
+
+  VtsFlightRecorder(const VtsFlightRecorder&) = delete;
+  VtsFlightRecorder& operator=(const VtsFlightRecorder&) = delete;
+
+  // Appends a delimited record. A record larger than the capacity is
+  // dropped, and returns false.
+  bool Append(const std::string& record);
+
+  // Appends the records held, from the oldest one, to out.
+  void Read(std::string* out) const;
+
+  // Writes the records held, from the oldest one, to fd. Only calls write,
+  // so that it can be called from a signal handler. Returns false on error.
+  bool WriteTo(int fd) const;
+
+  size_t Capacity() const { return capacity_; }
+  // Number of bytes held.
+  size_t Size() const { return size_; }
+  // Number of records evicted or dropped so far.
+  uint64_t EvictedCount() const { return evicted_count_; }
+
+ private:
+  // Evicts the oldest record.
+  void EvictRecord();
+
+  const size_t capacity_;
+  std::unique_ptr<char[]> buffer_;
+  // Offset of the oldest record in buffer_, and the number of bytes held
+  // from it, wrapping around the end of buffer_.
+  size_t head_;
+  size_t size_;
+  uint64_t evicted_count_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_FLIGHT_RECORDER_H_
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsHalServiceVisitor.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace std;
+using ::android::hardware::hidl_string;
+using ::android::hardware::Return;
+using ::android::hidl::base::V1_0::DebugInfo;
+using ::android::hidl::base::V1_0::IBase;
+using ::android::hidl::manager::V1_0::IServiceManager;
+
+namespace android {
+namespace vts {
+
+namespace {
+
+// The state shared by visitHalServices and its threads. The threads own it
+// with visitHalServices, as a thread stuck in a call outlives it.
+struct VisitState {
+  mutex mtx;
+  // notified when a call ends.
+  condition_variable cv;
+  vector<string> names;
+  // the index in names of the next instance to call.
+  size_t next_index = 0;
+  // the start of each call in progress, or -1.
+  vector<int64_t> start_ns;
+  // whether each result is final, as the call ended or timed out.
+  vector<bool> finished;
+  size_t finished_count = 0;
+  vector<HalServiceVisitResult> results;
+  // the processes of the instances called, see one_call_per_process.
+  set<int32_t> called_pids;
+};
+
+int64_t NowNs() {
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Gets the instance at index of state->names and calls visit on it. Takes
+// state->mtx only to check the process of the instance.
+HalServiceVisitResult CallHalService(
+    const sp<IServiceManager>& sm, const shared_ptr<VisitState>& state,
+    size_t index,
+    const function<Return<void>(const sp<IBase>&)>& visit,
+    bool one_call_per_process) {
+  HalServiceVisitResult result;
+  const string& fq_instance_name = state->names[index];
+  string::size_type n = fq_instance_name.find("/");
+  if (n == string::npos || fq_instance_name.size() == n + 1) {
+    result.error = "invalid instance name";
+    return result;
+  }
+  hidl_string fq_interface_name = fq_instance_name.substr(0, n);
+  hidl_string instance_name = fq_instance_name.substr(n + 1);
+  Return<sp<IBase>> interface_ret = sm->get(fq_interface_name, instance_name);
+  if (!interface_ret.isOk()) {
+    result.error = "failed to get service: " + interface_ret.description();
+    return result;
+  }
+  sp<IBase> interface = interface_ret;
+  if (interface == nullptr) {
+    result.error = "service is not registered anymore";
+    return result;
+  }
+  if (one_call_per_process) {
+    int32_t pid = -1;
+    auto debug_ret =
+        interface->getDebugInfo([&](const DebugInfo& info) { pid = info.pid; });
+    // The instances of an unknown process are all called.
+    if (debug_ret.isOk() && pid > 0) {
+      unique_lock<mutex> lock(state->mtx);
+      if (!state->called_pids.insert(pid).second) {
+        result.success = true;
+        result.skipped = true;
+        return result;
+      }
+    }
+  }
+  auto visit_ret = visit(interface);
+  if (!visit_ret.isOk()) {
+    result.error = visit_ret.description();
+    return result;
+  }
+  result.success = true;
+  return result;
+}
+
+// Calls the instances of state until there are none left, or until its call
+// times out, as visitHalServices starts a new thread then.
+void RunVisitThread(sp<IServiceManager> sm, shared_ptr<VisitState> state,
+                    function<Return<void>(const sp<IBase>&)> visit,
+                    bool one_call_per_process) {
+  unique_lock<mutex> lock(state->mtx);
+  while (state->next_index < state->names.size()) {
+    size_t index = state->next_index++;
+    int64_t start_ns = NowNs();
+    state->start_ns[index] = start_ns;
+    lock.unlock();
+    HalServiceVisitResult result =
+        CallHalService(sm, state, index, visit, one_call_per_process);
+    result.elapsed_ms = (NowNs() - start_ns) / 1000000;
+    lock.lock();
+    if (state->finished[index]) {
+      return;  // Timed out.
+    }
+    result.fq_instance_name = state->names[index];
+    state->results[index] = result;
+    state->start_ns[index] = -1;
+    state->finished[index] = true;
+    state->finished_count++;
+    state->cv.notify_all();
+  }
+}
+
+}  // namespace
+
+bool listHalServices(const sp<IServiceManager>& sm, vector<string>* names) {
+  auto list_ret = sm->list([&](const auto& interfaces) {
+    for (const string& fq_instance_name : interfaces) {
+      names->push_back(fq_instance_name);
+    }
+  });
+  if (!list_ret.isOk()) {
+    fprintf(stderr, "failed to list services: %s\n",
+            list_ret.description().c_str());
+    return false;
+  }
+  return true;
+}
+
+vector<HalServiceVisitResult> visitHalServices(
+    const sp<IServiceManager>& sm, const vector<string>& fq_instance_names,
+    const function<Return<void>(const sp<IBase>&)>& visit,
+    const HalServiceVisitOptions& options) {
+  auto state = make_shared<VisitState>();
+  state->names = fq_instance_names;
+  state->start_ns.assign(fq_instance_names.size(), -1);
+  state->finished.assign(fq_instance_names.size(), false);
+  state->results.resize(fq_instance_names.size());
+  int64_t timeout_ns =
+      chrono::duration_cast<chrono::nanoseconds>(options.call_timeout).count();
+
+  unique_lock<mutex> lock(state->mtx);
+  size_t thread_count = min(max<size_t>(options.max_concurrent_calls, 1),
+                            fq_instance_names.size());
+  for (size_t i = 0; i < thread_count; i++) {
+    thread(RunVisitThread, sm, state, visit, options.one_call_per_process)
+        .detach();
+  }
+  while (state->finished_count < state->names.size()) {
+    int64_t now_ns = NowNs();
+    int64_t next_timeout_ns = INT64_MAX;
+    for (size_t i = 0; i < state->names.size(); i++) {
+      if (state->finished[i] || state->start_ns[i] < 0) {
+        continue;
+      }
+      int64_t deadline_ns = state->start_ns[i] + timeout_ns;
+      if (deadline_ns > now_ns) {
+        next_timeout_ns = min(next_timeout_ns, deadline_ns);
+        continue;
+      }
+      // The thread stuck in the call drops its result, and another thread
+      // takes its place.
+      HalServiceVisitResult& result = state->results[i];
+      result.fq_instance_name = state->names[i];
+      result.timed_out = true;
+      result.error = "timed out";
+      result.elapsed_ms = (now_ns - state->start_ns[i]) / 1000000;
+      state->start_ns[i] = -1;
+      state->finished[i] = true;
+      state->finished_count++;
+      if (state->next_index < state->names.size()) {
+        thread(RunVisitThread, sm, state, visit, options.one_call_per_process)
+            .detach();
+      }
+    }
+    if (state->finished_count == state->names.size()) {
+      break;
+    }
+    if (next_timeout_ns == INT64_MAX) {
+      state->cv.wait(lock);
+    } else {
+      state->cv.wait_for(lock, chrono::nanoseconds(next_timeout_ns - now_ns));
+    }
+  }
+  return state->results;
+}
+
+size_t printHalServiceVisitResults(const string& action,
+                                   const vector<HalServiceVisitResult>& results,
+                                   int64_t elapsed_ms) {
+  size_t failed_count = 0;
+  size_t skipped_count = 0;
+  const HalServiceVisitResult* slowest = nullptr;
+  for (const auto& result : results) {
+    if (result.skipped) {
+      skipped_count++;
+      printf("- skipped %s, its process was %s through another instance\n",
+             result.fq_instance_name.c_str(), action.c_str());
+      continue;
+    }
+    if (result.success) {
+      printf("- %s %s (%lld ms)\n", action.c_str(),
+             result.fq_instance_name.c_str(),
+             static_cast<long long>(result.elapsed_ms));
+    } else {
+      failed_count++;
+      fprintf(stderr, "failed on %s after %lld ms: %s\n",
+              result.fq_instance_name.c_str(),
+              static_cast<long long>(result.elapsed_ms), result.error.c_str());
+    }
+    if (slowest == nullptr || result.elapsed_ms > slowest->elapsed_ms) {
+      slowest = &result;
+    }
+  }
+  printf("* %zu instances in %lld ms, %zu failed or timed out, %zu skipped",
+         results.size(), static_cast<long long>(elapsed_ms), failed_count,
+         skipped_count);
+  if (slowest != nullptr) {
+    printf(", slowest %s (%lld ms)", slowest->fq_instance_name.c_str(),
+           static_cast<long long>(slowest->elapsed_ms));
+  }
+  printf("\n");
+  return failed_count;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_PROFILING_HAL_SERVICE_VISITOR_H_
+#define __VTS_PROFILING_HAL_SERVICE_VISITOR_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <android/hidl/manager/1.0/IServiceManager.h>
+
+// This file defines how vts_profiling_configure and vts_coverage_configure
+// call a method on each registered HIDL HAL instance. Devices have over a
+// hundred instances and some answer slowly, so the calls are made
+// concurrently by a bounded number of threads, and a call that doesn't
+// return in time is reported and left behind rather than waited for.
+namespace android {
+namespace vts {
+
+// The options of visitHalServices.
+struct HalServiceVisitOptions {
+  // the number of calls made at the same time.
+  size_t max_concurrent_calls = 16;
+  // the time after which a call, including getting the service, is reported
+  // as timed out.
+  std::chrono::milliseconds call_timeout = std::chrono::seconds(5);
+  // whether to call only one instance per process, as told by getDebugInfo,
+  // for methods whose effect is on the whole process.
+  bool one_call_per_process = false;
+};
+
+// The result of the call on one instance.
+struct HalServiceVisitResult {
+  // the instance, as "<interface>/<instance>".
+  std::string fq_instance_name;
+  bool success = false;
+  bool timed_out = false;
+  // whether the instance was skipped as another instance of its process was
+  // called, see HalServiceVisitOptions::one_call_per_process.
+  bool skipped = false;
+  // the error of a failed call.
+  std::string error;
+  // the time from the start of the call to its end, or to its timeout.
+  int64_t elapsed_ms = 0;
+};
+
+// Lists the registered instances, as "<interface>/<instance>", to names.
+// Returns false on error.
+bool listHalServices(
+    const sp<::android::hidl::manager::V1_0::IServiceManager>& sm,
+    std::vector<std::string>* names);
+
+// Gets each instance in fq_instance_names and calls visit on it, with up to
+// options.max_concurrent_calls calls at the same time. Returns the result of
+// each instance, in the order of fq_instance_names.
+std::vector<HalServiceVisitResult> visitHalServices(
+    const sp<::android::hidl::manager::V1_0::IServiceManager>& sm,
+    const std::vector<std::string>& fq_instance_names,
+    const std::function<::android::hardware::Return<void>(
+        const sp<::android::hidl::base::V1_0::IBase>&)>& visit,
+    const HalServiceVisitOptions& options);
+
+// Prints the result of each instance, with the action that was done, and a
+// summary. Returns the number of instances that failed or timed out.
+size_t printHalServiceVisitResults(
+    const std::string& action,
+    const std::vector<HalServiceVisitResult>& results, int64_t elapsed_ms);
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_PROFILING_HAL_SERVICE_VISITOR_H_
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __VTS_PROFILING_ARGS_POLICY_H_
+#define __VTS_PROFILING_ARGS_POLICY_H_
+
+#include <stddef.h>
+
+// This file defines how much of the arguments and return values of a method
+// the generated profilers capture, chosen per method when the profiler is
+// built rather than when it runs.
+//
+// Each method of a generated profiler evaluates its policy as a constant, so
+// that the capture code which the policy excludes is compiled out. With
+// kProfileTimingOnly, tracing a call only builds the message with the method
+// name and enqueues it. The other policies still capture the values only if
+// hal.instrumentation.profile.args is set.
+//
+// The policy of all the methods is VTS_PROFILING_ARGS_POLICY, kProfileFullArgs
+// unless defined otherwise, e.g. with
+//   cflags: ["-DVTS_PROFILING_ARGS_POLICY=kProfileTimingOnly"],
+// in the Android.bp of the profiler, so that several variants of a profiler
+// library can be built from the same generated code. The policy of some
+// methods can be overridden by a config file given as
+// VTS_PROFILING_ARGS_POLICY_CONFIG, e.g.
+//   cflags: ["-DVTS_PROFILING_ARGS_POLICY_CONFIG=\"nfc_args_policy.h\""],
+// where each line of the file is {<interface>, <method>, <policy>}, e.g.
+//   {"INfc", "write", kProfileTruncatedBuffers},
+//   {"*", "getConfig", kProfileShallowArgs},
+// with "*" matching any interface or method. The first matching line applies.
+namespace android {
+namespace vts {
+
+enum VtsProfilingArgsPolicy {
+  // Only the method name and the timestamp of each event are traced.
+  kProfileTimingOnly = 0,
+  // Scalars, enums and strings are captured. Vectors and arrays are captured
+  // as their type and size, structs and unions as their type.
+  kProfileShallowArgs = 1,
+  // As kProfileFullArgs, but the vectors and arrays of scalars of the
+  // arguments and return values record at most
+  // VTS_PROFILING_TRUNCATED_BUFFER_BYTES bytes.
+  kProfileTruncatedBuffers = 2,
+  // All the values are captured.
+  kProfileFullArgs = 3,
+};
+
+#ifndef VTS_PROFILING_ARGS_POLICY
+#define VTS_PROFILING_ARGS_POLICY kProfileFullArgs
+#endif
+
+#ifndef VTS_PROFILING_TRUNCATED_BUFFER_BYTES
+#define VTS_PROFILING_TRUNCATED_BUFFER_BYTES 64
+#endif
+
+// A line of the config file of VTS_PROFILING_ARGS_POLICY_CONFIG.
+struct VtsProfilingArgsPolicyEntry {
+  const char* interface;
+  const char* method;
+  VtsProfilingArgsPolicy policy;
+};
+
+static constexpr VtsProfilingArgsPolicyEntry kVtsProfilingArgsPolicies[] = {
+#ifdef VTS_PROFILING_ARGS_POLICY_CONFIG
+#include VTS_PROFILING_ARGS_POLICY_CONFIG
+#endif
+    {nullptr, nullptr, VTS_PROFILING_ARGS_POLICY},
+};
+
+// Returns whether name matches pattern, which is a name or "*".
+constexpr bool MatchesProfilingArgsPolicyName(const char* pattern,
+                                              const char* name) {
+  if (pattern[0] == '*' && pattern[1] == '\0') {
+    return true;
+  }
+  for (; *pattern != '\0' && *pattern == *name; pattern++, name++) {
+  }
+  return *pattern == *name;
+}
+
+// Returns the policy of the given method of the given interface, e.g.
+// ("INfc", "write"). Meant to be evaluated at compile time.
+constexpr VtsProfilingArgsPolicy GetProfilingArgsPolicy(const char* interface,
+                                                        const char* method) {
+  for (const auto& entry : kVtsProfilingArgsPolicies) {
+    if (entry.interface == nullptr ||
+        (MatchesProfilingArgsPolicyName(entry.interface, interface) &&
+         MatchesProfilingArgsPolicyName(entry.method, method))) {
+      return entry.policy;
+    }
+  }
+  return VTS_PROFILING_ARGS_POLICY;
+}
+
+// Returns the number of bytes to record of raw_size bytes of elements of
+// element_size bytes under the given policy, rounded down to whole elements.
+template <VtsProfilingArgsPolicy policy>
+constexpr size_t GetProfilingRawValueSize(size_t raw_size,
+                                          size_t element_size) {
+  return policy == kProfileTruncatedBuffers && element_size != 0 &&
+                 raw_size > VTS_PROFILING_TRUNCATED_BUFFER_BYTES
+             ? VTS_PROFILING_TRUNCATED_BUFFER_BYTES / element_size *
+                   element_size
+             : raw_size;
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_PROFILING_ARGS_POLICY_H_
@@ -0,0 +1,363 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "VtsProfilingInterface.h"
+#include "VtsProfilingUtil.h"
+
+#include <cutils/properties.h>
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "test/vts/proto/VtsProfilingMessage.pb.h"
+
+using android::hardware::hidl_memory;
+using android::hardware::hidl_vec;
+using android::hardware::details::HidlInstrumentor;
+using google::protobuf::io::ArrayInputStream;
+using google::protobuf::io::ArrayOutputStream;
+using namespace std;
+
+// Measures the cost of the HAL instrumentation: the serialization of the
+// trace records, VtsProfilingInterface::AddTraceEvent on 1 to 16 threads,
+// writing synchronously and, as BM_AddTraceEventAsync, through the trace
+// writer in the delimited and compact formats, and the calls of the profilers
+// that vtsc generates for the HALs of its golden tests, with the profiling of
+// the arguments on and off.
+//
+// Usage: vts_profiling_benchmark [<profiler lib dir> [<trace dir>]]
+// where <profiler lib dir> is where VTS pushes the libraries, by default
+// /data/local/tmp/<bitness>/, and <trace dir> is where the trace files are
+// written, by default /data/local/tmp/ as for the profilers. The traces take
+// hundreds of MB per run and are not removed. Setting
+// hal.instrumentation.profile.args and hal.instrumentation.profile.async
+// requires root.
+
+namespace android {
+namespace vts {
+
+// Size of the buffer the records are serialized into and read from.
+static constexpr size_t kStreamBufferSize = 4 * 1024 * 1024;
+
+// The HAL the records of BM_AddTraceEvent are traced for.
+static constexpr char kPackage[] = "android.hardware.tests.bar";
+static constexpr char kVersion[] = "1.0";
+static constexpr char kInterface[] = "IBar";
+
+// The function a generated profiler registers with the HIDL instrumentation.
+typedef void (*InstrumentationFunction)(
+    HidlInstrumentor::InstrumentationEvent event, const char* package,
+    const char* version, const char* interface, const char* method,
+    vector<void*>* args);
+
+// Fills message with the call of a method with a vector of payload_size
+// bytes as argument, recorded as raw bytes as the profilers do.
+static void MakeMessage(size_t payload_size,
+                        FunctionSpecificationMessage* message) {
+  message->set_name("write");
+  if (payload_size > 0) {
+    VariableSpecificationMessage* arg = message->add_arg();
+    arg->set_type(TYPE_VECTOR);
+    arg->set_vector_size(payload_size);
+    arg->set_vector_raw_value(string(payload_size, '\x5a'));
+  }
+}
+
+static void MakeRecord(size_t payload_size, VtsProfilingRecord* record) {
+  record->set_timestamp(1234567890123456789LL);
+  record->set_event(InstrumentationEventType::SERVER_API_ENTRY);
+  record->set_package(kPackage);
+  record->set_version_major(1);
+  record->set_version_minor(0);
+  record->set_interface(kInterface);
+  record->set_thread_id(1234);
+  record->set_call_id(5678);
+  MakeMessage(payload_size, record->mutable_func_msg());
+}
+
+// Sets hal.instrumentation.profile.args. Returns false if it could not be
+// set, e.g. without root.
+static bool SetProfilingArgs(VtsProfilingInterface* profiler, bool enabled) {
+  property_set("hal.instrumentation.profile.args", enabled ? "true" : "false");
+  return profiler->IsProfilingArgsEnabled() == enabled;
+}
+
+// The instances of BM_AddTraceEventAsync, which write out their buffered
+// records when destroyed at exit.
+static vector<unique_ptr<VtsProfilingInterface>> async_profilers;
+
+// Returns a new instance writing its traces asynchronously into trace_dir,
+// in the compact format if compact is set. Returns nullptr if the properties
+// could not be set, e.g. without root.
+static VtsProfilingInterface* NewAsyncProfiler(const string& trace_dir,
+                                               bool compact) {
+  property_set("hal.instrumentation.profile.async", "true");
+  property_set("hal.instrumentation.profile.compact",
+               compact ? "true" : "false");
+  bool set =
+      property_get_bool("hal.instrumentation.profile.async", false) &&
+      property_get_bool("hal.instrumentation.profile.compact", !compact) ==
+          compact;
+  VtsProfilingInterface* profiler = nullptr;
+  if (set) {
+    async_profilers.emplace_back(new VtsProfilingInterface(trace_dir));
+    profiler = async_profilers.back().get();
+  }
+  // The profilers loaded afterwards trace synchronously.
+  property_set("hal.instrumentation.profile.async", "false");
+  property_set("hal.instrumentation.profile.compact", "false");
+  return profiler;
+}
+
+// Serializes records with a payload of state.range(0) bytes.
+static void BM_WriteOneDelimited(benchmark::State& state) {
+  VtsProfilingRecord record;
+  MakeRecord(state.range(0), &record);
+  size_t record_size = record.ByteSizeLong();
+  vector<char> buffer(kStreamBufferSize);
+  unique_ptr<ArrayOutputStream> output;
+  for (auto _ : state) {
+    // Starts over once the buffer is full.
+    if (!output || output->ByteCount() + record_size + 5 > buffer.size()) {
+      output.reset(new ArrayOutputStream(buffer.data(), buffer.size()));
+    }
+    if (!writeOneDelimited(record, output.get())) {
+      state.SkipWithError("failed to write the record.");
+      return;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * record_size);
+}
+
+// Parses records with a payload of state.range(0) bytes.
+static void BM_ReadOneDelimited(benchmark::State& state) {
+  VtsProfilingRecord record;
+  MakeRecord(state.range(0), &record);
+  size_t record_size = record.ByteSizeLong();
+  vector<char> buffer(kStreamBufferSize);
+  int64_t size;
+  {
+    ArrayOutputStream output(buffer.data(), buffer.size());
+    do {
+      writeOneDelimited(record, &output);
+    } while (output.ByteCount() + record_size + 5 <= buffer.size());
+    size = output.ByteCount();
+  }
+  unique_ptr<ArrayInputStream> input(new ArrayInputStream(buffer.data(), size));
+  for (auto _ : state) {
+    if (!readOneDelimited(&record, input.get())) {
+      // Starts over at the end of the buffer.
+      input.reset(new ArrayInputStream(buffer.data(), size));
+      if (!readOneDelimited(&record, input.get())) {
+        state.SkipWithError("failed to read the record.");
+        return;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * record_size);
+}
+
+// Traces the entry and exit events of a call with a payload of
+// state.range(0) bytes.
+static void BM_AddTraceEvent(benchmark::State& state,
+                             VtsProfilingInterface* profiler) {
+  if (profiler == nullptr) {
+    state.SkipWithError("failed to set hal.instrumentation.profile.async.");
+    return;
+  }
+  const VtsProfilingInterface::HalDescriptor* hal =
+      profiler->GetHalDescriptor(kPackage, kVersion, kInterface);
+  if (hal == nullptr) {
+    state.SkipWithError("failed to register the HAL.");
+    return;
+  }
+  FunctionSpecificationMessage message;
+  MakeMessage(state.range(0), &message);
+  for (auto _ : state) {
+    profiler->AddTraceEvent(HidlInstrumentor::SERVER_API_ENTRY, hal, message);
+    profiler->AddTraceEvent(HidlInstrumentor::SERVER_API_EXIT, hal, message);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Calls function with the entry and exit events of a call of method, with
+// the profiling of the arguments on if state.range(0) is not 0.
+static void ProfileCalls(benchmark::State& state,
+                         VtsProfilingInterface* profiler,
+                         InstrumentationFunction function,
+                         const char* package, const char* interface,
+                         const char* method, vector<void*>* entry_args,
+                         vector<void*>* exit_args) {
+  if (function == nullptr) {
+    state.SkipWithError("failed to load the profiler.");
+    return;
+  }
+  if (!SetProfilingArgs(profiler, state.range(0) != 0)) {
+    state.SkipWithError("failed to set hal.instrumentation.profile.args.");
+    return;
+  }
+  for (auto _ : state) {
+    function(HidlInstrumentor::SERVER_API_ENTRY, package, kVersion, interface,
+             method, entry_args);
+    function(HidlInstrumentor::SERVER_API_EXIT, package, kVersion, interface,
+             method, exit_args);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// INfc::write(vec<uint8_t> data) of state.range(1) bytes.
+static void BM_NfcWrite(benchmark::State& state,
+                        VtsProfilingInterface* profiler,
+                        InstrumentationFunction function) {
+  hidl_vec<uint8_t> data(state.range(1));
+  uint32_t result = data.size();
+  vector<void*> entry_args = {&data};
+  vector<void*> exit_args = {&result};
+  ProfileCalls(state, profiler, function, "android.hardware.nfc", "INfc",
+               "write", &entry_args, &exit_args);
+}
+
+// ITestMsgQ::requestWriteFmqSync(int32_t count).
+static void BM_TestMsgQRequestWrite(benchmark::State& state,
+                                    VtsProfilingInterface* profiler,
+                                    InstrumentationFunction function) {
+  int32_t count = 64;
+  bool result = true;
+  vector<void*> entry_args = {&count};
+  vector<void*> exit_args = {&result};
+  ProfileCalls(state, profiler, function, "android.hardware.tests.msgq",
+               "ITestMsgQ", "requestWriteFmqSync", &entry_args, &exit_args);
+}
+
+// IMemoryTest::fillMemory(memory memory_in, uint8_t filler) of
+// state.range(1) bytes. The memory is not mapped unless
+// hal.instrumentation.dump.memory is set, so it needs no region.
+static void BM_MemoryTestFillMemory(benchmark::State& state,
+                                    VtsProfilingInterface* profiler,
+                                    InstrumentationFunction function) {
+  hidl_memory memory("ashmem", static_cast<const native_handle_t*>(nullptr),
+                     state.range(1));
+  uint8_t filler = 0x5a;
+  vector<void*> entry_args = {&memory, &filler};
+  vector<void*> exit_args;
+  ProfileCalls(state, profiler, function, "android.hardware.tests.memory",
+               "IMemoryTest", "fillMemory", &entry_args, &exit_args);
+}
+
+// Loads the profiler library of the given HAL from lib_dir and returns its
+// instrumentation function, or nullptr on error.
+static InstrumentationFunction LoadProfiler(const string& lib_dir,
+                                            const string& package,
+                                            const string& interface) {
+  string lib_path = lib_dir + package + "@1.0-vts.profiler.so";
+  void* handle = dlopen(lib_path.c_str(), RTLD_NOW);
+  if (handle == nullptr) {
+    fprintf(stderr, "can't load %s: %s\n", lib_path.c_str(), dlerror());
+    return nullptr;
+  }
+  string function_name = "HIDL_INSTRUMENTATION_FUNCTION_" + package +
+                         "_V1_0_" + interface;
+  replace(function_name.begin(), function_name.end(), '.', '_');
+  InstrumentationFunction function = reinterpret_cast<InstrumentationFunction>(
+      dlsym(handle, function_name.c_str()));
+  if (function == nullptr) {
+    fprintf(stderr, "can't find %s in %s\n", function_name.c_str(),
+            lib_path.c_str());
+  }
+  return function;
+}
+
+// Adds payloads of 0 to 256 KiB.
+static void PayloadSizes(benchmark::internal::Benchmark* benchmark) {
+  for (int size : {0, 64, 1024, 16 * 1024, 256 * 1024}) {
+    benchmark->Arg(size);
+  }
+}
+
+// Adds the profiling of the arguments off and on, each with payloads of 0,
+// 64 and 4096 bytes.
+static void ProfilerArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int args : {0, 1}) {
+    for (int size : {0, 64, 4096}) {
+      benchmark->Args({args, size});
+    }
+  }
+}
+
+BENCHMARK(BM_WriteOneDelimited)->Apply(PayloadSizes);
+BENCHMARK(BM_ReadOneDelimited)->Apply(PayloadSizes);
+
+static void RegisterBenchmarks(const string& lib_dir,
+                               const string& trace_dir) {
+  // The profilers trace through the same instance, which getInstance
+  // creates on its first call.
+  VtsProfilingInterface* profiler =
+      &VtsProfilingInterface::getInstance(trace_dir);
+  benchmark::RegisterBenchmark("BM_AddTraceEvent", BM_AddTraceEvent,
+                               profiler)
+      ->Arg(0)
+      ->Arg(1024)
+      ->ThreadRange(1, 16)
+      ->UseRealTime();
+  // An instance reads the properties when it is created, so each format gets
+  // an instance of its own.
+  for (bool compact : {false, true}) {
+    benchmark::RegisterBenchmark(
+        compact ? "BM_AddTraceEventAsync/compact" : "BM_AddTraceEventAsync",
+        BM_AddTraceEvent, NewAsyncProfiler(trace_dir, compact))
+        ->Arg(0)
+        ->Arg(1024)
+        ->ThreadRange(1, 16)
+        ->UseRealTime();
+  }
+  benchmark::RegisterBenchmark(
+      "BM_NfcWrite", BM_NfcWrite, profiler,
+      LoadProfiler(lib_dir, "android.hardware.nfc", "INfc"))
+      ->Apply(ProfilerArgs);
+  benchmark::RegisterBenchmark(
+      "BM_TestMsgQRequestWrite", BM_TestMsgQRequestWrite, profiler,
+      LoadProfiler(lib_dir, "android.hardware.tests.msgq", "ITestMsgQ"))
+      ->Args({0, 0})
+      ->Args({1, 0});
+  benchmark::RegisterBenchmark(
+      "BM_MemoryTestFillMemory", BM_MemoryTestFillMemory, profiler,
+      LoadProfiler(lib_dir, "android.hardware.tests.memory", "IMemoryTest"))
+      ->Args({0, 4096})
+      ->Args({1, 4096});
+}
+
+}  // namespace vts
+}  // namespace android
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  string lib_dir =
+      argc > 1 ? argv[1] : "/data/local/tmp/" + to_string(sizeof(void*) * 8);
+  if (lib_dir.back() != '/') lib_dir += "/";
+  string trace_dir = argc > 2 ? argv[2] : "/data/local/tmp/";
+  if (trace_dir.back() != '/') trace_dir += "/";
+  android::vts::RegisterBenchmarks(lib_dir, trace_dir);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
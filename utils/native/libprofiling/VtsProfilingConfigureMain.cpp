@@ -18,14 +18,60 @@
 #include <hidl/ServiceManagement.h>
 #include <iostream>
 
+#include "VtsHalServiceVisitor.h"
+
 using namespace std;
 using namespace android;
 
-// Turns on the HAL instrumentation feature on all registered HIDL HALs.
-bool SetHALInstrumentation() {
+// The system properties listing the HALs to trace, read by
+// VtsProfilingInterface, with the index of the entry appended.
+const string kSysPropProfileFilter = "hal.instrumentation.profile.filter.";
+
+// Returns whether the instance is of a HAL in hals, which are
+// <package>@<version>[::<interface>[::<method>]] entries, or hals is empty.
+bool IsInstanceOfHals(const string &fqInstanceName,
+                      const vector<string> &hals) {
+  if (hals.empty()) return true;
+  string fqInterfaceName = fqInstanceName.substr(0, fqInstanceName.find("/"));
+  for (const string &hal : hals) {
+    // Drop the method.
+    string::size_type n = hal.find("::");
+    if (n != string::npos) n = hal.find("::", n + 2);
+    string halInterface = hal.substr(0, n);
+    if (fqInterfaceName == halInterface ||
+        fqInterfaceName.compare(0, halInterface.size() + 2,
+                                halInterface + "::") == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Sets the HALs traced by the profilers, all of them if hals is empty.
+// Returns false, without changing the filter, if a name doesn't fit in a
+// property, as dropping it could leave the filter empty, i.e. trace all the
+// HALs.
+bool SetProfilingFilter(const vector<string> &hals) {
+  for (const string &hal : hals) {
+    if (hal.size() >= PROPERTY_VALUE_MAX) {
+      fprintf(stderr, "HAL name too long to be traced: %s\n", hal.c_str());
+      return false;
+    }
+  }
+  for (size_t i = 0; i < hals.size(); i++) {
+    property_set((kSysPropProfileFilter + to_string(i)).c_str(),
+                 hals[i].c_str());
+  }
+  // The filter ends at the first entry that is not set.
+  property_set((kSysPropProfileFilter + to_string(hals.size())).c_str(), "");
+  return true;
+}
+
+// Turns on the HAL instrumentation feature on the registered HIDL HALs in
+// hals, or on all of them if hals is empty.
+bool SetHALInstrumentation(const vector<string> &hals) {
   using ::android::hidl::base::V1_0::IBase;
   using ::android::hidl::manager::V1_0::IServiceManager;
-  using ::android::hardware::hidl_string;
   using ::android::hardware::Return;
 
   sp<IServiceManager> sm = ::android::hardware::defaultServiceManager();
@@ -35,41 +81,53 @@ bool SetHALInstrumentation() {
     return false;
   }
 
-  auto listRet = sm->list([&](const auto &interfaces) {
-    for (const string &fqInstanceName : interfaces) {
-      string::size_type n = fqInstanceName.find("/");
-      if (n == std::string::npos || fqInstanceName.size() == n + 1) continue;
-
-      hidl_string fqInterfaceName = fqInstanceName.substr(0, n);
-      hidl_string instanceName =
-          fqInstanceName.substr(n + 1, std::string::npos);
-      Return<sp<IBase>> interfaceRet = sm->get(fqInterfaceName, instanceName);
-      if (!interfaceRet.isOk()) {
-        fprintf(stderr, "failed to get service %s: %s\n",
-                fqInstanceName.c_str(), interfaceRet.description().c_str());
-        continue;
-      }
-      sp<IBase> interface = interfaceRet;
-      auto notifyRet = interface->setHALInstrumentation();
-      if (!notifyRet.isOk()) {
-        fprintf(stderr, "failed to setHALInstrumentation on service %s: %s\n",
-                fqInstanceName.c_str(), notifyRet.description().c_str());
-      }
-      printf("- updated the HAL instrumentation mode setting for %s\n",
-             fqInstanceName.c_str());
-    }
-  });
-  if (!listRet.isOk()) {
-    fprintf(stderr, "failed to list services: %s\n",
-            listRet.description().c_str());
+  vector<string> allFqInstanceNames;
+  if (!vts::listHalServices(sm, &allFqInstanceNames)) {
     return false;
   }
+  vector<string> fqInstanceNames;
+  for (const string &fqInstanceName : allFqInstanceNames) {
+    if (IsInstanceOfHals(fqInstanceName, hals)) {
+      fqInstanceNames.push_back(fqInstanceName);
+    }
+  }
+  // The instrumentation is configured on each interface object, so all the
+  // instances of a process are called.
+  vts::HalServiceVisitOptions options;
+  auto start = chrono::steady_clock::now();
+  auto results = vts::visitHalServices(
+      sm, fqInstanceNames,
+      [](const sp<IBase> &interface) -> Return<void> {
+        return interface->setHALInstrumentation();
+      },
+      options);
+  int64_t elapsedMs = chrono::duration_cast<chrono::milliseconds>(
+                          chrono::steady_clock::now() - start)
+                          .count();
+  vts::printHalServiceVisitResults(
+      "updated the HAL instrumentation mode setting for", results, elapsedMs);
   return true;
 }
 
-bool EnableHALProfiling() {
+// Enables profiling on the HALs in hals, or on all of them if hals is empty.
+// The HALs that are not listed load the profilers only if they restart, and
+// don't trace anything. If aggregate is set, the profilers only keep the
+// latency histograms of the methods. If flightRecorder is set, they only keep
+// the latest events in memory, written on request, on a crash, or after a
+// call of trigger if not empty, see VtsProfilingInterface.
+bool EnableHALProfiling(const vector<string> &hals, bool aggregate,
+                        bool flightRecorder, const string &trigger) {
+  if (!SetProfilingFilter(hals)) {
+    return false;
+  }
+  property_set("hal.instrumentation.profile.aggregate",
+               aggregate ? "true" : "false");
+  property_set("hal.instrumentation.profile.flight_recorder",
+               flightRecorder ? "true" : "false");
+  property_set("hal.instrumentation.profile.flight_recorder.trigger",
+               trigger.c_str());
   property_set("hal.instrumentation.enable", "true");
-  if (!SetHALInstrumentation()) {
+  if (!SetHALInstrumentation(hals)) {
     fprintf(stderr, "failed to set instrumentation on services.\n");
     return false;
   }
@@ -77,19 +135,48 @@ bool EnableHALProfiling() {
 }
 
 bool DisableHALProfiling() {
+  SetProfilingFilter(vector<string>());
+  property_set("hal.instrumentation.profile.aggregate", "false");
+  property_set("hal.instrumentation.profile.flight_recorder", "false");
+  property_set("hal.instrumentation.profile.flight_recorder.trigger", "");
   property_set("hal.instrumentation.enable", "false");
-  if (!SetHALInstrumentation()) {
+  if (!SetHALInstrumentation(vector<string>())) {
     fprintf(stderr, "failed to set instrumentation on services.\n");
     return false;
   }
   return true;
 }
 
+// Asks the profilers in aggregate mode to write their summaries, and those
+// in flight recorder mode to write their latest events, on their next traced
+// call. The request is a new value of the properties.
+void RequestProfilingSummary() {
+  int64_t nowMs = chrono::duration_cast<chrono::milliseconds>(
+                      chrono::system_clock::now().time_since_epoch())
+                      .count();
+  property_set("hal.instrumentation.profile.aggregate.dump",
+               to_string(nowMs).c_str());
+  property_set("hal.instrumentation.profile.flight_recorder.dump",
+               to_string(nowMs).c_str());
+}
+
 void PrintUsage() {
   printf(
       "Usage: \n"
-      "To enable profiling: <binary> enable <lib path 32> <lib path 64>"
-      "To disable profiling <binary> disable");
+      "To enable profiling: <binary> enable [<lib path 32> <lib path 64>] "
+      "[--hal=<package>@<version>[::<interface>[::<method>]] ...] "
+      "[--aggregate] [--flight_recorder] "
+      "[--trigger=<package>@<version>::<interface>::<method>[=<value>]]\n"
+      "  Only the HALs given with --hal are profiled, all of them if none is "
+      "given.\n"
+      "  With --aggregate, only the call counts and latency distributions "
+      "are kept.\n"
+      "  With --flight_recorder, only the latest calls are kept in memory, "
+      "and written to trace files on dump, on a crash, or after a call of "
+      "the --trigger method (that returned <value>).\n"
+      "To write the summaries of the aggregated calls and the latest calls "
+      "of the flight recorders: <binary> dump\n"
+      "To disable profiling <binary> disable\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -101,13 +188,37 @@ int main(int argc, char *argv[]) {
       printf("failed to disable profiling.\n");
       return -1;
     }
+  } else if (argc == 2 && !strcmp(argv[1], "dump")) {
+    printf("* request profiling summaries.\n");
+    RequestProfilingSummary();
   } else if (argc >= 2 && !strcmp(argv[1], "enable")) {
     printf("* enable profiling.\n");
-    if (argc == 4) {
-      property_set("hal.instrumentation.lib.path.32", argv[2]);
-      property_set("hal.instrumentation.lib.path.64", argv[3]);
+    vector<string> libPaths;
+    vector<string> hals;
+    bool aggregate = false;
+    bool flightRecorder = false;
+    string trigger;
+    for (int i = 2; i < argc; i++) {
+      if (!strncmp(argv[i], "--hal=", strlen("--hal="))) {
+        hals.push_back(argv[i] + strlen("--hal="));
+      } else if (!strcmp(argv[i], "--aggregate")) {
+        aggregate = true;
+      } else if (!strcmp(argv[i], "--flight_recorder")) {
+        flightRecorder = true;
+      } else if (!strncmp(argv[i], "--trigger=", strlen("--trigger="))) {
+        trigger = argv[i] + strlen("--trigger=");
+      } else {
+        libPaths.push_back(argv[i]);
+      }
+    }
+    if (libPaths.size() == 2) {
+      property_set("hal.instrumentation.lib.path.32", libPaths[0].c_str());
+      property_set("hal.instrumentation.lib.path.64", libPaths[1].c_str());
+    } else if (!libPaths.empty()) {
+      PrintUsage();
+      return -1;
     }
-    if (!EnableHALProfiling()) {
+    if (!EnableHALProfiling(hals, aggregate, flightRecorder, trigger)) {
       printf("failed to enable profiling.\n");
       return -1;
     }
@@ -15,17 +15,30 @@
  */
 #include "VtsProfilingInterface.h"
 
+#include <cutils/ashmem.h>
 #include <cutils/properties.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 #include <android-base/logging.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/text_format.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <sys/socket.h>
+#include <sys/system_properties.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "VtsProfilingUtil.h"
+#include "VtsTraceReader.h"
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
 #include "test/vts/proto/VtsProfilingMessage.pb.h"
 
@@ -34,22 +47,236 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// Default size of the trace buffer used in async mode.
+static constexpr int64_t kDefaultAsyncBufferSize = 4 * 1024 * 1024;
+// Maximum depth of nested calls tracked per thread for sampling and call ids.
+// Deeper calls (or exit events that never came) reset the tracking.
+static constexpr size_t kMaxCallDepth = 256;
+static constexpr int64_t kNanoSecondsPerMilliSecond = 1000000;
+static constexpr int64_t kNanoSecondsPerSecond = 1000000000;
+// Initial and maximum size of the first block of the arena of the trace
+// messages of a thread. The block grows to fit the largest message seen.
+static constexpr size_t kTraceArenaInitialBlockSize = 16 * 1024;
+static constexpr size_t kMaxTraceArenaBlockSize = 1024 * 1024;
+// Default interval between two summaries in aggregate mode.
+static constexpr int64_t kDefaultSummaryIntervalMs = 60000;
+// Percentiles of the latencies written in the summaries.
+static constexpr double kSummaryPercentiles[] = {50, 90, 99};
+// Name of the socket of the collector in the trace file directory.
+static constexpr char kDefaultCollectorSocketName[] = "vts_trace_collector";
+// Signals on which the flight recorders are written.
+static constexpr int kFatalSignals[] = {SIGABRT, SIGBUS, SIGFPE, SIGILL,
+                                        SIGSEGV};
+
+// The instance whose flight recorders are written on a fatal signal, and the
+// actions of the fatal signals before its handler was installed.
+static atomic<VtsProfilingInterface*> flight_recorder_instance(nullptr);
+static struct sigaction previous_fatal_signal_actions[NSIG];
+
+// Generation of the next trace file created by the process, see
+// TraceFile::generation. Unique across the instances, so that the per-thread
+// state of a trace file can't be mistaken for that of another one.
+static atomic<uint64_t> next_trace_file_generation(1);
+
+static bool isEntryEvent(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event) {
+  switch (event) {
+    case android::hardware::details::HidlInstrumentor::SERVER_API_ENTRY:
+    case android::hardware::details::HidlInstrumentor::CLIENT_API_ENTRY:
+    case android::hardware::details::HidlInstrumentor::SYNC_CALLBACK_ENTRY:
+    case android::hardware::details::HidlInstrumentor::ASYNC_CALLBACK_ENTRY:
+    case android::hardware::details::HidlInstrumentor::PASSTHROUGH_ENTRY:
+      return true;
+    default:
+      return false;
+  }
+}
+
 VtsProfilingInterface::VtsProfilingInterface(
     const string& trace_file_path_prefix)
-    : trace_file_path_prefix_(trace_file_path_prefix) {}
+    : trace_file_path_prefix_(trace_file_path_prefix),
+      trace_file_count_(0),
+      next_call_id_(1),
+      index_thread_stop_(false) {
+  flight_recorder_ =
+      property_get_bool("hal.instrumentation.profile.flight_recorder", false);
+  compact_trace_ =
+      property_get_bool("hal.instrumentation.profile.compact", false);
+  capture_cpu_time_ =
+      property_get_bool("hal.instrumentation.profile.cpu_time", false);
+  // Evicting the oldest records would drop definitions of a compact trace.
+  if (flight_recorder_ && compact_trace_) {
+    LOG(WARNING) << "The flight recorder does not keep compact records, "
+                 << "using delimited records.";
+    compact_trace_ = false;
+  }
+  char clock[PROPERTY_VALUE_MAX];
+  property_get("hal.instrumentation.profile.clock", clock, "steady");
+  // Only the compact traces record the calibration of the clock.
+  if (!strcmp(clock, "counter")) {
+    if (!compact_trace_) {
+      LOG(WARNING) << "The counter clock needs a compact trace, using the "
+                   << "steady clock.";
+    } else {
+      trace_clock_ = VtsTraceClock(kTraceClockCounter);
+      if (trace_clock_.Source() != kTraceClockCounter) {
+        LOG(WARNING) << "The CPU counter is not usable, using the steady "
+                     << "clock.";
+      }
+    }
+  }
+  compress_trace_ =
+      property_get_bool("hal.instrumentation.profile.compress", false);
+  shm_trace_ = property_get_bool("hal.instrumentation.profile.shm", false);
+  int64_t ring_capacity = property_get_int64(
+      "hal.instrumentation.profile.shm.buffer_size", kDefaultRingCapacity);
+  // The ring capacity must be a power of 2, round it down.
+  ring_capacity_ = kDefaultRingCapacity;
+  if (ring_capacity > 0 && ring_capacity <= UINT32_MAX) {
+    ring_capacity_ = 1;
+    while (ring_capacity_ * 2 <= static_cast<size_t>(ring_capacity)) {
+      ring_capacity_ *= 2;
+    }
+  }
+  char socket_path[PROPERTY_VALUE_MAX];
+  property_get("hal.instrumentation.profile.shm.socket", socket_path,
+               (trace_file_path_prefix_ + kDefaultCollectorSocketName).c_str());
+  collector_socket_path_ = socket_path;
+  sampling_enabled_ =
+      property_get_bool("hal.instrumentation.profile.sampling", false);
+  default_sampling_rate_ =
+      property_get_int64("hal.instrumentation.profile.sampling.rate", 1);
+  default_sampling_interval_ns_ =
+      property_get_int64("hal.instrumentation.profile.sampling.interval_ms",
+                         0) *
+      kNanoSecondsPerMilliSecond;
+  max_events_per_second_ = property_get_int64(
+      "hal.instrumentation.profile.max_events_per_second", 0);
+  aggregate_ =
+      property_get_bool("hal.instrumentation.profile.aggregate", false);
+  summary_interval_ns_ =
+      property_get_int64("hal.instrumentation.profile.aggregate.interval_ms",
+                         kDefaultSummaryIntervalMs) *
+      kNanoSecondsPerMilliSecond;
+  next_summary_time_ = NanoTime() + summary_interval_ns_;
+  summary_request_serial_ = __system_property_area_serial();
+  char summary_request[PROPERTY_VALUE_MAX];
+  property_get("hal.instrumentation.profile.aggregate.dump", summary_request,
+               "");
+  summary_request_ = summary_request;
+  if (aggregate_) {
+    LOG(INFO) << "Aggregating the calls into latency histograms.";
+  }
+  property_serial_ = __system_property_area_serial();
+  profiling_args_enabled_ =
+      property_get_bool("hal.instrumentation.profile.args", true);
+  trace_filter_serial_ = __system_property_area_serial();
+  trace_filter_ = ReadTraceFilter();
+  trace_filter_generation_ = 1;
+  if (!trace_filter_.all) {
+    LOG(INFO) << "Tracing only " << trace_filter_.hals.size() << " HALs and "
+              << trace_filter_.methods.size() << " methods.";
+  }
+  int64_t flight_recorder_capacity = property_get_int64(
+      "hal.instrumentation.profile.flight_recorder.buffer_size",
+      kDefaultFlightRecorderCapacity);
+  flight_recorder_capacity_ = flight_recorder_capacity > 0
+                                  ? flight_recorder_capacity
+                                  : kDefaultFlightRecorderCapacity;
+  char trigger[PROPERTY_VALUE_MAX];
+  property_get("hal.instrumentation.profile.flight_recorder.trigger", trigger,
+               "");
+  flight_recorder_trigger_ = ParseFlightRecorderTrigger(trigger);
+  flight_recorder_dump_serial_ = __system_property_area_serial();
+  char dump_request[PROPERTY_VALUE_MAX];
+  property_get("hal.instrumentation.profile.flight_recorder.dump",
+               dump_request, "");
+  flight_recorder_dump_request_ = dump_request;
+  rotate_max_bytes_ =
+      property_get_int64("hal.instrumentation.profile.rotate.max_bytes", 0);
+  rotate_interval_ns_ =
+      property_get_int64("hal.instrumentation.profile.rotate.interval_ms", 0) *
+      kNanoSecondsPerMilliSecond;
+  rotate_keep_ =
+      property_get_int64("hal.instrumentation.profile.rotate.keep", 0);
+  if (rotate_max_bytes_ > 0 || rotate_interval_ns_ > 0) {
+    LOG(INFO) << "Rotating the trace files, max bytes: " << rotate_max_bytes_
+              << ", interval ms: "
+              << rotate_interval_ns_ / kNanoSecondsPerMilliSecond
+              << ", kept: " << rotate_keep_;
+  }
+  if (flight_recorder_) {
+    LOG(INFO) << "Keeping the latest trace events in memory, buffer size: "
+              << flight_recorder_capacity_;
+    VtsProfilingInterface* expected = nullptr;
+    if (flight_recorder_instance.compare_exchange_strong(expected, this)) {
+      struct sigaction action;
+      memset(&action, 0, sizeof(action));
+      sigemptyset(&action.sa_mask);
+      action.sa_sigaction = HandleFatalSignal;
+      action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+      for (int signal : kFatalSignals) {
+        sigaction(signal, &action, &previous_fatal_signal_actions[signal]);
+      }
+    }
+  } else if (shm_trace_) {
+    LOG(INFO) << "Writing trace events to shared memory, buffer size: "
+              << ring_capacity_ << ", collector: " << collector_socket_path_;
+  } else if (property_get_bool("hal.instrumentation.profile.async", false)) {
+    int64_t buffer_size =
+        property_get_int64("hal.instrumentation.profile.async.buffer_size",
+                           kDefaultAsyncBufferSize);
+    if (buffer_size <= 0) {
+      buffer_size = kDefaultAsyncBufferSize;
+    }
+    int64_t high_water_mark = property_get_int64(
+        "hal.instrumentation.profile.async.high_water_mark", buffer_size / 2);
+    if (high_water_mark <= 0) {
+      high_water_mark = buffer_size / 2;
+    }
+    LOG(INFO) << "Writing trace events asynchronously, buffer size: "
+              << buffer_size << ", high-water mark: " << high_water_mark;
+    trace_writer_.reset(
+        new VtsTraceWriter(buffer_size, high_water_mark, compress_trace_));
+  }
+}
 
 VtsProfilingInterface::~VtsProfilingInterface() {
+  if (aggregate_) {
+    WriteSummary();
+  }
+  // The handler leaves the signals to the previous handlers without an
+  // instance.
+  VtsProfilingInterface* instance = this;
+  flight_recorder_instance.compare_exchange_strong(instance, nullptr);
+  // Write out all the buffered events before closing the trace files.
+  trace_writer_.reset();
   mutex_.lock();
-  for (auto it = trace_map_.begin(); it != trace_map_.end(); ++it) {
-    close(it->second);
+  for (int i = 0; i < trace_file_count_; i++) {
+    trace_files_[i].compressor.reset();
+    // The collector drains the ring after the connection is closed.
+    ReleaseRingBuffer(&trace_files_[i]);
+    if (trace_files_[i].fd >= 0) {
+      close(trace_files_[i].fd);
+      // The last segment is complete, index it before the process exits.
+      if (trace_files_[i].rotated && !compact_trace_ && !compress_trace_) {
+        VtsTraceReader::Open(trace_files_[i].path);
+      }
+    }
   }
   mutex_.unlock();
+  // The segments completed before are indexed before the thread exits.
+  if (index_thread_.joinable()) {
+    index_mutex_.lock();
+    index_thread_stop_ = true;
+    index_cond_.signal();
+    index_mutex_.unlock();
+    index_thread_.join();
+  }
 }
 
 int64_t VtsProfilingInterface::NanoTime() {
-  std::chrono::nanoseconds duration(
-      std::chrono::steady_clock::now().time_since_epoch());
-  return static_cast<int64_t>(duration.count());
+  return VtsTraceClock::SteadyNowNs();
 }
 
 VtsProfilingInterface& VtsProfilingInterface::getInstance(
@@ -58,43 +285,735 @@ VtsProfilingInterface& VtsProfilingInterface::getInstance(
   return instance;
 }
 
-int VtsProfilingInterface::GetTraceFile(const string& package,
-                                        const string& version) {
+bool VtsProfilingInterface::IsProfilingArgsEnabled() {
+  // The serial of the property area changes whenever any system property is
+  // set, which is much cheaper to check than looking up the property.
+  uint32_t serial = __system_property_area_serial();
+  if (serial != property_serial_) {
+    property_serial_ = serial;
+    profiling_args_enabled_ =
+        property_get_bool("hal.instrumentation.profile.args", true);
+  }
+  return profiling_args_enabled_;
+}
+
+size_t VtsProfilingInterface::GetRawValueSize(size_t count,
+                                              size_t element_size) {
+  // Cached the same way as the profile.args property, but shared by all the
+  // instances as generated code for types does not have one at hand.
+  static atomic<uint32_t> property_serial(__system_property_area_serial());
+  static atomic<int64_t> max_raw_bytes(
+      property_get_int64("hal.instrumentation.profile.args.max_raw_bytes", 0));
+  uint32_t serial = __system_property_area_serial();
+  if (serial != property_serial) {
+    property_serial = serial;
+    max_raw_bytes = property_get_int64(
+        "hal.instrumentation.profile.args.max_raw_bytes", 0);
+  }
+  int64_t max_bytes = max_raw_bytes;
+  if (max_bytes <= 0 || element_size == 0 ||
+      count <= static_cast<uint64_t>(max_bytes) / element_size) {
+    return count * element_size;
+  }
+  return (max_bytes / element_size) * element_size;
+}
+
+FunctionSpecificationMessage& VtsProfilingInterface::NewTraceMessage() {
+  using google::protobuf::Arena;
+  using google::protobuf::ArenaOptions;
+
+  // Reset keeps the first block, provided by us, and frees the others. The
+  // first block is reallocated larger whenever a message did not fit in it,
+  // so that the arena quickly stops allocating memory.
+  static thread_local size_t block_size = 0;
+  static thread_local unique_ptr<char[]> block;
+  static thread_local unique_ptr<Arena> arena;
+  size_t space_allocated = arena ? arena->SpaceAllocated() : 0;
+  if (!arena || (space_allocated > block_size &&
+                 block_size < kMaxTraceArenaBlockSize)) {
+    arena.reset();
+    block_size = kTraceArenaInitialBlockSize;
+    while (block_size < space_allocated &&
+           block_size < kMaxTraceArenaBlockSize) {
+      block_size *= 2;
+    }
+    block.reset(new char[block_size]);
+    ArenaOptions options;
+    options.initial_block = block.get();
+    options.initial_block_size = block_size;
+    arena.reset(new Arena(options));
+  } else {
+    arena->Reset();
+  }
+  return *Arena::CreateMessage<FunctionSpecificationMessage>(arena.get());
+}
+
+bool VtsProfilingInterface::ProfileFileDescriptor(int fd, FdMessage* fd_msg) {
+  // Description of an fd, valid as long as the fd refers to the same file.
+  struct CachedFd {
+    dev_t dev;
+    ino_t ino;
+    mode_t mode;
+    FdMessage message;
+  };
+  // Never destroyed, generated code may run while the process exits.
+  static Mutex* cache_mutex = new Mutex();
+  static map<int, CachedFd>* cache = new map<int, CachedFd>();
+
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) != 0) {
+    return false;
+  }
+  {
+    Mutex::Autolock lock(*cache_mutex);
+    auto found = cache->find(fd);
+    if (found != cache->end() && found->second.dev == statbuf.st_dev &&
+        found->second.ino == statbuf.st_ino &&
+        found->second.mode == statbuf.st_mode) {
+      fd_msg->CopyFrom(found->second.message);
+      // All the ashmem regions are the same device file, the size can not be
+      // cached.
+      if (fd_msg->has_memory()) {
+        fd_msg->mutable_memory()->set_size(ashmem_get_size_region(fd));
+      }
+      return true;
+    }
+  }
+
+  CachedFd cached_fd;
+  cached_fd.dev = statbuf.st_dev;
+  cached_fd.ino = statbuf.st_ino;
+  cached_fd.mode = statbuf.st_mode;
+  FdMessage* message = &cached_fd.message;
+  char file_path[PATH_MAX];
+  string proc_path = "/proc/self/fd/" + to_string(fd);
+  ssize_t r = readlink(proc_path.c_str(), file_path, sizeof(file_path) - 1);
+  if (r == -1) {
+    return false;
+  }
+  file_path[r] = '\0';
+  message->set_file_name(file_path);
+  message->set_mode(statbuf.st_mode);
+  if (S_ISREG(statbuf.st_mode) || S_ISDIR(statbuf.st_mode)) {
+    message->set_type(S_ISREG(statbuf.st_mode) ? FILE_TYPE : DIR_TYPE);
+    message->set_flags(fcntl(fd, F_GETFL));
+  } else if (S_ISCHR(statbuf.st_mode) || S_ISBLK(statbuf.st_mode)) {
+    message->set_type(DEV_TYPE);
+    if (strcmp(file_path, "/dev/ashmem") == 0) {
+      message->mutable_memory()->set_size(ashmem_get_size_region(fd));
+    }
+  } else if (S_ISFIFO(statbuf.st_mode)) {
+    message->set_type(PIPE_TYPE);
+  } else if (S_ISSOCK(statbuf.st_mode)) {
+    message->set_type(SOCKET_TYPE);
+  } else {
+    message->set_type(LINK_TYPE);
+  }
+  fd_msg->CopyFrom(*message);
+
+  Mutex::Autolock lock(*cache_mutex);
+  (*cache)[fd] = move(cached_fd);
+  return true;
+}
+
+int VtsProfilingInterface::RegisterTraceFile(const string& package,
+                                             const string& version) {
   string fullname = package + "@" + version;
-  int fd = -1;
-  if (trace_map_.find(fullname) != trace_map_.end()) {
-    fd = trace_map_[fullname];
+  Mutex::Autolock lock(mutex_);
+  auto found = trace_map_.find(fullname);
+  if (found != trace_map_.end()) {
+    return found->second;
+  }
+  int handle = trace_file_count_;
+  if (handle >= kMaxTraceFiles) {
+    LOG(ERROR) << "Too many trace files, can not trace " << fullname;
+    return -1;
+  }
+  TraceFile* trace_file = &trace_files_[handle];
+  trace_file->package = package;
+  trace_file->version = version;
+  trace_file->fd = -1;
+  trace_file->event_count = 0;
+  trace_file->needs_check = true;
+  trace_file->rotated = false;
+  trace_file->segment_bytes = 0;
+  trace_file->segment_start_time = 0;
+  trace_map_[fullname] = handle;
+  // Publish the new entry only after it is initialized.
+  trace_file_count_ = handle + 1;
+  return handle;
+}
+
+const VtsProfilingInterface::HalDescriptor* VtsProfilingInterface::RegisterHal(
+    const string& package, int version_major, int version_minor,
+    const string& interface) {
+  string version = to_string(version_major) + "." + to_string(version_minor);
+  string fullname = package + "@" + version + "::" + interface;
+  {
+    Mutex::Autolock lock(mutex_);
+    auto found = hal_map_.find(fullname);
+    if (found != hal_map_.end()) {
+      return found->second.get();
+    }
+  }
+  int trace_file_handle = RegisterTraceFile(package, version);
+  if (trace_file_handle < 0) {
+    return nullptr;
+  }
+
+  VtsProfilingRecord metadata;
+  metadata.set_package(package);
+  metadata.set_version_major(version_major);
+  metadata.set_version_minor(version_minor);
+  metadata.set_interface(interface);
+
+  unique_ptr<HalDescriptor> hal(new HalDescriptor());
+  hal->package = package;
+  hal->version = version;
+  hal->version_major = version_major;
+  hal->version_minor = version_minor;
+  hal->interface = interface;
+  hal->trace_file_handle = trace_file_handle;
+  hal->record_metadata = metadata.SerializeAsString();
+  hal->budget_window_start = 0;
+  hal->budget_used = 0;
+  hal->filter_cache = 0;
+
+  Mutex::Autolock lock(mutex_);
+  // Another thread may have registered the same HAL in the meantime.
+  auto& entry = hal_map_[fullname];
+  if (!entry) {
+    entry = move(hal);
+  }
+  return entry.get();
+}
+
+const VtsProfilingInterface::HalDescriptor*
+VtsProfilingInterface::GetHalDescriptor(const char* package,
+                                        const char* version,
+                                        const char* interface) {
+  // Small per-thread cache from the (package, version, interface) string
+  // addresses to the descriptor. The strings are verified on hit in case the
+  // addresses are reused.
+  struct CacheEntry {
+    const char* package;
+    const char* version;
+    const char* interface;
+    const HalDescriptor* hal;
+  };
+  static constexpr size_t kCacheSize = 8;
+  static thread_local CacheEntry cache[kCacheSize];
+  size_t slot = (reinterpret_cast<uintptr_t>(package) ^
+                 reinterpret_cast<uintptr_t>(version) ^
+                 reinterpret_cast<uintptr_t>(interface)) %
+                kCacheSize;
+  CacheEntry& entry = cache[slot];
+  if (entry.package == package && entry.version == version &&
+      entry.interface == interface && entry.hal != nullptr &&
+      entry.hal->package == package && entry.hal->version == version &&
+      entry.hal->interface == interface) {
+    return entry.hal;
+  }
+
+  // Parse the version (e.g. 1.0) without allocating.
+  char* minor_begin = nullptr;
+  long version_major = strtol(version, &minor_begin, 10);
+  if (minor_begin == version || *minor_begin != '.') {
+    LOG(ERROR) << "Invalid version: " << version;
+    return nullptr;
+  }
+  char* minor_end = nullptr;
+  long version_minor = strtol(minor_begin + 1, &minor_end, 10);
+  if (minor_end == minor_begin + 1 || *minor_end != '\0') {
+    LOG(ERROR) << "Invalid version: " << version;
+    return nullptr;
+  }
+  const HalDescriptor* hal =
+      RegisterHal(package, version_major, version_minor, interface);
+  if (hal != nullptr) {
+    entry = {package, version, interface, hal};
+  }
+  return hal;
+}
+
+bool VtsProfilingInterface::ShouldTraceEvent(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, const char* method) {
+  // The filter is checked for the entry and the exit events, so that the
+  // exit events of the calls it skips are skipped too.
+  if (hal != nullptr && !IsTracedByFilter(hal, method)) {
+    return false;
+  }
+  if (aggregate_) {
+    if (hal != nullptr) {
+      AggregateEvent(event, hal, method);
+    }
+    return false;
+  }
+  if (!sampling_enabled_ && max_events_per_second_ <= 0) {
+    return true;
+  }
+  if (hal == nullptr) {
+    return false;
+  }
+  // Decisions for the calls in progress on this thread. Entry and exit events
+  // of a thread are always nested, including the callbacks made during a
+  // call.
+  static thread_local vector<bool> sampled_calls;
+  if (isEntryEvent(event)) {
+    bool sampled = SampleCall(hal, method, NanoTime());
+    if (sampled_calls.size() >= kMaxCallDepth) {
+      LOG(WARNING) << "Too many nested calls, resetting sampling state.";
+      sampled_calls.clear();
+    }
+    sampled_calls.push_back(sampled);
+    return sampled;
+  }
+  if (sampled_calls.empty()) {
+    // The entry event was not seen, e.g. with tracing enabled in the middle
+    // of a call.
+    return false;
+  }
+  bool sampled = sampled_calls.back();
+  sampled_calls.pop_back();
+  return sampled;
+}
+
+VtsProfilingInterface::TraceFilter VtsProfilingInterface::ReadTraceFilter() {
+  TraceFilter filter;
+  for (int i = 0;; i++) {
+    char entry[PROPERTY_VALUE_MAX];
+    string name = "hal.instrumentation.profile.filter." + to_string(i);
+    if (property_get(name.c_str(), entry, "") <= 0) {
+      break;
+    }
+    filter.all = false;
+    string value = entry;
+    // A method entry has a second "::", after the interface.
+    size_t interface_pos = value.find("::");
+    if (interface_pos != string::npos &&
+        value.find("::", interface_pos + 2) != string::npos) {
+      filter.methods.insert(value);
+    } else {
+      filter.hals.insert(value);
+    }
+  }
+  return filter;
+}
+
+bool VtsProfilingInterface::IsTracedByFilter(const HalDescriptor* hal,
+                                             const char* method) {
+  uint32_t serial = __system_property_area_serial();
+  if (serial != trace_filter_serial_) {
+    Mutex::Autolock lock(trace_filter_mutex_);
+    if (serial != trace_filter_serial_) {
+      trace_filter_ = ReadTraceFilter();
+      trace_filter_generation_++;
+      trace_filter_serial_ = serial;
+    }
+  }
+  uint64_t generation = trace_filter_generation_;
+  uint64_t cache = hal->filter_cache.load(memory_order_relaxed);
+  int state;
+  if ((cache >> 2) == generation) {
+    state = cache & 3;
+    if (state != kTraceMethods) {
+      return state == kTraceAll;
+    }
+  }
+
+  Mutex::Autolock lock(trace_filter_mutex_);
+  generation = trace_filter_generation_;
+  string hal_name = hal->package + "@" + hal->version;
+  string interface_name = hal_name + "::" + hal->interface;
+  if (trace_filter_.all || trace_filter_.hals.count(hal_name) ||
+      trace_filter_.hals.count(interface_name)) {
+    state = kTraceAll;
+  } else {
+    // Whether a method of the interface is listed.
+    auto it = trace_filter_.methods.lower_bound(interface_name + "::");
+    state = it != trace_filter_.methods.end() &&
+                    it->compare(0, interface_name.size() + 2,
+                                interface_name + "::") == 0
+                ? kTraceMethods
+                : kTraceNone;
+  }
+  hal->filter_cache.store((generation << 2) | state, memory_order_relaxed);
+  if (state != kTraceMethods) {
+    return state == kTraceAll;
+  }
+  return trace_filter_.methods.count(interface_name + "::" + method) > 0;
+}
+
+uint64_t VtsProfilingInterface::GetCallId(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event) {
+  // Ids of the calls in progress on this thread, nested as for sampling.
+  static thread_local vector<uint64_t> call_ids;
+  if (isEntryEvent(event)) {
+    if (call_ids.size() >= kMaxCallDepth) {
+      LOG(WARNING) << "Too many nested calls, resetting call ids.";
+      call_ids.clear();
+    }
+    call_ids.push_back(next_call_id_++);
+    return call_ids.back();
+  }
+  if (call_ids.empty()) {
+    return 0;
+  }
+  uint64_t call_id = call_ids.back();
+  call_ids.pop_back();
+  return call_id;
+}
+
+bool VtsProfilingInterface::SampleCall(const HalDescriptor* hal,
+                                       const char* method, int64_t now) {
+  if (sampling_enabled_) {
+    MethodState* sampler = GetMethodState(hal, method);
+    if (sampler->rate > 1 && sampler->call_count++ % sampler->rate != 0) {
+      return false;
+    }
+    if (sampler->interval_ns > 0) {
+      int64_t last_sample_time = sampler->last_sample_time;
+      if (now - last_sample_time < sampler->interval_ns ||
+          !sampler->last_sample_time.compare_exchange_strong(last_sample_time,
+                                                             now)) {
+        return false;
+      }
+    }
+  }
+  if (max_events_per_second_ > 0) {
+    int64_t window_start = hal->budget_window_start;
+    if (now - window_start >= kNanoSecondsPerSecond &&
+        hal->budget_window_start.compare_exchange_strong(window_start, now)) {
+      hal->budget_used = 0;
+    }
+    // Reserve the budget for both the entry and the exit events.
+    if (hal->budget_used.fetch_add(2) + 2 > max_events_per_second_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+VtsProfilingInterface::MethodState* VtsProfilingInterface::GetMethodState(
+    const HalDescriptor* hal, const char* method) {
+  struct CacheEntry {
+    const HalDescriptor* hal;
+    const char* method;
+    MethodState* state;
+  };
+  static constexpr size_t kCacheSize = 16;
+  static thread_local CacheEntry cache[kCacheSize];
+  size_t slot = (reinterpret_cast<uintptr_t>(hal) ^
+                 reinterpret_cast<uintptr_t>(method)) %
+                kCacheSize;
+  CacheEntry& entry = cache[slot];
+  if (entry.hal == hal && entry.method == method) {
+    return entry.state;
+  }
+
+  Mutex::Autolock lock(mutex_);
+  auto& sampler = method_states_[make_pair(hal, string(method))];
+  if (!sampler) {
+    sampler.reset(new MethodState());
+    string suffix = "." + hal->interface + "." + method;
+    sampler->rate = property_get_int64(
+        ("hal.instrumentation.profile.sampling.rate" + suffix).c_str(),
+        default_sampling_rate_);
+    sampler->interval_ns =
+        property_get_int64(
+            ("hal.instrumentation.profile.sampling.interval_ms" + suffix)
+                .c_str(),
+            default_sampling_interval_ns_ / kNanoSecondsPerMilliSecond) *
+        kNanoSecondsPerMilliSecond;
+    sampler->call_count = 0;
+    // Always trace the first call.
+    sampler->last_sample_time = INT64_MIN / 2;
+  }
+  entry = {hal, method, sampler.get()};
+  return sampler.get();
+}
+
+void VtsProfilingInterface::AggregateEvent(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, const char* method) {
+  struct Call {
+    MethodState* state;
+    int64_t start_time;
+  };
+  // Calls in progress on this thread, nested as for sampling.
+  static thread_local vector<Call> calls;
+  MethodState* state = GetMethodState(hal, method);
+  int64_t now = NanoTime();
+  if (isEntryEvent(event)) {
+    if (calls.size() >= kMaxCallDepth) {
+      LOG(WARNING) << "Too many nested calls, resetting aggregation state.";
+      calls.clear();
+    }
+    calls.push_back({state, now});
+    return;
+  }
+  // The entry event was not seen if the calls do not match, e.g. with
+  // profiling enabled in the middle of a call.
+  while (!calls.empty()) {
+    Call call = calls.back();
+    calls.pop_back();
+    if (call.state == state) {
+      state->latency.Record(now - call.start_time);
+      break;
+    }
+  }
+  CheckSummaryDump(now);
+}
+
+void VtsProfilingInterface::CheckSummaryDump(int64_t now) {
+  bool requested = false;
+  uint32_t serial = __system_property_area_serial();
+  if (serial != summary_request_serial_) {
+    summary_request_serial_ = serial;
+    char request[PROPERTY_VALUE_MAX];
+    property_get("hal.instrumentation.profile.aggregate.dump", request, "");
+    Mutex::Autolock lock(mutex_);
+    if (summary_request_ != request) {
+      summary_request_ = request;
+      requested = true;
+    }
+  }
+  int64_t next_summary_time = next_summary_time_;
+  if (summary_interval_ns_ > 0 && now >= next_summary_time &&
+      next_summary_time_.compare_exchange_strong(
+          next_summary_time, now + summary_interval_ns_)) {
+    requested = true;
+  }
+  if (requested) {
+    WriteSummary();
+  }
+}
+
+bool VtsProfilingInterface::WriteSummary() {
+  if (!aggregate_) {
+    return false;
+  }
+  Mutex::Autolock summary_lock(summary_mutex_);
+  string summary;
+  {
+    Mutex::Autolock lock(mutex_);
+    for (const auto& method_state : method_states_) {
+      const HalDescriptor* hal = method_state.first.first;
+      const VtsLatencyHistogram& latency = method_state.second->latency;
+      int64_t count = latency.GetCount();
+      if (count == 0) {
+        continue;
+      }
+      summary += hal->package + "@" + hal->version + "::" + hal->interface +
+                 "::" + method_state.first.second +
+                 " calls=" + to_string(count) +
+                 " mean_ns=" + to_string(latency.GetSumNs() / count) +
+                 " min_ns=" + to_string(latency.GetMinNs());
+      for (double percentile : kSummaryPercentiles) {
+        summary += " p" + to_string(static_cast<int>(percentile)) + "_ns=" +
+                   to_string(latency.GetPercentileNs(percentile));
+      }
+      summary += " max_ns=" + to_string(latency.GetMaxNs()) + "\n";
+    }
+  }
+  // Replace the summary at once, so that it can be read at any time.
+  string file_path = trace_file_path_prefix_ + "vts_profiling_summary_" +
+                     to_string(getpid()) + ".txt";
+  string temp_path = file_path + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    PLOG(ERROR) << "Can not open summary file: " << temp_path;
+    return false;
+  }
+  bool written = WriteFully(fd, summary);
+  close(fd);
+  if (!written || rename(temp_path.c_str(), file_path.c_str()) != 0) {
+    PLOG(ERROR) << "Failed to write summary file: " << file_path;
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+int VtsProfilingInterface::GetTraceFile(int trace_file_handle) {
+  if (trace_file_handle < 0 || trace_file_handle >= trace_file_count_) {
+    return -1;
+  }
+  TraceFile* trace_file = &trace_files_[trace_file_handle];
+  if (!trace_file->needs_check &&
+      trace_file->event_count++ < kTraceFileCheckInterval &&
+      !IsRotationDue(trace_file)) {
+    return trace_file->fd;
+  }
+  Mutex::Autolock lock(mutex_);
+  return CheckTraceFile(trace_file);
+}
+
+int VtsProfilingInterface::CheckTraceFile(TraceFile* trace_file) {
+  int fd = trace_file->fd;
+  bool valid = false;
+  if (trace_file->ring) {
+    // The ring is valid as long as the collector is connected. In compact
+    // mode, a dropped event may have carried definitions needed by the
+    // following ones, so the trace is restarted in a new ring.
+    char buffer;
+    valid = TEMP_FAILURE_RETRY(recv(trace_file->collector_socket, &buffer,
+                                    sizeof(buffer),
+                                    MSG_PEEK | MSG_DONTWAIT)) < 0 &&
+            errno == EAGAIN &&
+            !(compact_trace_ && trace_file->ring->DroppedCount() > 0);
+  } else if (fd >= 0) {
     struct stat statbuf;
-    fstat(fd, &statbuf);
     // If file no longer exists or the file descriptor is no longer valid,
     // create a new trace file.
-    if (statbuf.st_nlink <= 0 || fcntl(fd, F_GETFD) == -1) {
-      fd = CreateTraceFile(package, version);
-      trace_map_[fullname] = fd;
+    valid = fstat(fd, &statbuf) == 0 && statbuf.st_nlink > 0 &&
+            fcntl(fd, F_GETFD) != -1;
+  }
+  bool rotate = valid && IsRotationDue(trace_file);
+  if (!valid || rotate) {
+    int old_fd = fd;
+    string old_path = trace_file->path;
+    trace_file->compressor.reset();
+    if (trace_file->ring) {
+      ReleaseRingBuffer(trace_file);
+      close(fd);
+    }
+    // In async mode, the trace writer closes the old trace file once the
+    // records queued for it are written, see below.
+    if (rotate && !trace_writer_) {
+      close(fd);
+      CompleteSegment(trace_file, old_path);
+    }
+    fd = -1;
+    if (shm_trace_) {
+      fd = CreateRingBuffer(trace_file);
+    }
+    if (fd < 0) {
+      trace_file->path = GetNextTraceFilePath(trace_file);
+      fd = CreateTraceFile(trace_file->path);
+    }
+    trace_file->fd = fd;
+    trace_file->rotated = !trace_file->ring && (rotate_max_bytes_ > 0 ||
+                                                rotate_interval_ns_ > 0);
+    trace_file->segment_bytes = 0;
+    trace_file->segment_start_time = NanoTime();
+    if (fd >= 0 && compress_trace_ && !trace_writer_ && !trace_file->ring) {
+      trace_file->compressor.reset(new VtsTraceCompressor(fd));
+    }
+    uint64_t generation = next_trace_file_generation++;
+    if (compact_trace_) {
+      // A new trace file needs its own header and definitions. Nothing else
+      // writes to it yet.
+      shared_ptr<CompactEncoder> encoder = make_shared<CompactEncoder>();
+      encoder->generation = generation;
+      string header;
+      encoder->encoder.EncodeHeader(&header);
+      encoder->encoder.EncodeClock(trace_clock_.Calibrate(), &header);
+      if (fd >= 0 && !WriteTraceData(trace_file, fd, header)) {
+        PLOG(ERROR) << "Failed to write trace file header.";
+      }
+      atomic_store(&trace_file->encoder, encoder);
+    }
+    trace_file->generation = generation;
+    if (trace_writer_) {
+      // The generation is published before its file is set, and the old file
+      // is handed back once the records queued for it are written. The
+      // records queued for the new generation meanwhile are held back.
+      function<void()> on_replaced;
+      if (rotate) {
+        on_replaced = [this, trace_file, old_fd, old_path]() {
+          close(old_fd);
+          CompleteSegment(trace_file, old_path);
+        };
+      }
+      trace_writer_->SetFile(trace_file - trace_files_, generation, fd,
+                             move(on_replaced), &trace_file->needs_check);
     }
-  } else {
-    // Create trace file for a new HAL.
-    fd = CreateTraceFile(package, version);
-    trace_map_[fullname] = fd;
   }
+  trace_file->event_count = 0;
+  trace_file->needs_check = fd < 0;
   return fd;
 }
 
-int VtsProfilingInterface::CreateTraceFile(const string& package,
-                                           const string& version) {
-  // Attach device info and timestamp for the trace file.
-  char build_number[PROPERTY_VALUE_MAX];
-  char device_id[PROPERTY_VALUE_MAX];
-  char product_name[PROPERTY_VALUE_MAX];
-  property_get("ro.build.version.incremental", build_number, "unknown_build");
-  property_get("ro.serialno", device_id, "unknown_device");
-  property_get("ro.build.product", product_name, "unknown_product");
+bool VtsProfilingInterface::IsRotationDue(const TraceFile* trace_file) {
+  if (!trace_file->rotated) {
+    return false;
+  }
+  return (rotate_max_bytes_ > 0 &&
+          trace_file->segment_bytes >=
+              static_cast<uint64_t>(rotate_max_bytes_)) ||
+         (rotate_interval_ns_ > 0 &&
+          NanoTime() - trace_file->segment_start_time >= rotate_interval_ns_);
+}
 
-  string file_path = trace_file_path_prefix_ + package + "_" + version + "_" +
-                     string(product_name) + "_" + string(device_id) + "_" +
-                     string(build_number) + "_" + to_string(NanoTime()) +
-                     ".vts.trace";
+string VtsProfilingInterface::GetNextTraceFilePath(TraceFile* trace_file) {
+  string file_path = trace_file_path_prefix_ +
+                     GetTraceFileName(trace_file->package, trace_file->version);
+  if (rotate_max_bytes_ <= 0 && rotate_interval_ns_ <= 0) {
+    return file_path;
+  }
+  // All the segments are named after the first one, so that they sort in
+  // order.
+  static constexpr char kTraceFileSuffix[] = ".vts.trace";
+  if (trace_file->segment_path_prefix.empty()) {
+    trace_file->segment_path_prefix =
+        file_path.substr(0, file_path.size() - strlen(kTraceFileSuffix));
+  }
+  char segment[16];
+  snprintf(segment, sizeof(segment), "_%05d", trace_file->next_segment++);
+  return trace_file->segment_path_prefix + segment + kTraceFileSuffix;
+}
 
+void VtsProfilingInterface::CompleteSegment(TraceFile* trace_file,
+                                            const string& path) {
+  Mutex::Autolock lock(index_mutex_);
+  if (!compact_trace_ && !compress_trace_) {
+    // Indexing reads the whole segment, which is left to the indexing thread
+    // rather than delaying the traced call.
+    if (!index_thread_.joinable()) {
+      index_thread_ = thread(&VtsProfilingInterface::IndexSegments, this);
+    }
+    index_queue_.push_back(path);
+    index_cond_.signal();
+  }
+  trace_file->completed_segments.push_back(path);
+  while (rotate_keep_ > 0 && trace_file->completed_segments.size() >
+                                 static_cast<size_t>(rotate_keep_)) {
+    const string& oldest = trace_file->completed_segments.front();
+    LOG(INFO) << "Removing trace file: " << oldest;
+    index_queue_.erase(remove(index_queue_.begin(), index_queue_.end(), oldest),
+                       index_queue_.end());
+    unlink(oldest.c_str());
+    unlink(VtsTraceReader::IndexFileName(oldest).c_str());
+    trace_file->completed_segments.pop_front();
+  }
+}
+
+void VtsProfilingInterface::IndexSegments() {
+  Mutex::Autolock lock(index_mutex_);
+  while (true) {
+    while (index_queue_.empty() && !index_thread_stop_) {
+      index_cond_.wait(index_mutex_);
+    }
+    if (index_queue_.empty()) {
+      return;
+    }
+    string path = move(index_queue_.front());
+    index_queue_.pop_front();
+    index_mutex_.unlock();
+    if (!VtsTraceReader::Open(path)) {
+      PLOG(WARNING) << "Failed to index trace file: " << path;
+    } else if (access(path.c_str(), F_OK) != 0) {
+      // The segment was removed while it was indexed.
+      unlink(VtsTraceReader::IndexFileName(path).c_str());
+    }
+    index_mutex_.lock();
+  }
+}
+
+int VtsProfilingInterface::CreateTraceFile(const string& file_path) {
   LOG(INFO) << "Creating new trace file: " << file_path;
   int fd = open(file_path.c_str(), O_RDWR | O_CREAT | O_EXCL,
                 S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
@@ -105,38 +1024,511 @@ int VtsProfilingInterface::CreateTraceFile(const string& package,
   return fd;
 }
 
+int VtsProfilingInterface::CreateRingBuffer(TraceFile* trace_file) {
+  string name = GetTraceFileName(trace_file->package, trace_file->version);
+  int fd = ashmem_create_region(name.c_str(), kRingDataOffset + ring_capacity_);
+  if (fd < 0) {
+    PLOG(ERROR) << "Can not create shared memory for trace: " << name;
+    return -1;
+  }
+  trace_file->ring = VtsTraceRingBuffer::Create(fd, ring_capacity_);
+  if (!trace_file->ring) {
+    PLOG(ERROR) << "Can not map shared memory for trace: " << name;
+    close(fd);
+    return -1;
+  }
+  trace_file->collector_socket =
+      registerRingBuffer(collector_socket_path_, name, fd);
+  if (trace_file->collector_socket < 0) {
+    PLOG(WARNING) << "Can not register trace " << name
+                  << " with the collector at " << collector_socket_path_
+                  << ", writing a trace file instead.";
+    trace_file->ring.reset();
+    close(fd);
+    return -1;
+  }
+  LOG(INFO) << "Writing trace " << name << " to shared memory.";
+  return fd;
+}
+
+void VtsProfilingInterface::ReleaseRingBuffer(TraceFile* trace_file) {
+  if (trace_file->ring && trace_file->ring->DroppedCount() > 0) {
+    LOG(WARNING) << "Dropped " << trace_file->ring->DroppedCount()
+                 << " writes to a full trace ring buffer.";
+  }
+  trace_file->ring.reset();
+  if (trace_file->collector_socket >= 0) {
+    close(trace_file->collector_socket);
+    trace_file->collector_socket = -1;
+  }
+}
+
+string VtsProfilingInterface::GetTraceFileName(const string& package,
+                                               const string& version) {
+  // Attach device info and timestamp for the trace file.
+  char build_number[PROPERTY_VALUE_MAX];
+  char device_id[PROPERTY_VALUE_MAX];
+  char product_name[PROPERTY_VALUE_MAX];
+  property_get("ro.build.version.incremental", build_number, "unknown_build");
+  property_get("ro.serialno", device_id, "unknown_device");
+  property_get("ro.build.product", product_name, "unknown_product");
+
+  return package + "_" + version + "_" + string(product_name) + "_" +
+         string(device_id) + "_" + string(build_number) + "_" +
+         to_string(NanoTime()) + ".vts.trace";
+}
+
+void VtsProfilingInterface::SerializeRecord(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, int64_t timestamp, int32_t thread_id,
+    uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+    const FunctionSpecificationMessage& message, string* data) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  // The record is serialized by hand so that the metadata fields, which are
+  // the same for all the events of the HAL, are not copied into a new
+  // VtsProfilingRecord for each event.
+  int event_type = static_cast<int>(event);
+  int message_size = message.ByteSize();
+  size_t record_size =
+      WireFormatLite::TagSize(VtsProfilingRecord::kTimestampFieldNumber,
+                              WireFormatLite::TYPE_INT64) +
+      WireFormatLite::Int64Size(timestamp) +
+      WireFormatLite::TagSize(VtsProfilingRecord::kEventFieldNumber,
+                              WireFormatLite::TYPE_ENUM) +
+      WireFormatLite::EnumSize(event_type) + hal->record_metadata.size() +
+      WireFormatLite::TagSize(VtsProfilingRecord::kFuncMsgFieldNumber,
+                              WireFormatLite::TYPE_MESSAGE) +
+      WireFormatLite::LengthDelimitedSize(message_size) +
+      WireFormatLite::TagSize(VtsProfilingRecord::kThreadIdFieldNumber,
+                              WireFormatLite::TYPE_INT32) +
+      WireFormatLite::Int32Size(thread_id);
+  if (call_id != 0) {
+    record_size +=
+        WireFormatLite::TagSize(VtsProfilingRecord::kCallIdFieldNumber,
+                                WireFormatLite::TYPE_UINT64) +
+        WireFormatLite::UInt64Size(call_id);
+  }
+  bool has_cpu_time = cpu_sample.cpu_time_ns >= 0;
+  if (has_cpu_time) {
+    record_size +=
+        WireFormatLite::TagSize(VtsProfilingRecord::kThreadCpuTimeFieldNumber,
+                                WireFormatLite::TYPE_INT64) +
+        WireFormatLite::Int64Size(cpu_sample.cpu_time_ns) +
+        WireFormatLite::TagSize(VtsProfilingRecord::kCpuFieldNumber,
+                                WireFormatLite::TYPE_INT32) +
+        WireFormatLite::Int32Size(cpu_sample.cpu);
+  }
+  data->resize(CodedOutputStream::VarintSize32(record_size) + record_size);
+
+  uint8_t* target = reinterpret_cast<uint8_t*>(&(*data)[0]);
+  target = CodedOutputStream::WriteVarint32ToArray(record_size, target);
+  target = WireFormatLite::WriteInt64ToArray(
+      VtsProfilingRecord::kTimestampFieldNumber, timestamp, target);
+  target = WireFormatLite::WriteEnumToArray(
+      VtsProfilingRecord::kEventFieldNumber, event_type, target);
+  target = CodedOutputStream::WriteRawToArray(hal->record_metadata.data(),
+                                              hal->record_metadata.size(),
+                                              target);
+  target = WireFormatLite::WriteTagToArray(
+      VtsProfilingRecord::kFuncMsgFieldNumber,
+      WireFormatLite::WIRETYPE_LENGTH_DELIMITED, target);
+  target = CodedOutputStream::WriteVarint32ToArray(message_size, target);
+  target = message.SerializeWithCachedSizesToArray(target);
+  target = WireFormatLite::WriteInt32ToArray(
+      VtsProfilingRecord::kThreadIdFieldNumber, thread_id, target);
+  if (call_id != 0) {
+    target = WireFormatLite::WriteUInt64ToArray(
+        VtsProfilingRecord::kCallIdFieldNumber, call_id, target);
+  }
+  if (has_cpu_time) {
+    target = WireFormatLite::WriteInt64ToArray(
+        VtsProfilingRecord::kThreadCpuTimeFieldNumber, cpu_sample.cpu_time_ns,
+        target);
+    WireFormatLite::WriteInt32ToArray(VtsProfilingRecord::kCpuFieldNumber,
+                                      cpu_sample.cpu, target);
+  }
+}
+
 void VtsProfilingInterface::AddTraceEvent(
     android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
     const char* package, const char* version, const char* interface,
     const FunctionSpecificationMessage& message) {
-  std::string version_str = std::string(version);
-  int version_major = stoi(version_str.substr(0, version_str.find('.')));
-  int version_minor = stoi(version_str.substr(version_str.find('.') + 1));
-  // Build the VTSProfilingRecord and print it to string.
-  VtsProfilingRecord record;
-  record.set_timestamp(NanoTime());
-  record.set_event((InstrumentationEventType) static_cast<int>(event));
-  record.set_package(package);
-  record.set_version_major(version_major);
-  record.set_version_minor(version_minor);
-  record.set_interface(interface);
-  *record.mutable_func_msg() = message;
-
-  // Write the record string to trace file.
-  mutex_.lock();
-  int fd = GetTraceFile(package, version);
+  AddTraceEvent(event, GetHalDescriptor(package, version, interface), message);
+}
+
+void VtsProfilingInterface::AddTraceEvent(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, const FunctionSpecificationMessage& message) {
+  static thread_local int32_t thread_id = gettid();
+  // Taken first so that the entry and exit events of the calls stay paired
+  // whatever happens to the events.
+  uint64_t call_id = GetCallId(event);
+  if (hal == nullptr) {
+    LOG(ERROR) << "Failed to get HAL descriptor.";
+    return;
+  }
+  int64_t timestamp = trace_clock_.Now();
+  VtsThreadCpuSample cpu_sample;
+  if (capture_cpu_time_) {
+    cpu_sample = VtsThreadCpuSample::Now();
+  }
+  // No trace file is written in steady state in flight recorder mode.
+  if (flight_recorder_) {
+    AddFlightRecorderEvent(event, hal, timestamp, thread_id, call_id,
+                           cpu_sample, message);
+    return;
+  }
+  int fd = GetTraceFile(hal->trace_file_handle);
   if (fd == -1) {
     LOG(ERROR) << "Failed to get trace file.";
-  } else {
-    google::protobuf::io::FileOutputStream trace_output(fd);
-    if (!writeOneDelimited(record, &trace_output)) {
-      LOG(ERROR) << "Failed to write record.";
+    return;
+  }
+
+  if (compact_trace_) {
+    AddCompactTraceEvent(event, hal, timestamp, thread_id, call_id,
+                         cpu_sample, message);
+    return;
+  }
+
+  if (trace_writer_) {
+    string data;
+    SerializeRecord(event, hal, timestamp, thread_id, call_id, cpu_sample,
+                    message, &data);
+    // The trace writer resolves the file of the generation, so no lock is
+    // needed. The generation is read while the buffer of the thread is held,
+    // so that its file is not handed over before the record is queued.
+    TraceFile* trace_file = &trace_files_[hal->trace_file_handle];
+    VtsTraceWriter::PendingWrite write = trace_writer_->BeginWrite();
+    trace_file->segment_bytes += data.size();
+    write.Write(hal->trace_file_handle, trace_file->generation, timestamp,
+                move(data));
+    return;
+  }
+
+  // Write the record to trace file. The serialization buffer is reused across
+  // the events of the thread.
+  static thread_local string data;
+  SerializeRecord(event, hal, timestamp, thread_id, call_id, cpu_sample,
+                  message, &data);
+  mutex_.lock();
+  // The trace file may have been replaced since fd was returned.
+  TraceFile* trace_file = &trace_files_[hal->trace_file_handle];
+  if (!WriteTraceData(trace_file, trace_file->fd, data)) {
+    PLOG(ERROR) << "Failed to write record.";
+    // Check the trace file before the next write.
+    trace_file->needs_check = true;
+  }
+  mutex_.unlock();
+}
+
+void VtsProfilingInterface::AddCompactTraceEvent(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, int64_t timestamp, int32_t thread_id,
+    uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+    const FunctionSpecificationMessage& message) {
+  // Reused in sync mode, moved to the trace writer in async mode.
+  static thread_local string data;
+  data.clear();
+  TraceFile* trace_file = &trace_files_[hal->trace_file_handle];
+
+  if (!trace_writer_) {
+    // The encoder is replaced whenever the trace file is recreated, and both
+    // are only changed with mutex_ held.
+    Mutex::Autolock lock(mutex_);
+    int fd = trace_file->fd;
+    CompactEncoder* encoder = trace_file->encoder.get();
+    if (fd < 0 || encoder == nullptr) {
+      LOG(ERROR) << "Failed to get trace file.";
+      return;
     }
-    if (!trace_output.Flush()) {
-      PLOG(ERROR) << "Failed to flush";
+    // The definitions are written along with the event.
+    uint32_t hal_id = encoder->encoder.GetHalId(
+        hal->package, hal->version_major, hal->version_minor, hal->interface,
+        &data);
+    encoder->encoder.EncodeEvent(timestamp, static_cast<int>(event), hal_id,
+                                 message, thread_id, call_id, cpu_sample,
+                                 &data, &data);
+    if (!WriteTraceData(trace_file, fd, data)) {
+      PLOG(ERROR) << "Failed to write record.";
+      trace_file->needs_check = true;
     }
+    return;
   }
-  mutex_.unlock();
+
+  // The ids and the timestamp of the last event of the thread in the current
+  // generation of a trace file.
+  struct ThreadState {
+    uint64_t generation = 0;
+    unordered_map<const HalDescriptor*, uint32_t> hal_ids;
+    unordered_map<string, uint32_t> method_ids;
+    int64_t last_timestamp = VtsCompactTraceEncoder::kNoTimestamp;
+  };
+  static thread_local map<const TraceFile*, ThreadState> thread_states;
+
+  // As in AddTraceEvent, the encoder is loaded while the buffer of the thread
+  // is held.
+  VtsTraceWriter::PendingWrite write = trace_writer_->BeginWrite();
+  shared_ptr<CompactEncoder> encoder = atomic_load(&trace_file->encoder);
+  if (encoder == nullptr) {
+    LOG(ERROR) << "Failed to get trace file.";
+    return;
+  }
+  ThreadState& state = thread_states[trace_file];
+  if (state.generation != encoder->generation) {
+    state = ThreadState();
+    state.generation = encoder->generation;
+  }
+  auto found_hal = state.hal_ids.find(hal);
+  auto found_method = state.method_ids.find(message.name());
+  if (found_hal == state.hal_ids.end() ||
+      found_method == state.method_ids.end()) {
+    // Only the first event of each method of a thread gets here. The
+    // definitions are queued before the ids can be used by any thread, so
+    // that they precede in the trace file all the events that refer to them.
+    string definitions;
+    Mutex::Autolock lock(trace_file->encoder_mutex);
+    uint32_t hal_id = encoder->encoder.GetHalId(
+        hal->package, hal->version_major, hal->version_minor, hal->interface,
+        &definitions);
+    uint32_t method_id =
+        encoder->encoder.GetStringId(message.name(), &definitions);
+    if (!definitions.empty()) {
+      trace_file->segment_bytes += definitions.size();
+      trace_writer_->WriteAhead(hal->trace_file_handle, encoder->generation,
+                                move(definitions));
+    }
+    found_hal = state.hal_ids.emplace(hal, hal_id).first;
+    found_method = state.method_ids.emplace(message.name(), method_id).first;
+  }
+  VtsCompactTraceEncoder::EncodeEventWithIds(
+      timestamp, &state.last_timestamp, static_cast<int>(event),
+      found_hal->second, found_method->second, message, thread_id, call_id,
+      cpu_sample, &data);
+  trace_file->segment_bytes += data.size();
+  write.Write(hal->trace_file_handle, encoder->generation, timestamp,
+              move(data));
+}
+
+void VtsProfilingInterface::AddFlightRecorderEvent(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, int64_t timestamp, int32_t thread_id,
+    uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+    const FunctionSpecificationMessage& message) {
+  static thread_local string data;
+  SerializeRecord(event, hal, timestamp, thread_id, call_id, cpu_sample,
+                  message, &data);
+  {
+    Mutex::Autolock lock(mutex_);
+    TraceFile* trace_file = &trace_files_[hal->trace_file_handle];
+    if (!trace_file->flight_recorder) {
+      // The path is set first, the signal handler may read both at any time.
+      trace_file->crash_trace_path =
+          trace_file_path_prefix_ +
+          GetTraceFileName(trace_file->package, trace_file->version);
+      trace_file->flight_recorder.reset(
+          new VtsFlightRecorder(flight_recorder_capacity_));
+    }
+    if (!trace_file->flight_recorder->Append(data)) {
+      LOG(WARNING) << "Trace record larger than the flight recorder: "
+                   << data.size() << " bytes.";
+    }
+  }
+  if (IsFlightRecorderTrigger(event, hal, message) ||
+      IsFlightRecorderDumpRequested()) {
+    DumpFlightRecorders();
+  }
+}
+
+VtsProfilingInterface::FlightRecorderTrigger
+VtsProfilingInterface::ParseFlightRecorderTrigger(const string& value) {
+  FlightRecorderTrigger trigger;
+  if (value.empty()) {
+    return trigger;
+  }
+  string name = value;
+  size_t value_pos = value.find('=');
+  if (value_pos != string::npos) {
+    name = value.substr(0, value_pos);
+    trigger.has_value = true;
+    trigger.value = value.substr(value_pos + 1);
+  }
+  size_t version_pos = name.find('@');
+  size_t interface_pos = name.find("::");
+  size_t method_pos = interface_pos == string::npos
+                          ? string::npos
+                          : name.find("::", interface_pos + 2);
+  if (version_pos == string::npos || interface_pos == string::npos ||
+      method_pos == string::npos || version_pos > interface_pos) {
+    LOG(ERROR) << "Invalid flight recorder trigger: " << value;
+    return trigger;
+  }
+  trigger.enabled = true;
+  trigger.package = name.substr(0, version_pos);
+  trigger.version =
+      name.substr(version_pos + 1, interface_pos - version_pos - 1);
+  trigger.interface =
+      name.substr(interface_pos + 2, method_pos - interface_pos - 2);
+  trigger.method = name.substr(method_pos + 2);
+  return trigger;
+}
+
+bool VtsProfilingInterface::IsFlightRecorderTrigger(
+    android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+    const HalDescriptor* hal, const FunctionSpecificationMessage& message) {
+  const FlightRecorderTrigger& trigger = flight_recorder_trigger_;
+  // The exit event ends the records of the call, with its return values.
+  if (!trigger.enabled || isEntryEvent(event) ||
+      message.name() != trigger.method || hal->interface != trigger.interface ||
+      hal->package != trigger.package || hal->version != trigger.version) {
+    return false;
+  }
+  if (!trigger.has_value) {
+    return true;
+  }
+  if (message.return_type_hidl_size() == 0) {
+    return false;
+  }
+  // Scalars and enums both hold their value in a field of scalar_value.
+  const ScalarDataValueMessage& scalar_value =
+      message.return_type_hidl(0).scalar_value();
+  vector<const google::protobuf::FieldDescriptor*> fields;
+  scalar_value.GetReflection()->ListFields(scalar_value, &fields);
+  if (fields.size() != 1) {
+    return false;
+  }
+  string value;
+  google::protobuf::TextFormat::PrintFieldValueToString(scalar_value,
+                                                        fields[0], -1, &value);
+  return value == trigger.value;
+}
+
+bool VtsProfilingInterface::IsFlightRecorderDumpRequested() {
+  uint32_t serial = __system_property_area_serial();
+  if (serial == flight_recorder_dump_serial_) {
+    return false;
+  }
+  flight_recorder_dump_serial_ = serial;
+  char request[PROPERTY_VALUE_MAX];
+  property_get("hal.instrumentation.profile.flight_recorder.dump", request,
+               "");
+  Mutex::Autolock lock(mutex_);
+  if (flight_recorder_dump_request_ == request) {
+    return false;
+  }
+  flight_recorder_dump_request_ = request;
+  return true;
+}
+
+bool VtsProfilingInterface::DumpFlightRecorders() {
+  if (!flight_recorder_) {
+    return false;
+  }
+  bool success = true;
+  Mutex::Autolock lock(mutex_);
+  for (int i = 0; i < trace_file_count_; i++) {
+    TraceFile* trace_file = &trace_files_[i];
+    const VtsFlightRecorder* recorder = trace_file->flight_recorder.get();
+    if (recorder == nullptr || recorder->Size() == 0) {
+      continue;
+    }
+    int fd = CreateTraceFile(
+        trace_file_path_prefix_ +
+        GetTraceFileName(trace_file->package, trace_file->version));
+    if (fd < 0) {
+      success = false;
+      continue;
+    }
+    bool written;
+    if (compress_trace_) {
+      string data;
+      recorder->Read(&data);
+      VtsTraceCompressor compressor(fd);
+      written =
+          compressor.Write(data.data(), data.size()) && compressor.Flush();
+    } else {
+      written = recorder->WriteTo(fd);
+    }
+    if (!written) {
+      PLOG(ERROR) << "Failed to write flight recorder trace.";
+      success = false;
+    } else if (recorder->EvictedCount() > 0) {
+      LOG(INFO) << "Flight recorder trace written, " << recorder->EvictedCount()
+                << " older records evicted.";
+    }
+    close(fd);
+  }
+  return success;
+}
+
+void VtsProfilingInterface::HandleFatalSignal(int signal, siginfo_t* info,
+                                              void* /*context*/) {
+  // Only the first fatal signal writes the flight recorders. The mutex is not
+  // taken, the thread that got the signal may hold it.
+  VtsProfilingInterface* instance = flight_recorder_instance.exchange(nullptr);
+  if (instance != nullptr) {
+    int trace_file_count = instance->trace_file_count_;
+    for (int i = 0; i < trace_file_count; i++) {
+      const TraceFile& trace_file = instance->trace_files_[i];
+      const VtsFlightRecorder* recorder = trace_file.flight_recorder.get();
+      if (recorder == nullptr || recorder->Size() == 0) {
+        continue;
+      }
+      int fd = open(trace_file.crash_trace_path.c_str(),
+                    O_WRONLY | O_CREAT | O_EXCL,
+                    S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+      if (fd >= 0) {
+        recorder->WriteTo(fd);
+        close(fd);
+      }
+    }
+  }
+  // Let the previous handler, e.g. debuggerd's, handle the signal. A fault
+  // happens again when the handler returns, a signal sent by a process does
+  // not and is sent again.
+  sigaction(signal, &previous_fatal_signal_actions[signal], nullptr);
+  if (info->si_code <= 0) {
+    raise(signal);
+  }
+}
+
+bool VtsProfilingInterface::WriteTraceData(TraceFile* trace_file, int fd,
+                                           const string& data) {
+  if (trace_file->ring) {
+    // Events dropped because the ring is full are counted in the ring rather
+    // than reported as write errors. Only compact traces need to be
+    // restarted, see CheckTraceFile.
+    if (!trace_file->ring->Write(data.data(), data.size()) && compact_trace_) {
+      trace_file->needs_check = true;
+    }
+    return true;
+  }
+  trace_file->segment_bytes += data.size();
+  if (trace_file->compressor) {
+    return trace_file->compressor->Write(data.data(), data.size());
+  }
+  if (compress_trace_) {
+    // In async mode, the trace writer compresses the events. Data written
+    // directly goes into a block of its own.
+    VtsTraceCompressor compressor(fd);
+    return compressor.Write(data.data(), data.size()) && compressor.Flush();
+  }
+  return WriteFully(fd, data);
+}
+
+bool VtsProfilingInterface::WriteFully(int fd, const string& data) {
+  const char* buffer = data.data();
+  size_t remaining = data.size();
+  while (remaining > 0) {
+    ssize_t written = TEMP_FAILURE_RETRY(write(fd, buffer, remaining));
+    if (written < 0) {
+      return false;
+    }
+    buffer += written;
+    remaining -= written;
+  }
+  return true;
 }
 
 }  // namespace vts
@@ -20,9 +20,24 @@
 #include <android-base/macros.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <hidl/HidlSupport.h>
+#include <signal.h>
 #include <utils/Condition.h>
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
 
+#include "VtsCompactTrace.h"
+#include "VtsFlightRecorder.h"
+#include "VtsLatencyHistogram.h"
+#include "VtsProfilingArgsPolicy.h"
+#include "VtsTraceClock.h"
+#include "VtsTraceCompression.h"
+#include "VtsTraceRingBuffer.h"
+#include "VtsTraceWriter.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
 using namespace std;
@@ -31,6 +46,96 @@ namespace android {
 namespace vts {
 
 // Library class to trace, record and profile a HIDL HAL implementation.
+//
+// By default, each trace event is written to the trace file synchronously.
+// If the system property hal.instrumentation.profile.async is set, the events
+// are buffered in memory and written by a background thread instead. The
+// buffer size and the high-water mark (in bytes) that triggers a write are
+// configured by hal.instrumentation.profile.async.buffer_size and
+// hal.instrumentation.profile.async.high_water_mark.
+//
+// If hal.instrumentation.profile.compact is set, the trace files are written
+// in the compact format defined in VtsCompactTrace.h instead of as delimited
+// VtsProfilingRecord. If hal.instrumentation.profile.compress is set, the
+// trace files are compressed as defined in VtsTraceCompression.h. Compact
+// traces are timestamped with the CPU counter rather than the steady clock if
+// hal.instrumentation.profile.clock is "counter", see VtsTraceClock.h.
+//
+// If hal.instrumentation.profile.sampling is set, only a sample of the calls
+// of each method is traced: one in hal.instrumentation.profile.sampling.rate
+// calls, and at most one every hal.instrumentation.profile.sampling.interval_ms
+// milliseconds. Both can be overridden for a method with the properties
+// suffixed by .<interface>.<method>, e.g.
+// hal.instrumentation.profile.sampling.rate.ISensors.poll. Independently,
+// hal.instrumentation.profile.max_events_per_second limits the number of
+// events traced per second for each interface. The exit event of a call is
+// traced if and only if its entry event is.
+//
+// If hal.instrumentation.profile.aggregate is set, no event is traced.
+// Instead, the entry and exit events of each call are paired in the process
+// and the latency of the call is counted in a histogram of its method, see
+// VtsLatencyHistogram.h. The call counts and latency percentiles of the
+// methods are written to vts_profiling_summary_<pid>.txt, next to the trace
+// files, every hal.instrumentation.profile.aggregate.interval_ms
+// milliseconds and whenever hal.instrumentation.profile.aggregate.dump
+// changes, see vts_profiling_configure. The filter applies, the sampling and
+// rate limiting do not.
+//
+// If hal.instrumentation.profile.cpu_time is set, each trace event also
+// records the CPU time of its thread and the CPU it runs on (see
+// thread_cpu_time and cpu in VtsProfilingRecord), so that the latency of a
+// call can be split into the time it ran and the time it waited.
+//
+// Vectors and arrays of scalars are recorded as raw bytes (see
+// vector_raw_value in VariableSpecificationMessage), which
+// hal.instrumentation.profile.args.max_raw_bytes can truncate. Which values
+// are captured at all is chosen per method when the profiler is built, see
+// VtsProfilingArgsPolicy.h.
+//
+// If hal.instrumentation.profile.shm is set, the data of each trace file is
+// written into a shared memory ring buffer (see VtsTraceRingBuffer.h) of
+// hal.instrumentation.profile.shm.buffer_size bytes, registered with the
+// vts_trace_collector listening on hal.instrumentation.profile.shm.socket,
+// instead of into a file. Writing to the ring never blocks; the events that
+// do not fit are dropped. The async and compress modes do not apply to the
+// rings. If no collector is listening, the trace file is written as usual.
+//
+// If hal.instrumentation.profile.rotate.max_bytes or
+// hal.instrumentation.profile.rotate.interval_ms is set, the trace file of
+// each HAL is split into segments named after the first one with a sequence
+// number, e.g. <...>_<time>_00003.vts.trace. A new segment is started once
+// the current one holds max_bytes bytes of records (before compression), or
+// is interval_ms milliseconds old. Only the last
+// hal.instrumentation.profile.rotate.keep completed segments are kept, all of
+// them if 0. A segment is complete once the next one exists; the index of a
+// segment of delimited records that is not compressed (see VtsTraceReader.h)
+// is then written in the background, so that the segments can be processed
+// while tracing goes on. The shm mode does not rotate.
+//
+// If hal.instrumentation.profile.flight_recorder is set, nothing is written
+// in steady state. Instead, the latest records of each HAL are kept in an
+// in-memory ring of hal.instrumentation.profile.flight_recorder.buffer_size
+// bytes (see VtsFlightRecorder.h), and the rings are written to new trace
+// files:
+//   - whenever hal.instrumentation.profile.flight_recorder.dump changes,
+//     on the next traced call, see vts_profiling_configure;
+//   - when the process gets a fatal signal, uncompressed;
+//   - after a call of the method given by
+//     hal.instrumentation.profile.flight_recorder.trigger, as
+//     <package>@<version>::<interface>::<method>, optionally followed by
+//     =<value> to only trigger if the first return value is <value>, e.g.
+//     android.hardware.nfc@1.0::INfc::open=1. The return values are only
+//     captured if hal.instrumentation.profile.args is set.
+// Each trace file written holds the records of the ring at the time, which
+// keeps them. The records are never compact, and the async and shm modes do
+// not apply.
+//
+// If hal.instrumentation.profile.filter.0 is set, only the HALs listed by
+// hal.instrumentation.profile.filter.0, .1, ... up to the first property
+// that is not set are traced. Each lists a <package>@<version>, optionally
+// followed by ::<interface> and ::<method>, e.g.
+// android.hardware.nfc@1.0::INfc::open. The filter is read again after a
+// system property has changed, see vts_profiling_configure.
 class VtsProfilingInterface {
  public:
   explicit VtsProfilingInterface(const string& trace_file_path);
@@ -40,29 +145,424 @@ class VtsProfilingInterface {
   // Get and create the VtsProfilingInterface singleton.
   static VtsProfilingInterface& getInstance(const string& trace_file_path);
 
+  // Metadata of a traced HAL interface, registered once and reused for all
+  // the trace events of the interface.
+  struct HalDescriptor {
+    string package;
+    // Version string, e.g. 1.0.
+    string version;
+    int version_major;
+    int version_minor;
+    string interface;
+    // Handle of the trace file of the HAL, see RegisterTraceFile.
+    int trace_file_handle;
+    // The serialized package, version and interface fields of the
+    // VtsProfilingRecord, shared by all the records of the interface.
+    string record_metadata;
+    // Start of the current one second window of the event budget, and the
+    // number of events traced in it. Only used by ShouldTraceEvent.
+    mutable atomic<int64_t> budget_window_start;
+    mutable atomic<int64_t> budget_used;
+    // Whether the interface is traced by the trace filter, cached as the
+    // generation of the filter shifted left by 2 bits ored with a
+    // FilterState. 0 if not computed yet. Only used by IsTracedByFilter.
+    mutable atomic<uint64_t> filter_cache;
+  };
+
+  // Returns the FNV-1a hash of the given method name. Generated profilers
+  // switch on the hash of the traced method, with the hashes of the known
+  // methods computed at compile time, so that dispatching an event does not
+  // depend on the number of methods of the interface. A collision between
+  // two methods of an interface shows up as a duplicate case value at
+  // compile time.
+  static constexpr uint32_t HashMethodName(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name != '\0'; name++) {
+      hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+    }
+    return hash;
+  }
+
+  // Registers the trace file for a HAL with given package and version and
+  // returns its handle, or -1 if no more trace file could be registered.
+  // Registering the same HAL again returns the same handle.
+  int RegisterTraceFile(const string& package, const string& version);
+
+  // Registers a HAL interface with given package, version and interface name
+  // and returns its descriptor, or nullptr if the HAL could not be
+  // registered. Registering the same interface again returns the same
+  // descriptor. The descriptor lives as long as this object.
+  const HalDescriptor* RegisterHal(const string& package, int version_major,
+                                   int version_minor, const string& interface);
+
+  // Returns the descriptor of the HAL interface with given package, version
+  // (e.g. "1.0") and interface name, registering it if needed. The result is
+  // cached per thread using the addresses of the given strings, so that the
+  // version is only parsed once per interface.
+  const HalDescriptor* GetHalDescriptor(const char* package,
+                                        const char* version,
+                                        const char* interface);
+
+  // Returns whether the arguments and return values of the traced methods
+  // should be profiled, i.e. the value of hal.instrumentation.profile.args.
+  // The property is only read again after a system property has changed, so
+  // this is cheap enough to call for every trace event.
+  bool IsProfilingArgsEnabled();
+
+  // Returns the number of bytes of a vector or array of count scalars of
+  // element_size bytes to record as raw bytes, i.e. all of them unless
+  // truncated to hal.instrumentation.profile.args.max_raw_bytes (rounded down
+  // to whole elements). Cheap enough to call for every argument.
+  static size_t GetRawValueSize(size_t count, size_t element_size);
+
+  // Fills fd_msg with the description of the file descriptor fd of a
+  // hidl_handle (path, type, mode, flags and ashmem size). The description is
+  // cached per process and only computed again when fd refers to another file
+  // (device, inode or mode changed), so that profiling the same handles over
+  // and over only costs a fstat. Returns false if fd is not valid.
+  static bool ProfileFileDescriptor(int fd, FdMessage* fd_msg);
+
+  // Returns whether the given event of the given method should be traced,
+  // according to the sampling and rate limiting configuration. Must be called
+  // once for every entry and exit event, before building the message of the
+  // event, as the exit event of a call follows the decision made for its
+  // entry event on the same thread. Always false in aggregate mode, where the
+  // events are aggregated instead.
+  bool ShouldTraceEvent(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, const char* method);
+
+  // Returns an empty message to build the trace event of a method call in.
+  // The message is allocated on an arena of the calling thread, which is
+  // reset by the next call on the same thread, so that building the message
+  // of an event does not allocate memory in the common case. The message is
+  // only valid until then and must not be kept after AddTraceEvent.
+  static FunctionSpecificationMessage& NewTraceMessage();
+
   // returns true if the given message is added to the tracing queue.
   void AddTraceEvent(
       android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
       const char* package, const char* version, const char* interface,
       const FunctionSpecificationMessage& message);
 
+  // Same as above, but for the HAL interface with the given descriptor
+  // returned by RegisterHal or GetHalDescriptor.
+  void AddTraceEvent(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, const FunctionSpecificationMessage& message);
+
+  // Writes the call count and latency distribution of each method called so
+  // far to the summary file of the process in aggregate mode. Returns false
+  // if not in aggregate mode or on error.
+  bool WriteSummary();
+
+  // Writes the records held by the flight recorders to new trace files.
+  // Returns false if not in flight recorder mode or on error.
+  bool DumpFlightRecorders();
+
  private:
-  // Internal method to get the corresponding trace file descriptor for a HAL
-  // with given package and version.
-  int GetTraceFile(const string& package, const string& version);
-  // Internal method to create a trace file based on the trace_file_path_prefix_
-  // the given package and version, the device info and the current time.
-  int CreateTraceFile(const string& package, const string& version);
+  // Maximum number of trace files (i.e. HALs) traced by a process.
+  static constexpr int kMaxTraceFiles = 128;
+  // Number of trace events after which the trace file is checked for
+  // validity.
+  static constexpr uint32_t kTraceFileCheckInterval = 1024;
+
+  // The encoder of a compact trace file, and the generation of the file.
+  struct CompactEncoder {
+    uint64_t generation;
+    VtsCompactTraceEncoder encoder;
+  };
+
+  // A trace file registered for a HAL.
+  struct TraceFile {
+    string package;
+    string version;
+    // Descriptor of the trace file, -1 if not created yet.
+    atomic<int> fd;
+    // Number of trace events since the last validity check.
+    atomic<uint32_t> event_count;
+    // Whether to check the validity before the next write.
+    atomic<bool> needs_check;
+    // Generation of the current trace file in async mode, unique in the
+    // process, which the records are queued for. The trace writer owns the
+    // files in async mode, see VtsTraceWriter::SetFile.
+    atomic<uint64_t> generation;
+    // Encoder of the current trace file in compact mode, replaced with the
+    // file. Accessed with the atomic shared_ptr functions, so that async mode
+    // encodes the events without mutex_. encoder_mutex serializes the
+    // definition of new strings and HALs in async mode.
+    shared_ptr<CompactEncoder> encoder;
+    Mutex encoder_mutex;
+    // Compressor of the current trace file in compress mode, if the trace
+    // events are written synchronously.
+    unique_ptr<VtsTraceCompressor> compressor;
+    // Ring buffer the trace data is written to in shm mode, and the socket
+    // connected to the collector it is registered with. fd is the descriptor
+    // of the shared memory region of the ring in that case.
+    unique_ptr<VtsTraceRingBuffer> ring;
+    int collector_socket = -1;
+    // Latest records of the HAL in flight recorder mode, created with its
+    // first record, and the path of the trace file it is written to on a
+    // fatal signal, computed beforehand.
+    unique_ptr<VtsFlightRecorder> flight_recorder;
+    string crash_trace_path;
+    // Path of the current trace file, and whether it is rotated, i.e. in
+    // rotation mode unless it is a ring. If so, the number of bytes written
+    // to it and its creation time, the sequence number of the next segment,
+    // the path of the segments without the sequence number and suffix, and
+    // the completed segments kept, the oldest first.
+    string path;
+    atomic<bool> rotated;
+    atomic<uint64_t> segment_bytes;
+    atomic<int64_t> segment_start_time;
+    int next_segment = 0;
+    string segment_path_prefix;
+    deque<string> completed_segments;
+  };
+
+  // The call that triggers a dump of the flight recorders, see
+  // hal.instrumentation.profile.flight_recorder.trigger.
+  struct FlightRecorderTrigger {
+    bool enabled = false;
+    string package;
+    string version;
+    string interface;
+    string method;
+    // Whether only the calls that return value trigger a dump.
+    bool has_value = false;
+    string value;
+  };
+
+  // Whether the methods of a HAL interface are traced by the trace filter.
+  enum FilterState { kTraceAll = 0, kTraceNone = 1, kTraceMethods = 2 };
+
+  // The HALs to trace, see hal.instrumentation.profile.filter.
+  struct TraceFilter {
+    // Whether all the HALs are traced, as no filter is set.
+    bool all = true;
+    // The <package>@<version> and <package>@<version>::<interface> entries.
+    set<string> hals;
+    // The <package>@<version>::<interface>::<method> entries.
+    set<string> methods;
+  };
+
+  // Sampling state and latencies of a method of a HAL interface.
+  struct MethodState {
+    // Trace one call in rate calls.
+    int64_t rate;
+    // Trace at most one call every interval_ns nano seconds.
+    int64_t interval_ns;
+    // Number of calls so far.
+    atomic<uint64_t> call_count;
+    // Time of the last traced call.
+    atomic<int64_t> last_sample_time;
+    // Latencies of the calls, only recorded in aggregate mode.
+    VtsLatencyHistogram latency;
+  };
+
+  // Internal method to decide whether the trace filter lets the events of the
+  // given method be traced. Only looks up the method when the filter lists
+  // methods of the interface.
+  bool IsTracedByFilter(const HalDescriptor* hal, const char* method);
+  // Internal method to read the trace filter from the system properties.
+  static TraceFilter ReadTraceFilter();
+  // Internal method to decide whether the call of an entry event should be
+  // traced.
+  bool SampleCall(const HalDescriptor* hal, const char* method,
+                  int64_t now);
+  // Internal method to get the state of the given method. The result is
+  // cached per thread using the addresses of the given descriptor and method
+  // name.
+  MethodState* GetMethodState(const HalDescriptor* hal, const char* method);
+  // Internal method to pair the given event with the other event of its call
+  // in aggregate mode, and record the latency of the call on its exit event.
+  void AggregateEvent(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, const char* method);
+  // Internal method to write the summary if it is due, or requested through
+  // hal.instrumentation.profile.aggregate.dump.
+  void CheckSummaryDump(int64_t now);
+  // Internal method to record an event in the flight recorder of its HAL, and
+  // dump the flight recorders if it is a trigger or a dump was requested.
+  void AddFlightRecorderEvent(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, int64_t timestamp, int32_t thread_id,
+      uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+      const FunctionSpecificationMessage& message);
+  // Internal method to parse the value of
+  // hal.instrumentation.profile.flight_recorder.trigger.
+  static FlightRecorderTrigger ParseFlightRecorderTrigger(const string& value);
+  // Internal method to decide whether the given event triggers a dump of the
+  // flight recorders.
+  bool IsFlightRecorderTrigger(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, const FunctionSpecificationMessage& message);
+  // Internal method to check whether a dump of the flight recorders was
+  // requested through hal.instrumentation.profile.flight_recorder.dump.
+  bool IsFlightRecorderDumpRequested();
+  // Handler of the fatal signals in flight recorder mode. Writes the flight
+  // recorders with async-signal-safe calls only, then lets the previous
+  // handler handle the signal.
+  static void HandleFatalSignal(int signal, siginfo_t* info, void* context);
+  // Internal method to get the trace file descriptor of the given handle. The
+  // descriptor is only checked for validity (and the trace file recreated if
+  // needed) every kTraceFileCheckInterval calls or after a write error.
+  int GetTraceFile(int trace_file_handle);
+  // Internal method to check the trace file and recreate it if needed, or
+  // start its next segment if due. Must be called with mutex_ held.
+  int CheckTraceFile(TraceFile* trace_file);
+  // Internal method to decide whether the current segment of trace_file is
+  // complete in rotation mode.
+  bool IsRotationDue(const TraceFile* trace_file);
+  // Internal method to get the path of the next trace file of trace_file,
+  // its next segment in rotation mode. Must be called with mutex_ held.
+  string GetNextTraceFilePath(TraceFile* trace_file);
+  // Internal method to index the completed segment of trace_file at path and
+  // remove the segments beyond the retention count. Called with mutex_ held,
+  // or on the thread of the trace writer in async mode; index_mutex_ guards
+  // the segments.
+  void CompleteSegment(TraceFile* trace_file, const string& path);
+  // Main loop of index_thread_, indexes the segments of index_queue_ until
+  // it is empty and index_thread_stop_ is set.
+  void IndexSegments();
+  // Internal method to get the id of the call of the given event: a new id
+  // for an entry event, the id of the entry event of the innermost call in
+  // progress on the thread for an exit event (0 if there is none).
+  uint64_t GetCallId(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event);
+  // Internal method to serialize a delimited VtsProfilingRecord for the
+  // given event into data.
+  void SerializeRecord(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, int64_t timestamp, int32_t thread_id,
+      uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+      const FunctionSpecificationMessage& message, string* data);
+  // Internal method to encode and write an event in the compact trace format.
+  // In async mode, the ids of the strings and HALs are cached per thread, so
+  // that encoding an event does not lock.
+  void AddCompactTraceEvent(
+      android::hardware::details::HidlInstrumentor::InstrumentationEvent event,
+      const HalDescriptor* hal, int64_t timestamp, int32_t thread_id,
+      uint64_t call_id, const VtsThreadCpuSample& cpu_sample,
+      const FunctionSpecificationMessage& message);
+  // Internal method to write data to the trace file, compressing it if
+  // needed. Must be called with mutex_ held.
+  bool WriteTraceData(TraceFile* trace_file, int fd, const string& data);
+  // Internal method to write all of data to fd.
+  static bool WriteFully(int fd, const string& data);
+  // Internal method to create the trace file at file_path.
+  int CreateTraceFile(const string& file_path);
+  // Internal method to create a ring buffer for trace_file and register it
+  // with the collector. Returns the descriptor of the shared memory region,
+  // or -1 on error.
+  int CreateRingBuffer(TraceFile* trace_file);
+  // Internal method to release the ring buffer of trace_file, if any.
+  void ReleaseRingBuffer(TraceFile* trace_file);
+  // Internal method to get the name of a new trace file for the given package
+  // and version, based on the device info and the current time.
+  string GetTraceFileName(const string& package, const string& version);
   // Get the current time in nano seconds.
   int64_t NanoTime();
 
   // Prefix of all trace files.
   string trace_file_path_prefix_;  // Prefix of the trace file.
 
-  // map between the HAL to the trace file description.
+  // map between the HAL to the trace file handle.
   map<string, int> trace_map_;
+  // Trace files indexed by handle, only the first trace_file_count_ entries
+  // are registered.
+  TraceFile trace_files_[kMaxTraceFiles];
+  atomic<int> trace_file_count_;
+  // map between the HAL interface to its descriptor.
+  map<string, unique_ptr<HalDescriptor>> hal_map_;
   Mutex mutex_;  // Mutex used to synchronize the writing to the trace file.
 
+  // Whether calls are sampled, and the default configuration of the
+  // samplers.
+  bool sampling_enabled_;
+  int64_t default_sampling_rate_;
+  int64_t default_sampling_interval_ns_;
+  // Maximum number of events per second traced for an interface, 0 if
+  // unlimited.
+  int64_t max_events_per_second_;
+  // States of all the methods seen so far, keyed by HAL interface and
+  // method name.
+  map<pair<const HalDescriptor*, string>, unique_ptr<MethodState>>
+      method_states_;
+
+  // Whether the calls are aggregated into latency histograms rather than
+  // traced.
+  bool aggregate_;
+  // Interval between two summaries written in aggregate mode, 0 if they are
+  // only written on request, and the time of the next one.
+  int64_t summary_interval_ns_;
+  atomic<int64_t> next_summary_time_;
+  // Serial of the system property area and value of
+  // hal.instrumentation.profile.aggregate.dump when last checked.
+  atomic<uint32_t> summary_request_serial_;
+  string summary_request_;
+  // Serializes WriteSummary, whose calls may come from several threads and
+  // share the temporary file the summary is written to.
+  Mutex summary_mutex_;
+
+  // Whether the records are kept in flight recorders rather than written, the
+  // capacity of the flight recorders and the call that triggers a dump.
+  bool flight_recorder_;
+  size_t flight_recorder_capacity_;
+  FlightRecorderTrigger flight_recorder_trigger_;
+  // Serial of the system property area and value of
+  // hal.instrumentation.profile.flight_recorder.dump when last checked.
+  atomic<uint32_t> flight_recorder_dump_serial_;
+  string flight_recorder_dump_request_;
+
+  // Id of the next call traced by the process.
+  atomic<uint64_t> next_call_id_;
+
+  // Cached value of hal.instrumentation.profile.args.
+  atomic<bool> profiling_args_enabled_;
+  // Serial of the system property area when profiling_args_enabled_ was
+  // read.
+  atomic<uint32_t> property_serial_;
+
+  // The trace filter, and its generation, incremented each time it is read.
+  TraceFilter trace_filter_;
+  atomic<uint64_t> trace_filter_generation_;
+  // Serial of the system property area when trace_filter_ was read.
+  atomic<uint32_t> trace_filter_serial_;
+  Mutex trace_filter_mutex_;  // Mutex used to synchronize trace_filter_.
+
+  // Whether the trace files are written in the compact format.
+  bool compact_trace_;
+  // Whether the events record the CPU time of their thread and their CPU.
+  bool capture_cpu_time_;
+  // Clock of the timestamps of the trace events.
+  VtsTraceClock trace_clock_;
+  // Whether the trace files are compressed.
+  bool compress_trace_;
+  // Whether the trace data is written into shared memory ring buffers, the
+  // size of their data and the socket of the collector to register them with.
+  bool shm_trace_;
+  size_t ring_capacity_;
+  string collector_socket_path_;
+
+  // Size and age of the segments, 0 if unlimited, and number of completed
+  // segments kept per HAL, 0 if all, in rotation mode.
+  int64_t rotate_max_bytes_;
+  int64_t rotate_interval_ns_;
+  int64_t rotate_keep_;
+
+  // Writer used in async mode, nullptr if trace events are written
+  // synchronously.
+  unique_ptr<VtsTraceWriter> trace_writer_;
+
+  // Completed segments waiting to be indexed, the oldest first, and the
+  // thread indexing them, started with the first one.
+  deque<string> index_queue_;
+  thread index_thread_;
+  bool index_thread_stop_;
+  Mutex index_mutex_;  // Mutex used to synchronize the fields above.
+  Condition index_cond_;
+
   DISALLOW_COPY_AND_ASSIGN(VtsProfilingInterface);
 };
 
@@ -16,6 +16,7 @@
 #include "VtsProfilingUtil.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #include "google/protobuf/io/coded_stream.h"
 
@@ -77,5 +78,106 @@ bool readOneDelimited(google::protobuf::MessageLite* message,
   return true;
 }
 
+// Appends the count elements of type T in data to var as scalar values.
+template <typename T, typename Field>
+static void expandElements(const std::string& data, size_t count,
+                           void (ScalarDataValueMessage::*setter)(Field),
+                           VariableSpecificationMessage* var) {
+  for (size_t i = 0; i < count; i++) {
+    T value;
+    memcpy(&value, data.data() + i * sizeof(T), sizeof(T));
+    VariableSpecificationMessage* element = var->add_vector_value();
+    element->set_type(TYPE_SCALAR);
+    (element->mutable_scalar_value()->*setter)(value);
+  }
+}
+
+static bool expandRawVectorValue(VariableSpecificationMessage* var) {
+  if (var->has_vector_raw_value()) {
+    const std::string& data = var->vector_raw_value();
+    const std::string& type = var->scalar_type();
+    size_t element_size = 0;
+    if (type == "bool_t" || type == "int8_t" || type == "uint8_t") {
+      element_size = 1;
+    } else if (type == "int16_t" || type == "uint16_t") {
+      element_size = 2;
+    } else if (type == "int32_t" || type == "uint32_t" || type == "float_t") {
+      element_size = 4;
+    } else if (type == "int64_t" || type == "uint64_t" || type == "double_t") {
+      element_size = 8;
+    }
+    if (element_size == 0 || data.size() % element_size != 0) {
+      return false;
+    }
+    size_t count = data.size() / element_size;
+    var->clear_vector_value();
+    if (type == "bool_t") {
+      expandElements<bool>(data, count, &ScalarDataValueMessage::set_bool_t,
+                           var);
+    } else if (type == "int8_t") {
+      expandElements<int8_t>(data, count, &ScalarDataValueMessage::set_int8_t,
+                             var);
+    } else if (type == "uint8_t") {
+      expandElements<uint8_t>(data, count,
+                              &ScalarDataValueMessage::set_uint8_t, var);
+    } else if (type == "int16_t") {
+      expandElements<int16_t>(data, count,
+                              &ScalarDataValueMessage::set_int16_t, var);
+    } else if (type == "uint16_t") {
+      expandElements<uint16_t>(data, count,
+                               &ScalarDataValueMessage::set_uint16_t, var);
+    } else if (type == "int32_t") {
+      expandElements<int32_t>(data, count,
+                              &ScalarDataValueMessage::set_int32_t, var);
+    } else if (type == "uint32_t") {
+      expandElements<uint32_t>(data, count,
+                               &ScalarDataValueMessage::set_uint32_t, var);
+    } else if (type == "int64_t") {
+      expandElements<int64_t>(data, count,
+                              &ScalarDataValueMessage::set_int64_t, var);
+    } else if (type == "uint64_t") {
+      expandElements<uint64_t>(data, count,
+                               &ScalarDataValueMessage::set_uint64_t, var);
+    } else if (type == "float_t") {
+      expandElements<float>(data, count, &ScalarDataValueMessage::set_float_t,
+                            var);
+    } else {
+      expandElements<double>(data, count,
+                             &ScalarDataValueMessage::set_double_t, var);
+    }
+    var->clear_vector_raw_value();
+    var->clear_scalar_type();
+    return true;
+  }
+  bool success = true;
+  for (auto& element : *var->mutable_vector_value()) {
+    success = expandRawVectorValue(&element) && success;
+  }
+  for (auto& field : *var->mutable_struct_value()) {
+    success = expandRawVectorValue(&field) && success;
+  }
+  for (auto& field : *var->mutable_union_value()) {
+    success = expandRawVectorValue(&field) && success;
+  }
+  for (auto& field : *var->mutable_safe_union_value()) {
+    success = expandRawVectorValue(&field) && success;
+  }
+  if (var->has_ref_value()) {
+    success = expandRawVectorValue(var->mutable_ref_value()) && success;
+  }
+  return success;
+}
+
+bool expandRawVectorValues(FunctionSpecificationMessage* func_msg) {
+  bool success = true;
+  for (auto& arg : *func_msg->mutable_arg()) {
+    success = expandRawVectorValue(&arg) && success;
+  }
+  for (auto& result : *func_msg->mutable_return_type_hidl()) {
+    success = expandRawVectorValue(&result) && success;
+  }
+  return success;
+}
+
 }  // namespace vts
 }  // namespace android
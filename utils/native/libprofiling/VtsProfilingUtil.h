@@ -19,6 +19,7 @@
 
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/message_lite.h"
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
 // This file defines methods for serialization of protobuf messages in the same
 // way as Java's writeDelimitedTo()/parseDelimitedFrom().
@@ -30,9 +31,18 @@ bool writeOneDelimited(const ::google::protobuf::MessageLite& message,
                        google::protobuf::io::ZeroCopyOutputStream* out);
 
 // Deserialize one message from the in file, delimited by message size.
+// Compressed trace files can be read through a
+// VtsTraceDecompressingInputStream.
 bool readOneDelimited(::google::protobuf::MessageLite* message,
                       google::protobuf::io::ZeroCopyInputStream* in);
 
+// Converts the vectors and arrays recorded as raw bytes (vector_raw_value) in
+// the arguments and return values of func_msg back into one vector_value per
+// element, the way they are given to the HAL drivers. Returns false if a raw
+// value is not a whole number of elements of its scalar_type, in which case
+// the value is left as is.
+bool expandRawVectorValues(FunctionSpecificationMessage* func_msg);
+
 }  // namespace vts
 }  // namespace android
 #endif  // DRIVERS_HAL_COMMON_UTILS_VTSPROFILINGUTIL_H_
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsTraceClock.h"
+
+#include <sched.h>
+#include <time.h>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+static constexpr int64_t kNanoSecondsPerSecond = 1000000000;
+// Time over which the frequency of the TSC is measured.
+static constexpr int64_t kCounterMeasureNs = 10000000;
+
+static int64_t realtimeNowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return ts.tv_sec * kNanoSecondsPerSecond + ts.tv_nsec;
+}
+
+int64_t VtsTraceClockCalibration::TicksToNs(int64_t ticks) const {
+  if (ticks_per_second == 0) {
+    return ticks;
+  }
+  // Split the conversion so that ticks * 10^9 does not overflow.
+  int64_t delta = ticks - anchor_ticks;
+  int64_t rate = static_cast<int64_t>(ticks_per_second);
+  int64_t seconds = delta / rate;
+  int64_t remainder = delta % rate;
+  return anchor_monotonic_ns + seconds * kNanoSecondsPerSecond +
+         remainder * kNanoSecondsPerSecond / rate;
+}
+
+VtsThreadCpuSample VtsThreadCpuSample::Now() {
+  VtsThreadCpuSample sample;
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    sample.cpu_time_ns = ts.tv_sec * kNanoSecondsPerSecond + ts.tv_nsec;
+  }
+  sample.cpu = sched_getcpu();
+  if (sample.cpu < 0) {
+    sample.cpu = -1;
+  }
+  return sample;
+}
+
+VtsTraceClock::VtsTraceClock(VtsTraceClockSource source)
+    : source_(kTraceClockSteady), ticks_per_second_(kNanoSecondsPerSecond) {
+  if (source == kTraceClockCounter && IsCounterAvailable()) {
+    uint64_t frequency = CounterFrequency();
+    if (frequency > 0) {
+      source_ = kTraceClockCounter;
+      ticks_per_second_ = frequency;
+    }
+  }
+}
+
+bool VtsTraceClock::IsCounterAvailable() {
+#if defined(__aarch64__)
+  // The virtual counter is always readable from user space on Android.
+  return true;
+#elif defined(__x86_64__) || defined(__i386__)
+  // Only an invariant TSC ticks at a constant rate across frequency changes
+  // and idle states.
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007 ||
+      !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  return (edx & (1 << 8)) != 0;
+#else
+  return false;
+#endif
+}
+
+uint64_t VtsTraceClock::CounterFrequency() {
+#if defined(__aarch64__)
+  uint64_t frequency;
+  asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+  return frequency;
+#elif defined(__x86_64__) || defined(__i386__)
+  int64_t start_ns = SteadyNowNs();
+  int64_t start_ticks = ReadCounter();
+  this_thread::sleep_for(chrono::nanoseconds(kCounterMeasureNs));
+  int64_t end_ns = SteadyNowNs();
+  int64_t end_ticks = ReadCounter();
+  if (end_ns <= start_ns || end_ticks <= start_ticks) {
+    return 0;
+  }
+  return static_cast<uint64_t>(
+      static_cast<double>(end_ticks - start_ticks) * kNanoSecondsPerSecond /
+      (end_ns - start_ns));
+#else
+  return 0;
+#endif
+}
+
+VtsTraceClockCalibration VtsTraceClock::Calibrate() const {
+  VtsTraceClockCalibration calibration;
+  calibration.source = source_;
+  calibration.ticks_per_second = ticks_per_second_;
+  // The counter is read between two reads of the steady clock, and anchored
+  // at their midpoint. The realtime clock, read right after, is moved back
+  // to the anchor.
+  int64_t before_ns = SteadyNowNs();
+  calibration.anchor_ticks = Now();
+  int64_t after_ns = SteadyNowNs();
+  int64_t realtime_ns = realtimeNowNs();
+  calibration.anchor_monotonic_ns =
+      source_ == kTraceClockSteady ? calibration.anchor_ticks
+                                   : before_ns + (after_ns - before_ns) / 2;
+  calibration.anchor_realtime_ns =
+      realtime_ns - (after_ns - calibration.anchor_monotonic_ns);
+  return calibration;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __VTS_PROFILING_TRACE_CLOCK_H_
+#define __VTS_PROFILING_TRACE_CLOCK_H_
+
+#include <stdint.h>
+#include <chrono>
+
+// This file defines the clocks the trace events are timestamped with.
+//
+// The steady clock (CLOCK_MONOTONIC) costs a vDSO call per event. The counter
+// clock reads the CPU counter instead, cntvct_el0 on arm64 and the TSC on
+// x86, and leaves the conversion of its ticks to nano seconds to the trace
+// readers: the trace records a VtsTraceClockCalibration, which maps the
+// ticks to CLOCK_MONOTONIC, the clock domain of the steady clock that all the
+// processes of a device share, and to CLOCK_REALTIME, so that the traces of
+// several processes (or devices) can be aligned.
+namespace android {
+namespace vts {
+
+enum VtsTraceClockSource : uint32_t {
+  // Ticks are CLOCK_MONOTONIC nano seconds.
+  kTraceClockSteady = 0,
+  // Ticks are those of the CPU counter.
+  kTraceClockCounter = 1,
+};
+
+// Maps the ticks of a clock to nano seconds.
+struct VtsTraceClockCalibration {
+  uint32_t source = kTraceClockSteady;
+  uint64_t ticks_per_second = 1000000000;
+  // The same instant in ticks, CLOCK_MONOTONIC and CLOCK_REALTIME.
+  int64_t anchor_ticks = 0;
+  int64_t anchor_monotonic_ns = 0;
+  int64_t anchor_realtime_ns = 0;
+
+  // Converts the given ticks to CLOCK_MONOTONIC nano seconds.
+  int64_t TicksToNs(int64_t ticks) const;
+
+  // Converts the given ticks to CLOCK_REALTIME nano seconds.
+  int64_t TicksToRealtimeNs(int64_t ticks) const {
+    return TicksToNs(ticks) - anchor_monotonic_ns + anchor_realtime_ns;
+  }
+};
+
+// The CPU time of a thread and the CPU it runs on at a trace event, to tell
+// the time a call spent running from the time it spent waiting.
+struct VtsThreadCpuSample {
+  // CLOCK_THREAD_CPUTIME_ID in nano seconds, -1 if not captured.
+  int64_t cpu_time_ns = -1;
+  // -1 if not captured.
+  int32_t cpu = -1;
+
+  // Returns the sample of the calling thread. The CPU number comes from the
+  // vDSO or rseq where the kernel provides them, but reading the thread CPU
+  // clock is a system call on most kernels.
+  static VtsThreadCpuSample Now();
+};
+
+class VtsTraceClock {
+ public:
+  // Uses the counter clock if source is kTraceClockCounter and the CPU
+  // counter is usable, otherwise the steady clock. The frequency of the TSC
+  // is measured, which takes a few milli seconds.
+  explicit VtsTraceClock(VtsTraceClockSource source = kTraceClockSteady);
+
+  // Returns whether the CPU counter can be read on this device.
+  static bool IsCounterAvailable();
+
+  VtsTraceClockSource Source() const { return source_; }
+
+  // Returns the current time in ticks.
+  int64_t Now() const {
+    if (source_ == kTraceClockCounter) {
+      return ReadCounter();
+    }
+    return SteadyNowNs();
+  }
+
+  // Returns a calibration of the clock anchored at the current time.
+  VtsTraceClockCalibration Calibrate() const;
+
+  static int64_t SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+ private:
+  static int64_t ReadCounter() {
+#if defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return static_cast<int64_t>(ticks);
+#elif defined(__x86_64__) || defined(__i386__)
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return static_cast<int64_t>((static_cast<uint64_t>(high) << 32) | low);
+#else
+    return SteadyNowNs();
+#endif
+  }
+
+  // Returns the frequency of the CPU counter, 0 if unknown.
+  static uint64_t CounterFrequency();
+
+  VtsTraceClockSource source_;
+  uint64_t ticks_per_second_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_TRACE_CLOCK_H_
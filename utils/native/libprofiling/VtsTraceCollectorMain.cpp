@@ -0,0 +1,291 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VtsTraceRingBuffer.h"
+
+using namespace std;
+using namespace android::vts;
+
+static constexpr const char* kDefaultSocketPath =
+    "/data/local/tmp/vts_trace_collector";
+static constexpr const char* kDefaultOutputDir = "/data/local/tmp/";
+// Interval between two drains of the ring buffers.
+static constexpr int kDrainIntervalMs = 10;
+
+// A ring buffer registered by an instrumented HAL process.
+struct RegisteredRing {
+  // Connection with the HAL process, closed when it stops tracing.
+  int socket_fd;
+  string name;
+  unique_ptr<VtsTraceRingBuffer> ring;
+  // Where the trace data goes.
+  int output_fd;
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void HandleSignal(int) { stop_requested = 1; }
+
+void ShowUsage() {
+  printf(
+      "Usage:   vts_trace_collector [options]\n"
+      "Collects the traces written to shared memory by the HALs instrumented "
+      "with hal.instrumentation.profile.shm set.\n"
+      "--socket:     The unix socket to listen on, i.e. the value of "
+      "hal.instrumentation.profile.shm.socket (default: %s).\n"
+      "--output_dir: The directory to write the trace files into (default: "
+      "%s).\n"
+      "--stream:     Write the data of all traces to stdout instead, e.g. to "
+      "stream them with adb exec-out. Only meaningful for uncompacted traces, "
+      "whose records do not depend on each other.\n"
+      "--help:       Show help\n",
+      kDefaultSocketPath, kDefaultOutputDir);
+  exit(-1);
+}
+
+static bool WriteFully(int fd, const string& data) {
+  const char* buffer = data.data();
+  size_t remaining = data.size();
+  while (remaining > 0) {
+    ssize_t written = TEMP_FAILURE_RETRY(write(fd, buffer, remaining));
+    if (written < 0) {
+      return false;
+    }
+    buffer += written;
+    remaining -= written;
+  }
+  return true;
+}
+
+// Copies all the data available in the ring to its output.
+static void Drain(RegisteredRing* registered, string* buffer) {
+  buffer->clear();
+  while (registered->ring->Read(buffer)) {
+    if (buffer->size() >= kDefaultRingCapacity) {
+      break;
+    }
+  }
+  if (!buffer->empty() && !WriteFully(registered->output_fd, *buffer)) {
+    perror(("failed to write trace " + registered->name).c_str());
+  }
+}
+
+static int Listen(const string& socket_path) {
+  struct sockaddr_un address;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    fprintf(stderr, "socket path too long: %s\n", socket_path.c_str());
+    return -1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    perror("failed to create socket");
+    return -1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+  unlink(socket_path.c_str());
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    perror(("failed to listen on " + socket_path).c_str());
+    close(fd);
+    return -1;
+  }
+  // HAL processes run as various users.
+  chmod(socket_path.c_str(), 0666);
+  return fd;
+}
+
+// Accepts a connection and reads its registration. Returns nullptr on error.
+static unique_ptr<RegisteredRing> Accept(int listen_fd,
+                                         const string& output_dir,
+                                         bool stream) {
+  int socket_fd = TEMP_FAILURE_RETRY(accept4(listen_fd, nullptr, nullptr,
+                                             SOCK_CLOEXEC));
+  if (socket_fd < 0) {
+    perror("failed to accept connection");
+    return nullptr;
+  }
+  unique_ptr<RegisteredRing> registered(new RegisteredRing());
+  registered->socket_fd = socket_fd;
+  registered->output_fd = -1;
+  int region_fd = receiveRingBuffer(socket_fd, &registered->name);
+  if (region_fd < 0) {
+    fprintf(stderr, "failed to receive ring buffer.\n");
+    close(socket_fd);
+    return nullptr;
+  }
+  // The name ends up in a path, do not let it point outside output_dir.
+  if (registered->name.find('/') != string::npos) {
+    fprintf(stderr, "invalid trace name: %s\n", registered->name.c_str());
+    close(region_fd);
+    close(socket_fd);
+    return nullptr;
+  }
+  // The mapping keeps the region alive.
+  registered->ring = VtsTraceRingBuffer::Attach(region_fd);
+  close(region_fd);
+  if (!registered->ring) {
+    perror(("failed to map ring buffer of " + registered->name).c_str());
+    close(socket_fd);
+    return nullptr;
+  }
+  if (stream) {
+    registered->output_fd = STDOUT_FILENO;
+  } else {
+    string path = output_dir + "/" + registered->name;
+    registered->output_fd =
+        open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+             S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (registered->output_fd < 0) {
+      perror(("failed to create trace file " + path).c_str());
+      close(socket_fd);
+      return nullptr;
+    }
+  }
+  fprintf(stderr, "collecting trace %s\n", registered->name.c_str());
+  return registered;
+}
+
+// Drains the ring and releases it.
+static void Release(RegisteredRing* registered, string* buffer) {
+  // The HAL process does not write to the ring anymore once the connection
+  // is closed, but there may be more data than a single drain copies. A
+  // process that keeps writing can't keep the collector draining: the ring
+  // holds at most its capacity.
+  uint64_t dropped_count = registered->ring->DroppedCount();
+  size_t drained_size = 0;
+  do {
+    Drain(registered, buffer);
+    drained_size += buffer->size();
+  } while (!buffer->empty() && drained_size < registered->ring->Capacity());
+  if (dropped_count > 0) {
+    fprintf(stderr, "trace %s: %llu writes dropped by the HAL process.\n",
+            registered->name.c_str(),
+            static_cast<unsigned long long>(dropped_count));
+  }
+  fprintf(stderr, "finished collecting trace %s\n", registered->name.c_str());
+  close(registered->socket_fd);
+  if (registered->output_fd != STDOUT_FILENO) {
+    close(registered->output_fd);
+  }
+}
+
+int main(int argc, char** argv) {
+  string socket_path = kDefaultSocketPath;
+  string output_dir = kDefaultOutputDir;
+  bool stream = false;
+
+  const char* const short_opts = "hs:o:S";
+  const option long_opts[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"socket", required_argument, nullptr, 's'},
+      {"output_dir", required_argument, nullptr, 'o'},
+      {"stream", no_argument, nullptr, 'S'},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  while (true) {
+    int opt = getopt_long(argc, argv, short_opts, long_opts, nullptr);
+    if (opt == -1) {
+      break;
+    }
+    switch (opt) {
+      case 'h':
+      case '?':
+        ShowUsage();
+        return 0;
+      case 's': {
+        socket_path = string(optarg);
+        break;
+      }
+      case 'o': {
+        output_dir = string(optarg);
+        break;
+      }
+      case 'S': {
+        stream = true;
+        break;
+      }
+      default:
+        printf("getopt_long returned unexpected value: %d\n", opt);
+        return -1;
+    }
+  }
+
+  int listen_fd = Listen(socket_path);
+  if (listen_fd < 0) {
+    return -1;
+  }
+  signal(SIGINT, HandleSignal);
+  signal(SIGTERM, HandleSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  vector<unique_ptr<RegisteredRing>> rings;
+  vector<struct pollfd> poll_fds;
+  string buffer;
+  while (!stop_requested) {
+    poll_fds.clear();
+    poll_fds.push_back({listen_fd, POLLIN, 0});
+    for (const auto& registered : rings) {
+      poll_fds.push_back({registered->socket_fd, POLLIN, 0});
+    }
+    int ready = poll(poll_fds.data(), poll_fds.size(), kDrainIntervalMs);
+    if (ready < 0 && errno != EINTR) {
+      perror("failed to poll");
+      break;
+    }
+    // Release the rings whose HAL process is gone, i.e. the connection is
+    // closed (the HAL process never sends anything after the registration).
+    for (size_t i = rings.size(); i > 0; i--) {
+      if (poll_fds[i].revents != 0) {
+        Release(rings[i - 1].get(), &buffer);
+        rings.erase(rings.begin() + (i - 1));
+      }
+    }
+    for (const auto& registered : rings) {
+      Drain(registered.get(), &buffer);
+    }
+    if (poll_fds[0].revents & POLLIN) {
+      unique_ptr<RegisteredRing> registered =
+          Accept(listen_fd, output_dir, stream);
+      if (registered) {
+        rings.push_back(move(registered));
+      }
+    }
+  }
+
+  for (const auto& registered : rings) {
+    Release(registered.get(), &buffer);
+  }
+  close(listen_fd);
+  unlink(socket_path.c_str());
+  return 0;
+}
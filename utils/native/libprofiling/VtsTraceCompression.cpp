@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsTraceCompression.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include <zstd.h>
+
+#include "google/protobuf/io/coded_stream.h"
+
+using google::protobuf::io::CodedInputStream;
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Size of the block header: magic, uncompressed size and compressed size.
+static constexpr size_t kBlockHeaderSize = kCompressedBlockMagicSize + 8;
+// Trace data is compressed at the default level of zstd, which is fast enough
+// to keep up with the instrumented HALs.
+static constexpr int kCompressionLevel = 3;
+// Upper bound of the uncompressed size of a block accepted by the reader.
+static constexpr uint32_t kMaxBlockSize = 64 * 1024 * 1024;
+
+static void putFixed32(uint32_t value, char* buffer) {
+  for (size_t i = 0; i < 4; i++) {
+    buffer[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+static uint32_t getFixed32(const uint8_t* buffer) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; i++) {
+    value |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+  }
+  return value;
+}
+
+bool isCompressedTrace(int fd) {
+  char magic[kCompressedBlockMagicSize];
+  return pread(fd, magic, sizeof(magic), 0) ==
+             static_cast<ssize_t>(sizeof(magic)) &&
+         memcmp(magic, kCompressedBlockMagic, sizeof(magic)) == 0;
+}
+
+VtsTraceCompressor::VtsTraceCompressor(int fd, size_t block_size)
+    : fd_(fd), block_size_(block_size), context_(ZSTD_createCCtx()) {
+  buffer_.reserve(block_size_);
+}
+
+VtsTraceCompressor::~VtsTraceCompressor() {
+  Flush();
+  ZSTD_freeCCtx(context_);
+}
+
+bool VtsTraceCompressor::Write(const void* data, size_t size) {
+  bool success = true;
+  if (!buffer_.empty() && buffer_.size() + size > block_size_) {
+    success = Flush();
+  }
+  buffer_.append(static_cast<const char*>(data), size);
+  if (buffer_.size() >= block_size_ && !Flush()) {
+    success = false;
+  }
+  return success;
+}
+
+bool VtsTraceCompressor::Flush() {
+  if (buffer_.empty()) {
+    return true;
+  }
+  if (context_ == nullptr) {
+    buffer_.clear();
+    return false;
+  }
+  block_.resize(kBlockHeaderSize + ZSTD_compressBound(buffer_.size()));
+  size_t compressed_size = ZSTD_compressCCtx(
+      context_, &block_[kBlockHeaderSize], block_.size() - kBlockHeaderSize,
+      buffer_.data(), buffer_.size(), kCompressionLevel);
+  if (ZSTD_isError(compressed_size)) {
+    buffer_.clear();
+    return false;
+  }
+  memcpy(&block_[0], kCompressedBlockMagic, kCompressedBlockMagicSize);
+  putFixed32(buffer_.size(), &block_[kCompressedBlockMagicSize]);
+  putFixed32(compressed_size, &block_[kCompressedBlockMagicSize + 4]);
+  buffer_.clear();
+
+  // Write the whole block so that the trace file always ends on a block
+  // boundary unless the process dies in the middle of the write.
+  const char* data = block_.data();
+  size_t remaining = kBlockHeaderSize + compressed_size;
+  while (remaining > 0) {
+    ssize_t written = TEMP_FAILURE_RETRY(write(fd_, data, remaining));
+    if (written < 0) {
+      return false;
+    }
+    data += written;
+    remaining -= written;
+  }
+  return true;
+}
+
+VtsTraceDecompressingInputStream::VtsTraceDecompressingInputStream(
+    google::protobuf::io::ZeroCopyInputStream* in)
+    : in_(in),
+      offset_(0),
+      byte_count_(0),
+      error_(false),
+      context_(ZSTD_createDCtx()) {}
+
+VtsTraceDecompressingInputStream::~VtsTraceDecompressingInputStream() {
+  ZSTD_freeDCtx(context_);
+}
+
+bool VtsTraceDecompressingInputStream::ReadBlock() {
+  block_.clear();
+  offset_ = 0;
+  if (error_ || context_ == nullptr) {
+    error_ = true;
+    return false;
+  }
+  CodedInputStream input(in_);
+  uint8_t header[kBlockHeaderSize];
+  if (!input.ReadRaw(header, sizeof(header))) {
+    // End of the trace, or a block truncated by a crash.
+    return false;
+  }
+  uint32_t size = getFixed32(header + kCompressedBlockMagicSize);
+  uint32_t compressed_size = getFixed32(header + kCompressedBlockMagicSize + 4);
+  if (memcmp(header, kCompressedBlockMagic, kCompressedBlockMagicSize) != 0 ||
+      size > kMaxBlockSize ||
+      compressed_size > ZSTD_compressBound(kMaxBlockSize)) {
+    error_ = true;
+    return false;
+  }
+  if (!input.ReadString(&compressed_block_, compressed_size)) {
+    return false;
+  }
+  block_.resize(size);
+  size_t decompressed_size =
+      ZSTD_decompressDCtx(context_, &block_[0], block_.size(),
+                          compressed_block_.data(), compressed_block_.size());
+  if (ZSTD_isError(decompressed_size) || decompressed_size != size) {
+    block_.clear();
+    error_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool VtsTraceDecompressingInputStream::Next(const void** data, int* size) {
+  while (offset_ >= block_.size()) {
+    if (!ReadBlock()) {
+      return false;
+    }
+  }
+  *data = block_.data() + offset_;
+  *size = block_.size() - offset_;
+  offset_ = block_.size();
+  byte_count_ += *size;
+  return true;
+}
+
+void VtsTraceDecompressingInputStream::BackUp(int count) {
+  offset_ -= count;
+  byte_count_ -= count;
+}
+
+bool VtsTraceDecompressingInputStream::Skip(int count) {
+  while (count > 0) {
+    if (offset_ >= block_.size() && !ReadBlock()) {
+      return false;
+    }
+    size_t length = min(static_cast<size_t>(count), block_.size() - offset_);
+    offset_ += length;
+    byte_count_ += length;
+    count -= length;
+  }
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_PROFILING_TRACE_COMPRESSION_H_
+#define __VTS_PROFILING_TRACE_COMPRESSION_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "google/protobuf/io/zero_copy_stream.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+// This file defines the compressed trace container. A compressed trace is a
+// sequence of independently compressed blocks, each made of:
+//   the 4 bytes kCompressedBlockMagic,
+//   fixed32 size of the uncompressed data,
+//   fixed32 size of the compressed data,
+//   the zstd frame of the data.
+// All fixed width values are little endian. The uncompressed data of all the
+// blocks, concatenated, is a trace in either the delimited or the compact
+// format. As blocks are written whole, a process that crashes only loses the
+// block it had not written yet.
+namespace android {
+namespace vts {
+
+static constexpr char kCompressedBlockMagic[] = "VTSZ";
+static constexpr size_t kCompressedBlockMagicSize =
+    sizeof(kCompressedBlockMagic) - 1;
+// Default amount of trace data compressed into a block.
+static constexpr size_t kDefaultCompressedBlockSize = 64 * 1024;
+
+// Returns whether the file opened as fd is a compressed trace. Does not change
+// the file offset.
+bool isCompressedTrace(int fd);
+
+// Buffers the data of a trace file and writes it to the file in compressed
+// blocks. Not thread-safe.
+class VtsTraceCompressor {
+ public:
+  VtsTraceCompressor(int fd, size_t block_size = kDefaultCompressedBlockSize);
+
+  // Writes the buffered data.
+  virtual ~VtsTraceCompressor();
+
+  // Buffers the given data, writing a block whenever block_size bytes are
+  // buffered. The data of a call is never split across blocks, so that
+  // blocks written to the same file by other compressors are interleaved at
+  // record boundaries. Returns false if a block could not be written.
+  bool Write(const void* data, size_t size);
+
+  // Compresses and writes the buffered data as a block, even if it is
+  // smaller than block_size.
+  bool Flush();
+
+ private:
+  // Trace file written to. Not owned.
+  const int fd_;
+  const size_t block_size_;
+  // Data not written yet.
+  std::string buffer_;
+  // Header and compressed data of the block being written.
+  std::string block_;
+  ZSTD_CCtx_s* context_;
+};
+
+// Reads a compressed trace from the underlying stream and provides the
+// uncompressed data, so that readOneDelimited and VtsCompactTraceDecoder can
+// read compressed traces unchanged.
+class VtsTraceDecompressingInputStream
+    : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  explicit VtsTraceDecompressingInputStream(
+      google::protobuf::io::ZeroCopyInputStream* in);
+
+  virtual ~VtsTraceDecompressingInputStream();
+
+  // Returns true if a block could not be read. A truncated last block is not
+  // an error.
+  bool HadError() const { return error_; }
+
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  int64_t ByteCount() const override { return byte_count_; }
+
+ private:
+  // Reads and decompresses the next block into block_.
+  bool ReadBlock();
+
+  // Not owned.
+  google::protobuf::io::ZeroCopyInputStream* in_;
+  // Uncompressed data of the current block.
+  std::string block_;
+  // Compressed data of the current block.
+  std::string compressed_block_;
+  // Offset of the data in block_ not returned by Next yet.
+  size_t offset_;
+  // Total number of bytes returned by Next, minus the bytes backed up.
+  int64_t byte_count_;
+  bool error_;
+  ZSTD_DCtx_s* context_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_TRACE_COMPRESSION_H_
@@ -0,0 +1,371 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsTraceReader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <unordered_map>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+
+#include "VtsCompactTrace.h"
+#include "VtsTraceCompression.h"
+
+using namespace std;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace android {
+namespace vts {
+
+// Reads the varint at offset in data, of the given size, and moves offset
+// past it.
+static bool readVarint(const uint8_t* data, size_t size, size_t* offset,
+                       uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *offset < size; shift += 7) {
+    uint8_t byte = data[(*offset)++];
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads the timestamp and the full API name of a serialized
+// VtsProfilingRecord, skipping the arguments and return values of its
+// function. Returns false if it is not a valid record.
+static bool scanRecord(const uint8_t* data, int size, int64_t* timestamp,
+                       string* api_name) {
+  CodedInputStream input(data, size);
+  string package;
+  string interface;
+  string method;
+  int32_t version_major = -1;
+  int32_t version_minor = -1;
+  uint64_t value;
+  *timestamp = 0;
+  uint32_t tag;
+  while ((tag = input.ReadTag()) != 0) {
+    int field = WireFormatLite::GetTagFieldNumber(tag);
+    bool varint =
+        WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_VARINT;
+    bool bytes = WireFormatLite::GetTagWireType(tag) ==
+                 WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+    if (field == VtsProfilingRecord::kTimestampFieldNumber && varint) {
+      if (!input.ReadVarint64(&value)) {
+        return false;
+      }
+      *timestamp = static_cast<int64_t>(value);
+    } else if (field == VtsProfilingRecord::kVersionMajorFieldNumber &&
+               varint) {
+      if (!input.ReadVarint64(&value)) {
+        return false;
+      }
+      version_major = static_cast<int32_t>(value);
+    } else if (field == VtsProfilingRecord::kVersionMinorFieldNumber &&
+               varint) {
+      if (!input.ReadVarint64(&value)) {
+        return false;
+      }
+      version_minor = static_cast<int32_t>(value);
+    } else if (field == VtsProfilingRecord::kPackageFieldNumber && bytes) {
+      if (!WireFormatLite::ReadBytes(&input, &package)) {
+        return false;
+      }
+    } else if (field == VtsProfilingRecord::kInterfaceFieldNumber && bytes) {
+      if (!WireFormatLite::ReadBytes(&input, &interface)) {
+        return false;
+      }
+    } else if (field == VtsProfilingRecord::kFuncMsgFieldNumber && bytes) {
+      uint32_t length;
+      if (!input.ReadVarint32(&length)) {
+        return false;
+      }
+      CodedInputStream::Limit limit = input.PushLimit(length);
+      uint32_t func_tag;
+      while ((func_tag = input.ReadTag()) != 0) {
+        if (func_tag ==
+            WireFormatLite::MakeTag(
+                FunctionSpecificationMessage::kNameFieldNumber,
+                WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+          if (!WireFormatLite::ReadBytes(&input, &method)) {
+            return false;
+          }
+        } else if (!WireFormatLite::SkipField(&input, func_tag)) {
+          return false;
+        }
+      }
+      if (!input.ConsumedEntireMessage()) {
+        return false;
+      }
+      input.PopLimit(limit);
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return false;
+    }
+  }
+  if (!input.ConsumedEntireMessage()) {
+    return false;
+  }
+  *api_name = package + '@' + to_string(version_major) + '.' +
+              to_string(version_minor) + "::" + interface + "::" + method;
+  return true;
+}
+
+static int64_t getMtimeNs(const struct stat& st) {
+  return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+         st.st_mtim.tv_nsec;
+}
+
+unique_ptr<VtsTraceReader> VtsTraceReader::Open(const string& trace_file,
+                                                bool write_index) {
+  int fd = open(trace_file.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  if (isCompressedTrace(fd)) {
+    close(fd);
+    errno = EINVAL;
+    return nullptr;
+  }
+  size_t size = st.st_size;
+  const uint8_t* data = nullptr;
+  if (size > 0) {
+    void* region = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+    data = static_cast<const uint8_t*>(region);
+  }
+  // The mapping keeps the file open.
+  close(fd);
+  unique_ptr<VtsTraceReader> reader(new VtsTraceReader(data, size));
+  // The records of compact traces depend on the definitions before them.
+  google::protobuf::io::ArrayInputStream header(
+      data, min(size, kCompactTraceMagicSize));
+  if (isCompactTrace(&header)) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  int64_t mtime_ns = getMtimeNs(st);
+  if (!reader->LoadIndex(trace_file, mtime_ns)) {
+    reader->BuildIndex();
+    if (write_index) {
+      reader->WriteIndex(trace_file, mtime_ns);
+    }
+  }
+  reader->sorted_ =
+      is_sorted(reader->entries_.begin(), reader->entries_.end(),
+                [](const VtsTraceIndexEntry& lhs,
+                   const VtsTraceIndexEntry& rhs) {
+                  return lhs.timestamp < rhs.timestamp;
+                });
+  return reader;
+}
+
+VtsTraceReader::VtsTraceReader(const uint8_t* data, size_t size)
+    : data_(data), size_(size), sorted_(true) {}
+
+VtsTraceReader::~VtsTraceReader() {
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+}
+
+vector<size_t> VtsTraceReader::FindRecords(int64_t start_time,
+                                           int64_t end_time) const {
+  vector<size_t> indexes;
+  size_t begin = 0;
+  size_t end = entries_.size();
+  if (sorted_) {
+    auto by_timestamp = [](const VtsTraceIndexEntry& entry, int64_t time) {
+      return entry.timestamp < time;
+    };
+    begin = lower_bound(entries_.begin(), entries_.end(), start_time,
+                        by_timestamp) -
+            entries_.begin();
+    end = lower_bound(entries_.begin() + begin, entries_.end(), end_time,
+                      by_timestamp) -
+          entries_.begin();
+  }
+  for (size_t i = begin; i < end; i++) {
+    if (entries_[i].timestamp >= start_time &&
+        entries_[i].timestamp < end_time) {
+      indexes.push_back(i);
+    }
+  }
+  return indexes;
+}
+
+bool VtsTraceReader::ReadRecord(size_t index,
+                                VtsProfilingRecord* record) const {
+  if (index >= entries_.size()) {
+    return false;
+  }
+  const VtsTraceIndexEntry& entry = entries_[index];
+  return record->ParseFromArray(data_ + entry.offset, entry.size);
+}
+
+bool VtsTraceReader::LoadIndex(const string& trace_file,
+                               int64_t trace_mtime_ns) {
+  int fd = open(IndexFileName(trace_file).c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  string index;
+  char buffer[64 * 1024];
+  ssize_t read_size;
+  while ((read_size = TEMP_FAILURE_RETRY(read(fd, buffer, sizeof(buffer)))) >
+         0) {
+    index.append(buffer, read_size);
+  }
+  close(fd);
+  if (read_size < 0 || index.size() < sizeof(VtsTraceIndexHeader)) {
+    return false;
+  }
+  VtsTraceIndexHeader header;
+  memcpy(&header, index.data(), sizeof(header));
+  if (memcmp(header.magic, kTraceIndexMagic, kTraceIndexMagicSize) != 0 ||
+      header.trace_size != size_ || header.trace_mtime_ns != trace_mtime_ns) {
+    return false;
+  }
+  size_t offset = sizeof(header);
+  vector<string> api_names;
+  for (uint32_t i = 0; i < header.api_count; i++) {
+    uint32_t name_size;
+    if (index.size() - offset < sizeof(name_size)) {
+      return false;
+    }
+    memcpy(&name_size, index.data() + offset, sizeof(name_size));
+    offset += sizeof(name_size);
+    if (index.size() - offset < name_size) {
+      return false;
+    }
+    api_names.push_back(index.substr(offset, name_size));
+    offset += name_size;
+  }
+  if ((index.size() - offset) / sizeof(VtsTraceIndexEntry) !=
+          header.record_count ||
+      (index.size() - offset) % sizeof(VtsTraceIndexEntry) != 0) {
+    return false;
+  }
+  vector<VtsTraceIndexEntry> entries(header.record_count);
+  memcpy(entries.data(), index.data() + offset,
+         entries.size() * sizeof(VtsTraceIndexEntry));
+  for (const auto& entry : entries) {
+    if (entry.offset > size_ || entry.size > size_ - entry.offset ||
+        entry.api_id >= header.api_count) {
+      return false;
+    }
+  }
+  entries_ = move(entries);
+  api_names_ = move(api_names);
+  return true;
+}
+
+void VtsTraceReader::BuildIndex() {
+  entries_.clear();
+  api_names_.clear();
+  unordered_map<string, uint32_t> api_ids;
+  string api_name;
+  size_t offset = 0;
+  while (offset < size_) {
+    uint64_t record_size;
+    if (!readVarint(data_, size_, &offset, &record_size) ||
+        record_size > size_ - offset || record_size > INT_MAX) {
+      // Truncated, e.g. the traced process crashed while writing it.
+      break;
+    }
+    VtsTraceIndexEntry entry;
+    entry.offset = offset;
+    entry.size = record_size;
+    if (!scanRecord(data_ + offset, record_size, &entry.timestamp,
+                    &api_name)) {
+      break;
+    }
+    auto inserted = api_ids.emplace(api_name, api_names_.size());
+    if (inserted.second) {
+      api_names_.push_back(api_name);
+    }
+    entry.api_id = inserted.first->second;
+    entries_.push_back(entry);
+    offset += record_size;
+  }
+}
+
+bool VtsTraceReader::WriteIndex(const string& trace_file,
+                                int64_t trace_mtime_ns) const {
+  VtsTraceIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kTraceIndexMagic, kTraceIndexMagicSize);
+  header.trace_size = size_;
+  header.trace_mtime_ns = trace_mtime_ns;
+  header.record_count = entries_.size();
+  header.api_count = api_names_.size();
+  string index(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& api_name : api_names_) {
+    uint32_t name_size = api_name.size();
+    index.append(reinterpret_cast<const char*>(&name_size), sizeof(name_size));
+    index.append(api_name);
+  }
+  index.append(reinterpret_cast<const char*>(entries_.data()),
+               entries_.size() * sizeof(VtsTraceIndexEntry));
+
+  // Written to a temporary file first so that readers never see a partial
+  // index.
+  string index_file = IndexFileName(trace_file);
+  string tmp_file = trace_file + ".tmp" + kTraceIndexSuffix;
+  int fd = open(tmp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    return false;
+  }
+  const char* buffer = index.data();
+  size_t remaining = index.size();
+  while (remaining > 0) {
+    ssize_t written = TEMP_FAILURE_RETRY(write(fd, buffer, remaining));
+    if (written < 0) {
+      close(fd);
+      unlink(tmp_file.c_str());
+      return false;
+    }
+    buffer += written;
+    remaining -= written;
+  }
+  if (close(fd) != 0 || rename(tmp_file.c_str(), index_file.c_str()) != 0) {
+    unlink(tmp_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_PROFILING_TRACE_READER_H_
+#define __VTS_PROFILING_TRACE_READER_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test/vts/proto/VtsProfilingMessage.pb.h"
+
+// This file defines a reader with random access to the records of a trace of
+// delimited records that is not compressed. The trace file is mapped in
+// memory, and the offset, timestamp and API of each record are kept in an
+// index, so that the records of a time window or of an API can be found
+// without decoding the whole trace.
+//
+// The index is stored next to the trace file, in the file named after it with
+// kTraceIndexSuffix, and rebuilt whenever the size or modification time of the
+// trace file changed. The index file is made of a VtsTraceIndexHeader,
+// followed by api_count names, each a uint32 size followed by the bytes of the
+// name, followed by record_count VtsTraceIndexEntry. As it is only a cache, it
+// is written in the byte order of the host.
+namespace android {
+namespace vts {
+
+static constexpr char kTraceIndexMagic[] = "VTSIDX01";
+static constexpr size_t kTraceIndexMagicSize = sizeof(kTraceIndexMagic) - 1;
+static constexpr char kTraceIndexSuffix[] = ".idx";
+
+struct VtsTraceIndexHeader {
+  char magic[kTraceIndexMagicSize];
+  // Size and modification time of the indexed trace file.
+  uint64_t trace_size;
+  int64_t trace_mtime_ns;
+  uint64_t record_count;
+  uint32_t api_count;
+  uint32_t reserved;
+};
+
+struct VtsTraceIndexEntry {
+  // Offset of the serialized record in the trace file, after its size.
+  uint64_t offset;
+  int64_t timestamp;
+  // Size of the serialized record.
+  uint32_t size;
+  // Index of the full API name (package@version::interface::method) of the
+  // record in the API names of the index.
+  uint32_t api_id;
+};
+
+class VtsTraceReader {
+ public:
+  // Maps trace_file and loads its index, building it if it is missing or out
+  // of date, in which case the index file is also written if write_index is
+  // set (failing to write it is not an error). Returns nullptr on error,
+  // including when the trace is compressed or compact.
+  static std::unique_ptr<VtsTraceReader> Open(const std::string& trace_file,
+                                              bool write_index = true);
+
+  virtual ~VtsTraceReader();
+
+  // Returns the name of the index file of trace_file.
+  static std::string IndexFileName(const std::string& trace_file) {
+    return trace_file + kTraceIndexSuffix;
+  }
+
+  // The index entries of the records, in the order of the trace file.
+  const std::vector<VtsTraceIndexEntry>& Entries() const { return entries_; }
+
+  // The full API names, indexed by the api_id of the entries.
+  const std::vector<std::string>& ApiNames() const { return api_names_; }
+
+  // Returns the indexes of the records with start_time <= timestamp <
+  // end_time, in the order of the trace file.
+  std::vector<size_t> FindRecords(int64_t start_time, int64_t end_time) const;
+
+  // Decodes the record of the given index into record.
+  bool ReadRecord(size_t index, VtsProfilingRecord* record) const;
+
+ private:
+  VtsTraceReader(const uint8_t* data, size_t size);
+
+  // Decodes the index in the given index file. Returns false if it cannot be
+  // read or does not match the trace file.
+  bool LoadIndex(const std::string& index_file, int64_t trace_mtime_ns);
+
+  // Scans the records of the trace file to build the index.
+  void BuildIndex();
+
+  // Writes the index into the given index file.
+  bool WriteIndex(const std::string& index_file, int64_t trace_mtime_ns) const;
+
+  // The mapped trace file.
+  const uint8_t* data_;
+  size_t size_;
+  std::vector<VtsTraceIndexEntry> entries_;
+  std::vector<std::string> api_names_;
+  // Whether the entries are ordered by timestamp, which is not the case when
+  // several threads traced events.
+  bool sorted_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_TRACE_READER_H_
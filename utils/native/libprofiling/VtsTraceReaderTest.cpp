@@ -0,0 +1,246 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "VtsTraceReader.h"
+#include "VtsProfilingUtil.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <android-base/file.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <gtest/gtest.h>
+
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::io::StringOutputStream;
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Unit test of the index of the trace reader, on a small trace of two
+// threads written into a temporary directory.
+class VtsTraceReaderTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    trace_file_ = string(dir_.path) + "/trace.vts.trace";
+    // The records of the second thread are interleaved out of order.
+    AddRecord(100, "android.hardware.foo", "IFoo", "open");
+    AddRecord(150, "android.hardware.bar", "IBar", "close");
+    AddRecord(120, "android.hardware.foo", "IFoo", "write");
+    AddRecord(300, "android.hardware.foo", "IFoo", "open");
+    ASSERT_TRUE(WriteTrace());
+  }
+
+  void AddRecord(int64_t timestamp, const string& package,
+                 const string& interface, const string& method) {
+    records_.emplace_back();
+    VtsProfilingRecord* record = &records_.back();
+    record->set_timestamp(timestamp);
+    record->set_event(SERVER_API_ENTRY);
+    record->set_package(package);
+    record->set_version_major(1);
+    record->set_version_minor(0);
+    record->set_interface(interface);
+    record->mutable_func_msg()->set_name(method);
+    record->mutable_func_msg()->add_arg()->set_type(TYPE_SCALAR);
+  }
+
+  // Writes records_ into trace_file_, and the offset of each record after
+  // its size into offsets_.
+  bool WriteTrace() {
+    string trace;
+    offsets_.clear();
+    for (const auto& record : records_) {
+      offsets_.push_back(
+          trace.size() +
+          CodedOutputStream::VarintSize32(record.ByteSizeLong()));
+      StringOutputStream out(&trace);
+      if (!writeOneDelimited(record, &out)) {
+        return false;
+      }
+    }
+    return WriteFile(trace_file_, trace);
+  }
+
+  static bool WriteFile(const string& path, const string& data) {
+    return android::base::WriteStringToFile(data, path);
+  }
+
+  static string ReadFile(const string& path) {
+    string data;
+    android::base::ReadFileToString(path, &data);
+    return data;
+  }
+
+  // Returns the names of the files in the temporary directory.
+  vector<string> ListFiles() {
+    vector<string> files;
+    DIR* dir = opendir(dir_.path);
+    while (struct dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') {
+        files.push_back(entry->d_name);
+      }
+    }
+    closedir(dir);
+    sort(files.begin(), files.end());
+    return files;
+  }
+
+  // Checks that reader indexes the first count records of records_.
+  void CheckIndex(const VtsTraceReader& reader, size_t count) {
+    ASSERT_EQ(count, reader.Entries().size());
+    for (size_t i = 0; i < count; i++) {
+      const VtsTraceIndexEntry& entry = reader.Entries()[i];
+      const VtsProfilingRecord& record = records_[i];
+      EXPECT_EQ(offsets_[i], entry.offset);
+      EXPECT_EQ(record.ByteSizeLong(), entry.size);
+      EXPECT_EQ(record.timestamp(), entry.timestamp);
+      ASSERT_LT(entry.api_id, reader.ApiNames().size());
+      EXPECT_EQ(record.package() + "@1.0::" + record.interface() +
+                    "::" + record.func_msg().name(),
+                reader.ApiNames()[entry.api_id]);
+      VtsProfilingRecord read_record;
+      ASSERT_TRUE(reader.ReadRecord(i, &read_record));
+      EXPECT_EQ(record.SerializeAsString(), read_record.SerializeAsString());
+    }
+  }
+
+  TemporaryDir dir_;
+  string trace_file_;
+  vector<VtsProfilingRecord> records_;
+  vector<size_t> offsets_;
+};
+
+// Tests the index built for a trace and written next to it.
+TEST_F(VtsTraceReaderTest, BuildIndex) {
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file_);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size());
+  // The same API has the same id.
+  EXPECT_EQ(3u, reader->ApiNames().size());
+  EXPECT_EQ(reader->Entries()[0].api_id, reader->Entries()[3].api_id);
+  EXPECT_EQ(vector<size_t>({0, 2}), reader->FindRecords(100, 150));
+  EXPECT_EQ(vector<string>({"trace.vts.trace", "trace.vts.trace.idx"}),
+            ListFiles());
+}
+
+// Tests that the index file is used while it matches the trace.
+TEST_F(VtsTraceReaderTest, LoadIndex) {
+  ASSERT_NE(nullptr, VtsTraceReader::Open(trace_file_));
+  string index_file = VtsTraceReader::IndexFileName(trace_file_);
+  string index = ReadFile(index_file);
+  ASSERT_GE(index.size(), sizeof(VtsTraceIndexEntry));
+  // Change the timestamp of the last entry, which only the index has.
+  VtsTraceIndexEntry entry;
+  size_t entry_offset = index.size() - sizeof(entry);
+  memcpy(&entry, index.data() + entry_offset, sizeof(entry));
+  entry.timestamp = 12345;
+  index.replace(entry_offset, sizeof(entry),
+                reinterpret_cast<const char*>(&entry), sizeof(entry));
+  ASSERT_TRUE(WriteFile(index_file, index));
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file_);
+  ASSERT_NE(nullptr, reader);
+  EXPECT_EQ(12345, reader->Entries().back().timestamp);
+}
+
+// Tests that an index that no longer matches the trace is rebuilt.
+TEST_F(VtsTraceReaderTest, StaleIndex) {
+  ASSERT_NE(nullptr, VtsTraceReader::Open(trace_file_));
+  AddRecord(400, "android.hardware.bar", "IBar", "open");
+  ASSERT_TRUE(WriteTrace());
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file_);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size());
+
+  // Same size, another modification time.
+  records_.back().set_timestamp(401);
+  ASSERT_TRUE(WriteTrace());
+  struct timespec times[2] = {{0, UTIME_OMIT}, {1, 0}};
+  ASSERT_EQ(0, utimensat(AT_FDCWD, trace_file_.c_str(), times, 0));
+  reader = VtsTraceReader::Open(trace_file_);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size());
+}
+
+// Tests that a truncated or corrupt index is ignored.
+TEST_F(VtsTraceReaderTest, CorruptIndex) {
+  ASSERT_NE(nullptr, VtsTraceReader::Open(trace_file_));
+  string index_file = VtsTraceReader::IndexFileName(trace_file_);
+  string index = ReadFile(index_file);
+  for (size_t size : {sizeof(VtsTraceIndexHeader) - 1,
+                      sizeof(VtsTraceIndexHeader) + 2, index.size() - 1}) {
+    ASSERT_TRUE(WriteFile(index_file, index.substr(0, size)));
+    unique_ptr<VtsTraceReader> reader =
+        VtsTraceReader::Open(trace_file_, false);
+    ASSERT_NE(nullptr, reader);
+    CheckIndex(*reader, records_.size());
+  }
+  // An entry past the end of the trace.
+  string corrupt = index;
+  VtsTraceIndexEntry entry;
+  size_t entry_offset = corrupt.size() - sizeof(entry);
+  memcpy(&entry, corrupt.data() + entry_offset, sizeof(entry));
+  entry.offset = ReadFile(trace_file_).size();
+  corrupt.replace(entry_offset, sizeof(entry),
+                  reinterpret_cast<const char*>(&entry), sizeof(entry));
+  ASSERT_TRUE(WriteFile(index_file, corrupt));
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file_);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size());
+  // The index is written again.
+  EXPECT_EQ(index, ReadFile(index_file));
+}
+
+// Tests that a trace cut within a record is indexed up to that record.
+TEST_F(VtsTraceReaderTest, TruncatedTrace) {
+  string trace = ReadFile(trace_file_);
+  ASSERT_TRUE(WriteFile(trace_file_, trace.substr(0, trace.size() - 1)));
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file_, false);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size() - 1);
+}
+
+// Tests that opening a trace without writing its index leaves no file.
+TEST_F(VtsTraceReaderTest, ReadOnlyOpen) {
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file_, false);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size());
+  EXPECT_EQ(vector<string>({"trace.vts.trace"}), ListFiles());
+  // Nor does a stale index get replaced.
+  ASSERT_NE(nullptr, VtsTraceReader::Open(trace_file_));
+  string index_file = VtsTraceReader::IndexFileName(trace_file_);
+  string index = ReadFile(index_file);
+  AddRecord(400, "android.hardware.bar", "IBar", "open");
+  ASSERT_TRUE(WriteTrace());
+  reader = VtsTraceReader::Open(trace_file_, false);
+  ASSERT_NE(nullptr, reader);
+  CheckIndex(*reader, records_.size());
+  EXPECT_EQ(index, ReadFile(index_file));
+  EXPECT_EQ(vector<string>({"trace.vts.trace", "trace.vts.trace.idx"}),
+            ListFiles());
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsTraceRingBuffer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#include <algorithm>
+#include <new>
+
+#include <cutils/ashmem.h>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+static_assert(atomic<uint64_t>::is_always_lock_free,
+              "ring positions must be lock-free to be shared across processes");
+
+// Size of the header of a message.
+static constexpr size_t kMessageHeaderSize = sizeof(uint32_t);
+
+int registerRingBuffer(const string& socket_path, const string& name, int fd) {
+  struct sockaddr_un address;
+  if (socket_path.size() >= sizeof(address.sun_path) ||
+      name.size() > kMaxRingNameSize) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  int socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socket_fd < 0) {
+    return -1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+  if (TEMP_FAILURE_RETRY(connect(socket_fd,
+                                 reinterpret_cast<struct sockaddr*>(&address),
+                                 sizeof(address))) != 0) {
+    close(socket_fd);
+    return -1;
+  }
+
+  // The name is sent along with the descriptor in a single message.
+  struct iovec iov;
+  iov.iov_base = const_cast<char*>(name.data());
+  iov.iov_len = name.size();
+  char control[CMSG_SPACE(sizeof(int))];
+  memset(control, 0, sizeof(control));
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  if (TEMP_FAILURE_RETRY(sendmsg(socket_fd, &message, MSG_NOSIGNAL)) !=
+      static_cast<ssize_t>(name.size())) {
+    close(socket_fd);
+    return -1;
+  }
+  return socket_fd;
+}
+
+int receiveRingBuffer(int socket_fd, string* name) {
+  char buffer[kMaxRingNameSize];
+  struct iovec iov;
+  iov.iov_base = buffer;
+  iov.iov_len = sizeof(buffer);
+  char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  ssize_t size =
+      TEMP_FAILURE_RETRY(recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC));
+  if (size <= 0) {
+    return -1;
+  }
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+    return -1;
+  }
+  int fd;
+  memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  name->assign(buffer, size);
+  return fd;
+}
+
+VtsTraceRingBuffer::VtsTraceRingBuffer(void* region, size_t region_size)
+    : region_(region),
+      region_size_(region_size),
+      header_(static_cast<VtsTraceRingHeader*>(region)),
+      data_(static_cast<uint8_t*>(region) + kRingDataOffset),
+      capacity_(region_size - kRingDataOffset) {}
+
+VtsTraceRingBuffer::~VtsTraceRingBuffer() { munmap(region_, region_size_); }
+
+unique_ptr<VtsTraceRingBuffer> VtsTraceRingBuffer::Create(int fd,
+                                                          size_t capacity) {
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+      capacity > UINT32_MAX) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  size_t region_size = kRingDataOffset + capacity;
+  void* region =
+      mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (region == MAP_FAILED) {
+    return nullptr;
+  }
+  VtsTraceRingHeader* header = new (region) VtsTraceRingHeader();
+  header->capacity = capacity;
+  header->reserved = 0;
+  header->write_pos = 0;
+  header->dropped_count = 0;
+  header->read_pos = 0;
+  memcpy(header->magic, kRingMagic, kRingMagicSize);
+  return unique_ptr<VtsTraceRingBuffer>(
+      new VtsTraceRingBuffer(region, region_size));
+}
+
+// Returns the size of the shared memory region fd, or -1 if it is not one.
+static int64_t GetRegionSize(int fd) {
+  // fstat reports a size of 0 for an ashmem region. ashmem_get_size_region
+  // aborts on a descriptor that is not one, which the other process chose.
+  if (ashmem_valid(fd)) {
+    return ashmem_get_size_region(fd);
+  }
+  // Otherwise, only a memfd or tmpfs region has its size in fstat.
+  struct statfs region_statfs;
+  struct stat region_stat;
+  if (fstatfs(fd, &region_statfs) != 0 || fstat(fd, &region_stat) != 0) {
+    return -1;
+  }
+  if (region_statfs.f_type != TMPFS_MAGIC &&
+      region_statfs.f_type != HUGETLBFS_MAGIC) {
+    errno = EINVAL;
+    return -1;
+  }
+  return region_stat.st_size;
+}
+
+unique_ptr<VtsTraceRingBuffer> VtsTraceRingBuffer::Attach(int fd) {
+  // The region comes from another process. Accessing a mapping past the end
+  // of the region raises SIGBUS, so its size is checked before each mapping.
+  // The size of an ashmem region can't change once it is mapped, that of a
+  // memfd region is sealed when it allows it.
+  fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK);
+  int64_t region_size_limit = GetRegionSize(fd);
+  if (region_size_limit < 0) {
+    return nullptr;
+  }
+  uint64_t file_size = region_size_limit;
+  if (file_size < kRingDataOffset) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  // Map the header first to find out the size of the region.
+  void* region = mmap(nullptr, kRingDataOffset, PROT_READ, MAP_SHARED, fd, 0);
+  if (region == MAP_FAILED) {
+    return nullptr;
+  }
+  const VtsTraceRingHeader* header =
+      static_cast<const VtsTraceRingHeader*>(region);
+  uint32_t capacity = header->capacity;
+  bool valid = memcmp(header->magic, kRingMagic, kRingMagicSize) == 0 &&
+               capacity > 0 && (capacity & (capacity - 1)) == 0 &&
+               capacity <= file_size - kRingDataOffset;
+  munmap(region, kRingDataOffset);
+  if (!valid) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  size_t region_size = kRingDataOffset + capacity;
+  region =
+      mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (region == MAP_FAILED) {
+    return nullptr;
+  }
+  return unique_ptr<VtsTraceRingBuffer>(
+      new VtsTraceRingBuffer(region, region_size));
+}
+
+void VtsTraceRingBuffer::CopyToRing(uint64_t pos, const void* buffer,
+                                    size_t size) {
+  size_t offset = pos & (capacity_ - 1);
+  size_t length = min(size, capacity_ - offset);
+  memcpy(data_ + offset, buffer, length);
+  memcpy(data_, static_cast<const uint8_t*>(buffer) + length, size - length);
+}
+
+void VtsTraceRingBuffer::CopyFromRing(uint64_t pos, void* buffer,
+                                      size_t size) {
+  size_t offset = pos & (capacity_ - 1);
+  size_t length = min(size, capacity_ - offset);
+  memcpy(buffer, data_ + offset, length);
+  memcpy(static_cast<uint8_t*>(buffer) + length, data_, size - length);
+}
+
+bool VtsTraceRingBuffer::Write(const void* data, size_t size) {
+  uint64_t write_pos = header_->write_pos.load(memory_order_relaxed);
+  uint64_t read_pos = header_->read_pos.load(memory_order_acquire);
+  size_t free_size = capacity_ - (write_pos - read_pos);
+  if (size > UINT32_MAX || kMessageHeaderSize + size > free_size) {
+    header_->dropped_count.fetch_add(1, memory_order_relaxed);
+    return false;
+  }
+  uint32_t message_size = size;
+  CopyToRing(write_pos, &message_size, kMessageHeaderSize);
+  CopyToRing(write_pos + kMessageHeaderSize, data, size);
+  // Publish the message only once it is complete.
+  header_->write_pos.store(write_pos + kMessageHeaderSize + size,
+                           memory_order_release);
+  return true;
+}
+
+bool VtsTraceRingBuffer::Read(string* out) {
+  uint64_t read_pos = header_->read_pos.load(memory_order_relaxed);
+  uint64_t write_pos = header_->write_pos.load(memory_order_acquire);
+  // The positions and the message sizes are in memory the other process
+  // writes to, whether by a bug or on purpose, so they are checked before
+  // they bound any copy. On corrupt data, skip all the data.
+  uint64_t available = write_pos - read_pos;
+  if (available > capacity_) {
+    header_->read_pos.store(write_pos, memory_order_release);
+    return false;
+  }
+  if (available < kMessageHeaderSize) {
+    return false;
+  }
+  uint32_t message_size;
+  CopyFromRing(read_pos, &message_size, kMessageHeaderSize);
+  if (message_size > capacity_ - kMessageHeaderSize ||
+      kMessageHeaderSize + message_size > available) {
+    header_->read_pos.store(write_pos, memory_order_release);
+    return false;
+  }
+  size_t offset = out->size();
+  out->resize(offset + message_size);
+  CopyFromRing(read_pos + kMessageHeaderSize, &(*out)[offset], message_size);
+  // Release the space only after the message is copied out.
+  header_->read_pos.store(read_pos + kMessageHeaderSize + message_size,
+                          memory_order_release);
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_PROFILING_TRACE_RING_BUFFER_H_
+#define __VTS_PROFILING_TRACE_RING_BUFFER_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+// This file defines the shared memory transport of trace data. An
+// instrumented HAL process writes the data of a trace file into a ring buffer
+// in a shared memory region, and a collector process (vts_trace_collector)
+// that maps the same region reads it, so that the HAL threads never block on
+// file I/O.
+//
+// The region starts with a VtsTraceRingHeader, followed at offset
+// kRingDataOffset by capacity bytes of data. The data is a sequence of
+// messages, each made of a uint32 size followed by the bytes of one write;
+// messages wrap around at the end of the data. There is a single producer and
+// a single consumer: only the producer advances write_pos and only the
+// consumer advances read_pos. A message that does not fit in the free space
+// is dropped (and counted) rather than waiting for the consumer.
+//
+// The collector is registered with by connecting to its unix socket and
+// sending the name of the trace file along with the descriptor of the region
+// (SCM_RIGHTS). The collector drains the ring until the connection is closed.
+namespace android {
+namespace vts {
+
+static constexpr char kRingMagic[] = "VTSRING1";
+static constexpr size_t kRingMagicSize = sizeof(kRingMagic) - 1;
+// Offset of the data in the shared memory region.
+static constexpr size_t kRingDataOffset = 4096;
+// Default size of the data of a ring buffer.
+static constexpr size_t kDefaultRingCapacity = 1024 * 1024;
+// Maximum size of the trace file name sent when registering a ring buffer.
+static constexpr size_t kMaxRingNameSize = 256;
+
+// Layout of the start of the shared memory region. Only uses fixed size
+// fields so that 32 and 64-bit processes agree on it.
+struct VtsTraceRingHeader {
+  char magic[kRingMagicSize];
+  // Size of the data, a power of 2.
+  uint32_t capacity;
+  uint32_t reserved;
+  // Written by the producer: total number of bytes written, and number of
+  // messages dropped because the ring was full.
+  alignas(64) std::atomic<uint64_t> write_pos;
+  std::atomic<uint64_t> dropped_count;
+  // Written by the consumer: total number of bytes read.
+  alignas(64) std::atomic<uint64_t> read_pos;
+};
+
+static_assert(sizeof(VtsTraceRingHeader) <= kRingDataOffset,
+              "ring header does not fit before the data");
+
+// Connects to the collector listening on the unix socket socket_path and
+// registers the ring buffer region fd for the trace file name. Returns the
+// connected socket, to be kept open as long as the ring is written, or -1 on
+// error.
+int registerRingBuffer(const std::string& socket_path, const std::string& name,
+                       int fd);
+
+// Reads a registration sent by registerRingBuffer from the connected socket.
+// Returns the received region descriptor, owned by the caller, and sets name,
+// or returns -1 on error.
+int receiveRingBuffer(int socket_fd, std::string* name);
+
+// A ring buffer mapped from a shared memory region.
+class VtsTraceRingBuffer {
+ public:
+  // Maps the region fd, of at least kRingDataOffset + capacity bytes, and
+  // initializes an empty ring in it. capacity must be a power of 2. Returns
+  // nullptr on error. Does not take ownership of fd.
+  static std::unique_ptr<VtsTraceRingBuffer> Create(int fd, size_t capacity);
+
+  // Maps the region fd, an ashmem, memfd or tmpfs region, initialized by
+  // another process with Create. A memfd region that allows it is sealed
+  // against shrinking. Returns nullptr if it is not a valid ring, or if the
+  // region is smaller than the header and the capacity it declares. Does not
+  // take ownership of fd.
+  static std::unique_ptr<VtsTraceRingBuffer> Attach(int fd);
+
+  virtual ~VtsTraceRingBuffer();
+
+  // Producer side: appends data as one message. Returns false, and counts
+  // the message as dropped, if it does not fit in the free space. Not
+  // thread-safe.
+  bool Write(const void* data, size_t size);
+
+  // Consumer side: appends the next message to out. Returns false if the
+  // ring is empty, or if its positions or the size of the next message are
+  // corrupt, in which case all the data written so far is skipped. Not
+  // thread-safe.
+  bool Read(std::string* out);
+
+  // Number of messages dropped by the producer so far.
+  uint64_t DroppedCount() const { return header_->dropped_count; }
+
+  // Size of the data of the ring.
+  size_t Capacity() const { return capacity_; }
+
+ private:
+  VtsTraceRingBuffer(void* region, size_t region_size);
+
+  // Copies size bytes between the data at position pos (modulo the capacity)
+  // and buffer.
+  void CopyToRing(uint64_t pos, const void* buffer, size_t size);
+  void CopyFromRing(uint64_t pos, void* buffer, size_t size);
+
+  // The mapped region.
+  void* region_;
+  size_t region_size_;
+  VtsTraceRingHeader* header_;
+  uint8_t* data_;
+  size_t capacity_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_TRACE_RING_BUFFER_H_
@@ -0,0 +1,204 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "VtsTraceRingBuffer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cutils/ashmem.h>
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Size of the data of the rings of the tests, small enough to wrap around.
+static constexpr size_t kCapacity = 64;
+
+// Unit test of the ring buffer, with the producer and the consumer mapping
+// the same memfd region as two processes would.
+class VtsTraceRingBufferTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    fd_ = memfd_create("VtsTraceRingBufferTest", MFD_ALLOW_SEALING);
+    ASSERT_GE(fd_, 0);
+    ASSERT_EQ(0, ftruncate(fd_, kRingDataOffset + kCapacity));
+    producer_ = VtsTraceRingBuffer::Create(fd_, kCapacity);
+    ASSERT_NE(nullptr, producer_);
+    consumer_ = VtsTraceRingBuffer::Attach(fd_);
+    ASSERT_NE(nullptr, consumer_);
+  }
+
+  virtual void TearDown() { close(fd_); }
+
+  // Maps the header of the region, as a misbehaving producer would write it.
+  VtsTraceRingHeader* MapHeader() {
+    void* region = mmap(nullptr, kRingDataOffset, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd_, 0);
+    return region == MAP_FAILED ? nullptr
+                                : static_cast<VtsTraceRingHeader*>(region);
+  }
+
+  int fd_;
+  unique_ptr<VtsTraceRingBuffer> producer_;
+  unique_ptr<VtsTraceRingBuffer> consumer_;
+};
+
+// Tests reading an empty ring.
+TEST_F(VtsTraceRingBufferTest, ReadEmpty) {
+  string out = "previous";
+  EXPECT_FALSE(consumer_->Read(&out));
+  EXPECT_EQ("previous", out);
+  EXPECT_EQ(0u, consumer_->DroppedCount());
+}
+
+// Tests messages that wrap around at the end of the data.
+TEST_F(VtsTraceRingBufferTest, WrapAround) {
+  // Each message takes 4 + 20 bytes, so the third one wraps around the 64
+  // bytes of data, and so does the header of a later one.
+  for (int i = 0; i < 10; i++) {
+    string message(20, 'a' + i);
+    ASSERT_TRUE(producer_->Write(message.data(), message.size()));
+    string out;
+    ASSERT_TRUE(consumer_->Read(&out));
+    EXPECT_EQ(message, out);
+    EXPECT_FALSE(consumer_->Read(&out));
+  }
+  EXPECT_EQ(0u, consumer_->DroppedCount());
+}
+
+// Tests that the messages that do not fit in a full ring are dropped and
+// counted, and that the ones written before are kept.
+TEST_F(VtsTraceRingBufferTest, FullRingDrops) {
+  string message(12, 'x');
+  // 4 messages of 4 + 12 bytes fill the 64 bytes of data.
+  for (int i = 0; i < 4; i++) {
+    message[0] = '0' + i;
+    ASSERT_TRUE(producer_->Write(message.data(), message.size()));
+  }
+  EXPECT_FALSE(producer_->Write(message.data(), message.size()));
+  EXPECT_FALSE(producer_->Write("", 0));
+  EXPECT_EQ(2u, consumer_->DroppedCount());
+  // A message larger than the ring never fits.
+  string large(kCapacity, 'y');
+  string out;
+  ASSERT_TRUE(consumer_->Read(&out));
+  EXPECT_FALSE(producer_->Write(large.data(), large.size()));
+  EXPECT_EQ(3u, consumer_->DroppedCount());
+  for (int i = 1; i < 4; i++) {
+    ASSERT_TRUE(consumer_->Read(&out));
+  }
+  EXPECT_EQ("0xxxxxxxxxxx1xxxxxxxxxxx2xxxxxxxxxxx3xxxxxxxxxxx", out);
+  EXPECT_FALSE(consumer_->Read(&out));
+}
+
+// Tests attaching to a ring in an ashmem region.
+TEST_F(VtsTraceRingBufferTest, AttachAshmem) {
+  int fd = ashmem_create_region("VtsTraceRingBufferTest",
+                                kRingDataOffset + kCapacity);
+  ASSERT_GE(fd, 0);
+  unique_ptr<VtsTraceRingBuffer> producer =
+      VtsTraceRingBuffer::Create(fd, kCapacity);
+  ASSERT_NE(nullptr, producer);
+  unique_ptr<VtsTraceRingBuffer> consumer = VtsTraceRingBuffer::Attach(fd);
+  close(fd);
+  ASSERT_NE(nullptr, consumer);
+  EXPECT_EQ(kCapacity, consumer->Capacity());
+  ASSERT_TRUE(producer->Write("ashmem", 6));
+  string out;
+  ASSERT_TRUE(consumer->Read(&out));
+  EXPECT_EQ("ashmem", out);
+}
+
+// Tests that an attached memfd region can no longer shrink.
+TEST_F(VtsTraceRingBufferTest, AttachSealsMemfd) {
+  EXPECT_EQ(kCapacity, consumer_->Capacity());
+  int seals = fcntl(fd_, F_GET_SEALS);
+  ASSERT_GE(seals, 0);
+  EXPECT_TRUE(seals & F_SEAL_SHRINK);
+  EXPECT_NE(0, ftruncate(fd_, kRingDataOffset));
+}
+
+// Tests that a region smaller than the capacity in its header is rejected.
+TEST_F(VtsTraceRingBufferTest, AttachTruncated) {
+  int fd = memfd_create("VtsTraceRingBufferTest", 0);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(0, ftruncate(fd, kRingDataOffset + kCapacity));
+  ASSERT_NE(nullptr, VtsTraceRingBuffer::Create(fd, kCapacity));
+  ASSERT_EQ(0, ftruncate(fd, kRingDataOffset + kCapacity / 2));
+  EXPECT_EQ(nullptr, VtsTraceRingBuffer::Attach(fd));
+  ASSERT_EQ(0, ftruncate(fd, kRingDataOffset / 2));
+  EXPECT_EQ(nullptr, VtsTraceRingBuffer::Attach(fd));
+  close(fd);
+}
+
+// Tests that a region that is not a ring is rejected.
+TEST_F(VtsTraceRingBufferTest, AttachInvalid) {
+  int fd = memfd_create("VtsTraceRingBufferTest", 0);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(0, ftruncate(fd, kRingDataOffset + kCapacity));
+  EXPECT_EQ(nullptr, VtsTraceRingBuffer::Attach(fd));
+  close(fd);
+}
+
+// Tests that a write position beyond the capacity skips the data.
+TEST_F(VtsTraceRingBufferTest, CorruptWritePos) {
+  ASSERT_TRUE(producer_->Write("message", 7));
+  VtsTraceRingHeader* header = MapHeader();
+  ASSERT_NE(nullptr, header);
+  uint64_t write_pos = header->read_pos + kCapacity + 1;
+  header->write_pos = write_pos;
+  string out;
+  EXPECT_FALSE(consumer_->Read(&out));
+  EXPECT_TRUE(out.empty());
+  EXPECT_EQ(write_pos, header->read_pos);
+  EXPECT_FALSE(consumer_->Read(&out));
+  munmap(header, kRingDataOffset);
+}
+
+// Tests that a message size beyond the data written skips the data.
+TEST_F(VtsTraceRingBufferTest, CorruptMessageSize) {
+  ASSERT_TRUE(producer_->Write("message", 7));
+  ASSERT_TRUE(producer_->Write("next", 4));
+  uint8_t* region = static_cast<uint8_t*>(
+      mmap(nullptr, kRingDataOffset + kCapacity, PROT_READ | PROT_WRITE,
+           MAP_SHARED, fd_, 0));
+  ASSERT_NE(MAP_FAILED, region);
+  VtsTraceRingHeader* header = reinterpret_cast<VtsTraceRingHeader*>(region);
+  for (uint32_t size : {static_cast<uint32_t>(kCapacity), UINT32_MAX}) {
+    uint64_t read_pos = header->read_pos;
+    memcpy(region + kRingDataOffset + (read_pos & (kCapacity - 1)), &size,
+           sizeof(size));
+    string out;
+    EXPECT_FALSE(consumer_->Read(&out));
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(header->write_pos, header->read_pos);
+    // The ring is usable again.
+    ASSERT_TRUE(producer_->Write("again", 5));
+    ASSERT_TRUE(consumer_->Read(&out));
+    EXPECT_EQ("again", out);
+    ASSERT_TRUE(producer_->Write("corrupt", 7));
+  }
+  munmap(region, kRingDataOffset + kCapacity);
+}
+
+}  // namespace vts
+}  // namespace android
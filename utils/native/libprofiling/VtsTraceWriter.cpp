@@ -0,0 +1,400 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsTraceWriter.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <algorithm>
+#include <chrono>
+
+#include <android-base/logging.h>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Interval at which the buffered records are written if the high-water mark
+// is not reached.
+static constexpr chrono::milliseconds kFlushInterval(500);
+
+// Used to assign a unique id to each writer.
+static atomic<int> next_writer_id(0);
+
+VtsTraceWriter::VtsTraceWriter(size_t buffer_size, size_t high_water_mark,
+                               bool compress)
+    : id_(next_writer_id++),
+      buffer_size_(buffer_size),
+      high_water_mark_(max<size_t>(1, min(high_water_mark, buffer_size))),
+      compress_(compress),
+      drain_count_(0),
+      buffered_bytes_(0),
+      wakeup_pending_(false),
+      flush_requested_(false),
+      flush_count_(0),
+      completed_flush_count_(0),
+      stop_(false) {
+  writer_thread_ = thread(&VtsTraceWriter::WriterLoop, this);
+}
+
+VtsTraceWriter::~VtsTraceWriter() {
+  {
+    unique_lock<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  writer_cv_.notify_one();
+  writer_thread_.join();
+}
+
+VtsTraceWriter::ThreadBuffer* VtsTraceWriter::GetThreadBuffer() {
+  static thread_local shared_ptr<ThreadBuffer> thread_buffer;
+  static thread_local int thread_buffer_owner = -1;
+  if (thread_buffer_owner != id_) {
+    thread_buffer = make_shared<ThreadBuffer>();
+    thread_buffer_owner = id_;
+    unique_lock<mutex> lock(mutex_);
+    thread_buffers_.push_back(thread_buffer);
+  }
+  return thread_buffer.get();
+}
+
+VtsTraceWriter::PendingWrite VtsTraceWriter::BeginWrite() {
+  // Block while the buffers are full.
+  if (buffered_bytes_ >= buffer_size_) {
+    unique_lock<mutex> lock(mutex_);
+    while (buffered_bytes_ >= buffer_size_) {
+      flush_requested_ = true;
+      writer_cv_.notify_one();
+      drained_cv_.wait(lock);
+    }
+  }
+  return PendingWrite(this, GetThreadBuffer());
+}
+
+void VtsTraceWriter::PendingWrite::Write(int trace_file, uint64_t generation,
+                                         int64_t timestamp, string&& data) {
+  size_t size = data.size();
+  thread_buffer_->records.push_back(
+      {trace_file, generation, timestamp, move(data)});
+  lock_.unlock();
+  if (writer_->buffered_bytes_.fetch_add(size) + size >=
+          writer_->high_water_mark_ &&
+      !writer_->wakeup_pending_.exchange(true)) {
+    unique_lock<mutex> lock(writer_->mutex_);
+    writer_->writer_cv_.notify_one();
+  }
+}
+
+void VtsTraceWriter::SetFile(int trace_file, uint64_t generation, int fd,
+                             function<void()> on_replaced,
+                             atomic<bool>* write_error) {
+  unique_lock<mutex> lock(mutex_);
+  pending_files_.push_back(
+      {trace_file, generation, fd, move(on_replaced), write_error});
+}
+
+void VtsTraceWriter::WriteAhead(int trace_file, uint64_t generation,
+                                string&& data) {
+  size_t size = data.size();
+  unique_lock<mutex> lock(mutex_);
+  ahead_records_.push_back({trace_file, generation, 0, move(data)});
+  buffered_bytes_ += size;
+}
+
+void VtsTraceWriter::Flush() {
+  unique_lock<mutex> lock(mutex_);
+  // Wait for a drain that starts after this call, so that it also writes the
+  // records queued by this thread.
+  uint64_t flush_count = ++flush_count_;
+  flush_requested_ = true;
+  writer_cv_.notify_one();
+  while (completed_flush_count_ < flush_count) {
+    drained_cv_.wait(lock);
+  }
+}
+
+void VtsTraceWriter::WriterLoop() {
+  vector<PendingRecord> records;
+  vector<PendingRecord> ahead_records;
+  vector<PendingRecord> held_records;
+  vector<PendingFile> pending_files;
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    writer_cv_.wait_for(lock, kFlushInterval, [this] {
+      return stop_ || flush_requested_ || buffered_bytes_ >= high_water_mark_;
+    });
+    flush_requested_ = false;
+    wakeup_pending_ = false;
+    uint64_t flush_count = flush_count_;
+    bool stop = stop_;
+    bool flush_compressors = stop || flush_count > completed_flush_count_;
+    lock.unlock();
+    drain_count_++;
+
+    // The files and the data written ahead are taken after the records, so
+    // that they include the ones any of the records depend on.
+    bool idle = !CollectRecords(&records);
+    lock.lock();
+    pending_files.swap(pending_files_);
+    ahead_records.swap(ahead_records_);
+    lock.unlock();
+    idle &= ahead_records.empty() && pending_files.empty();
+    AddFiles(&pending_files);
+
+    // The records held back precede, for each thread, the ones queued since.
+    held_records.swap(held_records_);
+    size_t written_bytes = 0;
+    for (auto* batch : {&held_records, &ahead_records, &records}) {
+      written_bytes += WriteRecords(batch, &held_records_);
+      batch->clear();
+    }
+    if (stop && idle && !held_records_.empty()) {
+      LOG(ERROR) << "Dropped " << held_records_.size()
+                 << " records of trace files never set.";
+      for (const auto& record : held_records_) {
+        written_bytes += record.data.size();
+      }
+      held_records_.clear();
+    }
+    buffered_bytes_ -= written_bytes;
+    // A file is replaced in the drain that sees the next one set, which is
+    // published before. A producer that read its generation either held its
+    // buffer when the next drain collected it, or is done by then, so the
+    // file is handed over at the end of the next drain.
+    ReleaseReplacedFiles(stop && idle);
+    if (flush_compressors) {
+      FlushCompressors();
+    }
+
+    lock.lock();
+    completed_flush_count_ = flush_count;
+    drained_cv_.notify_all();
+    if (stop && idle) {
+      break;
+    }
+  }
+}
+
+bool VtsTraceWriter::CollectRecords(vector<PendingRecord>* records) {
+  vector<shared_ptr<ThreadBuffer>> thread_buffers;
+  {
+    unique_lock<mutex> lock(mutex_);
+    thread_buffers = thread_buffers_;
+  }
+  vector<size_t> run_ends;
+  vector<ThreadBuffer*> exited_buffers;
+  for (const auto& thread_buffer : thread_buffers) {
+    unique_lock<mutex> lock(thread_buffer->buffer_mutex);
+    // The buffer of a thread that has exited is only referenced here and by
+    // thread_buffers_, and it stays empty once collected.
+    if (thread_buffer.use_count() == 2) {
+      exited_buffers.push_back(thread_buffer.get());
+    }
+    if (thread_buffer->records.empty()) {
+      continue;
+    }
+    move(thread_buffer->records.begin(), thread_buffer->records.end(),
+         back_inserter(*records));
+    thread_buffer->records.clear();
+    run_ends.push_back(records->size());
+  }
+  if (!exited_buffers.empty()) {
+    unique_lock<mutex> lock(mutex_);
+    thread_buffers_.erase(
+        remove_if(thread_buffers_.begin(), thread_buffers_.end(),
+                  [&exited_buffers](const shared_ptr<ThreadBuffer>& buffer) {
+                    return find(exited_buffers.begin(), exited_buffers.end(),
+                                buffer.get()) != exited_buffers.end();
+                  }),
+        thread_buffers_.end());
+  }
+  if (records->empty()) {
+    return false;
+  }
+  // The records of each thread are already ordered by timestamp, merge the
+  // sorted runs pairwise.
+  auto by_timestamp = [](const PendingRecord& lhs, const PendingRecord& rhs) {
+    return lhs.timestamp < rhs.timestamp;
+  };
+  while (run_ends.size() > 1) {
+    vector<size_t> merged_run_ends;
+    size_t run_begin = 0;
+    for (size_t i = 0; i + 1 < run_ends.size(); i += 2) {
+      inplace_merge(records->begin() + run_begin,
+                    records->begin() + run_ends[i],
+                    records->begin() + run_ends[i + 1], by_timestamp);
+      merged_run_ends.push_back(run_ends[i + 1]);
+      run_begin = run_ends[i + 1];
+    }
+    if (run_ends.size() % 2) {
+      merged_run_ends.push_back(run_ends.back());
+    }
+    run_ends.swap(merged_run_ends);
+  }
+  return true;
+}
+
+void VtsTraceWriter::AddFiles(vector<PendingFile>* pending_files) {
+  for (auto& pending_file : *pending_files) {
+    deque<OutputFile>& files = files_[pending_file.trace_file];
+    if (!files.empty()) {
+      files.back().on_replaced = move(pending_file.on_replaced);
+      files.back().replaced_drain = drain_count_;
+    }
+    files.push_back({pending_file.generation, pending_file.fd, nullptr,
+                     pending_file.write_error, nullptr, 0});
+    if (compress_) {
+      // The blocks are independent, so a replacing file needs no header.
+      files.back().compressor.reset(new VtsTraceCompressor(pending_file.fd));
+    }
+  }
+  pending_files->clear();
+}
+
+VtsTraceWriter::OutputFile* VtsTraceWriter::FindFile(int trace_file,
+                                                     uint64_t generation) {
+  auto found = files_.find(trace_file);
+  if (found == files_.end()) {
+    return nullptr;
+  }
+  for (auto& file : found->second) {
+    if (file.generation == generation) {
+      return &file;
+    }
+  }
+  return nullptr;
+}
+
+bool VtsTraceWriter::IsFutureGeneration(int trace_file, uint64_t generation) {
+  auto found = files_.find(trace_file);
+  return found == files_.end() || found->second.empty() ||
+         generation > found->second.back().generation;
+}
+
+size_t VtsTraceWriter::WriteRecords(vector<PendingRecord>* records,
+                                    vector<PendingRecord>* held_records) {
+  struct iovec iov[IOV_MAX];
+  size_t written_bytes = 0;
+  size_t i = 0;
+  while (i < records->size()) {
+    size_t batch_start = i;
+    int trace_file = (*records)[i].trace_file;
+    uint64_t generation = (*records)[i].generation;
+    int iov_count = 0;
+    size_t batch_bytes = 0;
+    while (i < records->size() && (*records)[i].trace_file == trace_file &&
+           (*records)[i].generation == generation && iov_count < IOV_MAX) {
+      iov[iov_count].iov_base = const_cast<char*>((*records)[i].data.data());
+      iov[iov_count].iov_len = (*records)[i].data.size();
+      batch_bytes += iov[iov_count].iov_len;
+      iov_count++;
+      i++;
+    }
+    OutputFile* file = FindFile(trace_file, generation);
+    if (file == nullptr && IsFutureGeneration(trace_file, generation)) {
+      move(records->begin() + batch_start, records->begin() + i,
+           back_inserter(*held_records));
+      continue;
+    }
+    written_bytes += batch_bytes;
+    if (file == nullptr) {
+      // Only if a generation was not set in order.
+      LOG(ERROR) << "Dropped " << iov_count << " records of trace file "
+                 << trace_file << " queued after it was handed over.";
+      continue;
+    }
+    if (file->fd < 0) {
+      continue;
+    }
+    bool written = true;
+    if (file->compressor) {
+      for (size_t j = batch_start; j < i; j++) {
+        written &= file->compressor->Write((*records)[j].data.data(),
+                                           (*records)[j].data.size());
+      }
+    } else {
+      written = WriteFully(file->fd, iov, iov_count);
+    }
+    if (!written) {
+      PLOG(ERROR) << "Failed to write " << iov_count << " records to fd "
+                  << file->fd;
+      if (file->write_error) {
+        *file->write_error = true;
+      }
+    }
+  }
+  return written_bytes;
+}
+
+void VtsTraceWriter::ReleaseReplacedFiles(bool all) {
+  for (auto& trace_file_files : files_) {
+    deque<OutputFile>& files = trace_file_files.second;
+    // The current file, the last one, is not replaced.
+    while (files.size() > 1 &&
+           (all || files.front().replaced_drain < drain_count_)) {
+      OutputFile& file = files.front();
+      FlushCompressor(&file);
+      file.compressor.reset();
+      if (file.on_replaced) {
+        file.on_replaced();
+      }
+      files.pop_front();
+    }
+  }
+}
+
+void VtsTraceWriter::FlushCompressors() {
+  for (auto& trace_file_files : files_) {
+    for (auto& file : trace_file_files.second) {
+      FlushCompressor(&file);
+    }
+  }
+}
+
+void VtsTraceWriter::FlushCompressor(OutputFile* file) {
+  if (file->compressor && !file->compressor->Flush()) {
+    PLOG(ERROR) << "Failed to write compressed records to fd " << file->fd;
+    if (file->write_error) {
+      *file->write_error = true;
+    }
+  }
+}
+
+bool VtsTraceWriter::WriteFully(int fd, struct iovec* iov, int iov_count) {
+  while (iov_count > 0) {
+    ssize_t written = writev(fd, iov, iov_count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    // Skip the buffers that are completely written.
+    while (iov_count > 0 && static_cast<size_t>(written) >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iov_count--;
+    }
+    if (iov_count > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
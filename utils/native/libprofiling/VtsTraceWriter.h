@@ -0,0 +1,250 @@
+/*
+ * Copyright 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_DRIVER_TRACE_WRITER_H_
+#define __VTS_DRIVER_TRACE_WRITER_H_
+
+#include <android-base/macros.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VtsTraceCompression.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Buffers serialized trace records in memory and writes them to the trace
+// files from a background thread, so that the instrumented HAL threads do not
+// block on file I/O.
+//
+// Each producer thread appends to its own buffer, so concurrent producers do
+// not contend with each other. The writer thread collects the records of all
+// the threads, merges them by timestamp and writes them with batched writev
+// calls. The records of a thread are always written in order; records of
+// different threads queued around the time of a drain may end up in
+// consecutive batches.
+//
+// The writer owns the files it writes to. A record is queued for a trace file
+// and a generation of it, read while the buffer of the producer is held (see
+// BeginWrite), and the writer thread resolves the file of that generation
+// (see SetFile). So a trace file can be replaced while records are queued for
+// it, without the producers synchronizing with each other.
+//
+// The total buffered size is bounded by buffer_size bytes, plus a record per
+// producer. Once it reaches high_water_mark bytes, the writer thread is woken
+// up to drain the buffers. Otherwise, the buffers are drained periodically. A
+// producer only blocks if the buffers are full.
+//
+// If compress is set, the records of each file are written in blocks
+// compressed by a VtsTraceCompressor. The last partial block of a file is
+// written by Flush, the destructor, and before the file is handed over.
+class VtsTraceWriter {
+ private:
+  struct ThreadBuffer;
+
+ public:
+  // Queues a record of the calling thread, see BeginWrite.
+  class PendingWrite {
+   public:
+    // Queues the serialized record data for the file of the given generation
+    // of trace_file. timestamp is the time of the traced event, used to order
+    // the records coming from different threads. Must be called once.
+    void Write(int trace_file, uint64_t generation, int64_t timestamp,
+               string&& data);
+
+   private:
+    friend class VtsTraceWriter;
+
+    PendingWrite(VtsTraceWriter* writer, ThreadBuffer* thread_buffer)
+        : writer_(writer),
+          thread_buffer_(thread_buffer),
+          lock_(thread_buffer->buffer_mutex) {}
+
+    VtsTraceWriter* writer_;
+    ThreadBuffer* thread_buffer_;
+    unique_lock<mutex> lock_;
+  };
+
+  VtsTraceWriter(size_t buffer_size, size_t high_water_mark,
+                 bool compress = false);
+
+  // Writes all the buffered records and stops the writer thread. The files
+  // replaced so far are handed over to the on_replaced of their replacement,
+  // the current ones are left to the caller.
+  virtual ~VtsTraceWriter();
+
+  // Waits while the buffers are full, then holds the buffer of the calling
+  // thread until the returned object is destroyed. The generation of the file
+  // a record is queued for must be read meanwhile: the file of a generation
+  // is not handed over while a producer that may have read it holds its
+  // buffer. Encoding the record here keeps the writer thread waiting, so
+  // only what depends on the generation should be.
+  PendingWrite BeginWrite();
+
+  // Sets fd as the file of the given generation of trace_file, e.g. the
+  // handle of its HAL, when the trace file is created or replaced. The
+  // generations of a trace file must increase, and a generation must be
+  // published to the producers before it is set here. The records queued for
+  // a generation that is not set yet are held back until it is. The previous
+  // file of trace_file keeps getting the records of its own generation until
+  // none can be queued anymore; it is then flushed and on_replaced, if any,
+  // is called on the writer thread, e.g. to close that previous file.
+  // write_error, if not null, is set by the writer thread if data can't be
+  // written to fd, and must outlive the writer.
+  void SetFile(int trace_file, uint64_t generation, int fd,
+               function<void()> on_replaced,
+               atomic<bool>* write_error = nullptr);
+
+  // Queues data to be written to the file of the given generation of
+  // trace_file before any record queued, on any thread, after this call
+  // returns, e.g. the definitions these records refer to. Does not block.
+  void WriteAhead(int trace_file, uint64_t generation, string&& data);
+
+  // Blocks until all the records queued so far are written, including the
+  // partial compressed blocks.
+  void Flush();
+
+ private:
+  // A serialized record and the file it belongs to.
+  struct PendingRecord {
+    int trace_file;
+    uint64_t generation;
+    int64_t timestamp;
+    string data;
+  };
+
+  // A file the records of a trace file are written to.
+  struct OutputFile {
+    uint64_t generation;
+    int fd;
+    // Given by the SetFile call that replaced this file, if any.
+    function<void()> on_replaced;
+    // may be null.
+    atomic<bool>* write_error;
+    // only set in compress mode.
+    unique_ptr<VtsTraceCompressor> compressor;
+    // Number of the drain that saw a file of a later generation set, 0 while
+    // this is the current file.
+    uint64_t replaced_drain;
+  };
+
+  // A call to SetFile not yet seen by the writer thread.
+  struct PendingFile {
+    int trace_file;
+    uint64_t generation;
+    int fd;
+    function<void()> on_replaced;
+    atomic<bool>* write_error;
+  };
+
+  // Records queued by a single producer thread.
+  struct ThreadBuffer {
+    // Held by the producer while it queues a record, and by the writer
+    // thread while it collects the records.
+    mutex buffer_mutex;
+    vector<PendingRecord> records;
+  };
+
+  // Returns the buffer of the calling thread, creating it if needed.
+  ThreadBuffer* GetThreadBuffer();
+  // Main loop of the writer thread.
+  void WriterLoop();
+  // Moves the records of all the thread buffers into records, ordered by
+  // timestamp, and releases the buffers of the threads that have exited.
+  // Returns false if there is no buffered record.
+  bool CollectRecords(vector<PendingRecord>* records);
+  // Makes the given files the current ones of their trace files.
+  void AddFiles(vector<PendingFile>* pending_files);
+  // Returns the file of the given generation of trace_file, nullptr if it
+  // has been handed over.
+  OutputFile* FindFile(int trace_file, uint64_t generation);
+  // Returns whether the given generation of trace_file is not set yet.
+  bool IsFutureGeneration(int trace_file, uint64_t generation);
+  // Writes the given records in order, batching consecutive records of the
+  // same file into a single writev call. Moves the records of the
+  // generations not set yet to held_records, and sets the write_error of the
+  // files that can't be written. Returns the number of bytes written or
+  // dropped.
+  size_t WriteRecords(vector<PendingRecord>* records,
+                      vector<PendingRecord>* held_records);
+  // Flushes the files replaced before the current drain, or all the
+  // replaced files if all is set, and calls their on_replaced.
+  void ReleaseReplacedFiles(bool all);
+  // Writes all the given buffers to fd, retrying on partial writes.
+  bool WriteFully(int fd, struct iovec* iov, int iov_count);
+  // Writes the partial compressed blocks of all the files.
+  void FlushCompressors();
+  // Writes the partial compressed block of file.
+  void FlushCompressor(OutputFile* file);
+
+  // Unique id of this writer, used to tell apart the thread buffers.
+  const int id_;
+  // Maximum number of bytes buffered (queued and being written).
+  const size_t buffer_size_;
+  // Number of buffered bytes that triggers a drain.
+  const size_t high_water_mark_;
+  // Whether the records are compressed.
+  const bool compress_;
+  // Files of each trace file, the current one last, the records held back
+  // for the generations not set yet, and the number of the current drain.
+  // Only used by the writer thread.
+  map<int, deque<OutputFile>> files_;
+  vector<PendingRecord> held_records_;
+  uint64_t drain_count_;
+  // Total number of bytes queued and not written yet.
+  atomic<size_t> buffered_bytes_;
+  // Whether the writer thread has been woken up for the high-water mark.
+  atomic<bool> wakeup_pending_;
+
+  // Mutex protecting all the fields below.
+  mutex mutex_;
+  // Signaled when the writer thread should wake up.
+  condition_variable writer_cv_;
+  // Signaled when the writer thread finishes writing a batch.
+  condition_variable drained_cv_;
+  // Buffers of all the producer threads.
+  vector<shared_ptr<ThreadBuffer>> thread_buffers_;
+  // Files set and data queued by WriteAhead since the last drain.
+  vector<PendingFile> pending_files_;
+  vector<PendingRecord> ahead_records_;
+  // Whether the buffers should be drained regardless of the high-water mark.
+  bool flush_requested_;
+  // Number of calls to Flush so far, and number of them completed.
+  uint64_t flush_count_;
+  uint64_t completed_flush_count_;
+  // Whether the writer thread should exit.
+  bool stop_;
+
+  thread writer_thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(VtsTraceWriter);
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_DRIVER_TRACE_WRITER_H_
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2020 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __VTS_PROFILING_LATENCY_HISTOGRAM_H_
+#define __VTS_PROFILING_LATENCY_HISTOGRAM_H_
+
+#include <stdint.h>
+#include <atomic>
+
+// Header only, so that the libraries which measure latencies (e.g.
+// libvts_measurement, libvts_profiling and the trace processor) share one
+// implementation without depending on each other.
+
+namespace android {
+namespace vts {
+
+// Log-linear buckets of latencies: exact below 2 << kSubBucketBits ns, then
+// 1 << kSubBucketBits buckets per power of two, so the end of the bucket of
+// a value is within 1 / (1 << kSubBucketBits) of the value.
+template <int kSubBucketBits>
+struct VtsLatencyBuckets {
+  static constexpr int kExactBucketCount = 2 << kSubBucketBits;
+  static constexpr int kBucketCount =
+      kExactBucketCount + (63 - kSubBucketBits - 1) * (1 << kSubBucketBits);
+
+  // Returns the bucket of a latency. Negative values are in bucket 0.
+  static int GetBucket(int64_t value_ns) {
+    if (value_ns < kExactBucketCount) {
+      return value_ns < 0 ? 0 : value_ns;
+    }
+    // The highest bit set, at least kSubBucketBits + 1.
+    int exponent = 63 - __builtin_clzll(value_ns);
+    int sub_bucket = (value_ns >> (exponent - kSubBucketBits)) &
+                     ((1 << kSubBucketBits) - 1);
+    return kExactBucketCount +
+           ((exponent - kSubBucketBits - 1) << kSubBucketBits) + sub_bucket;
+  }
+
+  // Returns the largest value of a bucket.
+  static int64_t GetBucketEnd(int bucket) {
+    if (bucket < kExactBucketCount) {
+      return bucket;
+    }
+    int exponent = ((bucket - kExactBucketCount) >> kSubBucketBits) +
+                   kSubBucketBits + 1;
+    int64_t sub_bucket = (bucket - kExactBucketCount) &
+                         ((1 << kSubBucketBits) - 1);
+    int shift = exponent - kSubBucketBits;
+    // The end of the last bucket is INT64_MAX, so the shift is unsigned.
+    return static_cast<int64_t>(
+        ((static_cast<uint64_t>(1 << kSubBucketBits) + sub_bucket + 1)
+         << shift) - 1);
+  }
+};
+
+// The distribution of the latencies of the calls of a method, counted in a
+// fixed set of log-linear buckets: exact below 16 ns, then 8 per power of
+// two, so a percentile is within 12.5% of the measured value. Recording does
+// not allocate or lock, and may happen on several threads at once.
+class VtsLatencyHistogram {
+ public:
+  VtsLatencyHistogram() { Reset(); }
+
+  VtsLatencyHistogram(const VtsLatencyHistogram&) = delete;
+  VtsLatencyHistogram& operator=(const VtsLatencyHistogram&) = delete;
+
+  // Adds a latency in nano seconds. Negative values are counted as 0.
+  void Record(int64_t value_ns) {
+    if (value_ns < 0) value_ns = 0;
+    buckets_[Buckets::GetBucket(value_ns)].fetch_add(
+        1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+    int64_t min_ns = min_ns_.load(std::memory_order_relaxed);
+    while (value_ns < min_ns &&
+           !min_ns_.compare_exchange_weak(min_ns, value_ns,
+                                          std::memory_order_relaxed)) {
+    }
+    int64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+    while (value_ns > max_ns &&
+           !max_ns_.compare_exchange_weak(max_ns, value_ns,
+                                          std::memory_order_relaxed)) {
+    }
+  }
+
+  // Clears the latencies recorded. Not to be called while recording.
+  void Reset() {
+    for (auto& bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_ns_.store(0, std::memory_order_relaxed);
+    min_ns_.store(INT64_MAX, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+  }
+
+  int64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+  int64_t GetSumNs() const { return sum_ns_.load(std::memory_order_relaxed); }
+  // Returns 0 if there is no value.
+  int64_t GetMinNs() const {
+    int64_t min_ns = min_ns_.load(std::memory_order_relaxed);
+    return min_ns == INT64_MAX ? 0 : min_ns;
+  }
+  int64_t GetMaxNs() const { return max_ns_.load(std::memory_order_relaxed); }
+
+  // Returns the latency that percentile (0 to 100) percent of the values are
+  // at most, rounded up to the end of its bucket but not above the maximum,
+  // or 0 if there is no value.
+  int64_t GetPercentileNs(double percentile) const {
+    int64_t count = GetCount();
+    if (count == 0) {
+      return 0;
+    }
+    // The rank of the value, from 1 to count.
+    int64_t rank = static_cast<int64_t>(percentile / 100 * count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    int64_t max_ns = GetMaxNs();
+    int64_t seen = 0;
+    for (int bucket = 0; bucket < Buckets::kBucketCount; bucket++) {
+      seen += buckets_[bucket].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        int64_t end = Buckets::GetBucketEnd(bucket);
+        return end < max_ns ? end : max_ns;
+      }
+    }
+    // Only if values were recorded meanwhile.
+    return max_ns;
+  }
+
+ private:
+  typedef VtsLatencyBuckets<3> Buckets;
+
+  std::atomic<int64_t> buckets_[Buckets::kBucketCount];
+  std::atomic<int64_t> count_;
+  std::atomic<int64_t> sum_ns_;
+  std::atomic<int64_t> min_ns_;
+  std::atomic<int64_t> max_ns_;
+};
+
+}  // namespace vts
+}  // namespace android
+#endif  // __VTS_PROFILING_LATENCY_HISTOGRAM_H_
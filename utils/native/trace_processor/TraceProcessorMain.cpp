@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 #include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
 
 #include "VtsCoverageProcessor.h"
 #include "VtsTraceProcessor.h"
@@ -26,30 +30,64 @@ using namespace std;
 
 enum mode_code {
   // Trace related operations.
+  CALLBACK_LATENCY,
   CLEANUP_TRACE,
+  COMPARE_LATENCY,
   CONVERT_TRACE,
+  CONVERT_TRACE_TO_COMPACT,
+  CONVERT_TRACE_TO_DELIMITED,
+  CORRELATE_TRACE,
+  COUNT_TRACE,
   DEDUPE_TRACE,
+  EXPAND_TRACE,
+  EXPORT_TRACE,
+  FUZZ_SEEDS_FROM_TRACE,
   GET_TEST_LIST_FROM_TRACE,
+  INDEX_TRACE,
   PARSE_TRACE,
   PROFILING_TRACE,
   SELECT_TRACE,
+  SELECT_CORPUS,
+  SLOW_CALLS,
   // Coverage related operations.
   COMPARE_COVERAGE,
+  CONCAT_COVERAGE,
+  CONVERT_COVERAGE_TO_BINARY,
+  CONVERT_COVERAGE_TO_TEXT,
   GET_COVERGAGE_SUMMARY,
   GET_SUBSET_COVERAGE,
   MERGE_COVERAGE,
 };
 
 mode_code getModeCode(const std::string& str) {
+  if (str == "callback_latency") return mode_code::CALLBACK_LATENCY;
   if (str == "cleanup_trace") return mode_code::CLEANUP_TRACE;
+  if (str == "compare_latency") return mode_code::COMPARE_LATENCY;
   if (str == "convert_trace") return mode_code::CONVERT_TRACE;
+  if (str == "convert_trace_to_compact")
+    return mode_code::CONVERT_TRACE_TO_COMPACT;
+  if (str == "convert_trace_to_delimited")
+    return mode_code::CONVERT_TRACE_TO_DELIMITED;
+  if (str == "correlate_trace") return mode_code::CORRELATE_TRACE;
+  if (str == "count_trace") return mode_code::COUNT_TRACE;
   if (str == "dedup_trace") return mode_code::DEDUPE_TRACE;
+  if (str == "expand_trace") return mode_code::EXPAND_TRACE;
+  if (str == "export_trace") return mode_code::EXPORT_TRACE;
+  if (str == "fuzz_seeds_from_trace") return mode_code::FUZZ_SEEDS_FROM_TRACE;
   if (str == "get_test_list_from_trace")
     return mode_code::GET_TEST_LIST_FROM_TRACE;
+  if (str == "index_trace") return mode_code::INDEX_TRACE;
   if (str == "parse_trace") return mode_code::PARSE_TRACE;
   if (str == "profiling_trace") return mode_code::PROFILING_TRACE;
   if (str == "select_trace") return mode_code::SELECT_TRACE;
+  if (str == "select_corpus") return mode_code::SELECT_CORPUS;
+  if (str == "slow_calls") return mode_code::SLOW_CALLS;
   if (str == "compare_coverage") return mode_code::COMPARE_COVERAGE;
+  if (str == "concat_coverage") return mode_code::CONCAT_COVERAGE;
+  if (str == "convert_coverage_to_binary")
+    return mode_code::CONVERT_COVERAGE_TO_BINARY;
+  if (str == "convert_coverage_to_text")
+    return mode_code::CONVERT_COVERAGE_TO_TEXT;
   if (str == "get_coverage_summary") return mode_code::GET_COVERGAGE_SUMMARY;
   if (str == "get_subset_coverage") return mode_code::GET_SUBSET_COVERAGE;
   if (str == "merge_coverage") return mode_code::MERGE_COVERAGE;
@@ -61,29 +99,81 @@ void ShowUsage() {
   printf(
       "Usage:   trace_processor [options] <input>\n"
       "--mode:  The operation applied to the trace file.\n"
+      "\t callback_latency: pair the requests with the asynchronous callbacks "
+      "they trigger, as listed by the rules file (second argument), in the "
+      "trace file or the trace files of one run in the given directory (first "
+      "argument), and print the distribution of the request-to-callback "
+      "latency of each rule, or the latency of each pair with --verbose. Each "
+      "rule is a line '<request api> <callback api>' with full api names, "
+      "e.g. android.hardware.nfc@1.0::INfc::open.\n"
       "\t cleanup_trace: cleanup trace for replay (remove duplicate events "
       "etc.).\n"
+      "\t compare_latency: compare the latency of each api between the trace "
+      "files of a baseline (first argument) and of a new build (second "
+      "argument), print the apis whose median latency regressed "
+      "significantly, largest shift first, and write them to --output as a "
+      "text format report.\n"
       "\t convert_trace: convert a text format trace file into a binary format "
       "trace.\n"
+      "\t convert_trace_to_compact: convert a binary format trace file into a "
+      "compact format trace.\n"
+      "\t convert_trace_to_delimited: convert a compact format trace file into "
+      "a binary format trace of delimited records.\n"
+      "\t correlate_trace: join the calls of a client trace (first argument) "
+      "with those of the server trace of the same run (second argument) and "
+      "print the distribution of the total latency, HAL execution time and "
+      "binder transport overhead of each api, or their values for each api "
+      "call with --verbose.\n"
+      "\t count_trace: print the number of calls of each api in the trace "
+      "file.\n"
       "\t dedup_trace: remove duplicate trace file in the given directory. A "
       "trace is considered duplicated if there exists a trace that contains "
       "the "
       "same API call sequence as the given trace and the input parameters for "
       "each API call are all the same.\n"
+      "\t expand_trace: convert a binary format trace file into a binary "
+      "format trace with the vectors recorded as raw bytes expanded into one "
+      "value per element (e.g. for replay).\n"
+      "\t export_trace: convert a binary format trace file, or the trace "
+      "files of one run in the given directory, into a Chrome JSON trace "
+      "written to --output, to view the calls on a timeline in the Perfetto "
+      "UI or chrome://tracing, with a flow from each client call to its "
+      "server call.\n"
+      "\t fuzz_seeds_from_trace: convert the arguments of each HAL call "
+      "entry in the trace file, but not of the callbacks, into a seed input "
+      "of the fuzzer generated by vtsc for its function, written to "
+      "<output>/<function name>/.\n"
       "\t get_test_list_from_trace: parse all trace files under the given "
       "directory and create a list of test modules for each hal@version that "
       "access all apis covered by the whole test set. (i.e. such list should "
       "be a subset of the whole test list that access the corresponding "
       "hal@version)\n"
+      "\t index_trace: build the index of the trace file used by count_trace "
+      "and parse_trace to only read the records they need. Only for traces of "
+      "delimited records that are not compressed.\n"
       "\t parse_trace: parse the binary format trace file and print the text "
       "format trace. \n"
-      "\t profiling_trace: parse the trace file to get the latency of each api "
-      "call.\n"
+      "\t profiling_trace: parse the trace file to get the distribution of the "
+      "latency of each api (count, min, mean, p50, p90, p99, max), and of "
+      "the time its calls spent on and off CPU if the trace has the CPU times "
+      "of the threads, or the latency of each api call with --verbose.\n"
       "\t select_trace: select a subset of trace files from a give trace set "
       "based on their corresponding coverage data, the goal is to pick up the "
       "minimal num of trace files that to maximize the total coverage.\n"
+      "\t select_corpus: select a subset of the inputs of a fuzz corpus "
+      "(second argument) that covers all the edges covered by the corpus, "
+      "based on the 8-bit edge counters of each input in the coverage dir "
+      "(first argument), and copy them to the --output dir if given.\n"
+      "\t slow_calls: print the --top slowest calls of each api in the trace "
+      "file, slowest first, with their arguments and return values, and each "
+      "call slower than --threshold if given, in a single pass.\n"
       "\t compare_coverage: compare a coverage report with a reference "
       "coverage report and print the additional file/lines covered.\n"
+      "\t convert_coverage_to_binary: convert a coverage report into a binary "
+      "coverage report, which is much faster to parse. All the coverage "
+      "operations accept both formats.\n"
+      "\t convert_coverage_to_text: convert a binary coverage report into a "
+      "text format coverage report.\n"
       "\t get_coverage_summary: print the summary of the coverage file (e.g. "
       "covered lines, total lines, coverage rate.) \n"
       "\t get_subset_coverage: extract coverage measurement from coverage "
@@ -91,9 +181,38 @@ void ShowUsage() {
       "in cases when we have an aggregated coverage report for all files but "
       "are only interested in the coverage measurement of a subset of files in "
       "that report.\n"
+      "\t concat_coverage: concatenate the text format partial coverage "
+      "reports under the given directory, e.g. those of all the shards of "
+      "merge_coverage, into one report.\n"
       "\t merge_coverage: merge all coverage reports under the given directory "
       "and generate a merged report.\n"
-      "--output: The file path to store the output results.\n"
+      "--output: The file path to store the output results, or the dir for "
+      "fuzz_seeds_from_trace and select_corpus.\n"
+      "--verbose: Output more details (callback_latency, correlate_trace, "
+      "get_test_list_from_trace, profiling_trace).\n"
+      "--start_time: Only process the records with a timestamp greater than or "
+      "equal to the given one (count_trace, parse_trace).\n"
+      "--end_time: Only process the records with a timestamp less than the "
+      "given one (count_trace, parse_trace).\n"
+      "--follow: Keep reading the trace file of profiling_trace as it is "
+      "written, e.g. during a test, and print every second the call rate and "
+      "the latency distribution of each api over the last --window seconds "
+      "of trace. Only for traces of delimited records that are not "
+      "compressed.\n"
+      "--window: The number of seconds of trace of --follow (default: 10).\n"
+      "--top:    The number of slowest calls of each api printed by "
+      "slow_calls (default: 10).\n"
+      "--threshold: The latency in ns from which slow_calls prints each call "
+      "as an outlier (default: 0, none).\n"
+      "--jobs:   The number of threads to process the files of a directory "
+      "with in cleanup_trace, compare_latency, dedup_trace, "
+      "get_test_list_from_trace and merge_coverage, or the chunks of a "
+      "single uncompressed delimited trace in profiling_trace, dedup_trace "
+      "and get_test_list_from_trace, 0 for one per core (default: 1).\n"
+      "--shard:  <index>/<count>, e.g. 0/4. Only merge the coverage of the "
+      "source files of the given shard in merge_coverage, so that the shards "
+      "can be merged on different machines and the outputs put together by "
+      "concat_coverage (default: 0/1).\n"
       "--help:   Show help\n");
   exit(-1);
 }
@@ -102,16 +221,32 @@ int main(int argc, char** argv) {
   string mode = kDefaultMode;
   string output = kDefaultOutputFile;
   bool verbose_output = false;
+  bool follow = false;
+  int window_seconds = 10;
+  int top_count = 10;
+  int64_t threshold_ns = 0;
+  int64_t start_time = INT64_MIN;
+  int64_t end_time = INT64_MAX;
+  int shard_index = 0;
+  int shard_count = 1;
 
   android::vts::VtsCoverageProcessor coverage_processor;
   android::vts::VtsTraceProcessor trace_processor(&coverage_processor);
 
-  const char* const short_opts = "hm:o:v:";
+  const char* const short_opts = "hm:o:vj:s:e:fw:n:t:d:";
   const option long_opts[] = {
       {"help", no_argument, nullptr, 'h'},
       {"mode", required_argument, nullptr, 'm'},
       {"output", required_argument, nullptr, 'o'},
       {"verbose", no_argument, nullptr, 'v'},
+      {"jobs", required_argument, nullptr, 'j'},
+      {"start_time", required_argument, nullptr, 's'},
+      {"end_time", required_argument, nullptr, 'e'},
+      {"follow", no_argument, nullptr, 'f'},
+      {"window", required_argument, nullptr, 'w'},
+      {"top", required_argument, nullptr, 'n'},
+      {"threshold", required_argument, nullptr, 't'},
+      {"shard", required_argument, nullptr, 'd'},
       {nullptr, 0, nullptr, 0},
   };
 
@@ -137,6 +272,55 @@ int main(int argc, char** argv) {
         verbose_output = true;
         break;
       }
+      case 'j': {
+        int jobs = atoi(optarg);
+        if (jobs == 0) {
+          jobs = thread::hardware_concurrency();
+        }
+        trace_processor.SetJobs(jobs);
+        coverage_processor.SetJobs(jobs);
+        break;
+      }
+      case 's': {
+        start_time = strtoll(optarg, nullptr, 10);
+        break;
+      }
+      case 'e': {
+        end_time = strtoll(optarg, nullptr, 10);
+        break;
+      }
+      case 'f': {
+        follow = true;
+        break;
+      }
+      case 'w': {
+        window_seconds = atoi(optarg);
+        if (window_seconds <= 0) {
+          printf("Invalid window: %s\n", optarg);
+          return -1;
+        }
+        break;
+      }
+      case 'n': {
+        top_count = atoi(optarg);
+        if (top_count < 0) {
+          printf("Invalid top: %s\n", optarg);
+          return -1;
+        }
+        break;
+      }
+      case 't': {
+        threshold_ns = strtoll(optarg, nullptr, 10);
+        break;
+      }
+      case 'd': {
+        if (sscanf(optarg, "%d/%d", &shard_index, &shard_count) != 2 ||
+            shard_count < 1 || shard_index < 0 || shard_index >= shard_count) {
+          printf("Invalid shard: %s\n", optarg);
+          return -1;
+        }
+        break;
+      }
       default:
         printf("getopt_long returned unexpected value: %d\n", opt);
         return -1;
@@ -152,23 +336,64 @@ int main(int argc, char** argv) {
       case mode_code::CONVERT_TRACE:
         trace_processor.ConvertTrace(trace_path);
         break;
+      case mode_code::CONVERT_TRACE_TO_COMPACT:
+        trace_processor.ConvertTraceFormat(
+            trace_path, android::vts::VtsTraceProcessor::COMPACT);
+        break;
+      case mode_code::CONVERT_TRACE_TO_DELIMITED:
+        trace_processor.ConvertTraceFormat(
+            trace_path, android::vts::VtsTraceProcessor::DELIMITED);
+        break;
+      case mode_code::COUNT_TRACE:
+        trace_processor.CountTraceRecords(trace_path, start_time, end_time);
+        break;
       case mode_code::DEDUPE_TRACE:
         trace_processor.DedupTraces(trace_path);
         break;
+      case mode_code::EXPAND_TRACE:
+        trace_processor.ExpandTrace(trace_path);
+        break;
+      case mode_code::EXPORT_TRACE:
+        trace_processor.ExportTrace(trace_path, output);
+        break;
+      case mode_code::FUZZ_SEEDS_FROM_TRACE:
+        trace_processor.ConvertTraceToFuzzSeeds(trace_path, output);
+        break;
       case mode_code::GET_TEST_LIST_FROM_TRACE:
         trace_processor.GetTestListForHal(trace_path, output, verbose_output);
         break;
+      case mode_code::INDEX_TRACE:
+        trace_processor.IndexTrace(trace_path);
+        break;
       case mode_code::PARSE_TRACE:
-        trace_processor.ParseTrace(trace_path);
+        trace_processor.ParseTrace(trace_path, start_time, end_time);
         break;
       case mode_code::PROFILING_TRACE:
-        trace_processor.ProcessTraceForLatencyProfiling(trace_path);
+        if (follow) {
+          trace_processor.FollowTrace(trace_path, window_seconds);
+        } else {
+          trace_processor.ProcessTraceForLatencyProfiling(trace_path,
+                                                          verbose_output);
+        }
+        break;
+      case mode_code::SLOW_CALLS:
+        trace_processor.FindSlowCalls(trace_path, top_count, threshold_ns);
+        break;
+      case mode_code::CONVERT_COVERAGE_TO_BINARY:
+        coverage_processor.ConvertCoverage(trace_path, output, true);
+        break;
+      case mode_code::CONVERT_COVERAGE_TO_TEXT:
+        coverage_processor.ConvertCoverage(trace_path, output, false);
         break;
       case mode_code::GET_COVERGAGE_SUMMARY:
         coverage_processor.GetCoverageSummary(trace_path);
         break;
+      case mode_code::CONCAT_COVERAGE:
+        coverage_processor.ConcatCoverage(trace_path, output);
+        break;
       case mode_code::MERGE_COVERAGE:
-        coverage_processor.MergeCoverage(trace_path, output);
+        coverage_processor.MergeCoverageShard(trace_path, output, shard_index,
+                                              shard_count);
         break;
       default:
         printf("Invalid argument.");
@@ -176,12 +401,39 @@ int main(int argc, char** argv) {
     }
   } else if (optind == argc - 2) {
     switch (getModeCode(mode)) {
+      case mode_code::CALLBACK_LATENCY: {
+        string trace_path = argv[optind];
+        string rules_file = argv[optind + 1];
+        trace_processor.ProfileCallbackLatency(trace_path, rules_file,
+                                               verbose_output);
+        break;
+      }
+      case mode_code::COMPARE_LATENCY: {
+        string base_trace_dir = argv[optind];
+        string new_trace_dir = argv[optind + 1];
+        trace_processor.CompareLatency(base_trace_dir, new_trace_dir, output);
+        break;
+      }
+      case mode_code::CORRELATE_TRACE: {
+        string client_trace = argv[optind];
+        string server_trace = argv[optind + 1];
+        trace_processor.CorrelateTraces(client_trace, server_trace,
+                                        verbose_output);
+        break;
+      }
       case mode_code::SELECT_TRACE: {
         string coverage_dir = argv[optind];
         string trace_dir = argv[optind + 1];
         trace_processor.SelectTraces(coverage_dir, trace_dir);
         break;
       }
+      case mode_code::SELECT_CORPUS: {
+        string coverage_dir = argv[optind];
+        string corpus_dir = argv[optind + 1];
+        string output_dir = output == kDefaultOutputFile ? "" : output;
+        trace_processor.SelectCorpus(coverage_dir, corpus_dir, output_dir);
+        break;
+      }
       case mode_code::COMPARE_COVERAGE: {
         string ref_coverage_path = argv[optind];
         string coverage_path = argv[optind + 1];
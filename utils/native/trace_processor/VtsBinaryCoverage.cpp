@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsBinaryCoverage.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+using namespace std;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace android {
+namespace vts {
+
+static void appendVarint64(uint64_t value, string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+static void appendMessage(const google::protobuf::MessageLite& message,
+                          string* out) {
+  appendVarint64(message.ByteSizeLong(), out);
+  message.AppendToString(out);
+}
+
+static bool readMessage(CodedInputStream* input,
+                        google::protobuf::MessageLite* message) {
+  uint32_t size;
+  if (!input->ReadVarint32(&size)) {
+    return false;
+  }
+  CodedInputStream::Limit limit = input->PushLimit(size);
+  bool success =
+      message->MergeFromCodedStream(input) && input->ConsumedEntireMessage();
+  input->PopLimit(limit);
+  return success;
+}
+
+bool isBinaryCoverage(const void* data, size_t size) {
+  return size >= kBinaryCoverageMagicSize &&
+         memcmp(data, kBinaryCoverageMagic, kBinaryCoverageMagicSize) == 0;
+}
+
+void encodeBinaryCoverage(const TestReportMessage& report, string* out) {
+  out->append(kBinaryCoverageMagic, kBinaryCoverageMagicSize);
+  TestReportMessage report_without_coverage = report;
+  report_without_coverage.clear_coverage();
+  appendMessage(report_without_coverage, out);
+  appendVarint64(report.coverage_size(), out);
+
+  CoverageReportMessage coverage_without_lines;
+  for (const auto& coverage : report.coverage()) {
+    coverage_without_lines = coverage;
+    coverage_without_lines.clear_line_coverage_vector();
+    appendMessage(coverage_without_lines, out);
+    const int64_t* counts = coverage.line_coverage_vector().data();
+    size_t line_count = coverage.line_coverage_vector_size();
+    appendVarint64(line_count, out);
+    size_t bitmap_size = (line_count + 7) / 8;
+    size_t offset = out->size();
+    out->resize(offset + 2 * bitmap_size, 0);
+    char* instrumented_lines = &(*out)[offset];
+    char* covered_lines = instrumented_lines + bitmap_size;
+    for (size_t line = 0; line < line_count; line++) {
+      instrumented_lines[line / 8] |= (counts[line] >= 0) << (line % 8);
+      covered_lines[line / 8] |= (counts[line] > 0) << (line % 8);
+    }
+    for (size_t line = 0; line < line_count; line++) {
+      if (counts[line] > 0) {
+        appendVarint64(counts[line], out);
+      }
+    }
+    for (size_t line = 0; line < line_count; line++) {
+      if (counts[line] < 0) {
+        appendVarint64(WireFormatLite::ZigZagEncode64(counts[line]), out);
+      }
+    }
+  }
+}
+
+bool decodeBinaryCoverage(const void* data, size_t size,
+                          TestReportMessage* report) {
+  if (!isBinaryCoverage(data, size) || size > INT_MAX) {
+    return false;
+  }
+  CodedInputStream input(static_cast<const uint8_t*>(data), size);
+  input.PushLimit(size);
+  input.Skip(kBinaryCoverageMagicSize);
+  uint32_t coverage_count;
+  if (!readMessage(&input, report) || !input.ReadVarint32(&coverage_count)) {
+    return false;
+  }
+  report->mutable_coverage()->Reserve(coverage_count);
+  string bitmaps;
+  for (uint32_t i = 0; i < coverage_count; i++) {
+    CoverageReportMessage* coverage = report->add_coverage();
+    uint32_t line_count;
+    if (!readMessage(&input, coverage) || !input.ReadVarint32(&line_count)) {
+      return false;
+    }
+    size_t bitmap_size = (static_cast<size_t>(line_count) + 7) / 8;
+    if (2 * bitmap_size > static_cast<size_t>(input.BytesUntilLimit()) ||
+        !input.ReadString(&bitmaps, 2 * bitmap_size)) {
+      return false;
+    }
+    const char* instrumented_lines = bitmaps.data();
+    const char* covered_lines = instrumented_lines + bitmap_size;
+    google::protobuf::RepeatedField<int64_t>* counts =
+        coverage->mutable_line_coverage_vector();
+    counts->Resize(line_count, 0);
+    int64_t* count_data = counts->mutable_data();
+    uint64_t value;
+    for (uint32_t line = 0; line < line_count; line++) {
+      if ((covered_lines[line / 8] >> (line % 8)) & 1) {
+        if (!input.ReadVarint64(&value)) {
+          return false;
+        }
+        count_data[line] = value;
+      }
+    }
+    for (uint32_t line = 0; line < line_count; line++) {
+      if (!((instrumented_lines[line / 8] >> (line % 8)) & 1)) {
+        if (!input.ReadVarint64(&value)) {
+          return false;
+        }
+        count_data[line] = WireFormatLite::ZigZagDecode64(value);
+      }
+    }
+  }
+  return input.BytesUntilLimit() == 0;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TOOLS_TRACE_PROCESSOR_VTSBINARYCOVERAGE_H_
+#define TOOLS_TRACE_PROCESSOR_VTSBINARYCOVERAGE_H_
+
+#include <stddef.h>
+#include <string>
+
+#include <test/vts/proto/VtsReportMessage.pb.h>
+
+// This file defines the binary coverage format, an alternative to the text
+// format TestReportMessage for coverage reports that is much faster to parse.
+//
+// A binary coverage file starts with the 8 bytes kBinaryCoverageMagic,
+// followed by:
+//   varint size, the serialized TestReportMessage without its coverage,
+//   varint number of coverages, then for each coverage:
+//     varint size, the serialized CoverageReportMessage (file path, project,
+//     line counts...) without its line_coverage_vector,
+//     varint number of lines,
+//     bitmap of the instrumented lines (count >= 0), one bit per line,
+//     bitmap of the covered lines (count > 0), one bit per line,
+//     varint count of each covered line,
+//     zigzag varint count of each line that is not instrumented.
+// Bitmaps are in little endian bit order and padded to whole bytes. The
+// conversion from and to TestReportMessage is lossless.
+namespace android {
+namespace vts {
+
+static constexpr char kBinaryCoverageMagic[] = "VTSCOV01";
+static constexpr size_t kBinaryCoverageMagicSize =
+    sizeof(kBinaryCoverageMagic) - 1;
+
+// Returns whether the data of the given size is a binary coverage report.
+bool isBinaryCoverage(const void* data, size_t size);
+
+// Appends report in the binary coverage format to out.
+void encodeBinaryCoverage(const TestReportMessage& report, std::string* out);
+
+// Decodes the binary coverage report of the given size into report. Returns
+// false if it is not a valid binary coverage report.
+bool decodeBinaryCoverage(const void* data, size_t size,
+                          TestReportMessage* report);
+
+}  // namespace vts
+}  // namespace android
+#endif  // TOOLS_TRACE_PROCESSOR_VTSBINARYCOVERAGE_H_
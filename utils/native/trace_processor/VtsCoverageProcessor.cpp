@@ -17,15 +17,26 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
 #include <test/vts/proto/VtsReportMessage.pb.h>
 
+#include "VtsBinaryCoverage.h"
+#include "VtsCoverageVector.h"
+
 using namespace std;
 using google::protobuf::TextFormat;
 
@@ -34,30 +45,70 @@ namespace vts {
 
 void VtsCoverageProcessor::ParseCoverageData(const string& coverage_file,
                                              TestReportMessage* report_msg) {
-  ifstream in(coverage_file, std::ios::in);
-  string msg_str((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
-  if (!TextFormat::MergeFromString(msg_str, report_msg)) {
-    cerr << "Can't parse a given coverage report: " << msg_str << endl;
+  // Both formats are parsed from the mapped file, without copying it.
+  const char* data = "";
+  size_t size = 0;
+  int fd = open(coverage_file.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* region = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (region != MAP_FAILED) {
+      data = static_cast<const char*>(region);
+      size = st.st_size;
+    }
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  bool success;
+  if (isBinaryCoverage(data, size)) {
+    success = decodeBinaryCoverage(data, size, report_msg);
+  } else {
+    google::protobuf::io::ArrayInputStream input(data, size);
+    success = TextFormat::Merge(&input, report_msg);
+  }
+  if (!success) {
+    cerr << "Can't parse a given coverage report: " << coverage_file << endl;
     exit(-1);
   }
+  if (size > 0) {
+    munmap(const_cast<char*>(data), size);
+  }
+}
+
+void VtsCoverageProcessor::ConvertCoverage(const string& coverage_file,
+                                           const string& output_file,
+                                           bool binary) {
+  TestReportMessage coverage_report;
+  ParseCoverageData(coverage_file, &coverage_report);
+  string data;
+  if (binary) {
+    encodeBinaryCoverage(coverage_report, &data);
+  } else {
+    data = coverage_report.DebugString();
+  }
+  ofstream fout(output_file, ios::out | ios::binary);
+  fout << data;
+  fout.close();
+  if (!fout) {
+    cerr << __func__ << ": Failed to write " << output_file << endl;
+  }
 }
 
 void VtsCoverageProcessor::UpdateCoverageData(
     const CoverageReportMessage& ref_msg,
     CoverageReportMessage* msg_to_be_updated) {
   if (ref_msg.file_path() == msg_to_be_updated->file_path()) {
-    for (int line = 0; line < ref_msg.line_coverage_vector_size(); line++) {
-      if (line < msg_to_be_updated->line_coverage_vector_size()) {
-        if (ref_msg.line_coverage_vector(line) > 0 &&
-            msg_to_be_updated->line_coverage_vector(line) > 0) {
-          msg_to_be_updated->set_line_coverage_vector(line, 0);
-          msg_to_be_updated->set_covered_line_count(
-              msg_to_be_updated->covered_line_count() - 1);
-        }
-      } else {
-        cout << "Reached the end of line_coverage_vector." << endl;
-        break;
-      }
+    int size = min(ref_msg.line_coverage_vector_size(),
+                   msg_to_be_updated->line_coverage_vector_size());
+    long cleared_lines = subtractLineCounts(
+        ref_msg.line_coverage_vector().data(),
+        msg_to_be_updated->mutable_line_coverage_vector()->mutable_data(),
+        size);
+    msg_to_be_updated->set_covered_line_count(
+        msg_to_be_updated->covered_line_count() - cleared_lines);
+    if (size < ref_msg.line_coverage_vector_size()) {
+      cout << "Reached the end of line_coverage_vector." << endl;
     }
     // Validate
     if (msg_to_be_updated->covered_line_count() < 0) {
@@ -68,42 +119,105 @@ void VtsCoverageProcessor::UpdateCoverageData(
   }
 }
 
-void VtsCoverageProcessor::MergeCoverage(const string& coverage_file_dir,
-                                         const string& merged_coverage_file) {
-  DIR* coverage_dir = opendir(coverage_file_dir.c_str());
+// Lists the regular files under dir into files, sorted by name.
+// Returns false if dir can't be opened.
+static bool listCoverageFiles(const string& dir, vector<string>* files) {
+  DIR* coverage_dir = opendir(dir.c_str());
   if (coverage_dir == 0) {
-    cerr << __func__ << ": " << coverage_file_dir << " does not exist." << endl;
-    return;
+    return false;
   }
-  TestReportMessage merged_coverage_report;
-
   struct dirent* file;
   while ((file = readdir(coverage_dir)) != NULL) {
     if (file->d_type == DT_REG) {
-      string coverage_file = coverage_file_dir;
-      if (coverage_file_dir.substr(coverage_file_dir.size() - 1) != "/") {
+      string coverage_file = dir;
+      if (dir.substr(dir.size() - 1) != "/") {
         coverage_file += "/";
       }
-      string coverage_file_base_name = file->d_name;
-      coverage_file += coverage_file_base_name;
-      TestReportMessage coverage_report;
-      ParseCoverageData(coverage_file, &coverage_report);
+      files->push_back(coverage_file + file->d_name);
+    }
+  }
+  closedir(coverage_dir);
+  sort(files->begin(), files->end());
+  return true;
+}
+
+// Returns the shard of shard_count that the coverage of the source file at
+// file_path is merged in. The FNV-1a hash of the path is used so that all
+// the machines merging the shards agree on it.
+static int getCoverageShard(const string& file_path, int shard_count) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (char c : file_path) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  return hash % shard_count;
+}
+
+void VtsCoverageProcessor::MergeCoverage(const string& coverage_file_dir,
+                                         const string& merged_coverage_file) {
+  MergeCoverageShard(coverage_file_dir, merged_coverage_file, 0, 1);
+}
+
+void VtsCoverageProcessor::MergeCoverageShard(
+    const string& coverage_file_dir, const string& merged_coverage_file,
+    int shard_index, int shard_count) {
+  if (shard_count < 1 || shard_index < 0 || shard_index >= shard_count) {
+    cerr << __func__ << ": invalid shard " << shard_index << " of "
+         << shard_count << endl;
+    return;
+  }
+  vector<string> coverage_files;
+  if (!listCoverageFiles(coverage_file_dir, &coverage_files)) {
+    cerr << __func__ << ": " << coverage_file_dir << " does not exist." << endl;
+    return;
+  }
 
-      for (const auto& cov : coverage_report.coverage()) {
-        bool seen_cov = false;
-        for (int i = 0; i < merged_coverage_report.coverage_size(); i++) {
-          if (merged_coverage_report.coverage(i).file_path() ==
-              cov.file_path()) {
-            MergeCoverageMsg(cov, merged_coverage_report.mutable_coverage(i));
-            seen_cov = true;
-            break;
-          }
-        }
-        if (!seen_cov) {
-          *merged_coverage_report.add_coverage() = cov;
-        }
+  // Each thread merges a contiguous range of the files, the ranges are then
+  // merged in order, so that the result is the same as merging the files one
+  // by one.
+  size_t range_count =
+      max<size_t>(1, min<size_t>(jobs_, coverage_files.size()));
+  vector<PartialCoverage> partial_coverages(range_count);
+  vector<thread> threads;
+  for (size_t i = 0; i < range_count; i++) {
+    threads.emplace_back([&, i]() {
+      MergeCoverageRange(coverage_files,
+                         coverage_files.size() * i / range_count,
+                         coverage_files.size() * (i + 1) / range_count,
+                         shard_index, shard_count, &partial_coverages[i]);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  TestReportMessage merged_coverage_report;
+  unordered_map<string, int> merged_indexes;
+  for (auto& partial_coverage : partial_coverages) {
+    for (auto& partial_file_coverage : partial_coverage.files) {
+      CoverageReportMessage& first_coverage =
+          partial_file_coverage.first_coverage;
+      auto inserted = merged_indexes.emplace(
+          first_coverage.file_path(), merged_coverage_report.coverage_size());
+      CoverageReportMessage* merged_coverage;
+      if (inserted.second) {
+        merged_coverage = merged_coverage_report.add_coverage();
+        merged_coverage->Swap(&first_coverage);
+      } else {
+        merged_coverage =
+            merged_coverage_report.mutable_coverage(inserted.first->second);
+        MergeCoverageMsg(first_coverage, merged_coverage);
       }
+      const vector<int64_t>& added_line_counts =
+          partial_file_coverage.added_line_counts;
+      // The sizes are checked when merging the first coverages.
+      long newly_covered_lines = mergeLineCounts(
+          added_line_counts.data(),
+          merged_coverage->mutable_line_coverage_vector()->mutable_data(),
+          added_line_counts.size());
+      merged_coverage->set_covered_line_count(
+          merged_coverage->covered_line_count() + newly_covered_lines);
     }
+    partial_coverage = PartialCoverage();
   }
 
   PrintCoverageSummary(merged_coverage_report);
@@ -113,6 +227,85 @@ void VtsCoverageProcessor::MergeCoverage(const string& coverage_file_dir,
   fout.close();
 }
 
+void VtsCoverageProcessor::MergeCoverageRange(
+    const vector<string>& coverage_files, size_t begin, size_t end,
+    int shard_index, int shard_count, PartialCoverage* partial_coverage) {
+  for (size_t i = begin; i < end; i++) {
+    TestReportMessage coverage_report;
+    ParseCoverageData(coverage_files[i], &coverage_report);
+    for (auto& cov : *coverage_report.mutable_coverage()) {
+      if (shard_count > 1 &&
+          getCoverageShard(cov.file_path(), shard_count) != shard_index) {
+        continue;
+      }
+      auto inserted = partial_coverage->file_indexes.emplace(
+          cov.file_path(), partial_coverage->files.size());
+      if (inserted.second) {
+        partial_coverage->files.emplace_back();
+        partial_coverage->files.back().first_coverage.Swap(&cov);
+        continue;
+      }
+      PartialFileCoverage& partial_file_coverage =
+          partial_coverage->files[inserted.first->second];
+      int line_count = cov.line_coverage_vector_size();
+      if (line_count !=
+          partial_file_coverage.first_coverage.line_coverage_vector_size()) {
+        cerr << "Trying to merge coverage data with different lines."
+             << "ref_coverage_msg: " << cov.DebugString()
+             << "merged_coverage_msg: "
+             << partial_file_coverage.first_coverage.DebugString() << endl;
+        exit(-1);
+      }
+      vector<int64_t>& added_line_counts =
+          partial_file_coverage.added_line_counts;
+      added_line_counts.resize(line_count, 0);
+      mergeLineCounts(cov.line_coverage_vector().data(),
+                      added_line_counts.data(), line_count);
+    }
+  }
+}
+
+void VtsCoverageProcessor::ConcatCoverage(
+    const string& partial_coverage_dir, const string& merged_coverage_file) {
+  vector<string> partial_files;
+  if (!listCoverageFiles(partial_coverage_dir, &partial_files)) {
+    cerr << __func__ << ": " << partial_coverage_dir << " does not exist."
+         << endl;
+    return;
+  }
+  ofstream fout(merged_coverage_file, ios::out | ios::binary | ios::trunc);
+  // The text format merges the repeated fields of concatenated messages, so
+  // the reports are copied in chunks without being parsed.
+  vector<char> buffer(1 << 20);
+  for (const auto& partial_file : partial_files) {
+    ifstream fin(partial_file, ios::in | ios::binary);
+    bool first_chunk = true;
+    while (fin && fout) {
+      fin.read(buffer.data(), buffer.size());
+      if (fin.gcount() == 0) {
+        break;
+      }
+      if (first_chunk && isBinaryCoverage(buffer.data(), fin.gcount())) {
+        cerr << __func__ << ": " << partial_file
+             << " is a binary coverage report, only text format reports can "
+                "be concatenated."
+             << endl;
+        return;
+      }
+      first_chunk = false;
+      fout.write(buffer.data(), fin.gcount());
+    }
+    if (fin.bad()) {
+      cerr << __func__ << ": Failed to read " << partial_file << endl;
+      return;
+    }
+  }
+  fout.close();
+  if (!fout) {
+    cerr << __func__ << ": Failed to write " << merged_coverage_file << endl;
+  }
+}
+
 void VtsCoverageProcessor::MergeCoverageMsg(
     const CoverageReportMessage& ref_coverage_msg,
     CoverageReportMessage* merged_coverage_msg) {
@@ -129,22 +322,23 @@ void VtsCoverageProcessor::MergeCoverageMsg(
          << endl;
     exit(-1);
   }
-  for (int i = 0; i < ref_coverage_msg.line_coverage_vector_size(); i++) {
-    if (i > merged_coverage_msg->line_coverage_vector_size() - 1) {
-      cerr << "Reach the end of coverage vector" << endl;
-      break;
-    }
-    int ref_line_count = ref_coverage_msg.line_coverage_vector(i);
-    int merged_line_count = merged_coverage_msg->line_coverage_vector(i);
-    if (ref_line_count > 0) {
-      if (merged_line_count == 0) {
-        merged_coverage_msg->set_covered_line_count(
-            merged_coverage_msg->covered_line_count() + 1);
-      }
-      merged_coverage_msg->set_line_coverage_vector(
-          i, merged_line_count + ref_line_count);
-    }
+  long newly_covered_lines = mergeLineCounts(
+      ref_coverage_msg.line_coverage_vector().data(),
+      merged_coverage_msg->mutable_line_coverage_vector()->mutable_data(),
+      ref_coverage_msg.line_coverage_vector_size());
+  merged_coverage_msg->set_covered_line_count(
+      merged_coverage_msg->covered_line_count() + newly_covered_lines);
+}
+
+// Maps each file path of report to its first coverage.
+static unordered_map<string, const CoverageReportMessage*> indexCoverageByPath(
+    const TestReportMessage& report) {
+  unordered_map<string, const CoverageReportMessage*> index;
+  index.reserve(report.coverage_size());
+  for (const auto& coverage : report.coverage()) {
+    index.emplace(coverage.file_path(), &coverage);
   }
+  return index;
 }
 
 void VtsCoverageProcessor::CompareCoverage(const string& ref_msg_file,
@@ -153,39 +347,33 @@ void VtsCoverageProcessor::CompareCoverage(const string& ref_msg_file,
   TestReportMessage new_coverage_report;
   ParseCoverageData(ref_msg_file, &ref_coverage_report);
   ParseCoverageData(new_msg_file, &new_coverage_report);
+  auto ref_coverages = indexCoverageByPath(ref_coverage_report);
   map<string, vector<int>> new_coverage_map;
 
+  vector<int> new_lines;
   for (const auto& new_coverage : new_coverage_report.coverage()) {
-    bool seen_file = false;
-    for (const auto& ref_coverage : ref_coverage_report.coverage()) {
-      if (new_coverage.file_path() == ref_coverage.file_path()) {
-        int line = 0;
-        for (; line < new_coverage.line_coverage_vector_size(); line++) {
-          if (new_coverage.line_coverage_vector(line) > 0 &&
-              ref_coverage.line_coverage_vector(line) == 0) {
-            if (new_coverage_map.find(new_coverage.file_path()) !=
-                new_coverage_map.end()) {
-              new_coverage_map[new_coverage.file_path()].push_back(line);
-            } else {
-              new_coverage_map.insert(std::pair<string, vector<int>>(
-                  new_coverage.file_path(), vector<int>{line}));
-            }
-          }
-        }
-        seen_file = true;
-        break;
+    auto ref_coverage = ref_coverages.find(new_coverage.file_path());
+    if (ref_coverage == ref_coverages.end()) {
+      // A file missing from the reference is listed even if no line is
+      // covered, only once.
+      auto inserted =
+          new_coverage_map.emplace(new_coverage.file_path(), vector<int>());
+      if (inserted.second) {
+        findNewlyCoveredLines(new_coverage.line_coverage_vector().data(),
+                              new_coverage.line_coverage_vector_size(),
+                              nullptr, 0, &inserted.first->second);
       }
+      continue;
     }
-    if (!seen_file) {
-      vector<int> new_line;
-      for (int line = 0; line < new_coverage.line_coverage_vector_size();
-           line++) {
-        if (new_coverage.line_coverage_vector(line) > 0) {
-          new_line.push_back(line);
-        }
-      }
-      new_coverage_map.insert(
-          std::pair<string, vector<int>>(new_coverage.file_path(), new_line));
+    const CoverageReportMessage& ref = *ref_coverage->second;
+    new_lines.clear();
+    findNewlyCoveredLines(new_coverage.line_coverage_vector().data(),
+                          new_coverage.line_coverage_vector_size(),
+                          ref.line_coverage_vector().data(),
+                          ref.line_coverage_vector_size(), &new_lines);
+    if (!new_lines.empty()) {
+      vector<int>& lines = new_coverage_map[new_coverage.file_path()];
+      lines.insert(lines.end(), new_lines.begin(), new_lines.end());
     }
   }
   for (auto it = new_coverage_map.begin(); it != new_coverage_map.end(); it++) {
@@ -204,30 +392,25 @@ void VtsCoverageProcessor::GetSubsetCoverage(const string& ref_msg_file,
   TestReportMessage result_coverage_report;
   ParseCoverageData(ref_msg_file, &ref_coverage_report);
   ParseCoverageData(full_msg_file, &full_coverage_report);
+  auto full_coverages = indexCoverageByPath(full_coverage_report);
 
   for (const auto& ref_coverage : ref_coverage_report.coverage()) {
-    bool seen_file = false;
-    for (const auto& coverage : full_coverage_report.coverage()) {
-      if (coverage.file_path() == ref_coverage.file_path()) {
-        *result_coverage_report.add_coverage() = coverage;
-        seen_file = true;
-        break;
-      }
+    auto coverage = full_coverages.find(ref_coverage.file_path());
+    if (coverage != full_coverages.end()) {
+      *result_coverage_report.add_coverage() = *coverage->second;
+      continue;
     }
-    if (!seen_file) {
-      cout << ": missing coverage for file " << ref_coverage.file_path()
-           << endl;
-      CoverageReportMessage* empty_coverage =
-          result_coverage_report.add_coverage();
-      *empty_coverage = ref_coverage;
-      for (int line = 0; line < empty_coverage->line_coverage_vector_size();
-           line++) {
-        if (empty_coverage->line_coverage_vector(line) > 0) {
-          empty_coverage->set_line_coverage_vector(line, 0);
-        }
+    cout << ": missing coverage for file " << ref_coverage.file_path() << endl;
+    CoverageReportMessage* empty_coverage =
+        result_coverage_report.add_coverage();
+    *empty_coverage = ref_coverage;
+    for (int line = 0; line < empty_coverage->line_coverage_vector_size();
+         line++) {
+      if (empty_coverage->line_coverage_vector(line) > 0) {
+        empty_coverage->set_line_coverage_vector(line, 0);
       }
-      empty_coverage->set_covered_line_count(0);
     }
+    empty_coverage->set_covered_line_count(0);
   }
   PrintCoverageSummary(result_coverage_report);
   ofstream fout;
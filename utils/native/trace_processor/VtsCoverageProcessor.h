@@ -18,6 +18,11 @@
 #define TOOLS_TRACE_PROCESSOR_VTSCOVERAGEPROCESSOR_H_
 
 #include <android-base/macros.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <test/vts/proto/VtsReportMessage.pb.h>
 
 namespace android {
@@ -27,23 +32,54 @@ namespace vts {
 // two coverage reports.
 class VtsCoverageProcessor {
  public:
-  VtsCoverageProcessor(){};
+  VtsCoverageProcessor() : jobs_(1){};
   virtual ~VtsCoverageProcessor(){};
 
+  // Sets the number of threads the coverage files are parsed with by
+  // MergeCoverage and MergeCoverageShard. The results do not depend on it.
+  void SetJobs(int jobs) { jobs_ = jobs > 0 ? jobs : 1; }
+
   // Merge the coverage files under coverage_file_dir and output the merged
-  // coverage data to merged_coverage_file.
+  // coverage data to merged_coverage_file. The files are merged in the order
+  // of their names.
   void MergeCoverage(const std::string& coverage_file_dir,
                      const std::string& merged_coverage_file);
 
+  // Same as MergeCoverage, but only merges the coverage of the source files
+  // of shard shard_index of shard_count, the files being assigned to the
+  // shards by a stable hash of their path. The shards of the same coverage
+  // files can be merged by different processes or machines, each holding
+  // only its source files in memory, and the partial reports they write put
+  // together by ConcatCoverage.
+  void MergeCoverageShard(const std::string& coverage_file_dir,
+                          const std::string& merged_coverage_file,
+                          int shard_index, int shard_count);
+
+  // Concatenates the partial coverage reports under partial_coverage_dir,
+  // e.g. those written by MergeCoverageShard for all the shards, into
+  // merged_coverage_file, in the order of their names. The reports must be
+  // in text format and cover different source files, as they are copied
+  // without being parsed.
+  void ConcatCoverage(const std::string& partial_coverage_dir,
+                      const std::string& merged_coverage_file);
+
   // Compare coverage data contained in new_msg_file with ref_msg_file and
   // print the additional file/lines covered by the new_msg_file.
   void CompareCoverage(const std::string& ref_msg_file,
                        const std::string& new_msg_file);
 
-  // Parse the given coverage_file into a coverage report.
+  // Parse the given coverage_file into a coverage report. The file is either
+  // a text format TestReportMessage or a binary coverage report (see
+  // VtsBinaryCoverage.h), as are the coverage files read by all the methods.
   void ParseCoverageData(const std::string& coverage_file,
                          TestReportMessage* coverage_report);
 
+  // Converts the given coverage file into a binary coverage report if binary
+  // is set, or into a text format TestReportMessage otherwise, and stores it
+  // in output_file.
+  void ConvertCoverage(const std::string& coverage_file,
+                       const std::string& output_file, bool binary);
+
   // Updates msg_to_be_updated by removing all the covered lines in ref_msg
   // and recalculates the count of covered lines accordingly.
   void UpdateCoverageData(const CoverageReportMessage& ref_msg,
@@ -64,6 +100,29 @@ class VtsCoverageProcessor {
   long GetTotalCodeLine(const TestReportMessage& msg) const;
 
  private:
+  // Coverage of a source file merged from a range of coverage files.
+  struct PartialFileCoverage {
+    // The first coverage of the file in the range.
+    CoverageReportMessage first_coverage;
+    // Sum of the positive line counts of the other coverages of the file in
+    // the range. Empty if there are none.
+    std::vector<int64_t> added_line_counts;
+  };
+
+  // Coverage merged from a range of coverage files.
+  struct PartialCoverage {
+    // Index of the coverage of each file path in files.
+    std::unordered_map<std::string, size_t> file_indexes;
+    // In the order the files are first seen.
+    std::vector<PartialFileCoverage> files;
+  };
+
+  // Parses the coverage files [begin, end) of coverage_files and merges the
+  // coverage of the source files of the given shard into partial_coverage.
+  void MergeCoverageRange(const std::vector<std::string>& coverage_files,
+                          size_t begin, size_t end, int shard_index,
+                          int shard_count, PartialCoverage* partial_coverage);
+
   // Internal method to merge the ref_coverage_msg into merged_covergae_msg.
   void MergeCoverageMsg(const CoverageReportMessage& ref_coverage_msg,
                         CoverageReportMessage* merged_covergae_msg);
@@ -71,6 +130,9 @@ class VtsCoverageProcessor {
   // Help method to print the coverage summary.
   void PrintCoverageSummary(const TestReportMessage& coverage_report);
 
+  // Number of threads MergeCoverage parses the coverage files with.
+  int jobs_;
+
   DISALLOW_COPY_AND_ASSIGN(VtsCoverageProcessor);
 };
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "VtsCoverageVector.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+long mergeLineCounts(const int64_t* counts, int64_t* merged_counts,
+                     size_t size) {
+  long newly_covered_lines = 0;
+  for (size_t i = 0; i < size; i++) {
+    int64_t count = counts[i];
+    int64_t merged_count = merged_counts[i];
+    bool covered = count > 0;
+    newly_covered_lines += covered & (merged_count == 0);
+    merged_counts[i] = merged_count + (covered ? count : 0);
+  }
+  return newly_covered_lines;
+}
+
+long subtractLineCounts(const int64_t* ref_counts, int64_t* counts,
+                        size_t size) {
+  long cleared_lines = 0;
+  for (size_t i = 0; i < size; i++) {
+    int64_t count = counts[i];
+    bool cleared = (ref_counts[i] > 0) & (count > 0);
+    cleared_lines += cleared;
+    counts[i] = cleared ? 0 : count;
+  }
+  return cleared_lines;
+}
+
+void findNewlyCoveredLines(const int64_t* counts, size_t size,
+                           const int64_t* ref_counts, size_t ref_size,
+                           vector<int>* lines) {
+  size_t common_size = min(size, ref_size);
+  for (size_t i = 0; i < common_size; i++) {
+    if (counts[i] > 0 && ref_counts[i] == 0) {
+      lines->push_back(i);
+    }
+  }
+  for (size_t i = common_size; i < size; i++) {
+    if (counts[i] > 0) {
+      lines->push_back(i);
+    }
+  }
+}
+
+void lineCountsToBitset(const int64_t* counts, size_t size,
+                        vector<uint64_t>* bits) {
+  bits->assign((size + 63) / 64, 0);
+  for (size_t word = 0; word < bits->size(); word++) {
+    size_t begin = word * 64;
+    size_t end = min(size, begin + 64);
+    uint64_t value = 0;
+    for (size_t i = begin; i < end; i++) {
+      value |= static_cast<uint64_t>(counts[i] > 0) << (i - begin);
+    }
+    (*bits)[word] = value;
+  }
+}
+
+void edgeCountersToBitset(const uint8_t* counters, size_t size,
+                          vector<uint64_t>* bits) {
+  bits->assign((size + 63) / 64, 0);
+  for (size_t word = 0; word < bits->size(); word++) {
+    size_t begin = word * 64;
+    size_t end = min(size, begin + 64);
+    uint64_t value = 0;
+    for (size_t i = begin; i < end; i++) {
+      value |= static_cast<uint64_t>(counters[i] != 0) << (i - begin);
+    }
+    (*bits)[word] = value;
+  }
+}
+
+void mergeBitsets(const uint64_t* bits, uint64_t* merged_bits, size_t words) {
+  for (size_t i = 0; i < words; i++) {
+    merged_bits[i] |= bits[i];
+  }
+}
+
+long countCommonLines(const uint64_t* bits, const uint64_t* mask,
+                      size_t words) {
+  long count = 0;
+  for (size_t i = 0; i < words; i++) {
+    count += __builtin_popcountll(bits[i] & mask[i]);
+  }
+  return count;
+}
+
+}  // namespace vts
+}  // namespace android
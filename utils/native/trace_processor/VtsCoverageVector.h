@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TOOLS_TRACE_PROCESSOR_VTSCOVERAGEVECTOR_H_
+#define TOOLS_TRACE_PROCESSOR_VTSCOVERAGEVECTOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// This file defines the operations on line coverage vectors, i.e. the number
+// of times each line is executed as in CoverageReportMessage (negative for
+// the lines that are not instrumented), and on covered line bitsets, with one
+// bit per line set if the line is executed, 64 lines per word. They work on
+// contiguous arrays, e.g. the data of a line_coverage_vector, and are written
+// as branch-free loops the compiler can vectorize.
+namespace android {
+namespace vts {
+
+// Adds the positive counts to merged_counts, both of the given size. Returns
+// the number of lines newly covered, i.e. the lines with a positive count
+// whose merged count was 0.
+long mergeLineCounts(const int64_t* counts, int64_t* merged_counts,
+                     size_t size);
+
+// Sets to 0 the counts of the lines covered in both ref_counts and counts,
+// both of the given size. Returns the number of lines cleared.
+long subtractLineCounts(const int64_t* ref_counts, int64_t* counts,
+                        size_t size);
+
+// Appends to lines the lines covered in counts but not in ref_counts. The
+// lines past ref_size are not covered in ref_counts.
+void findNewlyCoveredLines(const int64_t* counts, size_t size,
+                           const int64_t* ref_counts, size_t ref_size,
+                           std::vector<int>* lines);
+
+// Sets bits to the covered line bitset of counts.
+void lineCountsToBitset(const int64_t* counts, size_t size,
+                        std::vector<uint64_t>* bits);
+
+// Sets bits to the covered edge bitset of the 8-bit edge counters of a fuzz
+// input, e.g. as in SharedEdgeCounters, with one bit per edge set if its
+// counter is not 0.
+void edgeCountersToBitset(const uint8_t* counters, size_t size,
+                          std::vector<uint64_t>* bits);
+
+// ORs bits into merged_bits, both of the given number of words.
+void mergeBitsets(const uint64_t* bits, uint64_t* merged_bits, size_t words);
+
+// Returns the number of lines set in both bits and mask, both of the given
+// number of words.
+long countCommonLines(const uint64_t* bits, const uint64_t* mask,
+                      size_t words);
+
+}  // namespace vts
+}  // namespace android
+#endif  // TOOLS_TRACE_PROCESSOR_VTSCOVERAGEVECTOR_H_
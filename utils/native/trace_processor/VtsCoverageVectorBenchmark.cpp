@@ -0,0 +1,165 @@
+//
+// Copyright 2020 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "VtsCoverageVector.h"
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "test/vts/proto/VtsReportMessage.pb.h"
+
+using namespace std;
+
+// Compares the line coverage vector kernels with the loops over the protobuf
+// accessors they replace, on coverage messages of state.range(0) lines.
+//
+// Usage: vts_coverage_vector_benchmark [--benchmark_filter=<regex>]
+
+namespace android {
+namespace vts {
+
+// Returns a coverage message of the given number of lines, of which about a
+// tenth are not instrumented and half of the others are covered.
+static CoverageReportMessage MakeCoverageMsg(int lines, unsigned seed) {
+  mt19937 random(seed);
+  CoverageReportMessage msg;
+  for (int i = 0; i < lines; i++) {
+    unsigned value = random() % 20;
+    msg.add_line_coverage_vector(value < 2 ? -1 : value < 11 ? 0 : value);
+  }
+  return msg;
+}
+
+// Merges as MergeCoverageMsg did, one line at a time through the accessors.
+static void BM_MergeAccessors(benchmark::State& state) {
+  CoverageReportMessage ref_msg = MakeCoverageMsg(state.range(0), 1);
+  CoverageReportMessage merged_msg = MakeCoverageMsg(state.range(0), 2);
+  for (auto _ : state) {
+    for (int i = 0; i < ref_msg.line_coverage_vector_size(); i++) {
+      int64_t ref_line_count = ref_msg.line_coverage_vector(i);
+      int64_t merged_line_count = merged_msg.line_coverage_vector(i);
+      if (ref_line_count > 0) {
+        if (merged_line_count == 0) {
+          merged_msg.set_covered_line_count(merged_msg.covered_line_count() +
+                                            1);
+        }
+        merged_msg.set_line_coverage_vector(
+            i, merged_line_count + ref_line_count);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MergeAccessors)->Range(1 << 10, 1 << 20);
+
+static void BM_MergeLineCounts(benchmark::State& state) {
+  CoverageReportMessage ref_msg = MakeCoverageMsg(state.range(0), 1);
+  CoverageReportMessage merged_msg = MakeCoverageMsg(state.range(0), 2);
+  for (auto _ : state) {
+    long newly_covered = mergeLineCounts(
+        ref_msg.line_coverage_vector().data(),
+        merged_msg.mutable_line_coverage_vector()->mutable_data(),
+        ref_msg.line_coverage_vector_size());
+    merged_msg.set_covered_line_count(merged_msg.covered_line_count() +
+                                      newly_covered);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MergeLineCounts)->Range(1 << 10, 1 << 20);
+
+// Subtracts as UpdateCoverageData did, one line at a time through the
+// accessors. The counts are restored between iterations.
+static void BM_SubtractAccessors(benchmark::State& state) {
+  CoverageReportMessage ref_msg = MakeCoverageMsg(state.range(0), 1);
+  CoverageReportMessage original_msg = MakeCoverageMsg(state.range(0), 2);
+  CoverageReportMessage msg;
+  for (auto _ : state) {
+    state.PauseTiming();
+    msg = original_msg;
+    state.ResumeTiming();
+    for (int i = 0; i < ref_msg.line_coverage_vector_size(); i++) {
+      if (ref_msg.line_coverage_vector(i) > 0 &&
+          msg.line_coverage_vector(i) > 0) {
+        msg.set_line_coverage_vector(i, 0);
+        msg.set_covered_line_count(msg.covered_line_count() - 1);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SubtractAccessors)->Range(1 << 10, 1 << 20);
+
+static void BM_SubtractLineCounts(benchmark::State& state) {
+  CoverageReportMessage ref_msg = MakeCoverageMsg(state.range(0), 1);
+  CoverageReportMessage original_msg = MakeCoverageMsg(state.range(0), 2);
+  CoverageReportMessage msg;
+  for (auto _ : state) {
+    state.PauseTiming();
+    msg = original_msg;
+    state.ResumeTiming();
+    long cleared = subtractLineCounts(
+        ref_msg.line_coverage_vector().data(),
+        msg.mutable_line_coverage_vector()->mutable_data(),
+        ref_msg.line_coverage_vector_size());
+    msg.set_covered_line_count(msg.covered_line_count() - cleared);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SubtractLineCounts)->Range(1 << 10, 1 << 20);
+
+// Counts the lines covered by both messages through the accessors, as the
+// trace selection did for each candidate.
+static void BM_CountCommonAccessors(benchmark::State& state) {
+  CoverageReportMessage msg = MakeCoverageMsg(state.range(0), 1);
+  CoverageReportMessage mask_msg = MakeCoverageMsg(state.range(0), 2);
+  for (auto _ : state) {
+    long common = 0;
+    for (int i = 0; i < msg.line_coverage_vector_size(); i++) {
+      if (msg.line_coverage_vector(i) > 0 &&
+          mask_msg.line_coverage_vector(i) > 0) {
+        common++;
+      }
+    }
+    benchmark::DoNotOptimize(common);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CountCommonAccessors)->Range(1 << 10, 1 << 20);
+
+// Counts the same lines on the bitsets, which are built once per message.
+static void BM_CountCommonLines(benchmark::State& state) {
+  CoverageReportMessage msg = MakeCoverageMsg(state.range(0), 1);
+  CoverageReportMessage mask_msg = MakeCoverageMsg(state.range(0), 2);
+  vector<uint64_t> bits;
+  vector<uint64_t> mask;
+  lineCountsToBitset(msg.line_coverage_vector().data(),
+                     msg.line_coverage_vector_size(), &bits);
+  lineCountsToBitset(mask_msg.line_coverage_vector().data(),
+                     mask_msg.line_coverage_vector_size(), &mask);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        countCommonLines(bits.data(), mask.data(), bits.size()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CountCommonLines)->Range(1 << 10, 1 << 20);
+
+}  // namespace vts
+}  // namespace android
+
+BENCHMARK_MAIN();
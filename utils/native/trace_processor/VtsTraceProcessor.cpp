@@ -17,33 +17,134 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <test/vts/proto/ComponentSpecificationMessage.pb.h>
 #include <test/vts/proto/VtsReportMessage.pb.h>
 
+#include "VtsCompactTrace.h"
+#include "VtsCoverageVector.h"
 #include "VtsProfilingUtil.h"
+#include "VtsTraceCompression.h"
+#include "VtsTraceReader.h"
 
 using namespace std;
 using google::protobuf::TextFormat;
 
+// The size of the chunks a text trace is read by, each parsed as a batch.
+static constexpr size_t kTextTraceChunkSize = 4 << 20;
+// The minimum relative shift of the median latency of an API, and the
+// maximum p-value of the shift, for CompareLatency to report a regression.
+static constexpr double kMinRegressionMedianShift = 0.05;
+static constexpr double kMaxRegressionPValue = 0.01;
+// The interval between two reads of a followed trace, and the size the new
+// data is read by.
+static constexpr int kFollowIntervalMs = 1000;
+static constexpr size_t kFollowReadSize = 1 << 20;
+// The minimum number of records of a chunk of a trace decoded by a job, and
+// the number of chunks per job, so that the jobs end at about the same time
+// even if some chunks take longer to decode.
+static constexpr size_t kMinTraceChunkRecords = 4096;
+static constexpr size_t kTraceChunksPerJob = 4;
+// The multiplier of the polynomial hash of the records of a trace.
+static constexpr uint64_t kTraceHashMultiplier = 0x9e3779b97f4a7c15ull;
+
+// Whether the current thread runs a job of RunJobs, in which case the jobs
+// of its own calls to RunJobs run on it rather than on more threads.
+static thread_local bool inJob = false;
+
 namespace android {
 namespace vts {
 
+// Clears the fields of record that differ between two runs of the same test.
+static void clearRecordTimestamps(VtsProfilingRecord* record) {
+  record->clear_timestamp();
+  record->clear_thread_id();
+  record->clear_call_id();
+  record->clear_thread_cpu_time();
+  record->clear_cpu();
+}
+
+// Hash of a sequence of records, H(r0..rn-1) = sum of h(ri) * M^(n-1-i),
+// where h is the 64-bit FNV-1a of the record preceded by its size, so that
+// it is the hash of the record sequence rather than of the concatenated
+// bytes, and M is kTraceHashMultiplier. The hashes of consecutive chunks of
+// a trace are combined into that of the whole trace as
+// H(AB) = H(A) * M^|B| + H(B).
+struct TraceHash {
+  uint64_t hash = 0;
+  long count = 0;
+
+  void Add(const VtsProfilingRecord& record, string* serialized_record) {
+    record.SerializeToString(serialized_record);
+    uint64_t h = 14695981039346656037ull;
+    auto hash_bytes = [&h](const void* data, size_t size) {
+      const uint8_t* bytes = static_cast<const uint8_t*>(data);
+      for (size_t i = 0; i < size; i++) {
+        h = (h ^ bytes[i]) * 1099511628211ull;
+      }
+    };
+    uint64_t size = serialized_record->size();
+    hash_bytes(&size, sizeof(size));
+    hash_bytes(serialized_record->data(), serialized_record->size());
+    hash = hash * kTraceHashMultiplier + h;
+    count++;
+  }
+
+  void Append(const TraceHash& other) {
+    // M^|other|, by squaring.
+    uint64_t multiplier = 1;
+    uint64_t power = kTraceHashMultiplier;
+    for (uint64_t n = other.count; n > 0; n >>= 1) {
+      if (n & 1) {
+        multiplier *= power;
+      }
+      power *= power;
+    }
+    hash = hash * multiplier + other.hash;
+    count += other.count;
+  }
+};
+
 bool VtsTraceProcessor::ParseBinaryTrace(const string& trace_file,
                                          bool ignore_timestamp, bool entry_only,
                                          bool ignore_func_params,
                                          VtsProfilingMessage* profiling_msg) {
+  return ParseBinaryTrace(trace_file, ignore_timestamp, entry_only,
+                          ignore_func_params,
+                          [profiling_msg](const VtsProfilingRecord& record) {
+                            *profiling_msg->add_records() = record;
+                          });
+}
+
+bool VtsTraceProcessor::ParseBinaryTrace(
+    const string& trace_file, bool ignore_timestamp, bool entry_only,
+    bool ignore_func_params,
+    const function<void(const VtsProfilingRecord&)>& on_record) {
   int fd =
       open(trace_file.c_str(), O_RDONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
   if (fd < 0) {
@@ -51,66 +152,237 @@ bool VtsTraceProcessor::ParseBinaryTrace(const string& trace_file,
          << "error: " << std::strerror(errno);
     return false;
   }
-  google::protobuf::io::FileInputStream input(fd);
+  google::protobuf::io::FileInputStream file_input(fd);
+  // Compressed traces are decompressed transparently.
+  bool compressed = isCompressedTrace(fd);
+  VtsTraceDecompressingInputStream decompressing_input(&file_input);
+  google::protobuf::io::ZeroCopyInputStream* input =
+      compressed ? static_cast<google::protobuf::io::ZeroCopyInputStream*>(
+                       &decompressing_input)
+                 : &file_input;
+  bool compact = isCompactTrace(input);
+  VtsCompactTraceDecoder decoder(input);
+  if (compact && !decoder.ReadHeader()) {
+    cerr << "Invalid compact trace file: " << trace_file << endl;
+    file_input.Close();
+    return false;
+  }
   VtsProfilingRecord record;
-  while (readOneDelimited(&record, &input)) {
+  while (compact ? decoder.ReadRecord(&record, nullptr)
+                 : readOneDelimited(&record, input)) {
     if (ignore_timestamp) {
-      record.clear_timestamp();
+      clearRecordTimestamps(&record);
     }
     if (ignore_func_params) {
       record.mutable_func_msg()->clear_arg();
       record.mutable_func_msg()->clear_return_type_hidl();
     }
-    if (entry_only) {
-      if (isEntryEvent(record.event())) {
-        *profiling_msg->add_records() = record;
-      }
-    } else {
-      *profiling_msg->add_records() = record;
+    if (!entry_only || isEntryEvent(record.event())) {
+      on_record(record);
     }
     record.Clear();
   }
-  input.Close();
+  if (decoder.HadError()) {
+    cerr << "Failed to decode compact trace file: " << trace_file << endl;
+  }
+  if (decompressing_input.HadError()) {
+    cerr << "Failed to decompress trace file: " << trace_file << endl;
+  }
+  file_input.Close();
   return true;
 }
 
-bool VtsTraceProcessor::ParseTextTrace(const string& trace_file,
-                                       VtsProfilingMessage* profiling_msg) {
-  ifstream in(trace_file, std::ios::in);
-  bool new_record = true;
-  string record_str, line;
+bool VtsTraceProcessor::HashTrace(const string& trace_file, uint64_t* hash,
+                                  long* record_count) {
+  TraceHash trace_hash;
+  unique_ptr<VtsTraceReader> reader = OpenTraceChunks(trace_file);
+  if (reader) {
+    // The chunks are hashed in parallel, then their hashes are combined in
+    // order.
+    vector<size_t> chunks = GetTraceChunks(*reader);
+    vector<TraceHash> chunk_hashes(chunks.size() - 1);
+    vector<string> serialized_records(chunks.size() - 1);
+    if (!ParseTraceChunks(*reader, chunks, true, true,
+                          [&](size_t chunk, size_t /*index*/,
+                              const VtsProfilingRecord& record) {
+                            chunk_hashes[chunk].Add(
+                                record, &serialized_records[chunk]);
+                          })) {
+      return false;
+    }
+    for (const TraceHash& chunk_hash : chunk_hashes) {
+      trace_hash.Append(chunk_hash);
+    }
+  } else {
+    string serialized_record;
+    if (!ParseBinaryTrace(trace_file, true, true, false,
+                          [&](const VtsProfilingRecord& record) {
+                            trace_hash.Add(record, &serialized_record);
+                          })) {
+      return false;
+    }
+  }
+  *hash = trace_hash.hash;
+  *record_count = trace_hash.count;
+  return true;
+}
 
-  while (getline(in, line)) {
-    // Assume records are separated by '\n'.
-    if (line.empty()) {
-      new_record = false;
+bool VtsTraceProcessor::IsSameTrace(const string& trace_file,
+                                    const string& other_trace_file) {
+  VtsProfilingMessage profiling_msg;
+  VtsProfilingMessage other_profiling_msg;
+  if (!ParseBinaryTrace(trace_file, true, true, false, &profiling_msg) ||
+      !ParseBinaryTrace(other_trace_file, true, true, false,
+                        &other_profiling_msg) ||
+      profiling_msg.records_size() != other_profiling_msg.records_size()) {
+    return false;
+  }
+  return profiling_msg.SerializeAsString() ==
+         other_profiling_msg.SerializeAsString();
+}
+
+bool VtsTraceProcessor::ParseTextTrace(
+    const string& trace_file,
+    const function<void(const VtsProfilingRecord&)>& on_record) {
+  ifstream in(trace_file, std::ios::in | std::ios::binary);
+  if (!in) {
+    cerr << "Can not open trace file: " << trace_file << endl;
+    return false;
+  }
+  // The text read so far that is not parsed yet, i.e. a batch of records
+  // followed by the beginning of the next one.
+  string buffer;
+  // The offset and size in buffer of each record of the batch.
+  vector<pair<size_t, size_t>> spans;
+  // The records of the batch, reused from one batch to the next.
+  vector<VtsProfilingRecord> records;
+  vector<char> parsed;
+  bool at_end = false;
+  while (!at_end) {
+    size_t size = buffer.size();
+    buffer.resize(size + kTextTraceChunkSize);
+    in.read(&buffer[size], kTextTraceChunkSize);
+    buffer.resize(size + in.gcount());
+    at_end = in.gcount() == 0;
+    // Assume records are separated by an empty line. The last record may
+    // not be followed by one.
+    spans.clear();
+    size_t record_start = 0;
+    size_t line_start = 0;
+    while (line_start < buffer.size()) {
+      size_t line_end = buffer.find('\n', line_start);
+      if (line_end == string::npos) {
+        if (!at_end) break;
+        line_end = buffer.size();
+      }
+      if (line_end == line_start) {
+        if (line_start > record_start) {
+          spans.emplace_back(record_start, line_start - record_start);
+        }
+        record_start = line_end + 1;
+      }
+      line_start = line_end + 1;
     }
-    if (new_record) {
-      record_str += line + "\n";
-    } else {
-      VtsProfilingRecord record;
-      if (!TextFormat::MergeFromString(record_str, &record)) {
-        cerr << "Can't parse a given record: " << record_str << endl;
+    if (at_end && record_start < buffer.size()) {
+      spans.emplace_back(record_start, buffer.size() - record_start);
+      record_start = buffer.size();
+    }
+    // The records of the batch are parsed in parallel, then passed in order.
+    if (records.size() < spans.size()) {
+      records.resize(spans.size());
+    }
+    parsed.assign(spans.size(), false);
+    RunJobs(spans.size(), [&](size_t i) {
+      google::protobuf::io::ArrayInputStream input(
+          buffer.data() + spans[i].first, spans[i].second);
+      parsed[i] = TextFormat::Parse(&input, &records[i]);
+    });
+    for (size_t i = 0; i < spans.size(); i++) {
+      if (!parsed[i]) {
+        cerr << "Can't parse a given record: "
+             << buffer.substr(spans[i].first, spans[i].second) << endl;
         return false;
       }
-      *profiling_msg->add_records() = record;
-      new_record = true;
-      record_str.clear();
+      on_record(records[i]);
     }
+    buffer.erase(0, min(record_start, buffer.size()));
   }
-  in.close();
   return true;
 }
 
-void VtsTraceProcessor::ParseTrace(const string& trace_file) {
-  VtsProfilingMessage profiling_msg;
-  if (!ParseBinaryTrace(trace_file, false, false, false, &profiling_msg)) {
+void VtsTraceProcessor::ParseTrace(const string& trace_file,
+                                   int64_t start_time, int64_t end_time) {
+  auto print_record = [](VtsProfilingRecord* record) {
+    // Print the vectors recorded as raw bytes element by element.
+    expandRawVectorValues(record->mutable_func_msg());
+    cout << record->DebugString() << endl;
+  };
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file, false);
+  if (reader) {
+    VtsProfilingRecord record;
+    for (size_t index : reader->FindRecords(start_time, end_time)) {
+      if (!reader->ReadRecord(index, &record)) {
+        cerr << __func__ << ": Failed to parse trace file: " << trace_file
+             << endl;
+        return;
+      }
+      print_record(&record);
+    }
+    return;
+  }
+  if (!ParseBinaryTrace(trace_file, false, false, false,
+                        [&](const VtsProfilingRecord& record) {
+                          if (record.timestamp() >= start_time &&
+                              record.timestamp() < end_time) {
+                            VtsProfilingRecord printed_record = record;
+                            print_record(&printed_record);
+                          }
+                        })) {
+    cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
+  }
+}
+
+void VtsTraceProcessor::CountTraceRecords(const string& trace_file,
+                                          int64_t start_time,
+                                          int64_t end_time) {
+  map<string, long> record_counts;
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file, false);
+  if (reader) {
+    // Only the index is needed.
+    vector<long> api_record_counts(reader->ApiNames().size());
+    for (size_t index : reader->FindRecords(start_time, end_time)) {
+      api_record_counts[reader->Entries()[index].api_id]++;
+    }
+    for (size_t i = 0; i < api_record_counts.size(); i++) {
+      if (api_record_counts[i] > 0) {
+        record_counts[reader->ApiNames()[i]] += api_record_counts[i];
+      }
+    }
+  } else if (!ParseBinaryTrace(trace_file, false, false, true,
+                               [&](const VtsProfilingRecord& record) {
+                                 if (record.timestamp() >= start_time &&
+                                     record.timestamp() < end_time) {
+                                   record_counts[GetFullApiStr(record)]++;
+                                 }
+                               })) {
     cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
     return;
   }
-  for (const auto& record : profiling_msg.records()) {
-    cout << record.DebugString() << endl;
+  for (const auto& it : record_counts) {
+    cout << it.first << ":" << it.second << endl;
+  }
+}
+
+void VtsTraceProcessor::IndexTrace(const string& trace_file) {
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file);
+  if (!reader) {
+    cerr << __func__ << ": Can not index trace file: " << trace_file
+         << ", only uncompressed traces of delimited records can be indexed "
+         << "(see convert_trace_to_delimited)." << endl;
+    return;
   }
+  cout << "records: " << reader->Entries().size() << endl;
+  cout << "apis: " << reader->ApiNames().size() << endl;
 }
 
 bool VtsTraceProcessor::WriteProfilingMsg(
@@ -132,51 +404,451 @@ bool VtsTraceProcessor::WriteProfilingMsg(
   return true;
 }
 
-void VtsTraceProcessor::ConvertTrace(const string& trace_file) {
+bool VtsTraceProcessor::WriteCompactProfilingMsg(
+    const string& output_file, const VtsProfilingMessage& profiling_msg) {
+  int fd = open(output_file.c_str(), O_WRONLY | O_CREAT | O_EXCL,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    cerr << "Can not open trace file: " << output_file
+         << "error: " << std::strerror(errno);
+    return false;
+  }
+  google::protobuf::io::FileOutputStream output(fd);
+  bool success;
+  {
+    google::protobuf::io::CodedOutputStream coded_output(&output);
+    VtsCompactTraceEncoder encoder;
+    string data;
+    encoder.EncodeHeader(&data);
+    coded_output.WriteString(data);
+    data.clear();
+    for (const auto& record : profiling_msg.records()) {
+      // Delimited traces do not record the thread of the events.
+      encoder.EncodeRecord(record, &data);
+      coded_output.WriteString(data);
+      data.clear();
+    }
+    success = !coded_output.HadError();
+  }
+  if (!success) {
+    cerr << "Failed to write record";
+  }
+  output.Close();
+  return success;
+}
+
+void VtsTraceProcessor::ConvertTraceFormat(const string& trace_file,
+                                           TraceFormat format) {
   VtsProfilingMessage profiling_msg;
-  if (!ParseTextTrace(trace_file, &profiling_msg)) {
+  if (!ParseBinaryTrace(trace_file, false, false, false, &profiling_msg)) {
     cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
     return;
   }
-  string tmp_file = trace_file + "_binary";
+  string tmp_file;
+  bool success;
+  if (format == TraceFormat::COMPACT) {
+    tmp_file = trace_file + "_compact";
+    success = WriteCompactProfilingMsg(tmp_file, profiling_msg);
+  } else {
+    tmp_file = trace_file + "_delimited";
+    success = WriteProfilingMsg(tmp_file, profiling_msg);
+  }
+  if (!success) {
+    cerr << __func__ << ": Failed to write new trace file: " << tmp_file
+         << endl;
+  }
+}
+
+void VtsTraceProcessor::ExpandTrace(const string& trace_file) {
+  VtsProfilingMessage profiling_msg;
+  if (!ParseBinaryTrace(trace_file, false, false, false, &profiling_msg)) {
+    cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
+    return;
+  }
+  for (auto& record : *profiling_msg.mutable_records()) {
+    if (!expandRawVectorValues(record.mutable_func_msg())) {
+      cerr << __func__ << ": Failed to expand record: " << record.DebugString()
+           << endl;
+    }
+  }
+  string tmp_file = trace_file + "_expanded";
   if (!WriteProfilingMsg(tmp_file, profiling_msg)) {
     cerr << __func__ << ": Failed to write new trace file: " << tmp_file
          << endl;
+  }
+}
+
+// Returns whether event begins a slice in an exported trace, i.e. is the
+// entry event of a call or a callback.
+static bool isSliceBeginEvent(InstrumentationEventType event) {
+  switch (event) {
+    case InstrumentationEventType::SERVER_API_ENTRY:
+    case InstrumentationEventType::CLIENT_API_ENTRY:
+    case InstrumentationEventType::SYNC_CALLBACK_ENTRY:
+    case InstrumentationEventType::ASYNC_CALLBACK_ENTRY:
+    case InstrumentationEventType::PASSTHROUGH_ENTRY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the category of the slices of event in an exported trace.
+static const char* getSliceCategory(InstrumentationEventType event) {
+  switch (event) {
+    case InstrumentationEventType::SERVER_API_ENTRY:
+    case InstrumentationEventType::SERVER_API_EXIT:
+      return "server";
+    case InstrumentationEventType::CLIENT_API_ENTRY:
+    case InstrumentationEventType::CLIENT_API_EXIT:
+      return "client";
+    case InstrumentationEventType::PASSTHROUGH_ENTRY:
+    case InstrumentationEventType::PASSTHROUGH_EXIT:
+      return "passthrough";
+    default:
+      return "callback";
+  }
+}
+
+// The longest value of an arg in an exported trace, beyond which it is
+// truncated.
+static constexpr size_t kMaxExportedArgSize = 256;
+
+// Appends to json the values of vars as the args of a trace event, named
+// with prefix and their index.
+static void appendExportedArgs(
+    const google::protobuf::RepeatedPtrField<VariableSpecificationMessage>&
+        vars,
+    const char* prefix, const TextFormat::Printer& printer, string* json) {
+  json->append(",\"args\":{");
+  for (int i = 0; i < vars.size(); i++) {
+    string value;
+    printer.PrintToString(vars.Get(i), &value);
+    // The single line format ends with a space.
+    if (!value.empty() && value.back() == ' ') value.pop_back();
+    if (value.size() > kMaxExportedArgSize) {
+      value.resize(kMaxExportedArgSize);
+      value += "...";
+    }
+    if (i > 0) json->push_back(',');
+    json->append("\"" + string(prefix) + to_string(i) + "\":");
+    json->append(Json::valueToQuotedString(value.c_str()));
+  }
+  json->push_back('}');
+}
+
+void VtsTraceProcessor::ExportTrace(const string& path,
+                                    const string& output_file) {
+  vector<string> trace_files;
+  struct stat path_stat;
+  if (stat(path.c_str(), &path_stat) == 0 && S_ISDIR(path_stat.st_mode)) {
+    trace_files = ListTraceFiles(path);
+  } else {
+    trace_files.push_back(path);
+  }
+  ofstream output(output_file, std::ios::out | std::ios::trunc);
+  if (!output) {
+    cerr << __func__ << ": Failed to open output file: " << output_file
+         << endl;
     return;
   }
+  TextFormat::Printer printer;
+  printer.SetSingleLineMode(true);
+  // The flow ids are derived from the API and the rank of the call, so that
+  // a client call and its server call get the same id without keeping the
+  // calls. They are kept within the integers exactly held by a double.
+  std::hash<string> hash_api;
+  const uint64_t kFlowIdMask = (1ULL << 53) - 1;
+  output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first_event = true;
+  string json;
+  auto write_event = [&]() {
+    if (!first_event) output << ",";
+    output << "\n" << json;
+    first_event = false;
+  };
+  long event_count = 0;
+  for (size_t i = 0; i < trace_files.size(); i++) {
+    int pid = i + 1;
+    string file_name = trace_files[i].substr(trace_files[i].rfind('/') + 1);
+    json = "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" +
+           to_string(pid) + ",\"args\":{\"name\":" +
+           Json::valueToQuotedString(file_name.c_str()) + "}}";
+    write_event();
+    // the number of client or server calls of each API so far.
+    unordered_map<string, uint64_t> api_call_counts;
+    auto on_record = [&](const VtsProfilingRecord& record) {
+      InstrumentationEventType event = record.event();
+      bool begin = isSliceBeginEvent(event);
+      string full_api_name = GetFullApiStr(record);
+      char ts[32];
+      snprintf(ts, sizeof(ts), "%" PRId64 ".%03d", record.timestamp() / 1000,
+               static_cast<int>(record.timestamp() % 1000));
+      string common = ",\"pid\":" + to_string(pid) +
+                      ",\"tid\":" + to_string(record.thread_id()) +
+                      ",\"ts\":" + ts;
+      json = string("{\"ph\":\"") + (begin ? "B" : "E") +
+             "\",\"cat\":\"" + getSliceCategory(event) + "\",\"name\":" +
+             Json::valueToQuotedString(full_api_name.c_str()) + common;
+      if (begin) {
+        appendExportedArgs(record.func_msg().arg(), "arg", printer, &json);
+      } else {
+        appendExportedArgs(record.func_msg().return_type_hidl(), "return",
+                           printer, &json);
+      }
+      json.push_back('}');
+      write_event();
+      event_count++;
+      if (event == InstrumentationEventType::CLIENT_API_ENTRY ||
+          event == InstrumentationEventType::SERVER_API_ENTRY) {
+        uint64_t rank = api_call_counts[full_api_name]++;
+        uint64_t flow_id =
+            (hash_api(full_api_name) * 1000003 + rank) & kFlowIdMask;
+        bool client = event == InstrumentationEventType::CLIENT_API_ENTRY;
+        json = string("{\"ph\":\"") + (client ? "s" : "f") +
+               "\",\"cat\":\"ipc\",\"name\":\"hwbinder\",\"id\":" +
+               to_string(flow_id) + common + (client ? "" : ",\"bp\":\"e\"") +
+               "}";
+        write_event();
+      }
+    };
+    if (!ParseBinaryTrace(trace_files[i], false, false, false, on_record)) {
+      cerr << __func__ << ": Failed to parse trace file: " << trace_files[i]
+           << endl;
+    }
+  }
+  output << "\n]}\n";
+  output.close();
+  if (!output) {
+    cerr << __func__ << ": Failed to write output file: " << output_file
+         << endl;
+    return;
+  }
+  cout << "Exported " << event_count << " events of " << trace_files.size()
+       << " trace files to " << output_file << endl;
 }
 
-void VtsTraceProcessor::CleanupTraceFile(const string& trace_file) {
-  VtsProfilingMessage profiling_msg;
-  if (!ParseBinaryTrace(trace_file, false, false, true, &profiling_msg)) {
+// Appends the bytes of value to seed, as FuzzDataCursor consumes them.
+template <typename T>
+static void appendFuzzBytes(T value, string* seed) {
+  seed->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Appends value, of the given scalar_type, to seed.
+// Returns false for an unknown scalar type.
+static bool appendFuzzScalar(const string& scalar_type,
+                             const ScalarDataValueMessage& value,
+                             string* seed) {
+  if (scalar_type == "bool_t") {
+    appendFuzzBytes<uint8_t>(value.bool_t(), seed);
+  } else if (scalar_type == "int8_t") {
+    appendFuzzBytes<int8_t>(value.int8_t(), seed);
+  } else if (scalar_type == "uint8_t") {
+    appendFuzzBytes<uint8_t>(value.uint8_t(), seed);
+  } else if (scalar_type == "char") {
+    appendFuzzBytes<int8_t>(value.char_(), seed);
+  } else if (scalar_type == "uchar") {
+    appendFuzzBytes<uint8_t>(value.uchar(), seed);
+  } else if (scalar_type == "int16_t") {
+    appendFuzzBytes<int16_t>(value.int16_t(), seed);
+  } else if (scalar_type == "uint16_t") {
+    appendFuzzBytes<uint16_t>(value.uint16_t(), seed);
+  } else if (scalar_type == "int32_t") {
+    appendFuzzBytes<int32_t>(value.int32_t(), seed);
+  } else if (scalar_type == "uint32_t") {
+    appendFuzzBytes<uint32_t>(value.uint32_t(), seed);
+  } else if (scalar_type == "int64_t") {
+    appendFuzzBytes<int64_t>(value.int64_t(), seed);
+  } else if (scalar_type == "uint64_t") {
+    appendFuzzBytes<uint64_t>(value.uint64_t(), seed);
+  } else if (scalar_type == "float_t") {
+    appendFuzzBytes<float>(value.float_t(), seed);
+  } else if (scalar_type == "double_t") {
+    appendFuzzBytes<double>(value.double_t(), seed);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Appends var to seed in the layout of utils/FuzzDecodeUtil.h: scalars and
+// enums as their bytes, strings and vectors prefixed by a 16-bit length,
+// arrays and structs element by element. The types the generated fuzzers
+// leave as they are, e.g. interfaces and handles, take no bytes. Returns
+// false if var can't be encoded. Vectors must have been expanded with
+// expandRawVectorValues.
+static bool appendFuzzVariable(const VariableSpecificationMessage& var,
+                               string* seed) {
+  switch (var.type()) {
+    case TYPE_SCALAR:
+    case TYPE_ENUM:
+    case TYPE_MASK:
+      return appendFuzzScalar(var.scalar_type(), var.scalar_value(), seed);
+    case TYPE_STRING: {
+      const string& message = var.string_value().message();
+      if (message.size() > UINT16_MAX) {
+        return false;
+      }
+      appendFuzzBytes<uint16_t>(message.size(), seed);
+      seed->append(message);
+      return true;
+    }
+    case TYPE_VECTOR:
+    case TYPE_ARRAY:
+      if (var.type() == TYPE_VECTOR) {
+        if (var.vector_value_size() > UINT16_MAX) {
+          return false;
+        }
+        appendFuzzBytes<uint16_t>(var.vector_value_size(), seed);
+      }
+      for (const auto& element : var.vector_value()) {
+        if (!appendFuzzVariable(element, seed)) {
+          return false;
+        }
+      }
+      return true;
+    case TYPE_STRUCT:
+      for (const auto& field : var.struct_value()) {
+        if (!appendFuzzVariable(field, seed)) {
+          return false;
+        }
+      }
+      return true;
+    case TYPE_HIDL_CALLBACK:
+    case TYPE_HIDL_INTERFACE:
+    case TYPE_HANDLE:
+    case TYPE_HIDL_MEMORY:
+    case TYPE_FMQ_SYNC:
+    case TYPE_FMQ_UNSYNC:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void VtsTraceProcessor::ConvertTraceToFuzzSeeds(const string& trace_file,
+                                                const string& output_dir) {
+  mkdir(output_dir.c_str(), 0755);
+  // Seeds already written, by function name.
+  map<string, set<string>> seeds;
+  long skipped_calls = 0;
+  long seed_count = 0;
+  bool success = ParseBinaryTrace(
+      trace_file, true, false, false, [&](const VtsProfilingRecord& record) {
+        // Only the calls into the HAL can be replayed by its fuzzer, not
+        // their exits or the callbacks of the HAL.
+        if (!isEntryEvent(record.event())) {
+          return;
+        }
+        FunctionSpecificationMessage func_msg = record.func_msg();
+        string seed;
+        bool encoded = expandRawVectorValues(&func_msg);
+        for (const auto& arg : func_msg.arg()) {
+          encoded = encoded && appendFuzzVariable(arg, &seed);
+        }
+        if (!encoded) {
+          skipped_calls++;
+          return;
+        }
+        set<string>& func_seeds = seeds[func_msg.name()];
+        if (!func_seeds.insert(seed).second) {
+          return;
+        }
+        string func_dir = output_dir + "/" + func_msg.name();
+        if (func_seeds.size() == 1) {
+          mkdir(func_dir.c_str(), 0755);
+        }
+        ofstream out(func_dir + "/seed_" + to_string(func_seeds.size()),
+                     ofstream::binary);
+        out << seed;
+        if (!out.good()) {
+          cerr << __func__ << ": Failed to write seed to " << func_dir
+               << endl;
+          return;
+        }
+        seed_count++;
+      });
+  if (!success) {
     cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
     return;
   }
-  VtsProfilingMessage clean_profiling_msg;
+  cout << "functions: " << seeds.size() << endl;
+  cout << "seeds written: " << seed_count << endl;
+  cout << "calls skipped: " << skipped_calls << endl;
+}
+
+void VtsTraceProcessor::ConvertTrace(const string& trace_file) {
+  string tmp_file = trace_file + "_binary";
+  int fd = open(tmp_file.c_str(), O_WRONLY | O_CREAT | O_EXCL,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    cerr << __func__ << ": Failed to write new trace file: " << tmp_file
+         << endl;
+    return;
+  }
+  // Each record is written as soon as it is parsed.
+  google::protobuf::io::FileOutputStream output(fd);
+  bool success = true;
+  auto on_record = [&](const VtsProfilingRecord& record) {
+    if (success && !writeOneDelimited(record, &output)) {
+      cerr << __func__ << ": Failed to write record to " << tmp_file << endl;
+      success = false;
+    }
+  };
+  if (!ParseTextTrace(trace_file, on_record)) {
+    cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
+    success = false;
+  }
+  if (!output.Close() || !success) {
+    cerr << __func__ << ": Failed to write new trace file: " << tmp_file
+         << endl;
+    unlink(tmp_file.c_str());
+  }
+}
+
+void VtsTraceProcessor::CleanupTraceFile(const string& trace_file) {
+  // The records kept are written as they are read, with their arguments so
+  // that the trace can still be replayed.
+  string tmp_file = trace_file + "_tmp";
+  int fd = open(tmp_file.c_str(), O_WRONLY | O_CREAT | O_EXCL,
+                S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    cerr << __func__ << ": Failed to write new trace file: " << tmp_file
+         << endl;
+    return;
+  }
+  google::protobuf::io::FileOutputStream output(fd);
   bool first_record = true;
-  enum TRACE_TYPE { server_trace, client_trace, passthrough_trace };
+  bool failed = false;
   string package;
   int version_major;
   int version_minor;
-  TRACE_TYPE trace_type;
-  for (const auto& record : profiling_msg.records()) {
+  // The entry and exit events of the type of the trace.
+  InstrumentationEventType entry_event = SERVER_API_ENTRY;
+  InstrumentationEventType exit_event = SERVER_API_EXIT;
+  auto on_record = [&](const VtsProfilingRecord& record) {
+    if (failed) {
+      return;
+    }
     if (first_record) {
       package = record.package();
       version_major = record.version_major();
       version_minor = record.version_minor();
       // determine trace type based on the event of the first record.
+      entry_event = record.event();
       switch (record.event()) {
         case InstrumentationEventType::SERVER_API_ENTRY:
-          trace_type = TRACE_TYPE::server_trace;
+          exit_event = InstrumentationEventType::SERVER_API_EXIT;
           break;
         case InstrumentationEventType::CLIENT_API_ENTRY:
-          trace_type = TRACE_TYPE::client_trace;
+          exit_event = InstrumentationEventType::CLIENT_API_EXIT;
           break;
         case InstrumentationEventType::PASSTHROUGH_ENTRY:
-          trace_type = TRACE_TYPE::passthrough_trace;
+          exit_event = InstrumentationEventType::PASSTHROUGH_EXIT;
           break;
         default:
           cerr << "Unexpected record: " << record.DebugString() << endl;
+          failed = true;
           return;
       }
       first_record = false;
@@ -186,125 +858,1180 @@ void VtsTraceProcessor::CleanupTraceFile(const string& trace_file) {
         record.version_major() != version_major ||
         record.version_minor() != version_minor) {
       cerr << "Unexpected record: " << record.DebugString() << endl;
-      continue;
+      return;
+    }
+    if (record.event() == entry_event || record.event() == exit_event) {
+      if (!writeOneDelimited(record, &output)) {
+        cerr << __func__ << ": Failed to write record to " << tmp_file
+             << endl;
+        failed = true;
+      }
+    }
+  };
+  if (!ParseBinaryTrace(trace_file, false, false, false, on_record)) {
+    cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
+    failed = true;
+  }
+  if (!output.Close()) {
+    cerr << __func__ << ": Failed to write new trace file: " << tmp_file
+         << endl;
+    failed = true;
+  }
+  if (failed) {
+    unlink(tmp_file.c_str());
+    return;
+  }
+  if (rename(tmp_file.c_str(), trace_file.c_str())) {
+    cerr << __func__ << ": Failed to replace old trace file: " << trace_file
+         << endl;
+    return;
+  }
+}
+
+vector<string> VtsTraceProcessor::ListTraceFiles(const string& dir) {
+  vector<string> files;
+  DIR* d = opendir(dir.c_str());
+  if (d == nullptr) {
+    return files;
+  }
+  string prefix = dir;
+  if (prefix.substr(prefix.size() - 1) != "/") {
+    prefix += "/";
+  }
+  struct dirent* file;
+  const size_t suffix_size = sizeof(kTraceIndexSuffix) - 1;
+  while ((file = readdir(d)) != NULL) {
+    string name = file->d_name;
+    // Skip the indexes written by VtsTraceReader.
+    if (file->d_type == DT_REG &&
+        (name.size() < suffix_size ||
+         name.compare(name.size() - suffix_size, suffix_size,
+                      kTraceIndexSuffix) != 0)) {
+      files.push_back(prefix + name);
+    }
+  }
+  closedir(d);
+  sort(files.begin(), files.end());
+  return files;
+}
+
+void VtsTraceProcessor::RunJobs(size_t count,
+                                const function<void(size_t)>& job) {
+  size_t thread_count = min(static_cast<size_t>(jobs_), count);
+  if (thread_count <= 1 || inJob) {
+    for (size_t i = 0; i < count; i++) {
+      job(i);
+    }
+    return;
+  }
+  // Files are handed out one at a time as their processing time varies a
+  // lot with their size.
+  atomic<size_t> next(0);
+  vector<thread> threads;
+  for (size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([&]() {
+      inJob = true;
+      for (size_t i = next++; i < count; i = next++) {
+        job(i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+unique_ptr<VtsTraceReader> VtsTraceProcessor::OpenTraceChunks(
+    const string& trace_file) {
+  if (jobs_ <= 1 || inJob) {
+    return nullptr;
+  }
+  return VtsTraceReader::Open(trace_file, false);
+}
+
+vector<size_t> VtsTraceProcessor::GetTraceChunks(
+    const VtsTraceReader& reader) {
+  const vector<VtsTraceIndexEntry>& entries = reader.Entries();
+  size_t chunk_count =
+      min(jobs_ * kTraceChunksPerJob,
+          max<size_t>(1, entries.size() / kMinTraceChunkRecords));
+  // The chunks have about the same number of bytes rather than of records,
+  // as the time to decode a record grows with its size.
+  vector<size_t> chunks = {0};
+  if (!entries.empty()) {
+    uint64_t begin = entries.front().offset;
+    uint64_t size = entries.back().offset + entries.back().size - begin;
+    for (size_t i = 1; i < chunk_count; i++) {
+      uint64_t offset = begin + size * i / chunk_count;
+      size_t start = lower_bound(entries.begin(), entries.end(), offset,
+                                 [](const VtsTraceIndexEntry& entry,
+                                    uint64_t offset) {
+                                   return entry.offset < offset;
+                                 }) -
+                     entries.begin();
+      if (start > chunks.back() && start < entries.size()) {
+        chunks.push_back(start);
+      }
+    }
+  }
+  chunks.push_back(entries.size());
+  return chunks;
+}
+
+bool VtsTraceProcessor::ParseTraceChunks(
+    const VtsTraceReader& reader, const vector<size_t>& chunks,
+    bool ignore_timestamp, bool entry_only,
+    const function<void(size_t, size_t, const VtsProfilingRecord&)>&
+        on_record) {
+  vector<char> parsed(chunks.size() - 1, true);
+  RunJobs(chunks.size() - 1, [&](size_t chunk) {
+    VtsProfilingRecord record;
+    for (size_t i = chunks[chunk]; i < chunks[chunk + 1]; i++) {
+      if (!reader.ReadRecord(i, &record)) {
+        parsed[chunk] = false;
+        return;
+      }
+      if (ignore_timestamp) {
+        clearRecordTimestamps(&record);
+      }
+      if (!entry_only || isEntryEvent(record.event())) {
+        on_record(chunk, i, record);
+      }
+    }
+  });
+  return find(parsed.begin(), parsed.end(), false) == parsed.end();
+}
+
+void VtsTraceProcessor::CleanupTraces(const string& path) {
+  struct stat path_stat;
+  stat(path.c_str(), &path_stat);
+  if (S_ISREG(path_stat.st_mode)) {
+    CleanupTraceFile(path);
+  } else if (S_ISDIR(path_stat.st_mode)) {
+    // List the files first so that the temporary files written by the
+    // cleanup are not processed.
+    vector<string> trace_files = ListTraceFiles(path);
+    RunJobs(trace_files.size(),
+            [&](size_t i) { CleanupTraceFile(trace_files[i]); });
+  }
+}
+
+void VtsTraceProcessor::LatencyHistogram::Add(int64_t latency) {
+  if (count == 0 || latency < min) {
+    min = latency;
+  }
+  if (count == 0 || latency > max) {
+    max = latency;
+  }
+  count++;
+  sum += latency;
+  buckets[Buckets::GetBucket(latency)]++;
+}
+
+int64_t VtsTraceProcessor::LatencyHistogram::Percentile(double percent) const {
+  long rank = static_cast<long>(count * percent / 100);
+  long seen = 0;
+  for (const auto& bucket : buckets) {
+    seen += bucket.second;
+    if (seen > rank) {
+      return std::min(Buckets::GetBucketEnd(bucket.first), max);
+    }
+  }
+  return max;
+}
+
+void VtsTraceProcessor::LatencyHistogram::Merge(
+    const LatencyHistogram& other) {
+  if (other.count == 0) {
+    return;
+  }
+  if (count == 0 || other.min < min) {
+    min = other.min;
+  }
+  if (count == 0 || other.max > max) {
+    max = other.max;
+  }
+  count += other.count;
+  sum += other.sum;
+  for (const auto& bucket : other.buckets) {
+    buckets[bucket.first] += bucket.second;
+  }
+}
+
+double VtsTraceProcessor::LatencyHistogram::ShiftPValue(
+    const LatencyHistogram& base) const {
+  if (count == 0 || base.count == 0) {
+    return 1;
+  }
+  // U counts the pairs of calls (base, this) where this call is slower, and
+  // half of the tied pairs. The buckets of both are walked in order, keeping
+  // the number of base calls in the lower buckets.
+  double u = 0;
+  double base_below = 0;
+  double ties = 0;
+  auto it = buckets.begin();
+  auto base_it = base.buckets.begin();
+  while (it != buckets.end() || base_it != base.buckets.end()) {
+    int bucket = it == buckets.end()
+                     ? base_it->first
+                     : base_it == base.buckets.end()
+                           ? it->first
+                           : std::min(it->first, base_it->first);
+    double n = 0;
+    double base_n = 0;
+    if (it != buckets.end() && it->first == bucket) {
+      n = (it++)->second;
+    }
+    if (base_it != base.buckets.end() && base_it->first == bucket) {
+      base_n = (base_it++)->second;
+    }
+    u += n * (base_below + base_n / 2);
+    base_below += base_n;
+    double tied = n + base_n;
+    ties += tied * tied * tied - tied;
+  }
+  // Normal approximation of the distribution of U, with the tie correction.
+  double n1 = base.count;
+  double n2 = count;
+  double total = n1 + n2;
+  double variance =
+      n1 * n2 / 12 * (total + 1 - ties / (total * (total - 1)));
+  if (variance <= 0) {
+    // All the calls are in the same bucket.
+    return 1;
+  }
+  double z = (u - n1 * n2 / 2) / sqrt(variance);
+  return erfc(z / sqrt(2)) / 2;
+}
+
+void VtsTraceProcessor::CallMatcher::AddRecord(
+    const VtsProfilingRecord& record, const string& full_api_name,
+    const function<void(const VtsProfilingRecord&, const string&, uint32_t,
+                        int64_t)>& on_call) {
+  auto inserted = api_ids_.emplace(full_api_name, api_ids_.size());
+  uint32_t api_id = inserted.first->second;
+  OpenCall call = {api_id, record.event(), record.timestamp(),
+                   record.has_thread_cpu_time() ? record.thread_cpu_time() : -1,
+                   record_count_++};
+  OpenCall entry;
+  if (record.call_id() != 0) {
+    if (isCallEntryEvent(record.event())) {
+      open_calls_[record.call_id()] = call;
+      return;
+    }
+    auto found = open_calls_.find(record.call_id());
+    if (found == open_calls_.end() || found->second.api_id != api_id ||
+        !isPairedEvent(found->second.event, record.event())) {
+      AddUnmatchedRecord(record, call.record_index);
+      return;
+    }
+    entry = found->second;
+    open_calls_.erase(found);
+  } else {
+    vector<OpenCall>& calls = open_thread_calls_[record.thread_id()];
+    if (isCallEntryEvent(record.event())) {
+      calls.push_back(call);
+      return;
+    }
+    // The exit event is paired with the innermost open call of the same
+    // API with the corresponding entry event.
+    auto found =
+        find_if(calls.rbegin(), calls.rend(), [&](const OpenCall& call) {
+          return call.api_id == api_id &&
+                 isPairedEvent(call.event, record.event());
+        });
+    if (found == calls.rend()) {
+      AddUnmatchedRecord(record, call.record_index);
+      return;
+    }
+    entry = *found;
+    calls.erase(next(found).base());
+  }
+  // A synchronous callback runs within the call of the same method, which
+  // is the one measured.
+  if (record.event() == InstrumentationEventType::SYNC_CALLBACK_EXIT) {
+    return;
+  }
+  last_entry_record_index_ = entry.record_index;
+  last_entry_thread_cpu_time_ = entry.thread_cpu_time;
+  on_call(record, full_api_name, api_id, entry.timestamp);
+}
+
+void VtsTraceProcessor::CallMatcher::AddUnmatchedRecord(
+    const VtsProfilingRecord& record, size_t record_index) {
+  if (on_unmatched_) {
+    on_unmatched_(record_index);
+    return;
+  }
+  cerr << "Could not found entry record for record: " << record.DebugString()
+       << endl;
+}
+
+vector<size_t> VtsTraceProcessor::CallMatcher::OpenEntryRecordIndexes()
+    const {
+  vector<size_t> record_indexes;
+  for (const auto& call : open_calls_) {
+    record_indexes.push_back(call.second.record_index);
+  }
+  for (const auto& calls : open_thread_calls_) {
+    for (const OpenCall& call : calls.second) {
+      record_indexes.push_back(call.record_index);
+    }
+  }
+  sort(record_indexes.begin(), record_indexes.end());
+  return record_indexes;
+}
+
+bool VtsTraceProcessor::ParseTraceCalls(
+    const string& trace_file,
+    const function<void(const VtsProfilingRecord&)>& on_record,
+    const function<void(const VtsProfilingRecord&, const string&, uint32_t,
+                        int64_t)>& on_call) {
+  CallMatcher matcher;
+  auto parse_record = [&](const VtsProfilingRecord& record) {
+    if (on_record) {
+      on_record(record);
+    }
+    matcher.AddRecord(record, GetFullApiStr(record), on_call);
+  };
+  return ParseBinaryTrace(trace_file, false, false, true, parse_record);
+}
+
+void VtsTraceProcessor::ProcessTraceForLatencyProfiling(
+    const string& trace_file, bool verbose) {
+  // The latencies of the calls of an API.
+  struct ApiLatencies {
+    LatencyHistogram histogram;
+    // For the calls whose entry and exit records have the CPU time of their
+    // thread, the CPU time they spent and their total latency.
+    LatencyHistogram on_cpu;
+    int64_t on_cpu_latency_sum = 0;
+  };
+  // The calls matched by a matcher, with the API names and latencies indexed
+  // by the API ids it assigns.
+  struct MatchedCalls {
+    CallMatcher matcher;
+    vector<string> api_names;
+    vector<ApiLatencies> apis;
+  };
+  // Returns the on_call of the matcher of calls, adding their latencies.
+  auto add_calls = [verbose](MatchedCalls* calls) {
+    return [verbose, calls](const VtsProfilingRecord& record,
+                            const string& full_api_name, uint32_t api_id,
+                            int64_t entry_timestamp) {
+      if (api_id >= calls->apis.size()) {
+        calls->api_names.resize(api_id + 1);
+        calls->apis.resize(api_id + 1);
+      }
+      calls->api_names[api_id] = full_api_name;
+      int64_t latency = record.timestamp() - entry_timestamp;
+      // Negative latency check.
+      if (latency < 0) {
+        cerr << __func__ << ": got negative latency for " << full_api_name
+             << endl;
+        exit(-1);
+      }
+      if (verbose) {
+        cout << full_api_name << ":" << latency << endl;
+        return;
+      }
+      ApiLatencies& api = calls->apis[api_id];
+      api.histogram.Add(latency);
+      // The entry and exit events of a call are traced by the same thread.
+      int64_t entry_cpu_time = calls->matcher.LastEntryThreadCpuTime();
+      if (entry_cpu_time >= 0 && record.has_thread_cpu_time() &&
+          record.thread_cpu_time() >= entry_cpu_time) {
+        api.on_cpu.Add(
+            min(record.thread_cpu_time() - entry_cpu_time, latency));
+        api.on_cpu_latency_sum += latency;
+      }
+    };
+  };
+  auto print_hal_mode = [](const VtsProfilingRecord& first_record) {
+    if (first_record.event() == InstrumentationEventType::PASSTHROUGH_ENTRY ||
+        first_record.event() == InstrumentationEventType::PASSTHROUGH_EXIT) {
+      cout << "hidl_hal_mode:passthrough" << endl;
+    } else {
+      cout << "hidl_hal_mode:binder" << endl;
+    }
+  };
+
+  vector<MatchedCalls> matched_calls;
+  // The latencies are output in order, so they are not computed in chunks.
+  unique_ptr<VtsTraceReader> reader =
+      verbose ? nullptr : OpenTraceChunks(trace_file);
+  if (reader) {
+    // The calls within each chunk are matched in parallel. Then the exit
+    // records without their entry record in their chunk, and the entry
+    // records still open at the end of their chunk, are matched chunk by
+    // chunk in order by a last matcher, which matches the calls across
+    // chunks as matching all the records in order would.
+    vector<size_t> chunks = GetTraceChunks(*reader);
+    size_t chunk_count = chunks.size() - 1;
+    matched_calls.resize(chunk_count + 1);
+    vector<function<void(const VtsProfilingRecord&, const string&, uint32_t,
+                         int64_t)>>
+        on_calls;
+    vector<vector<size_t>> unmatched_records(chunk_count);
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+      on_calls.push_back(add_calls(&matched_calls[chunk]));
+      matched_calls[chunk].matcher.SetUnmatchedCallback(
+          [&unmatched_records, &chunks, chunk](size_t record_index) {
+            unmatched_records[chunk].push_back(chunks[chunk] + record_index);
+          });
+    }
+    if (!ParseTraceChunks(*reader, chunks, false, false,
+                          [&](size_t chunk, size_t /*index*/,
+                              const VtsProfilingRecord& record) {
+                            matched_calls[chunk].matcher.AddRecord(
+                                record, GetFullApiStr(record),
+                                on_calls[chunk]);
+                          })) {
+      cerr << __func__ << ": Failed to parse trace file: " << trace_file
+           << endl;
+      return;
+    }
+    MatchedCalls& calls_across_chunks = matched_calls.back();
+    auto on_call = add_calls(&calls_across_chunks);
+    VtsProfilingRecord record;
+    if (!reader->Entries().empty() && reader->ReadRecord(0, &record)) {
+      print_hal_mode(record);
+    }
+    for (size_t chunk = 0; chunk < chunk_count; chunk++) {
+      vector<size_t> records = std::move(unmatched_records[chunk]);
+      for (size_t record_index :
+           matched_calls[chunk].matcher.OpenEntryRecordIndexes()) {
+        records.push_back(chunks[chunk] + record_index);
+      }
+      for (size_t index : records) {
+        if (!reader->ReadRecord(index, &record)) {
+          cerr << __func__ << ": Failed to parse trace file: " << trace_file
+               << endl;
+          return;
+        }
+        calls_across_chunks.matcher.AddRecord(record, GetFullApiStr(record),
+                                              on_call);
+      }
+    }
+  } else {
+    matched_calls.resize(1);
+    MatchedCalls& calls = matched_calls.front();
+    auto on_call = add_calls(&calls);
+    bool first_record = true;
+    auto parse_record = [&](const VtsProfilingRecord& record) {
+      if (first_record) {
+        print_hal_mode(record);
+        first_record = false;
+      }
+      calls.matcher.AddRecord(record, GetFullApiStr(record), on_call);
+    };
+    if (!ParseBinaryTrace(trace_file, false, false, true, parse_record)) {
+      cerr << __func__ << ": Failed to parse trace file: " << trace_file
+           << endl;
+      return;
+    }
+  }
+  if (verbose) {
+    return;
+  }
+  map<string, ApiLatencies> sorted_apis;
+  for (const MatchedCalls& calls : matched_calls) {
+    for (uint32_t api_id = 0; api_id < calls.apis.size(); api_id++) {
+      const ApiLatencies& api = calls.apis[api_id];
+      if (api.histogram.count == 0) {
+        continue;
+      }
+      ApiLatencies& merged = sorted_apis[calls.api_names[api_id]];
+      merged.histogram.Merge(api.histogram);
+      merged.on_cpu.Merge(api.on_cpu);
+      merged.on_cpu_latency_sum += api.on_cpu_latency_sum;
+    }
+  }
+  for (const auto& api : sorted_apis) {
+    const LatencyHistogram& histogram = api.second.histogram;
+    cout << api.first << ":count=" << histogram.count
+         << ",min=" << histogram.min
+         << ",mean=" << histogram.sum / histogram.count
+         << ",p50=" << histogram.Percentile(50)
+         << ",p90=" << histogram.Percentile(90)
+         << ",p99=" << histogram.Percentile(99) << ",max=" << histogram.max;
+    // The time the calls ran on a CPU, and the rest of their latency, during
+    // which they waited, e.g. for a lock, an I/O or to be scheduled.
+    const LatencyHistogram& on_cpu = api.second.on_cpu;
+    if (on_cpu.count > 0) {
+      cout << ",on_cpu_mean=" << on_cpu.sum / on_cpu.count
+           << ",on_cpu_p50=" << on_cpu.Percentile(50)
+           << ",on_cpu_p90=" << on_cpu.Percentile(90) << ",off_cpu_mean="
+           << (api.second.on_cpu_latency_sum - on_cpu.sum) / on_cpu.count;
     }
-    switch (trace_type) {
-      case TRACE_TYPE::server_trace: {
-        if (record.event() == InstrumentationEventType::SERVER_API_ENTRY ||
-            record.event() == InstrumentationEventType::SERVER_API_EXIT) {
-          *clean_profiling_msg.add_records() = record;
+    cout << endl;
+  }
+}
+
+void VtsTraceProcessor::FollowTrace(const string& trace_file,
+                                    int window_seconds) {
+  static constexpr int64_t kNanoSecondsPerSecond = 1000000000;
+  int fd = -1;
+  ino_t inode = 0;
+  off_t offset = 0;
+  // The data read after the last complete record.
+  string pending;
+  CallMatcher matcher;
+  // The latencies of the calls of each API by second of trace, i.e. by the
+  // timestamp of their exit event, and the last of those seconds.
+  map<string, map<int64_t, LatencyHistogram>> api_seconds;
+  int64_t last_second = INT64_MIN;
+  vector<char> buffer(kFollowReadSize);
+  VtsProfilingRecord record;
+
+  auto on_call = [&](const VtsProfilingRecord& exit_record,
+                     const string& full_api_name, uint32_t /*api_id*/,
+                     int64_t entry_timestamp) {
+    int64_t latency = exit_record.timestamp() - entry_timestamp;
+    if (latency < 0) {
+      cerr << __func__ << ": got negative latency for " << full_api_name
+           << endl;
+      return;
+    }
+    int64_t second = exit_record.timestamp() / kNanoSecondsPerSecond;
+    last_second = std::max(last_second, second);
+    map<int64_t, LatencyHistogram>& seconds = api_seconds[full_api_name];
+    // Calls mostly end in order, i.e. in the last second.
+    seconds.emplace_hint(seconds.end(), second, LatencyHistogram())
+        ->second.Add(latency);
+  };
+
+  while (true) {
+    struct stat file_stat;
+    if (fd >= 0 && (stat(trace_file.c_str(), &file_stat) != 0 ||
+                    file_stat.st_ino != inode || file_stat.st_size < offset)) {
+      close(fd);
+      fd = -1;
+    }
+    if (fd < 0) {
+      fd = open(trace_file.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd >= 0 && fstat(fd, &file_stat) == 0) {
+        inode = file_stat.st_ino;
+        offset = 0;
+        pending.clear();
+        matcher = CallMatcher();
+        api_seconds.clear();
+        last_second = INT64_MIN;
+      }
+    }
+    bool read_records = false;
+    ssize_t size;
+    while (fd >= 0 && (size = read(fd, buffer.data(), buffer.size())) > 0) {
+      // Neither a compact nor a compressed trace can be decoded from where
+      // the previous read stopped.
+      bool at_start = offset == 0;
+      offset += size;
+      pending.append(buffer.data(), size);
+      if (at_start &&
+          (hasCompactTraceMagic(pending.data(), pending.size()) ||
+           pending.compare(0, kCompressedBlockMagicSize,
+                           kCompressedBlockMagic) == 0)) {
+        cerr << __func__ << ": Only traces of delimited records that are not "
+             << "compressed can be followed: " << trace_file << endl;
+        close(fd);
+        return;
+      }
+      size_t pos = 0;
+      while (pos < pending.size()) {
+        const uint8_t* data =
+            reinterpret_cast<const uint8_t*>(pending.data()) + pos;
+        size_t available = pending.size() - pos;
+        google::protobuf::io::CodedInputStream input(data, available);
+        uint32_t record_size;
+        if (!input.ReadVarint32(&record_size)) {
+          // A varint32 is at most 5 bytes.
+          if (available >= 5) {
+            cerr << __func__ << ": Invalid record size in trace file: "
+                 << trace_file << endl;
+            close(fd);
+            return;
+          }
+          break;
+        }
+        size_t size_bytes = input.CurrentPosition();
+        if (available - size_bytes < record_size) {
+          // The rest of the record is not written yet.
+          break;
         }
-        break;
+        if (record.ParseFromArray(data + size_bytes, record_size)) {
+          matcher.AddRecord(record, GetFullApiStr(record), on_call);
+        } else {
+          cerr << __func__ << ": Failed to parse a record of trace file: "
+               << trace_file << endl;
+        }
+        pos += size_bytes + record_size;
+        read_records = true;
       }
-      case TRACE_TYPE::client_trace: {
-        if (record.event() == InstrumentationEventType::CLIENT_API_ENTRY ||
-            record.event() == InstrumentationEventType::CLIENT_API_EXIT) {
-          *clean_profiling_msg.add_records() = record;
+      pending.erase(0, pos);
+    }
+
+    if (read_records && last_second != INT64_MIN) {
+      int64_t first_second = last_second - window_seconds + 1;
+      cout << "window_end=" << last_second + 1 << "s,window=" << window_seconds
+           << "s" << endl;
+      for (auto api = api_seconds.begin(); api != api_seconds.end();) {
+        map<int64_t, LatencyHistogram>& seconds = api->second;
+        seconds.erase(seconds.begin(), seconds.lower_bound(first_second));
+        if (seconds.empty()) {
+          api = api_seconds.erase(api);
+          continue;
         }
-        break;
-      }
-      case TRACE_TYPE::passthrough_trace: {
-        if (record.event() == InstrumentationEventType::PASSTHROUGH_ENTRY ||
-            record.event() == InstrumentationEventType::PASSTHROUGH_EXIT) {
-          *clean_profiling_msg.add_records() = record;
+        LatencyHistogram histogram;
+        for (const auto& second : seconds) {
+          histogram.Merge(second.second);
         }
-        break;
+        cout << api->first << ":count=" << histogram.count << ",rate="
+             << fixed << setprecision(1)
+             << static_cast<double>(histogram.count) / window_seconds
+             << defaultfloat << "/s,p50=" << histogram.Percentile(50)
+             << ",p90=" << histogram.Percentile(90)
+             << ",p99=" << histogram.Percentile(99)
+             << ",max=" << histogram.max << endl;
+        ++api;
       }
-      default:
-        cerr << "Unknow trace type: " << trace_type << endl;
+    }
+    usleep(kFollowIntervalMs * 1000);
+  }
+}
+
+// Returns the values of vars in the single line text format, separated by
+// commas, each truncated as in an exported trace.
+static string formatSlowCallValues(
+    const google::protobuf::RepeatedPtrField<VariableSpecificationMessage>&
+        vars,
+    const TextFormat::Printer& printer) {
+  string values;
+  for (int i = 0; i < vars.size(); i++) {
+    string value;
+    printer.PrintToString(vars.Get(i), &value);
+    // The single line format ends with a space.
+    if (!value.empty() && value.back() == ' ') value.pop_back();
+    if (value.size() > kMaxExportedArgSize) {
+      value.resize(kMaxExportedArgSize);
+      value += "...";
+    }
+    if (i > 0) values.push_back(',');
+    values += "{" + value + "}";
+  }
+  return values;
+}
+
+void VtsTraceProcessor::FindSlowCalls(const string& trace_file, int top_count,
+                                      int64_t threshold_ns) {
+  // A call, ordered by latency then timestamp.
+  struct SlowCall {
+    int64_t latency;
+    int64_t timestamp;
+    size_t entry_record_index;
+    size_t exit_record_index;
+    bool operator>(const SlowCall& other) const {
+      return tie(latency, timestamp) > tie(other.latency, other.timestamp);
+    }
+  };
+  // Indexed by API id. Each heap keeps the top_count slowest calls of the
+  // API, the fastest of them on top.
+  vector<string> api_names;
+  vector<long> call_counts;
+  vector<long> outlier_counts;
+  vector<priority_queue<SlowCall, vector<SlowCall>, greater<SlowCall>>>
+      slowest_calls;
+
+  CallMatcher matcher;
+  size_t record_index = 0;
+  auto on_call = [&](const VtsProfilingRecord& record,
+                     const string& full_api_name, uint32_t api_id,
+                     int64_t entry_timestamp) {
+    if (api_id >= api_names.size()) {
+      api_names.resize(api_id + 1);
+      call_counts.resize(api_id + 1);
+      outlier_counts.resize(api_id + 1);
+      slowest_calls.resize(api_id + 1);
+    }
+    api_names[api_id] = full_api_name;
+    call_counts[api_id]++;
+    SlowCall call = {record.timestamp() - entry_timestamp, entry_timestamp,
+                     matcher.LastEntryRecordIndex(), record_index};
+    if (threshold_ns > 0 && call.latency >= threshold_ns) {
+      outlier_counts[api_id]++;
+      cout << "outlier:" << full_api_name << ":latency=" << call.latency
+           << ",timestamp=" << call.timestamp << ",thread_id="
+           << record.thread_id() << endl;
+    }
+    auto& heap = slowest_calls[api_id];
+    if (heap.size() < static_cast<size_t>(top_count)) {
+      heap.push(call);
+    } else if (top_count > 0 && call > heap.top()) {
+      heap.pop();
+      heap.push(call);
+    }
+  };
+  if (!ParseBinaryTrace(trace_file, false, false, true,
+                        [&](const VtsProfilingRecord& record) {
+                          matcher.AddRecord(record, GetFullApiStr(record),
+                                            on_call);
+                          record_index++;
+                        })) {
+    cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
+    return;
+  }
+
+  // The slowest calls of each API, slowest first, and the records to read.
+  vector<vector<SlowCall>> sorted_calls(slowest_calls.size());
+  set<size_t> record_indexes;
+  for (size_t api_id = 0; api_id < slowest_calls.size(); api_id++) {
+    auto& heap = slowest_calls[api_id];
+    while (!heap.empty()) {
+      sorted_calls[api_id].push_back(heap.top());
+      record_indexes.insert(heap.top().entry_record_index);
+      record_indexes.insert(heap.top().exit_record_index);
+      heap.pop();
+    }
+    reverse(sorted_calls[api_id].begin(), sorted_calls[api_id].end());
+  }
+  unordered_map<size_t, VtsProfilingRecord> records;
+  unique_ptr<VtsTraceReader> reader = VtsTraceReader::Open(trace_file, false);
+  if (reader) {
+    for (size_t index : record_indexes) {
+      if (!reader->ReadRecord(index, &records[index])) {
+        cerr << __func__ << ": Failed to read record " << index
+             << " of trace file: " << trace_file << endl;
         return;
+      }
+    }
+  } else {
+    record_index = 0;
+    if (!ParseBinaryTrace(trace_file, false, false, false,
+                          [&](const VtsProfilingRecord& record) {
+                            if (record_indexes.count(record_index++)) {
+                              records[record_index - 1] = record;
+                            }
+                          })) {
+      cerr << __func__ << ": Failed to parse trace file: " << trace_file
+           << endl;
+      return;
     }
   }
-  string tmp_file = trace_file + "_tmp";
-  if (!WriteProfilingMsg(tmp_file, clean_profiling_msg)) {
-    cerr << __func__ << ": Failed to write new trace file: " << tmp_file
+
+  TextFormat::Printer printer;
+  printer.SetSingleLineMode(true);
+  map<string, uint32_t> sorted_api_ids;
+  for (uint32_t api_id = 0; api_id < api_names.size(); api_id++) {
+    if (call_counts[api_id] > 0) {
+      sorted_api_ids.emplace(api_names[api_id], api_id);
+    }
+  }
+  for (const auto& api : sorted_api_ids) {
+    cout << api.first << ":count=" << call_counts[api.second];
+    if (threshold_ns > 0) {
+      cout << ",outliers=" << outlier_counts[api.second];
+    }
+    cout << endl;
+    for (const SlowCall& call : sorted_calls[api.second]) {
+      const VtsProfilingRecord& entry = records[call.entry_record_index];
+      const VtsProfilingRecord& exit = records[call.exit_record_index];
+      cout << "  latency=" << call.latency << ",timestamp=" << call.timestamp
+           << ",thread_id=" << entry.thread_id() << ",args=["
+           << formatSlowCallValues(entry.func_msg().arg(), printer)
+           << "],returns=["
+           << formatSlowCallValues(exit.func_msg().return_type_hidl(), printer)
+           << "]" << endl;
+    }
+  }
+}
+
+void VtsTraceProcessor::CorrelateTraces(const string& client_trace_file,
+                                        const string& server_trace_file,
+                                        bool verbose) {
+  // The entry and exit timestamps of a call.
+  struct CallWindow {
+    int64_t entry;
+    int64_t exit;
+    bool operator<(const CallWindow& other) const {
+      return entry < other.entry;
+    }
+  };
+  // The calls of each API, on each side.
+  map<string, vector<CallWindow>> client_calls;
+  map<string, vector<CallWindow>> server_calls;
+  // Returns the on_call of ParseTraceCalls adding the calls that end with
+  // exit_event to calls.
+  auto add_calls = [](InstrumentationEventType exit_event,
+                      map<string, vector<CallWindow>>* calls) {
+    return [exit_event, calls](const VtsProfilingRecord& record,
+                               const string& full_api_name, uint32_t,
+                               int64_t entry_timestamp) {
+      if (record.event() == exit_event) {
+        (*calls)[full_api_name].push_back(
+            {entry_timestamp, record.timestamp()});
+      }
+    };
+  };
+  if (!ParseTraceCalls(server_trace_file, nullptr,
+                       add_calls(InstrumentationEventType::SERVER_API_EXIT,
+                                 &server_calls))) {
+    cerr << __func__ << ": Failed to parse trace file: " << server_trace_file
          << endl;
     return;
   }
-  if (rename(tmp_file.c_str(), trace_file.c_str())) {
-    cerr << __func__ << ": Failed to replace old trace file: " << trace_file
+  if (!ParseTraceCalls(client_trace_file, nullptr,
+                       add_calls(InstrumentationEventType::CLIENT_API_EXIT,
+                                 &client_calls))) {
+    cerr << __func__ << ": Failed to parse trace file: " << client_trace_file
          << endl;
     return;
   }
-}
 
-void VtsTraceProcessor::CleanupTraces(const string& path) {
-  struct stat path_stat;
-  stat(path.c_str(), &path_stat);
-  if (S_ISREG(path_stat.st_mode)) {
-    CleanupTraceFile(path);
-  } else if (S_ISDIR(path_stat.st_mode)) {
-    DIR* dir = opendir(path.c_str());
-    struct dirent* file;
-    while ((file = readdir(dir)) != NULL) {
-      if (file->d_type == DT_REG) {
-        string trace_file = path;
-        if (path.substr(path.size() - 1) != "/") {
-          trace_file += "/";
+  LatencyHistogram all_total, all_hal, all_overhead;
+  long all_count = 0;
+  for (auto& api : client_calls) {
+    vector<CallWindow>& clients = api.second;
+    vector<CallWindow>& servers = server_calls[api.first];
+    sort(clients.begin(), clients.end());
+    sort(servers.begin(), servers.end());
+    // A client call is joined with the first server call of the same API
+    // that is not joined yet and runs within it. The calls of the same API
+    // from several threads may overlap, so the server calls between the
+    // entry and the exit of the client call are scanned.
+    vector<bool> joined(servers.size(), false);
+    size_t first_server = 0;
+    LatencyHistogram total, hal, overhead;
+    for (const CallWindow& client : clients) {
+      while (first_server < servers.size() &&
+             (joined[first_server] ||
+              servers[first_server].entry < client.entry)) {
+        first_server++;
+      }
+      int64_t hal_latency = -1;
+      for (size_t i = first_server;
+           i < servers.size() && servers[i].entry <= client.exit; i++) {
+        if (!joined[i] && servers[i].exit <= client.exit) {
+          joined[i] = true;
+          hal_latency = servers[i].exit - servers[i].entry;
+          break;
+        }
+      }
+      int64_t total_latency = client.exit - client.entry;
+      if (verbose) {
+        cout << api.first << ":total=" << total_latency;
+        if (hal_latency >= 0) {
+          cout << ",hal=" << hal_latency
+               << ",overhead=" << total_latency - hal_latency;
+        } else {
+          cout << ",hal=unmatched";
         }
-        trace_file += file->d_name;
-        CleanupTraceFile(trace_file);
+        cout << endl;
+      }
+      if (hal_latency >= 0) {
+        total.Add(total_latency);
+        hal.Add(hal_latency);
+        overhead.Add(total_latency - hal_latency);
+        all_total.Add(total_latency);
+        all_hal.Add(hal_latency);
+        all_overhead.Add(total_latency - hal_latency);
       }
     }
+    all_count += clients.size();
+    if (!verbose) {
+      PrintCorrelatedLatencies(api.first, clients.size(), total, hal,
+                               overhead);
+    }
+  }
+  if (!verbose) {
+    PrintCorrelatedLatencies("all", all_count, all_total, all_hal,
+                             all_overhead);
   }
 }
 
-void VtsTraceProcessor::ProcessTraceForLatencyProfiling(
-    const string& trace_file) {
-  VtsProfilingMessage profiling_msg;
-  if (!ParseBinaryTrace(trace_file, false, false, true, &profiling_msg)) {
-    cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
+// Returns the entry timestamps of the calls of an API given by event type,
+// of the first of the given event types that has any.
+static const vector<int64_t>* selectEntryTimestamps(
+    const map<InstrumentationEventType, vector<int64_t>>& timestamps,
+    const vector<InstrumentationEventType>& events) {
+  for (InstrumentationEventType event : events) {
+    auto found = timestamps.find(event);
+    if (found != timestamps.end()) {
+      return &found->second;
+    }
+  }
+  return nullptr;
+}
+
+void VtsTraceProcessor::ProfileCallbackLatency(const string& path,
+                                               const string& rules_file,
+                                               bool verbose) {
+  ifstream rules_input(rules_file);
+  if (!rules_input) {
+    cerr << __func__ << ": Failed to open rules file: " << rules_file << endl;
     return;
   }
-  if (!profiling_msg.records_size()) return;
-  if (profiling_msg.records(0).event() ==
-          InstrumentationEventType::PASSTHROUGH_ENTRY ||
-      profiling_msg.records(0).event() ==
-          InstrumentationEventType::PASSTHROUGH_EXIT) {
-    cout << "hidl_hal_mode:passthrough" << endl;
+  // The request and callback APIs of each rule.
+  vector<pair<string, string>> rules;
+  set<string> apis;
+  string line;
+  while (getline(rules_input, line)) {
+    istringstream fields(line);
+    string request, callback, extra;
+    if (!(fields >> request) || request[0] == '#') {
+      continue;
+    }
+    if (!(fields >> callback) || fields >> extra) {
+      cerr << __func__ << ": Malformed rule: " << line << endl;
+      return;
+    }
+    rules.emplace_back(request, callback);
+    apis.insert(request);
+    apis.insert(callback);
+  }
+
+  vector<string> trace_files;
+  struct stat path_stat;
+  if (stat(path.c_str(), &path_stat) == 0 && S_ISDIR(path_stat.st_mode)) {
+    trace_files = ListTraceFiles(path);
   } else {
-    cout << "hidl_hal_mode:binder" << endl;
+    trace_files.push_back(path);
+  }
+  // The entry timestamps of the calls of the APIs of the rules, by event.
+  map<string, map<InstrumentationEventType, vector<int64_t>>> entries;
+  auto on_record = [&](const VtsProfilingRecord& record) {
+    string full_api_name = GetFullApiStr(record);
+    if (apis.count(full_api_name)) {
+      entries[full_api_name][record.event()].push_back(record.timestamp());
+    }
+  };
+  for (const string& trace_file : trace_files) {
+    if (!ParseBinaryTrace(trace_file, false, true, true, on_record)) {
+      cerr << __func__ << ": Failed to parse trace file: " << trace_file
+           << endl;
+      return;
+    }
   }
 
-  // stack to store all seen records.
-  vector<VtsProfilingRecord> seen_records;
-  // stack to store temp records that not processed.
-  vector<VtsProfilingRecord> pending_records;
-  for (const auto& record : profiling_msg.records()) {
-    if (isEntryEvent(record.event())) {
-      seen_records.emplace_back(record);
-    } else {
-      while (!seen_records.empty() &&
-             !isPairedRecord(seen_records.back(), record)) {
-        pending_records.emplace_back(seen_records.back());
-        seen_records.pop_back();
-      }
-      if (seen_records.empty()) {
-        cerr << "Could not found entry record for record: "
-             << record.DebugString() << endl;
+  const vector<InstrumentationEventType> request_events = {
+      InstrumentationEventType::CLIENT_API_ENTRY,
+      InstrumentationEventType::PASSTHROUGH_ENTRY,
+      InstrumentationEventType::SERVER_API_ENTRY,
+  };
+  const vector<InstrumentationEventType> callback_sender_events = {
+      InstrumentationEventType::PASSTHROUGH_ENTRY,
+      InstrumentationEventType::CLIENT_API_ENTRY,
+  };
+  for (const auto& rule : rules) {
+    const string& request_api = rule.first;
+    const string& callback_api = rule.second;
+    vector<int64_t> requests;
+    vector<int64_t> callbacks;
+    if (const vector<int64_t>* timestamps =
+            selectEntryTimestamps(entries[request_api], request_events)) {
+      requests = *timestamps;
+    }
+    // The server and async callback entries are both on the receiving side.
+    const auto& callback_entries = entries[callback_api];
+    for (InstrumentationEventType event :
+         {InstrumentationEventType::SERVER_API_ENTRY,
+          InstrumentationEventType::ASYNC_CALLBACK_ENTRY}) {
+      auto found = callback_entries.find(event);
+      if (found != callback_entries.end()) {
+        callbacks.insert(callbacks.end(), found->second.begin(),
+                         found->second.end());
+      }
+    }
+    if (callbacks.empty()) {
+      if (const vector<int64_t>* timestamps = selectEntryTimestamps(
+              callback_entries, callback_sender_events)) {
+        callbacks = *timestamps;
+      }
+    }
+    sort(requests.begin(), requests.end());
+    sort(callbacks.begin(), callbacks.end());
+
+    string name = request_api + "->" + callback_api;
+    LatencyHistogram histogram;
+    long unsolicited_count = 0;
+    size_t next_request = 0;
+    // The requests before the current callback that are not paired yet are
+    // those from first_pending to next_request.
+    size_t first_pending = 0;
+    for (int64_t callback : callbacks) {
+      while (next_request < requests.size() &&
+             requests[next_request] <= callback) {
+        next_request++;
+      }
+      if (first_pending == next_request) {
+        unsolicited_count++;
         continue;
+      }
+      int64_t latency = callback - requests[first_pending++];
+      if (verbose) {
+        cout << name << ":" << latency << endl;
       } else {
-        // Found the paired entry record, calculate the latency.
-        VtsProfilingRecord entry_record = seen_records.back();
-        seen_records.pop_back();
-        string full_api_name = GetFullApiStr(record);
-        int64_t start_timestamp = entry_record.timestamp();
-        int64_t end_timestamp = record.timestamp();
-        int64_t latency = end_timestamp - start_timestamp;
-        // Negative latency check.
-        if (latency < 0) {
-          cerr << __func__ << ": got negative latency for " << full_api_name
-               << endl;
-          exit(-1);
-        }
-        cout << full_api_name << ":" << latency << endl;
-        while (!pending_records.empty()) {
-          seen_records.emplace_back(pending_records.back());
-          pending_records.pop_back();
-        }
+        histogram.Add(latency);
+      }
+    }
+    if (verbose) {
+      continue;
+    }
+    cout << name << ":requests=" << requests.size()
+         << ",matched=" << histogram.count
+         << ",unsolicited=" << unsolicited_count;
+    if (histogram.count > 0) {
+      cout << ",min=" << histogram.min
+           << ",mean=" << histogram.sum / histogram.count
+           << ",p50=" << histogram.Percentile(50)
+           << ",p90=" << histogram.Percentile(90)
+           << ",p99=" << histogram.Percentile(99) << ",max=" << histogram.max;
+    }
+    cout << endl;
+  }
+}
+
+void VtsTraceProcessor::PrintCorrelatedLatencies(
+    const string& name, long count, const LatencyHistogram& total,
+    const LatencyHistogram& hal, const LatencyHistogram& overhead) {
+  cout << name << ":count=" << count << ",matched=" << total.count;
+  const pair<const char*, const LatencyHistogram*> histograms[] = {
+      {"total", &total}, {"hal", &hal}, {"overhead", &overhead}};
+  for (const auto& histogram : histograms) {
+    if (histogram.second->count == 0) continue;
+    cout << "," << histogram.first
+         << "_mean=" << histogram.second->sum / histogram.second->count << ","
+         << histogram.first << "_p50=" << histogram.second->Percentile(50)
+         << "," << histogram.first
+         << "_p99=" << histogram.second->Percentile(99);
+  }
+  cout << endl;
+}
+
+void VtsTraceProcessor::CompareLatency(const string& base_trace_dir,
+                                       const string& new_trace_dir,
+                                       const string& output_file) {
+  // The files of both sets are processed by the same jobs, the base ones
+  // first. Each file is profiled on its own and merged into its set, so
+  // that only a histogram per API is kept.
+  vector<string> trace_files = ListTraceFiles(base_trace_dir);
+  size_t base_file_count = trace_files.size();
+  vector<string> new_trace_files = ListTraceFiles(new_trace_dir);
+  trace_files.insert(trace_files.end(), new_trace_files.begin(),
+                     new_trace_files.end());
+  if (base_file_count == 0 || base_file_count == trace_files.size()) {
+    cerr << __func__ << ": No trace file under " << base_trace_dir << " or "
+         << new_trace_dir << endl;
+    return;
+  }
+  map<string, LatencyHistogram> base_histograms;
+  map<string, LatencyHistogram> new_histograms;
+  mutex histograms_mutex;
+  RunJobs(trace_files.size(), [&](size_t i) {
+    vector<string> api_names;
+    vector<LatencyHistogram> histograms;
+    auto on_call = [&](const VtsProfilingRecord& record,
+                       const string& full_api_name, uint32_t api_id,
+                       int64_t entry_timestamp) {
+      if (api_id >= histograms.size()) {
+        api_names.resize(api_id + 1);
+        histograms.resize(api_id + 1);
       }
+      api_names[api_id] = full_api_name;
+      int64_t latency = record.timestamp() - entry_timestamp;
+      if (latency < 0) {
+        cerr << "CompareLatency: got negative latency for " << full_api_name
+             << " in " << trace_files[i] << endl;
+        return;
+      }
+      histograms[api_id].Add(latency);
+    };
+    if (!ParseTraceCalls(trace_files[i], nullptr, on_call)) {
+      cerr << "CompareLatency: Failed to parse trace file: "
+           << trace_files[i] << endl;
+      return;
+    }
+    lock_guard<mutex> lock(histograms_mutex);
+    map<string, LatencyHistogram>& merged =
+        i < base_file_count ? base_histograms : new_histograms;
+    for (size_t api_id = 0; api_id < api_names.size(); api_id++) {
+      merged[api_names[api_id]].Merge(histograms[api_id]);
+    }
+  });
+
+  struct Regression {
+    string api;
+    double median_shift;
+    double p_value;
+  };
+  vector<Regression> regressions;
+  int compared_api_count = 0;
+  for (const auto& api : new_histograms) {
+    auto base = base_histograms.find(api.first);
+    if (base == base_histograms.end() || base->second.count == 0 ||
+        api.second.count == 0) {
+      continue;
+    }
+    compared_api_count++;
+    int64_t base_median = base->second.Percentile(50);
+    int64_t new_median = api.second.Percentile(50);
+    double median_shift =
+        base_median > 0
+            ? static_cast<double>(new_median - base_median) / base_median
+            : (new_median > 0 ? HUGE_VAL : 0);
+    if (median_shift < kMinRegressionMedianShift) {
+      continue;
     }
+    double p_value = api.second.ShiftPValue(base->second);
+    if (p_value < kMaxRegressionPValue) {
+      regressions.push_back({api.first, median_shift, p_value});
+    }
+  }
+  stable_sort(regressions.begin(), regressions.end(),
+              [](const Regression& a, const Regression& b) {
+                return a.median_shift > b.median_shift;
+              });
+
+  TestReportMessage report;
+  for (const Regression& regression : regressions) {
+    const LatencyHistogram& base = base_histograms[regression.api];
+    const LatencyHistogram& current = new_histograms[regression.api];
+    cout << regression.api << ":base_p50=" << base.Percentile(50)
+         << ",new_p50=" << current.Percentile(50)
+         << ",median_shift=" << fixed << setprecision(1)
+         << regression.median_shift * 100 << "%"
+         << ",p_value=" << scientific << setprecision(2)
+         << regression.p_value << defaultfloat << endl;
+
+    ProfilingReportMessage* profiling = report.add_profiling();
+    profiling->set_name(regression.api);
+    profiling->set_type(VTS_PROFILING_TYPE_LABELED_VECTOR);
+    profiling->set_regression_mode(VTS_REGRESSION_MODE_INCREASING);
+    const pair<const char*, const LatencyHistogram*> sets[] = {
+        {"base", &base}, {"new", &current}};
+    for (const auto& set : sets) {
+      profiling->add_label(string(set.first) + "_count");
+      profiling->add_value(set.second->count);
+      for (int percent : {50, 90, 99}) {
+        profiling->add_label(string(set.first) + "_p" + to_string(percent));
+        profiling->add_value(set.second->Percentile(percent));
+      }
+    }
+    profiling->set_y_axis_label("latency (ns)");
+    ostringstream options;
+    options << "median_shift_percent=" << fixed << setprecision(1)
+            << regression.median_shift * 100;
+    profiling->add_options(options.str());
+    options.str("");
+    options << "p_value=" << scientific << setprecision(2)
+            << regression.p_value;
+    profiling->add_options(options.str());
   }
+  cout << "compared_apis=" << compared_api_count
+       << ",regressions=" << regressions.size() << endl;
+
+  ofstream fout;
+  fout.open(output_file);
+  fout << report.DebugString();
+  fout.close();
 }
 
 void VtsTraceProcessor::DedupTraces(const string& trace_dir) {
@@ -313,49 +2040,51 @@ void VtsTraceProcessor::DedupTraces(const string& trace_dir) {
     cerr << trace_dir << "does not exist." << endl;
     return;
   }
-  vector<VtsProfilingMessage> seen_msgs;
+  closedir(dir);
+  vector<string> trace_files = ListTraceFiles(trace_dir);
+  // The traces are hashed in parallel, then compared in order so that the
+  // first of the duplicate traces is the one kept whatever the number of
+  // jobs. Only the traces with the same hash are compared in full.
+  vector<uint64_t> hashes(trace_files.size());
+  vector<char> parsed(trace_files.size(), false);
+  vector<long> record_counts(trace_files.size(), 0);
+  RunJobs(trace_files.size(), [&](size_t i) {
+    parsed[i] = HashTrace(trace_files[i], &hashes[i], &record_counts[i]);
+  });
+  // Indexes of the unique trace files, by hash.
+  unordered_map<uint64_t, vector<size_t>> unique_traces;
   vector<string> duplicate_trace_files;
-  struct dirent* file;
   long total_trace_num = 0;
   long duplicat_trace_num = 0;
-  while ((file = readdir(dir)) != NULL) {
-    if (file->d_type == DT_REG) {
-      total_trace_num++;
-      string trace_file = trace_dir;
-      if (trace_dir.substr(trace_dir.size() - 1) != "/") {
-        trace_file += "/";
-      }
-      trace_file += file->d_name;
-      VtsProfilingMessage profiling_msg;
-      if (!ParseBinaryTrace(trace_file, true, true, false, &profiling_msg)) {
-        cerr << "Failed to parse trace file: " << trace_file << endl;
-        return;
-      }
-      if (!profiling_msg.records_size()) {  // empty trace file
-        duplicate_trace_files.push_back(trace_file);
-        duplicat_trace_num++;
-        continue;
+  for (size_t i = 0; i < trace_files.size(); i++) {
+    total_trace_num++;
+    if (!parsed[i]) {
+      cerr << "Failed to parse trace file: " << trace_files[i] << endl;
+      return;
+    }
+    // Empty trace files are duplicates too.
+    bool duplicate = record_counts[i] == 0;
+    if (!duplicate) {
+      vector<size_t>& bucket = unique_traces[hashes[i]];
+      for (size_t unique_trace : bucket) {
+        if (IsSameTrace(trace_files[unique_trace], trace_files[i])) {
+          duplicate = true;
+          break;
+        }
       }
-      auto found =
-          find_if(seen_msgs.begin(), seen_msgs.end(),
-                  [&profiling_msg](const VtsProfilingMessage& seen_msg) {
-                    std::string str_profiling_msg;
-                    std::string str_seen_msg;
-                    profiling_msg.SerializeToString(&str_profiling_msg);
-                    seen_msg.SerializeToString(&str_seen_msg);
-                    return (str_profiling_msg == str_seen_msg);
-                  });
-      if (found == seen_msgs.end()) {
-        seen_msgs.push_back(profiling_msg);
-      } else {
-        duplicate_trace_files.push_back(trace_file);
-        duplicat_trace_num++;
+      if (!duplicate) {
+        bucket.push_back(i);
       }
     }
+    if (duplicate) {
+      duplicate_trace_files.push_back(trace_files[i]);
+      duplicat_trace_num++;
+    }
   }
   for (const string& duplicate_trace : duplicate_trace_files) {
     cout << "deleting duplicate trace file: " << duplicate_trace << endl;
     remove(duplicate_trace.c_str());
+    remove(VtsTraceReader::IndexFileName(duplicate_trace).c_str());
   }
   cout << "Num of traces processed: " << total_trace_num << endl;
   cout << "Num of duplicate trace deleted: " << duplicat_trace_num << endl;
@@ -374,12 +2103,12 @@ void VtsTraceProcessor::SelectTraces(const string& coverage_file_dir,
   DIR* trace_dir = opendir(trace_file_dir.c_str());
   if (trace_dir == 0) {
     cerr << __func__ << ": " << trace_file_dir << " does not exist." << endl;
+    closedir(coverage_dir);
     return;
   }
-  map<string, CoverageInfo> original_coverages;
-  map<string, CoverageInfo> selected_coverages;
-
-  // Parse all the coverage files and store them into original_coverage_msgs.
+  closedir(trace_dir);
+  vector<string> coverage_file_names;
+  vector<string> coverage_files;
   struct dirent* file;
   while ((file = readdir(coverage_dir)) != NULL) {
     if (file->d_type == DT_REG) {
@@ -387,32 +2116,237 @@ void VtsTraceProcessor::SelectTraces(const string& coverage_file_dir,
       if (coverage_file_dir.substr(coverage_file_dir.size() - 1) != "/") {
         coverage_file += "/";
       }
-      string coverage_file_base_name = file->d_name;
-      coverage_file += coverage_file_base_name;
-      TestReportMessage coverage_msg;
-      coverage_processor_->ParseCoverageData(coverage_file, &coverage_msg);
+      coverage_file += file->d_name;
+      coverage_file_names.push_back(file->d_name);
+      coverage_files.push_back(coverage_file);
+    }
+  }
+  closedir(coverage_dir);
 
-      string trace_file = trace_file_dir;
-      if (trace_file_dir.substr(trace_file_dir.size() - 1) != "/") {
-        trace_file += "/";
-      }
-      string trace_file_base_name = GetTraceFileName(coverage_file_base_name);
-      trace_file += trace_file_base_name;
-      ifstream in(trace_file, ifstream::binary | ifstream::ate);
-      if (!in.good()) {
-        cerr << "trace file: " << trace_file << " does not exists." << endl;
-        continue;
-      }
-      long trace_file_size = in.tellg();
+  // Parse all the coverage files in parallel, then index their source files
+  // in order.
+  vector<CoverageInfo> coverage_infos(coverage_files.size());
+  vector<vector<string>> file_paths(coverage_files.size());
+  RunJobs(coverage_files.size(), [&](size_t i) {
+    TestReportMessage coverage_msg;
+    coverage_processor_->ParseCoverageData(coverage_files[i], &coverage_msg);
+
+    string trace_file = trace_file_dir;
+    if (trace_file_dir.substr(trace_file_dir.size() - 1) != "/") {
+      trace_file += "/";
+    }
+    trace_file += GetTraceFileName(coverage_file_names[i]);
+    CoverageInfo& coverage_info = coverage_infos[i];
+    coverage_info.trace_file_name = trace_file;
+    coverage_info.trace_file_size = -1;
+    ifstream in(trace_file, ifstream::binary | ifstream::ate);
+    if (!in.good()) {
+      return;
+    }
+    coverage_info.trace_file_size = in.tellg();
+
+    for (const auto& coverage : coverage_msg.coverage()) {
+      CoverageInfo::FileCoverage file_coverage;
+      file_paths[i].push_back(coverage.file_path());
+      file_coverage.covered_line_count = coverage.covered_line_count();
+      lineCountsToBitset(coverage.line_coverage_vector().data(),
+                         coverage.line_coverage_vector_size(),
+                         &file_coverage.covered_lines);
+      coverage_info.file_coverages.push_back(move(file_coverage));
+    }
+    coverage_info.total_line_count =
+        coverage_processor_->GetTotalCodeLine(coverage_msg);
+  });
+
+  map<string, CoverageInfo> original_coverages;
+  // Index of each file path seen in the coverage reports.
+  map<string, size_t> file_indexes;
+  for (size_t i = 0; i < coverage_files.size(); i++) {
+    CoverageInfo& coverage_info = coverage_infos[i];
+    if (coverage_info.trace_file_size < 0) {
+      cerr << "trace file: " << coverage_info.trace_file_name
+           << " does not exists." << endl;
+      continue;
+    }
+    for (size_t j = 0; j < file_paths[i].size(); j++) {
+      coverage_info.file_coverages[j].file_index =
+          file_indexes.emplace(file_paths[i][j], file_indexes.size())
+              .first->second;
+    }
+    original_coverages[coverage_files[i]] = move(coverage_info);
+  }
+  coverage_infos.clear();
+  file_paths.clear();
+
+  // The coverage files that share no source file, e.g. those of different
+  // HALs, do not change each other's coverage delta, so the selection is
+  // done separately for each group of coverage files connected by their
+  // source files, and selects the same files as a single selection would.
+  vector<size_t> file_groups(file_indexes.size());
+  for (size_t i = 0; i < file_groups.size(); i++) {
+    file_groups[i] = i;
+  }
+  auto find_group = [&](size_t i) {
+    while (file_groups[i] != i) {
+      i = file_groups[i] = file_groups[file_groups[i]];
+    }
+    return i;
+  };
+  for (const auto& it : original_coverages) {
+    const auto& file_coverages = it.second.file_coverages;
+    for (size_t i = 1; i < file_coverages.size(); i++) {
+      file_groups[find_group(file_coverages[i].file_index)] =
+          find_group(file_coverages[0].file_index);
+    }
+  }
+  vector<vector<const string*>> partitions;
+  map<size_t, size_t> partition_indexes;
+  for (const auto& it : original_coverages) {
+    // Files without coverage are never selected.
+    if (it.second.file_coverages.empty()) {
+      continue;
+    }
+    size_t group = find_group(it.second.file_coverages[0].file_index);
+    size_t index =
+        partition_indexes.emplace(group, partitions.size()).first->second;
+    if (index == partitions.size()) {
+      partitions.emplace_back();
+    }
+    partitions[index].push_back(&it.first);
+  }
+
+  // The partitions use disjoint elements of covered_lines, so they can share
+  // it.
+  vector<vector<uint64_t>> covered_lines(file_indexes.size());
+  vector<map<string, long>> partition_selections(partitions.size());
+  RunJobs(partitions.size(), [&](size_t i) {
+    SelectCoverages(partitions[i], original_coverages, metric, &covered_lines,
+                    &partition_selections[i]);
+  });
+  // Number of lines newly covered by each selected coverage file.
+  map<string, long> selected_coverages;
+  for (const auto& selection : partition_selections) {
+    selected_coverages.insert(selection.begin(), selection.end());
+  }
+
+  // Calculate the total code lines and total line covered.
+  long total_lines = 0;
+  long total_lines_covered = 0;
+  for (auto it = selected_coverages.begin(); it != selected_coverages.end();
+       ++it) {
+    const CoverageInfo& coverage = original_coverages[it->first];
+    cout << "select trace file: " << coverage.trace_file_name << endl;
+    total_lines_covered += it->second;
+    if (coverage.total_line_count > total_lines) {
+      total_lines = coverage.total_line_count;
+    }
+  }
+  double coverage_rate = (double)total_lines_covered / total_lines;
+  cout << "total lines covered: " << total_lines_covered << endl;
+  cout << "total lines: " << total_lines << endl;
+  cout << "coverage rate: " << coverage_rate << endl;
+}
+
+void VtsTraceProcessor::SelectCorpus(const string& coverage_file_dir,
+                                     const string& corpus_dir,
+                                     const string& output_dir,
+                                     TraceSelectionMetric metric) {
+  DIR* coverage_dir = opendir(coverage_file_dir.c_str());
+  if (coverage_dir == 0) {
+    cerr << __func__ << ": " << coverage_file_dir << " does not exist." << endl;
+    return;
+  }
+  vector<string> input_names;
+  struct dirent* file;
+  while ((file = readdir(coverage_dir)) != NULL) {
+    if (file->d_type == DT_REG) {
+      input_names.push_back(file->d_name);
+    }
+  }
+  closedir(coverage_dir);
+  sort(input_names.begin(), input_names.end());
+
+  // All the inputs cover the same edges of a single "file", index 0.
+  vector<CoverageInfo> coverage_infos(input_names.size());
+  RunJobs(input_names.size(), [&](size_t i) {
+    CoverageInfo& coverage_info = coverage_infos[i];
+    coverage_info.trace_file_name = corpus_dir + "/" + input_names[i];
+    coverage_info.trace_file_size = -1;
+    ifstream input(coverage_info.trace_file_name,
+                   ifstream::binary | ifstream::ate);
+    if (!input.good()) {
+      return;
+    }
+    coverage_info.trace_file_size = input.tellg();
+
+    ifstream in(coverage_file_dir + "/" + input_names[i], ifstream::binary);
+    string counters((istreambuf_iterator<char>(in)),
+                    istreambuf_iterator<char>());
+    CoverageInfo::FileCoverage file_coverage;
+    file_coverage.file_index = 0;
+    edgeCountersToBitset(reinterpret_cast<const uint8_t*>(counters.data()),
+                         counters.size(), &file_coverage.covered_lines);
+    file_coverage.covered_line_count =
+        countCommonLines(file_coverage.covered_lines.data(),
+                         file_coverage.covered_lines.data(),
+                         file_coverage.covered_lines.size());
+    coverage_info.total_line_count = counters.size();
+    coverage_info.file_coverages.push_back(move(file_coverage));
+  });
+
+  map<string, CoverageInfo> coverages;
+  vector<const string*> coverage_files;
+  long total_size = 0;
+  for (size_t i = 0; i < input_names.size(); i++) {
+    if (coverage_infos[i].trace_file_size < 0) {
+      cerr << "input file: " << coverage_infos[i].trace_file_name
+           << " does not exists." << endl;
+      continue;
+    }
+    total_size += coverage_infos[i].trace_file_size;
+    coverage_files.push_back(
+        &coverages.emplace(input_names[i], move(coverage_infos[i]))
+             .first->first);
+  }
+  coverage_infos.clear();
 
-      CoverageInfo coverage_info;
-      coverage_info.coverage_msg = coverage_msg;
-      coverage_info.trace_file_name = trace_file;
-      coverage_info.trace_file_size = trace_file_size;
+  vector<vector<uint64_t>> covered_edges(1);
+  map<string, long> selected_inputs;
+  SelectCoverages(coverage_files, coverages, metric, &covered_edges,
+                  &selected_inputs);
 
-      original_coverages[coverage_file] = coverage_info;
+  long total_edges = 0;
+  long total_edges_covered = 0;
+  long selected_size = 0;
+  for (const auto& it : selected_inputs) {
+    const CoverageInfo& coverage = coverages[it.first];
+    cout << "select input file: " << coverage.trace_file_name << endl;
+    total_edges_covered += it.second;
+    selected_size += coverage.trace_file_size;
+    total_edges = max(total_edges, coverage.total_line_count);
+    if (!output_dir.empty()) {
+      ifstream in(coverage.trace_file_name, ifstream::binary);
+      ofstream out(output_dir + "/" + it.first, ofstream::binary);
+      out << in.rdbuf();
+      if (!out.good()) {
+        cerr << __func__ << ": Failed to copy input file: "
+             << coverage.trace_file_name << " to " << output_dir << endl;
+      }
     }
   }
+  cout << "inputs: " << coverages.size() << " (" << total_size << " bytes)"
+       << endl;
+  cout << "selected inputs: " << selected_inputs.size() << " ("
+       << selected_size << " bytes)" << endl;
+  cout << "total edges covered: " << total_edges_covered << endl;
+  cout << "total edges: " << total_edges << endl;
+}
+
+void VtsTraceProcessor::SelectCoverages(
+    const vector<const string*>& coverage_files,
+    const map<string, CoverageInfo>& coverages, TraceSelectionMetric metric,
+    vector<vector<uint64_t>>* covered_lines,
+    map<string, long>* selected_coverages) {
   // Greedy algorithm that selects coverage files with the maximal code
   // coverage delta at each iteration. Note: Not guaranteed to generate the
   // optimal set. Example (*: covered, -: not_covered) line#\coverage_file
@@ -424,69 +2358,84 @@ void VtsTraceProcessor::SelectTraces(const string& coverage_file_dir,
   //          5              -   -    *
   // This algorithm will select cov2, cov1, cov3 while optimal solution is:
   // cov1, cov3.
-  // double max_coverage_size_ratio = 0.0;
-  TestReportMessage selected_coverage_msg;
-  while (true) {
-    double max_selection_metric = 0.0;
-    string selected_coverage_file = "";
-    // Update the remaining coverage file in original_coverage_msgs.
-    for (auto it = original_coverages.begin(); it != original_coverages.end();
-         ++it) {
-      TestReportMessage cur_coverage_msg = it->second.coverage_msg;
-      for (const auto& ref_coverage : selected_coverage_msg.coverage()) {
-        for (int i = 0; i < cur_coverage_msg.coverage_size(); i++) {
-          CoverageReportMessage* coverage_to_be_updated =
-              cur_coverage_msg.mutable_coverage(i);
-          coverage_processor_->UpdateCoverageData(ref_coverage,
-                                                  coverage_to_be_updated);
-        }
-      }
-      it->second.coverage_msg = cur_coverage_msg;
-      long total_coverage_line =
-          coverage_processor_->GetTotalCoverageLine(cur_coverage_msg);
-      long trace_file_size = it->second.trace_file_size;
-      double coverage_size_ratio =
-          (double)total_coverage_line / trace_file_size;
-      if (metric == TraceSelectionMetric::MAX_COVERAGE) {
-        if (coverage_size_ratio > max_selection_metric) {
-          max_selection_metric = coverage_size_ratio;
-          selected_coverage_file = it->first;
-        }
-      } else if (metric == TraceSelectionMetric::MAX_COVERAGE_SIZE_RATIO) {
-        if (total_coverage_line > max_selection_metric) {
-          max_selection_metric = total_coverage_line;
-          selected_coverage_file = it->first;
-        }
+  //
+  // The coverage delta of a file can only decrease as files are selected, so
+  // the deltas are evaluated lazily: the candidate with the highest delta
+  // computed so far is only re-evaluated, and selected if its delta did not
+  // change. Ties go to the first coverage file by name.
+  struct Candidate {
+    double selection_metric;
+    const string* coverage_file;
+  };
+  auto lower_priority = [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.selection_metric < rhs.selection_metric ||
+           (lhs.selection_metric == rhs.selection_metric &&
+            *lhs.coverage_file > *rhs.coverage_file);
+  };
+  auto get_selection_metric = [&](const CoverageInfo& coverage,
+                                  long new_covered_line_count) {
+    if (metric == TraceSelectionMetric::MAX_COVERAGE) {
+      return (double)new_covered_line_count / coverage.trace_file_size;
+    }
+    return (double)new_covered_line_count;
+  };
+  priority_queue<Candidate, vector<Candidate>, decltype(lower_priority)>
+      candidates(lower_priority);
+  for (const string* coverage_file : coverage_files) {
+    const CoverageInfo& coverage = coverages.at(*coverage_file);
+    long new_covered_line_count =
+        GetNewCoveredLineCount(coverage, *covered_lines);
+    double selection_metric =
+        get_selection_metric(coverage, new_covered_line_count);
+    // Only files with a positive metric are ever selected.
+    if (selection_metric > 0) {
+      candidates.push({selection_metric, coverage_file});
+    }
+  }
+  while (!candidates.empty()) {
+    Candidate candidate = candidates.top();
+    candidates.pop();
+    const CoverageInfo& coverage = coverages.at(*candidate.coverage_file);
+    long new_covered_line_count =
+        GetNewCoveredLineCount(coverage, *covered_lines);
+    double selection_metric =
+        get_selection_metric(coverage, new_covered_line_count);
+    if (selection_metric != candidate.selection_metric) {
+      if (selection_metric > 0) {
+        candidates.push({selection_metric, candidate.coverage_file});
       }
+      continue;
     }
-    if (!max_selection_metric) {
-      break;
-    } else {
-      CoverageInfo selected_coverage =
-          original_coverages[selected_coverage_file];
-      selected_coverages[selected_coverage_file] = selected_coverage;
-      // Remove the coverage file from original_coverage_msgs.
-      original_coverages.erase(selected_coverage_file);
-      selected_coverage_msg = selected_coverage.coverage_msg;
+    (*selected_coverages)[*candidate.coverage_file] = new_covered_line_count;
+    for (const auto& file_coverage : coverage.file_coverages) {
+      vector<uint64_t>& lines = (*covered_lines)[file_coverage.file_index];
+      if (lines.size() < file_coverage.covered_lines.size()) {
+        lines.resize(file_coverage.covered_lines.size(), 0);
+      }
+      mergeBitsets(file_coverage.covered_lines.data(), lines.data(),
+                   file_coverage.covered_lines.size());
     }
   }
-  // Calculate the total code lines and total line covered.
-  long total_lines = 0;
-  long total_lines_covered = 0;
-  for (auto it = selected_coverages.begin(); it != selected_coverages.end();
-       ++it) {
-    cout << "select trace file: " << it->second.trace_file_name << endl;
-    TestReportMessage coverage_msg = it->second.coverage_msg;
-    total_lines_covered +=
-        coverage_processor_->GetTotalCoverageLine(coverage_msg);
-    if (coverage_processor_->GetTotalCodeLine(coverage_msg) > total_lines) {
-      total_lines = coverage_processor_->GetTotalCodeLine(coverage_msg);
+}
+
+long VtsTraceProcessor::GetNewCoveredLineCount(
+    const CoverageInfo& coverage,
+    const vector<vector<uint64_t>>& covered_lines) {
+  long new_covered_line_count = 0;
+  for (const auto& file_coverage : coverage.file_coverages) {
+    const vector<uint64_t>& lines = covered_lines[file_coverage.file_index];
+    long count =
+        file_coverage.covered_line_count -
+        countCommonLines(file_coverage.covered_lines.data(), lines.data(),
+                         min(lines.size(), file_coverage.covered_lines.size()));
+    if (count < 0) {
+      cerr << __func__ << ": covered_line_count should not be negative."
+           << endl;
+      exit(-1);
     }
+    new_covered_line_count += count;
   }
-  double coverage_rate = (double)total_lines_covered / total_lines;
-  cout << "total lines covered: " << total_lines_covered << endl;
-  cout << "total lines: " << total_lines << endl;
-  cout << "coverage rate: " << coverage_rate << endl;
+  return new_covered_line_count;
 }
 
 string VtsTraceProcessor::GetTraceFileName(const string& coverage_file_name) {
@@ -504,37 +2453,31 @@ bool VtsTraceProcessor::isEntryEvent(const InstrumentationEventType& event) {
   return false;
 }
 
-bool VtsTraceProcessor::isPairedRecord(const VtsProfilingRecord& entry_record,
-                                       const VtsProfilingRecord& exit_record) {
-  if (entry_record.package() != exit_record.package() ||
-      entry_record.version_major() != exit_record.version_major() ||
-      entry_record.version_minor() != exit_record.version_minor() ||
-      entry_record.interface() != exit_record.interface() ||
-      entry_record.func_msg().name() != exit_record.func_msg().name()) {
-    return false;
-  }
-  switch (entry_record.event()) {
-    case InstrumentationEventType::SERVER_API_ENTRY: {
-      if (exit_record.event() == InstrumentationEventType::SERVER_API_EXIT) {
-        return true;
-      }
-      break;
-    }
-    case InstrumentationEventType::CLIENT_API_ENTRY: {
-      if (exit_record.event() == InstrumentationEventType::CLIENT_API_EXIT)
-        return true;
-      break;
-    }
-    case InstrumentationEventType::PASSTHROUGH_ENTRY: {
-      if (exit_record.event() == InstrumentationEventType::PASSTHROUGH_EXIT)
-        return true;
-      break;
-    }
+bool VtsTraceProcessor::isCallEntryEvent(
+    const InstrumentationEventType& event) {
+  return isEntryEvent(event) ||
+         event == InstrumentationEventType::SYNC_CALLBACK_ENTRY ||
+         event == InstrumentationEventType::ASYNC_CALLBACK_ENTRY;
+}
+
+bool VtsTraceProcessor::isPairedEvent(
+    const InstrumentationEventType& entry_event,
+    const InstrumentationEventType& exit_event) {
+  switch (entry_event) {
+    case InstrumentationEventType::SERVER_API_ENTRY:
+      return exit_event == InstrumentationEventType::SERVER_API_EXIT;
+    case InstrumentationEventType::CLIENT_API_ENTRY:
+      return exit_event == InstrumentationEventType::CLIENT_API_EXIT;
+    case InstrumentationEventType::SYNC_CALLBACK_ENTRY:
+      return exit_event == InstrumentationEventType::SYNC_CALLBACK_EXIT;
+    case InstrumentationEventType::ASYNC_CALLBACK_ENTRY:
+      return exit_event == InstrumentationEventType::ASYNC_CALLBACK_EXIT;
+    case InstrumentationEventType::PASSTHROUGH_ENTRY:
+      return exit_event == InstrumentationEventType::PASSTHROUGH_EXIT;
     default:
-      cout << "Unsupported event: " << entry_record.event() << endl;
+      cout << "Unsupported event: " << entry_event << endl;
       return false;
   }
-  return false;
 }
 
 void VtsTraceProcessor::GetTestListForHal(const string& test_trace_dir,
@@ -545,21 +2488,56 @@ void VtsTraceProcessor::GetTestListForHal(const string& test_trace_dir,
   GetHalTraceMapping(test_trace_dir, &hal_trace_mapping);
 
   map<string, set<string>> test_list;
-  for (auto it = hal_trace_mapping.begin(); it != hal_trace_mapping.end();
-       it++) {
-    test_list[it->first] = set<string>();
-    vector<TraceSummary> trace_summaries = it->second;
-    vector<string> covered_apis;
+  for (const auto& hal : hal_trace_mapping) {
+    const vector<TraceSummary>& trace_summaries = hal.second;
+    set<string>& tests = test_list[hal.first];
+    // The APIs of the HAL, interned in the order the tests are sorted in, and
+    // the bitset of the APIs called by each test.
+    unordered_map<string, size_t> api_ids;
+    vector<string> apis;
     for (const auto& summary : trace_summaries) {
-      for (auto const& api_stat_it : summary.api_stats) {
-        if (std::find(covered_apis.begin(), covered_apis.end(),
-                      api_stat_it.first) == covered_apis.end()) {
-          covered_apis.push_back(api_stat_it.first);
-          test_list[it->first].insert(summary.test_name);
+      for (const auto& api_stat : summary.api_stats) {
+        if (api_ids.emplace(api_stat.first, apis.size()).second) {
+          apis.push_back(api_stat.first);
+        }
+      }
+    }
+    size_t word_count = (apis.size() + 63) / 64;
+    vector<vector<uint64_t>> test_apis(trace_summaries.size(),
+                                       vector<uint64_t>(word_count, 0));
+    for (size_t i = 0; i < trace_summaries.size(); i++) {
+      for (const auto& api_stat : trace_summaries[i].api_stats) {
+        size_t id = api_ids[api_stat.first];
+        test_apis[i][id / 64] |= 1ULL << (id % 64);
+      }
+    }
+    // Greedy set cover: picks the test that calls the most APIs not called
+    // by the tests picked so far, the first one in the sorted order on a
+    // tie, until all the APIs are called.
+    vector<uint64_t> covered(word_count, 0);
+    vector<bool> picked(trace_summaries.size(), false);
+    while (true) {
+      size_t best = trace_summaries.size();
+      size_t best_gain = 0;
+      for (size_t i = 0; i < trace_summaries.size(); i++) {
+        if (picked[i]) continue;
+        size_t gain = 0;
+        for (size_t w = 0; w < word_count; w++) {
+          gain += __builtin_popcountll(test_apis[i][w] & ~covered[w]);
+        }
+        if (gain > best_gain) {
+          best = i;
+          best_gain = gain;
         }
       }
+      if (best == trace_summaries.size()) break;
+      picked[best] = true;
+      for (size_t w = 0; w < word_count; w++) {
+        covered[w] |= test_apis[best][w];
+      }
+      tests.insert(trace_summaries[best].test_name);
     }
-    for (const auto& api : covered_apis) {
+    for (const auto& api : apis) {
       cout << "covered api: " << api << endl;
     }
   }
@@ -582,16 +2560,16 @@ void VtsTraceProcessor::GetTestListForHal(const string& test_trace_dir,
       root["Test_list"] = arr;
       fout << root.toStyledString();
     } else {
+      // A test has one summary per HAL.
+      map<string, const TraceSummary*> summaries_by_test;
+      for (const TraceSummary& summary : it->second) {
+        summaries_by_test[summary.test_name] = &summary;
+      }
       fout << it->first << ",";
-      for (auto test : test_list[it->first]) {
-        auto found = find_if(it->second.begin(), it->second.end(),
-                             [&](const TraceSummary& trace_summary) {
-                               return (trace_summary.test_name == test);
-                             });
-        if (found != it->second.end()) {
-          fout << found->test_name << "(" << found->unique_api_count << "/"
-               << found->total_api_count << "),";
-        }
+      for (const auto& test : test_list[it->first]) {
+        const TraceSummary* found = summaries_by_test[test];
+        fout << found->test_name << "(" << found->unique_api_count << "/"
+             << found->total_api_count << "),";
       }
       fout << endl;
     }
@@ -607,89 +2585,153 @@ void VtsTraceProcessor::GetHalTraceMapping(
     cerr << __func__ << ": " << trace_dir << " does not exist." << endl;
     return;
   }
-  vector<TraceSummary> trace_summaries;
+  vector<pair<string, string>> trace_files;
+  vector<string> test_names;
   struct dirent* test_dir;
   while ((test_dir = readdir(trace_dir)) != NULL) {
     if (test_dir->d_type == DT_DIR) {
-      string test_name = test_dir->d_name;
-      cout << "Processing test: " << test_name << endl;
-      string trace_file_dir_name = test_trace_dir;
-      if (test_trace_dir.substr(test_trace_dir.size() - 1) != "/") {
-        trace_file_dir_name += "/";
-      }
-      trace_file_dir_name += test_name;
-      DIR* trace_file_dir = opendir(trace_file_dir_name.c_str());
-      struct dirent* trace_file;
-      while ((trace_file = readdir(trace_file_dir)) != NULL) {
-        if (trace_file->d_type == DT_REG) {
-          string trace_file_name =
-              trace_file_dir_name + "/" + trace_file->d_name;
-          GetHalTraceSummary(trace_file_name, test_name, &trace_summaries);
-        }
+      test_names.push_back(test_dir->d_name);
+    }
+  }
+  closedir(trace_dir);
+  sort(test_names.begin(), test_names.end());
+  for (const string& test_name : test_names) {
+    cout << "Processing test: " << test_name << endl;
+    string trace_file_dir_name = test_trace_dir;
+    if (test_trace_dir.substr(test_trace_dir.size() - 1) != "/") {
+      trace_file_dir_name += "/";
+    }
+    trace_file_dir_name += test_name;
+    for (const string& trace_file : ListTraceFiles(trace_file_dir_name)) {
+      trace_files.push_back(make_pair(test_name, trace_file));
+    }
+  }
+
+  // Summarize the trace files in parallel, then merge the summaries of the
+  // same test and HAL in order.
+  vector<vector<TraceSummary>> file_summaries(trace_files.size());
+  RunJobs(trace_files.size(), [&](size_t i) {
+    GetHalTraceSummary(trace_files[i].second, trace_files[i].first,
+                       &file_summaries[i]);
+  });
+  // The summaries of each HAL, and the index of the summary of each test and
+  // HAL among them.
+  map<tuple<string, int, int>, vector<TraceSummary>> hal_summaries;
+  map<tuple<string, int, int, string>, size_t> summary_indexes;
+  for (auto& summaries : file_summaries) {
+    for (TraceSummary& summary : summaries) {
+      auto hal = make_tuple(summary.package, summary.version_major,
+                            summary.version_minor);
+      vector<TraceSummary>& merged = hal_summaries[hal];
+      auto inserted = summary_indexes.emplace(
+          make_tuple(summary.package, summary.version_major,
+                     summary.version_minor, summary.test_name),
+          merged.size());
+      if (inserted.second) {
+        merged.push_back(std::move(summary));
+        continue;
       }
+      TraceSummary& found = merged[inserted.first->second];
+      found.total_api_count += summary.total_api_count;
+      for (const auto& api_stat : summary.api_stats) {
+        found.api_stats[api_stat.first] += api_stat.second;
+      }
+      found.unique_api_count = found.api_stats.size();
     }
+    summaries.clear();
   }
 
   // Generate hal_trace_mapping mappings.
-  for (const TraceSummary& trace_summary : trace_summaries) {
-    string test_name = trace_summary.test_name;
+  for (auto& hal : hal_summaries) {
     stringstream stream;
-    stream << trace_summary.version_major << "." << trace_summary.version_minor;
-    string hal_name = trace_summary.package + "@" + stream.str();
-    if (hal_trace_mapping->find(hal_name) != hal_trace_mapping->end()) {
-      (*hal_trace_mapping)[hal_name].push_back(trace_summary);
-    } else {
-      (*hal_trace_mapping)[hal_name] = vector<TraceSummary>{trace_summary};
+    stream << get<1>(hal.first) << "." << get<2>(hal.first);
+    string hal_name = get<0>(hal.first) + "@" + stream.str();
+    vector<TraceSummary>& summaries = (*hal_trace_mapping)[hal_name];
+    for (TraceSummary& summary : hal.second) {
+      summaries.push_back(std::move(summary));
     }
   }
   for (auto it = hal_trace_mapping->begin(); it != hal_trace_mapping->end();
        it++) {
     // Sort the tests according to unique_api_count and break tie with
     // total_api_count.
-    std::sort(it->second.begin(), it->second.end(),
-              [](const TraceSummary& lhs, const TraceSummary& rhs) {
-                return (lhs.unique_api_count > rhs.unique_api_count) ||
-                       (lhs.unique_api_count == rhs.unique_api_count &&
-                        lhs.total_api_count > rhs.total_api_count);
-              });
+    std::stable_sort(it->second.begin(), it->second.end(),
+                     [](const TraceSummary& lhs, const TraceSummary& rhs) {
+                       return (lhs.unique_api_count > rhs.unique_api_count) ||
+                              (lhs.unique_api_count == rhs.unique_api_count &&
+                               lhs.total_api_count > rhs.total_api_count);
+                     });
   }
 }
 
 void VtsTraceProcessor::GetHalTraceSummary(
     const string& trace_file, const string& test_name,
     vector<TraceSummary>* trace_summaries) {
-  VtsProfilingMessage profiling_msg;
-  if (!ParseBinaryTrace(trace_file, true, true, true, &profiling_msg)) {
+  // Returns the on_record counting the records into summaries, in the order
+  // their HAL is first seen.
+  auto count_records = [&test_name](vector<TraceSummary>* summaries) {
+    // The index in summaries of the summary of each HAL.
+    auto summary_indexes = make_shared<map<tuple<string, int, int>, size_t>>();
+    return [&test_name, summaries,
+            summary_indexes](const VtsProfilingRecord& record) {
+      auto inserted = summary_indexes->emplace(
+          make_tuple(record.package(), record.version_major(),
+                     record.version_minor()),
+          summaries->size());
+      if (inserted.second) {
+        summaries->emplace_back(test_name, record.package(),
+                                record.version_major(), record.version_minor(),
+                                0, 0, map<string, long>());
+      }
+      TraceSummary& summary = (*summaries)[inserted.first->second];
+      summary.total_api_count++;
+      if (summary.api_stats[record.func_msg().name()]++ == 0) {
+        summary.unique_api_count++;
+      }
+    };
+  };
+  unique_ptr<VtsTraceReader> reader = OpenTraceChunks(trace_file);
+  if (!reader) {
+    if (!ParseBinaryTrace(trace_file, true, true, true,
+                          count_records(trace_summaries))) {
+      cerr << __func__ << ": Failed to parse trace file: " << trace_file
+           << endl;
+    }
+    return;
+  }
+  // The records of each chunk are counted in parallel, then the counts are
+  // merged in order.
+  vector<size_t> chunks = GetTraceChunks(*reader);
+  vector<vector<TraceSummary>> chunk_summaries(chunks.size() - 1);
+  vector<function<void(const VtsProfilingRecord&)>> on_records;
+  for (auto& summaries : chunk_summaries) {
+    on_records.push_back(count_records(&summaries));
+  }
+  if (!ParseTraceChunks(*reader, chunks, true, true,
+                        [&](size_t chunk, size_t /*index*/,
+                            const VtsProfilingRecord& record) {
+                          on_records[chunk](record);
+                        })) {
     cerr << __func__ << ": Failed to parse trace file: " << trace_file << endl;
     return;
   }
-  for (const auto& record : profiling_msg.records()) {
-    string package = record.package();
-    int version_major = record.version_major();
-    int version_minor = record.version_minor();
-    string func_name = record.func_msg().name();
-    auto found =
-        find_if(trace_summaries->begin(), trace_summaries->end(),
-                [&](const TraceSummary& trace_summary) {
-                  return (test_name == trace_summary.test_name &&
-                          package == trace_summary.package &&
-                          version_major == trace_summary.version_major &&
-                          version_minor == trace_summary.version_minor);
-                });
-    if (found != trace_summaries->end()) {
-      found->total_api_count++;
-      if (found->api_stats.find(func_name) != found->api_stats.end()) {
-        found->api_stats[func_name]++;
-      } else {
-        found->unique_api_count++;
-        found->api_stats[func_name] = 1;
+  map<tuple<string, int, int>, size_t> summary_indexes;
+  for (auto& summaries : chunk_summaries) {
+    for (TraceSummary& summary : summaries) {
+      auto inserted = summary_indexes.emplace(
+          make_tuple(summary.package, summary.version_major,
+                     summary.version_minor),
+          trace_summaries->size());
+      if (inserted.second) {
+        trace_summaries->push_back(std::move(summary));
+        continue;
       }
-    } else {
-      map<string, long> api_stats;
-      api_stats[func_name] = 1;
-      TraceSummary trace_summary(test_name, package, version_major,
-                                 version_minor, 1, 1, api_stats);
-      trace_summaries->push_back(trace_summary);
+      TraceSummary& found = (*trace_summaries)[inserted.first->second];
+      found.total_api_count += summary.total_api_count;
+      for (const auto& api_stat : summary.api_stats) {
+        found.api_stats[api_stat.first] += api_stat.second;
+      }
+      found.unique_api_count = found.api_stats.size();
     }
   }
 }
@@ -18,31 +18,123 @@
 #define TOOLS_TRACE_PROCESSOR_VTSTRACEPROCESSOR_H_
 
 #include <android-base/macros.h>
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <test/vts/proto/VtsProfilingMessage.pb.h>
 #include <test/vts/proto/VtsReportMessage.pb.h>
 #include "VtsCoverageProcessor.h"
+#include "VtsLatencyHistogram.h"
 
 namespace android {
 namespace vts {
 
+class VtsTraceReader;
+
 class VtsTraceProcessor {
  public:
   explicit VtsTraceProcessor(VtsCoverageProcessor* coverage_processor)
-      : coverage_processor_(coverage_processor){};
+      : coverage_processor_(coverage_processor), jobs_(1){};
   virtual ~VtsTraceProcessor(){};
 
+  // Sets the number of threads the trace files of a directory are processed
+  // with by CleanupTraces, DedupTraces and GetTestListForHal, and the records
+  // of a single trace that can be indexed (see IndexTrace) are decoded with by
+  // ProcessTraceForLatencyProfiling, DedupTraces and GetTestListForHal. The
+  // results do not depend on it.
+  void SetJobs(int jobs) { jobs_ = jobs > 0 ? jobs : 1; }
+
   enum TraceSelectionMetric {
     MAX_COVERAGE,
     MAX_COVERAGE_SIZE_RATIO,
   };
+  enum TraceFormat {
+    // Records serialized as delimited VtsProfilingRecord.
+    DELIMITED,
+    // Compact format defined in VtsCompactTrace.h.
+    COMPACT,
+  };
   // Cleanups the given trace file/all trace files under the given directory to
   // be used for replaying. Current cleanup depends on the trace type:
   //   1. For sever side trace, remove client side and passthrough records.
   //   2. For client side trace, remove server side and passthrough records.
   //   3. For passthrough trace, remove server and client side records.
   void CleanupTraces(const std::string& path);
-  // Parses the given trace file and outputs the latency for each API call.
-  void ProcessTraceForLatencyProfiling(const std::string& trace_file);
+  // Parses the given trace file and outputs, for each API, the number of calls
+  // and the distribution of their latency (min, mean, p50, p90, p99 and max).
+  // Entry and exit events are paired by call id, or by thread for the traces
+  // written without call ids. For the calls traced with the CPU time of their
+  // thread, also outputs the time they spent running on a CPU (mean, p50 and
+  // p90) and the mean of the rest of their latency.
+  // If verbose is set, outputs the latency of each API call instead. The
+  // trace is processed in a single pass, so its size is not limited by the
+  // available memory, and in chunks on jobs_ threads if it can be indexed and
+  // verbose is not set.
+  void ProcessTraceForLatencyProfiling(const std::string& trace_file,
+                                       bool verbose = false);
+  // Tails a trace file of delimited records as it is written, e.g. by a
+  // running test or by vts_trace_collector, and prints every second the call
+  // rate and the latency distribution (count, p50, p90, p99, max) of each API
+  // over the window_seconds seconds of trace before its last call. Records
+  // appended partially are read once complete. The trace is read again from
+  // the start if it is truncated or replaced. Only returns if the trace is
+  // compact or compressed, which cannot be read incrementally.
+  void FollowTrace(const std::string& trace_file, int window_seconds);
+  // Finds the top_count slowest calls of each API of the given trace file in
+  // a single pass, and prints them, slowest first, with the arguments and
+  // return values of their records. The records are read back through the
+  // index of the trace (see IndexTrace), or by a second pass if the trace
+  // cannot be indexed. If threshold_ns is positive, also prints each call
+  // that took at least threshold_ns as soon as it is found, and the number
+  // of such calls of each API.
+  void FindSlowCalls(const std::string& trace_file, int top_count,
+                     int64_t threshold_ns);
+  // Joins the calls of a client trace with those of the server trace of the
+  // same HALs and run, to split the latency of each call between the HAL and
+  // the binder transport. A client call is joined with a server call of the
+  // same API that runs within it, as both traces are timestamped on the same
+  // clock. For each API, outputs the number of client calls and of those
+  // joined, and the mean, p50 and p99 of their total latency, HAL execution
+  // time (server side) and transport overhead (the difference). If verbose
+  // is set, outputs them for each call instead.
+  void CorrelateTraces(const std::string& client_trace_file,
+                       const std::string& server_trace_file,
+                       bool verbose = false);
+  // Measures how long HALs take to deliver the asynchronous callbacks that
+  // requests trigger, e.g. the completion event of INfc::open, as given by
+  // the rules listed in rules_file. Each line of the file other than empty
+  // lines and lines starting with '#' is a rule
+  //   <request API> <callback API>
+  // with full API names, e.g.
+  //   android.hardware.nfc@1.0::INfc::open
+  //   android.hardware.nfc@1.0::INfcClientCallback::sendEvent
+  // The calls are read from the given trace file, or the trace files of one
+  // run under the given directory, as they are timestamped on the same clock.
+  // A request is timed at its entry on the calling side (client, else
+  // passthrough, else server), a callback at its entry on the receiving side
+  // (server or async callback, else passthrough, else client). Each callback
+  // is paired with the oldest request of its rule before it that is not
+  // paired yet, the others are unsolicited, e.g. periodic callbacks. For each
+  // rule, outputs the number of requests, of those paired and of unsolicited
+  // callbacks, and the distribution of the request-to-callback latency (min,
+  // mean, p50, p90, p99 and max). If verbose is set, outputs the latency of
+  // each pair instead.
+  void ProfileCallbackLatency(const std::string& path,
+                              const std::string& rules_file,
+                              bool verbose = false);
+  // Compares the latency of each API between the traces under base_trace_dir
+  // (e.g. of a baseline build) and those under new_trace_dir. An API is a
+  // regression if its median latency grew by at least 5% and a one-sided
+  // Mann-Whitney U test of the two sets of calls gives a p-value below 0.01.
+  // Prints the regressions, largest relative median shift first, and writes
+  // them to output_file as a text format TestReportMessage with a profiling
+  // report of the count, p50, p90 and p99 of each set per regression. Both
+  // directories are processed at once on jobs_ threads, and each trace in a
+  // single pass, so their size is not limited by the available memory.
+  void CompareLatency(const std::string& base_trace_dir,
+                      const std::string& new_trace_dir,
+                      const std::string& output_file);
   // Parses all trace files under the the given trace directory and remove
   // duplicate trace file.
   void DedupTraces(const std::string& trace_dir);
@@ -57,11 +149,64 @@ class VtsTraceProcessor {
   void SelectTraces(
       const std::string& coverage_file_dir, const std::string& trace_file_dir,
       TraceSelectionMetric metric = TraceSelectionMetric::MAX_COVERAGE);
+  // Selects a minimal subset of the inputs of a fuzz corpus that covers all
+  // the edges covered by the corpus, with the greedy algorithm of
+  // SelectTraces, e.g. to seed a fuzzer or replay with fewer inputs.
+  // coverage_file_dir: directory that stores the coverage of each input, in
+  //   a file named as the input with its 8-bit edge counters, one byte per
+  //   edge as in SharedEdgeCounters.
+  // corpus_dir: directory that stores the inputs.
+  // output_dir: directory the selected inputs are copied to, if not empty.
+  // metric: as in SelectTraces, MAX_COVERAGE favors the smaller inputs.
+  void SelectCorpus(
+      const std::string& coverage_file_dir, const std::string& corpus_dir,
+      const std::string& output_dir,
+      TraceSelectionMetric metric = TraceSelectionMetric::MAX_COVERAGE);
   // Reads a binary trace file, parse each trace event and print the proto.
-  void ParseTrace(const std::string& trace_file);
+  // Only the events with start_time <= timestamp < end_time are printed.
+  void ParseTrace(const std::string& trace_file,
+                  int64_t start_time = INT64_MIN,
+                  int64_t end_time = INT64_MAX);
+  // Prints the number of events of each API in the given trace file with
+  // start_time <= timestamp < end_time.
+  void CountTraceRecords(const std::string& trace_file,
+                         int64_t start_time = INT64_MIN,
+                         int64_t end_time = INT64_MAX);
+  // Builds the index of the given trace file, used by ParseTrace and
+  // CountTraceRecords to read only the events they need, or checks that it is
+  // up to date (see VtsTraceReader.h). The other modes only read an index
+  // file, and build the index in memory if it is missing or out of date.
+  // Only traces of delimited records that are not compressed can be indexed,
+  // ParseTrace and CountTraceRecords read the others sequentially.
+  void IndexTrace(const std::string& trace_file);
   // Reads a text trace file, parse each trace event and convert it into a
-  // binary trace file.
+  // binary trace file, written as the events are parsed.
   void ConvertTrace(const std::string& trace_file);
+  // Reads a binary trace file in either format and converts it into a trace
+  // file in the given format.
+  void ConvertTraceFormat(const std::string& trace_file, TraceFormat format);
+  // Reads a binary trace file and writes it as a trace of delimited records
+  // with the vectors and arrays recorded as raw bytes expanded into one value
+  // per element, as expected by the replay tools.
+  void ExpandTrace(const std::string& trace_file);
+  // Reads a binary trace file and writes the arguments of each HAL call
+  // entry it records, but not of the callbacks, as a seed input of the fuzzer
+  // generated by vtsc for its function, i.e. in the byte layout the fuzzer
+  // decodes with --vts_target_func, to output_dir/<function name>/. Identical seeds are written once. The calls
+  // with arguments that the layout can't hold, e.g. unions, are skipped.
+  void ConvertTraceToFuzzSeeds(const std::string& trace_file,
+                               const std::string& output_dir);
+  // Converts the given trace file, or the trace files of one run under the
+  // given directory (e.g. the client, server and passthrough traces), into a
+  // trace in the Chrome JSON format written to output_file, which the
+  // Perfetto UI and chrome://tracing open. Each file is a process with a
+  // slice per HIDL call or callback on the thread that traced it, with the
+  // arguments and return values as args. Each client call has a flow arrow
+  // to the server call of the same API with the same rank among the calls of
+  // that API, i.e. the traces must be of the same run. The files are read in
+  // a single pass and the events written as they are read, so the size of
+  // the traces is not limited by the available memory.
+  void ExportTrace(const std::string& path, const std::string& output_file);
   // Parse all trace files under test_trace_dir and create a list of test
   // modules for each hal@version that access all apis covered by the whole test
   // set. (i.e. such list should be a subset of the whole test list that access
@@ -71,21 +216,148 @@ class VtsTraceProcessor {
                          bool verbose_output = false);
 
  private:
-  // Reads a binary trace file and parse each trace event into
-  // VtsProfilingRecord.
+  // Reads a binary trace file, either delimited or compact, and parse each
+  // trace event into VtsProfilingRecord. ignore_timestamp also drops the
+  // thread and call ids, which differ between two runs of the same test.
   bool ParseBinaryTrace(const std::string& trace_file, bool ignore_timestamp,
                         bool entry_only, bool summary_only,
                         VtsProfilingMessage* profiling_msg);
 
-  // Reads a text trace file and parse each trace event into
-  // VtsProfilingRecord.
-  bool ParseTextTrace(const std::string& trace_file,
-                      VtsProfilingMessage* profiling_msg);
+  // Same as above, but calls on_record for each record instead of keeping
+  // them all in memory.
+  bool ParseBinaryTrace(
+      const std::string& trace_file, bool ignore_timestamp, bool entry_only,
+      bool summary_only,
+      const std::function<void(const VtsProfilingRecord&)>& on_record);
+
+  // Parses the given trace file and calls on_record, if not null, for each
+  // record, and on_call for each call as it ends with its exit record, its
+  // full API name, an id of the API unique within the trace and assigned in
+  // order from 0, and its entry timestamp. Entry and exit events are paired
+  // by call id, or by thread for the traces written without call ids. The
+  // synchronous callbacks are not calls of their own, the asynchronous ones
+  // are. The arguments are not parsed.
+  bool ParseTraceCalls(
+      const std::string& trace_file,
+      const std::function<void(const VtsProfilingRecord&)>& on_record,
+      const std::function<void(const VtsProfilingRecord&, const std::string&,
+                               uint32_t, int64_t)>& on_call);
+
+  // Pairs the exit record of each call with its entry record, as the records
+  // of a trace are read in order. See ParseTraceCalls.
+  class CallMatcher {
+   public:
+    // Calls on_call, as ParseTraceCalls does, if record is the exit record of
+    // a call of the API full_api_name.
+    void AddRecord(const VtsProfilingRecord& record,
+                   const std::string& full_api_name,
+                   const std::function<void(const VtsProfilingRecord&,
+                                            const std::string&, uint32_t,
+                                            int64_t)>& on_call);
+    // Returns the rank, among the records given to AddRecord, of the entry
+    // record of the last call passed to on_call.
+    size_t LastEntryRecordIndex() const { return last_entry_record_index_; }
+    // Returns the CPU time of the thread at the entry record of the last call
+    // passed to on_call, -1 if not recorded.
+    int64_t LastEntryThreadCpuTime() const {
+      return last_entry_thread_cpu_time_;
+    }
+    // Calls on_unmatched with the rank of each exit record without an entry
+    // record instead of logging an error, e.g. as the records are a chunk of
+    // a trace and the entry record is in an earlier chunk.
+    void SetUnmatchedCallback(std::function<void(size_t)> on_unmatched) {
+      on_unmatched_ = std::move(on_unmatched);
+    }
+    // Returns the ranks of the entry records of the calls whose exit record
+    // has not been given yet, in order.
+    std::vector<size_t> OpenEntryRecordIndexes() const;
+
+   private:
+    // Reports an exit record without an entry record, see
+    // SetUnmatchedCallback.
+    void AddUnmatchedRecord(const VtsProfilingRecord& record,
+                            size_t record_index);
+
+    // Entry event of a call whose exit event has not been seen yet.
+    struct OpenCall {
+      uint32_t api_id;
+      InstrumentationEventType event;
+      int64_t timestamp;
+      int64_t thread_cpu_time;
+      size_t record_index;
+    };
+    // The number of records given to AddRecord.
+    size_t record_count_ = 0;
+    size_t last_entry_record_index_ = 0;
+    int64_t last_entry_thread_cpu_time_ = -1;
+    // APIs indexed by id, so that only their id is kept for each open call.
+    std::unordered_map<std::string, uint32_t> api_ids_;
+    // Open calls by call id.
+    std::unordered_map<uint64_t, OpenCall> open_calls_;
+    // Open calls without a call id (traces written before call ids were
+    // added) of each thread, innermost last.
+    std::unordered_map<int32_t, std::vector<OpenCall>> open_thread_calls_;
+    std::function<void(size_t)> on_unmatched_;
+  };
+
+  // Opens the given trace file to decode it in chunks with ParseTraceChunks if
+  // it can be indexed and more than one thread can decode it, i.e. jobs_ is
+  // more than 1 and the caller is not a job of RunJobs already. Returns null
+  // otherwise, in which case the trace is read by ParseBinaryTrace.
+  std::unique_ptr<VtsTraceReader> OpenTraceChunks(
+      const std::string& trace_file);
+
+  // Splits the records of the trace of reader into chunks of consecutive
+  // records of about the same size, enough of them to keep jobs_ threads
+  // busy. Returns the index of the first record of each chunk, followed by
+  // the number of records.
+  std::vector<size_t> GetTraceChunks(const VtsTraceReader& reader);
+
+  // Decodes the chunks of records given by GetTraceChunks on jobs_ threads,
+  // and calls on_record with the chunk, the index and the record of each of
+  // their records, in order within a chunk. ignore_timestamp and entry_only
+  // are as for ParseBinaryTrace. Returns false if a record can't be parsed.
+  bool ParseTraceChunks(
+      const VtsTraceReader& reader, const std::vector<size_t>& chunks,
+      bool ignore_timestamp, bool entry_only,
+      const std::function<void(size_t, size_t, const VtsProfilingRecord&)>&
+          on_record);
+
+  // Computes a hash of the sequence of entry records of the given trace file,
+  // without their timestamps, i.e. of the content compared by DedupTraces,
+  // and counts them. The hash does not depend on how the trace is chunked.
+  bool HashTrace(const std::string& trace_file, uint64_t* hash,
+                 long* record_count);
+
+  // Returns whether the given trace files have the same sequence of entry
+  // records, without their timestamps.
+  bool IsSameTrace(const std::string& trace_file,
+                   const std::string& other_trace_file);
+
+  // Reads a text trace file and calls on_record for each trace event, in
+  // order. The file is read in chunks whose records are parsed on jobs_
+  // threads, so only a chunk is kept in memory.
+  bool ParseTextTrace(
+      const std::string& trace_file,
+      const std::function<void(const VtsProfilingRecord&)>& on_record);
 
   // Writes the given VtsProfilingMessage into an output file.
   bool WriteProfilingMsg(const std::string& output_file,
                          const VtsProfilingMessage& profiling_msg);
 
+  // Writes the given VtsProfilingMessage into an output file in the compact
+  // trace format.
+  bool WriteCompactProfilingMsg(const std::string& output_file,
+                                const VtsProfilingMessage& profiling_msg);
+
+  // Returns the paths of the regular files in the given directory, sorted so
+  // that the results merged from them do not depend on the directory order.
+  std::vector<std::string> ListTraceFiles(const std::string& dir);
+
+  // Calls job(i) for each i in [0, count), on jobs_ threads. job must be
+  // thread-safe for different values of i.
+  void RunJobs(size_t count, const std::function<void(size_t)>& job);
+
   // Internal method to cleanup a trace file.
   void CleanupTraceFile(const std::string& trace_file);
   // Reads a test report file that contains the coverage data and parse it into
@@ -102,24 +374,84 @@ class VtsTraceProcessor {
   long GetTotalLine(const TestReportMessage& msg);
   // Helper method to extract the trace file name from the given file name.
   std::string GetTraceFileName(const std::string& coverage_file_name);
-  // Helper method to check whether the given event is an entry event.
-  bool isEntryEvent(const InstrumentationEventType& event);
-  // Helper method to check whether the given two records are paired records.
-  // Paired records means the two records are for the same hal interface, and
-  // have corresponding entry/exit events.
-  bool isPairedRecord(const VtsProfilingRecord& entry_record,
-                      const VtsProfilingRecord& exit_record);
+  // Helper method to check whether the given event is the entry event of a
+  // call of the HAL, i.e. not of a callback.
+  static bool isEntryEvent(const InstrumentationEventType& event);
+  // Helper method to check whether the given event opens a call to be paired
+  // with its exit event, including the calls of the callbacks.
+  static bool isCallEntryEvent(const InstrumentationEventType& event);
+  // Helper method to check whether the given exit event corresponds to the
+  // given entry event.
+  static bool isPairedEvent(const InstrumentationEventType& entry_event,
+                            const InstrumentationEventType& exit_event);
   // Util method to get the string representing the full API name, e.g.
   // android.hardware.foo@1.0::IFoo:open
   std::string GetFullApiStr(const VtsProfilingRecord& record);
 
+  // Histogram of the latencies of the calls of an API. The buckets are exact
+  // up to 128ns, then have a relative width of 1/64, so that the percentiles
+  // are within 1.6% of the exact values whatever the number of calls.
+  struct LatencyHistogram {
+    typedef VtsLatencyBuckets<6> Buckets;
+
+    long count = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    int64_t sum = 0;
+    // Number of calls by bucket.
+    std::map<int, long> buckets;
+
+    void Add(int64_t latency);
+    // Returns the upper bound (capped to max) of the bucket of the latency
+    // below which the given percentage of the calls are.
+    int64_t Percentile(double percent) const;
+    // Adds the calls of other.
+    void Merge(const LatencyHistogram& other);
+    // Returns the one-sided p-value of the Mann-Whitney U test that the
+    // latencies of these calls tend to be greater than those of base. Calls
+    // in the same bucket are counted as ties.
+    double ShiftPValue(const LatencyHistogram& base) const;
+  };
+
+  // Prints the line of CorrelateTraces for the calls of name.
+  void PrintCorrelatedLatencies(const std::string& name, long count,
+                                const LatencyHistogram& total,
+                                const LatencyHistogram& hal,
+                                const LatencyHistogram& overhead);
+
   // Struct to store the coverage data.
   struct CoverageInfo {
-    TestReportMessage coverage_msg;
+    // Coverage of a source file in the coverage report.
+    struct FileCoverage {
+      // Index of the file path in the paths of all the coverage reports.
+      size_t file_index;
+      // As reported, may differ from the number of bits set.
+      long covered_line_count;
+      // Bitset of the covered lines, 64 lines per word.
+      std::vector<uint64_t> covered_lines;
+    };
+    std::vector<FileCoverage> file_coverages;
+    long total_line_count;
     std::string trace_file_name;
     long trace_file_size;
   };
 
+  // Selects coverage files among coverage_files with the greedy algorithm of
+  // SelectTraces, given the lines already covered, and adds the number of
+  // lines newly covered by each selected file to selected_coverages.
+  void SelectCoverages(
+      const std::vector<const std::string*>& coverage_files,
+      const std::map<std::string, CoverageInfo>& coverages,
+      TraceSelectionMetric metric,
+      std::vector<std::vector<uint64_t>>* covered_lines,
+      std::map<std::string, long>* selected_coverages);
+
+  // Returns the number of lines covered by coverage and not in
+  // covered_lines, the bitsets of the lines covered so far indexed by file.
+  long GetNewCoveredLineCount(
+      const CoverageInfo& coverage,
+      const std::vector<std::vector<uint64_t>>& covered_lines);
+
   // Struct to store the trace summary data.
   struct TraceSummary {
     // Name of test module that generates the trace. e.g. CtsUsbTests.
@@ -146,7 +478,7 @@ class VtsTraceProcessor {
           version_minor(version_minor),
           total_api_count(total_api_count),
           unique_api_count(unique_api_count),
-          api_stats(api_stats){};
+          api_stats(std::move(api_stats)){};
   };
 
   // Internal method to parse all trace files under test_trace_dir and create
@@ -156,13 +488,16 @@ class VtsTraceProcessor {
       std::map<std::string, std::vector<TraceSummary>>* hal_trace_mapping);
 
   // Internal method to parse a trace file and create the corresponding
-  // TraceSummary from it.
+  // TraceSummary from it, in chunks if it can be indexed. Thread-safe.
   void GetHalTraceSummary(const std::string& trace_file,
                           const std::string& test_name,
                           std::vector<TraceSummary>* trace_summaries);
 
   // A class to process coverage reports. Not owned.
   VtsCoverageProcessor* coverage_processor_;
+  // Number of threads to process the trace files of a directory, or the
+  // chunks of a trace, with.
+  int jobs_;
 
   DISALLOW_COPY_AND_ASSIGN(VtsTraceProcessor);
 };
@@ -15,6 +15,7 @@
 #
 
 import logging
+import struct
 import sys
 
 from vts.proto import ComponentSpecificationMessage_pb2 as CompSpecMsg
@@ -68,6 +69,50 @@ def PbString2PyString(var):
     return var.string_value.message
 
 
+# struct formats of the scalar types a vector_raw_value may hold. The raw bytes
+# are in the byte order of the device, which is little-endian.
+_RAW_SCALAR_FORMATS = {
+    "bool_t": "?",
+    "int8_t": "b",
+    "uint8_t": "B",
+    "char": "b",
+    "uchar": "B",
+    "int16_t": "h",
+    "uint16_t": "H",
+    "int32_t": "i",
+    "uint32_t": "I",
+    "int64_t": "q",
+    "uint64_t": "Q",
+    "float_t": "f",
+    "double_t": "d",
+}
+
+
+def PbRawVector2PyList(var):
+    """Converts the vector_raw_value of a VariableSecificationMessage (Vector
+    or Array of scalars) to a Python list.
+
+    Args:
+        var: VariableSpecificationMessage to convert.
+
+    Returns:
+        A converted list if valid, None otherwise.
+    """
+    fmt = _RAW_SCALAR_FORMATS.get(var.scalar_type)
+    if fmt is None:
+        logging.error("unsupported raw scalar type %s", var.scalar_type)
+        return None
+    item_size = struct.calcsize("<" + fmt)
+    raw_value = var.vector_raw_value
+    if len(raw_value) % item_size:
+        logging.error("raw value of %d bytes is not a multiple of %s",
+                      len(raw_value), var.scalar_type)
+        return None
+    return list(
+        struct.unpack("<%d%s" % (len(raw_value) // item_size, fmt),
+                      raw_value))
+
+
 def PbVector2PyList(var):
     """Converts VariableSecificationMessage (Vector) to a Python list.
 
@@ -77,6 +122,8 @@ def PbVector2PyList(var):
     Returns:
         A converted list if valid, None otherwise.
     """
+    if var.HasField("vector_raw_value"):
+        return PbRawVector2PyList(var)
     result = []
     for curr_value in var.vector_value:
         if curr_value.type == CompSpecMsg.TYPE_SCALAR:
@@ -98,6 +145,8 @@ def PbArray2PyList(var):
     Returns:
         A converted list if valid, None otherwise
     """
+    if var.HasField("vector_raw_value"):
+        return PbRawVector2PyList(var)
     result = []
     for curr_value in var.vector_value:
         if curr_value.type == CompSpecMsg.TYPE_SCALAR:
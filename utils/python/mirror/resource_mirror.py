@@ -116,7 +116,6 @@ class ResourceFmqMirror(mirror_object.MirrorObject):
             return True
         return False
 
-    # TODO: support long-form blocking read in the future when there is use case.
     def readBlocking(self, data, data_size, time_out_nanos=0):
         """Initiate a blocking read request (short-form) to FMQ driver.
 
@@ -174,7 +173,6 @@ class ResourceFmqMirror(mirror_object.MirrorObject):
             return fmq_response.success
         return False
 
-    # TODO: support long-form blocking write in the future when there is use case.
     def writeBlocking(self, data, data_size, time_out_nanos=0):
         """Initiate a blocking write request (short-form) to FMQ driver.
 
@@ -205,6 +203,137 @@ class ResourceFmqMirror(mirror_object.MirrorObject):
             return fmq_response.success
         return False
 
+    def readBlockingLong(self, data, data_size, read_notification,
+                         write_notification, time_out_nanos=0,
+                         event_flag_queue=None):
+        """Initiate a blocking read request (long-form) to FMQ driver.
+
+        The read waits on write_notification bits of the event flag, and sets
+        read_notification bits when it finishes, so that several queues can
+        block on one event flag.
+
+        Args:
+            data: list, data to be filled by this function. The list will
+                  be emptied before the function starts to put read data into
+                  it, which is consistent with the function behavior on the
+                  target side.
+            data_size: int, length of data to read.
+            read_notification: int, notification bits to set when finish
+                               reading.
+            write_notification: int, notification bits to wait on when
+                                blocking.
+            time_out_nanos: int, wait time (in nanoseconds) when blocking.
+                            The default value is 0 (no blocking).
+            event_flag_queue: ResourceFmqMirror, the queue whose event flag is
+                              shared by a group of queues. The default is
+                              the event flag of this queue.
+
+        Returns:
+            bool, true if the operation succeeds,
+                  false otherwise.
+        """
+        # Prepare arguments.
+        del data[:]
+        request_msg = self._createTemplateRequestMessage(
+            ResControlMsg.FMQ_READ_BLOCKING_LONG, self._queue_id)
+        request_msg.read_data_size = data_size
+        self._setLongFormArguments(request_msg, read_notification,
+                                   write_notification, time_out_nanos,
+                                   event_flag_queue)
+
+        # Send and receive data.
+        fmq_response = self._client.SendFmqRequest(request_msg)
+        if fmq_response is not None and fmq_response.success:
+            self._extractReadData(fmq_response, data)
+            return True
+        return False
+
+    def writeBlockingLong(self, data, data_size, read_notification,
+                          write_notification, time_out_nanos=0,
+                          event_flag_queue=None):
+        """Initiate a blocking write request (long-form) to FMQ driver.
+
+        The write waits on read_notification bits of the event flag, and
+        sets write_notification bits when it finishes, so that several queues
+        can block on one event flag.
+
+        Args:
+            data: list, data to be written.
+            data_size: int, length of data to write.
+                       The function will only write data up until data_size,
+                       i.e. extraneous data will be discarded.
+            read_notification: int, notification bits to wait on when
+                               blocking.
+            write_notification: int, notification bits to set when finish
+                                writing.
+            time_out_nanos: int, wait time (in nanoseconds) when blocking.
+                            The default value is 0 (no blocking).
+            event_flag_queue: ResourceFmqMirror, the queue whose event flag is
+                              shared by a group of queues. The default is
+                              the event flag of this queue.
+
+        Returns:
+            bool, true if the operation succeeds,
+                  false otherwise.
+        """
+        # Prepare arguments.
+        request_msg = self._createTemplateRequestMessage(
+            ResControlMsg.FMQ_WRITE_BLOCKING_LONG, self._queue_id)
+        prepare_result = self._prepareWriteData(request_msg, data[:data_size])
+        if not prepare_result:
+            # Prepare write data failure, error logged in _prepareWriteData().
+            return False
+        self._setLongFormArguments(request_msg, read_notification,
+                                   write_notification, time_out_nanos,
+                                   event_flag_queue)
+
+        # Send and receive data.
+        fmq_response = self._client.SendFmqRequest(request_msg)
+        if fmq_response is not None:
+            return fmq_response.success
+        return False
+
+    def waitEventFlag(self, bits, time_out_nanos=0):
+        """Wait on bits of the event flag of this queue.
+
+        Args:
+            bits: int, bits to wait on.
+            time_out_nanos: int, wait time (in nanoseconds).
+                            The default value is 0 (wait forever).
+
+        Returns:
+            int, the bits woken, None on error or time out.
+        """
+        # Prepare arguments.
+        request_msg = self._createTemplateRequestMessage(
+            ResControlMsg.FMQ_WAIT_EVENT_FLAG, self._queue_id)
+        request_msg.event_flag_bits = bits
+        request_msg.time_out_nanos = time_out_nanos
+
+        # Send and receive data.
+        return self._processUtilMethod(request_msg)
+
+    def wakeEventFlag(self, bits):
+        """Set bits of the event flag of this queue, and wake up the waiters.
+
+        Args:
+            bits: int, bits to set.
+
+        Returns:
+            bool, true if the operation succeeds,
+                  false otherwise.
+        """
+        # Prepare arguments.
+        request_msg = self._createTemplateRequestMessage(
+            ResControlMsg.FMQ_WAKE_EVENT_FLAG, self._queue_id)
+        request_msg.event_flag_bits = bits
+
+        # Send and receive data.
+        fmq_response = self._client.SendFmqRequest(request_msg)
+        if fmq_response is not None:
+            return fmq_response.success
+        return False
+
     def availableToWrite(self):
         """Get space available to write in the queue.
 
@@ -320,6 +449,25 @@ class ResourceFmqMirror(mirror_object.MirrorObject):
         request_msg.queue_id = queue_id
         return request_msg
 
+    def _setLongFormArguments(self, request_msg, read_notification,
+                              write_notification, time_out_nanos,
+                              event_flag_queue):
+        """Sets the arguments of a long-form blocking operation.
+
+        Args:
+            request_msg: FmqRequestMessage, the request to fill in.
+            read_notification: int, notification bits of the readers.
+            write_notification: int, notification bits of the writers.
+            time_out_nanos: int, wait time (in nanoseconds) when blocking.
+            event_flag_queue: ResourceFmqMirror, the queue whose event flag is
+                              used, or None to use the one of this queue.
+        """
+        request_msg.read_notification = read_notification
+        request_msg.write_notification = write_notification
+        request_msg.time_out_nanos = time_out_nanos
+        if event_flag_queue is not None:
+            request_msg.event_flag_queue_id = event_flag_queue.queueId
+
     def _prepareWriteData(self, request_msg, data):
         """Converts python list to repeated protobuf field.
 
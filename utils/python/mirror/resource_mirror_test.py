@@ -0,0 +1,104 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2020 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import unittest
+
+from vts.proto import VtsResourceControllerMessage_pb2 as ResControlMsg
+from vts.utils.python.mirror import resource_mirror
+
+
+class FakeFmqClient(object):
+    """Records the FMQ requests and answers them with a canned response.
+
+    Attributes:
+        requests: list of FmqRequestMessage, the requests sent so far.
+        response: FmqResponseMessage, returned for every request.
+    """
+
+    def __init__(self):
+        self.requests = []
+        self.response = ResControlMsg.FmqResponseMessage()
+        self.response.success = True
+
+    def SendFmqRequest(self, request_msg):
+        self.requests.append(request_msg)
+        return self.response
+
+    def GetPythonDataOfVariableSpecMsg(self, var_spec_msg):
+        return var_spec_msg.scalar_value.uint16_t
+
+
+class ResourceFmqMirrorTest(unittest.TestCase):
+    """Checks the long-form requests built by ResourceFmqMirror."""
+
+    def setUp(self):
+        self._client = FakeFmqClient()
+        self._queue = resource_mirror.ResourceFmqMirror(
+            "uint16_t", True, self._client, queue_id=3)
+        self._event_flag_queue = resource_mirror.ResourceFmqMirror(
+            "uint16_t", True, self._client, queue_id=7)
+
+    def testReadBlockingLong(self):
+        data = [1, 2]
+        self.assertTrue(
+            self._queue.readBlockingLong(data, 4, 0x1, 0x2, 1000,
+                                         self._event_flag_queue))
+        self.assertEqual(data, [])
+        request = self._client.requests[-1]
+        self.assertEqual(request.operation,
+                         ResControlMsg.FMQ_READ_BLOCKING_LONG)
+        self.assertEqual(request.queue_id, 3)
+        self.assertEqual(request.read_data_size, 4)
+        self.assertEqual(request.read_notification, 0x1)
+        self.assertEqual(request.write_notification, 0x2)
+        self.assertEqual(request.time_out_nanos, 1000)
+        self.assertEqual(request.event_flag_queue_id, 7)
+
+    def testWriteBlockingLongUsesOwnEventFlag(self):
+        self.assertTrue(
+            self._queue.writeBlockingLong([5, 6, 7], 2, 0x4, 0x8))
+        request = self._client.requests[-1]
+        self.assertEqual(request.operation,
+                         ResControlMsg.FMQ_WRITE_BLOCKING_LONG)
+        self.assertEqual([item.scalar_value.uint16_t
+                          for item in request.write_data], [5, 6])
+        self.assertEqual(request.read_notification, 0x4)
+        self.assertEqual(request.write_notification, 0x8)
+        self.assertFalse(request.HasField("event_flag_queue_id"))
+        self.assertEqual(request.event_flag_queue_id, -1)
+
+    def testWaitEventFlag(self):
+        self._client.response.sizet_return_val = 0x10
+        self.assertEqual(self._queue.waitEventFlag(0x30, 500), 0x10)
+        request = self._client.requests[-1]
+        self.assertEqual(request.operation, ResControlMsg.FMQ_WAIT_EVENT_FLAG)
+        self.assertEqual(request.event_flag_bits, 0x30)
+        self.assertEqual(request.time_out_nanos, 500)
+
+    def testWakeEventFlag(self):
+        self.assertTrue(self._queue.wakeEventFlag(0x30))
+        request = self._client.requests[-1]
+        self.assertEqual(request.operation, ResControlMsg.FMQ_WAKE_EVENT_FLAG)
+        self.assertEqual(request.event_flag_bits, 0x30)
+
+    def testFailedWaitReturnsNone(self):
+        self._client.response.success = False
+        self.assertIsNone(self._queue.waitEventFlag(0x1))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -251,7 +251,7 @@ class ProfilingFeature(feature_utils.Feature):
                                            "lib64")
         trace_processor_cmd = [
             "chmod a+x %s" % trace_processor_binary,
-            "LD_LIBRARY_PATH=%s %s -m profiling_trace %s" %
+            "LD_LIBRARY_PATH=%s %s -m profiling_trace --verbose %s" %
             (trace_processor_lib, trace_processor_binary, trace_file)
         ]
 